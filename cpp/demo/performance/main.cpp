@@ -0,0 +1,294 @@
+// Weak/strong scaling harness (C++)
+// =================================
+//
+// This demo is a distributed performance harness. It solves a
+// parameterized Poisson or linear elasticity problem on a
+// generation::BoxMesh and reports per-phase wall times (partitioning
+// and mesh creation, topology, function space and dofmap, matrix and
+// vector assembly, solve, I/O) with the min/max/average over ranks and
+// the load imbalance (max/average), computed from the Timer records
+// via Table::reduce. Results are emitted as a single JSON line on rank
+// 0 so that scaling runs can be collected by scripts.
+//
+// Typical usage:
+//
+// .. code-block:: sh
+//
+//    # Weak scaling, 500k dofs per rank
+//    mpirun -n 8 ./demo_performance --problem poisson \
+//        --scaling weak --ndofs 500000
+//
+//    # Strong scaling, 10M dofs total, structured partitioning
+//    mpirun -n 32 ./demo_performance --problem elasticity \
+//        --scaling strong --ndofs 10000000 --structured
+//
+// PETSc options (e.g. -ksp_type, -pc_type) are forwarded to the
+// solver and override the conjugate gradient/Jacobi defaults.
+
+#include "elasticity.h"
+#include "poisson.h"
+#include <cmath>
+#include <cstring>
+#include <dolfinx.h>
+#include <dolfinx/common/Table.h>
+#include <dolfinx/common/timing.h>
+#include <dolfinx/fem/petsc.h>
+#include <iomanip>
+#include <iostream>
+#include <xtensor/xarray.hpp>
+#include <xtensor/xview.hpp>
+
+using namespace dolfinx;
+
+namespace
+{
+// Phase names, in reporting order. Timings are recorded under these
+// names with common::Timer and read back with dolfinx::timing.
+const std::vector<std::string> phases
+    = {"performance: partitioning and mesh",
+       "performance: topology",
+       "performance: functionspace and dofmap",
+       "performance: assemble matrix",
+       "performance: assemble vector",
+       "performance: solve",
+       "performance: output"};
+
+// Solve the variational problem defined by the generated forms
+// form_a/form_L on a box mesh with about ndofs_global degrees of
+// freedom (bs degrees of freedom per vertex), with a homogeneous
+// Dirichlet condition on the exterior boundary. Each phase is recorded
+// under the names in `phases`. Returns the Krylov iteration count.
+int run_problem(MPI_Comm comm, const ufc_form* form_a, const ufc_form* form_L,
+                ufc_function_space* (*fs)(const char*),
+                std::int64_t ndofs_global, int bs, bool structured, bool output)
+{
+  // Number of cells per direction giving approximately ndofs_global
+  // degrees of freedom: a box with n^3 cells has (n + 1)^3 vertices
+  const double nv = double(ndofs_global) / bs;
+  std::size_t n = std::size_t(std::llround(std::cbrt(nv))) - 1;
+  n = std::max<std::size_t>(n, 1);
+  const std::array<std::size_t, 3> nx = {n, n, n};
+
+  mesh::CellPartitionFunction partitioner
+      = static_cast<graph::AdjacencyList<std::int32_t> (*)(
+          MPI_Comm, int, int, const graph::AdjacencyList<std::int64_t>&,
+          mesh::GhostMode)>(&mesh::partition_cells_graph);
+  if (structured)
+    partitioner = generation::BoxMesh::structured_partitioner(
+        nx, mesh::CellType::tetrahedron);
+
+  // Phase: partitioning and mesh creation
+  std::shared_ptr<mesh::Mesh> mesh;
+  {
+    common::Timer timer(phases[0]);
+    mesh = std::make_shared<mesh::Mesh>(generation::BoxMesh::create(
+        comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, nx,
+        mesh::CellType::tetrahedron, mesh::GhostMode::none, partitioner));
+  }
+
+  // Phase: topology (facets and facet-cell connectivity, needed for
+  // the boundary condition)
+  const int tdim = mesh->topology().dim();
+  {
+    common::Timer timer(phases[1]);
+    mesh->topology().create_connectivity(tdim - 1, tdim);
+  }
+
+  // Phase: function space and dofmap
+  std::shared_ptr<fem::FunctionSpace> V;
+  {
+    common::Timer timer(phases[2]);
+    V = std::make_shared<fem::FunctionSpace>(
+        fem::create_functionspace(fs, "u", mesh));
+  }
+
+  auto f = std::make_shared<fem::Function<PetscScalar>>(V);
+  if (bs == 1)
+  {
+    f->interpolate(
+        [](const xt::xtensor<double, 2>& x) -> xt::xarray<PetscScalar>
+        {
+          auto dx = xt::square(xt::row(x, 0) - 0.5)
+                    + xt::square(xt::row(x, 1) - 0.5);
+          return 10 * xt::exp(-(dx) / 0.02);
+        });
+  }
+  else
+  {
+    f->interpolate(
+        [](const xt::xtensor<double, 2>& x) -> xt::xarray<PetscScalar>
+        {
+          xt::xarray<PetscScalar> v = xt::zeros<PetscScalar>(x.shape());
+          xt::row(v, 0) = xt::sin(xt::row(x, 1));
+          xt::row(v, 2) = xt::cos(xt::row(x, 0));
+          return v;
+        });
+  }
+
+  auto a = std::make_shared<fem::Form<PetscScalar>>(
+      fem::create_form<PetscScalar>(*form_a, {V, V}, {}, {}, {}));
+  auto L = std::make_shared<fem::Form<PetscScalar>>(
+      fem::create_form<PetscScalar>(*form_L, {V}, {{"f", f}}, {}, {}));
+
+  // Homogeneous Dirichlet condition on the exterior boundary
+  auto u0 = std::make_shared<fem::Function<PetscScalar>>(V);
+  const std::vector<std::int32_t> facets = mesh::exterior_facet_indices(*mesh);
+  std::vector bc{std::make_shared<const fem::DirichletBC<PetscScalar>>(
+      u0, fem::locate_dofs_topological(*V, tdim - 1, facets))};
+
+  // Phase: matrix assembly
+  la::PETScMatrix A = la::PETScMatrix(fem::create_matrix(*a), false);
+  {
+    common::Timer timer(phases[3]);
+    MatZeroEntries(A.mat());
+    fem::assemble_matrix(la::PETScMatrix::set_block_fn(A.mat(), ADD_VALUES),
+                         *a, bc);
+    MatAssemblyBegin(A.mat(), MAT_FLUSH_ASSEMBLY);
+    MatAssemblyEnd(A.mat(), MAT_FLUSH_ASSEMBLY);
+    fem::set_diagonal(la::PETScMatrix::set_fn(A.mat(), INSERT_VALUES), *V, bc);
+    MatAssemblyBegin(A.mat(), MAT_FINAL_ASSEMBLY);
+    MatAssemblyEnd(A.mat(), MAT_FINAL_ASSEMBLY);
+  }
+
+  // Phase: vector assembly
+  la::PETScVector b(*L->function_spaces()[0]->dofmap()->index_map,
+                    L->function_spaces()[0]->dofmap()->index_map_bs());
+  {
+    common::Timer timer(phases[4]);
+    VecSet(b.vec(), 0.0);
+    VecGhostUpdateBegin(b.vec(), INSERT_VALUES, SCATTER_FORWARD);
+    VecGhostUpdateEnd(b.vec(), INSERT_VALUES, SCATTER_FORWARD);
+    fem::assemble_vector_petsc(b.vec(), *L);
+    fem::apply_lifting_petsc(b.vec(), {a}, {{bc}}, {}, 1.0);
+    VecGhostUpdateBegin(b.vec(), ADD_VALUES, SCATTER_REVERSE);
+    VecGhostUpdateEnd(b.vec(), ADD_VALUES, SCATTER_REVERSE);
+    fem::set_bc_petsc(b.vec(), bc, nullptr);
+  }
+
+  // Phase: solve. Conjugate gradients with Jacobi preconditioning by
+  // default; any PETSc command-line options take precedence.
+  fem::Function<PetscScalar> u(V);
+  int num_iterations = 0;
+  {
+    common::Timer timer(phases[5]);
+    la::PETScKrylovSolver solver(comm);
+    la::PETScOptions::set("ksp_type", "cg");
+    la::PETScOptions::set("pc_type", "jacobi");
+    la::PETScOptions::set("ksp_rtol", 1.0e-8);
+    solver.set_from_options();
+    solver.set_operator(A.mat());
+    num_iterations = solver.solve(u.vector(), b.vec());
+  }
+
+  // Phase: I/O
+  if (output)
+  {
+    common::Timer timer(phases[6]);
+    io::VTKFile file(comm, "u.pvd", "w");
+    file.write({u}, 0.0);
+  }
+
+  return num_iterations;
+}
+
+// Extract the wall time for a phase from a reduced timings Table,
+// returning 0 for phases that were not executed on any rank
+double wall_time(const Table& table, const std::string& phase)
+{
+  const std::vector<std::string>& rows = table.rows();
+  if (std::find(rows.begin(), rows.end(), phase) == rows.end())
+    return 0.0;
+  return std::get<double>(table.get(phase, "wall"));
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  common::subsystem::init_logging(argc, argv);
+  common::subsystem::init_petsc(argc, argv);
+
+  {
+    // Parse command line options (PETSc options are handled by
+    // init_petsc and ignored here)
+    std::string problem = "poisson";
+    std::string scaling = "weak";
+    std::int64_t ndofs = 500000;
+    bool structured = false;
+    bool output = false;
+    for (int i = 1; i < argc; ++i)
+    {
+      if (std::strcmp(argv[i], "--problem") == 0 and i + 1 < argc)
+        problem = argv[++i];
+      else if (std::strcmp(argv[i], "--scaling") == 0 and i + 1 < argc)
+        scaling = argv[++i];
+      else if (std::strcmp(argv[i], "--ndofs") == 0 and i + 1 < argc)
+        ndofs = std::stoll(argv[++i]);
+      else if (std::strcmp(argv[i], "--structured") == 0)
+        structured = true;
+      else if (std::strcmp(argv[i], "--output") == 0)
+        output = true;
+    }
+    if (problem != "poisson" and problem != "elasticity")
+      throw std::runtime_error("Unknown problem: " + problem);
+    if (scaling != "weak" and scaling != "strong")
+      throw std::runtime_error("Unknown scaling mode: " + scaling);
+
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const int size = dolfinx::MPI::size(comm);
+    const std::int64_t ndofs_global
+        = scaling == "weak" ? ndofs * size : ndofs;
+
+    int num_iterations = 0;
+    if (problem == "poisson")
+    {
+      num_iterations
+          = run_problem(comm, form_poisson_a, form_poisson_L,
+                        functionspace_form_poisson_a, ndofs_global, 1,
+                        structured, output);
+    }
+    else
+    {
+      num_iterations
+          = run_problem(comm, form_elasticity_a, form_elasticity_L,
+                        functionspace_form_elasticity_a, ndofs_global, 3,
+                        structured, output);
+    }
+
+    // Collect per-phase wall times into a Table and reduce over ranks
+    Table table("Performance summary");
+    for (const std::string& phase : phases)
+    {
+      const auto [count, wall, user, system] = timing(phase);
+      table.set(phase, "wall", wall);
+    }
+    const Table t_min = table.reduce(comm, Table::Reduction::min);
+    const Table t_max = table.reduce(comm, Table::Reduction::max);
+    const Table t_avg = table.reduce(comm, Table::Reduction::average);
+
+    if (dolfinx::MPI::rank(comm) == 0)
+    {
+      std::cout << std::setprecision(6) << "{\"problem\": \"" << problem
+                << "\", \"scaling\": \"" << scaling << "\", \"ranks\": "
+                << size << ", \"ndofs\": " << ndofs_global
+                << ", \"iterations\": " << num_iterations
+                << ", \"phases\": {";
+      for (std::size_t i = 0; i < phases.size(); ++i)
+      {
+        const double min = wall_time(t_min, phases[i]);
+        const double max = wall_time(t_max, phases[i]);
+        const double avg = wall_time(t_avg, phases[i]);
+        const double imbalance = avg > 0.0 ? max / avg : 0.0;
+        // Strip the "performance: " prefix for the report
+        std::cout << (i == 0 ? "" : ", ") << "\""
+                  << phases[i].substr(std::strlen("performance: "))
+                  << "\": {\"min\": " << min << ", \"max\": " << max
+                  << ", \"avg\": " << avg << ", \"imbalance\": " << imbalance
+                  << "}";
+      }
+      std::cout << "}}" << std::endl;
+    }
+  }
+
+  common::subsystem::finalize_petsc();
+  return 0;
+}
@@ -6,6 +6,8 @@
 
 #include "IndexMap.h"
 #include <algorithm>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/sort.h>
 #include <functional>
 #include <numeric>
 #include <unordered_map>
@@ -144,6 +146,191 @@ compute_owned_shared(MPI_Comm comm, const xtl::span<const std::int64_t>& ghosts,
   return {recv_indices, recv_disp};
 }
 //-----------------------------------------------------------------------------
+
+/// Determine the owning rank of ghost indices with a distributed
+/// directory (rendezvous) lookup. Each global index is assigned a
+/// directory rank by MPI::index_owner (uniform block distribution over
+/// [0, size_global)). Owning ranks first register their ownership range
+/// with the directory ranks covering it, and the owner of each ghost is
+/// then found by querying the directory rank of the ghost index. Both
+/// phases use the NBX algorithm to discover incoming messages, so the
+/// cost scales with the number of ghosts rather than the communicator
+/// size.
+///
+/// @param[in] comm The MPI communicator
+/// @param[in] local_range Global index range owned by the caller
+/// @param[in] size_global Global size of the index set
+/// @param[in] ghosts Global indices of ghost entries on the caller
+/// @return The owning rank (on @p comm) of each entry in @p ghosts
+std::vector<int>
+locate_ghost_owners(MPI_Comm comm, std::array<std::int64_t, 2> local_range,
+                    std::int64_t size_global,
+                    const xtl::span<const std::int64_t>& ghosts)
+{
+  const int mpi_size = dolfinx::MPI::size(comm);
+
+  // Message tags for the registration, query and reply phases
+  constexpr int tag_register = 1201, tag_query = 1202, tag_reply = 1203;
+
+  // --- Phase 1: register the caller's ownership range with the
+  // directory ranks that cover it
+
+  std::vector<MPI_Request> send_requests;
+  if (local_range[1] > local_range[0])
+  {
+    const int d0
+        = dolfinx::MPI::index_owner(mpi_size, local_range[0], size_global);
+    const int d1
+        = dolfinx::MPI::index_owner(mpi_size, local_range[1] - 1, size_global);
+    send_requests.resize(d1 - d0 + 1, MPI_REQUEST_NULL);
+    for (int d = d0; d <= d1; ++d)
+    {
+      MPI_Issend(local_range.data(), 2, MPI_INT64_T, d, tag_register, comm,
+                 &send_requests[d - d0]);
+    }
+  }
+
+  // Receive the ownership ranges registered with this rank's directory
+  // block, with consensus on completion via a non-blocking barrier
+  // (entered once the local synchronous sends have been matched)
+  std::vector<std::array<std::int64_t, 3>> directory;
+  MPI_Request barrier = MPI_REQUEST_NULL;
+  int comm_done = 0;
+  while (!comm_done)
+  {
+    int message_pending = 0;
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, tag_register, comm, &message_pending, &status);
+    if (message_pending)
+    {
+      std::array<std::int64_t, 2> range;
+      MPI_Recv(range.data(), 2, MPI_INT64_T, status.MPI_SOURCE, tag_register,
+               comm, MPI_STATUS_IGNORE);
+      directory.push_back({range[0], range[1], status.MPI_SOURCE});
+    }
+
+    if (barrier == MPI_REQUEST_NULL)
+    {
+      int sends_done = 0;
+      MPI_Testall(send_requests.size(), send_requests.data(), &sends_done,
+                  MPI_STATUSES_IGNORE);
+      if (sends_done)
+        MPI_Ibarrier(comm, &barrier);
+    }
+    else
+      MPI_Test(&barrier, &comm_done, MPI_STATUS_IGNORE);
+  }
+  std::sort(directory.begin(), directory.end());
+
+  // --- Phase 2: query the directory rank of each ghost index for the
+  // owning rank
+
+  // Group ghosts by directory rank
+  std::vector<int> dir_rank(ghosts.size());
+  std::transform(ghosts.cbegin(), ghosts.cend(), dir_rank.begin(),
+                 [mpi_size, size_global](std::int64_t idx)
+                 { return dolfinx::MPI::index_owner(mpi_size, idx, size_global); });
+  std::vector<std::int32_t> perm(ghosts.size());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::sort(perm.begin(), perm.end(), [&dir_rank](auto a, auto b)
+            { return dir_rank[a] < dir_rank[b]; });
+
+  std::vector<int> dest;
+  std::vector<std::vector<std::int64_t>> query_send;
+  std::vector<std::vector<std::int32_t>> query_pos;
+  for (std::int32_t p : perm)
+  {
+    if (dest.empty() or dir_rank[p] != dest.back())
+    {
+      dest.push_back(dir_rank[p]);
+      query_send.emplace_back();
+      query_pos.emplace_back();
+    }
+    query_send.back().push_back(ghosts[p]);
+    query_pos.back().push_back(p);
+  }
+
+  // Post receives for the replies (one per queried directory rank, with
+  // known size and source)
+  std::vector<std::vector<int>> reply_recv(dest.size());
+  std::vector<MPI_Request> recv_requests(dest.size(), MPI_REQUEST_NULL);
+  for (std::size_t p = 0; p < dest.size(); ++p)
+  {
+    reply_recv[p].resize(query_send[p].size());
+    MPI_Irecv(reply_recv[p].data(), reply_recv[p].size(), MPI_INT, dest[p],
+              tag_reply, comm, &recv_requests[p]);
+  }
+
+  // Send queries, and answer incoming queries for this rank's directory
+  // block as they arrive
+  send_requests.assign(dest.size(), MPI_REQUEST_NULL);
+  for (std::size_t p = 0; p < dest.size(); ++p)
+  {
+    MPI_Issend(query_send[p].data(), query_send[p].size(), MPI_INT64_T, dest[p],
+               tag_query, comm, &send_requests[p]);
+  }
+
+  std::vector<std::vector<int>> reply_send;
+  std::vector<MPI_Request> reply_requests;
+  barrier = MPI_REQUEST_NULL;
+  comm_done = 0;
+  while (!comm_done)
+  {
+    int message_pending = 0;
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, tag_query, comm, &message_pending, &status);
+    if (message_pending)
+    {
+      int count = 0;
+      MPI_Get_count(&status, MPI_INT64_T, &count);
+      std::vector<std::int64_t> query(count);
+      MPI_Recv(query.data(), count, MPI_INT64_T, status.MPI_SOURCE, tag_query,
+               comm, MPI_STATUS_IGNORE);
+
+      // Look up the registered owner of each queried index
+      std::vector<int>& owner_reply = reply_send.emplace_back(count);
+      for (int i = 0; i < count; ++i)
+      {
+        auto it = std::upper_bound(directory.cbegin(), directory.cend(),
+                                   query[i],
+                                   [](std::int64_t idx, const auto& range)
+                                   { return idx < range[0]; });
+        assert(it != directory.cbegin());
+        --it;
+        assert((*it)[0] <= query[i] and query[i] < (*it)[1]);
+        owner_reply[i] = (*it)[2];
+      }
+
+      reply_requests.push_back(MPI_REQUEST_NULL);
+      MPI_Isend(owner_reply.data(), owner_reply.size(), MPI_INT,
+                status.MPI_SOURCE, tag_reply, comm, &reply_requests.back());
+    }
+
+    if (barrier == MPI_REQUEST_NULL)
+    {
+      int sends_done = 0;
+      MPI_Testall(send_requests.size(), send_requests.data(), &sends_done,
+                  MPI_STATUSES_IGNORE);
+      if (sends_done)
+        MPI_Ibarrier(comm, &barrier);
+    }
+    else
+      MPI_Test(&barrier, &comm_done, MPI_STATUS_IGNORE);
+  }
+
+  // Unpack the replies into the ghost ordering
+  MPI_Waitall(recv_requests.size(), recv_requests.data(), MPI_STATUSES_IGNORE);
+  std::vector<int> owners(ghosts.size());
+  for (std::size_t p = 0; p < dest.size(); ++p)
+    for (std::size_t i = 0; i < query_pos[p].size(); ++i)
+      owners[query_pos[p][i]] = reply_recv[p][i];
+
+  MPI_Waitall(reply_requests.size(), reply_requests.data(),
+              MPI_STATUSES_IGNORE);
+
+  return owners;
+}
+//-----------------------------------------------------------------------------
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -267,6 +454,32 @@ common::stack_index_maps(
           std::move(ghost_owners_new)};
 }
 //-----------------------------------------------------------------------------
+common::IndexMap
+common::create_index_map(MPI_Comm comm, std::int32_t local_size,
+                         const xtl::span<const std::int64_t>& ghosts)
+{
+  // Compute the global offset and size, which define the directory
+  // distribution
+  std::int64_t offset = 0;
+  const std::int64_t local_size_tmp = local_size;
+  MPI_Request request_scan;
+  MPI_Iexscan(&local_size_tmp, &offset, 1, MPI_INT64_T, MPI_SUM, comm,
+              &request_scan);
+  std::int64_t size_global = 0;
+  MPI_Allreduce(&local_size_tmp, &size_global, 1, MPI_INT64_T, MPI_SUM, comm);
+  MPI_Wait(&request_scan, MPI_STATUS_IGNORE);
+
+  // Resolve the owning rank of each ghost via the distributed directory
+  const std::vector<int> owners = locate_ghost_owners(
+      comm, {offset, offset + local_size}, size_global, ghosts);
+
+  // Determine the ranks that ghost indices owned by the caller
+  const std::vector<int> dest_ranks = dolfinx::MPI::compute_graph_edges_nbx(
+      comm, std::set<int>(owners.begin(), owners.end()));
+
+  return IndexMap(comm, local_size, dest_ranks, ghosts, owners);
+}
+//-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 IndexMap::IndexMap(MPI_Comm comm, std::int32_t local_size)
     : _comm(comm), _comm_owner_to_ghost(MPI_COMM_NULL),
@@ -303,6 +516,8 @@ IndexMap::IndexMap(MPI_Comm comm, std::int32_t local_size)
   _comm_owner_to_ghost = dolfinx::MPI::Comm(comm0, false);
   _comm_ghost_to_owner = dolfinx::MPI::Comm(comm1, false);
   _shared_indices = std::make_unique<graph::AdjacencyList<std::int32_t>>(0);
+
+  build_ghost_lookup();
 }
 //-----------------------------------------------------------------------------
 IndexMap::IndexMap(MPI_Comm mpi_comm, std::int32_t local_size,
@@ -424,6 +639,29 @@ IndexMap::IndexMap(MPI_Comm mpi_comm, std::int32_t local_size,
                  _ghost_pos_recv_fwd.begin(),
                  [displs = _displs_recv_fwd](auto owner) mutable
                  { return displs[owner]++; });
+
+  // Account for the ghost and scatter index/displacement storage
+  register_memory(
+      "IndexMap (scatter)",
+      std::int64_t(sizeof(std::int64_t)) * _ghosts.size()
+          + sizeof(std::int32_t)
+                * (_shared_indices->array().size()
+                   + _shared_indices->offsets().size()
+                   + _ghost_pos_recv_fwd.size())
+          + sizeof(int)
+                * (_sizes_recv_fwd.size() + _sizes_send_fwd.size()
+                   + _displs_recv_fwd.size()));
+
+  build_ghost_lookup();
+}
+//-----------------------------------------------------------------------------
+void IndexMap::build_ghost_lookup()
+{
+  _ghosts_sorted = _ghosts;
+  _ghosts_sorted_pos.resize(_ghosts.size());
+  std::iota(_ghosts_sorted_pos.begin(), _ghosts_sorted_pos.end(), 0);
+  radix_sort_by_key(xtl::span<std::int64_t>(_ghosts_sorted),
+                    xtl::span<std::int32_t>(_ghosts_sorted_pos));
 }
 //-----------------------------------------------------------------------------
 std::array<std::int64_t, 2> IndexMap::local_range() const noexcept
@@ -467,27 +705,35 @@ void IndexMap::local_to_global(const xtl::span<const std::int32_t>& local,
 void IndexMap::global_to_local(const xtl::span<const std::int64_t>& global,
                                const xtl::span<std::int32_t>& local) const
 {
-  const std::int32_t local_size = _local_range[1] - _local_range[0];
-
-  std::vector<std::pair<std::int64_t, std::int32_t>> global_local_ghosts(
-      _ghosts.size());
-  for (std::size_t i = 0; i < _ghosts.size(); ++i)
-    global_local_ghosts[i] = {_ghosts[i], i + local_size};
-  std::map<std::int64_t, std::int32_t> global_to_local(
-      global_local_ghosts.begin(), global_local_ghosts.end());
+  const std::array<std::int64_t, 2> range = _local_range;
+  const std::int32_t local_size = range[1] - range[0];
+  const std::int64_t* ghosts = _ghosts_sorted.data();
+  const std::size_t num_ghosts = _ghosts_sorted.size();
+  std::transform(
+      global.cbegin(), global.cend(), local.begin(),
+      [&](std::int64_t index) -> std::int32_t
+      {
+        if (index >= range[0] and index < range[1])
+          return index - range[0];
+
+        // Branch-free binary search over the sorted ghost indices,
+        // prefetching the two possible next probe positions
+        const std::int64_t* base = ghosts;
+        std::size_t n = num_ghosts;
+        while (n > 1)
+        {
+          const std::size_t half = n / 2;
+          __builtin_prefetch(base + half / 2);
+          __builtin_prefetch(base + half + (n - half) / 2);
+          base += (base[half - 1] < index) ? half : 0;
+          n -= half;
+        }
 
-  std::transform(global.cbegin(), global.cend(), local.begin(),
-                 [range = _local_range,
-                  &global_to_local](std::int64_t index) -> std::int32_t
-                 {
-                   if (index >= range[0] and index < range[1])
-                     return index - range[0];
-                   else
-                   {
-                     auto it = global_to_local.find(index);
-                     return it != global_to_local.end() ? it->second : -1;
-                   }
-                 });
+        if (n == 1 and *base == index)
+          return local_size + _ghosts_sorted_pos[base - ghosts];
+        else
+          return -1;
+      });
 }
 //-----------------------------------------------------------------------------
 std::vector<std::int64_t> IndexMap::global_indices() const
@@ -6,13 +6,16 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Telemetry.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <map>
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <xtl/xspan.hpp>
@@ -38,6 +41,25 @@ stack_index_maps(
     const std::vector<
         std::pair<std::reference_wrapper<const common::IndexMap>, int>>& maps);
 
+/// Create an IndexMap when the owning rank of each ghost index is not
+/// known by the caller. Ownership is resolved with a distributed
+/// directory (rendezvous) lookup: each index is assigned a directory
+/// rank by `MPI::index_owner` (uniform block distribution), owning
+/// ranks register their range with the directory, and ghost owners are
+/// found by querying the directory with point-to-point messages. The
+/// communication cost therefore scales with the number of ghosts rather
+/// than with the communicator size.
+///
+/// @note Collective
+/// @param[in] comm The MPI communicator
+/// @param[in] local_size Local size of the IndexMap, i.e. the number of
+/// owned entries
+/// @param[in] ghosts The global indices of ghost entries
+/// @return An IndexMap with the ghost owners determined by the
+/// directory lookup
+IndexMap create_index_map(MPI_Comm comm, std::int32_t local_size,
+                          const xtl::span<const std::int64_t>& ghosts);
+
 /// This class represents the distribution index arrays across
 /// processes. An index array is a contiguous collection of N+1 indices
 /// [0, 1, . . ., N] that are distributed across M processes. On a given
@@ -48,11 +70,17 @@ stack_index_maps(
 class IndexMap
 {
 public:
-  /// Mode for reverse scatter operation
+  /// Mode for reverse scatter operation. The received ghost
+  /// contributions overwrite (insert), sum into (add) or are combined
+  /// element-wise (min, max) with the owned values. The min and max
+  /// modes require ordered (real) data. For other combine operations
+  /// see the scatter_rev overload taking a binary operation.
   enum class Mode
   {
     insert,
-    add
+    add,
+    min,
+    max
   };
 
   /// Edge directions of neighborhood communicator
@@ -110,6 +138,8 @@ private:
     _sizes_send_fwd.resize(_shared_indices->num_nodes(), 0);
     std::adjacent_difference(displs_send.cbegin() + 1, displs_send.cend(),
                              _sizes_send_fwd.begin());
+
+    build_ghost_lookup();
   }
 
 public:
@@ -259,6 +289,9 @@ public:
     if (static_cast<int>(recv_buffer.size()) != n * _displs_recv_fwd.back())
       throw std::runtime_error("Incompatible receive buffer size..");
 
+    telemetry::emit(telemetry::Channel::scatter_forward, send_buffer.size(),
+                    double(sizeof(T)) * send_buffer.size());
+
     // Start send/receive
     MPI_Ineighbor_alltoallv(send_buffer.data(), _sizes_send_fwd.data(),
                             displs_send_fwd.data(), data_type,
@@ -284,49 +317,129 @@ public:
     MPI_Wait(&request, MPI_STATUS_IGNORE);
   }
 
+  /// Start a forward scatter on a persistent communication channel.
+  /// With an MPI-4 library, the first call (with `request ==
+  /// MPI_REQUEST_NULL`) builds a persistent `MPI_Neighbor_alltoallv`
+  /// operation bound to the given buffers and subsequent calls only
+  /// trigger it, avoiding the per-call setup cost of
+  /// IndexMap::scatter_fwd_begin. The same buffer memory must therefore
+  /// be passed on every call with a given request, and the caller must
+  /// free the request with `MPI_Request_free` when the channel is no
+  /// longer needed. Without MPI-4 support this function falls back to
+  /// IndexMap::scatter_fwd_begin. The communication is completed by
+  /// calling IndexMap::scatter_fwd_wait.
+  ///
+  /// @param[in] send_buffer Local data associated with each owned local
+  /// index to be sent to process where the data is ghosted. The order
+  /// of data in the buffer is given by IndexMap::scatter_fwd_indices.
+  /// @param data_type The MPI data type. To send data with a block size
+  /// use `MPI_Type_contiguous` with size `n`
+  /// @param request The persistent MPI request handle. Pass
+  /// `MPI_REQUEST_NULL` on the first call to create the channel.
+  /// @param recv_buffer A buffer used for the received data. The
+  /// position of ghost entries in the buffer is given by
+  /// IndexMap::scatter_fwd_ghost_positions.
+  template <typename T>
+  void scatter_fwd_start(const xtl::span<const T>& send_buffer,
+                         MPI_Datatype& data_type, MPI_Request& request,
+                         const xtl::span<T>& recv_buffer) const
+  {
+#if MPI_VERSION >= 4
+    // Send displacement
+    const std::vector<int32_t>& displs_send_fwd = _shared_indices->offsets();
+
+    // Return early if there are no incoming or outgoing edges
+    if (_displs_recv_fwd.size() == 1 and displs_send_fwd.size() == 1)
+      return;
+
+    if (request == MPI_REQUEST_NULL)
+    {
+      // Get block size
+      int n;
+      MPI_Type_size(data_type, &n);
+      n /= sizeof(T);
+      if (static_cast<int>(send_buffer.size()) != n * displs_send_fwd.back())
+        throw std::runtime_error("Incompatible send buffer size.");
+      if (static_cast<int>(recv_buffer.size()) != n * _displs_recv_fwd.back())
+        throw std::runtime_error("Incompatible receive buffer size..");
+
+      // Create persistent send/receive operation bound to the buffers
+      MPI_Neighbor_alltoallv_init(
+          send_buffer.data(), _sizes_send_fwd.data(), displs_send_fwd.data(),
+          data_type, recv_buffer.data(), _sizes_recv_fwd.data(),
+          _displs_recv_fwd.data(), data_type, _comm_owner_to_ghost.comm(),
+          MPI_INFO_NULL, &request);
+    }
+
+    MPI_Start(&request);
+#else
+    scatter_fwd_begin(send_buffer, data_type, request, recv_buffer);
+#endif
+  }
+
+  /// Complete a forward scatter started by IndexMap::scatter_fwd_start.
+  /// The persistent request remains allocated and can be re-started.
+  ///
+  /// @param[in] request The MPI request handle for tracking the status
+  /// of the send
+  void scatter_fwd_wait(MPI_Request& request) const
+  {
+    scatter_fwd_end(request);
+  }
+
   /// Send n values for each index that is owned to processes that have
   /// the index as a ghost. The size of the input array local_data must
   /// be the same as n * size_local().
   ///
+  /// The buffer scalar type `S` defaults to the data type `T`. To
+  /// reduce the communication volume it can be set to a lower precision
+  /// type (e.g. `float` for `T` double): values are then narrowed to
+  /// `S` when packed and widened back to `T` on receive.
+  ///
   /// @param[in] local_data Local data associated with each owned local
   /// index to be sent to process where the data is ghosted. Size must
   /// be n * size_local().
   /// @param[in,out] remote_data Ghost data on this process received
   /// from the owning process. Size will be n * num_ghosts().
   /// @param[in] n Number of data items per index
-  template <typename T>
+  template <typename T, typename S = T>
   void scatter_fwd(const xtl::span<const T>& local_data,
                    xtl::span<T> remote_data, int n) const
   {
     MPI_Datatype data_type;
     if (n == 1)
-      data_type = dolfinx::MPI::mpi_type<T>();
+      data_type = dolfinx::MPI::mpi_type<S>();
     else
     {
-      MPI_Type_contiguous(n, dolfinx::MPI::mpi_type<T>(), &data_type);
+      MPI_Type_contiguous(n, dolfinx::MPI::mpi_type<S>(), &data_type);
       MPI_Type_commit(&data_type);
     }
 
     const std::vector<std::int32_t>& indices = _shared_indices->array();
-    std::vector<T> send_buffer(n * indices.size());
+    std::vector<S> send_buffer(n * indices.size());
     for (std::size_t i = 0; i < indices.size(); ++i)
     {
-      std::copy_n(std::next(local_data.cbegin(), n * indices[i]), n,
-                  std::next(send_buffer.begin(), n * i));
+      std::transform(std::next(local_data.cbegin(), n * indices[i]),
+                     std::next(local_data.cbegin(), n * indices[i] + n),
+                     std::next(send_buffer.begin(), n * i),
+                     [](T v) { return static_cast<S>(v); });
     }
 
     MPI_Request request;
-    std::vector<T> buffer_recv(n * _displs_recv_fwd.back());
-    scatter_fwd_begin(xtl::span<const T>(send_buffer), data_type, request,
-                      xtl::span<T>(buffer_recv));
+    std::vector<S> buffer_recv(n * _displs_recv_fwd.back());
+    scatter_fwd_begin(xtl::span<const S>(send_buffer), data_type, request,
+                      xtl::span<S>(buffer_recv));
     scatter_fwd_end(request);
 
     // Copy into ghost area ("remote_data")
     assert(remote_data.size() == n * _ghost_pos_recv_fwd.size());
     for (std::size_t i = 0; i < _ghost_pos_recv_fwd.size(); ++i)
     {
-      std::copy_n(std::next(buffer_recv.cbegin(), n * _ghost_pos_recv_fwd[i]),
-                  n, std::next(remote_data.begin(), n * i));
+      const int pos = _ghost_pos_recv_fwd[i];
+      std::transform(std::next(buffer_recv.cbegin(), n * pos),
+                     std::next(buffer_recv.cbegin(), n * pos + n),
+                     std::next(remote_data.begin(), n * i),
+                     [](S v) { return static_cast<T>(v); });
     }
 
     if (n != 1)
@@ -374,6 +487,9 @@ public:
     if (static_cast<int>(recv_buffer.size()) != n * displs_send_fwd.back())
       throw std::runtime_error("Inconsistent receive buffer size.");
 
+    telemetry::emit(telemetry::Channel::scatter_reverse, send_buffer.size(),
+                    double(sizeof(T)) * send_buffer.size());
+
     // Send and receive data
     MPI_Ineighbor_alltoallv(send_buffer.data(), _sizes_recv_fwd.data(),
                             _displs_recv_fwd.data(), data_type,
@@ -399,43 +515,116 @@ public:
     MPI_Wait(&request, MPI_STATUS_IGNORE);
   }
 
+  /// Start a reverse scatter on a persistent communication channel. A
+  /// reverse scatter is the transpose of IndexMap::scatter_fwd_start;
+  /// see there for the channel semantics (buffer binding, request
+  /// lifetime and the fallback without MPI-4 support). The
+  /// communication is completed by calling IndexMap::scatter_rev_wait.
+  ///
+  /// @param[in] send_buffer Send buffer filled with ghost data on this
+  /// process to be sent to the owning rank. The order of the data is
+  /// given by IndexMap::scatter_fwd_ghost_positions.
+  /// @param data_type The MPI data type. To send data with a block size
+  /// use `MPI_Type_contiguous` with size `n`
+  /// @param request The persistent MPI request handle. Pass
+  /// `MPI_REQUEST_NULL` on the first call to create the channel.
+  /// @param recv_buffer A buffer used for the received data. The
+  /// ordering of the data is given by IndexMap::scatter_fwd_indices.
+  template <typename T>
+  void scatter_rev_start(const xtl::span<const T>& send_buffer,
+                         MPI_Datatype& data_type, MPI_Request& request,
+                         const xtl::span<T>& recv_buffer) const
+  {
+#if MPI_VERSION >= 4
+    // Get displacement vector
+    const std::vector<int32_t>& displs_send_fwd = _shared_indices->offsets();
+
+    // Return early if there are no incoming or outgoing edges
+    if (_displs_recv_fwd.size() == 1 and displs_send_fwd.size() == 1)
+      return;
+
+    if (request == MPI_REQUEST_NULL)
+    {
+      // Get block size
+      int n;
+      MPI_Type_size(data_type, &n);
+      n /= sizeof(T);
+      if (static_cast<int>(send_buffer.size()) != n * _ghosts.size())
+        throw std::runtime_error("Inconsistent send buffer size.");
+      if (static_cast<int>(recv_buffer.size()) != n * displs_send_fwd.back())
+        throw std::runtime_error("Inconsistent receive buffer size.");
+
+      // Create persistent send/receive operation bound to the buffers
+      MPI_Neighbor_alltoallv_init(
+          send_buffer.data(), _sizes_recv_fwd.data(), _displs_recv_fwd.data(),
+          data_type, recv_buffer.data(), _sizes_send_fwd.data(),
+          displs_send_fwd.data(), data_type, _comm_ghost_to_owner.comm(),
+          MPI_INFO_NULL, &request);
+    }
+
+    MPI_Start(&request);
+#else
+    scatter_rev_begin(send_buffer, data_type, request, recv_buffer);
+#endif
+  }
+
+  /// Complete a reverse scatter started by IndexMap::scatter_rev_start.
+  /// The persistent request remains allocated and can be re-started.
+  ///
+  /// @param[in] request The MPI request handle for tracking the status
+  /// of the send
+  void scatter_rev_wait(MPI_Request& request) const
+  {
+    scatter_rev_end(request);
+  }
+
   /// Send n values for each ghost index to owning to the process
   ///
+  /// The buffer scalar type `S` defaults to the data type `T`. To
+  /// reduce the communication volume it can be set to a lower precision
+  /// type (e.g. `float` for `T` double): values are then narrowed to
+  /// `S` when packed and widened back to `T` on receive.
+  ///
   /// @param[in,out] local_data Local data associated with each owned
   /// local index to be sent to process where the data is ghosted. Size
   /// must be n * size_local().
   /// @param[in] remote_data Ghost data on this process received from
   /// the owning process. Size will be n * num_ghosts().
   /// @param[in] n Number of data items per index
-  /// @param[in] op Sum or set received values in local_data
-  template <typename T>
+  /// @param[in] op How received values are combined into local_data
+  /// (set, sum, minimum or maximum). The min and max modes require
+  /// ordered (real) data.
+  template <typename T, typename S = T>
   void scatter_rev(xtl::span<T> local_data,
                    const xtl::span<const T>& remote_data, int n,
                    IndexMap::Mode op) const
   {
     MPI_Datatype data_type;
     if (n == 1)
-      data_type = MPI::mpi_type<T>();
+      data_type = MPI::mpi_type<S>();
     else
     {
-      MPI_Type_contiguous(n, dolfinx::MPI::mpi_type<T>(), &data_type);
+      MPI_Type_contiguous(n, dolfinx::MPI::mpi_type<S>(), &data_type);
       MPI_Type_commit(&data_type);
     }
 
     // Pack send buffer
-    std::vector<T> buffer_send;
+    std::vector<S> buffer_send;
     buffer_send.resize(n * _displs_recv_fwd.back());
     for (std::size_t i = 0; i < _ghost_pos_recv_fwd.size(); ++i)
     {
-      std::copy_n(std::next(remote_data.cbegin(), n * i), n,
-                  std::next(buffer_send.begin(), n * _ghost_pos_recv_fwd[i]));
+      std::transform(
+          std::next(remote_data.cbegin(), n * i),
+          std::next(remote_data.cbegin(), n * i + n),
+          std::next(buffer_send.begin(), n * _ghost_pos_recv_fwd[i]),
+          [](T v) { return static_cast<S>(v); });
     }
 
     // Exchange data
     MPI_Request request;
-    std::vector<T> buffer_recv(n * _shared_indices->array().size());
-    scatter_rev_begin(xtl::span<const T>(buffer_send), data_type, request,
-                      xtl::span<T>(buffer_recv));
+    std::vector<S> buffer_recv(n * _shared_indices->array().size());
+    scatter_rev_begin(xtl::span<const S>(buffer_send), data_type, request,
+                      xtl::span<S>(buffer_recv));
     scatter_rev_end(request);
 
     // Copy or accumulate into "local_data"
@@ -446,16 +635,51 @@ public:
     case Mode::insert:
       for (std::size_t i = 0; i < shared_indices.size(); ++i)
       {
-        std::copy_n(std::next(buffer_recv.cbegin(), n * i), n,
-                    std::next(local_data.begin(), n * shared_indices[i]));
+        std::transform(std::next(buffer_recv.cbegin(), n * i),
+                       std::next(buffer_recv.cbegin(), n * i + n),
+                       std::next(local_data.begin(), n * shared_indices[i]),
+                       [](S v) { return static_cast<T>(v); });
       }
       break;
     case Mode::add:
       for (std::size_t i = 0; i < shared_indices.size(); ++i)
       {
         for (int j = 0; j < n; ++j)
-          local_data[shared_indices[i] * n + j] += buffer_recv[i * n + j];
+        {
+          local_data[shared_indices[i] * n + j]
+              += static_cast<T>(buffer_recv[i * n + j]);
+        }
+      }
+      break;
+    case Mode::min:
+      if constexpr (std::is_arithmetic<T>::value)
+      {
+        for (std::size_t i = 0; i < shared_indices.size(); ++i)
+        {
+          for (int j = 0; j < n; ++j)
+          {
+            T& u = local_data[shared_indices[i] * n + j];
+            u = std::min(u, static_cast<T>(buffer_recv[i * n + j]));
+          }
+        }
       }
+      else
+        throw std::runtime_error("Mode::min requires ordered data.");
+      break;
+    case Mode::max:
+      if constexpr (std::is_arithmetic<T>::value)
+      {
+        for (std::size_t i = 0; i < shared_indices.size(); ++i)
+        {
+          for (int j = 0; j < n; ++j)
+          {
+            T& u = local_data[shared_indices[i] * n + j];
+            u = std::max(u, static_cast<T>(buffer_recv[i * n + j]));
+          }
+        }
+      }
+      else
+        throw std::runtime_error("Mode::max requires ordered data.");
       break;
     }
 
@@ -463,7 +687,81 @@ public:
       MPI_Type_free(&data_type);
   }
 
+  /// Send n values for each ghost index to the owning process and
+  /// combine them into the owned values with a caller-supplied binary
+  /// operation
+  ///
+  /// The buffer scalar type `S` defaults to the data type `T`, and can
+  /// be set to a lower precision type to reduce the communication
+  /// volume (see the Mode overload).
+  ///
+  /// @param[in,out] local_data Local data associated with each owned
+  /// local index to be combined with received ghost contributions. Size
+  /// must be n * size_local().
+  /// @param[in] remote_data Ghost data on this process sent to the
+  /// owning process. Size will be n * num_ghosts().
+  /// @param[in] n Number of data items per index
+  /// @param[in] op Binary operation combining the current owned value
+  /// (first argument) with one received contribution (second argument),
+  /// applied once per contribution. The operation should be associative
+  /// and commutative since the order in which contributions arrive is
+  /// not defined.
+  template <typename T, typename S = T, typename BinaryOp,
+            typename
+            = std::enable_if_t<std::is_invocable_r<T, BinaryOp, T, T>::value>>
+  void scatter_rev(xtl::span<T> local_data,
+                   const xtl::span<const T>& remote_data, int n,
+                   BinaryOp op) const
+  {
+    MPI_Datatype data_type;
+    if (n == 1)
+      data_type = MPI::mpi_type<S>();
+    else
+    {
+      MPI_Type_contiguous(n, dolfinx::MPI::mpi_type<S>(), &data_type);
+      MPI_Type_commit(&data_type);
+    }
+
+    // Pack send buffer
+    std::vector<S> buffer_send;
+    buffer_send.resize(n * _displs_recv_fwd.back());
+    for (std::size_t i = 0; i < _ghost_pos_recv_fwd.size(); ++i)
+    {
+      std::transform(
+          std::next(remote_data.cbegin(), n * i),
+          std::next(remote_data.cbegin(), n * i + n),
+          std::next(buffer_send.begin(), n * _ghost_pos_recv_fwd[i]),
+          [](T v) { return static_cast<S>(v); });
+    }
+
+    // Exchange data
+    MPI_Request request;
+    std::vector<S> buffer_recv(n * _shared_indices->array().size());
+    scatter_rev_begin(xtl::span<const S>(buffer_send), data_type, request,
+                      xtl::span<S>(buffer_recv));
+    scatter_rev_end(request);
+
+    // Combine received contributions into "local_data"
+    assert(local_data.size() == n * this->size_local());
+    const std::vector<std::int32_t>& shared_indices = _shared_indices->array();
+    for (std::size_t i = 0; i < shared_indices.size(); ++i)
+    {
+      for (int j = 0; j < n; ++j)
+      {
+        T& u = local_data[shared_indices[i] * n + j];
+        u = op(u, static_cast<T>(buffer_recv[i * n + j]));
+      }
+    }
+
+    if (n != 1)
+      MPI_Type_free(&data_type);
+  }
+
 private:
+  // Build the sorted ghost lookup (_ghosts_sorted,
+  // _ghosts_sorted_pos). Called at the end of construction.
+  void build_ghost_lookup();
+
   // Range of indices (global) owned by this process
   std::array<std::int64_t, 2> _local_range;
 
@@ -498,6 +796,13 @@ private:
   // Local-to-global map for ghost indices
   std::vector<std::int64_t> _ghosts;
 
+  // Ghost global indices sorted ascending, and for each sorted entry
+  // its position in _ghosts. Built once at construction and used by
+  // global_to_local to resolve ghost indices by binary search without
+  // any per-call allocation.
+  std::vector<std::int64_t> _ghosts_sorted;
+  std::vector<std::int32_t> _ghosts_sorted_pos;
+
   // List of owned local indices that are in the ghost (halo) region on
   // other ranks, grouped by rank in the neighbor communicator
   // (destination ranks in forward communicator and source ranks in the
@@ -6,6 +6,7 @@
 
 #include "MPI.h"
 #include <algorithm>
+#include <cstddef>
 
 //-----------------------------------------------------------------------------
 dolfinx::MPI::Comm::Comm(MPI_Comm comm, bool duplicate)
@@ -107,6 +108,57 @@ std::vector<int> dolfinx::MPI::compute_graph_edges(MPI_Comm comm,
   return edges1;
 }
 //-----------------------------------------------------------------------------
+std::vector<int>
+dolfinx::MPI::compute_graph_edges_nbx(MPI_Comm comm, const std::set<int>& edges)
+{
+  // Tag for the NBX edge notification messages
+  constexpr int tag = 1200;
+
+  // Send a zero-length synchronous message to each rank that I have an
+  // edge to
+  std::vector<MPI_Request> send_requests(edges.size(), MPI_REQUEST_NULL);
+  std::byte send_buffer;
+  {
+    std::size_t i = 0;
+    for (int e : edges)
+      MPI_Issend(&send_buffer, 0, MPI_BYTE, e, tag, comm, &send_requests[i++]);
+  }
+
+  // Probe for incoming messages until all ranks have received the
+  // messages addressed to them (consensus via a non-blocking barrier,
+  // started once the local sends have been matched)
+  std::vector<int> edges1;
+  MPI_Request barrier = MPI_REQUEST_NULL;
+  int comm_done = 0;
+  while (!comm_done)
+  {
+    int message_pending = 0;
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, tag, comm, &message_pending, &status);
+    if (message_pending)
+    {
+      std::byte recv_buffer;
+      MPI_Recv(&recv_buffer, 0, MPI_BYTE, status.MPI_SOURCE, tag, comm,
+               MPI_STATUS_IGNORE);
+      edges1.push_back(status.MPI_SOURCE);
+    }
+
+    if (barrier == MPI_REQUEST_NULL)
+    {
+      int sends_done = 0;
+      MPI_Testall(send_requests.size(), send_requests.data(), &sends_done,
+                  MPI_STATUSES_IGNORE);
+      if (sends_done)
+        MPI_Ibarrier(comm, &barrier);
+    }
+    else
+      MPI_Test(&barrier, &comm_done, MPI_STATUS_IGNORE);
+  }
+
+  std::sort(edges1.begin(), edges1.end());
+  return edges1;
+}
+//-----------------------------------------------------------------------------
 std::array<std::vector<int>, 2> dolfinx::MPI::neighbors(MPI_Comm comm)
 {
   int status;
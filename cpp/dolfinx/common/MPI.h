@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <complex>
@@ -68,6 +69,28 @@ template <typename T>
 graph::AdjacencyList<T> all_to_all(MPI_Comm comm,
                                    const graph::AdjacencyList<T>& send_data);
 
+/// Sparse dynamic all-to-all. Send data to a run-time set of
+/// destination ranks and receive data from source ranks that are
+/// discovered during the exchange using the NBX (nonblocking
+/// consensus) algorithm: sends are synchronous-mode, sources are
+/// probed, and completion is detected with a non-blocking barrier once
+/// the local sends have been matched. In contrast to MPI::all_to_all
+/// the cost scales with the number of communicating pairs rather than
+/// with the communicator size.
+///
+/// @note This function is collective on @p comm
+///
+/// @param[in] comm The MPI communicator
+/// @param[in] dest Destination rank for each node of @p send_data.
+/// Ranks may not be repeated; sending to the own rank is permitted.
+/// @param[in] send_data The data to send, one node per destination
+/// @return (source ranks, received data), with one node of the
+/// adjacency list per source rank, sorted by source rank
+template <typename T>
+std::pair<std::vector<int>, graph::AdjacencyList<T>>
+sparse_all_to_all(MPI_Comm comm, const std::vector<int>& dest,
+                  const graph::AdjacencyList<T>& send_data);
+
 /// @todo Experimental. Maybe be moved or removed.
 ///
 /// Compute communication graph edges. The caller provides edges that
@@ -82,6 +105,22 @@ graph::AdjacencyList<T> all_to_all(MPI_Comm comm,
 /// @return Ranks that have defined edges from them to this rank
 std::vector<int> compute_graph_edges(MPI_Comm comm, const std::set<int>& edges);
 
+/// Compute communication graph edges using the NBX (non-blocking
+/// consensus) algorithm. The caller provides edges that it can define,
+/// and will receive edges to it that are defined by other ranks. In
+/// contrast to MPI::compute_graph_edges, which performs an
+/// `MPI_Alltoall`, the cost scales with the number of edges rather than
+/// with the communicator size.
+///
+/// @note This function is collective on @p comm
+///
+/// @param[in] comm The MPI communicator
+/// @param[in] edges Communication edges between the caller and the
+///   ranks in @p edges.
+/// @return Ranks that have defined edges from them to this rank
+std::vector<int> compute_graph_edges_nbx(MPI_Comm comm,
+                                         const std::set<int>& edges);
+
 /// Neighborhood all-to-all. Send data to neighbors.
 /// Send in_values[n0] to neighbor process n0 and receive values from neighbor
 /// process n1 in out_values[n1]
@@ -156,6 +195,12 @@ constexpr MPI_Datatype mpi_type()
     return MPI_DOUBLE;
   else if constexpr (std::is_same<T, std::complex<double>>::value)
     return MPI_DOUBLE_COMPLEX;
+  else if constexpr (std::is_same<T, std::complex<float>>::value)
+    return MPI_C_FLOAT_COMPLEX;
+  else if constexpr (std::is_same<T, signed char>::value)
+    return MPI_INT8_T;
+  else if constexpr (std::is_same<T, unsigned char>::value)
+    return MPI_UINT8_T;
   else if constexpr (std::is_same<T, short int>::value)
     return MPI_SHORT;
   else if constexpr (std::is_same<T, int>::value)
@@ -211,6 +256,88 @@ graph::AdjacencyList<T> all_to_all(MPI_Comm comm,
 }
 //-----------------------------------------------------------------------------
 template <typename T>
+std::pair<std::vector<int>, graph::AdjacencyList<T>>
+sparse_all_to_all(MPI_Comm comm, const std::vector<int>& dest,
+                  const graph::AdjacencyList<T>& send_data)
+{
+  assert(send_data.num_nodes() == (int)dest.size());
+
+  // Tag for the NBX data messages. Distinct from the tag used by
+  // compute_graph_edges_nbx so the exchanges cannot interfere.
+  constexpr int tag = 1201;
+
+  // Start a synchronous-mode send to each destination
+  std::vector<MPI_Request> send_requests(dest.size(), MPI_REQUEST_NULL);
+  for (std::size_t i = 0; i < dest.size(); ++i)
+  {
+    MPI_Issend(send_data.array().data() + send_data.offsets()[i],
+               send_data.num_links(i), mpi_type<T>(), dest[i], tag, comm,
+               &send_requests[i]);
+  }
+
+  // Probe for incoming messages until all ranks have received the
+  // messages addressed to them (consensus via a non-blocking barrier,
+  // started once the local sends have been matched)
+  std::vector<int> src;
+  std::vector<T> recv_data;
+  std::vector<std::int32_t> recv_offsets = {0};
+  MPI_Request barrier = MPI_REQUEST_NULL;
+  int comm_done = 0;
+  while (!comm_done)
+  {
+    int message_pending = 0;
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, tag, comm, &message_pending, &status);
+    if (message_pending)
+    {
+      int count = 0;
+      MPI_Get_count(&status, mpi_type<T>(), &count);
+      recv_data.resize(recv_offsets.back() + count);
+      MPI_Recv(recv_data.data() + recv_offsets.back(), count, mpi_type<T>(),
+               status.MPI_SOURCE, tag, comm, MPI_STATUS_IGNORE);
+      recv_offsets.push_back(recv_offsets.back() + count);
+      src.push_back(status.MPI_SOURCE);
+    }
+
+    if (barrier == MPI_REQUEST_NULL)
+    {
+      int sends_done = 0;
+      MPI_Testall(send_requests.size(), send_requests.data(), &sends_done,
+                  MPI_STATUSES_IGNORE);
+      if (sends_done)
+        MPI_Ibarrier(comm, &barrier);
+    }
+    else
+      MPI_Test(&barrier, &comm_done, MPI_STATUS_IGNORE);
+  }
+
+  // Re-order the received blocks by ascending source rank so the
+  // result does not depend on message arrival order
+  std::vector<std::size_t> perm(src.size());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::sort(perm.begin(), perm.end(),
+            [&src](std::size_t a, std::size_t b) { return src[a] < src[b]; });
+  std::vector<int> src_sorted;
+  src_sorted.reserve(src.size());
+  std::vector<T> data_sorted;
+  data_sorted.reserve(recv_data.size());
+  std::vector<std::int32_t> offsets_sorted = {0};
+  offsets_sorted.reserve(src.size() + 1);
+  for (std::size_t p : perm)
+  {
+    src_sorted.push_back(src[p]);
+    data_sorted.insert(data_sorted.end(),
+                       std::next(recv_data.begin(), recv_offsets[p]),
+                       std::next(recv_data.begin(), recv_offsets[p + 1]));
+    offsets_sorted.push_back(data_sorted.size());
+  }
+
+  return {std::move(src_sorted),
+          graph::AdjacencyList<T>(std::move(data_sorted),
+                                  std::move(offsets_sorted))};
+}
+//-----------------------------------------------------------------------------
+template <typename T>
 graph::AdjacencyList<T>
 neighbor_all_to_all(MPI_Comm neighbor_comm,
                     const graph::AdjacencyList<T>& send_data)
@@ -0,0 +1,139 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::common
+{
+
+/// A bump allocator for short-lived scratch buffers, e.g. element
+/// tensors and gathered cell geometry in the assembly kernels. Memory
+/// is carved from cache-line aligned blocks that are retained across
+/// uses, so once the high-water mark has been reached (after the first
+/// few assemblies) allocation is a pointer bump and steady-state
+/// assembly performs no heap allocations. Blocks are never moved, so
+/// spans handed out remain valid until their Frame is destroyed.
+///
+/// Allocations are scoped by ScratchArena::Frame: destroying a frame
+/// releases (for reuse, not to the heap) everything allocated since
+/// the frame was opened. One arena is kept per thread, see instance().
+class ScratchArena
+{
+public:
+  /// The arena for the calling thread
+  static ScratchArena& instance()
+  {
+    static thread_local ScratchArena arena;
+    return arena;
+  }
+
+  ScratchArena() = default;
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /// RAII scope for arena allocations. On destruction the arena is
+  /// rewound to the state at frame creation.
+  class Frame
+  {
+  public:
+    /// Open a frame on an arena
+    explicit Frame(ScratchArena& arena = ScratchArena::instance())
+        : _arena(arena), _block(arena._block), _offset(arena._offset)
+    {
+    }
+
+    Frame(const Frame&) = delete;
+    Frame& operator=(const Frame&) = delete;
+
+    /// Rewind the arena
+    ~Frame()
+    {
+      _arena._block = _block;
+      _arena._offset = _offset;
+    }
+
+    /// Allocate a zero-initialised array of n objects of type T from
+    /// the arena. The returned span is valid until this frame is
+    /// destroyed.
+    template <typename T>
+    xtl::span<T> allocate(std::size_t n)
+    {
+      T* p = static_cast<T*>(_arena.allocate_bytes(n * sizeof(T), alignof(T)));
+      std::fill_n(p, n, T());
+      return xtl::span<T>(p, n);
+    }
+
+  private:
+    ScratchArena& _arena;
+    std::size_t _block, _offset;
+  };
+
+private:
+  friend class Frame;
+
+  // Minimum block size (bytes)
+  static constexpr std::size_t block_size = 1 << 16;
+
+  // Cache-line alignment for block starts
+  static constexpr std::size_t block_align = 64;
+
+  void* allocate_bytes(std::size_t size, std::size_t align)
+  {
+    // Find a block with enough space, appending a new block if
+    // required. Blocks are never resized or moved.
+    while (true)
+    {
+      if (_block == _blocks.size())
+      {
+        const std::size_t bytes = std::max(block_size, size);
+        _blocks.push_back(
+            {bytes, BlockPtr(static_cast<char*>(
+                 ::operator new[](bytes, std::align_val_t(block_align))))});
+      }
+
+      const std::size_t offset = (_offset + align - 1) / align * align;
+      if (offset + size <= _blocks[_block].size)
+      {
+        _offset = offset + size;
+        return _blocks[_block].data.get() + offset;
+      }
+
+      // Current block exhausted - move to the next one
+      ++_block;
+      _offset = 0;
+    }
+  }
+
+  struct Deleter
+  {
+    /// Deallocate an aligned block
+    void operator()(char* p) const
+    {
+      ::operator delete[](p, std::align_val_t(block_align));
+    }
+  };
+  using BlockPtr = std::unique_ptr<char[], Deleter>;
+
+  struct Block
+  {
+    /// Block size in bytes
+    std::size_t size;
+    /// Block storage
+    BlockPtr data;
+  };
+
+  // Retained blocks, current block index and offset within it
+  std::vector<Block> _blocks;
+  std::size_t _block = 0, _offset = 0;
+};
+
+} // namespace dolfinx::common
@@ -0,0 +1,125 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <dolfinx/common/MPI.h>
+#include <mpi.h>
+#include <utility>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::common
+{
+
+/// A fixed-size array held in an MPI-3 shared-memory window
+/// (MPI_Win_allocate_shared), visible to all ranks of one
+/// shared-memory node. The lowest rank of the node communicator
+/// allocates the storage and the other ranks attach to it
+/// (MPI_Win_shared_query), so a node holds one copy of the data rather
+/// than one copy per rank. Construction, sync() and destruction are
+/// collective on the node communicator. After any rank has written to
+/// the array, all ranks must call sync() before reading data written
+/// by another rank.
+template <typename T>
+class SharedArray
+{
+public:
+  /// Allocate a shared array of @p size elements. Collective on
+  /// @p node_comm, which must connect the ranks of one shared-memory
+  /// node, e.g. a communicator from MPI_Comm_split_type with
+  /// MPI_COMM_TYPE_SHARED. The array is uninitialized.
+  /// @param[in] node_comm Node (shared-memory) communicator
+  /// @param[in] size Number of elements in the array
+  SharedArray(MPI_Comm node_comm, std::size_t size)
+      : _comm(node_comm), _size(size)
+  {
+    int rank;
+    MPI_Comm_rank(node_comm, &rank);
+    void* base = nullptr;
+    const MPI_Aint bytes = rank == 0 ? size * sizeof(T) : 0;
+    MPI_Win_allocate_shared(bytes, sizeof(T), MPI_INFO_NULL, node_comm, &base,
+                            &_win);
+    if (rank != 0)
+    {
+      MPI_Aint size0;
+      int unit;
+      MPI_Win_shared_query(_win, 0, &size0, &unit, &base);
+    }
+    _data = static_cast<T*>(base);
+
+    // Open a passive access epoch for the lifetime of the array so
+    // that loads/stores and MPI_Win_sync are permitted
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, _win);
+  }
+
+  // Copy constructor (deleted)
+  SharedArray(const SharedArray& array) = delete;
+
+  /// Move constructor
+  SharedArray(SharedArray&& array) noexcept
+      : _comm(std::move(array._comm)), _win(array._win), _data(array._data),
+        _size(array._size)
+  {
+    array._win = MPI_WIN_NULL;
+    array._data = nullptr;
+    array._size = 0;
+  }
+
+  // Copy assignment (deleted)
+  SharedArray& operator=(const SharedArray& array) = delete;
+
+  // Move assignment (deleted)
+  SharedArray& operator=(SharedArray&& array) = delete;
+
+  /// Destructor. Collective on the node communicator (frees the
+  /// shared-memory window).
+  ~SharedArray()
+  {
+    if (_win != MPI_WIN_NULL)
+    {
+      MPI_Win_unlock_all(_win);
+      MPI_Win_free(&_win);
+    }
+  }
+
+  /// Make writes to the array visible on all ranks of the node.
+  /// Collective on the node communicator.
+  void sync() const
+  {
+    MPI_Win_sync(_win);
+    MPI_Barrier(_comm.comm());
+    MPI_Win_sync(_win);
+  }
+
+  /// The array
+  xtl::span<T> array() { return xtl::span<T>(_data, _size); }
+
+  /// The array (const version)
+  xtl::span<const T> array() const
+  {
+    return xtl::span<const T>(_data, _size);
+  }
+
+  /// Number of elements in the array
+  std::size_t size() const { return _size; }
+
+private:
+  // Duplicate of the node communicator, used by sync()
+  dolfinx::MPI::Comm _comm;
+
+  // Shared-memory window holding the array
+  MPI_Win _win = MPI_WIN_NULL;
+
+  // Base address of the array in the shared segment
+  T* _data = nullptr;
+
+  // Number of elements
+  std::size_t _size = 0;
+};
+
+} // namespace dolfinx::common
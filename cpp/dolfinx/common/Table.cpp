@@ -66,6 +66,10 @@ std::variant<std::string, int, double> Table::get(std::string row,
   return it->second;
 }
 //-----------------------------------------------------------------------------
+const std::vector<std::string>& Table::rows() const { return _rows; }
+//-----------------------------------------------------------------------------
+const std::vector<std::string>& Table::cols() const { return _cols; }
+//-----------------------------------------------------------------------------
 Table Table::reduce(MPI_Comm comm, Table::Reduction reduction) const
 {
   std::string new_title;
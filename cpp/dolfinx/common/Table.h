@@ -68,6 +68,14 @@ public:
   std::variant<std::string, int, double> get(std::string row,
                                              std::string col) const;
 
+  /// Return the row names, in insertion order
+  /// @returns The row names
+  const std::vector<std::string>& rows() const;
+
+  /// Return the column names, in insertion order
+  /// @returns The column names
+  const std::vector<std::string>& cols() const;
+
   /// Do MPI reduction on Table
   /// @param[in] comm MPI communicator
   /// @param[in] reduction Type of reduction to perform
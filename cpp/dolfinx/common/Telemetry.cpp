@@ -0,0 +1,141 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "Telemetry.h"
+#include <chrono>
+#include <stdexcept>
+
+using namespace dolfinx;
+using namespace dolfinx::common;
+
+namespace
+{
+std::chrono::steady_clock::time_point epoch
+    = std::chrono::steady_clock::now();
+
+double now()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                       - epoch)
+      .count();
+}
+
+std::size_t round_up_pow2(std::size_t n)
+{
+  std::size_t p = 1;
+  while (p < n)
+    p *= 2;
+  return p;
+}
+} // namespace
+
+std::atomic<telemetry::Sink*> telemetry::active_sink{nullptr};
+
+//-----------------------------------------------------------------------------
+telemetry::Sink::Sink(const std::string& filename, std::size_t capacity)
+    : _ring(round_up_pow2(capacity)), _mask(_ring.size() - 1), _head(0),
+      _tail(0), _dropped(0), _file(filename, std::ios::binary), _t0(now()),
+      _stop(false)
+{
+  if (!_file)
+    throw std::runtime_error("Failed to open telemetry log " + filename);
+  for (std::size_t i = 0; i < _ring.size(); ++i)
+    _ring[i].sequence.store(i, std::memory_order_relaxed);
+  _file.write("DLFXTLM1", 8);
+  _thread = std::thread([this] { flush_loop(); });
+}
+//-----------------------------------------------------------------------------
+telemetry::Sink::~Sink()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _cv.notify_one();
+  _thread.join();
+
+  // Drain records published after the flush thread exited
+  Record record;
+  while (pop(record))
+    _file.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+  _file.flush();
+}
+//-----------------------------------------------------------------------------
+void telemetry::Sink::push(Channel channel, std::uint32_t index, double value)
+{
+  // Claim a slot (Vyukov bounded queue enqueue). A slot is free when
+  // its sequence equals the claimed position.
+  std::size_t pos = _head.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true)
+  {
+    slot = &_ring[pos & _mask];
+    const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+    const std::intptr_t diff = std::intptr_t(seq) - std::intptr_t(pos);
+    if (diff == 0)
+    {
+      if (_head.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+    {
+      // Ring full: drop rather than block the publishing thread
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    else
+      pos = _head.load(std::memory_order_relaxed);
+  }
+
+  slot->record
+      = {now() - _t0, std::uint32_t(channel), index, value};
+  slot->sequence.store(pos + 1, std::memory_order_release);
+}
+//-----------------------------------------------------------------------------
+std::size_t telemetry::Sink::dropped() const
+{
+  return _dropped.load(std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
+bool telemetry::Sink::pop(Record& record)
+{
+  // Single-consumer dequeue (only the flush thread and the destructor,
+  // never concurrently, call this)
+  const std::size_t pos = _tail.load(std::memory_order_relaxed);
+  Slot& slot = _ring[pos & _mask];
+  const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+  if (std::intptr_t(seq) - std::intptr_t(pos + 1) < 0)
+    return false;
+  record = slot.record;
+  slot.sequence.store(pos + _ring.size(), std::memory_order_release);
+  _tail.store(pos + 1, std::memory_order_relaxed);
+  return true;
+}
+//-----------------------------------------------------------------------------
+void telemetry::Sink::flush_loop()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_stop)
+  {
+    _cv.wait_for(lock, std::chrono::milliseconds(10));
+    Record record;
+    while (pop(record))
+      _file.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+    _file.flush();
+  }
+}
+//-----------------------------------------------------------------------------
+void telemetry::attach(Sink& sink)
+{
+  active_sink.store(&sink, std::memory_order_release);
+}
+//-----------------------------------------------------------------------------
+void telemetry::detach()
+{
+  active_sink.store(nullptr, std::memory_order_release);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dolfinx::common::telemetry
+{
+
+/// Streaming solver telemetry. Subsystems publish fixed-size records
+/// (per-Krylov-iteration residuals, Newton convergence history,
+/// scatter volumes, assembly times) into an attached Sink, which
+/// buffers them in a lock-free ring and flushes them to a binary log
+/// from a background thread. With no sink attached, publishing is a
+/// single relaxed atomic load and a predictable branch, so the
+/// instrumentation can stay enabled in production builds.
+
+/// Telemetry channels
+enum class Channel : std::uint32_t
+{
+  krylov_residual = 1, ///< index: iteration, value: residual norm
+  newton_residual = 2, ///< index: iteration, value: residual norm
+  scatter_forward = 3, ///< index: entries sent, value: bytes sent
+  scatter_reverse = 4, ///< index: entries sent, value: bytes sent
+  assembly = 5         ///< index: 0 (vector), 1 (matrix), value: seconds
+};
+
+/// A single telemetry record (POD, written verbatim to the log)
+struct Record
+{
+  /// Time in seconds since the sink was created (steady clock)
+  double t;
+  /// Event channel
+  std::uint32_t channel;
+  /// Channel-specific index, e.g. an iteration number
+  std::uint32_t index;
+  /// Channel-specific value, e.g. a residual norm
+  double value;
+};
+
+/// Telemetry sink: a bounded multi-producer ring buffer drained to a
+/// binary log file by a background thread. The log starts with an
+/// eight-byte magic string ("DLFXTLM1") followed by Record structs.
+/// When the ring is full, records are dropped (and counted) rather
+/// than blocking the publishing thread.
+class Sink
+{
+public:
+  /// Create a sink writing to a binary log file
+  /// @param[in] filename Name of the log file. On multi-rank runs each
+  /// rank should use a distinct name, e.g. by appending the rank.
+  /// @param[in] capacity Ring buffer capacity (rounded up to a power
+  /// of two)
+  Sink(const std::string& filename, std::size_t capacity = 65536);
+
+  // Sinks own a file and a flush thread and cannot be copied
+  Sink(const Sink&) = delete;
+  Sink& operator=(const Sink&) = delete;
+
+  /// Stop the flush thread, drain the ring and close the log
+  ~Sink();
+
+  /// Append a record. Thread-safe and non-blocking; drops the record
+  /// if the ring is full.
+  /// @param[in] channel Event channel
+  /// @param[in] index Channel-specific index
+  /// @param[in] value Channel-specific value
+  void push(Channel channel, std::uint32_t index, double value);
+
+  /// Number of records dropped because the ring was full
+  std::size_t dropped() const;
+
+private:
+  // Ring slot with its sequence number (Vyukov bounded MPMC queue)
+  struct Slot
+  {
+    std::atomic<std::size_t> sequence;
+    Record record;
+  };
+
+  // Drain loop run by the flush thread
+  void flush_loop();
+
+  // Pop one record; returns false if the ring is empty
+  bool pop(Record& record);
+
+  std::vector<Slot> _ring;
+  std::size_t _mask;
+  std::atomic<std::size_t> _head, _tail;
+  std::atomic<std::size_t> _dropped;
+
+  std::ofstream _file;
+  double _t0;
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  bool _stop;
+  std::thread _thread;
+};
+
+/// The active sink, nullptr when detached. An implementation detail of
+/// emit(); use attach()/detach() to change it.
+extern std::atomic<Sink*> active_sink;
+
+/// Attach a sink. Records published by any thread are streamed into it
+/// until detach() is called. The caller keeps ownership and must keep
+/// the sink alive until after detach().
+void attach(Sink& sink);
+
+/// Detach the active sink (no-op if none is attached). The sink's
+/// destructor flushes any remaining buffered records.
+void detach();
+
+/// Publish a telemetry record to the active sink, if any
+/// @param[in] channel Event channel
+/// @param[in] index Channel-specific index
+/// @param[in] value Channel-specific value
+inline void emit(Channel channel, std::uint32_t index, double value)
+{
+  if (Sink* sink = active_sink.load(std::memory_order_acquire); sink)
+    sink->push(channel, index, value);
+}
+
+} // namespace dolfinx::common::telemetry
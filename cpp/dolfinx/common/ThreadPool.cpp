@@ -0,0 +1,208 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "ThreadPool.h"
+#include "utils.h"
+#include <cstdlib>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace dolfinx;
+using namespace dolfinx::common;
+
+namespace
+{
+// Set on pool workers; is_pool_thread() guards MPI entry points
+thread_local bool is_worker = false;
+
+// Pin the calling thread to one CPU, round-robin over the hardware
+// threads, leaving CPU 0 for the submitting (main) thread. No-op on
+// platforms without a thread affinity interface.
+void pin_to_cpu([[maybe_unused]] int index)
+{
+#ifdef __linux__
+  const unsigned int num_cpus = std::thread::hardware_concurrency();
+  if (num_cpus == 0)
+    return;
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET((index + 1) % num_cpus, &cpuset);
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#endif
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+ThreadPool::ThreadPool(int num_workers)
+    : _queues(std::max(num_workers, 1)), _next_queue(0), _num_queued(0),
+      _shutdown(false)
+{
+  for (std::size_t i = 0; i < _queues.size(); ++i)
+    _mutex.push_back(std::make_unique<std::mutex>());
+  const bool pin = std::getenv("DOLFINX_PIN_THREADS") != nullptr;
+  for (int i = 0; i < num_workers; ++i)
+  {
+    _workers.emplace_back(
+        [this, i, pin]()
+        {
+          is_worker = true;
+          if (pin)
+            pin_to_cpu(i);
+          this->worker_main(i);
+        });
+  }
+}
+//-----------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(_sleep_mutex);
+    _shutdown = true;
+  }
+  _work_available.notify_all();
+  for (std::thread& worker : _workers)
+    worker.join();
+}
+//-----------------------------------------------------------------------------
+void ThreadPool::worker_main(int index)
+{
+  while (true)
+  {
+    if (try_run_task(index))
+      continue;
+
+    // No work found in any queue; sleep until work is submitted. The
+    // queued-task count is re-checked under the sleep mutex, which
+    // submission also holds when signalling, so wakeups are not lost.
+    std::unique_lock<std::mutex> lock(_sleep_mutex);
+    _work_available.wait(lock,
+                         [this]() {
+                           return _shutdown
+                                  or _num_queued.load(std::memory_order_acquire)
+                                         > 0;
+                         });
+    if (_shutdown)
+      return;
+  }
+}
+//-----------------------------------------------------------------------------
+bool ThreadPool::try_run_task(int q)
+{
+  // Check the own queue first (back), then steal from the other
+  // queues (front)
+  const int num_queues = _queues.size();
+  for (int k = 0; k < num_queues; ++k)
+  {
+    const int i = (q + k) % num_queues;
+    std::pair<std::function<void()>, TaskGroup*> task;
+    {
+      std::lock_guard<std::mutex> lock(*_mutex[i]);
+      if (_queues[i].empty())
+        continue;
+      if (k == 0)
+      {
+        task = std::move(_queues[i].back());
+        _queues[i].pop_back();
+      }
+      else
+      {
+        task = std::move(_queues[i].front());
+        _queues[i].pop_front();
+      }
+    }
+
+    _num_queued.fetch_sub(1, std::memory_order_release);
+    task.first();
+    task.second->_pending.fetch_sub(1, std::memory_order_release);
+    return true;
+  }
+
+  return false;
+}
+//-----------------------------------------------------------------------------
+void ThreadPool::parallel_for(
+    std::size_t n, const std::function<void(std::size_t, std::size_t)>& f,
+    std::size_t grain)
+{
+  const std::size_t num_threads = _workers.size() + 1;
+  if (num_threads <= 1 or n < 2 or (grain > 0 and n <= grain))
+  {
+    f(0, n);
+    return;
+  }
+
+  // Split [0, n) evenly over the available threads, respecting the
+  // grain size
+  std::size_t num_chunks = num_threads;
+  if (grain > 0)
+    num_chunks = std::min<std::size_t>(num_threads, (n + grain - 1) / grain);
+
+  TaskGroup tasks(*this);
+  for (std::size_t c = 1; c < num_chunks; ++c)
+  {
+    const std::size_t begin = (n * c) / num_chunks;
+    const std::size_t end = (n * (c + 1)) / num_chunks;
+    if (begin != end)
+      tasks.run([&f, begin, end]() { f(begin, end); });
+  }
+
+  // The calling thread executes the first chunk, then helps with the
+  // queued chunks
+  f(0, n / num_chunks);
+  tasks.wait();
+}
+//-----------------------------------------------------------------------------
+int ThreadPool::num_workers() const { return _workers.size(); }
+//-----------------------------------------------------------------------------
+bool ThreadPool::is_pool_thread() { return is_worker; }
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+ThreadPool::TaskGroup::TaskGroup(ThreadPool& pool) : _pool(pool), _pending(0)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+ThreadPool::TaskGroup::~TaskGroup() { wait(); }
+//-----------------------------------------------------------------------------
+void ThreadPool::TaskGroup::run(std::function<void()> f)
+{
+  _pending.fetch_add(1, std::memory_order_acquire);
+  const std::size_t q
+      = _pool._next_queue.fetch_add(1, std::memory_order_relaxed)
+        % _pool._queues.size();
+  {
+    std::lock_guard<std::mutex> lock(*_pool._mutex[q]);
+    _pool._queues[q].push_back({std::move(f), this});
+  }
+  {
+    std::lock_guard<std::mutex> lock(_pool._sleep_mutex);
+    _pool._num_queued.fetch_add(1, std::memory_order_release);
+  }
+  _pool._work_available.notify_one();
+}
+//-----------------------------------------------------------------------------
+void ThreadPool::TaskGroup::wait()
+{
+  // Execute queued tasks while tasks of this group are in flight. A
+  // task of another group may be picked up; that only helps that
+  // group along.
+  while (_pending.load(std::memory_order_acquire) > 0)
+  {
+    if (!_pool.try_run_task(0))
+      std::this_thread::yield();
+  }
+}
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+ThreadPool& dolfinx::common::thread_pool()
+{
+  static ThreadPool pool(num_threads() - 1);
+  return pool;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::common
+{
+
+/// A process-wide pool of worker threads shared by the threaded code
+/// paths (assembly, sparsity construction, mesh utilities, sort).
+/// Workers are created once and kept alive, so repeated parallel
+/// regions pay no thread spawn cost. Tasks are distributed over
+/// per-worker queues and idle workers steal from the other queues.
+///
+/// The calling thread participates: it executes tasks while waiting on
+/// a TaskGroup, so `n` parallel ranges use the pool's workers plus the
+/// caller. The pool holds common::num_threads() - 1 workers and is
+/// inert (no threads) when DOLFINX_NUM_THREADS is unset or 1.
+///
+/// @note Tasks run on pool workers and must never make MPI calls: MPI
+/// is only serialized on the thread that entered the parallel region.
+/// ThreadPool::is_pool_thread() can be used to guard MPI entry points.
+/// Workers can optionally be pinned to CPUs round-robin by setting the
+/// environment variable `DOLFINX_PIN_THREADS`, which keeps workers on
+/// their memory domain on multi-socket nodes.
+class ThreadPool
+{
+public:
+  /// Create a pool
+  /// @param[in] num_workers Number of worker threads (in addition to
+  /// the threads that submit work)
+  explicit ThreadPool(int num_workers);
+
+  // The pool is a shared resource and cannot be copied
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Destructor. Joins the workers; all task groups must have been
+  /// waited on.
+  ~ThreadPool();
+
+  /// A group of tasks submitted to the pool that can be waited on as a
+  /// unit
+  class TaskGroup
+  {
+  public:
+    /// Create an empty task group on a pool
+    explicit TaskGroup(ThreadPool& pool);
+
+    // Task groups track in-flight tasks and cannot be copied
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// Destructor. Waits for all tasks in the group.
+    ~TaskGroup();
+
+    /// Submit a task to the pool
+    void run(std::function<void()> f);
+
+    /// Wait for all tasks in the group. The calling thread executes
+    /// queued tasks while waiting.
+    void wait();
+
+  private:
+    friend class ThreadPool;
+    ThreadPool& _pool;
+
+    // Number of tasks submitted but not yet finished
+    std::atomic<std::int64_t> _pending;
+  };
+
+  /// Execute `f(begin, end)` over the index range [0, n), split into
+  /// chunks executed in parallel on the pool and the calling thread.
+  /// Writes from different chunks must not overlap. Runs serially when
+  /// the pool has no workers or the range is small.
+  /// @param[in] n Size of the index range
+  /// @param[in] f Callable invoked as `f(begin, end)` for each chunk
+  /// @param[in] grain Minimum chunk size. When zero, the range is
+  /// split evenly over the available threads.
+  void parallel_for(std::size_t n,
+                    const std::function<void(std::size_t, std::size_t)>& f,
+                    std::size_t grain = 0);
+
+  /// Number of worker threads (excluding submitting threads)
+  int num_workers() const;
+
+  /// True when called from a pool worker. Pool tasks must never make
+  /// MPI calls; MPI entry points reachable from tasks can assert on
+  /// this.
+  static bool is_pool_thread();
+
+private:
+  // Worker main loop
+  void worker_main(int index);
+
+  // Pop a task from queue q (or steal from the others when empty).
+  // Returns false if no work is available.
+  bool try_run_task(int q);
+
+  // Per-worker task queues; queue i is guarded by _mutex[i]. Submitted
+  // tasks are distributed round-robin.
+  std::vector<std::deque<std::pair<std::function<void()>, TaskGroup*>>> _queues;
+  std::vector<std::unique_ptr<std::mutex>> _mutex;
+  std::atomic<std::size_t> _next_queue;
+
+  // Total number of queued (not yet started) tasks
+  std::atomic<std::int64_t> _num_queued;
+
+  // Worker sleep/wake signalling
+  std::mutex _sleep_mutex;
+  std::condition_variable _work_available;
+  bool _shutdown;
+
+  std::vector<std::thread> _workers;
+};
+
+/// The process-wide thread pool, created on first use (and warmed up
+/// by dolfinx::init). Sized from common::num_threads().
+ThreadPool& thread_pool();
+
+} // namespace dolfinx::common
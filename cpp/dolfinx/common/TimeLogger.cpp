@@ -42,8 +42,25 @@ void TimeLogger::list_timings(MPI_Comm comm, std::set<TimingType> type)
 {
   // Format and reduce to rank 0
   Table timings = this->timings(type);
-  timings = timings.reduce(comm, Table::Reduction::average);
-  const std::string str = "\n" + timings.str();
+  Table t_avg = timings.reduce(comm, Table::Reduction::average);
+  if (type.find(TimingType::wall) != type.end())
+  {
+    // Append the per-rank spread of the total wall time: min, max and
+    // the max/average imbalance ratio. The reduced tables are empty on
+    // other ranks, so the loop runs on rank 0 only.
+    const Table t_min = timings.reduce(comm, Table::Reduction::min);
+    const Table t_max = timings.reduce(comm, Table::Reduction::max);
+    for (const std::string& task : t_avg.rows())
+    {
+      const double avg = std::get<double>(t_avg.get(task, "wall tot"));
+      const double max = std::get<double>(t_max.get(task, "wall tot"));
+      t_avg.set(task, "wall min",
+                std::get<double>(t_min.get(task, "wall tot")));
+      t_avg.set(task, "wall max", max);
+      t_avg.set(task, "imbalance", avg > 0.0 ? max / avg : 1.0);
+    }
+  }
+  const std::string str = "\n" + t_avg.str();
 
   // Print just on rank 0
   if (dolfinx::MPI::rank(comm) == 0)
@@ -0,0 +1,150 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <dolfinx/common/memory.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace dolfinx::common
+{
+
+namespace impl
+{
+/// Pool of aligned memory blocks. Freed blocks are retained and reused
+/// for later allocations of the same size rather than returned to the
+/// heap, so steady-state allocation of recurring buffer sizes (e.g.
+/// scatter buffers) is a list pop. All cached blocks are released when
+/// the pool is destroyed.
+template <std::size_t Alignment>
+class MemoryPool
+{
+public:
+  MemoryPool() = default;
+  MemoryPool(const MemoryPool&) = delete;
+  MemoryPool& operator=(const MemoryPool&) = delete;
+
+  /// Destructor. Releases all cached blocks.
+  ~MemoryPool()
+  {
+    for (auto& [size, blocks] : _free)
+      for (void* p : blocks)
+        ::operator delete(p, std::align_val_t(Alignment));
+  }
+
+  /// Allocate an aligned block of at least `bytes` bytes. Fresh large
+  /// blocks have the allocation policies applied: optional transparent
+  /// huge pages and parallel first-touch page placement (see
+  /// common::advise_huge_pages and common::first_touch). Recycled
+  /// blocks keep their existing page placement.
+  void* allocate(std::size_t bytes)
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (auto it = _free.find(bytes); it != _free.end() and !it->second.empty())
+      {
+        void* p = it->second.back();
+        it->second.pop_back();
+        return p;
+      }
+    }
+
+    void* p = ::operator new(bytes, std::align_val_t(Alignment));
+    if (bytes >= memory_policy_threshold)
+    {
+      advise_huge_pages(p, bytes);
+      first_touch(p, bytes);
+    }
+    return p;
+  }
+
+  /// Return a block to the pool for reuse. The size must match the
+  /// value passed to the allocating call.
+  void deallocate(void* p, std::size_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _free[bytes].push_back(p);
+  }
+
+private:
+  // Cached blocks, grouped by allocation size (bytes)
+  std::map<std::size_t, std::vector<void*>> _free;
+  std::mutex _mutex;
+};
+} // namespace impl
+
+/// Aligned, pool-backed allocator. Memory is aligned to `Alignment`
+/// bytes (a cache line by default), which permits vectorized (aligned
+/// load/store) access to array data. Freed memory is retained in a pool
+/// shared by all copies and rebound versions of an allocator, so
+/// containers that repeatedly allocate the same sizes (e.g. vector
+/// payloads and ghost scatter buffers) recycle their buffers instead of
+/// hitting the heap. The pool is released when the last allocator
+/// referencing it is destroyed.
+template <typename T, std::size_t Alignment = 64>
+class AlignedPoolAllocator
+{
+  static_assert(Alignment >= alignof(T),
+                "Pool alignment must satisfy the type alignment");
+
+public:
+  /// Allocated type
+  using value_type = T;
+
+  /// Create an allocator with its own (initially empty) pool
+  AlignedPoolAllocator()
+      : _pool(std::make_shared<impl::MemoryPool<Alignment>>())
+  {
+  }
+
+  /// Create an allocator sharing the pool of another allocator
+  template <typename U>
+  AlignedPoolAllocator(const AlignedPoolAllocator<U, Alignment>& alloc) noexcept
+      : _pool(alloc._pool)
+  {
+  }
+
+  /// Allocate storage for n objects of type T
+  T* allocate(std::size_t n)
+  {
+    return static_cast<T*>(_pool->allocate(n * sizeof(T)));
+  }
+
+  /// Return storage for n objects of type T to the pool
+  void deallocate(T* p, std::size_t n) noexcept
+  {
+    _pool->deallocate(p, n * sizeof(T));
+  }
+
+  /// Allocators are equal if they share a pool (memory from one can be
+  /// deallocated by the other)
+  friend bool operator==(const AlignedPoolAllocator& a,
+                         const AlignedPoolAllocator& b) noexcept
+  {
+    return a._pool == b._pool;
+  }
+
+  /// Inequality, see operator==
+  friend bool operator!=(const AlignedPoolAllocator& a,
+                         const AlignedPoolAllocator& b) noexcept
+  {
+    return a._pool != b._pool;
+  }
+
+private:
+  template <typename, std::size_t>
+  friend class AlignedPoolAllocator;
+
+  // Pool shared by all copies of this allocator
+  std::shared_ptr<impl::MemoryPool<Alignment>> _pool;
+};
+
+} // namespace dolfinx::common
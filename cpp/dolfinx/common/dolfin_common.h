@@ -14,9 +14,12 @@ namespace dolfinx
 
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Table.h>
+#include <dolfinx/common/Telemetry.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/defines.h>
 #include <dolfinx/common/init.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/profiler.h>
 #include <dolfinx/common/subsystem.h>
 #include <dolfinx/common/timing.h>
 #include <dolfinx/common/version.h>
@@ -5,6 +5,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "init.h"
+#include "ThreadPool.h"
 #include "subsystem.h"
 #include <dolfinx/common/log.h>
 
@@ -13,6 +14,14 @@ void dolfinx::init(int argc, char* argv[])
 {
   common::subsystem::init_logging(argc, argv);
   LOG(INFO) << "Initializing DOLFINx version" << DOLFINX_VERSION;
-  common::subsystem::init_petsc(argc, argv);
+
+  // Record the arguments for PETSc, but defer its initialization to
+  // the first use of a PETSc object: mesh and I/O tools never pay
+  // PETSc startup
+  common::subsystem::init_petsc_deferred(argc, argv);
+
+  // Start the shared worker threads (a no-op when DOLFINX_NUM_THREADS
+  // is unset or 1)
+  common::thread_pool();
 }
 //-----------------------------------------------------------------------------
@@ -10,3 +10,52 @@
 #define LOGURU_REPLACE_GLOG 1
 
 #include "loguru.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+// Compile-time log stripping: with DOLFINX_MAX_LOG_LEVEL defined (a
+// loguru verbosity number, e.g. -1 to keep WARNING and above), LOG
+// statements above the threshold reduce to a constant-false branch
+// that the optimizer removes entirely, including the evaluation of the
+// streamed arguments. For release builds where even the runtime
+// verbosity check is measurable in inner loops. Set via the CMake
+// cache variable DOLFINX_MAX_LOG_LEVEL.
+#ifdef DOLFINX_MAX_LOG_LEVEL
+#undef VLOG_IF_S
+#define VLOG_IF_S(verbosity, cond)                                            \
+  ((verbosity) > (DOLFINX_MAX_LOG_LEVEL)                                      \
+   || (verbosity) > loguru::current_verbosity_cutoff() || (cond) == false)    \
+      ? (void)0                                                               \
+      : loguru::Voidify()                                                     \
+            & loguru::StreamLogger(verbosity, __FILE__, __LINE__)
+#undef VLOG_F
+#define VLOG_F(verbosity, ...)                                                \
+  ((verbosity) > (DOLFINX_MAX_LOG_LEVEL)                                      \
+   || (verbosity) > loguru::current_verbosity_cutoff())                       \
+      ? (void)0                                                               \
+      : loguru::log(verbosity, __FILE__, __LINE__, __VA_ARGS__)
+#endif
+
+// Sampled logging for hot paths: log only every n-th execution of the
+// statement (counted per call site), so per-iteration solver and
+// assembly messages keep monitoring available without the per-call
+// logging cost. The sample counter is only advanced while the
+// verbosity level is active. Usage: LOG_EVERY_N(INFO, 100) << "...";
+#define LOG_EVERY_N(verbosity_name, n)                                        \
+  LOG_IF_S(verbosity_name,                                                    \
+           []() -> bool                                                       \
+           {                                                                  \
+             static std::atomic<std::uint64_t> count{0};                      \
+             return count.fetch_add(1, std::memory_order_relaxed) % (n) == 0; \
+           }())
+
+// Log only the first n executions of the statement (counted per call
+// site), e.g. to report a fallback once instead of once per cell
+#define LOG_FIRST_N(verbosity_name, n)                                        \
+  LOG_IF_S(verbosity_name,                                                    \
+           []() -> bool                                                       \
+           {                                                                  \
+             static std::atomic<std::uint64_t> count{0};                      \
+             return count.fetch_add(1, std::memory_order_relaxed) < (n);      \
+           }())
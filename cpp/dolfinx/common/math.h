@@ -12,6 +12,14 @@
 #include <xtensor/xfixed.hpp>
 #include <xtensor/xtensor.hpp>
 
+/// No-alias qualifier for the batched kernel pointer arguments, which
+/// lets the compiler vectorize the loop over the matrix block
+#if defined(__GNUC__) or defined(__clang__)
+#define DOLFINX_RESTRICT __restrict__
+#else
+#define DOLFINX_RESTRICT
+#endif
+
 namespace dolfinx::math
 {
 
@@ -197,4 +205,133 @@ void pinv(const U& A, V&& P)
   }
 }
 
+// Batched fixed-size kernels. The matrices of a cell or point block
+// are stored contiguously (row-major, array-of-matrices layout) and
+// each kernel body is fully unrolled for its fixed size, so the loop
+// over the block carries no branches, indirection or temporaries and
+// vectorizes across matrices.
+
+/// Compute the determinants of a contiguous block of 2x2 matrices
+/// @param[in] n Number of matrices
+/// @param[in] A The matrices (row-major, shape=(n, 2, 2))
+/// @param[out] d The determinants (size n)
+template <typename T>
+void det_2x2_batch(std::size_t n, const T* DOLFINX_RESTRICT A,
+                   T* DOLFINX_RESTRICT d)
+{
+  for (std::size_t m = 0; m < n; ++m)
+  {
+    const T* a = A + 4 * m;
+    d[m] = difference_of_products(a[0], a[1], a[2], a[3]);
+  }
+}
+
+/// Compute the determinants of a contiguous block of 3x3 matrices
+/// @param[in] n Number of matrices
+/// @param[in] A The matrices (row-major, shape=(n, 3, 3))
+/// @param[out] d The determinants (size n)
+template <typename T>
+void det_3x3_batch(std::size_t n, const T* DOLFINX_RESTRICT A,
+                   T* DOLFINX_RESTRICT d)
+{
+  for (std::size_t m = 0; m < n; ++m)
+  {
+    const T* a = A + 9 * m;
+    T w0 = difference_of_products(a[4], a[5], a[7], a[8]);
+    T w1 = difference_of_products(a[3], a[5], a[6], a[8]);
+    T w2 = difference_of_products(a[3], a[4], a[6], a[7]);
+    T w3 = difference_of_products(a[0], a[1], w1, w0);
+    d[m] = std::fma(a[2], w2, w3);
+  }
+}
+
+/// Compute the inverses (and optionally the determinants) of a
+/// contiguous block of 2x2 matrices
+/// @param[in] n Number of matrices
+/// @param[in] A The matrices (row-major, shape=(n, 2, 2))
+/// @param[out] B The inverses (row-major, shape=(n, 2, 2))
+/// @param[out] d The determinants (size n). Pass nullptr to skip.
+/// @warning This function does not check if the matrices are invertible
+template <typename T>
+void inv_2x2_batch(std::size_t n, const T* DOLFINX_RESTRICT A,
+                   T* DOLFINX_RESTRICT B, T* DOLFINX_RESTRICT d = nullptr)
+{
+  for (std::size_t m = 0; m < n; ++m)
+  {
+    const T* a = A + 4 * m;
+    T* b = B + 4 * m;
+    T det = difference_of_products(a[0], a[1], a[2], a[3]);
+    T idet = 1 / det;
+    b[0] = idet * a[3];
+    b[1] = -idet * a[1];
+    b[2] = -idet * a[2];
+    b[3] = idet * a[0];
+    if (d)
+      d[m] = det;
+  }
+}
+
+/// Compute the inverses (and optionally the determinants) of a
+/// contiguous block of 3x3 matrices
+/// @param[in] n Number of matrices
+/// @param[in] A The matrices (row-major, shape=(n, 3, 3))
+/// @param[out] B The inverses (row-major, shape=(n, 3, 3))
+/// @param[out] d The determinants (size n). Pass nullptr to skip.
+/// @warning This function does not check if the matrices are invertible
+template <typename T>
+void inv_3x3_batch(std::size_t n, const T* DOLFINX_RESTRICT A,
+                   T* DOLFINX_RESTRICT B, T* DOLFINX_RESTRICT d = nullptr)
+{
+  for (std::size_t m = 0; m < n; ++m)
+  {
+    const T* a = A + 9 * m;
+    T* b = B + 9 * m;
+    T w0 = difference_of_products(a[4], a[5], a[7], a[8]);
+    T w1 = difference_of_products(a[3], a[5], a[6], a[8]);
+    T w2 = difference_of_products(a[3], a[4], a[6], a[7]);
+    T w3 = difference_of_products(a[0], a[1], w1, w0);
+    T det = std::fma(a[2], w2, w3);
+    T idet = 1 / det;
+    b[0] = w0 * idet;
+    b[3] = -w1 * idet;
+    b[6] = w2 * idet;
+    b[1] = difference_of_products(a[2], a[1], a[8], a[7]) * idet;
+    b[2] = difference_of_products(a[1], a[2], a[4], a[5]) * idet;
+    b[4] = difference_of_products(a[0], a[2], a[6], a[8]) * idet;
+    b[5] = difference_of_products(a[3], a[0], a[5], a[2]) * idet;
+    b[7] = difference_of_products(a[6], a[0], a[7], a[1]) * idet;
+    b[8] = difference_of_products(a[0], a[3], a[1], a[4]) * idet;
+    if (d)
+      d[m] = det;
+  }
+}
+
+/// Compute C = A * B for a contiguous block of fixed-size matrices
+/// @tparam M,K,N The (compile-time) matrix dimensions
+/// @param[in] n Number of matrix products
+/// @param[in] A The first factors (row-major, shape=(n, M, K))
+/// @param[in] B The second factors (row-major, shape=(n, K, N))
+/// @param[out] C The products (row-major, shape=(n, M, N))
+template <std::size_t M, std::size_t K, std::size_t N, typename T>
+void matmul_batch(std::size_t n, const T* DOLFINX_RESTRICT A,
+                  const T* DOLFINX_RESTRICT B, T* DOLFINX_RESTRICT C)
+{
+  for (std::size_t m = 0; m < n; ++m)
+  {
+    const T* a = A + M * K * m;
+    const T* b = B + K * N * m;
+    T* c = C + M * N * m;
+    for (std::size_t i = 0; i < M; ++i)
+    {
+      for (std::size_t j = 0; j < N; ++j)
+      {
+        T cij = 0;
+        for (std::size_t k = 0; k < K; ++k)
+          cij += a[i * K + k] * b[k * N + j];
+        c[i * N + j] = cij;
+      }
+    }
+  }
+}
+
 } // namespace dolfinx::math
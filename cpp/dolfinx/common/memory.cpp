@@ -0,0 +1,145 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "memory.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <dolfinx/common/MPI.h>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <utility>
+#include <variant>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Current and high-water-mark bytes per tag
+std::map<std::string, std::pair<std::int64_t, std::int64_t>> _memory;
+std::mutex _memory_mutex;
+
+// Process-wide resident-set high-water mark in bytes, as reported by
+// the kernel. Includes untagged allocations.
+std::int64_t process_peak_rss()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  // ru_maxrss is in KiB on Linux
+  return std::int64_t(usage.ru_maxrss) * 1024;
+}
+
+constexpr double MiB = 1048576.0;
+} // namespace
+
+//-----------------------------------------------------------------------------
+void dolfinx::register_memory(std::string tag, std::int64_t change)
+{
+  const std::lock_guard<std::mutex> lock(_memory_mutex);
+  auto& [current, peak] = _memory[tag];
+  current += change;
+  peak = std::max(peak, current);
+}
+//-----------------------------------------------------------------------------
+std::pair<std::int64_t, std::int64_t> dolfinx::memory_usage(std::string tag)
+{
+  const std::lock_guard<std::mutex> lock(_memory_mutex);
+  auto it = _memory.find(tag);
+  if (it == _memory.end())
+  {
+    throw std::runtime_error("No memory registered for tag \"" + tag
+                             + "\".");
+  }
+  return it->second;
+}
+//-----------------------------------------------------------------------------
+dolfinx::Table dolfinx::memory_usage()
+{
+  Table table("Summary of memory usage");
+  {
+    const std::lock_guard<std::mutex> lock(_memory_mutex);
+    for (const auto& [tag, usage] : _memory)
+    {
+      table.set(tag, "current (MiB)", usage.first / MiB);
+      table.set(tag, "peak (MiB)", usage.second / MiB);
+    }
+  }
+
+  const std::int64_t rss = process_peak_rss();
+  table.set("process (maxrss)", "current (MiB)", rss / MiB);
+  table.set("process (maxrss)", "peak (MiB)", rss / MiB);
+
+  return table;
+}
+//-----------------------------------------------------------------------------
+void dolfinx::list_memory(MPI_Comm comm)
+{
+  // Reduce to rank 0 and append the per-rank spread of the peak usage.
+  // The reduced tables are empty on other ranks, so the augmentation
+  // loop runs on rank 0 only.
+  const Table table = memory_usage();
+  Table t_avg = table.reduce(comm, Table::Reduction::average);
+  const Table t_min = table.reduce(comm, Table::Reduction::min);
+  const Table t_max = table.reduce(comm, Table::Reduction::max);
+  for (const std::string& tag : t_avg.rows())
+  {
+    const double avg = std::get<double>(t_avg.get(tag, "peak (MiB)"));
+    const double max = std::get<double>(t_max.get(tag, "peak (MiB)"));
+    t_avg.set(tag, "peak min",
+              std::get<double>(t_min.get(tag, "peak (MiB)")));
+    t_avg.set(tag, "peak max", max);
+    t_avg.set(tag, "imbalance", avg > 0.0 ? max / avg : 1.0);
+  }
+
+  if (dolfinx::MPI::rank(comm) == 0)
+    std::cout << "\n" + t_avg.str() << std::endl;
+}
+//-----------------------------------------------------------------------------
+void dolfinx::common::advise_huge_pages([[maybe_unused]] void* p,
+                                        [[maybe_unused]] std::size_t bytes)
+{
+#ifdef __linux__
+  static const bool enabled = std::getenv("DOLFINX_USE_HUGE_PAGES") != nullptr;
+  if (!enabled or bytes < memory_policy_threshold)
+    return;
+
+  // madvise operates on whole pages: shrink the region to its
+  // page-aligned interior
+  const std::size_t page = sysconf(_SC_PAGESIZE);
+  const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p);
+  const std::uintptr_t begin = (addr + page - 1) & ~(page - 1);
+  const std::uintptr_t end = (addr + bytes) & ~(page - 1);
+  if (begin < end)
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#endif
+}
+//-----------------------------------------------------------------------------
+void dolfinx::common::first_touch(void* p, std::size_t bytes)
+{
+  ThreadPool& pool = thread_pool();
+  if (pool.num_workers() == 0 or bytes < memory_policy_threshold)
+    return;
+
+  // Zero one byte per page, splitting the region into the same evenly
+  // sized contiguous chunks that parallel_for hands to the threads, so
+  // first-touch places each chunk's pages near its prospective worker
+  const std::size_t page = 4096;
+  std::byte* data = static_cast<std::byte*>(p);
+  pool.parallel_for(bytes,
+                    [data, page](std::size_t begin, std::size_t end)
+                    {
+                      for (std::size_t i = begin; i < end; i += page)
+                        data[i] = std::byte(0);
+                    });
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <dolfinx/common/Table.h>
+#include <mpi.h>
+#include <string>
+#include <utility>
+
+namespace dolfinx
+{
+
+/// Register a change in the number of bytes held by a tagged
+/// subsystem, e.g. "Topology connectivity" or "SparsityPattern".
+/// Positive on allocation, negative on release. The current total and
+/// the high-water mark per tag are tracked. Thread-safe.
+/// @param[in] tag Name of the subsystem
+/// @param[in] change Change in bytes held
+void register_memory(std::string tag, std::int64_t change);
+
+/// Return the tracked memory for a given tag
+/// @param[in] tag Name of a subsystem
+/// @returns The (current bytes, high-water-mark bytes) for the tag
+std::pair<std::int64_t, std::int64_t> memory_usage(std::string tag);
+
+/// Return a summary of tagged memory usage in a Table, in MiB. The
+/// process-wide resident-set high-water mark reported by the kernel is
+/// included as an extra row.
+/// @returns Table with current and peak memory per tag
+Table memory_usage();
+
+/// List a summary of tagged memory usage. The average over the ranks
+/// is printed, with the per-rank minimum, maximum and max/average
+/// imbalance ratio of the peak usage.
+/// @param[in] comm MPI Communicator
+void list_memory(MPI_Comm comm);
+
+namespace common
+{
+
+/// Size threshold (bytes) above which the allocation policies below
+/// (huge pages, parallel first touch) are applied. Matches the x86-64
+/// huge page size.
+constexpr std::size_t memory_policy_threshold = std::size_t(1) << 21;
+
+/// Advise the kernel to back the region [p, p + bytes) with
+/// transparent huge pages, reducing TLB pressure for large array
+/// sweeps. Active only when the environment variable
+/// `DOLFINX_USE_HUGE_PAGES` is set and the region is at least
+/// memory_policy_threshold bytes; a no-op otherwise and on platforms
+/// without madvise. Can be applied to already-populated arrays.
+/// @param[in] p Start of the region
+/// @param[in] bytes Length of the region
+void advise_huge_pages(void* p, std::size_t bytes);
+
+/// Touch the pages of a freshly allocated region from the shared
+/// thread pool, one contiguous chunk per thread, so that with the
+/// kernel's first-touch policy the physical pages are distributed over
+/// the NUMA domains of the threads that later process the array in
+/// evenly-split parallel sweeps.
+/// @note The region is overwritten (zeroed one byte per page); only
+/// call on uninitialized memory, before meaningful data is written.
+/// @param[in] p Start of the region
+/// @param[in] bytes Length of the region
+void first_touch(void* p, std::size_t bytes);
+
+} // namespace common
+
+} // namespace dolfinx
@@ -0,0 +1,229 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "profiler.h"
+#include "MPI.h"
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+using namespace dolfinx;
+using namespace dolfinx::common;
+
+namespace
+{
+// Event buffer of one thread. Buffers are owned jointly by the
+// registry and by the thread-local handle, so a buffer outlives its
+// thread and its events remain available for statistics and export.
+struct Buffer
+{
+  // Thread index, in order of registration
+  int tid;
+
+  // Recorded events, in program order
+  std::vector<profiler::Event> events;
+};
+
+struct Registry
+{
+  // Guards the buffer list, not the buffers' contents
+  std::mutex mutex;
+
+  // Buffers of all threads that have recorded events
+  std::vector<std::shared_ptr<Buffer>> buffers;
+
+  // Number of threads registered so far
+  int num_threads = 0;
+
+  // Common reference point for all timestamps
+  std::chrono::steady_clock::time_point epoch
+      = std::chrono::steady_clock::now();
+};
+//-----------------------------------------------------------------------------
+Registry& registry()
+{
+  static Registry r;
+  return r;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<Buffer>& local_buffer()
+{
+  thread_local std::shared_ptr<Buffer> buffer;
+  return buffer;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+double profiler::now()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                       - registry().epoch)
+      .count();
+}
+//-----------------------------------------------------------------------------
+void profiler::record(const char* name, bool begin)
+{
+  std::shared_ptr<Buffer>& buffer = local_buffer();
+  if (!buffer)
+  {
+    // First event on this thread: create its buffer and register it.
+    // This is the only locked path; all later events append to the
+    // thread-local buffer without synchronisation.
+    Registry& r = registry();
+    const std::lock_guard<std::mutex> lock(r.mutex);
+    buffer = std::make_shared<Buffer>();
+    buffer->tid = r.num_threads++;
+    buffer->events.reserve(1024);
+    r.buffers.push_back(buffer);
+  }
+
+  buffer->events.push_back({name, now(), begin});
+}
+//-----------------------------------------------------------------------------
+void profiler::reset()
+{
+  Registry& r = registry();
+  const std::lock_guard<std::mutex> lock(r.mutex);
+  for (const std::shared_ptr<Buffer>& buffer : r.buffers)
+    buffer->events.clear();
+}
+//-----------------------------------------------------------------------------
+Table profiler::statistics()
+{
+  // Replay the events of each thread against a scope stack, crediting
+  // the inclusive time of a scope to itself and subtracting it from
+  // the self time of the enclosing scope
+  struct Frame
+  {
+    const char* name;
+    double t0;
+    double child;
+  };
+
+  // name -> (calls, inclusive wall time, self wall time)
+  std::map<std::string, std::tuple<int, double, double>> scopes;
+
+  Registry& r = registry();
+  const std::lock_guard<std::mutex> lock(r.mutex);
+  for (const std::shared_ptr<Buffer>& buffer : r.buffers)
+  {
+    std::vector<Frame> stack;
+    for (const Event& e : buffer->events)
+    {
+      if (e.begin)
+        stack.push_back({e.name, e.t, 0.0});
+      else if (!stack.empty())
+      {
+        const Frame frame = stack.back();
+        stack.pop_back();
+        const double incl = e.t - frame.t0;
+        auto& [calls, wall, self] = scopes[frame.name];
+        calls += 1;
+        wall += incl;
+        self += incl - frame.child;
+        if (!stack.empty())
+          stack.back().child += incl;
+      }
+    }
+  }
+
+  Table table("Profiler summary");
+  for (const auto& [name, data] : scopes)
+  {
+    const auto [calls, wall, self] = data;
+    // NB - the cast to std::variant should not be needed: needed by Intel
+    // compiler.
+    table.set(name, "calls", std::variant<std::string, int, double>(calls));
+    table.set(name, "wall tot", wall);
+    table.set(name, "wall self", self);
+  }
+
+  return table;
+}
+//-----------------------------------------------------------------------------
+void profiler::list_statistics(MPI_Comm comm)
+{
+  // Reduce to rank 0 and append the per-rank spread of the inclusive
+  // wall time. The reduced tables are empty on other ranks, so the
+  // augmentation loop runs on rank 0 only.
+  const Table table = statistics();
+  Table t_avg = table.reduce(comm, Table::Reduction::average);
+  const Table t_min = table.reduce(comm, Table::Reduction::min);
+  const Table t_max = table.reduce(comm, Table::Reduction::max);
+  for (const std::string& name : t_avg.rows())
+  {
+    const double avg = std::get<double>(t_avg.get(name, "wall tot"));
+    const double max = std::get<double>(t_max.get(name, "wall tot"));
+    t_avg.set(name, "wall min", std::get<double>(t_min.get(name, "wall tot")));
+    t_avg.set(name, "wall max", max);
+    t_avg.set(name, "imbalance", avg > 0.0 ? max / avg : 1.0);
+  }
+
+  if (dolfinx::MPI::rank(comm) == 0)
+    std::cout << "\n" + t_avg.str() << std::endl;
+}
+//-----------------------------------------------------------------------------
+void profiler::write_trace(MPI_Comm comm, const std::string& filename)
+{
+  const int rank = dolfinx::MPI::rank(comm);
+  const int size = dolfinx::MPI::size(comm);
+
+  // Shift the local steady-clock timestamps into the common MPI_Wtime
+  // timebase and start the trace at the earliest epoch over all ranks,
+  // so the tracks of different ranks line up
+  const double offset = MPI_Wtime() - now();
+  double start = 0.0;
+  MPI_Allreduce(&offset, &start, 1, MPI_DOUBLE, MPI_MIN, comm);
+
+  // Serialise the local events as trace-event objects, one process per
+  // rank and one track per thread, timestamps in microseconds
+  std::ostringstream s;
+  {
+    Registry& r = registry();
+    const std::lock_guard<std::mutex> lock(r.mutex);
+    for (const std::shared_ptr<Buffer>& buffer : r.buffers)
+    {
+      for (const Event& e : buffer->events)
+      {
+        s << "{\"name\":\"" << e.name << "\",\"ph\":\""
+          << (e.begin ? 'B' : 'E') << "\",\"pid\":" << rank
+          << ",\"tid\":" << buffer->tid
+          << ",\"ts\":" << (offset + e.t - start) * 1e6 << "},\n";
+      }
+    }
+  }
+
+  // Gather the serialised events to rank 0
+  const std::string local = s.str();
+  const int local_size = local.size();
+  std::vector<int> pcounts(size), offsets(size + 1, 0);
+  MPI_Gather(&local_size, 1, MPI_INT, pcounts.data(), 1, MPI_INT, 0, comm);
+  std::partial_sum(pcounts.begin(), pcounts.end(), offsets.begin() + 1);
+  std::vector<char> events_all(offsets.back());
+  MPI_Gatherv(local.data(), local.size(), MPI_CHAR, events_all.data(),
+              pcounts.data(), offsets.data(), MPI_CHAR, 0, comm);
+
+  if (rank == 0)
+  {
+    std::ofstream file(filename);
+    if (!file)
+      throw std::runtime_error("Failed to open trace file \"" + filename
+                               + "\" for writing.");
+
+    // The empty object absorbs the trailing comma of the last event
+    file << "[\n";
+    file.write(events_all.data(), events_all.size());
+    file << "{}]\n";
+  }
+}
+//-----------------------------------------------------------------------------
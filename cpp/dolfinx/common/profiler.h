@@ -0,0 +1,105 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <dolfinx/common/Table.h>
+#include <mpi.h>
+#include <string>
+
+namespace dolfinx::common::profiler
+{
+
+/// Low-overhead hierarchical profiler. Scopes record begin/end events
+/// with a steady-clock timestamp into a per-thread buffer, so
+/// recording takes no locks on the hot path and is cheap enough for
+/// per-cell-block regions; a global mutex is taken only once per
+/// thread, when its buffer is first registered. Scope names must be
+/// string literals (or otherwise outlive the profiler), which avoids
+/// string copies when recording.
+///
+/// Instrument code with the DOLFINX_PROFILE_SCOPE and
+/// DOLFINX_PROFILE_FUNCTION macros; defining DOLFINX_DISABLE_PROFILING
+/// removes the instrumentation at compile time.
+
+/// A single begin or end event
+struct Event
+{
+  /// Scope name (not owned, must outlive the profiler)
+  const char* name;
+  /// Time in seconds since the profiling epoch
+  double t;
+  /// Begin event if true, end event otherwise
+  bool begin;
+};
+
+/// Append an event to the calling thread's buffer
+/// @param[in] name Scope name (not copied, must outlive the profiler)
+/// @param[in] begin Begin event if true, end event otherwise
+void record(const char* name, bool begin);
+
+/// Seconds elapsed since the profiling epoch
+double now();
+
+/// Profiling scope. Records a begin event at construction and the
+/// matching end event at destruction.
+class Scope
+{
+public:
+  /// Start a scope
+  /// @param[in] name Scope name (not copied, must outlive the
+  /// profiler)
+  Scope(const char* name) : _name(name) { record(_name, true); }
+
+  // Scopes are tied to their lexical extent and cannot be copied
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+  /// End the scope
+  ~Scope() { record(_name, false); }
+
+private:
+  const char* _name;
+};
+
+/// Discard all recorded events
+void reset();
+
+/// Aggregate the recorded events of this rank into a Table with the
+/// call count, inclusive wall time and self (exclusive) wall time per
+/// scope name
+Table statistics();
+
+/// List aggregated statistics with the per-rank spread: average,
+/// minimum and maximum inclusive wall time over the ranks, and the
+/// max/average imbalance ratio. Collective; prints on rank 0.
+/// @param[in] comm MPI Communicator
+void list_statistics(MPI_Comm comm);
+
+/// Write all recorded events to a Chrome trace-event JSON file, for
+/// viewing in chrome://tracing or Perfetto. Each rank appears as a
+/// process and each thread as a track, with timestamps shifted into
+/// the common MPI_Wtime timebase so overlap of work across ranks can
+/// be inspected. Collective; rank 0 writes the file.
+/// @param[in] comm MPI Communicator
+/// @param[in] filename Name of the trace file to write
+void write_trace(MPI_Comm comm, const std::string& filename);
+
+} // namespace dolfinx::common::profiler
+
+#ifdef DOLFINX_DISABLE_PROFILING
+#define DOLFINX_PROFILE_SCOPE(name)
+#define DOLFINX_PROFILE_FUNCTION()
+#else
+#define DOLFINX_PROFILE_CONCAT_(a, b) a##b
+#define DOLFINX_PROFILE_CONCAT(a, b) DOLFINX_PROFILE_CONCAT_(a, b)
+/// Profile the enclosing scope under the given name (string literal)
+#define DOLFINX_PROFILE_SCOPE(name)                                            \
+  dolfinx::common::profiler::Scope DOLFINX_PROFILE_CONCAT(_dolfinx_profile_,   \
+                                                          __LINE__)(name)
+/// Profile the enclosing function
+#define DOLFINX_PROFILE_FUNCTION() DOLFINX_PROFILE_SCOPE(__func__)
+#endif
@@ -7,10 +7,16 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <cstdint>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/Timer.h>
+#include <dolfinx/common/utils.h>
 #include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xview.hpp>
@@ -19,13 +25,15 @@
 namespace dolfinx
 {
 
-/// Sort a vector of integers with radix sorting algorithm.The bucket size is
-/// determined by the number of bits to sort at a time (2^BITS).
+namespace impl
+{
+/// Serial LSB radix sort. The bucket size is determined by the number
+/// of bits to sort at a time (2^BITS).
 /// @tparam T Integral type
 /// @tparam BITS The number of bits to sort at a time.
 /// @param[in, out] array The array to sort.
 template <typename T, int BITS = 8>
-void radix_sort(const xtl::span<T>& array)
+void radix_sort_serial(const xtl::span<T>& array)
 {
   static_assert(std::is_integral<T>(), "This function only sorts integers.");
 
@@ -85,6 +93,376 @@ void radix_sort(const xtl::span<T>& array)
   if (its % 2 != 0)
     std::copy(buffer.begin(), buffer.end(), array.begin());
 }
+} // namespace impl
+
+/// Sort a vector of integers with radix sorting algorithm. The bucket
+/// size is determined by the number of bits to sort at a time (2^BITS).
+/// Large arrays are partitioned by the most significant digit into
+/// buckets, which are contiguous in the output and are sorted
+/// independently on the shared thread pool.
+/// @tparam T Integral type
+/// @tparam BITS The number of bits to sort at a time.
+/// @param[in, out] array The array to sort.
+template <typename T, int BITS = 8>
+void radix_sort(const xtl::span<T>& array)
+{
+  static_assert(std::is_integral<T>(), "This function only sorts integers.");
+
+  if (array.size() <= 1)
+    return;
+
+  common::ThreadPool& pool = common::thread_pool();
+  const int num_threads = pool.num_workers() + 1;
+  constexpr std::size_t serial_cutoff = 1 << 16;
+  if (num_threads <= 1 or array.size() < serial_cutoff)
+    return impl::radix_sort_serial<T, BITS>(array);
+
+  T max_value = *std::max_element(array.begin(), array.end());
+  int its = 0;
+  while (max_value)
+  {
+    max_value >>= BITS;
+    its++;
+  }
+
+  // A single digit: nothing left to parallelise over
+  if (its <= 1)
+    return impl::radix_sort_serial<T, BITS>(array);
+
+  constexpr int bucket_size = 1 << BITS;
+  const int shift = (its - 1) * BITS;
+
+  // Histogram the most significant digit, one histogram per thread
+  std::vector<std::size_t> bounds(num_threads + 1);
+  for (int t = 0; t <= num_threads; ++t)
+    bounds[t] = (array.size() * t) / num_threads;
+  std::vector<std::array<std::int64_t, bucket_size>> counts(num_threads);
+  {
+    common::ThreadPool::TaskGroup tasks(pool);
+    for (int t = 0; t < num_threads; ++t)
+    {
+      tasks.run(
+          [&array, &counts, shift, &bounds, t]()
+          {
+            counts[t].fill(0);
+            for (std::size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+              counts[t][array[i] >> shift]++;
+          });
+    }
+  }
+
+  // Bucket offsets, and per-thread insertion positions within each
+  // bucket (thread order preserves nothing, only bucket membership)
+  std::vector<std::int64_t> offsets(bucket_size + 1, 0);
+  for (int t = 0; t < num_threads; ++t)
+  {
+    for (int b = 0; b < bucket_size; ++b)
+      offsets[b + 1] += counts[t][b];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<std::array<std::int64_t, bucket_size>> pos(num_threads);
+  for (int b = 0; b < bucket_size; ++b)
+  {
+    std::int64_t p = offsets[b];
+    for (int t = 0; t < num_threads; ++t)
+    {
+      pos[t][b] = p;
+      p += counts[t][b];
+    }
+  }
+
+  // Scatter into buckets; threads write to disjoint positions
+  std::vector<T> buffer(array.size());
+  {
+    common::ThreadPool::TaskGroup tasks(pool);
+    for (int t = 0; t < num_threads; ++t)
+    {
+      tasks.run(
+          [&array, &buffer, &pos, shift, &bounds, t]()
+          {
+            for (std::size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+              buffer[pos[t][array[i] >> shift]++] = array[i];
+          });
+    }
+  }
+
+  // Sort each bucket independently (values in a bucket share the most
+  // significant digit)
+  {
+    common::ThreadPool::TaskGroup tasks(pool);
+    for (int t = 0; t < num_threads; ++t)
+    {
+      tasks.run(
+          [&buffer, &offsets, num_threads, t]()
+          {
+            for (int b = t; b < bucket_size; b += num_threads)
+            {
+              impl::radix_sort_serial<T, BITS>(xtl::span<T>(buffer).subspan(
+                  offsets[b], offsets[b + 1] - offsets[b]));
+            }
+          });
+    }
+  }
+
+  std::copy(buffer.begin(), buffer.end(), array.begin());
+}
+
+namespace impl
+{
+/// Serial LSB radix sort of integer keys, with an array of payload
+/// values moved alongside the keys.
+/// @tparam K Integral key type
+/// @tparam V Payload type (trivially copyable)
+/// @tparam BITS The number of bits to sort at a time
+/// @param[in, out] keys The keys to sort
+/// @param[in, out] values The payloads, reordered alongside the keys
+template <typename K, typename V, int BITS = 8>
+void radix_sort_by_key_serial(const xtl::span<K>& keys,
+                              const xtl::span<V>& values)
+{
+  static_assert(std::is_integral<K>(), "This function only sorts integers.");
+  assert(keys.size() == values.size());
+
+  if (keys.size() <= 1)
+    return;
+
+  K max_value = *std::max_element(keys.begin(), keys.end());
+
+  constexpr int bucket_size = 1 << BITS;
+  K mask = (K(1) << BITS) - 1;
+
+  int its = 0;
+  while (max_value)
+  {
+    max_value >>= BITS;
+    its++;
+  }
+
+  std::array<std::int32_t, bucket_size> counter;
+  std::array<std::int32_t, bucket_size + 1> offset;
+
+  std::int32_t mask_offset = 0;
+  std::vector<K> key_buffer(keys.size());
+  std::vector<V> value_buffer(values.size());
+  xtl::span<K> current_keys = keys;
+  xtl::span<K> next_keys = key_buffer;
+  xtl::span<V> current_values = values;
+  xtl::span<V> next_values = value_buffer;
+  for (int i = 0; i < its; i++)
+  {
+    std::fill(counter.begin(), counter.end(), 0);
+    for (K c : current_keys)
+      counter[(c & mask) >> mask_offset]++;
+
+    offset[0] = 0;
+    std::partial_sum(counter.begin(), counter.end(), std::next(offset.begin()));
+    for (std::size_t k = 0; k < current_keys.size(); ++k)
+    {
+      std::int32_t bucket = (current_keys[k] & mask) >> mask_offset;
+      std::int32_t new_pos = offset[bucket + 1] - counter[bucket];
+      next_keys[new_pos] = current_keys[k];
+      next_values[new_pos] = current_values[k];
+      counter[bucket]--;
+    }
+
+    mask = mask << BITS;
+    mask_offset += BITS;
+
+    std::swap(current_keys, next_keys);
+    std::swap(current_values, next_values);
+  }
+
+  if (its % 2 != 0)
+  {
+    std::copy(key_buffer.begin(), key_buffer.end(), keys.begin());
+    std::copy(value_buffer.begin(), value_buffer.end(), values.begin());
+  }
+}
+} // namespace impl
+
+/// Sort an array of integer keys, applying the same permutation to an
+/// array of payload values. The payloads move with the keys during the
+/// radix passes, avoiding the permutation-then-gather of an argsort.
+/// Large arrays are partitioned by the most significant digit into
+/// buckets, which are contiguous in the output and are sorted
+/// independently on the shared thread pool.
+/// @tparam K Integral key type
+/// @tparam V Payload type (trivially copyable)
+/// @tparam BITS The number of bits to sort at a time
+/// @param[in, out] keys The keys to sort
+/// @param[in, out] values The payloads, reordered alongside the keys
+template <typename K, typename V, int BITS = 8>
+void radix_sort_by_key(const xtl::span<K>& keys, const xtl::span<V>& values)
+{
+  static_assert(std::is_integral<K>(), "This function only sorts integers.");
+  assert(keys.size() == values.size());
+
+  if (keys.size() <= 1)
+    return;
+
+  common::ThreadPool& pool = common::thread_pool();
+  const int num_threads = pool.num_workers() + 1;
+  constexpr std::size_t serial_cutoff = 1 << 16;
+  if (num_threads <= 1 or keys.size() < serial_cutoff)
+    return impl::radix_sort_by_key_serial<K, V, BITS>(keys, values);
+
+  K max_value = *std::max_element(keys.begin(), keys.end());
+  int its = 0;
+  while (max_value)
+  {
+    max_value >>= BITS;
+    its++;
+  }
+
+  // A single digit: nothing left to parallelise over
+  if (its <= 1)
+    return impl::radix_sort_by_key_serial<K, V, BITS>(keys, values);
+
+  constexpr int bucket_size = 1 << BITS;
+  const int shift = (its - 1) * BITS;
+
+  // Histogram the most significant digit, one histogram per thread
+  std::vector<std::size_t> bounds(num_threads + 1);
+  for (int t = 0; t <= num_threads; ++t)
+    bounds[t] = (keys.size() * t) / num_threads;
+  std::vector<std::array<std::int64_t, bucket_size>> counts(num_threads);
+  {
+    common::ThreadPool::TaskGroup tasks(pool);
+    for (int t = 0; t < num_threads; ++t)
+    {
+      tasks.run(
+          [&keys, &counts, shift, &bounds, t]()
+          {
+            counts[t].fill(0);
+            for (std::size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+              counts[t][keys[i] >> shift]++;
+          });
+    }
+  }
+
+  // Bucket offsets, and per-thread insertion positions within each
+  // bucket
+  std::vector<std::int64_t> offsets(bucket_size + 1, 0);
+  for (int t = 0; t < num_threads; ++t)
+  {
+    for (int b = 0; b < bucket_size; ++b)
+      offsets[b + 1] += counts[t][b];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<std::array<std::int64_t, bucket_size>> pos(num_threads);
+  for (int b = 0; b < bucket_size; ++b)
+  {
+    std::int64_t p = offsets[b];
+    for (int t = 0; t < num_threads; ++t)
+    {
+      pos[t][b] = p;
+      p += counts[t][b];
+    }
+  }
+
+  // Scatter keys and payloads into buckets; threads write to disjoint
+  // positions
+  std::vector<K> key_buffer(keys.size());
+  std::vector<V> value_buffer(values.size());
+  {
+    common::ThreadPool::TaskGroup tasks(pool);
+    for (int t = 0; t < num_threads; ++t)
+    {
+      tasks.run(
+          [&keys, &values, &key_buffer, &value_buffer, &pos, shift, &bounds,
+           t]()
+          {
+            for (std::size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+            {
+              const std::int64_t p = pos[t][keys[i] >> shift]++;
+              key_buffer[p] = keys[i];
+              value_buffer[p] = values[i];
+            }
+          });
+    }
+  }
+
+  // Sort each bucket independently on the remaining digits
+  {
+    common::ThreadPool::TaskGroup tasks(pool);
+    for (int t = 0; t < num_threads; ++t)
+    {
+      tasks.run(
+          [&key_buffer, &value_buffer, &offsets, num_threads, t]()
+          {
+            for (int b = t; b < bucket_size; b += num_threads)
+            {
+              impl::radix_sort_by_key_serial<K, V, BITS>(
+                  xtl::span<K>(key_buffer)
+                      .subspan(offsets[b], offsets[b + 1] - offsets[b]),
+                  xtl::span<V>(value_buffer)
+                      .subspan(offsets[b], offsets[b + 1] - offsets[b]));
+            }
+          });
+    }
+  }
+
+  std::copy(key_buffer.begin(), key_buffer.end(), keys.begin());
+  std::copy(value_buffer.begin(), value_buffer.end(), values.begin());
+}
+
+namespace common
+{
+/// Overload of sort_unique (common/utils.h) that takes ownership of
+/// the arrays. The values payload is moved alongside the indices by
+/// radix_sort_by_key rather than permuted afterwards, duplicates are
+/// removed in place (keeping the smallest value, as for sort_unique),
+/// and input that is already sorted with no duplicates -- the common
+/// case for entities coming from locate_entities -- is detected and
+/// returned without sorting.
+/// @param[in] indices Array of indices (integral, non-negative)
+/// @param[in] values Array of values
+/// @return Sorted (indices, values), with sorting based on indices
+template <
+    typename U, typename V,
+    typename = std::enable_if_t<!std::is_lvalue_reference_v<U>
+                                and !std::is_lvalue_reference_v<V>>>
+std::pair<std::decay_t<U>, std::decay_t<V>> sort_unique(U&& indices, V&& values)
+{
+  if (indices.size() != values.size())
+    throw std::runtime_error("Cannot sort two arrays of different lengths");
+
+  // Already sorted with no duplicates: nothing to do
+  if (std::adjacent_find(indices.begin(), indices.end(),
+                         [](auto a, auto b) { return a >= b; })
+      == indices.end())
+  {
+    return {std::move(indices), std::move(values)};
+  }
+
+  if (!std::is_sorted(indices.begin(), indices.end()))
+  {
+    radix_sort_by_key(
+        xtl::span(indices.data(), indices.size()),
+        xtl::span(values.data(), values.size()));
+  }
+
+  // Remove duplicate indices in place, keeping the smallest value
+  std::size_t w = 0;
+  for (std::size_t r = 0; r < indices.size();)
+  {
+    auto value = values[r];
+    std::size_t r1 = r + 1;
+    while (r1 < indices.size() and indices[r1] == indices[r])
+    {
+      value = std::min(value, values[r1]);
+      ++r1;
+    }
+    indices[w] = indices[r];
+    values[w] = value;
+    ++w;
+    r = r1;
+  }
+  indices.resize(w);
+  values.resize(w);
+  return {std::move(indices), std::move(values)};
+}
+} // namespace common
 
 /// Returns the indices that would sort (lexicographic) a vector of
 /// bitsets.
@@ -163,6 +541,76 @@ void argsort_radix(const xtl::span<const T>& array,
     std::copy(perm2.begin(), perm2.end(), perm.begin());
 }
 
+/// Returns the indices that would sort an array of 128-bit keys,
+/// stored as (hi, lo) pairs of std::uint64_t. The permutation is
+/// refined by radix passes over the low word and then the high word,
+/// so a single key comparison replaces a lexicographic row comparison.
+/// @tparam BITS The number of bits to sort at a time
+/// @param[in] array The array of keys to sort
+/// @param[in, out] perm The permutation to refine
+template <int BITS = 16>
+void argsort_radix128(
+    const xtl::span<const std::array<std::uint64_t, 2>>& array,
+    xtl::span<std::int32_t> perm)
+{
+  if (array.size() <= 1)
+    return;
+
+  constexpr int bucket_size = 1 << BITS;
+
+  // Adjacency list arrays for computing insertion position
+  std::array<std::int32_t, bucket_size> counter;
+  std::array<std::int32_t, bucket_size + 1> offset;
+
+  std::vector<std::int32_t> perm2(perm.size());
+  xtl::span<std::int32_t> current_perm = perm;
+  xtl::span<std::int32_t> next_perm = perm2;
+  int its_total = 0;
+
+  // Low word first (least significant), then high word
+  for (int word = 1; word >= 0; --word)
+  {
+    std::uint64_t max_value = 0;
+    for (std::int32_t cp : current_perm)
+      max_value = std::max(max_value, array[cp][word]);
+
+    int its = 0;
+    while (max_value)
+    {
+      max_value >>= BITS;
+      its++;
+    }
+
+    std::uint64_t mask = (std::uint64_t(1) << BITS) - 1;
+    std::int32_t mask_offset = 0;
+    for (int i = 0; i < its; i++)
+    {
+      std::fill(counter.begin(), counter.end(), 0);
+      for (std::int32_t cp : current_perm)
+        counter[(array[cp][word] & mask) >> mask_offset]++;
+
+      offset[0] = 0;
+      std::partial_sum(counter.begin(), counter.end(),
+                       std::next(offset.begin()));
+      for (std::int32_t cp : current_perm)
+      {
+        std::int32_t bucket = (array[cp][word] & mask) >> mask_offset;
+        std::int32_t pos = offset[bucket + 1] - counter[bucket];
+        next_perm[pos] = cp;
+        counter[bucket]--;
+      }
+
+      std::swap(current_perm, next_perm);
+      mask = mask << BITS;
+      mask_offset += BITS;
+      ++its_total;
+    }
+  }
+
+  if (its_total % 2 == 1)
+    std::copy(perm2.begin(), perm2.end(), perm.begin());
+}
+
 template <typename T, int BITS = 16>
 std::vector<std::int32_t> sort_by_perm(const xt::xtensor<T, 2>& array)
 {
@@ -8,6 +8,7 @@
 #include <dolfinx/common/log.h>
 #include <iostream>
 #include <mpi.h>
+#include <mutex>
 #include <petscsys.h>
 #include <string>
 #include <vector>
@@ -18,6 +19,14 @@
 
 using namespace dolfinx::common;
 
+namespace
+{
+// Arguments recorded by init_petsc_deferred, consumed by
+// ensure_petsc_initialized
+std::mutex deferred_mutex;
+std::vector<std::string> deferred_args;
+} // namespace
+
 //-----------------------------------------------------------------------------
 void subsystem::init_mpi()
 {
@@ -86,6 +95,42 @@ void subsystem::init_petsc(int argc, char* argv[])
 #endif
 }
 //-----------------------------------------------------------------------------
+void subsystem::init_petsc_deferred(int argc, char* argv[])
+{
+  std::lock_guard<std::mutex> lock(deferred_mutex);
+  deferred_args.assign(argv, argv + argc);
+}
+//-----------------------------------------------------------------------------
+void subsystem::ensure_petsc_initialized()
+{
+  PetscBool is_initialized;
+  PetscInitialized(&is_initialized);
+  if (is_initialized)
+    return;
+
+  std::lock_guard<std::mutex> lock(deferred_mutex);
+
+  // Re-check under the lock in case another thread initialized while
+  // we waited
+  PetscInitialized(&is_initialized);
+  if (is_initialized)
+    return;
+
+  // Rebuild an argv from the recorded arguments (PETSc may modify it)
+  std::vector<char*> argv;
+  for (std::string& s : deferred_args)
+    argv.push_back(s.data());
+  argv.push_back(nullptr);
+  int argc = deferred_args.size();
+  char** argv_ptr = argv.data();
+
+  LOG(INFO) << "Lazily initializing PETSc on first use.";
+  PetscInitialize(&argc, &argv_ptr, nullptr, nullptr);
+#ifdef HAS_SLEPC
+  SlepcInitialize(&argc, &argv_ptr, nullptr, nullptr);
+#endif
+}
+//-----------------------------------------------------------------------------
 void subsystem::finalize_mpi()
 {
   int mpi_initialized;
@@ -33,6 +33,19 @@ void init_petsc();
 /// arguments
 void init_petsc(int argc, char* argv[]);
 
+/// Record command-line arguments for a deferred PETSc initialization.
+/// PETSc is not initialized by this call; the first use of a PETSc
+/// object in dolfinx::la triggers the initialization with the recorded
+/// arguments. Tools that never touch dolfinx::la therefore never pay
+/// PETSc startup.
+void init_petsc_deferred(int argc, char* argv[]);
+
+/// Initialize PETSc (and SLEPc, if configured) now, if it has not been
+/// initialized yet, using any arguments recorded by
+/// init_petsc_deferred. Called from dolfinx::la before PETSc objects
+/// are created; cheap when PETSc is already up.
+void ensure_petsc_initialized();
+
 /// Check if MPI has been initialised (returns true if MPI has been
 /// initialised, even if it is later finalised)
 bool mpi_initialized();
@@ -5,6 +5,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "utils.h"
+#include <cstdlib>
 #include <sstream>
 
 //-----------------------------------------------------------------------------
@@ -24,3 +25,18 @@ std::string dolfinx::common::indent(std::string block)
   return s.str();
 }
 //-----------------------------------------------------------------------------
+int dolfinx::common::num_threads()
+{
+  static const int n = []()
+  {
+    if (const char* env = std::getenv("DOLFINX_NUM_THREADS"); env)
+    {
+      const int n = std::atoi(env);
+      if (n > 0)
+        return n;
+    }
+    return 1;
+  }();
+  return n;
+}
+//-----------------------------------------------------------------------------
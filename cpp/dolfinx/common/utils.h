@@ -56,6 +56,12 @@ std::pair<U, V> sort_unique(const U& indices, const V& values)
 /// Indent string block
 std::string indent(std::string block);
 
+/// Number of threads to use inside a rank for threaded code paths
+/// (e.g. coloured assembly). Controlled by the environment variable
+/// `DOLFINX_NUM_THREADS`; defaults to 1 (serial). The shared worker
+/// pool (common::thread_pool()) is sized from this value.
+int num_threads();
+
 /// Convert a container to string
 template <typename T>
 std::string container_to_string(const T& x, int precision, int linebreak)
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <stdexcept>
 #include <vector>
 #include <xtensor/xarray.hpp>
 
@@ -29,10 +31,41 @@ public:
     std::copy(c.shape().cbegin(), c.shape().cend(), std::back_inserter(shape));
   }
 
+  /// Update the value of a rank-0 constant and increment the version
+  /// counter
+  void update(T c)
+  {
+    if (value.size() != 1)
+      throw std::runtime_error("Constant value shape mismatch.");
+    value[0] = c;
+    ++_version;
+  }
+
+  /// Update the value(s) of the constant (flattened) and increment the
+  /// version counter
+  void update(const std::vector<T>& c)
+  {
+    if (c.size() != value.size())
+      throw std::runtime_error("Constant value shape mismatch.");
+    value = c;
+    ++_version;
+  }
+
+  /// Version counter for the constant value. It is incremented on each
+  /// update() and can be used to invalidate caches of derived data,
+  /// e.g. packed constants on a Form.
+  /// @note Writing to the public `value` member directly bypasses the
+  /// counter; use update() when caches should be refreshed.
+  std::size_t version() const noexcept { return _version; }
+
   /// Shape
   std::vector<int> shape;
 
   /// Values, stored as a flattened array.
   std::vector<T> value;
+
+private:
+  // Version counter for value (see version())
+  std::size_t _version = 0;
 };
 } // namespace dolfinx::fem
@@ -9,6 +9,7 @@
 #include <cmath>
 #include <dolfinx/common/math.h>
 #include <dolfinx/mesh/cell_types.h>
+#include <xtensor/xfixed.hpp>
 #include <xtensor/xnoalias.hpp>
 #include <xtensor/xview.hpp>
 
@@ -23,6 +24,13 @@ CoordinateElement::CoordinateElement(
   int degree = _element->degree();
   const mesh::CellType cell = cell_shape();
   _is_affine = mesh::is_simplex(cell) and degree == 1;
+
+  // Cache basis first derivatives at the reference cell origin. For
+  // affine maps this table fully determines the (constant) Jacobian.
+  const std::size_t tdim = topological_dimension();
+  const xt::xtensor<double, 2> X0 = xt::zeros<double>({std::size_t(1), tdim});
+  const xt::xtensor<double, 4> data = _element->tabulate(1, X0);
+  _dphi0 = xt::view(data, xt::range(1, tdim + 1), 0, xt::all(), 0);
 }
 //-----------------------------------------------------------------------------
 CoordinateElement::CoordinateElement(mesh::CellType celltype, int degree,
@@ -91,23 +99,6 @@ CoordinateElement::x0(const xt::xtensor<double, 2>& cell_geometry)
   return x0;
 }
 //-----------------------------------------------------------------------------
-void CoordinateElement::pull_back_affine(xt::xtensor<double, 2>& X,
-                                         const xt::xtensor<double, 2>& K,
-                                         const std::array<double, 3>& x0,
-                                         const xt::xtensor<double, 2>& x)
-{
-  assert(X.shape(0) == x.shape(0));
-  assert(X.shape(1) == K.shape(0));
-  assert(x.shape(1) == K.shape(1));
-
-  // Calculate X for each point
-  X.fill(0.0);
-  for (std::size_t p = 0; p < x.shape(0); ++p)
-    for (std::size_t i = 0; i < K.shape(0); ++i)
-      for (std::size_t j = 0; j < K.shape(1); ++j)
-        X(p, i) += K(i, j) * (x(p, j) - x0[j]);
-}
-//-----------------------------------------------------------------------------
 void CoordinateElement::pull_back_nonaffine(
     xt::xtensor<double, 2>& X, const xt::xtensor<double, 2>& x,
     const xt::xtensor<double, 2>& cell_geometry, double tol, int maxit) const
@@ -119,17 +110,19 @@ void CoordinateElement::pull_back_nonaffine(
 
   const std::size_t tdim = this->topological_dimension();
   const std::size_t gdim = x.shape(1);
-  const std::size_t num_xnodes = cell_geometry.shape(0);
   assert(cell_geometry.shape(1) == gdim);
   assert(X.shape(0) == num_points);
   assert(X.shape(1) == tdim);
 
-  xt::xtensor<double, 2> dphi({tdim, num_xnodes});
+  // Fixed-size (stack) work matrices for the Newton update. Only the
+  // top-left (gdim, tdim) blocks are used; gdim and tdim are at most 3.
+  xt::xtensor_fixed<double, xt::xshape<3, 3>> Jb, Kb;
+  auto J = xt::view(Jb, xt::range(0, gdim), xt::range(0, tdim));
+  auto K = xt::view(Kb, xt::range(0, tdim), xt::range(0, gdim));
+
   xt::xtensor<double, 2> Xk({1, tdim});
   std::array<double, 3> xk = {0, 0, 0};
-  xt::xtensor<double, 1> dX = xt::empty<double>({tdim});
-  xt::xtensor<double, 2> J({gdim, tdim});
-  xt::xtensor<double, 2> K({tdim, gdim});
+  std::array<double, 3> dX = {0, 0, 0};
   xt::xtensor<double, 4> basis(_element->tabulate_shape(1, 1));
   for (std::size_t p = 0; p < num_points; ++p)
   {
@@ -146,19 +139,26 @@ void CoordinateElement::pull_back_nonaffine(
         for (std::size_t j = 0; j < cell_geometry.shape(0); ++j)
           xk[i] += cell_geometry(j, i) * phi[j];
 
-      // Compute Jacobian, its inverse and determinant
+      // Compute Jacobian and its inverse
+      auto dphi = xt::view(basis, xt::range(1, tdim + 1), 0, xt::all(), 0);
       J.fill(0);
-      dphi = xt::view(basis, xt::range(1, tdim + 1), 0, xt::all(), 0);
       compute_jacobian(dphi, cell_geometry, J);
       compute_jacobian_inverse(J, K);
 
-      dX.fill(0.0);
-      for (std::size_t i = 0; i < K.shape(0); ++i)
-        for (std::size_t j = 0; j < K.shape(1); ++j)
+      // Newton update dX = K (x - x(Xk))
+      std::fill(dX.begin(), dX.end(), 0.0);
+      for (std::size_t i = 0; i < tdim; ++i)
+        for (std::size_t j = 0; j < gdim; ++j)
           dX[i] += K(i, j) * (x(p, j) - xk[j]);
 
-      Xk += dX;
-      if (std::sqrt(xt::sum(dX * dX)()) < tol)
+      double norm_sq = 0;
+      for (std::size_t i = 0; i < tdim; ++i)
+      {
+        Xk(0, i) += dX[i];
+        norm_sq += dX[i] * dX[i];
+      }
+
+      if (norm_sq < tol * tol)
         break;
     }
     xt::row(X, p) = xt::row(Xk, 0);
@@ -170,6 +170,30 @@ void CoordinateElement::pull_back_nonaffine(
   }
 }
 //-----------------------------------------------------------------------------
+void CoordinateElement::pull_back(
+    xt::xtensor<double, 2>& X, const xt::xtensor<double, 2>& x,
+    const xt::xtensor<double, 2>& cell_geometry) const
+{
+  if (_is_affine)
+  {
+    const std::size_t tdim = this->topological_dimension();
+    const std::size_t gdim = x.shape(1);
+
+    // The map is affine, so the Jacobian is constant over the cell and
+    // is determined by the cached derivative table at the reference
+    // origin
+    xt::xtensor_fixed<double, xt::xshape<3, 3>> Jb, Kb;
+    auto J = xt::view(Jb, xt::range(0, gdim), xt::range(0, tdim));
+    auto K = xt::view(Kb, xt::range(0, tdim), xt::range(0, gdim));
+    J.fill(0);
+    compute_jacobian(_dphi0, cell_geometry, J);
+    compute_jacobian_inverse(J, K);
+    pull_back_affine(X, K, x0(cell_geometry), x);
+  }
+  else
+    pull_back_nonaffine(X, x, cell_geometry);
+}
+//-----------------------------------------------------------------------------
 void CoordinateElement::permute_dofs(const xtl::span<std::int32_t>& dofs,
                                      std::uint32_t cell_perm) const
 {
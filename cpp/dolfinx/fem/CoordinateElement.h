@@ -13,6 +13,7 @@
 #include <dolfinx/mesh/cell_types.h>
 #include <memory>
 #include <xtensor/xtensor.hpp>
+#include <xtensor/xview.hpp>
 #include <xtl/xspan.hpp>
 
 namespace basix
@@ -128,6 +129,40 @@ public:
     }
   }
 
+  /// Compute the inverses and determinants of a contiguous block of
+  /// Jacobians using the batched fixed-size kernels. For square
+  /// Jacobians the whole block is processed by a single unrolled,
+  /// vectorizable loop with no per-matrix dispatch or temporaries.
+  /// @param[in] J The Jacobians (shape=(num_matrices, gdim, tdim))
+  /// @param[out] K The inverses (shape=(num_matrices, tdim, gdim))
+  /// @param[out] detJ The determinants (size num_matrices)
+  static void compute_jacobian_inverse_batch(const xt::xtensor<double, 3>& J,
+                                             xt::xtensor<double, 3>& K,
+                                             xtl::span<double> detJ)
+  {
+    const std::size_t n = J.shape(0);
+    const std::size_t gdim = J.shape(1);
+    const std::size_t tdim = J.shape(2);
+    assert(K.shape(0) == n);
+    assert(K.shape(1) == tdim);
+    assert(K.shape(2) == gdim);
+    assert(detJ.size() == n);
+    if (gdim == tdim and gdim == 3)
+      math::inv_3x3_batch(n, J.data(), K.data(), detJ.data());
+    else if (gdim == tdim and gdim == 2)
+      math::inv_2x2_batch(n, J.data(), K.data(), detJ.data());
+    else
+    {
+      // Mixed-dimension (or 1D) fall-back, one matrix at a time
+      for (std::size_t p = 0; p < n; ++p)
+      {
+        auto _J = xt::view(J, p, xt::all(), xt::all());
+        compute_jacobian_inverse(_J, xt::view(K, p, xt::all(), xt::all()));
+        detJ[p] = compute_jacobian_determinant(_J);
+      }
+    }
+  }
+
   /// Compute and return the dof layout
   ElementDofLayout create_dof_layout() const;
 
@@ -158,10 +193,35 @@ public:
   /// @param[in] x0 The physical coordinate of reference coordinate X0=(0, 0,
   /// 0).
   /// @param[in] x The physical coordinates (shape=(num_points, gdim))
-  static void pull_back_affine(xt::xtensor<double, 2>& X,
-                               const xt::xtensor<double, 2>& K,
-                               const std::array<double, 3>& x0,
-                               const xt::xtensor<double, 2>& x);
+  template <typename U, typename V, typename W>
+  static void pull_back_affine(U&& X, const V& K,
+                               const std::array<double, 3>& x0, const W& x)
+  {
+    assert(X.shape(0) == x.shape(0));
+    assert(X.shape(1) == K.shape(0));
+    assert(x.shape(1) == K.shape(1));
+
+    // Calculate X for each point
+    X.fill(0.0);
+    for (std::size_t p = 0; p < x.shape(0); ++p)
+      for (std::size_t i = 0; i < K.shape(0); ++i)
+        for (std::size_t j = 0; j < K.shape(1); ++j)
+          X(p, i) += K(i, j) * (x(p, j) - x0[j]);
+  }
+
+  /// Compute reference coordinates X for a batch of physical
+  /// coordinates x in a single cell. For an affine map the constant
+  /// Jacobian is computed once from the cached derivative table and the
+  /// closed-form inverse map is applied to all points; otherwise a
+  /// Newton iteration is run per point. The work matrices are
+  /// fixed-size stack buffers, so no per-point heap allocation is
+  /// performed.
+  /// @param[out] X The reference coordinates (shape=(num_points, tdim))
+  /// @param[in] x The physical coordinates (shape=(num_points, gdim))
+  /// @param[in] cell_geometry The cell node coordinates (shape=(num
+  /// geometry nodes, gdim))
+  void pull_back(xt::xtensor<double, 2>& X, const xt::xtensor<double, 2>& x,
+                 const xt::xtensor<double, 2>& cell_geometry) const;
 
   /// Compute reference coordinates X for physical coordinates x for a
   /// non-affine map.
@@ -198,11 +258,22 @@ public:
   /// @return True is geometry map is affine
   bool is_affine() const noexcept { return _is_affine; }
 
+  /// Tabulated basis function first derivatives at the reference cell
+  /// origin (shape=(tdim, num geometry nodes)). For an affine map the
+  /// derivatives are constant over the cell, so the Jacobian can be
+  /// computed directly from this cached table via compute_jacobian
+  /// without re-tabulating the basis for every cell or point.
+  const xt::xtensor<double, 2>& dphi0() const noexcept { return _dphi0; }
+
 private:
   // Flag denoting affine map
   bool _is_affine;
 
   // Basix Element
   std::shared_ptr<basix::FiniteElement> _element;
+
+  // Basis first derivatives at the reference cell origin
+  // (shape=(tdim, num geometry nodes))
+  xt::xtensor<double, 2> _dphi0;
 };
 } // namespace dolfinx::fem
@@ -10,12 +10,15 @@
 #include <algorithm>
 #include <array>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/sort.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
 #include <dolfinx/mesh/cell_types.h>
 #include <map>
 #include <numeric>
+#include <thread>
 #include <utility>
 #include <xtensor/xtensor.hpp>
 
@@ -271,6 +274,32 @@ get_remote_bcs2(const common::IndexMap& map0, int bs0,
   return dofs;
 }
 //-----------------------------------------------------------------------------
+
+/// Execute f(begin, end) over the index range [0, n), splitting the
+/// range across common::num_threads() threads. Writes from different
+/// sub-ranges must not overlap.
+template <typename Fn>
+void parallel_for_ranges(std::size_t n, Fn&& f)
+{
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads <= 1)
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    const std::size_t begin = (n * t) / num_threads;
+    const std::size_t end = (n * (t + 1)) / num_threads;
+    if (begin != end)
+      threads.emplace_back(f, begin, end);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+}
+//-----------------------------------------------------------------------------
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -314,13 +343,17 @@ std::array<std::vector<std::int32_t>, 2> fem::locate_dofs_topological(
   const int element_bs = dofmap0->element_dof_layout->block_size();
   assert(element_bs == dofmap1->element_dof_layout->block_size());
 
-  // Build vector local dofs for each cell facet
-  std::vector<std::vector<int>> entity_dofs;
-  for (int i = 0;
-       i < mesh::cell_num_entities(mesh->topology().cell_type(), dim); ++i)
+  // Build flattened entity-closure dof table, one row per local entity
+  const int num_cell_entities
+      = mesh::cell_num_entities(mesh->topology().cell_type(), dim);
+  std::vector<int> entity_dofs(num_cell_entities * num_entity_dofs);
+  for (int i = 0; i < num_cell_entities; ++i)
   {
-    entity_dofs.push_back(
-        dofmap0->element_dof_layout->entity_closure_dofs(dim, i));
+    const std::vector<int> dofs_i
+        = dofmap0->element_dof_layout->entity_closure_dofs(dim, i);
+    assert((int)dofs_i.size() == num_entity_dofs);
+    std::copy(dofs_i.begin(), dofs_i.end(),
+              std::next(entity_dofs.begin(), i * num_entity_dofs));
   }
   auto e_to_c = mesh->topology().connectivity(dim, tdim);
   assert(e_to_c);
@@ -330,40 +363,55 @@ std::array<std::vector<std::int32_t>, 2> fem::locate_dofs_topological(
   const int bs0 = dofmap0->bs();
   const int bs1 = dofmap1->bs();
 
-  // Iterate over marked facets
-  std::vector<std::array<std::int32_t, 2>> bc_dofs;
-  for (std::int32_t e : entities)
-  {
-    // Get first attached cell
-    assert(e_to_c->num_links(e) > 0);
-    const int cell = e_to_c->links(e)[0];
-
-    // Get local index of facet with respect to the cell
-    auto entities_d = c_to_e->links(cell);
-    auto it = std::find(entities_d.begin(), entities_d.end(), e);
-    assert(it != entities_d.end());
-    const int entity_local_index = std::distance(entities_d.begin(), it);
-
-    // Get cell dofmap
-    xtl::span<const std::int32_t> cell_dofs0 = dofmap0->cell_dofs(cell);
-    xtl::span<const std::int32_t> cell_dofs1 = dofmap1->cell_dofs(cell);
-    assert(bs0 * cell_dofs0.size() == bs1 * cell_dofs1.size());
-
-    // Loop over facet dofs and 'unpack' blocked dofs
-    for (int i = 0; i < num_entity_dofs; ++i)
-    {
-      const int index = entity_dofs[entity_local_index][i];
-      for (int block = 0; block < element_bs; ++block)
+  // Iterate over marked facets. Each entity contributes a fixed number
+  // of dofs, so the output is preallocated and entities are processed
+  // in parallel with each thread writing a disjoint slice.
+  const int dofs_per_entity = element_bs * num_entity_dofs;
+  std::vector<std::array<std::int32_t, 2>> bc_dofs(entities.size()
+                                                   * dofs_per_entity);
+  parallel_for_ranges(
+      entities.size(),
+      [&](std::size_t begin, std::size_t end)
       {
-        const int local_pos = element_bs * index + block;
-        const std::div_t pos0 = std::div(local_pos, bs0);
-        const std::div_t pos1 = std::div(local_pos, bs1);
-        const std::int32_t dof_index0 = bs0 * cell_dofs0[pos0.quot] + pos0.rem;
-        const std::int32_t dof_index1 = bs1 * cell_dofs1[pos1.quot] + pos1.rem;
-        bc_dofs.push_back({dof_index0, dof_index1});
-      }
-    }
-  }
+        for (std::size_t idx = begin; idx < end; ++idx)
+        {
+          const std::int32_t e = entities[idx];
+
+          // Get first attached cell
+          assert(e_to_c->num_links(e) > 0);
+          const int cell = e_to_c->links(e)[0];
+
+          // Get local index of facet with respect to the cell
+          auto entities_d = c_to_e->links(cell);
+          auto it = std::find(entities_d.begin(), entities_d.end(), e);
+          assert(it != entities_d.end());
+          const int entity_local_index = std::distance(entities_d.begin(), it);
+
+          // Get cell dofmap
+          xtl::span<const std::int32_t> cell_dofs0 = dofmap0->cell_dofs(cell);
+          xtl::span<const std::int32_t> cell_dofs1 = dofmap1->cell_dofs(cell);
+          assert(bs0 * cell_dofs0.size() == bs1 * cell_dofs1.size());
+
+          // Loop over facet dofs and 'unpack' blocked dofs
+          for (int i = 0; i < num_entity_dofs; ++i)
+          {
+            const int index = entity_dofs[entity_local_index * num_entity_dofs
+                                          + i];
+            for (int block = 0; block < element_bs; ++block)
+            {
+              const int local_pos = element_bs * index + block;
+              const std::div_t pos0 = std::div(local_pos, bs0);
+              const std::div_t pos1 = std::div(local_pos, bs1);
+              const std::int32_t dof_index0
+                  = bs0 * cell_dofs0[pos0.quot] + pos0.rem;
+              const std::int32_t dof_index1
+                  = bs1 * cell_dofs1[pos1.quot] + pos1.rem;
+              bc_dofs[idx * dofs_per_entity + element_bs * i + block]
+                  = {dof_index0, dof_index1};
+            }
+          }
+        }
+      });
 
   // TODO: is removing duplicates at this point worth the effort?
   // Remove duplicates
@@ -418,14 +466,19 @@ fem::locate_dofs_topological(const fem::FunctionSpace& V, int dim,
   mesh->topology_mutable().create_connectivity(dim, tdim);
 
   // Prepare an element - local dof layout for dofs on entities of the
-  // entity_dim
+  // entity_dim, flattened with one row per local entity
   const int num_cell_entities
       = mesh::cell_num_entities(mesh->topology().cell_type(), dim);
-  std::vector<std::vector<int>> entity_dofs;
+  const int num_entity_closure_dofs
+      = dofmap->element_dof_layout->num_entity_closure_dofs(dim);
+  std::vector<int> entity_dofs(num_cell_entities * num_entity_closure_dofs);
   for (int i = 0; i < num_cell_entities; ++i)
   {
-    entity_dofs.push_back(
-        dofmap->element_dof_layout->entity_closure_dofs(dim, i));
+    const std::vector<int> dofs_i
+        = dofmap->element_dof_layout->entity_closure_dofs(dim, i);
+    assert((int)dofs_i.size() == num_entity_closure_dofs);
+    std::copy(dofs_i.begin(), dofs_i.end(),
+              std::next(entity_dofs.begin(), i * num_entity_closure_dofs));
   }
 
   auto e_to_c = mesh->topology().connectivity(dim, tdim);
@@ -433,35 +486,44 @@ fem::locate_dofs_topological(const fem::FunctionSpace& V, int dim,
   auto c_to_e = mesh->topology().connectivity(tdim, dim);
   assert(c_to_e);
 
-  const int num_entity_closure_dofs
-      = dofmap->element_dof_layout->num_entity_closure_dofs(dim);
-  std::vector<std::int32_t> dofs;
-  for (std::int32_t e : entities)
-  {
-    // Get first attached cell
-    assert(e_to_c->num_links(e) > 0);
-    const int cell = e_to_c->links(e)[0];
-
-    // Get local index of facet with respect to the cell
-    auto entities_d = c_to_e->links(cell);
-    auto it = std::find(entities_d.begin(), entities_d.end(), e);
-    assert(it != entities_d.end());
-    const int entity_local_index = std::distance(entities_d.data(), it);
-
-    // Get cell dofmap
-    auto cell_dofs = dofmap->cell_dofs(cell);
-
-    // Loop over entity dofs
-    for (int j = 0; j < num_entity_closure_dofs; j++)
-    {
-      const int index = entity_dofs[entity_local_index][j];
-      dofs.push_back(cell_dofs[index]);
-    }
-  }
+  // Each entity contributes num_entity_closure_dofs dofs, so the
+  // output is preallocated and entities are processed in parallel with
+  // each thread writing a disjoint slice
+  std::vector<std::int32_t> dofs(entities.size() * num_entity_closure_dofs);
+  parallel_for_ranges(
+      entities.size(),
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t idx = begin; idx < end; ++idx)
+        {
+          const std::int32_t e = entities[idx];
+
+          // Get first attached cell
+          assert(e_to_c->num_links(e) > 0);
+          const int cell = e_to_c->links(e)[0];
+
+          // Get local index of facet with respect to the cell
+          auto entities_d = c_to_e->links(cell);
+          auto it = std::find(entities_d.begin(), entities_d.end(), e);
+          assert(it != entities_d.end());
+          const int entity_local_index = std::distance(entities_d.data(), it);
+
+          // Get cell dofmap
+          auto cell_dofs = dofmap->cell_dofs(cell);
+
+          // Loop over entity dofs
+          for (int j = 0; j < num_entity_closure_dofs; j++)
+          {
+            const int index
+                = entity_dofs[entity_local_index * num_entity_closure_dofs + j];
+            dofs[idx * num_entity_closure_dofs + j] = cell_dofs[index];
+          }
+        }
+      });
 
   // TODO: is removing duplicates at this point worth the effort?
   // Remove duplicates
-  std::sort(dofs.begin(), dofs.end());
+  dolfinx::radix_sort(xtl::span<std::int32_t>(dofs));
   dofs.erase(std::unique(dofs.begin(), dofs.end()), dofs.end());
 
   if (remote)
@@ -473,7 +535,7 @@ fem::locate_dofs_topological(const fem::FunctionSpace& V, int dim,
     dofs.insert(dofs.end(), dofs_remote.begin(), dofs_remote.end());
 
     // Remove duplicates
-    std::sort(dofs.begin(), dofs.end());
+    dolfinx::radix_sort(xtl::span<std::int32_t>(dofs));
     dofs.erase(std::unique(dofs.begin(), dofs.end()), dofs.end());
   }
 
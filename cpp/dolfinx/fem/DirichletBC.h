@@ -8,9 +8,12 @@
 
 #include "Function.h"
 #include "FunctionSpace.h"
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <dolfinx/la/utils.h>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <vector>
 #include <xtensor/xtensor.hpp>
@@ -166,6 +169,7 @@ public:
 
     // TODO: allows single dofs array (let one point to the other)
     _dofs1_g = _dofs0;
+    build_marker();
   }
 
   /// Create a representation of a Dirichlet boundary condition where
@@ -199,6 +203,7 @@ public:
     const int owned_size0 = map0_bs * map0_size;
     auto it0 = std::lower_bound(_dofs0.begin(), _dofs0.end(), owned_size0);
     _owned_indices0 = std::distance(_dofs0.begin(), it0);
+    build_marker();
   }
 
   /// Copy constructor
@@ -241,6 +246,12 @@ public:
     return {_dofs0, _owned_indices0};
   }
 
+  /// Dense marker over the owned+ghost dof range of the constrained
+  /// space (unrolled indices). Entry i is 1 if dof i has this boundary
+  /// condition applied, 0 otherwise. Computed once at construction.
+  /// @return Marker array of length `bs * (size_local + num_ghosts)`
+  xtl::span<const std::int8_t> marker() const { return _marker; }
+
   /// Set bc entries in `x` to `scale * x_bc`
   ///
   /// @param[in] x The array in which to set `scale * x_bc[i]`, where
@@ -254,15 +265,12 @@ public:
   /// @param[in] scale The scaling value to apply
   void set(xtl::span<T> x, double scale = 1.0) const
   {
-    assert(_g);
-    xtl::span<const T> g = _g->x()->array();
-    for (std::size_t i = 0; i < _dofs0.size(); ++i)
+    update_value_cache();
+    const std::size_t size = std::min(x.size(), _value_cache.size());
+    for (std::size_t i = 0; i < size; ++i)
     {
-      if (_dofs0[i] < (std::int32_t)x.size())
-      {
-        assert(_dofs1_g[i] < (std::int32_t)g.size());
-        x[_dofs0[i]] = scale * g[_dofs1_g[i]];
-      }
+      if (_marker[i])
+        x[i] = scale * _value_cache[i];
     }
   }
 
@@ -273,16 +281,13 @@ public:
   void set(xtl::span<T> x, const xtl::span<const T>& x0,
            double scale = 1.0) const
   {
-    assert(_g);
-    xtl::span<const T> g = _g->x()->array();
     assert(x.size() <= x0.size());
-    for (std::size_t i = 0; i < _dofs0.size(); ++i)
+    update_value_cache();
+    const std::size_t size = std::min(x.size(), _value_cache.size());
+    for (std::size_t i = 0; i < size; ++i)
     {
-      if (_dofs0[i] < (std::int32_t)x.size())
-      {
-        assert(_dofs1_g[i] < (std::int32_t)g.size());
-        x[_dofs0[i]] = scale * (g[_dofs1_g[i]] - x0[_dofs0[i]]);
-      }
+      if (_marker[i])
+        x[i] = scale * (_value_cache[i] - x0[i]);
     }
   }
 
@@ -296,10 +301,13 @@ public:
   /// (the space of the function that provides the dof values)
   void dof_values(xtl::span<T> values) const
   {
-    assert(_g);
-    xtl::span<const T> g = _g->x()->array();
-    for (std::size_t i = 0; i < _dofs1_g.size(); ++i)
-      values[_dofs0[i]] = g[_dofs1_g[i]];
+    update_value_cache();
+    const std::size_t size = std::min(values.size(), _value_cache.size());
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      if (_marker[i])
+        values[i] = _value_cache[i];
+    }
   }
 
   /// Set markers[i] = true if dof i has a boundary condition applied.
@@ -310,14 +318,97 @@ public:
   /// unchanged.
   void mark_dofs(std::vector<bool>& markers) const
   {
-    for (std::size_t i = 0; i < _dofs0.size(); ++i)
+    if (markers.size() == _marker.size())
+    {
+      // Stream through the precomputed dense marker
+      for (std::size_t i = 0; i < _marker.size(); ++i)
+      {
+        if (_marker[i])
+          markers[i] = true;
+      }
+    }
+    else
+    {
+      for (std::size_t i = 0; i < _dofs0.size(); ++i)
+      {
+        assert(_dofs0[i] < (std::int32_t)markers.size());
+        markers[_dofs0[i]] = true;
+      }
+    }
+  }
+
+  /// Cells with at least one dof of this boundary condition in their
+  /// closure, computed from the dof marker and the dofmap of the
+  /// constrained space. The list is sorted, has no duplicates, and is
+  /// built on first call and then cached. It is used by the assembler
+  /// to restrict boundary condition lifting to the cells that can
+  /// contribute, rather than sweeping all cells of the form.
+  /// @return Sorted array of cell indices (local to process)
+  const std::vector<std::int32_t>& constrained_cells() const
+  {
+    if (!_cells_built)
     {
-      assert(_dofs0[i] < (std::int32_t)markers.size());
-      markers[_dofs0[i]] = true;
+      assert(_function_space);
+      const graph::AdjacencyList<std::int32_t>& dofmap
+          = _function_space->dofmap()->list();
+      const int bs = _function_space->dofmap()->bs();
+      const std::int32_t num_cells = dofmap.num_nodes();
+      for (std::int32_t c = 0; c < num_cells; ++c)
+      {
+        auto dofs = dofmap.links(c);
+        const bool constrained
+            = std::any_of(dofs.begin(), dofs.end(),
+                          [&](std::int32_t dof)
+                          {
+                            for (int k = 0; k < bs; ++k)
+                            {
+                              if (_marker[bs * dof + k])
+                                return true;
+                            }
+                            return false;
+                          });
+        if (constrained)
+          _constrained_cells.push_back(c);
+      }
+      _cells_built = true;
     }
+    return _constrained_cells;
   }
 
 private:
+  // Build the dense dof marker over the owned+ghost range of the
+  // constrained space
+  void build_marker()
+  {
+    assert(_function_space);
+    auto map = _function_space->dofmap()->index_map;
+    const int bs = _function_space->dofmap()->index_map_bs();
+    assert(map);
+    _marker.assign(bs * (map->size_local() + map->num_ghosts()), 0);
+    for (std::int32_t dof : _dofs0)
+    {
+      assert(dof < (std::int32_t)_marker.size());
+      _marker[dof] = 1;
+    }
+  }
+
+  // Refresh the dense bc value cache if the data of g has changed
+  // since it was last built
+  void update_value_cache() const
+  {
+    assert(_g);
+    if (_g->version() == _value_version)
+      return;
+    xtl::span<const T> g = _g->x()->array();
+    _value_cache.assign(_marker.size(), 0.0);
+    for (std::size_t i = 0; i < _dofs0.size(); ++i)
+    {
+      assert(_dofs1_g[i] < (std::int32_t)g.size());
+      _value_cache[_dofs0[i]] = g[_dofs1_g[i]];
+    }
+    _value_version = _g->version();
+  }
+
   // The function space (possibly a sub function space)
   std::shared_ptr<const fem::FunctionSpace> _function_space;
 
@@ -331,5 +422,18 @@ private:
   // The first _owned_indices in _dofs are owned by this process
   int _owned_indices0 = -1;
   int _owned_indices1 = -1;
+
+  // Dense dof marker over the owned+ghost range (unrolled indices)
+  std::vector<std::int8_t> _marker;
+
+  // Cells with at least one constrained dof, built lazily (see
+  // constrained_cells)
+  mutable std::vector<std::int32_t> _constrained_cells;
+  mutable bool _cells_built = false;
+
+  // Dense bc values over the owned+ghost range, rebuilt lazily when
+  // the data version of _g changes
+  mutable std::vector<T> _value_cache;
+  mutable std::size_t _value_version = std::numeric_limits<std::size_t>::max();
 };
 } // namespace dolfinx::fem
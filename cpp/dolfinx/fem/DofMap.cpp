@@ -12,9 +12,11 @@
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/sort.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Topology.h>
 #include <memory>
+#include <thread>
 #include <utility>
 
 using namespace dolfinx;
@@ -23,6 +25,32 @@ using namespace dolfinx::fem;
 namespace
 {
 //-----------------------------------------------------------------------------
+
+/// Execute f(begin, end) over the index range [0, n), splitting the
+/// range across common::num_threads() threads. Writes from different
+/// sub-ranges must not overlap.
+template <typename Fn>
+void parallel_for_ranges(std::size_t n, Fn&& f)
+{
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads <= 1)
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    const std::size_t begin = (n * t) / num_threads;
+    const std::size_t end = (n * (t + 1)) / num_threads;
+    if (begin != end)
+      threads.emplace_back(f, begin, end);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+}
+//-----------------------------------------------------------------------------
 template <typename T>
 std::vector<std::int32_t>
 remap_dofs(const std::vector<std::int32_t>& old_to_new,
@@ -30,8 +58,12 @@ remap_dofs(const std::vector<std::int32_t>& old_to_new,
 {
   const std::vector<T>& _dofs_old = dofs_old.array();
   std::vector<std::int32_t> dofmap(_dofs_old.size());
-  for (std::size_t i = 0; i < dofmap.size(); ++i)
-    dofmap[i] = old_to_new[_dofs_old[i]];
+  parallel_for_ranges(dofmap.size(),
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t i = begin; i < end; ++i)
+                          dofmap[i] = old_to_new[_dofs_old[i]];
+                      });
   return dofmap;
 }
 //-----------------------------------------------------------------------------
@@ -111,12 +143,23 @@ fem::DofMap build_collapsed_dofmap(MPI_Comm comm, const DofMap& dofmap_view,
     ghost_owners[index] = ghost_owner_old[index_old];
   }
 
+  // The ranks that ghost indices owned by this rank in the collapsed
+  // map are a subset of the destination ranks of the parent map, so
+  // the parent neighbourhood is reused rather than re-deriving the
+  // graph edges with a collective exchange. Edges with nothing to
+  // communicate are harmless.
+  MPI_Comm comm_fwd
+      = dofmap_view.index_map->comm(common::IndexMap::Direction::forward);
+  int num_src(0), num_dest(0), weighted(0);
+  MPI_Dist_graph_neighbors_count(comm_fwd, &num_src, &num_dest, &weighted);
+  std::vector<int> src_ranks(num_src), dest_ranks(num_dest);
+  MPI_Dist_graph_neighbors(comm_fwd, num_src, src_ranks.data(), MPI_UNWEIGHTED,
+                           num_dest, dest_ranks.data(), MPI_UNWEIGHTED);
+
   // Create new index map
-  auto index_map = std::make_shared<common::IndexMap>(
-      comm, num_owned,
-      dolfinx::MPI::compute_graph_edges(
-          comm, std::set<int>(ghost_owners.begin(), ghost_owners.end())),
-      ghosts, ghost_owners);
+  auto index_map = std::make_shared<common::IndexMap>(comm, num_owned,
+                                                      dest_ranks, ghosts,
+                                                      ghost_owners);
 
   // Create array from dofs in view to new dof indices
   std::vector<std::int32_t> old_to_new(dofs_view.back() + 1, -1);
@@ -215,16 +258,21 @@ DofMap DofMap::extract_sub_dofmap(const std::vector<int>& component) const
   const std::int32_t dofs_per_cell = sub_element_map_view.size();
   std::vector<std::int32_t> dofmap(num_cells * dofs_per_cell);
   const int bs_parent = this->bs();
-  for (int c = 0; c < num_cells; ++c)
-  {
-    auto cell_dmap_parent = this->_dofmap.links(c);
-    for (std::int32_t i = 0; i < dofs_per_cell; ++i)
-    {
-      const std::div_t pos = std::div(sub_element_map_view[i], bs_parent);
-      dofmap[c * dofs_per_cell + i]
-          = bs_parent * cell_dmap_parent[pos.quot] + pos.rem;
-    }
-  }
+  parallel_for_ranges(
+      num_cells,
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t c = begin; c < end; ++c)
+        {
+          auto cell_dmap_parent = this->_dofmap.links(c);
+          for (std::int32_t i = 0; i < dofs_per_cell; ++i)
+          {
+            const std::div_t pos = std::div(sub_element_map_view[i], bs_parent);
+            dofmap[c * dofs_per_cell + i]
+                = bs_parent * cell_dmap_parent[pos.quot] + pos.rem;
+          }
+        }
+      });
 
   // FIXME X
   return DofMap(sub_element_dof_layout, this->index_map, this->index_map_bs(),
@@ -303,5 +351,10 @@ const graph::AdjacencyList<std::int32_t>& DofMap::list() const
   return _dofmap;
 }
 //-----------------------------------------------------------------------------
+graph::FixedDegreeAdjacencyList<std::int32_t> DofMap::list_fixed() const
+{
+  return graph::FixedDegreeAdjacencyList<std::int32_t>(_dofmap);
+}
+//-----------------------------------------------------------------------------
 int DofMap::index_map_bs() const { return _index_map_bs; }
 //-----------------------------------------------------------------------------
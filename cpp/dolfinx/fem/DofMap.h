@@ -145,6 +145,12 @@ public:
   /// @return The adjacency list with dof indices for each cell
   const graph::AdjacencyList<std::int32_t>& list() const;
 
+  /// Get dofmap data as a constant-stride view. The number of dofs per
+  /// cell is the same for every cell, so the offsets can be computed
+  /// rather than loaded (see graph::FixedDegreeAdjacencyList). The
+  /// view is valid for the lifetime of this DofMap.
+  graph::FixedDegreeAdjacencyList<std::int32_t> list_fixed() const;
+
   /// Layout of dofs on an element
   std::shared_ptr<const ElementDofLayout> element_dof_layout;
 
@@ -8,7 +8,9 @@
 
 #include <dolfinx/mesh/Mesh.h>
 #include "Function.h"
+#include <dolfinx/common/utils.h>
 #include <functional>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <xtensor/xarray.hpp>
@@ -84,6 +86,12 @@ public:
   }
 
   /// Evaluate the expression on cells
+  ///
+  /// The cell list is processed in contiguous blocks. Coefficients are
+  /// packed once for all cells and each block carries its own geometry
+  /// and kernel scratch, so blocks are evaluated on
+  /// common::num_threads() threads when more than one is requested.
+  /// Each block writes a disjoint slice of rows of @p values.
   /// @param[in] active_cells Cells on which to evaluate the Expression
   /// @param[out] values A 2D array to store the result. Caller
   /// responsible for correct sizing which should be (num_cells,
@@ -111,30 +119,48 @@ public:
     const std::size_t num_dofs_g = x_dofmap.num_links(0);
     const xt::xtensor<double, 2>& x_g = _mesh->geometry().x();
 
-    // Create data structures used in evaluation
-    std::vector<double> coordinate_dofs(3 * num_dofs_g);
-
-    // Iterate over cells and 'assemble' into values
-    std::vector<T> values_e(this->num_points() * this->value_size(), 0);
-    for (std::size_t c = 0; c < active_cells.size(); ++c)
+    // Evaluate a block of cells with block-local scratch
+    auto eval_block = [&](std::size_t begin, std::size_t end)
     {
-      const std::int32_t cell = active_cells[c];
-
-      auto x_dofs = x_dofmap.links(cell);
-      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      std::vector<double> coordinate_dofs(3 * num_dofs_g);
+      std::vector<T> values_e(this->num_points() * this->value_size(), 0);
+      for (std::size_t c = begin; c < end; ++c)
       {
-        std::copy_n(xt::row(x_g, x_dofs[i]).cbegin(), 3,
-                    std::next(coordinate_dofs.begin(), 3 * i));
+        const std::int32_t cell = active_cells[c];
+
+        auto x_dofs = x_dofmap.links(cell);
+        for (std::size_t i = 0; i < x_dofs.size(); ++i)
+        {
+          std::copy_n(xt::row(x_g, x_dofs[i]).cbegin(), 3,
+                      std::next(coordinate_dofs.begin(), 3 * i));
+        }
+
+        const T* coeff_cell = coeffs.data() + c * cstride;
+        std::fill(values_e.begin(), values_e.end(), 0.0);
+        fn(values_e.data(), coeff_cell, constant_data.data(),
+           coordinate_dofs.data());
+
+        for (std::size_t j = 0; j < values_e.size(); ++j)
+          values(c, j) = values_e[j];
       }
+    };
 
-      const T* coeff_cell = coeffs.data() + c * cstride;
-      std::fill(values_e.begin(), values_e.end(), 0.0);
-      fn(values_e.data(), coeff_cell, constant_data.data(),
-         coordinate_dofs.data());
-
-      for (std::size_t j = 0; j < values_e.size(); ++j)
-        values(c, j) = values_e[j];
+    const int num_threads = dolfinx::common::num_threads();
+    if (num_threads > 1)
+    {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < num_threads; ++t)
+      {
+        const std::size_t begin = (active_cells.size() * t) / num_threads;
+        const std::size_t end = (active_cells.size() * (t + 1)) / num_threads;
+        if (begin != end)
+          threads.emplace_back(eval_block, begin, end);
+      }
+      for (std::thread& thread : threads)
+        thread.join();
     }
+    else
+      eval_block(0, active_cells.size());
   }
 
   /// Get function for tabulate_expression.
@@ -6,12 +6,15 @@
 
 #pragma once
 
+#include "Constant.h"
 #include "FunctionSpace.h"
 #include <algorithm>
 #include <array>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/MeshTags.h>
+#include <dolfinx/mesh/cell_types.h>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -34,6 +37,22 @@ enum class IntegralType : std::int8_t
   vertex = 3
 };
 
+/// Precomputed assembly data for one interior facet: the two attached
+/// cells, the local index of the facet in each cell, and the facet
+/// permutation for each cell. The local facet and permutation pairs are
+/// stored contiguously so they can be passed to integration kernels
+/// without repacking.
+struct InteriorFacetData
+{
+  /// The cells attached to the facet
+  std::array<std::int32_t, 2> cells;
+  /// Local index of the facet in each attached cell
+  std::array<int, 2> local_facet;
+  /// Facet permutation for each attached cell (zero when the form does
+  /// not need facet permutations)
+  std::array<std::uint8_t, 2> perm;
+};
+
 /// Class for variational forms
 ///
 /// A note on the order of trial and test spaces: FEniCS numbers
@@ -299,6 +318,100 @@ public:
     return it->second.second;
   }
 
+  /// Set the list of cell indices for the ith integral (kernel) for
+  /// the cell domain type. Accepts pre-built (possibly shared) lists,
+  /// e.g. from fem::cell_integration_entities, so the MeshTags scan is
+  /// not repeated for every form on a mesh.
+  /// @param[in] i Integral ID, i.e. (sub)domain index
+  /// @param[in] cells List of active cell entities for the integral
+  void set_domains(int i, const std::vector<std::int32_t>& cells)
+  {
+    auto it = _cell_integrals.find(i);
+    if (it == _cell_integrals.end())
+      throw std::runtime_error("No kernel for requested domain index.");
+    it->second.second = cells;
+  }
+
+  /// Set the list of (cell_index, local_facet_index) pairs for the ith
+  /// integral (kernel) for the exterior facet domain type. Accepts
+  /// pre-built (possibly shared) lists, e.g. from
+  /// fem::exterior_facet_integration_entities.
+  /// @param[in] i Integral ID, i.e. (sub)domain index
+  /// @param[in] facets List of (cell_index, local_facet_index) pairs
+  void set_domains(int i,
+                   const std::vector<std::pair<std::int32_t, int>>& facets)
+  {
+    auto it = _exterior_facet_integrals.find(i);
+    if (it == _exterior_facet_integrals.end())
+      throw std::runtime_error("No kernel for requested domain index.");
+    it->second.second = facets;
+  }
+
+  /// Set the list of (cell_index_0, local_facet_index_0, cell_index_1,
+  /// local_facet_index_1) tuples for the ith integral (kernel) for the
+  /// interior facet domain type. Accepts pre-built (possibly shared)
+  /// lists, e.g. from fem::interior_facet_integration_entities. Any
+  /// cached assembly data for the integral is discarded.
+  /// @param[in] i Integral ID, i.e. (sub)domain index
+  /// @param[in] facets List of (cell_index_0, local_facet_index_0,
+  /// cell_index_1, local_facet_index_1) tuples
+  void set_domains(
+      int i,
+      const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
+          facets)
+  {
+    auto it = _interior_facet_integrals.find(i);
+    if (it == _interior_facet_integrals.end())
+      throw std::runtime_error("No kernel for requested domain index.");
+    it->second.second = facets;
+    _interior_facet_data.erase(i);
+  }
+
+  /// Get the precomputed assembly data for the ith integral (kernel)
+  /// for the interior facet domain type. The attached cells, local
+  /// facet indices and facet permutations of each facet are flattened
+  /// into one array so the assembly loop is a pure streaming pass, with
+  /// no topology lookups. Built on first call and cached on the Form.
+  /// @param[in] i Integral ID, i.e. (sub)domain index
+  /// @return Assembly data for each facet of the integral domain
+  const std::vector<InteriorFacetData>&
+  interior_facet_assembly_data(int i) const
+  {
+    if (auto it = _interior_facet_data.find(i);
+        it != _interior_facet_data.end())
+    {
+      return it->second;
+    }
+
+    const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
+        facets
+        = interior_facet_domains(i);
+    std::vector<InteriorFacetData>& data = _interior_facet_data[i];
+    data.reserve(facets.size());
+    if (_needs_facet_permutations)
+    {
+      _mesh->topology_mutable().create_entity_permutations();
+      const std::vector<std::uint8_t>& perms
+          = _mesh->topology().get_facet_permutations();
+      const int num_cell_facets = mesh::cell_num_entities(
+          _mesh->topology().cell_type(), _mesh->topology().dim() - 1);
+      for (const auto& [c0, lf0, c1, lf1] : facets)
+      {
+        data.push_back({{c0, c1},
+                        {lf0, lf1},
+                        {perms[c0 * num_cell_facets + lf0],
+                         perms[c1 * num_cell_facets + lf1]}});
+      }
+    }
+    else
+    {
+      for (const auto& [c0, lf0, c1, lf1] : facets)
+        data.push_back({{c0, c1}, {lf0, lf1}, {0, 0}});
+    }
+
+    return data;
+  }
+
   /// Access coefficients
   const std::vector<std::shared_ptr<const fem::Function<T>>>
   coefficients() const
@@ -332,6 +445,41 @@ public:
     return _constants;
   }
 
+  /// Constants packed for assembly (see fem::pack_constants). The
+  /// flattened array is cached on the Form and repacked only when a
+  /// constant reports a new version (see Constant::version), so
+  /// repeated assemblies with unchanged constants do not repack.
+  const std::vector<T>& packed_constants() const
+  {
+    std::vector<std::size_t> versions;
+    versions.reserve(_constants.size());
+    for (const auto& constant : _constants)
+    {
+      if (!constant)
+        throw std::runtime_error("Not all form constants have been set.");
+      versions.push_back(constant->version());
+    }
+
+    if (versions != _packed_constants_versions)
+    {
+      std::int32_t size = 0;
+      for (const auto& constant : _constants)
+        size += constant->value.size();
+      _packed_constants.resize(size);
+      std::int32_t offset = 0;
+      for (const auto& constant : _constants)
+      {
+        const std::vector<T>& value = constant->value;
+        std::copy(value.cbegin(), value.cend(),
+                  std::next(_packed_constants.begin(), offset));
+        offset += value.size();
+      }
+      _packed_constants_versions = std::move(versions);
+    }
+
+    return _packed_constants;
+  }
+
   /// Scalar type (T)
   using scalar_type = T;
 
@@ -574,29 +722,15 @@ private:
         auto c_to_f = mesh.topology().connectivity(tdim, tdim - 1);
         assert(c_to_f);
 
-        // Only need to consider shared facets when there are no ghost
-        // cells
-        std::set<std::int32_t> fwd_shared_facets;
-        assert(topology.index_map(tdim - 1));
-        if (topology.index_map(tdim)->num_ghosts() == 0)
+        // Get the exterior facets (computed once and cached on the
+        // topology)
+        for (std::int32_t f : mesh.topology_mutable().exterior_facets())
         {
-          const std::vector<std::int32_t>& fwd_indices
-              = topology.index_map(tdim - 1)->scatter_fwd_indices().array();
-          fwd_shared_facets.insert(fwd_indices.begin(), fwd_indices.end());
-        }
-
-        const int num_facets = topology.index_map(tdim - 1)->size_local();
-        for (int f = 0; f < num_facets; ++f)
-        {
-          if (f_to_c->num_links(f) == 1
-              and fwd_shared_facets.find(f) == fwd_shared_facets.end())
-          {
-            // There will only be one pair for an exterior facet
-            // integral
-            std::pair<std::int32_t, int> pair = get_cell_local_facet_pairs<1>(
-                f, f_to_c->links(f), *c_to_f)[0];
-            active_facets.push_back(pair);
-          }
+          // There will only be one pair for an exterior facet
+          // integral
+          std::pair<std::int32_t, int> pair = get_cell_local_facet_pairs<1>(
+              f, f_to_c->links(f), *c_to_f)[0];
+          active_facets.push_back(pair);
         }
       }
     }
@@ -646,6 +780,15 @@ private:
   // Constants associated with the Form
   std::vector<std::shared_ptr<const fem::Constant<T>>> _constants;
 
+  // Cached packed constants and the versions of the constants they
+  // were packed from (see packed_constants())
+  mutable std::vector<T> _packed_constants;
+  mutable std::vector<std::size_t> _packed_constants_versions;
+
+  // Cached flattened interior facet assembly data per integral ID (see
+  // interior_facet_assembly_data())
+  mutable std::map<int, std::vector<InteriorFacetData>> _interior_facet_data;
+
   // The mesh
   std::shared_ptr<const mesh::Mesh> _mesh;
 
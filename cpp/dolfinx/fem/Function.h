@@ -12,6 +12,7 @@
 #include "interpolate.h"
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/UniqueIdGenerator.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/la/PETScVector.h>
 #include <dolfinx/la/Vector.h>
 #include <dolfinx/mesh/Geometry.h>
@@ -22,6 +23,7 @@
 #include <numeric>
 #include <petscvec.h>
 #include <string>
+#include <thread>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -114,7 +116,11 @@ public:
   // Assignment
   Function& operator=(const Function& v) = delete;
 
-  /// Extract subfunction (view into the Function)
+  /// Extract subfunction (view into the Function). No dof data is
+  /// copied: the subfunction shares the parent vector and indexes into
+  /// it through the sub-dofmap, so it can be passed directly to eval,
+  /// interpolation and the io writers. Use collapse() only when a
+  /// stand-alone copy of the dof data is required.
   /// @param[in] i Index of subfunction
   /// @return The subfunction
   Function sub(int i) const
@@ -125,7 +131,9 @@ public:
   }
 
   /// Collapse a subfunction (view into the Function) to a stand-alone
-  /// Function
+  /// Function. This copies the dof data; the collapsed dofmap is cached
+  /// on the function space, so repeated collapses only pay for the
+  /// copy.
   /// @return New collapsed Function
   Function collapse() const
   {
@@ -197,17 +205,34 @@ public:
   std::shared_ptr<const la::Vector<T>> x() const { return _x; }
 
   /// Underlying vector
-  std::shared_ptr<la::Vector<T>> x() { return _x; }
+  /// @note Non-const access bumps the version counter, see version()
+  std::shared_ptr<la::Vector<T>> x()
+  {
+    ++_version;
+    return _x;
+  }
+
+  /// Version counter for the function data. The counter is incremented
+  /// whenever the degree-of-freedom vector may have been modified
+  /// (non-const access to the vector, interpolation, or a write to the
+  /// underlying la::Vector, see la::Vector::version), and can be used
+  /// to invalidate caches of derived data, e.g. packed coefficients.
+  std::size_t version() const noexcept { return _version + _x->version(); }
 
   /// Interpolate a Function (on possibly non-matching meshes)
   /// @param[in] v The function to be interpolated.
-  void interpolate(const Function<T>& v) { fem::interpolate(*this, v); }
+  void interpolate(const Function<T>& v)
+  {
+    ++_version;
+    fem::interpolate(*this, v);
+  }
 
   /// Interpolate an expression
   /// @param[in] f The expression to be interpolated
   void interpolate(
       const std::function<xt::xarray<T>(const xt::xtensor<double, 2>&)>& f)
   {
+    ++_version;
     assert(_function_space);
     assert(_function_space->element());
     assert(_function_space->mesh());
@@ -226,6 +251,13 @@ public:
 
   /// Evaluate the Function at points
   ///
+  /// The points are grouped by containing cell, so that the geometry
+  /// pull-back, basis tabulation and dof gather are performed once per
+  /// cell for all of its points; clustered point sets (e.g. probe
+  /// lines) are therefore much cheaper than scattered ones. Cell
+  /// groups are processed in parallel when `DOLFINX_NUM_THREADS` is
+  /// set.
+  ///
   /// @param[in] x The coordinates of the points. It has shape
   /// (num_points, 3).
   /// @param[in] cells An array of cell indices. cells[i] is the index
@@ -238,9 +270,6 @@ public:
             const xtl::span<const std::int32_t>& cells,
             xt::xtensor<T, 2>& u) const
   {
-    // TODO: This could be easily made more efficient by exploiting points
-    // being ordered by the cell to which they belong.
-
     if (x.shape(0) != cells.size())
     {
       throw std::runtime_error(
@@ -291,17 +320,6 @@ public:
                                "elements. Extract subspaces.");
     }
 
-    // Prepare basis function data structures
-    xt::xtensor<double, 4> basis_derivatives_reference_values(
-        {1, 1, space_dimension, reference_value_size});
-    auto basis_reference_values = xt::view(basis_derivatives_reference_values,
-                                           0, xt::all(), xt::all(), xt::all());
-    xt::xtensor<double, 3> basis_values(
-        {static_cast<std::size_t>(1), space_dimension, value_size});
-
-    // Create work vector for expansion coefficients
-    std::vector<T> coefficients(space_dimension * bs_element);
-
     // Get dofmap
     std::shared_ptr<const fem::DofMap> dofmap = _function_space->dofmap();
     assert(dofmap);
@@ -314,13 +332,8 @@ public:
       cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
     }
 
-    xt::xtensor<double, 2> coordinate_dofs
-        = xt::zeros<double>({num_dofs_g, gdim});
-    xt::xtensor<double, 2> xp = xt::zeros<double>({std::size_t(1), gdim});
-
-    // Loop over points
     std::fill(u.data(), u.data() + u.size(), 0.0);
-    const xtl::span<const T>& _v = _x->array();
+    const xtl::span<const T> _v = _x->array();
 
     const std::function<void(const xtl::span<double>&,
                              const xtl::span<const std::uint32_t>&,
@@ -328,120 +341,208 @@ public:
         apply_dof_transformation
         = element->get_dof_transformation_function<double>();
 
-    // -- Lambda function for affine pull-backs
-    auto pull_back_affine =
-        [&cmap, tdim,
-         X0 = xt::xtensor<double, 2>(xt::zeros<double>({std::size_t(1), tdim})),
-         data = xt::xtensor<double, 4>(cmap.tabulate_shape(1, 1)),
-         dphi = xt::xtensor<double, 2>({tdim, cmap.tabulate_shape(1, 1)[2]})](
-            auto&& X, const auto& cell_geometry, auto&& J, auto&& K,
-            const auto& x) mutable
-    {
-      cmap.tabulate(1, X0, data);
-      dphi = xt::view(data, xt::range(1, tdim + 1), 0, xt::all(), 0);
-      cmap.compute_jacobian(dphi, cell_geometry, J);
-      cmap.compute_jacobian_inverse(J, K);
-      cmap.pull_back_affine(X, K, cmap.x0(cell_geometry), x);
-    };
-
-    xt::xtensor<double, 2> dphi;
-    xt::xtensor<double, 2> X({1, tdim});
-    xt::xtensor<double, 3> J = xt::zeros<double>({std::size_t(1), gdim, tdim});
-    xt::xtensor<double, 3> K = xt::zeros<double>({std::size_t(1), tdim, gdim});
-    xt::xtensor<double, 1> detJ = xt::zeros<double>({1});
-    xt::xtensor<double, 4> phi(cmap.tabulate_shape(1, 1));
-    using u_t = xt::xview<decltype(basis_values)&, std::size_t,
-                          xt::xall<std::size_t>, xt::xall<std::size_t>>;
-    using U_t = xt::xview<decltype(basis_reference_values)&, std::size_t,
-                          xt::xall<std::size_t>, xt::xall<std::size_t>>;
-    using J_t = xt::xview<decltype(J)&, std::size_t, xt::xall<std::size_t>,
-                          xt::xall<std::size_t>>;
-    using K_t = xt::xview<decltype(K)&, std::size_t, xt::xall<std::size_t>,
-                          xt::xall<std::size_t>>;
-    auto push_forward_fn = element->map_fn<u_t, U_t, J_t, K_t>();
+    // Group the points by containing cell, so that the geometry
+    // pull-back, basis tabulation and dof gather are performed once
+    // per cell for all of its points
+    const std::int32_t num_cells = map->size_local() + map->num_ghosts();
+    std::vector<std::int32_t> offsets(num_cells + 1, 0);
     for (std::size_t p = 0; p < cells.size(); ++p)
+      if (cells[p] >= 0)
+        offsets[cells[p] + 1] += 1;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<std::int32_t> point_order(offsets.back());
     {
-      const int cell_index = cells[p];
-
-      // Skip negative cell indices
-      if (cell_index < 0)
-        continue;
-
-      // Get cell geometry (coordinate dofs)
-      auto x_dofs = x_dofmap.links(cell_index);
-      for (std::size_t i = 0; i < num_dofs_g; ++i)
-        for (std::size_t j = 0; j < gdim; ++j)
-          coordinate_dofs(i, j) = x_g(x_dofs[i], j);
-
-      for (std::size_t j = 0; j < gdim; ++j)
-        xp(0, j) = x(p, j);
-
-      // Compute reference coordinates X, and J, detJ and K
-      if (cmap.is_affine())
-      {
-        J.fill(0);
-        pull_back_affine(X, coordinate_dofs,
-                         xt::view(J, 0, xt::all(), xt::all()),
-                         xt::view(K, 0, xt::all(), xt::all()), xp);
-        detJ[0] = cmap.compute_jacobian_determinant(
-            xt::view(J, 0, xt::all(), xt::all()));
-      }
-      else
+      std::vector<std::int32_t> pos(offsets.begin(), std::prev(offsets.end()));
+      for (std::size_t p = 0; p < cells.size(); ++p)
+        if (cells[p] >= 0)
+          point_order[pos[cells[p]]++] = p;
+    }
+    std::vector<std::int32_t> cell_list;
+    for (std::int32_t c = 0; c < num_cells; ++c)
+      if (offsets[c + 1] > offsets[c])
+        cell_list.push_back(c);
+
+    // Per-cell affine flags (empty unless
+    // Geometry::classify_affine_cells has been run). Exactly affine
+    // cells of a higher-degree geometry take the constant-Jacobian
+    // path below.
+    const std::vector<std::uint8_t>& affine_cell
+        = mesh->geometry().cell_is_affine();
+
+    // Evaluate the points of the cells cell_list[begin:end]. Each
+    // point writes its own row of u, so cell ranges can be processed
+    // concurrently.
+    const auto eval_cells = [&](std::size_t begin, std::size_t end)
+    {
+      // Scratch data (per thread). The tensors whose shape depends on
+      // the number of points in a cell are resized per cell group.
+      xt::xtensor<double, 2> coordinate_dofs
+          = xt::zeros<double>({num_dofs_g, gdim});
+      std::vector<T> coefficients(space_dimension * bs_element);
+      xt::xtensor<double, 2> xp({0, gdim}), X({0, tdim}), dphi;
+      xt::xtensor<double, 3> J, K;
+      xt::xtensor<double, 1> detJ;
+      xt::xtensor<double, 4> phi, basis_reference_values(
+                                      {1, 0, space_dimension,
+                                       reference_value_size});
+      xt::xtensor<double, 3> basis_values(
+          {std::size_t(0), space_dimension, value_size});
+
+      using u_t = xt::xview<decltype(basis_values)&, std::size_t,
+                            xt::xall<std::size_t>, xt::xall<std::size_t>>;
+      using U_t = xt::xview<decltype(basis_reference_values)&, std::size_t,
+                            std::size_t, xt::xall<std::size_t>,
+                            xt::xall<std::size_t>>;
+      using J_t = xt::xview<decltype(J)&, std::size_t, xt::xall<std::size_t>,
+                            xt::xall<std::size_t>>;
+      using K_t = xt::xview<decltype(K)&, std::size_t, xt::xall<std::size_t>,
+                            xt::xall<std::size_t>>;
+      auto push_forward_fn = element->map_fn<u_t, U_t, J_t, K_t>();
+
+      for (std::size_t index = begin; index < end; ++index)
       {
-        cmap.pull_back_nonaffine(X, xp, coordinate_dofs);
-        cmap.tabulate(1, X, phi);
-        dphi = xt::view(phi, xt::range(1, tdim + 1), 0, xt::all(), 0);
+        const std::int32_t cell_index = cell_list[index];
+        const std::int32_t p0 = offsets[cell_index];
+        const std::size_t np = offsets[cell_index + 1] - p0;
+
+        // Get cell geometry (coordinate dofs)
+        auto x_dofs = x_dofmap.links(cell_index);
+        for (std::size_t i = 0; i < num_dofs_g; ++i)
+          for (std::size_t j = 0; j < gdim; ++j)
+            coordinate_dofs(i, j) = x_g(x_dofs[i], j);
+
+        // Gather the physical coordinates of the points in the cell
+        xp.resize({np, gdim});
+        for (std::size_t i = 0; i < np; ++i)
+          for (std::size_t j = 0; j < gdim; ++j)
+            xp(i, j) = x(point_order[p0 + i], j);
+
+        // Compute reference coordinates X, and J, detJ and K for all
+        // points of the cell
+        X.resize({np, tdim});
+        J.resize({np, gdim, tdim});
+        K.resize({np, tdim, gdim});
+        detJ.resize({np});
         J.fill(0);
-        auto _J = xt::view(J, 0, xt::all(), xt::all());
-        cmap.compute_jacobian(dphi, coordinate_dofs, _J);
-        cmap.compute_jacobian_inverse(_J, xt::view(K, 0, xt::all(), xt::all()));
-        detJ[0] = cmap.compute_jacobian_determinant(_J);
-      }
-
-      // Compute basis on reference element
-      element->tabulate(basis_derivatives_reference_values, X, 0);
-
-      // Permute the reference values to account for the cell's orientation
-      apply_dof_transformation(xtl::span(basis_reference_values.data(),
-                                         basis_reference_values.size()),
-                               cell_info, cell_index, reference_value_size);
+        const bool cell_affine
+            = cmap.is_affine()
+              or (!affine_cell.empty() and affine_cell[cell_index]);
+        if (cell_affine)
+        {
+          // One pull-back for the whole cell: the Jacobian is constant
+          // and comes from the derivative table cached by the
+          // CoordinateElement, with no basis tabulation per point
+          auto J0 = xt::view(J, 0, xt::all(), xt::all());
+          auto K0 = xt::view(K, 0, xt::all(), xt::all());
+          cmap.compute_jacobian(cmap.dphi0(), coordinate_dofs, J0);
+          cmap.compute_jacobian_inverse(J0, K0);
+          cmap.pull_back_affine(X, K0, cmap.x0(coordinate_dofs), xp);
+          detJ[0] = cmap.compute_jacobian_determinant(J0);
+          for (std::size_t i = 1; i < np; ++i)
+          {
+            xt::view(J, i, xt::all(), xt::all()) = J0;
+            xt::view(K, i, xt::all(), xt::all()) = K0;
+            detJ[i] = detJ[0];
+          }
+        }
+        else
+        {
+          cmap.pull_back_nonaffine(X, xp, coordinate_dofs);
+          phi.resize(cmap.tabulate_shape(1, np));
+          cmap.tabulate(1, X, phi);
+          for (std::size_t i = 0; i < np; ++i)
+          {
+            dphi = xt::view(phi, xt::range(1, tdim + 1), i, xt::all(), 0);
+            auto _J = xt::view(J, i, xt::all(), xt::all());
+            cmap.compute_jacobian(dphi, coordinate_dofs, _J);
+            cmap.compute_jacobian_inverse(
+                _J, xt::view(K, i, xt::all(), xt::all()));
+            detJ[i] = cmap.compute_jacobian_determinant(_J);
+          }
+        }
 
-      // Push basis forward to physical element
-      for (std::size_t i = 0; i < basis_values.shape(0); ++i)
-      {
-        auto _K = xt::view(K, i, xt::all(), xt::all());
-        auto _J = xt::view(J, i, xt::all(), xt::all());
-        auto _u = xt::view(basis_values, i, xt::all(), xt::all());
-        auto _U = xt::view(basis_reference_values, i, xt::all(), xt::all());
-        push_forward_fn(_u, _U, _J, detJ[i], _K);
-      }
+        // Compute basis on reference element, one tabulation for all
+        // points of the cell
+        basis_reference_values.resize(
+            {1, np, space_dimension, reference_value_size});
+        element->tabulate(basis_reference_values, X, 0);
+
+        // Permute the reference values to account for the cell's
+        // orientation
+        const std::size_t value_stride
+            = space_dimension * reference_value_size;
+        for (std::size_t i = 0; i < np; ++i)
+        {
+          apply_dof_transformation(
+              xtl::span(basis_reference_values.data() + i * value_stride,
+                        value_stride),
+              cell_info, cell_index, reference_value_size);
+        }
 
-      // element->push_forward(basis_values, basis_reference_values, J, detJ,
-      // K);
+        // Push basis forward to physical element
+        basis_values.resize({np, space_dimension, value_size});
+        for (std::size_t i = 0; i < np; ++i)
+        {
+          auto _K = xt::view(K, i, xt::all(), xt::all());
+          auto _J = xt::view(J, i, xt::all(), xt::all());
+          auto _u = xt::view(basis_values, i, xt::all(), xt::all());
+          auto _U = xt::view(basis_reference_values, 0, i, xt::all(),
+                             xt::all());
+          push_forward_fn(_u, _U, _J, detJ[i], _K);
+        }
 
-      // Get degrees of freedom for current cell
-      xtl::span<const std::int32_t> dofs = dofmap->cell_dofs(cell_index);
-      for (std::size_t i = 0; i < dofs.size(); ++i)
-        for (int k = 0; k < bs_dof; ++k)
-          coefficients[bs_dof * i + k] = _v[bs_dof * dofs[i] + k];
+        // Get degrees of freedom for current cell
+        xtl::span<const std::int32_t> dofs = dofmap->cell_dofs(cell_index);
+        for (std::size_t i = 0; i < dofs.size(); ++i)
+          for (int k = 0; k < bs_dof; ++k)
+            coefficients[bs_dof * i + k] = _v[bs_dof * dofs[i] + k];
 
-      // Compute expansion
-      auto u_row = xt::row(u, p);
-      for (int k = 0; k < bs_element; ++k)
-      {
-        for (std::size_t i = 0; i < space_dimension; ++i)
+        // Compute expansion for each point of the cell
+        for (std::size_t i = 0; i < np; ++i)
         {
-          for (std::size_t j = 0; j < value_size; ++j)
+          auto u_row = xt::row(u, point_order[p0 + i]);
+          for (int k = 0; k < bs_element; ++k)
           {
-            u_row[j * bs_element + k]
-                += coefficients[bs_element * i + k] * basis_values(0, i, j);
+            for (std::size_t b = 0; b < space_dimension; ++b)
+            {
+              for (std::size_t j = 0; j < value_size; ++j)
+              {
+                u_row[j * bs_element + k] += coefficients[bs_element * b + k]
+                                             * basis_values(i, b, j);
+              }
+            }
           }
         }
       }
+    };
+
+    // Thread over cell groups
+    const int num_threads = common::num_threads();
+    const std::size_t n = cell_list.size();
+    if (num_threads <= 1 or n < 64)
+      eval_cells(0, n);
+    else
+    {
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (int t = 0; t < num_threads; ++t)
+      {
+        threads.emplace_back(eval_cells, (n * t) / num_threads,
+                             (n * (t + 1)) / num_threads);
+      }
+      for (std::thread& t : threads)
+        t.join();
     }
   }
 
   /// Compute values at all mesh 'nodes'
+  ///
+  /// The geometry points of every cell are the push-forward of the
+  /// coordinate element's interpolation points, so the basis functions
+  /// are tabulated at these reference points once and reused for all
+  /// cells, with no per-cell pull-back. Cells are processed in
+  /// parallel when `DOLFINX_NUM_THREADS` is set.
+  ///
   /// @return The values at all geometric points
   /// @warning This function will be removed soon. Use interpolation
   /// instead.
@@ -450,7 +551,8 @@ public:
     assert(_function_space);
     std::shared_ptr<const mesh::Mesh> mesh = _function_space->mesh();
     assert(mesh);
-    const int tdim = mesh->topology().dim();
+    const std::size_t gdim = mesh->geometry().dim();
+    const std::size_t tdim = mesh->topology().dim();
 
     // Compute in tensor (one for scalar function, . . .)
     const std::size_t value_size_loc = _function_space->element()->value_size();
@@ -464,11 +566,52 @@ public:
         = mesh->geometry().dofmap();
 
     // FIXME: Add proper interface for num coordinate dofs
-    const int num_dofs_g = x_dofmap.num_links(0);
+    const std::size_t num_dofs_g = x_dofmap.num_links(0);
     const xt::xtensor<double, 2>& x_g = mesh->geometry().x();
 
-    // Interpolate point values on each cell (using last computed value if
-    // not continuous, e.g. discontinuous Galerkin methods)
+    // Get coordinate map
+    const fem::CoordinateElement& cmap = mesh->geometry().cmap();
+
+    // Get element
+    assert(_function_space->element());
+    std::shared_ptr<const fem::FiniteElement> element
+        = _function_space->element();
+    assert(element);
+    const int bs_element = element->block_size();
+    const std::size_t reference_value_size
+        = element->reference_value_size() / bs_element;
+    const std::size_t value_size = element->value_size() / bs_element;
+    const std::size_t space_dimension = element->space_dimension() / bs_element;
+
+    const int num_sub_elements = element->num_sub_elements();
+    if (num_sub_elements > 1 and num_sub_elements != bs_element)
+    {
+      throw std::runtime_error("Function::compute_point_values is not "
+                               "supported for mixed elements. Extract "
+                               "subspaces.");
+    }
+
+    // Get dofmap
+    std::shared_ptr<const fem::DofMap> dofmap = _function_space->dofmap();
+    assert(dofmap);
+    const int bs_dof = dofmap->bs();
+
+    xtl::span<const std::uint32_t> cell_info;
+    if (element->needs_dof_transformations())
+    {
+      mesh->topology_mutable().create_entity_permutations();
+      cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+    }
+
+    const std::function<void(const xtl::span<double>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>
+        apply_dof_transformation
+        = element->get_dof_transformation_function<double>();
+
+    // Each point value is computed from one cell containing it (using
+    // the last cell if not continuous, e.g. discontinuous Galerkin
+    // methods)
     auto map = mesh->topology().index_map(tdim);
     assert(map);
     const std::int32_t num_cells = map->size_local() + map->num_ghosts();
@@ -478,11 +621,189 @@ public:
     {
       // Get coordinates for all points in cell
       xtl::span<const std::int32_t> dofs = x_dofmap.links(c);
-      for (int i = 0; i < num_dofs_g; ++i)
+      for (std::size_t i = 0; i < num_dofs_g; ++i)
         cells[dofs[i]] = c;
     }
 
-    eval(x_g, cells, point_values);
+    if (num_cells == 0)
+      return point_values;
+
+    const std::size_t np = num_dofs_g;
+
+    // Pull back the geometry points of one cell to obtain the
+    // reference interpolation points of the coordinate element; they
+    // are identical for every cell
+    xt::xtensor<double, 2> X({np, tdim});
+    {
+      xt::xtensor<double, 2> coordinate_dofs({num_dofs_g, gdim});
+      auto x_dofs = x_dofmap.links(0);
+      for (std::size_t i = 0; i < num_dofs_g; ++i)
+        for (std::size_t j = 0; j < gdim; ++j)
+          coordinate_dofs(i, j) = x_g(x_dofs[i], j);
+      if (cmap.is_affine())
+      {
+        xt::xtensor<double, 2> J0 = xt::zeros<double>({gdim, tdim});
+        xt::xtensor<double, 2> K0 = xt::zeros<double>({tdim, gdim});
+        cmap.compute_jacobian(cmap.dphi0(), coordinate_dofs, J0);
+        cmap.compute_jacobian_inverse(J0, K0);
+        cmap.pull_back_affine(X, K0, cmap.x0(coordinate_dofs),
+                              coordinate_dofs);
+      }
+      else
+        cmap.pull_back_nonaffine(X, coordinate_dofs, coordinate_dofs);
+    }
+
+    // Tabulate the coordinate map derivatives and the element basis at
+    // the reference points, once for all cells
+    xt::xtensor<double, 4> phi(cmap.tabulate_shape(1, np));
+    cmap.tabulate(1, X, phi);
+    xt::xtensor<double, 4> basis_reference_values(
+        {1, np, space_dimension, reference_value_size});
+    element->tabulate(basis_reference_values, X, 0);
+
+    const xtl::span<const T> _v = _x->array();
+
+    // Stream through the cells [begin, end) with preallocated scratch.
+    // Each point is written only by the cell recorded in `cells`, so
+    // cell ranges can be processed concurrently.
+    // Per-cell affine flags (empty unless
+    // Geometry::classify_affine_cells has been run). Exactly affine
+    // cells of a higher-degree geometry take the constant-Jacobian
+    // path below.
+    const std::vector<std::uint8_t>& affine_cell
+        = mesh->geometry().cell_is_affine();
+
+    const auto process_cells = [&](std::int32_t begin, std::int32_t end)
+    {
+      xt::xtensor<double, 2> coordinate_dofs({num_dofs_g, gdim});
+      std::vector<T> coefficients(space_dimension * bs_element);
+      xt::xtensor<double, 2> dphi;
+      xt::xtensor<double, 3> J = xt::zeros<double>({np, gdim, tdim});
+      xt::xtensor<double, 3> K = xt::zeros<double>({np, tdim, gdim});
+      xt::xtensor<double, 1> detJ = xt::zeros<double>({np});
+      xt::xtensor<double, 4> basis_ref = basis_reference_values;
+      xt::xtensor<double, 3> basis_values(
+          {np, space_dimension, value_size});
+
+      using u_t = xt::xview<decltype(basis_values)&, std::size_t,
+                            xt::xall<std::size_t>, xt::xall<std::size_t>>;
+      using U_t = xt::xview<decltype(basis_ref)&, std::size_t, std::size_t,
+                            xt::xall<std::size_t>, xt::xall<std::size_t>>;
+      using J_t = xt::xview<decltype(J)&, std::size_t, xt::xall<std::size_t>,
+                            xt::xall<std::size_t>>;
+      using K_t = xt::xview<decltype(K)&, std::size_t, xt::xall<std::size_t>,
+                            xt::xall<std::size_t>>;
+      auto push_forward_fn = element->map_fn<u_t, U_t, J_t, K_t>();
+
+      const std::size_t value_stride = space_dimension * reference_value_size;
+      for (std::int32_t c = begin; c < end; ++c)
+      {
+        // Get cell geometry (coordinate dofs)
+        auto x_dofs = x_dofmap.links(c);
+        for (std::size_t i = 0; i < num_dofs_g; ++i)
+          for (std::size_t j = 0; j < gdim; ++j)
+            coordinate_dofs(i, j) = x_g(x_dofs[i], j);
+
+        // Compute J, detJ and K at the reference points
+        J.fill(0);
+        const bool cell_affine
+            = cmap.is_affine()
+              or (!affine_cell.empty() and affine_cell[c]);
+        if (cell_affine)
+        {
+          auto J0 = xt::view(J, 0, xt::all(), xt::all());
+          auto K0 = xt::view(K, 0, xt::all(), xt::all());
+          cmap.compute_jacobian(cmap.dphi0(), coordinate_dofs, J0);
+          cmap.compute_jacobian_inverse(J0, K0);
+          detJ[0] = cmap.compute_jacobian_determinant(J0);
+          for (std::size_t i = 1; i < np; ++i)
+          {
+            xt::view(J, i, xt::all(), xt::all()) = J0;
+            xt::view(K, i, xt::all(), xt::all()) = K0;
+            detJ[i] = detJ[0];
+          }
+        }
+        else
+        {
+          for (std::size_t i = 0; i < np; ++i)
+          {
+            dphi = xt::view(phi, xt::range(1, tdim + 1), i, xt::all(), 0);
+            auto _J = xt::view(J, i, xt::all(), xt::all());
+            cmap.compute_jacobian(dphi, coordinate_dofs, _J);
+            cmap.compute_jacobian_inverse(
+                _J, xt::view(K, i, xt::all(), xt::all()));
+            detJ[i] = cmap.compute_jacobian_determinant(_J);
+          }
+        }
+
+        // Permute the reference values to account for the cell's
+        // orientation
+        if (!cell_info.empty())
+        {
+          basis_ref = basis_reference_values;
+          for (std::size_t i = 0; i < np; ++i)
+          {
+            apply_dof_transformation(
+                xtl::span(basis_ref.data() + i * value_stride, value_stride),
+                cell_info, c, reference_value_size);
+          }
+        }
+
+        // Get degrees of freedom for current cell
+        xtl::span<const std::int32_t> dofs = dofmap->cell_dofs(c);
+        for (std::size_t i = 0; i < dofs.size(); ++i)
+          for (int k = 0; k < bs_dof; ++k)
+            coefficients[bs_dof * i + k] = _v[bs_dof * dofs[i] + k];
+
+        for (std::size_t i = 0; i < np; ++i)
+        {
+          // Skip points owned by another cell
+          const std::int32_t p = x_dofs[i];
+          if (cells[p] != c)
+            continue;
+
+          // Push basis forward to physical element
+          auto _K = xt::view(K, i, xt::all(), xt::all());
+          auto _J = xt::view(J, i, xt::all(), xt::all());
+          auto _u = xt::view(basis_values, i, xt::all(), xt::all());
+          auto _U = xt::view(basis_ref, 0, i, xt::all(), xt::all());
+          push_forward_fn(_u, _U, _J, detJ[i], _K);
+
+          // Compute expansion, writing directly into the output row
+          auto u_row = xt::row(point_values, p);
+          std::fill(u_row.begin(), u_row.end(), 0.0);
+          for (int k = 0; k < bs_element; ++k)
+          {
+            for (std::size_t b = 0; b < space_dimension; ++b)
+            {
+              for (std::size_t j = 0; j < value_size; ++j)
+              {
+                u_row[j * bs_element + k] += coefficients[bs_element * b + k]
+                                             * basis_values(i, b, j);
+              }
+            }
+          }
+        }
+      }
+    };
+
+    // Thread over cells
+    const int num_threads = common::num_threads();
+    if (num_threads <= 1 or num_cells < 64)
+      process_cells(0, num_cells);
+    else
+    {
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (int t = 0; t < num_threads; ++t)
+      {
+        threads.emplace_back(process_cells,
+                             (std::int64_t(num_cells) * t) / num_threads,
+                             (std::int64_t(num_cells) * (t + 1)) / num_threads);
+      }
+      for (std::thread& t : threads)
+        t.join();
+    }
 
     return point_values;
   }
@@ -503,6 +824,9 @@ private:
   // The vector of expansion coefficients (local)
   std::shared_ptr<la::Vector<T>> _x;
 
+  // Version counter for the function data (see version())
+  std::size_t _version = 0;
+
   // PETSc wrapper of the expansion coefficients
   mutable Vec _petsc_vector = nullptr;
 };
@@ -8,12 +8,16 @@
 #include "CoordinateElement.h"
 #include "DofMap.h"
 #include "FiniteElement.h"
+#include <algorithm>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/UniqueIdGenerator.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <numeric>
+#include <thread>
 #include <vector>
 #include <xtensor/xadapt.hpp>
 #include <xtensor/xtensor.hpp>
@@ -49,12 +53,9 @@ FunctionSpace::sub(const std::vector<int>& component) const
   assert(_element);
   assert(_dofmap);
 
-  // Check if sub space is already in the cache and not expired
+  // Check if sub space is already in the cache
   if (auto it = _subspaces.find(component); it != _subspaces.end())
-  {
-    if (auto s = it->second.lock())
-      return s;
-  }
+    return it->second;
 
   // Extract sub-element
   std::shared_ptr<const fem::FiniteElement> element
@@ -73,8 +74,9 @@ FunctionSpace::sub(const std::vector<int>& component) const
   sub_space->_component.insert(sub_space->_component.end(), component.begin(),
                                component.end());
 
-  // Insert new subspace into cache
-  _subspaces.emplace(sub_space->_component, sub_space);
+  // Insert new subspace into cache, keyed by the component relative to
+  // this space so that the lookup above can find it
+  _subspaces.emplace(component, sub_space);
 
   return sub_space;
 }
@@ -85,21 +87,106 @@ FunctionSpace::collapse() const
   if (_component.empty())
     throw std::runtime_error("Function space is not a subspace");
 
-  // Create collapsed DofMap
-  std::shared_ptr<fem::DofMap> collapsed_dofmap;
-  std::vector<std::int32_t> collapsed_dofs;
-  std::tie(collapsed_dofmap, collapsed_dofs)
-      = _dofmap->collapse(_mesh->mpi_comm(), _mesh->topology());
+  // Create collapsed DofMap on first request. The build involves
+  // parallel communication, so the result is cached and shared by
+  // subsequent collapses of this subspace.
+  if (!_collapsed_dofmap)
+  {
+    auto [dofmap, dofs] = _dofmap->collapse(_mesh->mpi_comm(),
+                                            _mesh->topology());
+    _collapsed_dofmap = std::move(dofmap);
+    _collapsed_dofs = std::move(dofs);
+  }
 
   // Create new FunctionSpace and return
-  return {FunctionSpace(_mesh, _element, collapsed_dofmap),
-          std::move(collapsed_dofs)};
+  return {FunctionSpace(_mesh, _element, _collapsed_dofmap), _collapsed_dofs};
 }
 //-----------------------------------------------------------------------------
 std::vector<int> FunctionSpace::component() const { return _component; }
 //-----------------------------------------------------------------------------
 xt::xtensor<double, 2>
 FunctionSpace::tabulate_dof_coordinates(bool transpose) const
+{
+  assert(_mesh);
+  assert(_dofmap);
+  std::shared_ptr<const common::IndexMap> index_map = _dofmap->index_map;
+  assert(index_map);
+  const std::size_t num_dofs = _dofmap->index_map_bs()
+                               * (index_map->size_local()
+                                  + index_map->num_ghosts())
+                               / _dofmap->bs();
+
+  // (Re-)build the cache if the mesh geometry has changed since the
+  // coordinates were last computed
+  if (_dof_coordinates.size() == 0
+      or _dof_coordinates_version != _mesh->geometry().version())
+  {
+    std::vector<std::int32_t> dof_pos(num_dofs);
+    std::iota(dof_pos.begin(), dof_pos.end(), 0);
+    _dof_coordinates = tabulate_dof_coordinates_impl(dof_pos, num_dofs);
+    _dof_coordinates_version = _mesh->geometry().version();
+  }
+
+  if (!transpose)
+    return _dof_coordinates;
+  else
+    return xt::transpose(_dof_coordinates);
+}
+//-----------------------------------------------------------------------------
+xt::xtensor<double, 2> FunctionSpace::tabulate_dof_coordinates(
+    const xtl::span<const std::int32_t>& dofs, bool transpose) const
+{
+  assert(_dofmap);
+  std::shared_ptr<const common::IndexMap> index_map = _dofmap->index_map;
+  assert(index_map);
+  const std::size_t num_dofs = _dofmap->index_map_bs()
+                               * (index_map->size_local()
+                                  + index_map->num_ghosts())
+                               / _dofmap->bs();
+
+  const std::size_t shape_c0 = transpose ? 3 : dofs.size();
+  const std::size_t shape_c1 = transpose ? dofs.size() : 3;
+  xt::xtensor<double, 2> coords = xt::zeros<double>({shape_c0, shape_c1});
+
+  // If the cache is already valid, gather from it rather than visiting
+  // cells
+  assert(_mesh);
+  if (_dof_coordinates.size() != 0
+      and _dof_coordinates_version == _mesh->geometry().version())
+  {
+    for (std::size_t i = 0; i < dofs.size(); ++i)
+    {
+      assert(std::size_t(dofs[i]) < num_dofs);
+      for (std::size_t j = 0; j < 3; ++j)
+      {
+        if (!transpose)
+          coords(i, j) = _dof_coordinates(dofs[i], j);
+        else
+          coords(j, i) = _dof_coordinates(dofs[i], j);
+      }
+    }
+    return coords;
+  }
+
+  // Map each requested dof to its output row. Later requests of the
+  // same dof win, matching the cell loop order.
+  std::vector<std::int32_t> dof_pos(num_dofs, -1);
+  for (std::size_t i = 0; i < dofs.size(); ++i)
+  {
+    assert(std::size_t(dofs[i]) < num_dofs);
+    dof_pos[dofs[i]] = i;
+  }
+
+  const xt::xtensor<double, 2> x
+      = tabulate_dof_coordinates_impl(dof_pos, dofs.size());
+  if (!transpose)
+    return x;
+  else
+    return xt::transpose(x);
+}
+//-----------------------------------------------------------------------------
+xt::xtensor<double, 2> FunctionSpace::tabulate_dof_coordinates_impl(
+    const std::vector<std::int32_t>& dof_pos, std::size_t num_rows) const
 {
   if (!_component.empty())
   {
@@ -116,23 +203,12 @@ FunctionSpace::tabulate_dof_coordinates(bool transpose) const
 
   // Geometric dimension
   assert(_mesh);
-  assert(_element);
   const std::size_t gdim = _mesh->geometry().dim();
   const int tdim = _mesh->topology().dim();
 
-  // Get dofmap local size
-  assert(_dofmap);
-  std::shared_ptr<const common::IndexMap> index_map = _dofmap->index_map;
-  const int index_map_bs = _dofmap->index_map_bs();
-  const int dofmap_bs = _dofmap->bs();
-  assert(index_map);
-
   const int element_block_size = _element->block_size();
   const std::size_t scalar_dofs
       = _element->space_dimension() / element_block_size;
-  const std::int32_t num_dofs
-      = index_map_bs * (index_map->size_local() + index_map->num_ghosts())
-        / dofmap_bs;
 
   // Get the dof coordinates on the reference element
   if (!_element->interpolation_ident())
@@ -153,17 +229,12 @@ FunctionSpace::tabulate_dof_coordinates(bool transpose) const
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
 
   // Array to hold coordinates to return
-  const std::size_t shape_c0 = transpose ? 3 : num_dofs;
-  const std::size_t shape_c1 = transpose ? num_dofs : 3;
-  xt::xtensor<double, 2> coords = xt::zeros<double>({shape_c0, shape_c1});
-
-  // Loop over cells and tabulate dofs
-  xt::xtensor<double, 2> x = xt::zeros<double>({scalar_dofs, gdim});
-  xt::xtensor<double, 2> coordinate_dofs({num_dofs_g, gdim});
+  xt::xtensor<double, 2> coords
+      = xt::zeros<double>({num_rows, std::size_t(3)});
 
   auto map = _mesh->topology().index_map(tdim);
   assert(map);
-  const int num_cells = map->size_local() + map->num_ghosts();
+  const std::int32_t num_cells = map->size_local() + map->num_ghosts();
 
   xtl::span<const std::uint32_t> cell_info;
   if (_element->needs_dof_transformations())
@@ -181,38 +252,73 @@ FunctionSpace::tabulate_dof_coordinates(bool transpose) const
   const xt::xtensor<double, 2> phi
       = xt::view(cmap.tabulate(0, X), 0, xt::all(), xt::all(), 0);
 
-  for (int c = 0; c < num_cells; ++c)
+  // Assign each requested dof to the last cell containing it, so that
+  // each output row is written by exactly one cell and cell ranges can
+  // be processed concurrently
+  std::vector<std::int32_t> dof_cell(dof_pos.size(), -1);
+  for (std::int32_t c = 0; c < num_cells; ++c)
   {
-    // Extract cell geometry
-    auto x_dofs = x_dofmap.links(c);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), gdim,
-                  std::next(coordinate_dofs.begin(), i * gdim));
-    }
+    for (std::int32_t dof : _dofmap->cell_dofs(c))
+      if (dof_pos[dof] >= 0)
+        dof_cell[dof] = c;
+  }
 
-    // Tabulate dof coordinates on cell
-    cmap.push_forward(x, coordinate_dofs, phi);
-    apply_dof_transformation(xtl::span(x.data(), x.size()),
-                             xtl::span(cell_info.data(), cell_info.size()), c,
-                             x.shape(1));
+  // Tabulate the dofs of the cells [begin, end)
+  const auto tabulate_cells = [&](std::int32_t begin, std::int32_t end)
+  {
+    xt::xtensor<double, 2> x = xt::zeros<double>({scalar_dofs, gdim});
+    xt::xtensor<double, 2> coordinate_dofs({num_dofs_g, gdim});
+    for (std::int32_t c = begin; c < end; ++c)
+    {
+      // Skip cells that do not own a requested dof
+      auto dofs = _dofmap->cell_dofs(c);
+      const bool required
+          = std::any_of(dofs.begin(), dofs.end(),
+                        [&](std::int32_t dof) { return dof_cell[dof] == c; });
+      if (!required)
+        continue;
+
+      // Extract cell geometry
+      auto x_dofs = x_dofmap.links(c);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        std::copy_n(xt::row(x_g, x_dofs[i]).begin(), gdim,
+                    std::next(coordinate_dofs.begin(), i * gdim));
+      }
 
-    // Get cell dofmap
-    auto dofs = _dofmap->cell_dofs(c);
+      // Tabulate dof coordinates on cell
+      cmap.push_forward(x, coordinate_dofs, phi);
+      apply_dof_transformation(xtl::span(x.data(), x.size()),
+                               xtl::span(cell_info.data(), cell_info.size()),
+                               c, x.shape(1));
 
-    // Copy dof coordinates into vector
-    if (!transpose)
-    {
+      // Copy dof coordinates into the output rows owned by this cell
       for (std::size_t i = 0; i < dofs.size(); ++i)
+      {
+        if (dof_cell[dofs[i]] != c)
+          continue;
         for (std::size_t j = 0; j < gdim; ++j)
-          coords(dofs[i], j) = x(i, j);
+          coords(dof_pos[dofs[i]], j) = x(i, j);
+      }
     }
-    else
+  };
+
+  // Thread over cells
+  const int num_threads = common::num_threads();
+  if (num_threads <= 1 or num_cells < 64)
+    tabulate_cells(0, num_cells);
+  else
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t)
     {
-      for (std::size_t i = 0; i < dofs.size(); ++i)
-        for (std::size_t j = 0; j < gdim; ++j)
-          coords(j, dofs[i]) = x(i, j);
+      threads.emplace_back(tabulate_cells,
+                           (std::int64_t(num_cells) * t) / num_threads,
+                           (std::int64_t(num_cells) * (t + 1)) / num_threads);
     }
+    for (std::thread& t : threads)
+      t.join();
   }
 
   return coords;
@@ -11,6 +11,7 @@
 #include <memory>
 #include <vector>
 #include <xtensor/xtensor.hpp>
+#include <xtl/xspan.hpp>
 
 namespace dolfinx::mesh
 {
@@ -71,7 +72,9 @@ public:
   bool contains(const FunctionSpace& V) const;
 
   /// Collapse a subspace and return a new function space and a map from
-  /// new to old dofs
+  /// new to old dofs. The collapsed dofmap is built on the first call
+  /// and cached, so repeated collapses of the same subspace (e.g. at
+  /// every output step) only pay for the dof copy.
   /// @return The new function space and a map from new to old dofs
   std::pair<FunctionSpace, std::vector<std::int32_t>> collapse() const;
 
@@ -82,6 +85,11 @@ public:
 
   /// @todo Remove - see function in interpolate.h
   /// Tabulate the physical coordinates of all dofs on this process.
+  ///
+  /// The coordinates are cached on the FunctionSpace and recomputed
+  /// only when the mesh geometry changes (detected via the geometry
+  /// version counter), so repeated calls on a static mesh are cheap.
+  ///
   /// @param[in] transpose If false the returned data has shape
   /// (num_points, gdim), otherwise it is transposed and has shape
   /// (gdim, num_points)
@@ -90,6 +98,19 @@ public:
   /// transposed.
   xt::xtensor<double, 2> tabulate_dof_coordinates(bool transpose) const;
 
+  /// Tabulate the physical coordinates of a subset of the dofs on this
+  /// process. Only cells containing a requested dof are visited, so
+  /// e.g. boundary-only queries do not touch the volume.
+  /// @param[in] dofs The (unblocked) dof indices to tabulate
+  /// @param[in] transpose If false the returned data has shape
+  /// (dofs.size(), gdim), otherwise it is transposed and has shape
+  /// (gdim, dofs.size())
+  /// @return The coordinates of the dofs, with row (or column if @p
+  /// transpose is true) i holding the coordinates of dof dofs[i]
+  xt::xtensor<double, 2>
+  tabulate_dof_coordinates(const xtl::span<const std::int32_t>& dofs,
+                           bool transpose) const;
+
   /// Unique identifier
   std::size_t id() const;
 
@@ -103,6 +124,14 @@ public:
   std::shared_ptr<const fem::DofMap> dofmap() const;
 
 private:
+  // Compute the physical coordinates of the dofs with dof_pos[dof]
+  // >= 0, writing the coordinates of a dof into row dof_pos[dof] of
+  // the returned (num_rows, 3) array. Cells without a requested dof
+  // are skipped.
+  xt::xtensor<double, 2>
+  tabulate_dof_coordinates_impl(const std::vector<std::int32_t>& dof_pos,
+                                std::size_t num_rows) const;
+
   // The mesh
   std::shared_ptr<const mesh::Mesh> _mesh;
 
@@ -121,8 +150,23 @@ private:
   // The identifier of root space
   std::size_t _root_space_id;
 
-  // Cache of subspaces
-  mutable std::map<std::vector<int>, std::weak_ptr<FunctionSpace>> _subspaces;
+  // Cache of subspaces, keyed by component. Subspaces are kept alive
+  // by the parent so that extracted sub-dofmaps and the collapsed
+  // dofmaps cached on them survive the caller releasing the subspace,
+  // e.g. between solver re-initializations.
+  mutable std::map<std::vector<int>, std::shared_ptr<FunctionSpace>>
+      _subspaces;
+
+  // Cached collapsed dofmap and new-to-old dof map for subspaces.
+  // Building the collapsed dofmap involves parallel communication, so
+  // it is computed on the first call to collapse() and re-used.
+  mutable std::shared_ptr<fem::DofMap> _collapsed_dofmap;
+  mutable std::vector<std::int32_t> _collapsed_dofs;
+
+  // Cached dof coordinates, shape (num_dofs, 3), and the geometry
+  // version they were computed for. Empty means not built.
+  mutable xt::xtensor<double, 2> _dof_coordinates;
+  mutable std::size_t _dof_coordinates_version = 0;
 };
 
 /// Extract FunctionSpaces for (0) rows blocks and (1) columns blocks
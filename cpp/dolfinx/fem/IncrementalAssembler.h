@@ -0,0 +1,214 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DofMap.h"
+#include "Form.h"
+#include "FunctionSpace.h"
+#include "utils.h"
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::fem
+{
+
+/// Incremental (dirty-cell) matrix assembly. The assembler retains the
+/// last element tensor of every cell; update() re-tabulates the
+/// tensors of a user-supplied cell subset and adds the difference
+/// (new - stale) into the matrix, so after mesh motion or a local
+/// coefficient change only the affected rows are touched and the cost
+/// is proportional to the changed region rather than the whole mesh.
+/// The first update() over all active cells performs the initial full
+/// assembly (stored tensors start at zero).
+///
+/// The matrix must use additive insertion and must not be zeroed
+/// between updates. Only cell integrals are supported.
+template <typename T>
+class IncrementalAssembler
+{
+public:
+  /// Create an incremental assembler for a bilinear form
+  /// @param[in] a The bilinear form. Only cell integrals are
+  /// supported.
+  explicit IncrementalAssembler(std::shared_ptr<const Form<T>> a) : _a(a)
+  {
+    assert(_a);
+    if (_a->num_integrals(IntegralType::exterior_facet) > 0
+        or _a->num_integrals(IntegralType::interior_facet) > 0)
+    {
+      throw std::runtime_error(
+          "Incremental assembly supports cell integrals only");
+    }
+
+    std::shared_ptr<const mesh::Mesh> mesh = _a->mesh();
+    assert(mesh);
+    const int tdim = mesh->topology().dim();
+    auto cell_map = mesh->topology().index_map(tdim);
+    assert(cell_map);
+    const std::int32_t num_cells
+        = cell_map->size_local() + cell_map->num_ghosts();
+
+    const int ndim0 = _a->function_spaces().at(0)->dofmap()->list().num_links(0)
+                      * _a->function_spaces().at(0)->dofmap()->bs();
+    const int ndim1 = _a->function_spaces().at(1)->dofmap()->list().num_links(0)
+                      * _a->function_spaces().at(1)->dofmap()->bs();
+    _ndim = {ndim0, ndim1};
+
+    // Stored element tensors and cell -> active-list position map for
+    // each cell integral
+    for (int id : _a->integral_ids(IntegralType::cell))
+    {
+      const std::vector<std::int32_t>& cells = _a->cell_domains(id);
+      _stored[id] = std::vector<T>(cells.size() * ndim0 * ndim1, 0);
+      std::vector<std::int32_t>& pos = _position[id];
+      pos.assign(num_cells, -1);
+      for (std::size_t i = 0; i < cells.size(); ++i)
+        pos[cells[i]] = i;
+    }
+  }
+
+  /// Re-assemble the contribution of a subset of cells, adding the
+  /// difference between the new and the previously assembled element
+  /// tensors into the matrix. Coefficients and constants are re-packed
+  /// for the form; geometry is read from the current mesh coordinates.
+  /// @param[in] mat_add The function for adding values into the matrix
+  /// (must have ADD_VALUES semantics)
+  /// @param[in] cells The dirty cells to re-assemble
+  /// @param[in] dof_marker0 Boundary condition markers for the rows
+  /// @param[in] dof_marker1 Boundary condition markers for the columns
+  void update(
+      const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                              const std::int32_t*, const T*)>& mat_add,
+      const xtl::span<const std::int32_t>& cells,
+      const std::vector<bool>& dof_marker0 = {},
+      const std::vector<bool>& dof_marker1 = {})
+  {
+    std::shared_ptr<const mesh::Mesh> mesh = _a->mesh();
+    assert(mesh);
+
+    const graph::AdjacencyList<std::int32_t>& dofs0
+        = _a->function_spaces().at(0)->dofmap()->list();
+    const int bs0 = _a->function_spaces().at(0)->dofmap()->bs();
+    const graph::AdjacencyList<std::int32_t>& dofs1
+        = _a->function_spaces().at(1)->dofmap()->list();
+    const int bs1 = _a->function_spaces().at(1)->dofmap()->bs();
+
+    std::shared_ptr<const fem::FiniteElement> element0
+        = _a->function_spaces().at(0)->element();
+    std::shared_ptr<const fem::FiniteElement> element1
+        = _a->function_spaces().at(1)->element();
+    const auto& dof_transform
+        = element0->template get_dof_transformation_function<T>();
+    const auto& dof_transform_to_transpose
+        = element1->template get_dof_transformation_to_transpose_function<T>();
+
+    xtl::span<const std::uint32_t> cell_info;
+    if (element0->needs_dof_transformations()
+        or element1->needs_dof_transformations())
+    {
+      mesh->topology_mutable().create_entity_permutations();
+      cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+    }
+
+    const std::vector<T>& constants = _a->packed_constants();
+    const auto coefficients = pack_coefficients(*_a);
+
+    // Prepare cell geometry
+    const graph::AdjacencyList<std::int32_t>& x_dofmap
+        = mesh->geometry().dofmap();
+    const std::size_t num_dofs_g = x_dofmap.num_links(0);
+    const xt::xtensor<double, 2>& x_g = mesh->geometry().x();
+
+    const auto [ndim0, ndim1] = _ndim;
+    std::vector<double> coordinate_dofs(3 * num_dofs_g);
+    std::vector<T> Ae(ndim0 * ndim1), dAe(ndim0 * ndim1);
+    const xtl::span<T> _Ae(Ae);
+
+    for (int id : _a->integral_ids(IntegralType::cell))
+    {
+      const auto& kernel = _a->kernel(IntegralType::cell, id);
+      const auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, id});
+      const std::vector<std::int32_t>& pos = _position.at(id);
+      std::vector<T>& stored = _stored.at(id);
+      for (std::int32_t c : cells)
+      {
+        const std::int32_t index = pos[c];
+        if (index < 0)
+          continue;
+
+        // Get cell coordinates/geometry
+        auto x_dofs = x_dofmap.links(c);
+        for (std::size_t i = 0; i < x_dofs.size(); ++i)
+        {
+          std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                      std::next(coordinate_dofs.begin(), 3 * i));
+        }
+
+        // Tabulate tensor
+        std::fill(Ae.begin(), Ae.end(), 0);
+        kernel(Ae.data(), coeffs.data() + index * cstride, constants.data(),
+               coordinate_dofs.data(), nullptr, nullptr);
+        dof_transform(_Ae, cell_info, c, ndim1);
+        dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
+
+        // Zero rows/columns for essential bcs
+        auto cell_dofs0 = dofs0.links(c);
+        auto cell_dofs1 = dofs1.links(c);
+        if (!dof_marker0.empty())
+        {
+          for (std::size_t i = 0; i < cell_dofs0.size(); ++i)
+            for (int k = 0; k < bs0; ++k)
+              if (dof_marker0[bs0 * cell_dofs0[i] + k])
+                std::fill_n(std::next(Ae.begin(), ndim1 * (bs0 * i + k)),
+                            ndim1, 0.0);
+        }
+        if (!dof_marker1.empty())
+        {
+          for (std::size_t j = 0; j < cell_dofs1.size(); ++j)
+            for (int k = 0; k < bs1; ++k)
+              if (dof_marker1[bs1 * cell_dofs1[j] + k])
+                for (int row = 0; row < ndim0; ++row)
+                  Ae[row * ndim1 + bs1 * j + k] = 0.0;
+        }
+
+        // Add difference to the matrix and store the new tensor
+        T* old = stored.data() + std::size_t(index) * ndim0 * ndim1;
+        for (int i = 0; i < ndim0 * ndim1; ++i)
+        {
+          dAe[i] = Ae[i] - old[i];
+          old[i] = Ae[i];
+        }
+        mat_add(cell_dofs0.size(), cell_dofs0.data(), cell_dofs1.size(),
+                cell_dofs1.data(), dAe.data());
+      }
+    }
+  }
+
+  /// The form being assembled
+  std::shared_ptr<const Form<T>> form() const { return _a; }
+
+private:
+  std::shared_ptr<const Form<T>> _a;
+
+  // Element tensor dimensions (rows, cols)
+  std::array<int, 2> _ndim;
+
+  // Per cell-integral id: stored element tensors and cell ->
+  // active-list position map
+  std::map<int, std::vector<T>> _stored;
+  std::map<int, std::vector<std::int32_t>> _position;
+};
+
+} // namespace dolfinx::fem
@@ -0,0 +1,283 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DofMap.h"
+#include "Form.h"
+#include "FunctionSpace.h"
+#include "utils.h"
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <memory>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::fem
+{
+
+/// A matrix-free representation of a bilinear form. The operator
+/// computes the action y <- y + A x cell-by-cell using the generated
+/// kernel and packed coefficients, without ever assembling the matrix
+/// A. This reduces memory use by an order of magnitude for high-order
+/// elements at the cost of re-tabulating element tensors on each
+/// application. The operator can be wrapped as a PETSc shell Mat and
+/// used with iterative solvers.
+///
+/// Constants and coefficients are packed at construction; call
+/// MatrixFreeOperator::repack to refresh them after coefficient data
+/// changes.
+template <typename T>
+class MatrixFreeOperator
+{
+public:
+  /// Create a matrix-free operator from a bilinear form
+  /// @param[in] a The bilinear form. Only cell integrals are
+  /// supported.
+  explicit MatrixFreeOperator(std::shared_ptr<const Form<T>> a) : _a(a)
+  {
+    assert(_a);
+    if (_a->rank() != 2)
+      throw std::runtime_error("Form must be a bilinear form (rank 2)");
+    if (_a->num_integrals(IntegralType::exterior_facet) > 0
+        or _a->num_integrals(IntegralType::interior_facet) > 0)
+    {
+      throw std::runtime_error(
+          "Matrix-free operator supports cell integrals only");
+    }
+    repack();
+  }
+
+  /// Re-pack form constants and coefficients, e.g. after a coefficient
+  /// Function has been updated
+  void repack()
+  {
+    _constants = _a->packed_constants();
+    _coefficients = pack_coefficients(*_a);
+  }
+
+  /// Compute y += A x. Ghost values of x are updated (forward scatter)
+  /// before the cell sweep and ghost contributions to y are
+  /// accumulated (reverse scatter add) afterwards.
+  /// @param[in,out] x The vector to apply the operator to
+  /// @param[in,out] y The result vector, accumulated into
+  void apply(la::Vector<T>& x, la::Vector<T>& y) const
+  {
+    std::shared_ptr<const mesh::Mesh> mesh = _a->mesh();
+    assert(mesh);
+
+    // Get dofmap data
+    std::shared_ptr<const fem::DofMap> dofmap0
+        = _a->function_spaces().at(0)->dofmap();
+    std::shared_ptr<const fem::DofMap> dofmap1
+        = _a->function_spaces().at(1)->dofmap();
+    assert(dofmap0);
+    assert(dofmap1);
+    const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+    const int bs0 = dofmap0->bs();
+    const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+    const int bs1 = dofmap1->bs();
+
+    std::shared_ptr<const fem::FiniteElement> element0
+        = _a->function_spaces().at(0)->element();
+    std::shared_ptr<const fem::FiniteElement> element1
+        = _a->function_spaces().at(1)->element();
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform
+        = element0->get_dof_transformation_function<T>();
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform_to_transpose
+        = element1->get_dof_transformation_to_transpose_function<T>();
+
+    const bool needs_transformation_data
+        = element0->needs_dof_transformations()
+          or element1->needs_dof_transformations();
+    xtl::span<const std::uint32_t> cell_info;
+    if (needs_transformation_data)
+    {
+      mesh->topology_mutable().create_entity_permutations();
+      cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+    }
+
+    // Prepare cell geometry
+    const graph::AdjacencyList<std::int32_t>& x_dofmap
+        = mesh->geometry().dofmap();
+    const std::size_t num_dofs_g = x_dofmap.num_links(0);
+    const xt::xtensor<double, 2>& x_g = mesh->geometry().x();
+
+    const int num_dofs0 = dofs0.links(0).size();
+    const int num_dofs1 = dofs1.links(0).size();
+    const int ndim0 = bs0 * num_dofs0;
+    const int ndim1 = bs1 * num_dofs1;
+    std::vector<T> Ae(ndim0 * ndim1), xe(ndim1), ye(ndim0);
+    const xtl::span<T> _Ae(Ae);
+    std::vector<double> coordinate_dofs(3 * num_dofs_g);
+
+    // Update ghost values of x before the cell sweep
+    x.scatter_fwd();
+    const xtl::span<const T> x_array = x.array();
+    const xtl::span<T> y_array = y.mutable_array();
+
+    for (int i : _a->integral_ids(IntegralType::cell))
+    {
+      const auto& kernel = _a->kernel(IntegralType::cell, i);
+      const auto& [coeffs, cstride] = _coefficients.at({IntegralType::cell, i});
+      const std::vector<std::int32_t>& cells = _a->cell_domains(i);
+      for (std::size_t index = 0; index < cells.size(); ++index)
+      {
+        std::int32_t c = cells[index];
+
+        // Get cell coordinates/geometry
+        auto x_dofs = x_dofmap.links(c);
+        for (std::size_t j = 0; j < x_dofs.size(); ++j)
+        {
+          std::copy_n(xt::row(x_g, x_dofs[j]).begin(), 3,
+                      std::next(coordinate_dofs.begin(), 3 * j));
+        }
+
+        // Tabulate element tensor
+        std::fill(Ae.begin(), Ae.end(), 0);
+        kernel(Ae.data(), coeffs.data() + index * cstride, _constants.data(),
+               coordinate_dofs.data(), nullptr, nullptr);
+        dof_transform(_Ae, cell_info, c, ndim1);
+        dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
+
+        // Gather local part of x
+        auto dmap1 = dofs1.links(c);
+        for (int j = 0; j < num_dofs1; ++j)
+          for (int k = 0; k < bs1; ++k)
+            xe[bs1 * j + k] = x_array[bs1 * dmap1[j] + k];
+
+        // ye = Ae * xe
+        std::fill(ye.begin(), ye.end(), 0);
+        for (int row = 0; row < ndim0; ++row)
+          for (int col = 0; col < ndim1; ++col)
+            ye[row] += Ae[row * ndim1 + col] * xe[col];
+
+        // Scatter-add into y
+        auto dmap0 = dofs0.links(c);
+        for (int j = 0; j < num_dofs0; ++j)
+          for (int k = 0; k < bs0; ++k)
+            y_array[bs0 * dmap0[j] + k] += ye[bs0 * j + k];
+      }
+    }
+
+    // Accumulate ghost contributions to y
+    y.scatter_rev(common::IndexMap::Mode::add);
+  }
+
+  /// Assemble the diagonal of the operator cell-by-cell into a vector,
+  /// e.g. for use with la::PolynomialSmoother. The test and trial
+  /// spaces of the form must be the same.
+  /// @param[in,out] diag The vector to accumulate the diagonal into.
+  /// It is zeroed before assembly and ghost contributions are
+  /// accumulated onto the owning process.
+  void diagonal(la::Vector<T>& diag) const
+  {
+    if (_a->function_spaces().at(0) != _a->function_spaces().at(1))
+    {
+      throw std::runtime_error(
+          "Operator diagonal requires identical test and trial spaces");
+    }
+
+    std::shared_ptr<const mesh::Mesh> mesh = _a->mesh();
+    assert(mesh);
+
+    // Get dofmap data
+    std::shared_ptr<const fem::DofMap> dofmap
+        = _a->function_spaces().at(0)->dofmap();
+    assert(dofmap);
+    const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+    const int bs = dofmap->bs();
+
+    std::shared_ptr<const fem::FiniteElement> element
+        = _a->function_spaces().at(0)->element();
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform
+        = element->get_dof_transformation_function<T>();
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform_to_transpose
+        = element->get_dof_transformation_to_transpose_function<T>();
+
+    xtl::span<const std::uint32_t> cell_info;
+    if (element->needs_dof_transformations())
+    {
+      mesh->topology_mutable().create_entity_permutations();
+      cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+    }
+
+    // Prepare cell geometry
+    const graph::AdjacencyList<std::int32_t>& x_dofmap
+        = mesh->geometry().dofmap();
+    const std::size_t num_dofs_g = x_dofmap.num_links(0);
+    const xt::xtensor<double, 2>& x_g = mesh->geometry().x();
+
+    const int num_dofs = dofs.links(0).size();
+    const int ndim = bs * num_dofs;
+    std::vector<T> Ae(ndim * ndim);
+    const xtl::span<T> _Ae(Ae);
+    std::vector<double> coordinate_dofs(3 * num_dofs_g);
+
+    const xtl::span<T> d_array = diag.mutable_array();
+    std::fill(d_array.begin(), d_array.end(), T(0));
+
+    for (int i : _a->integral_ids(IntegralType::cell))
+    {
+      const auto& kernel = _a->kernel(IntegralType::cell, i);
+      const auto& [coeffs, cstride] = _coefficients.at({IntegralType::cell, i});
+      const std::vector<std::int32_t>& cells = _a->cell_domains(i);
+      for (std::size_t index = 0; index < cells.size(); ++index)
+      {
+        std::int32_t c = cells[index];
+
+        // Get cell coordinates/geometry
+        auto x_dofs = x_dofmap.links(c);
+        for (std::size_t j = 0; j < x_dofs.size(); ++j)
+        {
+          std::copy_n(xt::row(x_g, x_dofs[j]).begin(), 3,
+                      std::next(coordinate_dofs.begin(), 3 * j));
+        }
+
+        // Tabulate element tensor
+        std::fill(Ae.begin(), Ae.end(), 0);
+        kernel(Ae.data(), coeffs.data() + index * cstride, _constants.data(),
+               coordinate_dofs.data(), nullptr, nullptr);
+        dof_transform(_Ae, cell_info, c, ndim);
+        dof_transform_to_transpose(_Ae, cell_info, c, ndim);
+
+        // Scatter-add the diagonal of the element tensor
+        auto dmap = dofs.links(c);
+        for (int j = 0; j < num_dofs; ++j)
+        {
+          for (int k = 0; k < bs; ++k)
+          {
+            const int row = bs * j + k;
+            d_array[bs * dmap[j] + k] += Ae[row * ndim + row];
+          }
+        }
+      }
+    }
+
+    // Accumulate ghost contributions
+    diag.scatter_rev(common::IndexMap::Mode::add);
+  }
+
+  /// The bilinear form the operator represents
+  std::shared_ptr<const Form<T>> form() const { return _a; }
+
+private:
+  std::shared_ptr<const Form<T>> _a;
+  std::vector<T> _constants;
+  std::map<std::pair<IntegralType, int>, std::pair<std::vector<T>, int>>
+      _coefficients;
+};
+
+} // namespace dolfinx::fem
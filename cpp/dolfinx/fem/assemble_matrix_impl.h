@@ -10,7 +10,13 @@
 #include "Form.h"
 #include "FunctionSpace.h"
 #include "utils.h"
+#include <algorithm>
+#include <dolfinx/common/ScratchArena.h>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/coloring.h>
+#include <dolfinx/la/MatrixCSR.h>
 #include <dolfinx/la/utils.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
@@ -37,20 +43,135 @@ void assemble_matrix(
                    std::pair<xtl::span<const T>, int>>& coefficients,
     const std::vector<bool>& bc0, const std::vector<bool>& bc1);
 
-/// Execute kernel over cells and accumulate result in matrix
-template <typename T>
+/// Group integration entities by colour such that the cells attached
+/// to entities in one group do not share a mesh vertex, hence entities
+/// of the same colour touch disjoint matrix rows/columns and can be
+/// assembled concurrently without atomics.
+///
+/// @param[in] topology The mesh topology
+/// @param[in] entity_cells Flattened list of cells attached to each
+/// entity (`cells_per_entity` cells per entity)
+/// @param[in] cells_per_entity Number of cells attached to each entity
+/// (1 for cell and exterior facet integrals, 2 for interior facets)
+/// @return Entity positions grouped by colour
+inline std::vector<std::vector<std::int32_t>>
+compute_conflict_free_groups(const mesh::Topology& topology,
+                             const std::vector<std::int32_t>& entity_cells,
+                             int cells_per_entity)
+{
+  const int tdim = topology.dim();
+  auto c_to_v = topology.connectivity(tdim, 0);
+  assert(c_to_v);
+  auto map_v = topology.index_map(0);
+  assert(map_v);
+  const std::int32_t num_vertices = map_v->size_local() + map_v->num_ghosts();
+  const std::int32_t num_entities = entity_cells.size() / cells_per_entity;
+
+  // Build vertex -> entity position lists for the active entities
+  std::vector<std::vector<std::int32_t>> v_to_e(num_vertices);
+  for (std::int32_t e = 0; e < num_entities; ++e)
+  {
+    for (int i = 0; i < cells_per_entity; ++i)
+    {
+      for (std::int32_t v : c_to_v->links(entity_cells[cells_per_entity * e + i]))
+        v_to_e[v].push_back(e);
+    }
+  }
+
+  // Build entity conflict graph (entities sharing a vertex) and colour
+  std::vector<std::vector<std::int32_t>> conflicts(num_entities);
+  for (std::int32_t e = 0; e < num_entities; ++e)
+  {
+    std::vector<std::int32_t>& nbr = conflicts[e];
+    for (int i = 0; i < cells_per_entity; ++i)
+    {
+      for (std::int32_t v : c_to_v->links(entity_cells[cells_per_entity * e + i]))
+        nbr.insert(nbr.end(), v_to_e[v].begin(), v_to_e[v].end());
+    }
+    std::sort(nbr.begin(), nbr.end());
+    nbr.erase(std::unique(nbr.begin(), nbr.end()), nbr.end());
+  }
+
+  const std::vector<std::int32_t> colors
+      = graph::color(graph::AdjacencyList<std::int32_t>(conflicts));
+
+  const std::int32_t num_colors
+      = colors.empty()
+            ? 0
+            : *std::max_element(colors.begin(), colors.end()) + 1;
+  std::vector<std::vector<std::int32_t>> groups(num_colors);
+  for (std::int32_t e = 0; e < num_entities; ++e)
+    groups[colors[e]].push_back(e);
+
+  return groups;
+}
+
+/// Execute an assembly routine over entities re-ordered by a
+/// conflict-free colouring (see compute_conflict_free_groups), running
+/// each colour in parallel on the shared thread pool. The callable
+/// `fn` is passed a contiguous range of entities and the matching
+/// packed coefficients, and must be safe to call concurrently for
+/// conflict-free entity ranges.
+template <typename T, typename U, typename Fn>
+void assemble_coloured(const mesh::Topology& topology,
+                       const xtl::span<const U>& entities,
+                       const std::vector<std::int32_t>& entity_cells,
+                       int cells_per_entity, const xtl::span<const T>& coeffs,
+                       int cstride, Fn&& fn)
+{
+  const std::vector<std::vector<std::int32_t>> groups
+      = compute_conflict_free_groups(topology, entity_cells, cells_per_entity);
+
+  // Permute entities and packed coefficients so that each colour
+  // occupies a contiguous range
+  std::vector<U> entities_c;
+  entities_c.reserve(entities.size());
+  std::vector<T> coeffs_c(coeffs.size());
+  for (const std::vector<std::int32_t>& group : groups)
+  {
+    for (std::int32_t e : group)
+    {
+      std::copy_n(std::next(coeffs.begin(), e * cstride), cstride,
+                  std::next(coeffs_c.begin(), entities_c.size() * cstride));
+      entities_c.push_back(entities[e]);
+    }
+  }
+
+  std::size_t offset = 0;
+  for (const std::vector<std::int32_t>& group : groups)
+  {
+    const std::size_t n = group.size();
+    common::thread_pool().parallel_for(
+        n,
+        [&entities_c, &coeffs_c, cstride, offset, &fn](std::size_t begin,
+                                                       std::size_t end)
+        {
+          begin += offset;
+          end += offset;
+          fn(xtl::span<const U>(entities_c.data() + begin, end - begin),
+             xtl::span<const T>(coeffs_c.data() + begin * cstride,
+                                (end - begin) * cstride));
+        });
+    offset += n;
+  }
+}
+
+/// Execute kernel over cells and accumulate result in matrix. _bs0 and
+/// _bs1 set the block size as a compile-time constant so that the
+/// blocked boundary condition loops unroll; when negative the block
+/// size is read from the dofmaps at runtime. The dof transformations
+/// are generic callables so that the transformation-free instantiation
+/// (an empty no-op functor) carries no per-cell indirect call.
+template <typename T, int _bs0 = -1, int _bs1 = -1, typename Transform0,
+          typename Transform1>
 void assemble_cells(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set,
     const mesh::Geometry& geometry, const xtl::span<const std::int32_t>& cells,
-    const std::function<void(const xtl::span<T>&,
-                             const xtl::span<const std::uint32_t>&,
-                             std::int32_t, int)>& dof_transform,
-    const graph::AdjacencyList<std::int32_t>& dofmap0, int bs0,
-    const std::function<void(const xtl::span<T>&,
-                             const xtl::span<const std::uint32_t>&,
-                             std::int32_t, int)>& dof_transform_to_transpose,
-    const graph::AdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const Transform0& dof_transform,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const Transform1& dof_transform_to_transpose,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap1, int bs1,
     const std::vector<bool>& bc0, const std::vector<bool>& bc1,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& kernel,
@@ -58,8 +179,12 @@ void assemble_cells(
     const xtl::span<const T>& constants,
     const xtl::span<const std::uint32_t>& cell_info)
 {
+  assert(_bs0 < 0 or _bs0 == bs0);
+  assert(_bs1 < 0 or _bs1 == bs1);
+
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
@@ -70,9 +195,13 @@ void assemble_cells(
   const int num_dofs1 = dofmap1.links(0).size();
   const int ndim0 = bs0 * num_dofs0;
   const int ndim1 = bs1 * num_dofs1;
-  std::vector<T> Ae(ndim0 * ndim1);
+
+  // Scratch buffers, reused across assembly calls (see ScratchArena)
+  common::ScratchArena::Frame scratch;
+  const xtl::span<T> Ae = scratch.allocate<T>(ndim0 * ndim1);
   const xtl::span<T> _Ae(Ae);
-  std::vector<double> coordinate_dofs(3 * num_dofs_g);
+  const xtl::span<double> coordinate_dofs
+      = scratch.allocate<double>(3 * num_dofs_g);
 
   // Iterate over active cells
   for (std::size_t index = 0; index < cells.size(); ++index)
@@ -102,13 +231,28 @@ void assemble_cells(
     {
       for (int i = 0; i < num_dofs0; ++i)
       {
-        for (int k = 0; k < bs0; ++k)
+        if constexpr (_bs0 > 0)
         {
-          if (bc0[bs0 * dofs0[i] + k])
+          for (int k = 0; k < _bs0; ++k)
           {
-            // Zero row bs0 * i + k
-            const int row = bs0 * i + k;
-            std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
+            if (bc0[_bs0 * dofs0[i] + k])
+            {
+              // Zero row _bs0 * i + k
+              const int row = _bs0 * i + k;
+              std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
+            }
+          }
+        }
+        else
+        {
+          for (int k = 0; k < bs0; ++k)
+          {
+            if (bc0[bs0 * dofs0[i] + k])
+            {
+              // Zero row bs0 * i + k
+              const int row = bs0 * i + k;
+              std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
+            }
           }
         }
       }
@@ -118,14 +262,30 @@ void assemble_cells(
     {
       for (int j = 0; j < num_dofs1; ++j)
       {
-        for (int k = 0; k < bs1; ++k)
+        if constexpr (_bs1 > 0)
         {
-          if (bc1[bs1 * dofs1[j] + k])
+          for (int k = 0; k < _bs1; ++k)
           {
-            // Zero column bs1 * j + k
-            const int col = bs1 * j + k;
-            for (int row = 0; row < ndim0; ++row)
-              Ae[row * ndim1 + col] = 0.0;
+            if (bc1[_bs1 * dofs1[j] + k])
+            {
+              // Zero column _bs1 * j + k
+              const int col = _bs1 * j + k;
+              for (int row = 0; row < ndim0; ++row)
+                Ae[row * ndim1 + col] = 0.0;
+            }
+          }
+        }
+        else
+        {
+          for (int k = 0; k < bs1; ++k)
+          {
+            if (bc1[bs1 * dofs1[j] + k])
+            {
+              // Zero column bs1 * j + k
+              const int col = bs1 * j + k;
+              for (int row = 0; row < ndim0; ++row)
+                Ae[row * ndim1 + col] = 0.0;
+            }
           }
         }
       }
@@ -135,21 +295,325 @@ void assemble_cells(
   }
 }
 
+/// Execute kernel over cells once for an ensemble of packed
+/// coefficient sets, emitting sample s through mat_set[s]. The
+/// geometry gather and the dof lookups are performed once per cell and
+/// re-used for every sample, so the mesh-side memory traffic is
+/// amortized across the ensemble and the inner sample loop runs from
+/// cache.
+template <typename T, typename Transform0, typename Transform1>
+void assemble_cells_ensemble(
+    const std::vector<std::function<int(std::int32_t, const std::int32_t*,
+                                        std::int32_t, const std::int32_t*,
+                                        const T*)>>& mat_set,
+    const mesh::Geometry& geometry, const xtl::span<const std::int32_t>& cells,
+    const Transform0& dof_transform,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const Transform1& dof_transform_to_transpose,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel,
+    const std::vector<xtl::span<const T>>& coeffs, int cstride,
+    const xtl::span<const T>& constants,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  const std::size_t num_samples = mat_set.size();
+  assert(coeffs.size() == num_samples);
+
+  // Prepare cell geometry
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+
+  const int num_dofs0 = dofmap0.links(0).size();
+  const int num_dofs1 = dofmap1.links(0).size();
+  const int ndim0 = bs0 * num_dofs0;
+  const int ndim1 = bs1 * num_dofs1;
+
+  // Scratch buffers, reused across assembly calls (see ScratchArena)
+  common::ScratchArena::Frame scratch;
+  const xtl::span<T> Ae = scratch.allocate<T>(ndim0 * ndim1);
+  const xtl::span<T> _Ae(Ae);
+  const xtl::span<double> coordinate_dofs
+      = scratch.allocate<double>(3 * num_dofs_g);
+
+  // Iterate over active cells
+  for (std::size_t index = 0; index < cells.size(); ++index)
+  {
+    std::int32_t c = cells[index];
+
+    // Get cell coordinates/geometry (once for all samples)
+    auto x_dofs = x_dofmap.links(c);
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                  std::next(coordinate_dofs.begin(), 3 * i));
+    }
+    auto dofs0 = dofmap0.links(c);
+    auto dofs1 = dofmap1.links(c);
+
+    for (std::size_t s = 0; s < num_samples; ++s)
+    {
+      // Tabulate tensor
+      std::fill(Ae.begin(), Ae.end(), 0);
+      kernel(Ae.data(), coeffs[s].data() + index * cstride, constants.data(),
+             coordinate_dofs.data(), nullptr, nullptr);
+
+      dof_transform(_Ae, cell_info, c, ndim1);
+      dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
+
+      // Zero rows/columns for essential bcs
+      if (!bc0.empty())
+      {
+        for (int i = 0; i < num_dofs0; ++i)
+        {
+          for (int k = 0; k < bs0; ++k)
+          {
+            if (bc0[bs0 * dofs0[i] + k])
+            {
+              // Zero row bs0 * i + k
+              const int row = bs0 * i + k;
+              std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
+            }
+          }
+        }
+      }
+
+      if (!bc1.empty())
+      {
+        for (int j = 0; j < num_dofs1; ++j)
+        {
+          for (int k = 0; k < bs1; ++k)
+          {
+            if (bc1[bs1 * dofs1[j] + k])
+            {
+              // Zero column bs1 * j + k
+              const int col = bs1 * j + k;
+              for (int row = 0; row < ndim0; ++row)
+                Ae[row * ndim1 + col] = 0.0;
+            }
+          }
+        }
+      }
+
+      mat_set[s](dofs0.size(), dofs0.data(), dofs1.size(), dofs1.data(),
+                 Ae.data());
+    }
+  }
+}
+
+/// Execute kernel over cells and stream the element tensors into a CSR
+/// matrix at precomputed value offsets (see
+/// fem::create_element_csr_map). The offset map is indexed by the
+/// global cell index, so cells may be visited in any order, including
+/// coloured, threaded ranges. No index search and no boundary
+/// condition zeroing is performed; entries masked (negative) in the
+/// offset map are skipped.
+template <typename T, typename Transform0, typename Transform1>
+void assemble_cells_refill(
+    la::MatrixCSR<T>& A, const xtl::span<const std::int64_t>& element_map,
+    const mesh::Geometry& geometry, const xtl::span<const std::int32_t>& cells,
+    const Transform0& dof_transform,
+    const Transform1& dof_transform_to_transpose, int ndim0, int ndim1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel,
+    const xtl::span<const T>& coeffs, int cstride,
+    const xtl::span<const T>& constants,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  // Prepare cell geometry
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+
+  // Scratch buffers, reused across assembly calls (see ScratchArena)
+  common::ScratchArena::Frame scratch;
+  const xtl::span<T> Ae = scratch.allocate<T>(ndim0 * ndim1);
+  const xtl::span<T> _Ae(Ae);
+  const xtl::span<double> coordinate_dofs
+      = scratch.allocate<double>(3 * num_dofs_g);
+
+  // Iterate over active cells
+  for (std::size_t index = 0; index < cells.size(); ++index)
+  {
+    std::int32_t c = cells[index];
+
+    // Get cell coordinates/geometry
+    auto x_dofs = x_dofmap.links(c);
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                  std::next(coordinate_dofs.begin(), 3 * i));
+    }
+
+    // Tabulate tensor
+    std::fill(Ae.begin(), Ae.end(), 0);
+    kernel(Ae.data(), coeffs.data() + index * cstride, constants.data(),
+           coordinate_dofs.data(), nullptr, nullptr);
+
+    dof_transform(_Ae, cell_info, c, ndim1);
+    dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
+
+    // Stream into the value arrays at the recorded offsets
+    A.add_at(element_map.data() + std::int64_t(c) * ndim0 * ndim1,
+             ndim0 * ndim1, Ae.data());
+  }
+}
+
+/// Execute a batched (cross-cell SIMD) kernel over cells and
+/// accumulate the result in the matrix. Geometry and packed
+/// coefficients for `batch_size` cells are interleaved lane-wise, i.e.
+/// the value at flat index i for lane (cell) l is stored at
+/// `i * batch_size + l`, so that a vectorized kernel can process one
+/// SIMD lane per cell. The batched kernel receives the interleaved
+/// element tensor, coefficients and coordinates and computes
+/// `batch_size` element tensors in one invocation. Cells left over
+/// when the cell count is not a multiple of the batch size are
+/// assembled with the scalar `kernel`.
+template <typename T, typename Transform0, typename Transform1>
+void assemble_cells_batched(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set,
+    const mesh::Geometry& geometry, const xtl::span<const std::int32_t>& cells,
+    const Transform0& dof_transform,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const Transform1& dof_transform_to_transpose,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const std::function<void(T*, const T*, const T*, const double*)>&
+        batch_kernel,
+    int batch_size,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel,
+    const xtl::span<const T>& coeffs, int cstride,
+    const xtl::span<const T>& constants,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  assert(batch_size > 0);
+
+  // Prepare cell geometry
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+
+  const int num_dofs0 = dofmap0.links(0).size();
+  const int num_dofs1 = dofmap1.links(0).size();
+  const int ndim0 = bs0 * num_dofs0;
+  const int ndim1 = bs1 * num_dofs1;
+
+  // Interleaved batch buffers (lane l of batch at flat index
+  // i * batch_size + l)
+  std::vector<T> Ae_b(ndim0 * ndim1 * batch_size);
+  std::vector<T> coeffs_b(cstride * batch_size);
+  std::vector<double> coordinate_dofs_b(3 * num_dofs_g * batch_size);
+
+  // Per-cell element tensor for post-processing (transforms, bcs)
+  std::vector<T> Ae(ndim0 * ndim1);
+  const xtl::span<T> _Ae(Ae);
+
+  const std::size_t num_batches = cells.size() / batch_size;
+  for (std::size_t b = 0; b < num_batches; ++b)
+  {
+    // Pack interleaved geometry and coefficients for the batch
+    for (int l = 0; l < batch_size; ++l)
+    {
+      const std::size_t index = b * batch_size + l;
+      auto x_dofs = x_dofmap.links(cells[index]);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        for (int j = 0; j < 3; ++j)
+        {
+          coordinate_dofs_b[(3 * i + j) * batch_size + l]
+              = x_g(x_dofs[i], j);
+        }
+      }
+
+      for (int i = 0; i < cstride; ++i)
+        coeffs_b[i * batch_size + l] = coeffs[index * cstride + i];
+    }
+
+    // Tabulate batch_size element tensors in one kernel invocation
+    std::fill(Ae_b.begin(), Ae_b.end(), 0);
+    batch_kernel(Ae_b.data(), coeffs_b.data(), constants.data(),
+                 coordinate_dofs_b.data());
+
+    // De-interleave and insert each lane
+    for (int l = 0; l < batch_size; ++l)
+    {
+      const std::int32_t c = cells[b * batch_size + l];
+      for (int i = 0; i < ndim0 * ndim1; ++i)
+        Ae[i] = Ae_b[i * batch_size + l];
+
+      dof_transform(_Ae, cell_info, c, ndim1);
+      dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
+
+      // Zero rows/columns for essential bcs
+      auto dofs0 = dofmap0.links(c);
+      auto dofs1 = dofmap1.links(c);
+      if (!bc0.empty())
+      {
+        for (int i = 0; i < num_dofs0; ++i)
+        {
+          for (int k = 0; k < bs0; ++k)
+          {
+            if (bc0[bs0 * dofs0[i] + k])
+            {
+              const int row = bs0 * i + k;
+              std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
+            }
+          }
+        }
+      }
+
+      if (!bc1.empty())
+      {
+        for (int j = 0; j < num_dofs1; ++j)
+        {
+          for (int k = 0; k < bs1; ++k)
+          {
+            if (bc1[bs1 * dofs1[j] + k])
+            {
+              const int col = bs1 * j + k;
+              for (int row = 0; row < ndim0; ++row)
+                Ae[row * ndim1 + col] = 0.0;
+            }
+          }
+        }
+      }
+
+      mat_set(dofs0.size(), dofs0.data(), dofs1.size(), dofs1.data(),
+              Ae.data());
+    }
+  }
+
+  // Assemble remainder cells with the scalar kernel
+  const std::size_t tail = num_batches * batch_size;
+  if (tail < cells.size())
+  {
+    assemble_cells<T>(mat_set, geometry, cells.subspan(tail), dof_transform,
+                      dofmap0, bs0, dof_transform_to_transpose, dofmap1, bs1,
+                      bc0, bc1, kernel, coeffs.subspan(tail * cstride),
+                      cstride, constants, cell_info);
+  }
+}
+
 /// Execute kernel over exterior facets and  accumulate result in Mat
-template <typename T>
+template <typename T, typename Transform0, typename Transform1>
 void assemble_exterior_facets(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set,
     const mesh::Mesh& mesh,
     const xtl::span<const std::pair<std::int32_t, int>>& facets,
-    const std::function<void(const xtl::span<T>&,
-                             const xtl::span<const std::uint32_t>&,
-                             std::int32_t, int)>& dof_transform,
-    const graph::AdjacencyList<std::int32_t>& dofmap0, int bs0,
-    const std::function<void(const xtl::span<T>&,
-                             const xtl::span<const std::uint32_t>&,
-                             std::int32_t, int)>& dof_transform_to_transpose,
-    const graph::AdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const Transform0& dof_transform,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const Transform1& dof_transform_to_transpose,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap1, int bs1,
     const std::vector<bool>& bc0, const std::vector<bool>& bc1,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& kernel,
@@ -161,7 +625,8 @@ void assemble_exterior_facets(
   const int tdim = mesh.topology().dim();
 
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = mesh.geometry().dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
@@ -170,13 +635,16 @@ void assemble_exterior_facets(
   const int num_cell_facets
       = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
 
-  // Data structures used in assembly
-  std::vector<double> coordinate_dofs(3 * num_dofs_g);
+  // Data structures used in assembly, reused across calls (see
+  // ScratchArena)
+  common::ScratchArena::Frame scratch;
+  const xtl::span<double> coordinate_dofs
+      = scratch.allocate<double>(3 * num_dofs_g);
   const int num_dofs0 = dofmap0.links(0).size();
   const int num_dofs1 = dofmap1.links(0).size();
   const int ndim0 = bs0 * num_dofs0;
   const int ndim1 = bs1 * num_dofs1;
-  std::vector<T> Ae(ndim0 * ndim1);
+  const xtl::span<T> Ae = scratch.allocate<T>(ndim0 * ndim1);
   const xtl::span<T> _Ae(Ae);
 
   for (std::size_t index = 0; index < facets.size(); ++index)
@@ -241,33 +709,24 @@ void assemble_exterior_facets(
 }
 
 /// Execute kernel over interior facets and  accumulate result in Mat
-template <typename T>
+template <typename T, typename Transform0, typename Transform1>
 void assemble_interior_facets(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set,
-    const mesh::Mesh& mesh,
-    const xtl::span<const std::tuple<std::int32_t, int, std::int32_t, int>>&
-        facets,
-    const std::function<void(const xtl::span<T>&,
-                             const xtl::span<const std::uint32_t>&,
-                             std::int32_t, int)>& dof_transform,
-    const DofMap& dofmap0, int bs0,
-    const std::function<void(const xtl::span<T>&,
-                             const xtl::span<const std::uint32_t>&,
-                             std::int32_t, int)>& dof_transform_to_transpose,
-    const DofMap& dofmap1, int bs1, const std::vector<bool>& bc0,
+    const mesh::Mesh& mesh, const xtl::span<const InteriorFacetData>& facets,
+    const Transform0& dof_transform, const DofMap& dofmap0, int bs0,
+    const Transform1& dof_transform_to_transpose, const DofMap& dofmap1,
+    int bs1, const std::vector<bool>& bc0,
     const std::vector<bool>& bc1,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& kernel,
     const xtl::span<const T>& coeffs, int cstride,
     const xtl::span<const int>& offsets, const xtl::span<const T>& constants,
-    const xtl::span<const std::uint32_t>& cell_info,
-    const std::function<std::uint8_t(std::size_t)>& get_perm)
+    const xtl::span<const std::uint32_t>& cell_info)
 {
-  const int tdim = mesh.topology().dim();
-
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = mesh.geometry().dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
@@ -279,18 +738,13 @@ void assemble_interior_facets(
   std::vector<T> coeff_array(2 * offsets.back());
   assert(offsets.back() == cstride);
 
-  const int num_cell_facets
-      = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
-
   // Temporaries for joint dofmaps
   std::vector<std::int32_t> dmapjoint0, dmapjoint1;
 
   for (std::size_t index = 0; index < facets.size(); ++index)
   {
-    const std::array<std::int32_t, 2> cells
-        = {std::get<0>(facets[index]), std::get<2>(facets[index])};
-    const std::array<int, 2> local_facet
-        = {std::get<1>(facets[index]), std::get<3>(facets[index])};
+    const std::array<std::int32_t, 2>& cells = facets[index].cells;
+    const std::array<int, 2>& local_facet = facets[index].local_facet;
 
     // Get cell geometry
     auto x_dofs0 = x_dofmap.links(cells[0]);
@@ -328,11 +782,9 @@ void assemble_interior_facets(
     Ae.resize(num_rows * num_cols);
     std::fill(Ae.begin(), Ae.end(), 0);
 
-    const std::array perm{
-        get_perm(cells[0] * num_cell_facets + local_facet[0]),
-        get_perm(cells[1] * num_cell_facets + local_facet[1])};
     kernel(Ae.data(), coeffs.data() + index * 2 * cstride, constants.data(),
-           coordinate_dofs.data(), local_facet.data(), perm.data());
+           coordinate_dofs.data(), local_facet.data(),
+           facets[index].perm.data());
 
     const xtl::span<T> _Ae(Ae);
 
@@ -390,14 +842,22 @@ void assemble_interior_facets(
   }
 }
 
-template <typename T>
+/// Assemble a matrix with the dof transformations supplied as generic
+/// callables. The function is instantiated once with the std::function
+/// transformations and once with an empty no-op functor, so forms over
+/// transformation-free elements pay no per-cell indirect call; see
+/// assemble_matrix below for the selection.
+template <typename T, typename Transform0, typename Transform1>
 void assemble_matrix(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set,
     const Form<T>& a, const xtl::span<const T>& constants,
     const std::map<std::pair<IntegralType, int>,
                    std::pair<xtl::span<const T>, int>>& coefficients,
-    const std::vector<bool>& bc0, const std::vector<bool>& bc1)
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const Transform0& dof_transform,
+    const Transform1& dof_transform_to_transpose,
+    const xtl::span<const std::uint32_t>& cell_info)
 {
   std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
   assert(mesh);
@@ -414,51 +874,72 @@ void assemble_matrix(
   const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
   const int bs1 = dofmap1->bs();
 
-  std::shared_ptr<const fem::FiniteElement> element0
-      = a.function_spaces().at(0)->element();
-  std::shared_ptr<const fem::FiniteElement> element1
-      = a.function_spaces().at(1)->element();
-  const std::function<void(const xtl::span<T>&,
-                           const xtl::span<const std::uint32_t>&, std::int32_t,
-                           int)>& dof_transform
-      = element0->get_dof_transformation_function<T>();
-  const std::function<void(const xtl::span<T>&,
-                           const xtl::span<const std::uint32_t>&, std::int32_t,
-                           int)>& dof_transform_to_transpose
-      = element1->get_dof_transformation_to_transpose_function<T>();
-
-  const bool needs_transformation_data
-      = element0->needs_dof_transformations()
-        or element1->needs_dof_transformations()
-        or a.needs_facet_permutations();
-  xtl::span<const std::uint32_t> cell_info;
-  if (needs_transformation_data)
-  {
-    mesh->topology_mutable().create_entity_permutations();
-    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
-  }
-
+  const int num_threads = dolfinx::common::num_threads();
   for (int i : a.integral_ids(IntegralType::cell))
   {
     const auto& fn = a.kernel(IntegralType::cell, i);
     const auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, i});
     const std::vector<std::int32_t>& cells = a.cell_domains(i);
-    impl::assemble_cells<T>(mat_set, mesh->geometry(), cells, dof_transform,
-                            dofs0, bs0, dof_transform_to_transpose, dofs1, bs1,
-                            bc0, bc1, fn, coeffs, cstride, constants,
-                            cell_info);
-  }
 
-  if (a.num_integrals(IntegralType::exterior_facet) > 0
-      or a.num_integrals(IntegralType::interior_facet) > 0)
-  {
-    std::function<std::uint8_t(std::size_t)> get_perm;
-    if (a.needs_facet_permutations())
+    // Dispatch to a block-size specialized instantiation for the
+    // common block sizes
+    auto assemble_range = [&](const xtl::span<const std::int32_t>& cells_range,
+                              const xtl::span<const T>& coeffs_range)
     {
-      mesh->topology_mutable().create_entity_permutations();
-      const std::vector<std::uint8_t>& perms
-          = mesh->topology().get_facet_permutations();
-      get_perm = [&perms](std::size_t i) { return perms[i]; };
+      if (bs0 == 1 and bs1 == 1)
+      {
+        impl::assemble_cells<T, 1, 1>(mat_set, mesh->geometry(), cells_range,
+                                      dof_transform, dofs0, bs0,
+                                      dof_transform_to_transpose, dofs1, bs1,
+                                      bc0, bc1, fn, coeffs_range, cstride,
+                                      constants, cell_info);
+      }
+      else if (bs0 == 2 and bs1 == 2)
+      {
+        impl::assemble_cells<T, 2, 2>(mat_set, mesh->geometry(), cells_range,
+                                      dof_transform, dofs0, bs0,
+                                      dof_transform_to_transpose, dofs1, bs1,
+                                      bc0, bc1, fn, coeffs_range, cstride,
+                                      constants, cell_info);
+      }
+      else if (bs0 == 3 and bs1 == 3)
+      {
+        impl::assemble_cells<T, 3, 3>(mat_set, mesh->geometry(), cells_range,
+                                      dof_transform, dofs0, bs0,
+                                      dof_transform_to_transpose, dofs1, bs1,
+                                      bc0, bc1, fn, coeffs_range, cstride,
+                                      constants, cell_info);
+      }
+      else
+      {
+        impl::assemble_cells<T>(mat_set, mesh->geometry(), cells_range,
+                                dof_transform, dofs0, bs0,
+                                dof_transform_to_transpose, dofs1, bs1, bc0,
+                                bc1, fn, coeffs_range, cstride, constants,
+                                cell_info);
+      }
+    };
+
+    if (num_threads > 1 and !cells.empty())
+    {
+      impl::assemble_coloured<T, std::int32_t>(
+          mesh->topology(), xtl::span<const std::int32_t>(cells), cells, 1,
+          coeffs, cstride, assemble_range);
+    }
+    else
+      assemble_range(cells, coeffs);
+  }
+
+  if (a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    std::function<std::uint8_t(std::size_t)> get_perm;
+    if (a.needs_facet_permutations())
+    {
+      mesh->topology_mutable().create_entity_permutations();
+      const std::vector<std::uint8_t>& perms
+          = mesh->topology().get_facet_permutations();
+      get_perm = [&perms](std::size_t i) { return perms[i]; };
     }
     else
       get_perm = [](std::size_t) { return 0; };
@@ -470,10 +951,31 @@ void assemble_matrix(
           = coefficients.at({IntegralType::exterior_facet, i});
       const std::vector<std::pair<std::int32_t, int>>& facets
           = a.exterior_facet_domains(i);
-      impl::assemble_exterior_facets<T>(
-          mat_set, *mesh, facets, dof_transform, dofs0, bs0,
-          dof_transform_to_transpose, dofs1, bs1, bc0, bc1, fn, coeffs, cstride,
-          constants, cell_info, get_perm);
+      if (num_threads > 1 and !facets.empty())
+      {
+        std::vector<std::int32_t> facet_cells(facets.size());
+        std::transform(facets.begin(), facets.end(), facet_cells.begin(),
+                       [](const auto& f) { return f.first; });
+        impl::assemble_coloured<T, std::pair<std::int32_t, int>>(
+            mesh->topology(), xtl::span(facets), facet_cells, 1, coeffs,
+            cstride,
+            [&](const xtl::span<const std::pair<std::int32_t, int>>&
+                    facets_range,
+                const xtl::span<const T>& coeffs_range)
+            {
+              impl::assemble_exterior_facets<T>(
+                  mat_set, *mesh, facets_range, dof_transform, dofs0, bs0,
+                  dof_transform_to_transpose, dofs1, bs1, bc0, bc1, fn,
+                  coeffs_range, cstride, constants, cell_info, get_perm);
+            });
+      }
+      else
+      {
+        impl::assemble_exterior_facets<T>(
+            mat_set, *mesh, facets, dof_transform, dofs0, bs0,
+            dof_transform_to_transpose, dofs1, bs1, bc0, bc1, fn, coeffs,
+            cstride, constants, cell_info, get_perm);
+      }
     }
 
     const std::vector<int> c_offsets = a.coefficient_offsets();
@@ -482,14 +984,551 @@ void assemble_matrix(
       const auto& fn = a.kernel(IntegralType::interior_facet, i);
       const auto& [coeffs, cstride]
           = coefficients.at({IntegralType::interior_facet, i});
-      const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
-          facets
-          = a.interior_facet_domains(i);
-      impl::assemble_interior_facets<T>(
-          mat_set, *mesh, facets, dof_transform, *dofmap0, bs0,
-          dof_transform_to_transpose, *dofmap1, bs1, bc0, bc1, fn, coeffs,
-          cstride, c_offsets, constants, cell_info, get_perm);
+      const std::vector<InteriorFacetData>& facets
+          = a.interior_facet_assembly_data(i);
+      if (num_threads > 1 and !facets.empty())
+      {
+        std::vector<std::int32_t> facet_cells(2 * facets.size());
+        for (std::size_t f = 0; f < facets.size(); ++f)
+        {
+          facet_cells[2 * f] = facets[f].cells[0];
+          facet_cells[2 * f + 1] = facets[f].cells[1];
+        }
+        impl::assemble_coloured<T, InteriorFacetData>(
+            mesh->topology(), xtl::span(facets), facet_cells, 2, coeffs,
+            cstride,
+            [&](const xtl::span<const InteriorFacetData>& facets_range,
+                const xtl::span<const T>& coeffs_range)
+            {
+              impl::assemble_interior_facets<T>(
+                  mat_set, *mesh, facets_range, dof_transform, *dofmap0, bs0,
+                  dof_transform_to_transpose, *dofmap1, bs1, bc0, bc1, fn,
+                  coeffs_range, cstride, c_offsets, constants, cell_info);
+            });
+      }
+      else
+      {
+        impl::assemble_interior_facets<T>(
+            mat_set, *mesh, facets, dof_transform, *dofmap0, bs0,
+            dof_transform_to_transpose, *dofmap1, bs1, bc0, bc1, fn, coeffs,
+            cstride, c_offsets, constants, cell_info);
+      }
+    }
+  }
+}
+
+template <typename T>
+void assemble_matrix(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set,
+    const Form<T>& a, const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  std::shared_ptr<const fem::FiniteElement> element0
+      = a.function_spaces().at(0)->element();
+  std::shared_ptr<const fem::FiniteElement> element1
+      = a.function_spaces().at(1)->element();
+
+  const bool needs_transformation_data
+      = element0->needs_dof_transformations()
+        or element1->needs_dof_transformations()
+        or a.needs_facet_permutations();
+  xtl::span<const std::uint32_t> cell_info;
+  if (needs_transformation_data)
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  // Select the dof transformation instantiation once per form: for
+  // transformation-free elements (e.g. Lagrange) an empty no-op functor
+  // is passed, so the transformation calls vanish from the generated
+  // assembly loops
+  if (element0->needs_dof_transformations()
+      or element1->needs_dof_transformations())
+  {
+    assemble_matrix(
+        mat_set, a, constants, coefficients, bc0, bc1,
+        element0->get_dof_transformation_function<T>(),
+        element1->get_dof_transformation_to_transpose_function<T>(),
+        cell_info);
+  }
+  else
+  {
+    const auto noop
+        = [](const xtl::span<T>&, const xtl::span<const std::uint32_t>&,
+             std::int32_t, int)
+    {
+      // Do nothing
+    };
+    assemble_matrix(mat_set, a, constants, coefficients, bc0, bc1, noop, noop,
+                    cell_info);
+  }
+}
+
+/// Assemble the cell integrals of a bilinear form against an ensemble
+/// of packed coefficient sets with the dof transformations supplied as
+/// generic callables; see assemble_matrix_ensemble below.
+template <typename T, typename Transform0, typename Transform1>
+void assemble_matrix_ensemble(
+    const std::vector<std::function<int(std::int32_t, const std::int32_t*,
+                                        std::int32_t, const std::int32_t*,
+                                        const T*)>>& mat_set,
+    const Form<T>& a, const xtl::span<const T>& constants,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<xtl::span<const T>, int>>>&
+        coefficients,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const Transform0& dof_transform,
+    const Transform1& dof_transform_to_transpose,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  // Get dofmap data
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const int bs0 = dofmap0->bs();
+  const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+  const int bs1 = dofmap1->bs();
+
+  for (int i : a.integral_ids(IntegralType::cell))
+  {
+    const auto& fn = a.kernel(IntegralType::cell, i);
+    const std::vector<std::int32_t>& cells = a.cell_domains(i);
+
+    // Collect the packed coefficients of every sample for this
+    // integral. The layout (cstride) is a property of the form, so it
+    // is identical for all samples.
+    const int cstride = coefficients.front().at({IntegralType::cell, i}).second;
+    std::vector<xtl::span<const T>> coeffs;
+    coeffs.reserve(coefficients.size());
+    for (const auto& coefficients_s : coefficients)
+    {
+      const auto& [c, stride] = coefficients_s.at({IntegralType::cell, i});
+      assert(stride == cstride);
+      coeffs.push_back(c);
+    }
+
+    assemble_cells_ensemble(mat_set, mesh->geometry(), cells, dof_transform,
+                            dofs0, bs0, dof_transform_to_transpose, dofs1, bs1,
+                            bc0, bc1, fn, coeffs, cstride, constants,
+                            cell_info);
+  }
+}
+
+/// Assemble a bilinear form against an ensemble of packed coefficient
+/// sets in a single cell sweep, emitting sample s through mat_set[s].
+/// The form must have cell integrals only.
+/// @param[in] mat_set The matrix insertion functions, one per sample
+/// @param[in] a The bilinear form
+/// @param[in] constants Packed constants that appear in `a` (shared by
+/// all samples)
+/// @param[in] coefficients Packed coefficients that appear in `a`, one
+/// set per sample
+/// @param[in] bc0 Boundary condition markers for the rows
+/// @param[in] bc1 Boundary condition markers for the columns
+template <typename T>
+void assemble_matrix_ensemble(
+    const std::vector<std::function<int(std::int32_t, const std::int32_t*,
+                                        std::int32_t, const std::int32_t*,
+                                        const T*)>>& mat_set,
+    const Form<T>& a, const xtl::span<const T>& constants,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<xtl::span<const T>, int>>>&
+        coefficients,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1)
+{
+  assert(mat_set.size() == coefficients.size());
+  if (a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    throw std::runtime_error(
+        "Ensemble assembly supports cell integrals only.");
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  std::shared_ptr<const fem::FiniteElement> element0
+      = a.function_spaces().at(0)->element();
+  std::shared_ptr<const fem::FiniteElement> element1
+      = a.function_spaces().at(1)->element();
+
+  xtl::span<const std::uint32_t> cell_info;
+  if (element0->needs_dof_transformations()
+      or element1->needs_dof_transformations())
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+    assemble_matrix_ensemble(
+        mat_set, a, constants, coefficients, bc0, bc1,
+        element0->get_dof_transformation_function<T>(),
+        element1->get_dof_transformation_to_transpose_function<T>(),
+        cell_info);
+  }
+  else
+  {
+    const auto noop
+        = [](const xtl::span<T>&, const xtl::span<const std::uint32_t>&,
+             std::int32_t, int)
+    {
+      // Do nothing
+    };
+    assemble_matrix_ensemble(mat_set, a, constants, coefficients, bc0, bc1,
+                             noop, noop, cell_info);
+  }
+}
+
+/// Re-assemble the cell integrals of a bilinear form into a CSR matrix
+/// through a precomputed element-to-CSR offset map (see
+/// fem::create_element_csr_map). The form must have cell integrals
+/// only. The matrix is not zeroed.
+template <typename T>
+void assemble_matrix_refill(
+    la::MatrixCSR<T>& A, const Form<T>& a,
+    const xtl::span<const std::int64_t>& element_map,
+    const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients)
+{
+  if (a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0
+      or a.num_integrals(IntegralType::vertex) > 0)
+  {
+    throw std::runtime_error(
+        "Refill assembly supports cell integrals only.");
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  const int ndim0 = dofmap0->bs() * dofmap0->list().links(0).size();
+  const int ndim1 = dofmap1->bs() * dofmap1->list().links(0).size();
+
+  std::shared_ptr<const fem::FiniteElement> element0
+      = a.function_spaces().at(0)->element();
+  std::shared_ptr<const fem::FiniteElement> element1
+      = a.function_spaces().at(1)->element();
+  const bool needs_transformation_data
+      = element0->needs_dof_transformations()
+        or element1->needs_dof_transformations();
+  xtl::span<const std::uint32_t> cell_info;
+  if (needs_transformation_data)
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  const int num_threads = dolfinx::common::num_threads();
+  for (int i : a.integral_ids(IntegralType::cell))
+  {
+    const auto& fn = a.kernel(IntegralType::cell, i);
+    const auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, i});
+    const std::vector<std::int32_t>& cells = a.cell_domains(i);
+
+    auto assemble_range = [&](const xtl::span<const std::int32_t>& cells_range,
+                              const xtl::span<const T>& coeffs_range)
+    {
+      // Select the dof transformation instantiation (see
+      // assemble_matrix above)
+      if (needs_transformation_data)
+      {
+        assemble_cells_refill<T>(
+            A, element_map, mesh->geometry(), cells_range,
+            element0->get_dof_transformation_function<T>(),
+            element1->get_dof_transformation_to_transpose_function<T>(), ndim0,
+            ndim1, fn, coeffs_range, cstride, constants, cell_info);
+      }
+      else
+      {
+        const auto noop
+            = [](const xtl::span<T>&, const xtl::span<const std::uint32_t>&,
+                 std::int32_t, int)
+        {
+          // Do nothing
+        };
+        assemble_cells_refill<T>(A, element_map, mesh->geometry(), cells_range,
+                                 noop, noop, ndim0, ndim1, fn, coeffs_range,
+                                 cstride, constants, cell_info);
+      }
+    };
+
+    if (num_threads > 1 and !cells.empty())
+    {
+      impl::assemble_coloured<T, std::int32_t>(
+          mesh->topology(), xtl::span<const std::int32_t>(cells), cells, 1,
+          coeffs, cstride, assemble_range);
+    }
+    else
+      assemble_range(cells, coeffs);
+  }
+}
+
+/// Execute the bilinear and the linear form kernel over cells in a
+/// single sweep, accumulating the results in the matrix and the vector.
+/// The geometry gather is shared between the two kernels and the
+/// coefficients of both forms are packed in one per-cell block (the
+/// bilinear form block first, `cstride_a` entries, followed by the
+/// linear form block, `cstride_L` entries). The forms must share the
+/// test space, so `dofmap0` applies to both.
+template <typename T, typename Transform0, typename Transform1>
+void assemble_matrix_vector_cells(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set,
+    xtl::span<T> b, const mesh::Geometry& geometry,
+    const xtl::span<const std::int32_t>& cells,
+    const Transform0& dof_transform,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const Transform1& dof_transform_to_transpose,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel_a,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel_L,
+    const xtl::span<const T>& coeffs, int cstride_a, int cstride_L,
+    const xtl::span<const T>& constants_a, const xtl::span<const T>& constants_L,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  // Prepare cell geometry
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+
+  const int num_dofs0 = dofmap0.links(0).size();
+  const int num_dofs1 = dofmap1.links(0).size();
+  const int ndim0 = bs0 * num_dofs0;
+  const int ndim1 = bs1 * num_dofs1;
+  const int cstride = cstride_a + cstride_L;
+
+  // Scratch buffers, reused across assembly calls (see ScratchArena)
+  common::ScratchArena::Frame scratch;
+  const xtl::span<T> Ae = scratch.allocate<T>(ndim0 * ndim1);
+  const xtl::span<T> _Ae(Ae);
+  const xtl::span<T> be = scratch.allocate<T>(ndim0);
+  const xtl::span<T> _be(be);
+  const xtl::span<double> coordinate_dofs
+      = scratch.allocate<double>(3 * num_dofs_g);
+
+  // Iterate over active cells
+  for (std::size_t index = 0; index < cells.size(); ++index)
+  {
+    std::int32_t c = cells[index];
+
+    // Get cell coordinates/geometry (shared by both kernels)
+    auto x_dofs = x_dofmap.links(c);
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                  std::next(coordinate_dofs.begin(), 3 * i));
+    }
+
+    const T* coeff_cell = coeffs.data() + index * cstride;
+
+    // Tabulate matrix for cell
+    std::fill(Ae.begin(), Ae.end(), 0);
+    kernel_a(Ae.data(), coeff_cell, constants_a.data(),
+             coordinate_dofs.data(), nullptr, nullptr);
+    dof_transform(_Ae, cell_info, c, ndim1);
+    dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
+
+    // Tabulate vector for cell
+    std::fill(be.begin(), be.end(), 0);
+    kernel_L(be.data(), coeff_cell + cstride_a, constants_L.data(),
+             coordinate_dofs.data(), nullptr, nullptr);
+    dof_transform(_be, cell_info, c, 1);
+
+    // Zero rows/columns for essential bcs
+    auto dofs0 = dofmap0.links(c);
+    auto dofs1 = dofmap1.links(c);
+    if (!bc0.empty())
+    {
+      for (int i = 0; i < num_dofs0; ++i)
+      {
+        for (int k = 0; k < bs0; ++k)
+        {
+          if (bc0[bs0 * dofs0[i] + k])
+          {
+            // Zero row bs0 * i + k
+            const int row = bs0 * i + k;
+            std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
+          }
+        }
+      }
+    }
+
+    if (!bc1.empty())
+    {
+      for (int j = 0; j < num_dofs1; ++j)
+      {
+        for (int k = 0; k < bs1; ++k)
+        {
+          if (bc1[bs1 * dofs1[j] + k])
+          {
+            // Zero column bs1 * j + k
+            const int col = bs1 * j + k;
+            for (int row = 0; row < ndim0; ++row)
+              Ae[row * ndim1 + col] = 0.0;
+          }
+        }
+      }
     }
+
+    mat_set(dofs0.size(), dofs0.data(), dofs1.size(), dofs1.data(), Ae.data());
+
+    // Scatter cell vector to 'global' vector array
+    for (int i = 0; i < num_dofs0; ++i)
+      for (int k = 0; k < bs0; ++k)
+        b[bs0 * dofs0[i] + k] += be[bs0 * i + k];
+  }
+}
+
+/// Assemble the bilinear form a into a matrix and the linear form L
+/// into a vector in a single sweep over cells. This avoids the second
+/// pass over the mesh (and second geometry gather) that separate
+/// assemble_matrix/assemble_vector calls perform, e.g. in a Newton
+/// iteration where the Jacobian and the residual are built over the
+/// same cells. Both forms must be defined over cell integrals only,
+/// with identical cell domains, and must share the test space. Rows
+/// (bc0) and columns (bc1) of the matrix with Dirichlet conditions are
+/// zeroed; the vector is not modified by the bcs.
+template <typename T>
+void assemble_matrix_vector(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set,
+    xtl::span<T> b, const Form<T>& a, const Form<T>& L,
+    const xtl::span<const T>& constants_a,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients_a,
+    const xtl::span<const T>& constants_L,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients_L,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+  assert(L.mesh() == mesh);
+
+  if (a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0
+      or L.num_integrals(IntegralType::exterior_facet) > 0
+      or L.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    throw std::runtime_error("Fused matrix and vector assembly supports cell "
+                             "integrals only.");
+  }
+  if (a.integral_ids(IntegralType::cell) != L.integral_ids(IntegralType::cell))
+  {
+    throw std::runtime_error(
+        "Bilinear and linear forms must have the same cell integral domains "
+        "for fused matrix and vector assembly.");
+  }
+
+  // Get dofmap data (L shares the test space of a)
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const int bs0 = dofmap0->bs();
+  const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+  const int bs1 = dofmap1->bs();
+
+  std::shared_ptr<const fem::FiniteElement> element0
+      = a.function_spaces().at(0)->element();
+  std::shared_ptr<const fem::FiniteElement> element1
+      = a.function_spaces().at(1)->element();
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>& dof_transform
+      = element0->get_dof_transformation_function<T>();
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>& dof_transform_to_transpose
+      = element1->get_dof_transformation_to_transpose_function<T>();
+
+  const bool needs_transformation_data
+      = element0->needs_dof_transformations()
+        or element1->needs_dof_transformations();
+  xtl::span<const std::uint32_t> cell_info;
+  if (needs_transformation_data)
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  const int num_threads = dolfinx::common::num_threads();
+  for (int i : a.integral_ids(IntegralType::cell))
+  {
+    const auto& kernel_a = a.kernel(IntegralType::cell, i);
+    const auto& kernel_L = L.kernel(IntegralType::cell, i);
+    const auto& [coeffs_a, cstride_a]
+        = coefficients_a.at({IntegralType::cell, i});
+    const auto& [coeffs_L, cstride_L]
+        = coefficients_L.at({IntegralType::cell, i});
+    const std::vector<std::int32_t>& cells = a.cell_domains(i);
+    if (L.cell_domains(i) != cells)
+    {
+      throw std::runtime_error(
+          "Bilinear and linear forms must have the same cell integral "
+          "domains for fused matrix and vector assembly.");
+    }
+
+    // Pack the coefficients of both forms in one per-cell block so
+    // that each cell touches a single contiguous coefficient range
+    const int cstride = cstride_a + cstride_L;
+    std::vector<T> coeffs(cells.size() * cstride);
+    for (std::size_t c = 0; c < cells.size(); ++c)
+    {
+      std::copy_n(std::next(coeffs_a.begin(), c * cstride_a), cstride_a,
+                  std::next(coeffs.begin(), c * cstride));
+      std::copy_n(std::next(coeffs_L.begin(), c * cstride_L), cstride_L,
+                  std::next(coeffs.begin(), c * cstride + cstride_a));
+    }
+
+    auto assemble_range = [&](const xtl::span<const std::int32_t>& cells_range,
+                              const xtl::span<const T>& coeffs_range)
+    {
+      impl::assemble_matrix_vector_cells<T>(
+          mat_set, b, mesh->geometry(), cells_range, dof_transform, dofs0, bs0,
+          dof_transform_to_transpose, dofs1, bs1, bc0, bc1, kernel_a, kernel_L,
+          coeffs_range, cstride_a, cstride_L, constants_a, constants_L,
+          cell_info);
+    };
+
+    // Cells of one colour touch disjoint matrix and vector rows, so
+    // the coloured driver can run the fused kernel concurrently
+    if (num_threads > 1 and !cells.empty())
+    {
+      impl::assemble_coloured<T, std::int32_t>(
+          mesh->topology(), xtl::span<const std::int32_t>(cells), cells, 1,
+          xtl::span<const T>(coeffs), cstride, assemble_range);
+    }
+    else
+      assemble_range(cells, coeffs);
   }
 }
 
@@ -11,6 +11,8 @@
 #include "FunctionSpace.h"
 #include "utils.h"
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
@@ -30,7 +32,8 @@ T assemble_cells(const mesh::Geometry& geometry,
                  const xtl::span<const T>& coeffs, int cstride)
 {
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
@@ -61,6 +64,48 @@ T assemble_cells(const mesh::Geometry& geometry,
   return value;
 }
 
+/// Assemble functional over cells on the shared thread pool. Each
+/// task accumulates a fixed contiguous chunk of cells and the chunk
+/// partials are combined with a pairwise tree reduction in chunk
+/// order, so the result is deterministic for a given thread count.
+template <typename T>
+T assemble_cells_threaded(
+    const mesh::Geometry& geometry, const xtl::span<const std::int32_t>& cells,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& fn,
+    const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
+    int cstride)
+{
+  common::ThreadPool& pool = common::thread_pool();
+  const int num_threads = pool.num_workers() + 1;
+  std::vector<T> partial(num_threads, 0);
+  {
+    common::ThreadPool::TaskGroup tasks(pool);
+    for (int t = 0; t < num_threads; ++t)
+    {
+      const std::size_t begin = (cells.size() * t) / num_threads;
+      const std::size_t end = (cells.size() * (t + 1)) / num_threads;
+      if (begin == end)
+        continue;
+      tasks.run(
+          [&, t, begin, end]()
+          {
+            partial[t] = assemble_cells<T>(
+                geometry, cells.subspan(begin, end - begin), fn, constants,
+                coeffs.subspan(begin * cstride, (end - begin) * cstride),
+                cstride);
+          });
+    }
+  }
+
+  // Pairwise tree reduction of the chunk partials
+  for (int step = 1; step < num_threads; step *= 2)
+    for (int i = 0; i + step < num_threads; i += 2 * step)
+      partial[i] += partial[i + step];
+
+  return partial[0];
+}
+
 /// Execute kernel over exterior facets and accumulate result
 template <typename T>
 T assemble_exterior_facets(
@@ -74,7 +119,8 @@ T assemble_exterior_facets(
   const int tdim = mesh.topology().dim();
 
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = mesh.geometry().dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
@@ -112,19 +158,15 @@ T assemble_exterior_facets(
 /// Assemble functional over interior facets
 template <typename T>
 T assemble_interior_facets(
-    const mesh::Mesh& mesh,
-    const xtl::span<const std::tuple<std::int32_t, int, std::int32_t, int>>&
-        facets,
+    const mesh::Mesh& mesh, const xtl::span<const InteriorFacetData>& facets,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& fn,
     const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
-    int cstride, const xtl::span<const int>& offsets,
-    const xtl::span<const std::uint8_t>& perms)
+    int cstride, const xtl::span<const int>& offsets)
 {
-  const int tdim = mesh.topology().dim();
-
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = mesh.geometry().dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
@@ -135,17 +177,12 @@ T assemble_interior_facets(
   std::vector<T> coeff_array(2 * offsets.back());
   assert(offsets.back() == cstride);
 
-  const int num_cell_facets
-      = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
-
   // Iterate over all facets
   T value = 0;
   for (std::size_t index = 0; index < facets.size(); ++index)
   {
-    const std::array<std::int32_t, 2> cells
-        = {std::get<0>(facets[index]), std::get<2>(facets[index])};
-    const std::array<int, 2> local_facet
-        = {std::get<1>(facets[index]), std::get<3>(facets[index])};
+    const std::array<std::int32_t, 2>& cells = facets[index].cells;
+    const std::array<int, 2>& local_facet = facets[index].local_facet;
 
     // Get cell geometry
     auto x_dofs0 = x_dofmap.links(cells[0]);
@@ -161,10 +198,8 @@ T assemble_interior_facets(
                   xt::view(coordinate_dofs, 1, i, xt::all()).begin());
     }
 
-    const std::array perm{perms[cells[0] * num_cell_facets + local_facet[0]],
-                          perms[cells[1] * num_cell_facets + local_facet[1]]};
     fn(&value, coeffs.data() + index * 2 * cstride, constants.data(),
-       coordinate_dofs.data(), local_facet.data(), perm.data());
+       coordinate_dofs.data(), local_facet.data(), facets[index].perm.data());
   }
 
   return value;
@@ -186,8 +221,16 @@ T assemble_scalar(
     const auto& fn = M.kernel(IntegralType::cell, i);
     const auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, i});
     const std::vector<std::int32_t>& cells = M.cell_domains(i);
-    value += impl::assemble_cells(mesh->geometry(), cells, fn, constants,
-                                  coeffs, cstride);
+    if (dolfinx::common::num_threads() > 1 and !cells.empty())
+    {
+      value += impl::assemble_cells_threaded<T>(mesh->geometry(), cells, fn,
+                                                constants, coeffs, cstride);
+    }
+    else
+    {
+      value += impl::assemble_cells(mesh->geometry(), cells, fn, constants,
+                                    coeffs, cstride);
+    }
   }
 
   if (M.num_integrals(IntegralType::exterior_facet) > 0
@@ -215,12 +258,10 @@ T assemble_scalar(
       const auto& fn = M.kernel(IntegralType::interior_facet, i);
       const auto& [coeffs, cstride]
           = coefficients.at({IntegralType::interior_facet, i});
-      const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
-          facets
-          = M.interior_facet_domains(i);
+      const std::vector<InteriorFacetData>& facets
+          = M.interior_facet_assembly_data(i);
       value += impl::assemble_interior_facets(*mesh, facets, fn, constants,
-                                              coeffs, cstride,
-                                              c_offsets, perms);
+                                              coeffs, cstride, c_offsets);
     }
   }
 
@@ -12,7 +12,9 @@
 #include "Form.h"
 #include "FunctionSpace.h"
 #include "utils.h"
+#include <algorithm>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/ScratchArena.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
@@ -41,14 +43,15 @@ void _lift_bc_cells(
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& kernel,
     const xtl::span<const std::int32_t>& cells,
+    const xtl::span<const std::int32_t>& active,
     const std::function<void(const xtl::span<T>&,
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform,
-    const graph::AdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap0, int bs0,
     const std::function<void(const xtl::span<T>&,
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform_to_transpose,
-    const graph::AdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap1, int bs1,
     const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
     int cstride, const xtl::span<const std::uint32_t>& cell_info,
     const xtl::span<const T>& bc_values1, const std::vector<bool>& bc_markers1,
@@ -58,16 +61,19 @@ void _lift_bc_cells(
   assert(_bs1 < 0 or _bs1 == bs1);
 
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = geometry.x();
 
-  // Data structures used in bc application
+  // Data structures used in bc application. Only the preselected
+  // positions in the cell list are visited; coefficients are packed by
+  // position in the full list.
   std::vector<double> coordinate_dofs(3 * num_dofs_g);
   std::vector<T> Ae, be;
-  for (std::size_t index = 0; index < cells.size(); ++index)
+  for (std::int32_t index : active)
   {
     std::int32_t c = cells[index];
 
@@ -200,11 +206,11 @@ void _lift_bc_exterior_facets(
     const std::function<void(const xtl::span<T>&,
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform,
-    const graph::AdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap0, int bs0,
     const std::function<void(const xtl::span<T>&,
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform_to_transpose,
-    const graph::AdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap1, int bs1,
     const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
     int cstride, const xtl::span<const std::uint32_t>& cell_info,
     const std::function<std::uint8_t(std::size_t)>& get_perm,
@@ -214,7 +220,8 @@ void _lift_bc_exterior_facets(
   const int tdim = mesh.topology().dim();
 
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = mesh.geometry().dofmap_fixed();
 
   const int num_cell_facets
       = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
@@ -311,35 +318,29 @@ void _lift_bc_interior_facets(
     xtl::span<T> b, const mesh::Mesh& mesh,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& kernel,
-    const xtl::span<const std::tuple<std::int32_t, int, std::int32_t, int>>&
-        facets,
+    const xtl::span<const InteriorFacetData>& facets,
     const std::function<void(const xtl::span<T>&,
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform,
-    const graph::AdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap0, int bs0,
     const std::function<void(const xtl::span<T>&,
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform_to_transpose,
-    const graph::AdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap1, int bs1,
     const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
     int cstride, const std::vector<int>& offsets,
     const xtl::span<const std::uint32_t>& cell_info,
-    const std::function<std::uint8_t(std::size_t)>& get_perm,
     const xtl::span<const T>& bc_values1, const std::vector<bool>& bc_markers1,
     const xtl::span<const T>& x0, double scale)
 {
-  const int tdim = mesh.topology().dim();
-
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = mesh.geometry().dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
 
-  const int num_cell_facets
-      = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
-
   // Data structures used in assembly
   xt::xtensor<double, 3> coordinate_dofs({2, num_dofs_g, 3});
   std::vector<T> coeff_array(2 * offsets.back());
@@ -351,10 +352,8 @@ void _lift_bc_interior_facets(
 
   for (std::size_t index = 0; index < facets.size(); ++index)
   {
-    const std::array<std::int32_t, 2> cells
-        = {std::get<0>(facets[index]), std::get<2>(facets[index])};
-    const std::array<int, 2> local_facet
-        = {std::get<1>(facets[index]), std::get<3>(facets[index])};
+    const std::array<std::int32_t, 2>& cells = facets[index].cells;
+    const std::array<int, 2>& local_facet = facets[index].local_facet;
 
     // Get cell geometry
     auto x_dofs0 = x_dofmap.links(cells[0]);
@@ -421,11 +420,9 @@ void _lift_bc_interior_facets(
     // Tabulate tensor
     Ae.resize(num_rows * num_cols);
     std::fill(Ae.begin(), Ae.end(), 0);
-    const std::array perm{
-        get_perm(cells[0] * num_cell_facets + local_facet[0]),
-        get_perm(cells[1] * num_cell_facets + local_facet[1])};
     kernel(Ae.data(), coeffs.data() + index * 2 * cstride, constants.data(),
-           coordinate_dofs.data(), local_facet.data(), perm.data());
+           coordinate_dofs.data(), local_facet.data(),
+           facets[index].perm.data());
 
     const xtl::span<T> _Ae(Ae);
 
@@ -497,14 +494,12 @@ void _lift_bc_interior_facets(
 /// less than zero the block size is determined at runtime. If `_bs` is
 /// positive the block size is used as a compile-time constant, which
 /// has performance benefits.
-template <typename T, int _bs = -1>
+template <typename T, int _bs = -1, typename Transform>
 void assemble_cells(
-    const std::function<void(const xtl::span<T>&,
-                             const xtl::span<const std::uint32_t>&,
-                             std::int32_t, int)>& dof_transform,
-    xtl::span<T> b, const mesh::Geometry& geometry,
+    const Transform& dof_transform, xtl::span<T> b,
+    const mesh::Geometry& geometry,
     const xtl::span<const std::int32_t>& cells,
-    const graph::AdjacencyList<std::int32_t>& dofmap, int bs,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap, int bs,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& kernel,
     const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
@@ -513,7 +508,8 @@ void assemble_cells(
   assert(_bs < 0 or _bs == bs);
 
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const int num_dofs_g = x_dofmap.num_links(0);
@@ -522,8 +518,10 @@ void assemble_cells(
   // FIXME: Add proper interface for num_dofs
   // Create data structures used in assembly
   const int num_dofs = dofmap.links(0).size();
-  std::vector<double> coordinate_dofs(3 * num_dofs_g);
-  std::vector<T> be(bs * num_dofs);
+  common::ScratchArena::Frame scratch;
+  const xtl::span<double> coordinate_dofs
+      = scratch.allocate<double>(3 * num_dofs_g);
+  const xtl::span<T> be = scratch.allocate<T>(bs * num_dofs);
   const xtl::span<T> _be(be);
 
   // Iterate over active cells
@@ -562,20 +560,85 @@ void assemble_cells(
   }
 }
 
+/// Execute kernel over cells once for an ensemble of packed
+/// coefficient sets, accumulating sample s into b[s]. The geometry
+/// gather and the dof lookups are performed once per cell and re-used
+/// for every sample, so the mesh-side memory traffic is amortized
+/// across the ensemble and the inner sample loop runs from cache.
+template <typename T, typename Transform>
+void assemble_cells_ensemble(
+    const Transform& dof_transform, const std::vector<xtl::span<T>>& b,
+    const mesh::Geometry& geometry,
+    const xtl::span<const std::int32_t>& cells,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap, int bs,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel,
+    const xtl::span<const T>& constants,
+    const std::vector<xtl::span<const T>>& coeffs, int cstride,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  const std::size_t num_samples = b.size();
+  assert(coeffs.size() == num_samples);
+
+  // Prepare cell geometry
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const int num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+
+  // FIXME: Add proper interface for num_dofs
+  // Create data structures used in assembly
+  const int num_dofs = dofmap.links(0).size();
+  common::ScratchArena::Frame scratch;
+  const xtl::span<double> coordinate_dofs
+      = scratch.allocate<double>(3 * num_dofs_g);
+  const xtl::span<T> be = scratch.allocate<T>(bs * num_dofs);
+  const xtl::span<T> _be(be);
+
+  // Iterate over active cells
+  for (std::size_t index = 0; index < cells.size(); ++index)
+  {
+    std::int32_t c = cells[index];
+
+    // Get cell coordinates/geometry (once for all samples)
+    auto x_dofs = x_dofmap.links(c);
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                  std::next(coordinate_dofs.begin(), 3 * i));
+    }
+    auto dofs = dofmap.links(c);
+
+    for (std::size_t s = 0; s < num_samples; ++s)
+    {
+      // Tabulate vector for cell
+      std::fill(be.begin(), be.end(), 0);
+      kernel(be.data(), coeffs[s].data() + index * cstride, constants.data(),
+             coordinate_dofs.data(), nullptr, nullptr);
+      dof_transform(_be, cell_info, c, 1);
+
+      // Scatter cell vector to sample s of the ensemble
+      const xtl::span<T>& _b = b[s];
+      for (int i = 0; i < num_dofs; ++i)
+        for (int k = 0; k < bs; ++k)
+          _b[bs * dofs[i] + k] += be[bs * i + k];
+    }
+  }
+}
+
 /// Execute kernel over cells and accumulate result in vector
 /// @tparam T The scalar type
 /// @tparam _bs The block size of the form test function dof map. If
 /// less than zero the block size is determined at runtime. If `_bs` is
 /// positive the block size is used as a compile-time constant, which
 /// has performance benefits.
-template <typename T, int _bs = -1>
+template <typename T, int _bs = -1, typename Transform>
 void assemble_exterior_facets(
-    const std::function<void(const xtl::span<T>&,
-                             const xtl::span<const std::uint32_t>&,
-                             std::int32_t, int)>& dof_transform,
-    xtl::span<T> b, const mesh::Mesh& mesh,
+    const Transform& dof_transform, xtl::span<T> b, const mesh::Mesh& mesh,
     const xtl::span<const std::pair<std::int32_t, int>>& facets,
-    const graph::AdjacencyList<std::int32_t>& dofmap, int bs,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap, int bs,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& fn,
     const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
@@ -587,7 +650,8 @@ void assemble_exterior_facets(
   const int tdim = mesh.topology().dim();
 
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = mesh.geometry().dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
@@ -599,8 +663,10 @@ void assemble_exterior_facets(
   // FIXME: Add proper interface for num_dofs
   // Create data structures used in assembly
   const int num_dofs = dofmap.links(0).size();
-  std::vector<double> coordinate_dofs(3 * num_dofs_g);
-  std::vector<T> be(bs * num_dofs);
+  common::ScratchArena::Frame scratch;
+  const xtl::span<double> coordinate_dofs
+      = scratch.allocate<double>(3 * num_dofs_g);
+  const xtl::span<T> be = scratch.allocate<T>(bs * num_dofs);
   const xtl::span<T> _be(be);
 
   for (std::size_t index = 0; index < facets.size(); ++index)
@@ -647,26 +713,20 @@ void assemble_exterior_facets(
 /// less than zero the block size is determined at runtime. If `_bs` is
 /// positive the block size is used as a compile-time constant, which
 /// has performance benefits.
-template <typename T, int _bs = -1>
+template <typename T, int _bs = -1, typename Transform>
 void assemble_interior_facets(
-    const std::function<void(const xtl::span<T>&,
-                             const xtl::span<const std::uint32_t>&,
-                             std::int32_t, int)>& dof_transform,
-    xtl::span<T> b, const mesh::Mesh& mesh,
-    const xtl::span<const std::tuple<std::int32_t, int, std::int32_t, int>>&
-        facets,
+    const Transform& dof_transform, xtl::span<T> b, const mesh::Mesh& mesh,
+    const xtl::span<const InteriorFacetData>& facets,
     const fem::DofMap& dofmap,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& fn,
     const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
     int cstride, const xtl::span<const int>& offsets,
-    const xtl::span<const std::uint32_t>& cell_info,
-    const std::function<std::uint8_t(std::size_t)>& get_perm)
+    const xtl::span<const std::uint32_t>& cell_info)
 {
-  const int tdim = mesh.topology().dim();
-
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = mesh.geometry().dofmap_fixed();
 
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
@@ -677,17 +737,12 @@ void assemble_interior_facets(
   std::vector<T> be;
   assert(offsets.back() == cstride);
 
-  const int num_cell_facets
-      = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
-
   const int bs = dofmap.bs();
   assert(_bs < 0 or _bs == bs);
   for (std::size_t index = 0; index < facets.size(); ++index)
   {
-    const std::array<std::int32_t, 2> cells
-        = {std::get<0>(facets[index]), std::get<2>(facets[index])};
-    const std::array<int, 2> local_facet
-        = {std::get<1>(facets[index]), std::get<3>(facets[index])};
+    const std::array<std::int32_t, 2>& cells = facets[index].cells;
+    const std::array<int, 2>& local_facet = facets[index].local_facet;
 
     // Get cell geometry
     auto x_dofs0 = x_dofmap.links(cells[0]);
@@ -710,11 +765,9 @@ void assemble_interior_facets(
     // Tabulate element vector
     be.resize(bs * (dmap0.size() + dmap1.size()));
     std::fill(be.begin(), be.end(), 0);
-    const std::array perm{
-        get_perm(cells[0] * num_cell_facets + local_facet[0]),
-        get_perm(cells[1] * num_cell_facets + local_facet[1])};
     fn(be.data(), coeffs.data() + index * 2 * cstride, constants.data(),
-       coordinate_dofs.data(), local_facet.data(), perm.data());
+       coordinate_dofs.data(), local_facet.data(),
+       facets[index].perm.data());
 
     const xtl::span<T> _be(be);
     const xtl::span<T> sub_be
@@ -756,6 +809,10 @@ void assemble_interior_facets(
 /// @param[in] bc_values1 The boundary condition 'values'
 /// @param[in] bc_markers1 The indices (columns of A, rows of x) to
 /// which bcs belong
+/// @param[in] lift_cells Sorted list of cells with at least one
+/// constrained trial dof. Cell integral contributions are assembled
+/// only over these cells; all other cells produce a zero element
+/// vector and are skipped.
 /// @param[in] x0 The array used in the lifting, typically a 'current
 /// solution' in a Newton method
 /// @param[in] scale Scaling to apply
@@ -765,8 +822,9 @@ void lift_bc(xtl::span<T> b, const Form<T>& a,
              const std::map<std::pair<IntegralType, int>,
                             std::pair<xtl::span<const T>, int>>& coefficients,
              const xtl::span<const T>& bc_values1,
-             const std::vector<bool>& bc_markers1, const xtl::span<const T>& x0,
-             double scale)
+             const std::vector<bool>& bc_markers1,
+             const std::vector<std::int32_t>& lift_cells,
+             const xtl::span<const T>& x0, double scale)
 {
   std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
   assert(mesh);
@@ -811,27 +869,57 @@ void lift_bc(xtl::span<T> b, const Form<T>& a,
   {
     const auto& kernel = a.kernel(IntegralType::cell, i);
     const auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, i});
+
+    // Restrict the sweep to positions in the domain list whose cell
+    // has at least one constrained trial dof. Coefficients are packed
+    // by position in the full list, so positions rather than cell
+    // indices are kept. Both lists are sorted.
     const std::vector<std::int32_t>& cells = a.cell_domains(i);
+    std::vector<std::int32_t> active;
+    active.reserve(std::min(cells.size(), lift_cells.size()));
+    for (std::size_t p = 0, q = 0; p < cells.size() and q < lift_cells.size();)
+    {
+      if (cells[p] < lift_cells[q])
+        ++p;
+      else if (lift_cells[q] < cells[p])
+        ++q;
+      else
+      {
+        active.push_back(p);
+        ++p;
+        ++q;
+      }
+    }
     if (bs0 == 1 and bs1 == 1)
     {
-      _lift_bc_cells<T, 1, 1>(b, mesh->geometry(), kernel, cells, dof_transform,
-                              dofmap0, bs0, dof_transform_to_transpose, dofmap1,
-                              bs1, constants, coeffs, cstride, cell_info,
+      _lift_bc_cells<T, 1, 1>(b, mesh->geometry(), kernel, cells, active,
+                              dof_transform, dofmap0, bs0,
+                              dof_transform_to_transpose, dofmap1, bs1,
+                              constants, coeffs, cstride, cell_info,
+                              bc_values1, bc_markers1, x0, scale);
+    }
+    else if (bs0 == 2 and bs1 == 2)
+    {
+      _lift_bc_cells<T, 2, 2>(b, mesh->geometry(), kernel, cells, active,
+                              dof_transform, dofmap0, bs0,
+                              dof_transform_to_transpose, dofmap1, bs1,
+                              constants, coeffs, cstride, cell_info,
                               bc_values1, bc_markers1, x0, scale);
     }
     else if (bs0 == 3 and bs1 == 3)
     {
-      _lift_bc_cells<T, 3, 3>(b, mesh->geometry(), kernel, cells, dof_transform,
-                              dofmap0, bs0, dof_transform_to_transpose, dofmap1,
-                              bs1, constants, coeffs, cstride, cell_info,
+      _lift_bc_cells<T, 3, 3>(b, mesh->geometry(), kernel, cells, active,
+                              dof_transform, dofmap0, bs0,
+                              dof_transform_to_transpose, dofmap1, bs1,
+                              constants, coeffs, cstride, cell_info,
                               bc_values1, bc_markers1, x0, scale);
     }
     else
     {
-      _lift_bc_cells(b, mesh->geometry(), kernel, cells, dof_transform, dofmap0,
-                     bs0, dof_transform_to_transpose, dofmap1, bs1, constants,
-                     coeffs, cstride, cell_info, bc_values1, bc_markers1, x0,
-                     scale);
+      _lift_bc_cells(b, mesh->geometry(), kernel, cells, active, dof_transform,
+                     dofmap0, bs0, dof_transform_to_transpose, dofmap1, bs1,
+                     constants, coeffs, cstride, cell_info, bc_values1,
+                     bc_markers1, x0, scale);
     }
   }
 
@@ -868,13 +956,12 @@ void lift_bc(xtl::span<T> b, const Form<T>& a,
       const auto& kernel = a.kernel(IntegralType::interior_facet, i);
       const auto& [coeffs, cstride]
           = coefficients.at({IntegralType::interior_facet, i});
-      const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
-          facets
-          = a.interior_facet_domains(i);
+      const std::vector<InteriorFacetData>& facets
+          = a.interior_facet_assembly_data(i);
       _lift_bc_interior_facets(b, *mesh, kernel, facets, dof_transform, dofmap0,
                                bs0, dof_transform_to_transpose, dofmap1, bs1,
                                constants, coeffs, cstride, c_offsets, cell_info,
-                               get_perm, bc_values1, bc_markers1, x0, scale);
+                               bc_values1, bc_markers1, x0, scale);
     }
   }
 }
@@ -936,58 +1023,259 @@ void apply_lifting(
       const int crange = bs1 * (map1->size_local() + map1->num_ghosts());
       bc_markers1.assign(crange, false);
       bc_values1.assign(crange, 0.0);
+      // Merge the cached per-bc constrained cell lists so that lifting
+      // sweeps only cells adjacent to a constrained trial dof
+      std::vector<std::int32_t> lift_cells;
       for (const std::shared_ptr<const DirichletBC<T>>& bc : bcs1[j])
       {
         bc->mark_dofs(bc_markers1);
         bc->dof_values(bc_values1);
+
+        const std::vector<std::int32_t>& bc_cells = bc->constrained_cells();
+        const std::size_t offset = lift_cells.size();
+        lift_cells.insert(lift_cells.end(), bc_cells.begin(), bc_cells.end());
+        std::inplace_merge(lift_cells.begin(),
+                           std::next(lift_cells.begin(), offset),
+                           lift_cells.end());
       }
+      lift_cells.erase(std::unique(lift_cells.begin(), lift_cells.end()),
+                       lift_cells.end());
 
       if (!x0.empty())
       {
         lift_bc<T>(b, *a[j], constants[j], coeffs[j], bc_values1, bc_markers1,
-                   x0[j], scale);
+                   lift_cells, x0[j], scale);
       }
       else
       {
         lift_bc<T>(b, *a[j], constants[j], coeffs[j], bc_values1, bc_markers1,
-                   xtl::span<const T>(), scale);
+                   lift_cells, xtl::span<const T>(), scale);
       }
     }
   }
 }
 
-/// Assemble linear form into a vector
+/// Fused assembly of a linear form and bc lifting over cells. For each
+/// cell the geometry is gathered once, the `L` kernel is tabulated and,
+/// if any trial dof of the cell carries a bc, the `a` kernel is
+/// tabulated and the lifting contribution -scale * Ae (g - x0) is
+/// accumulated into the same cell vector before it is scattered. The
+/// forms must share the test space, so `dofmap0` applies to both.
+/// @tparam T The scalar type
+/// @tparam _bs0 The block size of the test function dof map. If less
+/// than zero the block size is determined at runtime. If `_bs0` is
+/// positive the block size is used as a compile-time constant, which
+/// has performance benefits.
+/// @tparam _bs1 The block size of the trial function dof map.
+template <typename T, int _bs0 = -1, int _bs1 = -1>
+void _assemble_vector_lift_cells(
+    xtl::span<T> b, const mesh::Geometry& geometry,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel_L,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel_a,
+    const xtl::span<const std::int32_t>& cells,
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform_to_transpose,
+    const graph::FixedDegreeAdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const xtl::span<const T>& constants_L, const xtl::span<const T>& coeffs_L,
+    int cstride_L, const xtl::span<const T>& constants_a,
+    const xtl::span<const T>& coeffs_a, int cstride_a,
+    const xtl::span<const std::uint32_t>& cell_info,
+    const xtl::span<const T>& bc_values1, const std::vector<bool>& bc_markers1,
+    const xtl::span<const T>& x0, double scale)
+{
+  assert(_bs0 < 0 or _bs0 == bs0);
+  assert(_bs1 < 0 or _bs1 == bs1);
+
+  // Prepare cell geometry
+  const graph::FixedDegreeAdjacencyList<std::int32_t> x_dofmap
+      = geometry.dofmap_fixed();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+
+  // Create data structures used in assembly
+  common::ScratchArena::Frame scratch;
+  const xtl::span<double> coordinate_dofs
+      = scratch.allocate<double>(3 * num_dofs_g);
+  std::vector<T> Ae, be;
+  for (std::size_t index = 0; index < cells.size(); ++index)
+  {
+    std::int32_t c = cells[index];
+
+    // Get cell coordinates/geometry (shared by both kernels)
+    auto x_dofs = x_dofmap.links(c);
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                  std::next(coordinate_dofs.begin(), 3 * i));
+    }
+
+    auto dmap0 = dofmap0.links(c);
+    const int num_rows = bs0 * dmap0.size();
+
+    // Tabulate vector for cell
+    be.resize(num_rows);
+    std::fill(be.begin(), be.end(), 0);
+    kernel_L(be.data(), coeffs_L.data() + index * cstride_L,
+             constants_L.data(), coordinate_dofs.data(), nullptr, nullptr);
+    dof_transform(be, cell_info, c, 1);
+
+    // Check if bc is applied to cell
+    auto dmap1 = dofmap1.links(c);
+    bool has_bc = false;
+    for (std::size_t j = 0; j < dmap1.size(); ++j)
+    {
+      for (int k = 0; k < bs1; ++k)
+      {
+        assert(bs1 * dmap1[j] + k < (int)bc_markers1.size());
+        if (bc_markers1[bs1 * dmap1[j] + k])
+        {
+          has_bc = true;
+          break;
+        }
+      }
+    }
+
+    if (has_bc)
+    {
+      const int num_cols = bs1 * dmap1.size();
+      Ae.resize(num_rows * num_cols);
+      std::fill(Ae.begin(), Ae.end(), 0);
+      kernel_a(Ae.data(), coeffs_a.data() + index * cstride_a,
+               constants_a.data(), coordinate_dofs.data(), nullptr, nullptr);
+      dof_transform(Ae, cell_info, c, num_cols);
+      dof_transform_to_transpose(Ae, cell_info, c, num_rows);
+
+      for (std::size_t j = 0; j < dmap1.size(); ++j)
+      {
+        if constexpr (_bs1 > 0)
+        {
+          for (int k = 0; k < _bs1; ++k)
+          {
+            const std::int32_t jj = _bs1 * dmap1[j] + k;
+            if (bc_markers1[jj])
+            {
+              const T bc = bc_values1[jj];
+              const T _x0 = x0.empty() ? 0.0 : x0[jj];
+              // be -= Ae.col(bs1 * j + k) * scale * (bc - _x0);
+              for (int m = 0; m < num_rows; ++m)
+                be[m] -= Ae[m * num_cols + _bs1 * j + k] * scale * (bc - _x0);
+            }
+          }
+        }
+        else
+        {
+          for (int k = 0; k < bs1; ++k)
+          {
+            const std::int32_t jj = bs1 * dmap1[j] + k;
+            if (bc_markers1[jj])
+            {
+              const T bc = bc_values1[jj];
+              const T _x0 = x0.empty() ? 0.0 : x0[jj];
+              // be -= Ae.col(bs1 * j + k) * scale * (bc - _x0);
+              for (int m = 0; m < num_rows; ++m)
+                be[m] -= Ae[m * num_cols + bs1 * j + k] * scale * (bc - _x0);
+            }
+          }
+        }
+      }
+    }
+
+    // Scatter cell vector to 'global' vector array
+    for (std::size_t i = 0; i < dmap0.size(); ++i)
+    {
+      if constexpr (_bs0 > 0)
+      {
+        for (int k = 0; k < _bs0; ++k)
+          b[_bs0 * dmap0[i] + k] += be[_bs0 * i + k];
+      }
+      else
+      {
+        for (int k = 0; k < bs0; ++k)
+          b[bs0 * dmap0[i] + k] += be[bs0 * i + k];
+      }
+    }
+  }
+}
+
+/// Assemble the linear form L and lift the bcs on the trial space of a
+/// in a single sweep over cells:
+///
+///   b <- b + L_e - scale * A_e (g - x0)
+///
+/// This avoids the second pass over the mesh (and second geometry
+/// gather) that separate assemble_vector/apply_lifting calls perform,
+/// e.g. in a Newton residual assembly. Both forms must be defined over
+/// cell integrals only, with identical cell domains, and `a` must have
+/// the same test space as `L`.
 /// @param[in,out] b The vector to be assembled. It will not be zeroed
 /// before assembly.
-/// @param[in] L The linear forms to assemble into b
-/// @param[in] constants Packed constants that appear in `L`
-/// @param[in] coefficients Packed coefficients that appear in `L`
+/// @param[in] L The linear form to assemble into b
+/// @param[in] a The bilinear form generating the lifted matrix
+/// @param[in] constants_L Packed constants that appear in `L`
+/// @param[in] coefficients_L Packed coefficients that appear in `L`
+/// @param[in] constants_a Packed constants that appear in `a`
+/// @param[in] coefficients_a Packed coefficients that appear in `a`
+/// @param[in] bc_values1 The boundary condition 'values'
+/// @param[in] bc_markers1 The trial space indices to which bcs belong
+/// @param[in] x0 The array used in the lifting, typically a 'current
+/// solution' in a Newton method
+/// @param[in] scale Scaling to apply to the lifting
 template <typename T>
-void assemble_vector(
-    xtl::span<T> b, const Form<T>& L, const xtl::span<const T>& constants,
+void assemble_vector_lifted(
+    xtl::span<T> b, const Form<T>& L, const Form<T>& a,
+    const xtl::span<const T>& constants_L,
     const std::map<std::pair<IntegralType, int>,
-                   std::pair<xtl::span<const T>, int>>& coefficients)
+                   std::pair<xtl::span<const T>, int>>& coefficients_L,
+    const xtl::span<const T>& constants_a,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients_a,
+    const xtl::span<const T>& bc_values1, const std::vector<bool>& bc_markers1,
+    const xtl::span<const T>& x0, double scale)
 {
   std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
   assert(mesh);
 
-  // Get dofmap data
-  assert(L.function_spaces().at(0));
-  std::shared_ptr<const fem::FiniteElement> element
-      = L.function_spaces().at(0)->element();
-  std::shared_ptr<const fem::DofMap> dofmap
-      = L.function_spaces().at(0)->dofmap();
-  assert(dofmap);
-  const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
-  const int bs = dofmap->bs();
+  if (L.num_integrals(IntegralType::exterior_facet) > 0
+      or L.num_integrals(IntegralType::interior_facet) > 0
+      or a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    throw std::runtime_error("Fused assembly and lifting supports cell "
+                             "integrals only.");
+  }
+  if (L.integral_ids(IntegralType::cell) != a.integral_ids(IntegralType::cell))
+  {
+    throw std::runtime_error(
+        "Linear and bilinear forms must have the same cell integral domains "
+        "for fused assembly and lifting.");
+  }
 
-  const std::function<void(const xtl::span<T>&,
-                           const xtl::span<const std::uint32_t>&, std::int32_t,
-                           int)>
-      dof_transform = element->get_dof_transformation_function<T>();
+  // Get dofmap for columns and rows of a (L shares the test space)
+  assert(a.function_spaces().at(0));
+  assert(a.function_spaces().at(1));
+  const graph::AdjacencyList<std::int32_t>& dofmap0
+      = a.function_spaces()[0]->dofmap()->list();
+  const int bs0 = a.function_spaces()[0]->dofmap()->bs();
+  std::shared_ptr<const fem::FiniteElement> element0
+      = a.function_spaces()[0]->element();
+  const graph::AdjacencyList<std::int32_t>& dofmap1
+      = a.function_spaces()[1]->dofmap()->list();
+  const int bs1 = a.function_spaces()[1]->dofmap()->bs();
+  std::shared_ptr<const fem::FiniteElement> element1
+      = a.function_spaces()[1]->element();
 
   const bool needs_transformation_data
-      = element->needs_dof_transformations() or L.needs_facet_permutations();
+      = element0->needs_dof_transformations()
+        or element1->needs_dof_transformations();
   xtl::span<const std::uint32_t> cell_info;
   if (needs_transformation_data)
   {
@@ -995,17 +1283,150 @@ void assemble_vector(
     cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
   }
 
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>
+      dof_transform = element0->get_dof_transformation_function<T>();
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>
+      dof_transform_to_transpose
+      = element1->get_dof_transformation_to_transpose_function<T>();
+
+  for (int i : L.integral_ids(IntegralType::cell))
+  {
+    const auto& kernel_L = L.kernel(IntegralType::cell, i);
+    const auto& kernel_a = a.kernel(IntegralType::cell, i);
+    const auto& [coeffs_L, cstride_L]
+        = coefficients_L.at({IntegralType::cell, i});
+    const auto& [coeffs_a, cstride_a]
+        = coefficients_a.at({IntegralType::cell, i});
+    const std::vector<std::int32_t>& cells = L.cell_domains(i);
+    if (cells != a.cell_domains(i))
+    {
+      throw std::runtime_error(
+          "Linear and bilinear forms must have the same cell integral "
+          "domains for fused assembly and lifting.");
+    }
+
+    if (bs0 == 1 and bs1 == 1)
+    {
+      _assemble_vector_lift_cells<T, 1, 1>(
+          b, mesh->geometry(), kernel_L, kernel_a, cells, dof_transform,
+          dofmap0, bs0, dof_transform_to_transpose, dofmap1, bs1, constants_L,
+          coeffs_L, cstride_L, constants_a, coeffs_a, cstride_a, cell_info,
+          bc_values1, bc_markers1, x0, scale);
+    }
+    else if (bs0 == 2 and bs1 == 2)
+    {
+      _assemble_vector_lift_cells<T, 2, 2>(
+          b, mesh->geometry(), kernel_L, kernel_a, cells, dof_transform,
+          dofmap0, bs0, dof_transform_to_transpose, dofmap1, bs1, constants_L,
+          coeffs_L, cstride_L, constants_a, coeffs_a, cstride_a, cell_info,
+          bc_values1, bc_markers1, x0, scale);
+    }
+    else if (bs0 == 3 and bs1 == 3)
+    {
+      _assemble_vector_lift_cells<T, 3, 3>(
+          b, mesh->geometry(), kernel_L, kernel_a, cells, dof_transform,
+          dofmap0, bs0, dof_transform_to_transpose, dofmap1, bs1, constants_L,
+          coeffs_L, cstride_L, constants_a, coeffs_a, cstride_a, cell_info,
+          bc_values1, bc_markers1, x0, scale);
+    }
+    else
+    {
+      _assemble_vector_lift_cells(
+          b, mesh->geometry(), kernel_L, kernel_a, cells, dof_transform,
+          dofmap0, bs0, dof_transform_to_transpose, dofmap1, bs1, constants_L,
+          coeffs_L, cstride_L, constants_a, coeffs_a, cstride_a, cell_info,
+          bc_values1, bc_markers1, x0, scale);
+    }
+  }
+}
+
+/// Split the cells of each cell integral domain of a linear form into
+/// cells whose dofmap rows include ghost indices and purely interior
+/// cells, for overlapping the accumulation of ghost contributions with
+/// assembly
+/// @param[in] L The linear form
+/// @return The (ghost-touching cells, interior cells) lists for each
+/// cell integral id of `L`
+template <typename T>
+std::array<std::map<int, std::vector<std::int32_t>>, 2>
+split_cell_domains(const Form<T>& L)
+{
+  assert(L.function_spaces().at(0));
+  std::shared_ptr<const fem::DofMap> dofmap
+      = L.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+  assert(dofmap->index_map);
+  const std::int32_t num_owned = dofmap->index_map->size_local();
+
+  std::array<std::map<int, std::vector<std::int32_t>>, 2> domains;
   for (int i : L.integral_ids(IntegralType::cell))
+  {
+    const std::vector<std::int32_t>& cells = L.cell_domains(i);
+    std::vector<std::int32_t>& bnd = domains[0][i];
+    std::vector<std::int32_t>& interior = domains[1][i];
+    interior.reserve(cells.size());
+    for (std::int32_t c : cells)
+    {
+      const auto dofs_c = dofs.links(c);
+      if (std::any_of(dofs_c.begin(), dofs_c.end(),
+                      [num_owned](std::int32_t d) { return d >= num_owned; }))
+      {
+        bnd.push_back(c);
+      }
+      else
+        interior.push_back(c);
+    }
+  }
+  return domains;
+}
+
+/// Assemble the cell integrals of a linear form with the dof
+/// transformation supplied as a generic callable. The function is
+/// instantiated once with the std::function transformation and once
+/// with an empty no-op functor, so transformation-free elements pay no
+/// per-cell indirect call; see assemble_vector_cells below for the
+/// selection.
+template <typename T, typename Transform>
+void assemble_vector_cells(
+    xtl::span<T> b, const Form<T>& L, const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients,
+    const std::map<int, xtl::span<const std::int32_t>>& cell_domains,
+    const Transform& dof_transform,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+
+  // Get dofmap data
+  assert(L.function_spaces().at(0));
+  std::shared_ptr<const fem::DofMap> dofmap
+      = L.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+  const int bs = dofmap->bs();
+
+  for (const auto& [i, cells] : cell_domains)
   {
     const auto& fn = L.kernel(IntegralType::cell, i);
     const auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, i});
-    const std::vector<std::int32_t>& cells = L.cell_domains(i);
     if (bs == 1)
     {
       impl::assemble_cells<T, 1>(dof_transform, b, mesh->geometry(), cells,
                                  dofs, bs, fn, constants, coeffs, cstride,
                                  cell_info);
     }
+    else if (bs == 2)
+    {
+      impl::assemble_cells<T, 2>(dof_transform, b, mesh->geometry(), cells,
+                                 dofs, bs, fn, constants, coeffs, cstride,
+                                 cell_info);
+    }
     else if (bs == 3)
     {
       impl::assemble_cells<T, 3>(dof_transform, b, mesh->geometry(), cells,
@@ -1018,6 +1439,83 @@ void assemble_vector(
                            fn, constants, coeffs, cstride, cell_info);
     }
   }
+}
+
+/// Assemble the cell integrals of a linear form over given subsets of
+/// the integration domains
+/// @param[in,out] b The vector to accumulate into
+/// @param[in] L The linear form
+/// @param[in] constants Packed constants that appear in `L`
+/// @param[in] coefficients Packed coefficients that appear in `L`
+/// @param[in] cell_domains The cells to integrate over for each cell
+/// integral id of `L`. Each list must be a subset of the corresponding
+/// integration domain of `L`.
+template <typename T>
+void assemble_vector_cells(
+    xtl::span<T> b, const Form<T>& L, const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients,
+    const std::map<int, xtl::span<const std::int32_t>>& cell_domains)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+
+  assert(L.function_spaces().at(0));
+  std::shared_ptr<const fem::FiniteElement> element
+      = L.function_spaces().at(0)->element();
+
+  const bool needs_transformation_data
+      = element->needs_dof_transformations() or L.needs_facet_permutations();
+  xtl::span<const std::uint32_t> cell_info;
+  if (needs_transformation_data)
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  // Select the dof transformation instantiation once per form: for
+  // transformation-free elements an empty no-op functor is passed, so
+  // the transformation calls vanish from the assembly loops
+  if (element->needs_dof_transformations())
+  {
+    assemble_vector_cells(b, L, constants, coefficients, cell_domains,
+                          element->get_dof_transformation_function<T>(),
+                          cell_info);
+  }
+  else
+  {
+    const auto noop
+        = [](const xtl::span<T>&, const xtl::span<const std::uint32_t>&,
+             std::int32_t, int)
+    {
+      // Do nothing
+    };
+    assemble_vector_cells(b, L, constants, coefficients, cell_domains, noop,
+                          cell_info);
+  }
+}
+
+/// Assemble the facet integrals of a linear form with the dof
+/// transformation supplied as a generic callable; see
+/// assemble_vector_facets below for the instantiation selection.
+template <typename T, typename Transform>
+void assemble_vector_facets(
+    xtl::span<T> b, const Form<T>& L, const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients,
+    const Transform& dof_transform,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+
+  // Get dofmap data
+  assert(L.function_spaces().at(0));
+  std::shared_ptr<const fem::DofMap> dofmap
+      = L.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+  const int bs = dofmap->bs();
 
   if (L.num_integrals(IntegralType::exterior_facet) > 0
       or L.num_integrals(IntegralType::interior_facet) > 0)
@@ -1046,6 +1544,12 @@ void assemble_vector(
                                              dofs, bs, fn, constants, coeffs,
                                              cstride, cell_info, get_perm);
       }
+      else if (bs == 2)
+      {
+        impl::assemble_exterior_facets<T, 2>(dof_transform, b, *mesh, facets,
+                                             dofs, bs, fn, constants, coeffs,
+                                             cstride, cell_info, get_perm);
+      }
       else if (bs == 3)
       {
         impl::assemble_exterior_facets<T, 3>(dof_transform, b, *mesh, facets,
@@ -1066,28 +1570,198 @@ void assemble_vector(
       const auto& fn = L.kernel(IntegralType::interior_facet, i);
       const auto& [coeffs, cstride]
           = coefficients.at({IntegralType::interior_facet, i});
-      const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
-          facets
-          = L.interior_facet_domains(i);
+      const std::vector<InteriorFacetData>& facets
+          = L.interior_facet_assembly_data(i);
       if (bs == 1)
       {
-        impl::assemble_interior_facets<T, 1>(
-            dof_transform, b, *mesh, facets, *dofmap, fn, constants, coeffs,
-            cstride, c_offsets, cell_info, get_perm);
+        impl::assemble_interior_facets<T, 1>(dof_transform, b, *mesh, facets,
+                                             *dofmap, fn, constants, coeffs,
+                                             cstride, c_offsets, cell_info);
+      }
+      else if (bs == 2)
+      {
+        impl::assemble_interior_facets<T, 2>(dof_transform, b, *mesh, facets,
+                                             *dofmap, fn, constants, coeffs,
+                                             cstride, c_offsets, cell_info);
       }
       else if (bs == 3)
       {
-        impl::assemble_interior_facets<T, 3>(
-            dof_transform, b, *mesh, facets, *dofmap, fn, constants, coeffs,
-            cstride, c_offsets, cell_info, get_perm);
+        impl::assemble_interior_facets<T, 3>(dof_transform, b, *mesh, facets,
+                                             *dofmap, fn, constants, coeffs,
+                                             cstride, c_offsets, cell_info);
       }
       else
       {
         impl::assemble_interior_facets(dof_transform, b, *mesh, facets, *dofmap,
                                        fn, constants, coeffs, cstride,
-                                       c_offsets, cell_info, get_perm);
+                                       c_offsets, cell_info);
       }
     }
   }
 }
+
+/// Assemble the exterior and interior facet integrals of a linear form
+/// @param[in,out] b The vector to accumulate into
+/// @param[in] L The linear form
+/// @param[in] constants Packed constants that appear in `L`
+/// @param[in] coefficients Packed coefficients that appear in `L`
+template <typename T>
+void assemble_vector_facets(
+    xtl::span<T> b, const Form<T>& L, const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+
+  assert(L.function_spaces().at(0));
+  std::shared_ptr<const fem::FiniteElement> element
+      = L.function_spaces().at(0)->element();
+
+  const bool needs_transformation_data
+      = element->needs_dof_transformations() or L.needs_facet_permutations();
+  xtl::span<const std::uint32_t> cell_info;
+  if (needs_transformation_data)
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  // Select the dof transformation instantiation once per form, as for
+  // the cell integrals
+  if (element->needs_dof_transformations())
+  {
+    assemble_vector_facets(b, L, constants, coefficients,
+                           element->get_dof_transformation_function<T>(),
+                           cell_info);
+  }
+  else
+  {
+    const auto noop
+        = [](const xtl::span<T>&, const xtl::span<const std::uint32_t>&,
+             std::int32_t, int)
+    {
+      // Do nothing
+    };
+    assemble_vector_facets(b, L, constants, coefficients, noop, cell_info);
+  }
+}
+
+/// Assemble linear form into a vector
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] L The linear forms to assemble into b
+/// @param[in] constants Packed constants that appear in `L`
+/// @param[in] coefficients Packed coefficients that appear in `L`
+template <typename T>
+void assemble_vector(
+    xtl::span<T> b, const Form<T>& L, const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients)
+{
+  std::map<int, xtl::span<const std::int32_t>> cell_domains;
+  for (int i : L.integral_ids(IntegralType::cell))
+    cell_domains.emplace(i, L.cell_domains(i));
+  assemble_vector_cells(b, L, constants, coefficients, cell_domains);
+  assemble_vector_facets(b, L, constants, coefficients);
+}
+
+/// Assemble the cell integrals of a linear form against an ensemble of
+/// packed coefficient sets with the dof transformation supplied as a
+/// generic callable; see assemble_vector_ensemble below.
+template <typename T, typename Transform>
+void assemble_vector_ensemble(
+    const std::vector<xtl::span<T>>& b, const Form<T>& L,
+    const xtl::span<const T>& constants,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<xtl::span<const T>, int>>>&
+        coefficients,
+    const Transform& dof_transform,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+
+  // Get dofmap data
+  assert(L.function_spaces().at(0));
+  std::shared_ptr<const fem::DofMap> dofmap
+      = L.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+  const int bs = dofmap->bs();
+
+  for (int i : L.integral_ids(IntegralType::cell))
+  {
+    const auto& fn = L.kernel(IntegralType::cell, i);
+    const std::vector<std::int32_t>& cells = L.cell_domains(i);
+
+    // Collect the packed coefficients of every sample for this
+    // integral. The layout (cstride) is a property of the form, so it
+    // is identical for all samples.
+    const int cstride = coefficients.front().at({IntegralType::cell, i}).second;
+    std::vector<xtl::span<const T>> coeffs;
+    coeffs.reserve(coefficients.size());
+    for (const auto& coefficients_s : coefficients)
+    {
+      const auto& [c, stride] = coefficients_s.at({IntegralType::cell, i});
+      assert(stride == cstride);
+      coeffs.push_back(c);
+    }
+
+    assemble_cells_ensemble(dof_transform, b, mesh->geometry(), cells, dofs,
+                            bs, fn, constants, coeffs, cstride, cell_info);
+  }
+}
+
+/// Assemble a linear form against an ensemble of packed coefficient
+/// sets in a single cell sweep, accumulating sample s into b[s]. The
+/// form must have cell integrals only.
+/// @param[in,out] b The vectors to accumulate into, one per sample
+/// @param[in] L The linear form
+/// @param[in] constants Packed constants that appear in `L` (shared by
+/// all samples)
+/// @param[in] coefficients Packed coefficients that appear in `L`, one
+/// set per sample
+template <typename T>
+void assemble_vector_ensemble(
+    const std::vector<xtl::span<T>>& b, const Form<T>& L,
+    const xtl::span<const T>& constants,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<xtl::span<const T>, int>>>&
+        coefficients)
+{
+  assert(b.size() == coefficients.size());
+  if (L.num_integrals(IntegralType::exterior_facet) > 0
+      or L.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    throw std::runtime_error(
+        "Ensemble assembly supports cell integrals only.");
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+  assert(L.function_spaces().at(0));
+  std::shared_ptr<const fem::FiniteElement> element
+      = L.function_spaces().at(0)->element();
+
+  xtl::span<const std::uint32_t> cell_info;
+  if (element->needs_dof_transformations())
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+    assemble_vector_ensemble(b, L, constants, coefficients,
+                             element->get_dof_transformation_function<T>(),
+                             cell_info);
+  }
+  else
+  {
+    const auto noop
+        = [](const xtl::span<T>&, const xtl::span<const std::uint32_t>&,
+             std::int32_t, int)
+    {
+      // Do nothing
+    };
+    assemble_vector_ensemble(b, L, constants, coefficients, noop, cell_info);
+  }
+}
 } // namespace dolfinx::fem::impl
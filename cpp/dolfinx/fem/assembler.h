@@ -9,7 +9,13 @@
 #include "assemble_matrix_impl.h"
 #include "assemble_scalar_impl.h"
 #include "assemble_vector_impl.h"
+#include <chrono>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Telemetry.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/Vector.h>
 #include <memory>
+#include <mpi.h>
 #include <vector>
 #include <xtl/xspan.hpp>
 
@@ -68,12 +74,59 @@ T assemble_scalar(
 template <typename T>
 T assemble_scalar(const Form<T>& M)
 {
-  const std::vector<T> constants = pack_constants(M);
+  const std::vector<T>& constants = M.packed_constants();
   const auto coefficients = pack_coefficients(M);
   return assemble_scalar(M, tcb::make_span(constants),
                          make_coefficients_span(coefficients));
 }
 
+/// Handle for a pending non-blocking scalar reduction. The
+/// accumulation across processes is started with MPI_Iallreduce at
+/// construction and completed by get(), so the communication can
+/// overlap other work. The handle owns the communication buffers and
+/// is therefore not copyable or movable.
+template <typename T>
+class ScalarReduction
+{
+public:
+  /// Start the reduction of a local value over a communicator
+  ScalarReduction(T local, MPI_Comm comm) : _local(local)
+  {
+    MPI_Iallreduce(&_local, &_global, 1, dolfinx::MPI::mpi_type<T>(), MPI_SUM,
+                   comm, &_request);
+  }
+
+  // The MPI request holds pointers into this object
+  ScalarReduction(const ScalarReduction&) = delete;
+  ScalarReduction& operator=(const ScalarReduction&) = delete;
+
+  /// Destructor. Completes the reduction if still pending.
+  ~ScalarReduction() { MPI_Wait(&_request, MPI_STATUS_IGNORE); }
+
+  /// Wait for the reduction and return the global value
+  T get()
+  {
+    MPI_Wait(&_request, MPI_STATUS_IGNORE);
+    return _global;
+  }
+
+private:
+  T _local, _global = 0;
+  MPI_Request _request = MPI_REQUEST_NULL;
+};
+
+/// Assemble functional into a scalar with a non-blocking reduction
+/// across processes. The local assembly is performed immediately and
+/// the MPI reduction is started; the returned handle completes it on
+/// get(), allowing the communication to overlap subsequent work.
+/// @param[in] M The form (functional) to assemble
+/// @return Handle for the pending global value
+template <typename T>
+ScalarReduction<T> assemble_scalar_begin(const Form<T>& M)
+{
+  return ScalarReduction<T>(assemble_scalar(M), M.mesh()->mpi_comm());
+}
+
 // -- Vectors ----------------------------------------------------------------
 
 /// Assemble linear form into a vector, The caller supplies the form
@@ -90,7 +143,12 @@ void assemble_vector(
     const std::map<std::pair<IntegralType, int>,
                    std::pair<xtl::span<const T>, int>>& coefficients)
 {
+  const auto t0 = std::chrono::steady_clock::now();
   impl::assemble_vector(b, L, constants, coefficients);
+  common::telemetry::emit(
+      common::telemetry::Channel::assembly, 0,
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+          .count());
 }
 
 /// Assemble linear form into a vector
@@ -101,11 +159,201 @@ template <typename T>
 void assemble_vector(xtl::span<T> b, const Form<T>& L)
 {
   const auto coefficients = pack_coefficients(L);
-  const std::vector<T> constants = pack_constants(L);
+  const std::vector<T>& constants = L.packed_constants();
   assemble_vector(b, L, tcb::make_span(constants),
                   make_coefficients_span(coefficients));
 }
 
+/// Assemble a linear form against an ensemble of packed coefficient
+/// sets (e.g. UQ samples) in a single cell sweep, accumulating sample
+/// s into b[s]. The geometry gathers and dof lookups are performed
+/// once per cell and shared by all samples, which amortizes the
+/// mesh-side memory traffic when the same form is assembled for many
+/// coefficient realisations. The form must have cell integrals only.
+/// @param[in,out] b The vectors to be assembled, one per sample. They
+/// will not be zeroed before assembly.
+/// @param[in] L The linear form to assemble
+/// @param[in] constants The constants that appear in `L` (shared by
+/// all samples)
+/// @param[in] coefficients The packed coefficients that appear in `L`,
+/// one set per sample (see pack_coefficients)
+template <typename T>
+void assemble_vector_ensemble(
+    const std::vector<xtl::span<T>>& b, const Form<T>& L,
+    const xtl::span<const T>& constants,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<xtl::span<const T>, int>>>&
+        coefficients)
+{
+  const auto t0 = std::chrono::steady_clock::now();
+  impl::assemble_vector_ensemble(b, L, constants, coefficients);
+  common::telemetry::emit(
+      common::telemetry::Channel::assembly, 0,
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+          .count());
+}
+
+/// Assemble a linear form into a vector and accumulate the ghost
+/// contributions, overlapping the reverse scatter with assembly.
+///
+/// The cells of each cell integral domain are split into cells whose
+/// dofs include ghost indices and purely interior cells. The
+/// ghost-touching cells and all facet integrals are assembled first,
+/// the reverse scatter of the ghost entries is then started, and the
+/// interior cells (which write owned entries only) are assembled while
+/// the communication is in flight. On return the owned entries of `b`
+/// are complete; `b` is not zeroed before assembly.
+/// @param[in,out] b The vector to be assembled and accumulated
+/// @param[in] L The linear form to assemble into b
+/// @param[in] constants The constants that appear in `L`
+/// @param[in] coefficients The coefficients that appear in `L`
+template <typename T, class Allocator>
+void assemble_vector_overlap(
+    la::Vector<T, Allocator>& b, const Form<T>& L,
+    const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients)
+{
+  // Split each cell integral domain into cells touching ghost dofs and
+  // purely interior cells
+  const auto [boundary_cells, interior_cells] = impl::split_cell_domains(L);
+
+  std::map<int, xtl::span<const std::int32_t>> domains;
+  const xtl::span<T> x = b.mutable_array();
+
+  // Assemble everything that can contribute to ghost entries: the
+  // ghost-touching cells and all facet integrals
+  for (const auto& [i, cells] : boundary_cells)
+    domains.emplace(i, cells);
+  impl::assemble_vector_cells(x, L, constants, coefficients, domains);
+  impl::assemble_vector_facets(x, L, constants, coefficients);
+
+  // Send the ghost contributions to the owning processes while
+  // assembling the interior cells, which write owned entries only
+  b.scatter_rev_begin();
+  domains.clear();
+  for (const auto& [i, cells] : interior_cells)
+    domains.emplace(i, cells);
+  impl::assemble_vector_cells(x, L, constants, coefficients, domains);
+  b.scatter_rev_end(common::IndexMap::Mode::add);
+}
+
+/// Assemble a linear form into a vector and accumulate the ghost
+/// contributions, overlapping communication with assembly. See the
+/// user-supplied constants/coefficients version for the pipelining of
+/// the reverse scatter. The ghost values of the given coefficient
+/// vectors are additionally refreshed first, with the forward scatter
+/// overlapping the packing of the form constants.
+/// @param[in,out] b The vector to be assembled and accumulated
+/// @param[in] L The linear form to assemble into b
+/// @param[in] coefficient_x Vectors of coefficients appearing in `L`
+/// whose ghost values should be updated before packing
+template <typename T, class Allocator>
+void assemble_vector_overlap(
+    la::Vector<T, Allocator>& b, const Form<T>& L,
+    const std::vector<std::shared_ptr<la::Vector<T>>>& coefficient_x = {})
+{
+  for (const std::shared_ptr<la::Vector<T>>& x : coefficient_x)
+    x->scatter_fwd_begin();
+  const std::vector<T>& constants = L.packed_constants();
+  for (const std::shared_ptr<la::Vector<T>>& x : coefficient_x)
+    x->scatter_fwd_end();
+  const auto coefficients = pack_coefficients(L);
+  assemble_vector_overlap(b, L, tcb::make_span(constants),
+                          make_coefficients_span(coefficients));
+}
+
+/// Assemble a linear form into a vector, accumulate the ghost
+/// contributions and start a non-blocking reduction of the squared l2
+/// norm of the assembled vector.
+///
+/// The assembly is pipelined as in assemble_vector_overlap. The norm
+/// pass is fused into the scatter epilogue: the squares of the owned
+/// entries that receive no remote contribution are folded while the
+/// reverse scatter is still in flight, only the entries completed by
+/// the scatter are visited afterwards, and the global reduction is
+/// non-blocking so residual assembly and convergence checks (e.g. in a
+/// Newton iteration) need no separate full-vector norm pass or
+/// blocking allreduce. `b` is not zeroed before assembly.
+/// @param[in,out] b The vector to be assembled and accumulated
+/// @param[in] L The linear form to assemble into b
+/// @param[in] constants The constants that appear in `L`
+/// @param[in] coefficients The coefficients that appear in `L`
+/// @return Handle for the pending squared l2 norm of `b` (the caller
+/// takes the square root after get())
+template <typename T, class Allocator>
+ScalarReduction<double> assemble_vector_norm_begin(
+    la::Vector<T, Allocator>& b, const Form<T>& L,
+    const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients)
+{
+  const auto [boundary_cells, interior_cells] = impl::split_cell_domains(L);
+
+  std::map<int, xtl::span<const std::int32_t>> domains;
+  const xtl::span<T> x = b.mutable_array();
+  for (const auto& [i, cells] : boundary_cells)
+    domains.emplace(i, cells);
+  impl::assemble_vector_cells(x, L, constants, coefficients, domains);
+  impl::assemble_vector_facets(x, L, constants, coefficients);
+
+  b.scatter_rev_begin();
+  domains.clear();
+  for (const auto& [i, cells] : interior_cells)
+    domains.emplace(i, cells);
+  impl::assemble_vector_cells(x, L, constants, coefficients, domains);
+
+  // Owned entries that receive no remote contribution are final once
+  // the interior cells are assembled: fold their squares while the
+  // reverse scatter completes
+  assert(b.map());
+  const std::int32_t num_owned = b.map()->size_local();
+  std::vector<bool> shared(num_owned, false);
+  for (std::int32_t i : b.map()->scatter_fwd_indices().array())
+    shared[i] = true;
+  const int bs = b.bs();
+  double s = 0.0;
+  for (std::int32_t i = 0; i < num_owned; ++i)
+  {
+    if (!shared[i])
+    {
+      for (int k = 0; k < bs; ++k)
+        s += std::norm(x[i * bs + k]);
+    }
+  }
+
+  b.scatter_rev_end(common::IndexMap::Mode::add);
+
+  // Add the entries completed by the scatter and start the global
+  // reduction
+  for (std::int32_t i = 0; i < num_owned; ++i)
+  {
+    if (shared[i])
+    {
+      for (int k = 0; k < bs; ++k)
+        s += std::norm(x[i * bs + k]);
+    }
+  }
+  return ScalarReduction<double>(s, b.map()->comm());
+}
+
+/// Assemble a linear form into a vector, accumulate the ghost
+/// contributions and start a non-blocking reduction of the squared l2
+/// norm. See the user-supplied constants/coefficients version for the
+/// pipelining.
+/// @param[in,out] b The vector to be assembled and accumulated
+/// @param[in] L The linear form to assemble into b
+/// @return Handle for the pending squared l2 norm of `b`
+template <typename T, class Allocator>
+ScalarReduction<double> assemble_vector_norm_begin(la::Vector<T, Allocator>& b,
+                                                   const Form<T>& L)
+{
+  const std::vector<T>& constants = L.packed_constants();
+  const auto coefficients = pack_coefficients(L);
+  return assemble_vector_norm_begin(b, L, tcb::make_span(constants),
+                                    make_coefficients_span(coefficients));
+}
+
 // FIXME: clarify how x0 is used
 // FIXME: if bcs entries are set
 
@@ -163,7 +411,7 @@ void apply_lifting(
     if (_a)
     {
       coeffs.push_back(pack_coefficients(*_a));
-      constants.push_back(pack_constants(*_a));
+      constants.push_back(_a->packed_constants());
     }
     else
     {
@@ -183,6 +431,63 @@ void apply_lifting(
   apply_lifting(b, a, _constants, _coeffs, bcs1, x0, scale);
 }
 
+/// Assemble linear form into a vector and apply bc lifting in a single
+/// sweep over cells:
+///
+///   b <- b + L_e - scale * A_e (g - x0)
+///
+/// Equivalent to assemble_vector(b, L) followed by apply_lifting with
+/// the single form a, but each cell is visited once, sharing the
+/// geometry gather and packed data between the two kernels. Intended
+/// for Newton residual assembly, where both passes walk the same cells.
+/// Both forms must be defined over cell integrals only, with identical
+/// cell domains, and `a` must have the same test space as `L`.
+///
+/// Ghost contributions are not accumulated (not sent to owner). Caller
+/// is responsible for calling VecGhostUpdateBegin/End.
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] L The linear form to assemble into b
+/// @param[in] a The bilinear form generating the lifted matrix. The
+/// boundary conditions bcs1 are on its trial space.
+/// @param[in] bcs1 Boundary conditions on the trial space of a
+/// @param[in] x0 The vector used in the lifting, typically a 'current
+/// solution' in a Newton method
+/// @param[in] scale Scaling to apply to the lifting
+template <typename T>
+void assemble_vector_lifted(
+    xtl::span<T> b, const Form<T>& L, const Form<T>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs1,
+    const xtl::span<const T>& x0 = xtl::span<const T>(), double scale = 1.0)
+{
+  const auto coefficients_L = pack_coefficients(L);
+  const std::vector<T>& constants_L = L.packed_constants();
+  const auto coefficients_a = pack_coefficients(a);
+  const std::vector<T>& constants_a = a.packed_constants();
+
+  std::vector<bool> bc_markers1;
+  std::vector<T> bc_values1;
+  auto V1 = a.function_spaces().at(1);
+  assert(V1);
+  auto map1 = V1->dofmap()->index_map;
+  const int bs1 = V1->dofmap()->index_map_bs();
+  assert(map1);
+  const int crange = bs1 * (map1->size_local() + map1->num_ghosts());
+  bc_markers1.assign(crange, false);
+  bc_values1.assign(crange, 0.0);
+  for (const std::shared_ptr<const DirichletBC<T>>& bc : bcs1)
+  {
+    bc->mark_dofs(bc_markers1);
+    bc->dof_values(bc_values1);
+  }
+
+  impl::assemble_vector_lifted(
+      b, L, a, tcb::make_span(constants_L),
+      make_coefficients_span(coefficients_L), tcb::make_span(constants_a),
+      make_coefficients_span(coefficients_a), tcb::make_span(bc_values1),
+      bc_markers1, x0, scale);
+}
+
 // -- Matrices ---------------------------------------------------------------
 
 /// Assemble bilinear form into a matrix
@@ -231,8 +536,78 @@ void assemble_matrix(
   }
 
   // Assemble
+  const auto t0 = std::chrono::steady_clock::now();
   impl::assemble_matrix(mat_add, a, constants, coefficients, dof_marker0,
                         dof_marker1);
+  common::telemetry::emit(
+      common::telemetry::Channel::assembly, 1,
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+          .count());
+}
+
+/// Assemble a bilinear form against an ensemble of packed coefficient
+/// sets (e.g. UQ samples) in a single cell sweep, emitting sample s
+/// into the matrix behind mat_add[s]. The geometry gathers, dof
+/// lookups and sparsity insertions are keyed identically for all
+/// samples, so the mesh-side memory traffic is amortized across the
+/// ensemble. The form must have cell integrals only.
+/// @param[in] mat_add The functions for adding values into the
+/// matrices, one per sample
+/// @param[in] a The bilinear form to assemble
+/// @param[in] constants Constants that appear in `a` (shared by all
+/// samples)
+/// @param[in] coefficients The packed coefficients that appear in `a`,
+/// one set per sample (see pack_coefficients)
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+///  dofs the row and column are zeroed. The diagonal entry is not set.
+template <typename T>
+void assemble_matrix_ensemble(
+    const std::vector<std::function<int(std::int32_t, const std::int32_t*,
+                                        std::int32_t, const std::int32_t*,
+                                        const T*)>>& mat_add,
+    const Form<T>& a, const xtl::span<const T>& constants,
+    const std::vector<std::map<std::pair<IntegralType, int>,
+                               std::pair<xtl::span<const T>, int>>>&
+        coefficients,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  // Index maps for dof ranges
+  auto map0 = a.function_spaces().at(0)->dofmap()->index_map;
+  auto map1 = a.function_spaces().at(1)->dofmap()->index_map;
+  auto bs0 = a.function_spaces().at(0)->dofmap()->index_map_bs();
+  auto bs1 = a.function_spaces().at(1)->dofmap()->index_map_bs();
+
+  // Build dof markers
+  std::vector<bool> dof_marker0, dof_marker1;
+  assert(map0);
+  std::int32_t dim0 = bs0 * (map0->size_local() + map0->num_ghosts());
+  assert(map1);
+  std::int32_t dim1 = bs1 * (map1->size_local() + map1->num_ghosts());
+  for (std::size_t k = 0; k < bcs.size(); ++k)
+  {
+    assert(bcs[k]);
+    assert(bcs[k]->function_space());
+    if (a.function_spaces().at(0)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker0.resize(dim0, false);
+      bcs[k]->mark_dofs(dof_marker0);
+    }
+
+    if (a.function_spaces().at(1)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker1.resize(dim1, false);
+      bcs[k]->mark_dofs(dof_marker1);
+    }
+  }
+
+  // Assemble
+  const auto t0 = std::chrono::steady_clock::now();
+  impl::assemble_matrix_ensemble(mat_add, a, constants, coefficients,
+                                 dof_marker0, dof_marker1);
+  common::telemetry::emit(
+      common::telemetry::Channel::assembly, 1,
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+          .count());
 }
 
 /// Assemble bilinear form into a matrix
@@ -248,7 +623,7 @@ void assemble_matrix(
     const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
 {
   // Prepare constants and coefficients
-  const std::vector<T> constants = pack_constants(a);
+  const std::vector<T>& constants = a.packed_constants();
   const auto coefficients = pack_coefficients(a);
 
   // Assemble
@@ -301,7 +676,7 @@ void assemble_matrix(
 
 {
   // Prepare constants and coefficients
-  const std::vector<T> constants = pack_constants(a);
+  const std::vector<T>& constants = a.packed_constants();
   const auto coefficients = pack_coefficients(a);
 
   // Assemble
@@ -310,6 +685,247 @@ void assemble_matrix(
                   dof_marker1);
 }
 
+/// Assemble bilinear form into a distributed CSR matrix. The matrix
+/// must be built on an assembled sparsity pattern for the form. Cell
+/// contributions are accumulated with MatrixCSR::add, which is safe to
+/// call concurrently for distinct rows, so the coloured threaded
+/// assembly sweep runs without locks or atomics. Does not zero the
+/// matrix; call MatrixCSR::finalize after all forms have been
+/// assembled to fold the ghost row contributions into the owned rows.
+/// @param[in,out] A The matrix to assemble into
+/// @param[in] a The bilinear form to assemble
+/// @param[in] constants Constants that appear in `a`
+/// @param[in] coefficients Coefficients that appear in `a`
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+/// dofs the row and column are zeroed. The diagonal entry is not set.
+template <typename T>
+void assemble_matrix(
+    la::MatrixCSR<T>& A, const Form<T>& a,
+    const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  assemble_matrix(A.mat_add_values(), a, constants, coefficients, bcs);
+}
+
+/// Assemble bilinear form into a distributed CSR matrix, packing the
+/// constants and coefficients of the form. See the overload above for
+/// the assembly and finalisation semantics.
+/// @param[in,out] A The matrix to assemble into
+/// @param[in] a The bilinear form to assemble
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+/// dofs the row and column are zeroed. The diagonal entry is not set.
+template <typename T>
+void assemble_matrix(
+    la::MatrixCSR<T>& A, const Form<T>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  assemble_matrix(A.mat_add_values(), a, bcs);
+}
+
+/// Build the element-to-CSR offset map for a bilinear form, for use
+/// with assemble_matrix_refill. For each cell, the map holds the
+/// direct offset of every element matrix entry into the value arrays
+/// of `A` (see la::MatrixCSR::entry_offset), with entries on rows or
+/// columns carrying a Dirichlet condition masked with -1. The map
+/// depends only on the dofmaps, the sparsity pattern and the boundary
+/// conditions, so it is computed once and reused across refill
+/// assemblies.
+/// @param[in] A The matrix the form will be assembled into. Must be
+/// built on an assembled sparsity pattern for the form.
+/// @param[in] a The bilinear form
+/// @param[in] bcs Boundary conditions that will be applied. Rows and
+/// columns with a condition applied are masked in the map.
+/// @return Offset map of shape (num_cells, ndim0 * ndim1), flattened
+template <typename T>
+std::vector<std::int64_t> create_element_csr_map(
+    const la::MatrixCSR<T>& A, const Form<T>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+  const int bs0 = dofmap0->bs();
+  const int bs1 = dofmap1->bs();
+
+  // Build dof markers (see assemble_matrix)
+  auto map0 = dofmap0->index_map;
+  auto map1 = dofmap1->index_map;
+  assert(map0);
+  assert(map1);
+  std::vector<bool> dof_marker0, dof_marker1;
+  const std::int32_t dim0 = dofmap0->index_map_bs()
+                            * (map0->size_local() + map0->num_ghosts());
+  const std::int32_t dim1 = dofmap1->index_map_bs()
+                            * (map1->size_local() + map1->num_ghosts());
+  for (std::size_t k = 0; k < bcs.size(); ++k)
+  {
+    assert(bcs[k]);
+    assert(bcs[k]->function_space());
+    if (a.function_spaces().at(0)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker0.resize(dim0, false);
+      bcs[k]->mark_dofs(dof_marker0);
+    }
+    if (a.function_spaces().at(1)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker1.resize(dim1, false);
+      bcs[k]->mark_dofs(dof_marker1);
+    }
+  }
+
+  const std::int32_t num_cells = dofs0.num_nodes();
+  const int num_dofs0 = dofs0.links(0).size();
+  const int num_dofs1 = dofs1.links(0).size();
+  const int ndim0 = bs0 * num_dofs0;
+  const int ndim1 = bs1 * num_dofs1;
+  std::vector<std::int64_t> element_map(std::int64_t(num_cells) * ndim0
+                                        * ndim1);
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    auto cell_dofs0 = dofs0.links(c);
+    auto cell_dofs1 = dofs1.links(c);
+    std::int64_t* map_cell
+        = element_map.data() + std::int64_t(c) * ndim0 * ndim1;
+    for (int i = 0; i < num_dofs0; ++i)
+    {
+      for (int k0 = 0; k0 < bs0; ++k0)
+      {
+        const std::int32_t row = bs0 * cell_dofs0[i] + k0;
+        const bool bc_row = !dof_marker0.empty() and dof_marker0[row];
+        std::int64_t* map_row = map_cell + std::int64_t(bs0 * i + k0) * ndim1;
+        for (int j = 0; j < num_dofs1; ++j)
+        {
+          for (int k1 = 0; k1 < bs1; ++k1)
+          {
+            const std::int32_t col = bs1 * cell_dofs1[j] + k1;
+            if (bc_row or (!dof_marker1.empty() and dof_marker1[col]))
+              map_row[bs1 * j + k1] = -1;
+            else
+              map_row[bs1 * j + k1] = A.entry_offset(row, col);
+          }
+        }
+      }
+    }
+  }
+
+  return element_map;
+}
+
+/// Re-assemble a bilinear form into a CSR matrix through a precomputed
+/// element-to-CSR offset map (see create_element_csr_map): kernel
+/// output is streamed straight into the value arrays with no column
+/// search, and rows and columns with a Dirichlet condition stay zero
+/// through the mask in the map. The form must have cell integrals
+/// only. Does not zero the matrix; call MatrixCSR::set(0) before
+/// re-assembly and MatrixCSR::finalize and set_diagonal afterwards, as
+/// for assemble_matrix.
+/// @param[in,out] A The matrix to assemble into
+/// @param[in] a The bilinear form to assemble
+/// @param[in] element_map The element-to-CSR offset map for `a` and
+/// `A`
+/// @param[in] constants Constants that appear in `a`
+/// @param[in] coefficients Coefficients that appear in `a`
+template <typename T>
+void assemble_matrix_refill(
+    la::MatrixCSR<T>& A, const Form<T>& a,
+    const xtl::span<const std::int64_t>& element_map,
+    const xtl::span<const T>& constants,
+    const std::map<std::pair<IntegralType, int>,
+                   std::pair<xtl::span<const T>, int>>& coefficients)
+{
+  impl::assemble_matrix_refill(A, a, element_map, constants, coefficients);
+}
+
+/// Re-assemble a bilinear form into a CSR matrix through a precomputed
+/// element-to-CSR offset map, packing the constants and coefficients
+/// of the form. See the overload above for the assembly semantics.
+/// @param[in,out] A The matrix to assemble into
+/// @param[in] a The bilinear form to assemble
+/// @param[in] element_map The element-to-CSR offset map for `a` and
+/// `A`
+template <typename T>
+void assemble_matrix_refill(la::MatrixCSR<T>& A, const Form<T>& a,
+                            const xtl::span<const std::int64_t>& element_map)
+{
+  const std::vector<T>& constants = a.packed_constants();
+  const auto coefficients = pack_coefficients(a);
+  assemble_matrix_refill(A, a, element_map, tcb::make_span(constants),
+                         make_coefficients_span(coefficients));
+}
+
+/// Assemble a bilinear form into a matrix and a linear form into a
+/// vector in a single sweep over cells. Equivalent to assemble_matrix
+/// followed by assemble_vector, but each cell is visited once, sharing
+/// the geometry gather between the two kernels and packing the
+/// coefficients of both forms in one per-cell block. Intended for
+/// Newton-type iterations, where the Jacobian and the residual are
+/// built over the same cells. Both forms must be defined over cell
+/// integrals only, with identical cell domains, and `L` must have the
+/// same test space as `a`. Rows and columns of the matrix with boundary
+/// conditions are zeroed (the diagonal entry is not set); the vector is
+/// not modified by the bcs.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] a The bilinear form to assemble
+/// @param[in] L The linear form to assemble into b
+/// @param[in] bcs Boundary conditions to apply to the matrix
+template <typename T>
+void assemble_matrix_vector(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    xtl::span<T> b, const Form<T>& a, const Form<T>& L,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  // Prepare constants and coefficients
+  const std::vector<T>& constants_a = a.packed_constants();
+  const auto coefficients_a = pack_coefficients(a);
+  const std::vector<T>& constants_L = L.packed_constants();
+  const auto coefficients_L = pack_coefficients(L);
+
+  // Index maps for dof ranges
+  auto map0 = a.function_spaces().at(0)->dofmap()->index_map;
+  auto map1 = a.function_spaces().at(1)->dofmap()->index_map;
+  auto bs0 = a.function_spaces().at(0)->dofmap()->index_map_bs();
+  auto bs1 = a.function_spaces().at(1)->dofmap()->index_map_bs();
+
+  // Build dof markers
+  std::vector<bool> dof_marker0, dof_marker1;
+  assert(map0);
+  std::int32_t dim0 = bs0 * (map0->size_local() + map0->num_ghosts());
+  assert(map1);
+  std::int32_t dim1 = bs1 * (map1->size_local() + map1->num_ghosts());
+  for (std::size_t k = 0; k < bcs.size(); ++k)
+  {
+    assert(bcs[k]);
+    assert(bcs[k]->function_space());
+    if (a.function_spaces().at(0)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker0.resize(dim0, false);
+      bcs[k]->mark_dofs(dof_marker0);
+    }
+
+    if (a.function_spaces().at(1)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker1.resize(dim1, false);
+      bcs[k]->mark_dofs(dof_marker1);
+    }
+  }
+
+  // Assemble
+  impl::assemble_matrix_vector(
+      mat_add, b, a, L, tcb::make_span(constants_a),
+      make_coefficients_span(coefficients_a), tcb::make_span(constants_L),
+      make_coefficients_span(coefficients_L), dof_marker0, dof_marker1);
+}
+
 /// Sets a value to the diagonal of a matrix for specified rows. It is
 /// typically called after assembly. The assembly function zeroes
 /// Dirichlet rows and columns. For block matrices, this function should
@@ -367,6 +983,54 @@ void set_diagonal(
   }
 }
 
+/// Sets a value to the diagonal of a native CSR matrix for specified
+/// rows. All rows are applied in one batched pass through the
+/// precomputed diagonal-position array of the matrix (see
+/// la::MatrixCSR::diagonal_positions), with no per-row insertion call
+/// or column search. It is typically called after assembly, and at
+/// every Jacobian rebuild the column searches are not repeated.
+/// @param[in] A The matrix to set diagonal values of
+/// @param[in] rows The rows, in local indices, for which to set the
+///   diagonal
+/// @param[in] diagonal The value to set on the diagonal for the
+///   specified rows
+template <typename T>
+void set_diagonal(la::MatrixCSR<T>& A,
+                  const xtl::span<const std::int32_t>& rows, T diagonal = 1.0)
+{
+  A.set_diagonal(rows, diagonal);
+}
+
+/// Sets a value to the diagonal of a native CSR matrix for rows with a
+/// Dirichlet boundary condition applied, batching all rows of each
+/// condition through the precomputed diagonal-position array of the
+/// matrix. Only locally owned rows are written, so no parallel
+/// communication is created. For block matrices, this function should
+/// normally be called only on the diagonal blocks, i.e. blocks for
+/// which the test and trial spaces are the same.
+/// @param[in] A The matrix to set diagonal values of
+/// @param[in] V The function space for the rows and columns of the
+///   matrix. It is used to extract only the Dirichlet boundary
+///   conditions that are defined on V or subspaces of V.
+/// @param[in] bcs The Dirichlet boundary conditions
+/// @param[in] diagonal The value to set on the diagonal for rows with
+///   a boundary condition applied
+template <typename T>
+void set_diagonal(la::MatrixCSR<T>& A, const fem::FunctionSpace& V,
+                  const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+                  T diagonal = 1.0)
+{
+  for (const auto& bc : bcs)
+  {
+    assert(bc);
+    if (V.contains(*bc->function_space()))
+    {
+      const auto [dofs, range] = bc->dof_indices();
+      A.set_diagonal(dofs.first(range), diagonal);
+    }
+  }
+}
+
 // -- Setting bcs ------------------------------------------------------------
 
 // FIXME: Move these function elsewhere?
@@ -0,0 +1,332 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DofMap.h"
+#include "ElementDofLayout.h"
+#include "Form.h"
+#include "FunctionSpace.h"
+#include "utils.h"
+#include <algorithm>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <functional>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::fem
+{
+namespace impl
+{
+/// Solve the dense system A X = B in-place by Gaussian elimination
+/// with partial pivoting. A is n x n and B is n x m, both row-major;
+/// on return B holds X and A is overwritten.
+template <typename T>
+void solve_dense(const xtl::span<T>& A, const xtl::span<T>& B, int n, int m)
+{
+  for (int k = 0; k < n; ++k)
+  {
+    // Partial pivoting
+    int p = k;
+    for (int i = k + 1; i < n; ++i)
+    {
+      if (std::abs(A[i * n + k]) > std::abs(A[p * n + k]))
+        p = i;
+    }
+    if (p != k)
+    {
+      for (int j = 0; j < n; ++j)
+        std::swap(A[k * n + j], A[p * n + j]);
+      for (int j = 0; j < m; ++j)
+        std::swap(B[k * m + j], B[p * m + j]);
+    }
+
+    if (A[k * n + k] == T(0))
+      throw std::runtime_error("Singular interior block in condensation");
+
+    for (int i = k + 1; i < n; ++i)
+    {
+      const T f = A[i * n + k] / A[k * n + k];
+      for (int j = k; j < n; ++j)
+        A[i * n + j] -= f * A[k * n + j];
+      for (int j = 0; j < m; ++j)
+        B[i * m + j] -= f * B[k * m + j];
+    }
+  }
+
+  // Back substitution
+  for (int k = n - 1; k >= 0; --k)
+  {
+    for (int j = 0; j < m; ++j)
+    {
+      T s = B[k * m + j];
+      for (int i = k + 1; i < n; ++i)
+        s -= A[k * n + i] * B[i * m + j];
+      B[k * m + j] = s / A[k * n + k];
+    }
+  }
+}
+} // namespace impl
+
+/// Assemble a bilinear form with element-wise static condensation of
+/// the cell-interior degrees of freedom. For each cell, with the
+/// element tensor partitioned into trace (t) and interior (i) blocks,
+///
+///     S = A_tt - A_ti inv(A_ii) A_it
+///
+/// is assembled into the matrix at the trace dofs only, so the global
+/// system contains no interior dofs. Interior values can be recovered
+/// with backsubstitute(). The test and trial spaces must be the same
+/// and only cell integrals are supported.
+///
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear form to assemble
+/// @param[in] dof_marker0 Boundary condition markers for the rows
+/// @param[in] dof_marker1 Boundary condition markers for the columns
+template <typename T>
+void assemble_matrix_condensed(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    const Form<T>& a, const std::vector<bool>& dof_marker0,
+    const std::vector<bool>& dof_marker1)
+{
+  if (a.function_spaces().at(0) != a.function_spaces().at(1))
+  {
+    throw std::runtime_error(
+        "Static condensation requires identical test and trial spaces");
+  }
+  if (a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    throw std::runtime_error(
+        "Static condensation supports cell integrals only");
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  std::shared_ptr<const fem::DofMap> dofmap
+      = a.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+  const int bs = dofmap->bs();
+
+  std::shared_ptr<const fem::FiniteElement> element
+      = a.function_spaces().at(0)->element();
+  if (element->needs_dof_transformations())
+  {
+    throw std::runtime_error(
+        "Static condensation does not support dof transformations");
+  }
+
+  // Split element dofs into interior (attached to the cell itself) and
+  // trace dofs
+  const int tdim = mesh->topology().dim();
+  assert(dofmap->element_dof_layout);
+  const std::vector<int>& interior
+      = dofmap->element_dof_layout->entity_dofs(tdim, 0);
+  const int num_dofs = dofs.links(0).size();
+  std::vector<int> trace;
+  for (int i = 0; i < num_dofs; ++i)
+  {
+    if (std::find(interior.begin(), interior.end(), i) == interior.end())
+      trace.push_back(i);
+  }
+
+  const int ni = bs * interior.size();
+  const int nt = bs * trace.size();
+  const int ndim = bs * num_dofs;
+
+  // Pack constants and coefficients
+  const std::vector<T>& constants = a.packed_constants();
+  const auto coefficients = pack_coefficients(a);
+
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap
+      = mesh->geometry().dofmap();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = mesh->geometry().x();
+
+  std::vector<double> coordinate_dofs(3 * num_dofs_g);
+  std::vector<T> Ae(ndim * ndim), A_ii(ni * ni), A_it(ni * nt), S(nt * nt);
+  std::vector<std::int32_t> trace_dofs(trace.size());
+
+  for (int id : a.integral_ids(IntegralType::cell))
+  {
+    const auto& kernel = a.kernel(IntegralType::cell, id);
+    const auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, id});
+    const std::vector<std::int32_t>& cells = a.cell_domains(id);
+    for (std::size_t index = 0; index < cells.size(); ++index)
+    {
+      std::int32_t c = cells[index];
+
+      // Get cell coordinates/geometry
+      auto x_dofs = x_dofmap.links(c);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                    std::next(coordinate_dofs.begin(), 3 * i));
+      }
+
+      // Tabulate full element tensor
+      std::fill(Ae.begin(), Ae.end(), 0);
+      kernel(Ae.data(), coeffs.data() + index * cstride,
+             constants.data(), coordinate_dofs.data(), nullptr, nullptr);
+
+      // Gather blocks: A_ii, A_it and S <- A_tt
+      auto e = [bs](const std::vector<int>& set, int p)
+      { return bs * set[p / bs] + p % bs; };
+      for (int i = 0; i < ni; ++i)
+      {
+        for (int j = 0; j < ni; ++j)
+          A_ii[i * ni + j] = Ae[e(interior, i) * ndim + e(interior, j)];
+        for (int j = 0; j < nt; ++j)
+          A_it[i * nt + j] = Ae[e(interior, i) * ndim + e(trace, j)];
+      }
+      for (int i = 0; i < nt; ++i)
+        for (int j = 0; j < nt; ++j)
+          S[i * nt + j] = Ae[e(trace, i) * ndim + e(trace, j)];
+
+      // X = inv(A_ii) A_it, then S -= A_ti X
+      impl::solve_dense<T>(xtl::span<T>(A_ii), xtl::span<T>(A_it), ni, nt);
+      for (int i = 0; i < nt; ++i)
+      {
+        for (int k = 0; k < ni; ++k)
+        {
+          const T a_ti = Ae[e(trace, i) * ndim + e(interior, k)];
+          for (int j = 0; j < nt; ++j)
+            S[i * nt + j] -= a_ti * A_it[k * nt + j];
+        }
+      }
+
+      // Zero rows/columns for essential bcs on trace dofs
+      auto cell_dofs = dofs.links(c);
+      for (std::size_t i = 0; i < trace.size(); ++i)
+        trace_dofs[i] = cell_dofs[trace[i]];
+      if (!dof_marker0.empty())
+      {
+        for (std::size_t i = 0; i < trace.size(); ++i)
+          for (int k = 0; k < bs; ++k)
+            if (dof_marker0[bs * trace_dofs[i] + k])
+              std::fill_n(std::next(S.begin(), nt * (bs * i + k)), nt, 0.0);
+      }
+      if (!dof_marker1.empty())
+      {
+        for (std::size_t j = 0; j < trace.size(); ++j)
+          for (int k = 0; k < bs; ++k)
+            if (dof_marker1[bs * trace_dofs[j] + k])
+              for (int row = 0; row < nt; ++row)
+                S[row * nt + bs * j + k] = 0.0;
+      }
+
+      mat_add(trace_dofs.size(), trace_dofs.data(), trace_dofs.size(),
+              trace_dofs.data(), S.data());
+    }
+  }
+}
+
+/// Recover cell-interior degrees of freedom after a condensed solve.
+/// For each cell the interior values are computed by back-substitution,
+///
+///     u_i = inv(A_ii) (b_i - A_it u_t),
+///
+/// where u_t are the (already solved) trace values in `u` and `b` is
+/// the un-condensed right-hand side. Interior entries of `u` are
+/// overwritten; trace entries are untouched. The caller is responsible
+/// for scattering ghost values of `u` afterwards.
+///
+/// @param[in] a The bilinear form that was condensed
+/// @param[in,out] u Solution vector holding trace values on entry
+/// @param[in] b The original (un-condensed) right-hand side
+template <typename T>
+void backsubstitute(const Form<T>& a, const xtl::span<T>& u,
+                    const xtl::span<const T>& b)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  std::shared_ptr<const fem::DofMap> dofmap
+      = a.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+  const int bs = dofmap->bs();
+
+  const int tdim = mesh->topology().dim();
+  assert(dofmap->element_dof_layout);
+  const std::vector<int>& interior
+      = dofmap->element_dof_layout->entity_dofs(tdim, 0);
+  const int num_dofs = dofs.links(0).size();
+  std::vector<int> trace;
+  for (int i = 0; i < num_dofs; ++i)
+  {
+    if (std::find(interior.begin(), interior.end(), i) == interior.end())
+      trace.push_back(i);
+  }
+
+  const int ni = bs * interior.size();
+  const int nt = bs * trace.size();
+  const int ndim = bs * num_dofs;
+
+  const std::vector<T>& constants = a.packed_constants();
+  const auto coefficients = pack_coefficients(a);
+
+  const graph::AdjacencyList<std::int32_t>& x_dofmap
+      = mesh->geometry().dofmap();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = mesh->geometry().x();
+
+  std::vector<double> coordinate_dofs(3 * num_dofs_g);
+  std::vector<T> Ae(ndim * ndim), A_ii(ni * ni), u_i(ni);
+
+  for (int id : a.integral_ids(IntegralType::cell))
+  {
+    const auto& kernel = a.kernel(IntegralType::cell, id);
+    const auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, id});
+    const std::vector<std::int32_t>& cells = a.cell_domains(id);
+    for (std::size_t index = 0; index < cells.size(); ++index)
+    {
+      std::int32_t c = cells[index];
+
+      auto x_dofs = x_dofmap.links(c);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                    std::next(coordinate_dofs.begin(), 3 * i));
+      }
+
+      std::fill(Ae.begin(), Ae.end(), 0);
+      kernel(Ae.data(), coeffs.data() + index * cstride,
+             constants.data(), coordinate_dofs.data(), nullptr, nullptr);
+
+      auto e = [bs](const std::vector<int>& set, int p)
+      { return bs * set[p / bs] + p % bs; };
+      auto cell_dofs = dofs.links(c);
+
+      // u_i <- b_i - A_it u_t, A_ii gathered alongside
+      for (int i = 0; i < ni; ++i)
+      {
+        T s = b[bs * cell_dofs[interior[i / bs]] + i % bs];
+        for (int j = 0; j < nt; ++j)
+        {
+          s -= Ae[e(interior, i) * ndim + e(trace, j)]
+               * u[bs * cell_dofs[trace[j / bs]] + j % bs];
+        }
+        u_i[i] = s;
+        for (int j = 0; j < ni; ++j)
+          A_ii[i * ni + j] = Ae[e(interior, i) * ndim + e(interior, j)];
+      }
+
+      impl::solve_dense<T>(xtl::span<T>(A_ii), xtl::span<T>(u_i), ni, 1);
+      for (int i = 0; i < ni; ++i)
+        u[bs * cell_dofs[interior[i / bs]] + i % bs] = u_i[i];
+    }
+  }
+}
+
+} // namespace dolfinx::fem
@@ -73,67 +73,89 @@ fem::create_sparsity_discrete_gradient(const fem::FunctionSpace& V0,
   auto e_to_v = mesh->topology().connectivity(1, 0);
   mesh->topology_mutable().create_connectivity(tdim, 1);
   auto c_to_e = mesh->topology().connectivity(tdim, 1);
-  mesh->topology_mutable().create_connectivity(1, tdim);
-  auto e_to_c = mesh->topology().connectivity(1, tdim);
   mesh->topology_mutable().create_connectivity(tdim, 0);
   auto c_to_v = mesh->topology().connectivity(tdim, 0);
 
-  // Build sparsity pattern
+  // Build edge -> dof and vertex -> dof lookup tables
+  const std::array<std::vector<std::int32_t>, 2> entity_dofs
+      = impl::build_discrete_gradient_entity_dofs(*mesh, *V0.dofmap(),
+                                                  *layout0, *V1.dofmap(),
+                                                  *layout1);
+  const std::vector<std::int32_t>& edge_dof = entity_dofs[0];
+  const std::vector<std::int32_t>& vertex_dof = entity_dofs[1];
+
+  // Each edge dof row couples to exactly the two vertex dofs of the
+  // edge
   const std::int32_t num_edges = mesh->topology().index_map(1)->size_local()
                                  + mesh->topology().index_map(1)->num_ghosts();
-  const std::shared_ptr<const fem::DofMap> dofmap0 = V0.dofmap();
-  assert(dofmap0);
-  // Create local lookup table for local edge to cell dofs
-  const int num_edges_per_cell
-      = mesh::cell_num_entities(mesh->topology().cell_type(), 1);
-  std::map<std::int32_t, std::vector<std::int32_t>> local_edge_dofs;
-  for (std::int32_t i = 0; i < num_edges_per_cell; ++i)
-    local_edge_dofs[i] = layout0->entity_dofs(1, i);
-  // Create local lookup table for local vertex to cell dofs
-  const int num_vertices_per_cell
-      = mesh::cell_num_entities(mesh->topology().cell_type(), 0);
-  std::map<std::int32_t, std::vector<std::int32_t>> local_vertex_dofs;
-  for (std::int32_t i = 0; i < num_vertices_per_cell; ++i)
-    local_vertex_dofs[i] = layout1->entity_dofs(0, i);
-
   std::array<std::int32_t, 2> cols;
   for (std::int32_t e = 0; e < num_edges; ++e)
   {
-    // Find local index of edge in one of the cells it is part of
-    xtl::span<const std::int32_t> cells = e_to_c->links(e);
-    assert(cells.size() > 0);
-    const std::int32_t cell = cells[0];
-    xtl::span<const std::int32_t> edges = c_to_e->links(cell);
-    const auto it = std::find(edges.begin(), edges.end(), e);
-    assert(it != edges.end());
-    const int local_edge = std::distance(edges.begin(), it);
-
-    // Find the dofs located on the edge
-    xtl::span<const std::int32_t> dofs0 = dofmap0->cell_dofs(cell);
-    std::vector<std::int32_t>& local_dofs = local_edge_dofs[local_edge];
-    assert(local_dofs.size() == 1);
-    const std::int32_t row = dofs0[local_dofs[0]];
     xtl::span<const std::int32_t> vertices = e_to_v->links(e);
     assert(vertices.size() == 2);
-    auto cell_vertices = c_to_v->links(cell);
-
-    // Find local index of each of the vertices and map to local dof
-    xtl::span<const std::int32_t> dofs1 = V1.dofmap()->cell_dofs(cell);
-    for (std::int32_t i = 0; i < 2; ++i)
-    {
-      const auto it
-          = std::find(cell_vertices.begin(), cell_vertices.end(), vertices[i]);
-      assert(it != cell_vertices.end());
-      const int local_vertex = std::distance(cell_vertices.begin(), it);
-      std::vector<std::int32_t>& local_v_dofs = local_vertex_dofs[local_vertex];
-
-      assert(local_v_dofs.size() == 1);
-      cols[i] = dofs1[local_v_dofs[0]];
-    }
-
+    const std::int32_t row = edge_dof[e];
+    cols = {vertex_dof[vertices[0]], vertex_dof[vertices[1]]};
     pattern.insert(xtl::span<const std::int32_t>(&row, 1),
                    tcb::make_span(cols));
   }
   pattern.assemble();
   return pattern;
 }
+//-----------------------------------------------------------------------------
+std::array<std::vector<std::int32_t>, 2>
+fem::impl::build_discrete_gradient_entity_dofs(
+    const mesh::Mesh& mesh, const fem::DofMap& dofmap0,
+    const fem::ElementDofLayout& layout0, const fem::DofMap& dofmap1,
+    const fem::ElementDofLayout& layout1)
+{
+  const int tdim = mesh.topology().dim();
+  auto c_to_e = mesh.topology().connectivity(tdim, 1);
+  assert(c_to_e);
+  auto c_to_v = mesh.topology().connectivity(tdim, 0);
+  assert(c_to_v);
+
+  // Local dof for each local edge/vertex (one dof per entity)
+  const int num_edges_per_cell
+      = mesh::cell_num_entities(mesh.topology().cell_type(), 1);
+  std::vector<std::int32_t> local_edge_dof(num_edges_per_cell);
+  for (int i = 0; i < num_edges_per_cell; ++i)
+  {
+    const std::vector<int> dofs = layout0.entity_dofs(1, i);
+    assert(dofs.size() == 1);
+    local_edge_dof[i] = dofs[0];
+  }
+  const int num_vertices_per_cell
+      = mesh::cell_num_entities(mesh.topology().cell_type(), 0);
+  std::vector<std::int32_t> local_vertex_dof(num_vertices_per_cell);
+  for (int i = 0; i < num_vertices_per_cell; ++i)
+  {
+    const std::vector<int> dofs = layout1.entity_dofs(0, i);
+    assert(dofs.size() == 1);
+    local_vertex_dof[i] = dofs[0];
+  }
+
+  // Scatter cell dofs to the entities in one sweep over cells
+  std::array<std::vector<std::int32_t>, 2> entity_dofs;
+  entity_dofs[0].resize(mesh.topology().index_map(1)->size_local()
+                        + mesh.topology().index_map(1)->num_ghosts());
+  entity_dofs[1].resize(mesh.topology().index_map(0)->size_local()
+                        + mesh.topology().index_map(0)->num_ghosts());
+  auto cell_map = mesh.topology().index_map(tdim);
+  assert(cell_map);
+  const std::int32_t num_cells
+      = cell_map->size_local() + cell_map->num_ghosts();
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    xtl::span<const std::int32_t> dofs0 = dofmap0.cell_dofs(c);
+    xtl::span<const std::int32_t> edges = c_to_e->links(c);
+    for (int i = 0; i < num_edges_per_cell; ++i)
+      entity_dofs[0][edges[i]] = dofs0[local_edge_dof[i]];
+
+    xtl::span<const std::int32_t> dofs1 = dofmap1.cell_dofs(c);
+    xtl::span<const std::int32_t> vertices = c_to_v->links(c);
+    for (int i = 0; i < num_vertices_per_cell; ++i)
+      entity_dofs[1][vertices[i]] = dofs1[local_vertex_dof[i]];
+  }
+
+  return entity_dofs;
+}
@@ -10,15 +10,37 @@
 #include "FunctionSpace.h"
 #include <array>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <memory>
+#include <thread>
 #include <vector>
 #include <xtl/xspan.hpp>
 
 namespace dolfinx::fem
 {
 
+namespace impl
+{
+/// Build edge -> dof and vertex -> dof lookup tables for the discrete
+/// gradient operator in a single sweep over cells. Both spaces must
+/// have exactly one dof per entity (lowest-order edge and P1 spaces;
+/// checked by the callers).
+/// @param[in] mesh The mesh. Edge and vertex entities and their
+/// cell connectivities must have been created.
+/// @param[in] dofmap0 Dofmap of the edge (H(curl)) space
+/// @param[in] layout0 Element dof layout of the edge space
+/// @param[in] dofmap1 Dofmap of the vertex (P1) space
+/// @param[in] layout1 Element dof layout of the vertex space
+/// @return Arrays mapping (0) edge index to edge dof and (1) vertex
+/// index to vertex dof, over owned and ghost entities
+std::array<std::vector<std::int32_t>, 2> build_discrete_gradient_entity_dofs(
+    const mesh::Mesh& mesh, const fem::DofMap& dofmap0,
+    const fem::ElementDofLayout& layout0, const fem::DofMap& dofmap1,
+    const fem::ElementDofLayout& layout1);
+} // namespace impl
+
 /// @todo Improve documentation
 /// This function class computes the sparsity pattern for discrete gradient
 /// operators (matrices) that map derivatives of finite element functions into
@@ -126,78 +148,68 @@ void fem::assemble_discrete_gradient(
   mesh->topology_mutable().create_connectivity(1, 0);
   auto e_to_v = mesh->topology().connectivity(1, 0);
   mesh->topology_mutable().create_connectivity(tdim, 1);
-  auto c_to_e = mesh->topology().connectivity(tdim, 1);
-  mesh->topology_mutable().create_connectivity(1, tdim);
-  auto e_to_c = mesh->topology().connectivity(1, tdim);
   mesh->topology_mutable().create_connectivity(tdim, 0);
-  auto c_to_v = mesh->topology().connectivity(tdim, 0);
 
-  // Build sparsity pattern
+  // Build edge -> dof and vertex -> dof lookup tables
+  const std::array<std::vector<std::int32_t>, 2> entity_dofs
+      = impl::build_discrete_gradient_entity_dofs(*mesh, *V0.dofmap(),
+                                                  *layout0, *V1.dofmap(),
+                                                  *layout1);
+  const std::vector<std::int32_t>& edge_dof = entity_dofs[0];
+  const std::vector<std::int32_t>& vertex_dof = entity_dofs[1];
+
+  // Each edge dof row has exactly the two vertex dofs of the edge as
+  // columns, with signs from the global vertex ordering. Compute all
+  // rows into preallocated arrays, threading over edge ranges, then
+  // stream them through the (serial) matrix insertion function.
   const std::int32_t num_edges = mesh->topology().index_map(1)->size_local()
                                  + mesh->topology().index_map(1)->num_ghosts();
-  const std::shared_ptr<const fem::DofMap> dofmap0 = V0.dofmap();
-  assert(dofmap0);
-  // Create local lookup table for local edge to cell dofs
-  const int num_edges_per_cell
-      = mesh::cell_num_entities(mesh->topology().cell_type(), 1);
-  std::map<std::int32_t, std::vector<std::int32_t>> local_edge_dofs;
-  for (std::int32_t i = 0; i < num_edges_per_cell; ++i)
-    local_edge_dofs[i] = layout0->entity_dofs(1, i);
-  // Create local lookup table for local vertex to cell dofs
-  const int num_vertices_per_cell
-      = mesh::cell_num_entities(mesh->topology().cell_type(), 0);
-  std::map<std::int32_t, std::vector<std::int32_t>> local_vertex_dofs;
-  for (std::int32_t i = 0; i < num_vertices_per_cell; ++i)
-    local_vertex_dofs[i] = layout1->entity_dofs(0, i);
-
-  // Build discrete gradient operator/matrix
-  const std::shared_ptr<const fem::DofMap> dofmap1 = V1.dofmap();
-  assert(dofmap1);
   const std::vector<std::int64_t>& global_indices
       = mesh->topology().index_map(0)->global_indices();
-  std::array<T, 2> Ae;
-  for (std::int32_t e = 0; e < num_edges; ++e)
+  std::vector<std::int32_t> rows(num_edges);
+  std::vector<std::int32_t> cols(2 * num_edges);
+  std::vector<T> values(2 * num_edges);
+  auto fill_rows = [&](std::int32_t begin, std::int32_t end)
   {
-    // Find local index of edge in one of the cells it is part of
-    xtl::span<const std::int32_t> cells = e_to_c->links(e);
-    assert(cells.size() > 0);
-    const std::int32_t cell = cells[0];
-    xtl::span<const std::int32_t> edges = c_to_e->links(cell);
-    const auto it = std::find(edges.begin(), edges.end(), e);
-    assert(it != edges.end());
-    const int local_edge = std::distance(edges.begin(), it);
-
-    // Find the dofs located on the edge
-    xtl::span<const std::int32_t> dofs0 = dofmap0->cell_dofs(cell);
-    std::vector<std::int32_t>& local_dofs = local_edge_dofs[local_edge];
-    assert(local_dofs.size() == 1);
-    const std::int32_t row = dofs0[local_dofs[0]];
-
-    xtl::span<const std::int32_t> vertices = e_to_v->links(e);
-    assert(vertices.size() == 2);
-    xtl::span<const std::int32_t> cell_vertices = c_to_v->links(cell);
-
-    // Find local index of each of the vertices and map to local dof
-    std::array<std::int32_t, 2> cols;
-    xtl::span<const std::int32_t> dofs1 = dofmap1->cell_dofs(cell);
-    for (std::int32_t i = 0; i < 2; ++i)
+    for (std::int32_t e = begin; e < end; ++e)
     {
-      const auto it
-          = std::find(cell_vertices.begin(), cell_vertices.end(), vertices[i]);
-      assert(it != cell_vertices.end());
-      const int local_vertex = std::distance(cell_vertices.begin(), it);
-
-      std::vector<std::int32_t>& local_v_dofs = local_vertex_dofs[local_vertex];
-      assert(local_v_dofs.size() == 1);
-      cols[i] = dofs1[local_v_dofs[0]];
+      xtl::span<const std::int32_t> vertices = e_to_v->links(e);
+      assert(vertices.size() == 2);
+      rows[e] = edge_dof[e];
+      cols[2 * e] = vertex_dof[vertices[0]];
+      cols[2 * e + 1] = vertex_dof[vertices[1]];
+      if (global_indices[vertices[1]] < global_indices[vertices[0]])
+      {
+        values[2 * e] = 1;
+        values[2 * e + 1] = -1;
+      }
+      else
+      {
+        values[2 * e] = -1;
+        values[2 * e + 1] = 1;
+      }
     }
+  };
 
-    if (global_indices[vertices[1]] < global_indices[vertices[0]])
-      Ae = {1, -1};
-    else
-      Ae = {-1, 1};
-
-    mat_set(1, &row, 2, cols.data(), Ae.data());
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads > 1)
+  {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+      const std::int32_t begin = (std::int64_t(num_edges) * t) / num_threads;
+      const std::int32_t end
+          = (std::int64_t(num_edges) * (t + 1)) / num_threads;
+      if (begin != end)
+        threads.emplace_back(fill_rows, begin, end);
+    }
+    for (std::thread& thread : threads)
+      thread.join();
   }
+  else
+    fill_rows(0, num_edges);
+
+  for (std::int32_t e = 0; e < num_edges; ++e)
+    mat_set(1, &rows[e], 2, &cols[2 * e], &values[2 * e]);
 }
 //-----------------------------------------------------------------------------
@@ -12,6 +12,7 @@
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Timer.h>
+#include <dolfinx/common/sort.h>
 #include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Topology.h>
@@ -20,7 +21,7 @@
 #include <memory>
 #include <numeric>
 #include <random>
-#include <unordered_map>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -31,6 +32,33 @@ namespace
 
 //-----------------------------------------------------------------------------
 
+/// Execute f(begin, end) over the index range [0, n), splitting the
+/// range across common::num_threads() threads. Writes from different
+/// sub-ranges must not overlap.
+template <typename Fn>
+void parallel_for_ranges(std::size_t n, Fn&& f)
+{
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads <= 1)
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    const std::size_t begin = (n * t) / num_threads;
+    const std::size_t end = (n * (t + 1)) / num_threads;
+    if (begin != end)
+      threads.emplace_back(f, begin, end);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+}
+
+//-----------------------------------------------------------------------------
+
 /// Build a graph for owned dofs and apply graph reordering function
 /// @param[in] dofmap The local dofmap (cell -> dofs)
 /// @param[in] owned_size Number of dofs owned by this process
@@ -194,88 +222,91 @@ build_basic_dofmap(const mesh::Topology& topology,
   std::partial_sum(std::next(cell_ptr.begin(), 1), cell_ptr.end(),
                    std::next(cell_ptr.begin(), 1));
 
-  // Allocate entity indices array
-  std::vector<std::vector<int32_t>> entity_indices_local(D + 1);
-  std::vector<std::vector<int64_t>> entity_indices_global(D + 1);
-  for (int d = 0; d <= D; ++d)
-  {
-    const int num_entities = mesh::cell_num_entities(topology.cell_type(), d);
-    entity_indices_local[d].resize(num_entities);
-    entity_indices_global[d].resize(num_entities);
-  }
-
   // Entity dofs on cell (dof = entity_dofs[dim][entity][index])
   const std::vector<std::vector<std::vector<int>>>& entity_dofs
       = element_dof_layout.entity_dofs_all();
 
+  // Dof offset for each topological dimension, in the process-local and
+  // the global numbering
+  std::vector<std::int32_t> offset_local(D + 1, 0);
+  std::vector<std::int64_t> offset_global(D + 1, 0);
+  for (int d = 0; d < D; ++d)
+  {
+    const std::int32_t num_entity_dofs = element_dof_layout.num_entity_dofs(d);
+    offset_local[d + 1]
+        = offset_local[d] + num_entity_dofs * num_mesh_entities_local[d];
+    offset_global[d + 1]
+        = offset_global[d] + num_entity_dofs * num_mesh_entities_global[d];
+  }
+
   // Storage for local-to-global map
   std::vector<std::int64_t> local_to_global(local_size);
 
   // Dof -> (dim, entity index) marker
   std::vector<std::pair<std::int8_t, std::int32_t>> dof_entity(local_size);
 
-  // Loops over cells and build dofmaps from ElementDofmap
-  for (int c = 0; c < connectivity[0]->num_nodes(); ++c)
+  // Number dofs directly from the entity indices: the dofs attached to
+  // entity e of dimension d occupy the contiguous range starting at
+  // offset_local[d] + num_entity_dofs*e. Each entity writes a disjoint
+  // slice, so the loop over entities is split across threads.
+  for (int d = 0; d <= D; ++d)
   {
-    // Get local (process) and global indices for each cell entity
-    for (int d = 0; d < D; ++d)
-    {
-      if (needs_entities[d])
-      {
-        auto entities = connectivity[d]->links(c);
-        for (std::size_t i = 0; i < entities.size(); ++i)
-        {
-          entity_indices_local[d][i] = entities[i];
-          entity_indices_global[d][i] = global_indices[d][entities[i]];
-        }
-      }
-    }
-
-    // Handle cell index separately because cell.entities(D) doesn't work.
-    if (needs_entities[D])
-    {
-      entity_indices_global[D][0] = global_indices[D][c];
-      entity_indices_local[D][0] = c;
-    }
+    if (!needs_entities[d])
+      continue;
 
-    // Iterate over each topological dimension
-    std::int32_t offset_local = 0;
-    std::int64_t offset_global = 0;
-    for (auto e_dofs_d = entity_dofs.begin(); e_dofs_d != entity_dofs.end();
-         ++e_dofs_d)
-    {
-      const std::size_t d = std::distance(entity_dofs.begin(), e_dofs_d);
+    const std::int32_t num_entity_dofs = element_dof_layout.num_entity_dofs(d);
+    parallel_for_ranges(
+        num_mesh_entities_local[d],
+        [&, d, num_entity_dofs](std::size_t begin, std::size_t end)
+        {
+          for (std::size_t e = begin; e < end; ++e)
+          {
+            const std::int32_t dof0 = offset_local[d] + num_entity_dofs * e;
+            const std::int64_t dof0_global
+                = offset_global[d] + num_entity_dofs * global_indices[d][e];
+            for (std::int32_t count = 0; count < num_entity_dofs; ++count)
+            {
+              local_to_global[dof0 + count] = dof0_global + count;
+              dof_entity[dof0 + count] = {d, e};
+            }
+          }
+        });
+  }
 
-      // Iterate over each entity of current dimension d
-      for (auto e_dofs = e_dofs_d->begin(); e_dofs != e_dofs_d->end(); ++e_dofs)
+  // Loop over cells and gather the dof numbers of the cell entities
+  // into the dofmap. Cells write disjoint rows of the dofmap, so the
+  // loop is split across threads.
+  parallel_for_ranges(
+      num_cells,
+      [&](std::size_t begin, std::size_t end)
       {
-        // Get entity indices (local to cell, local to process, and
-        // global)
-        const std::size_t e = std::distance(e_dofs_d->begin(), e_dofs);
-        const std::int32_t e_index_local = entity_indices_local[d][e];
-        const std::int64_t e_index_global = entity_indices_global[d][e];
-
-        // Loop over dofs belong to entity e of dimension d (d, e)
-        // d: topological dimension
-        // e: local entity index
-        // dof_local: local index of dof at (d, e)
-        const std::size_t num_entity_dofs = e_dofs->size();
-        for (auto dof_local = e_dofs->begin(); dof_local != e_dofs->end();
-             ++dof_local)
+        for (std::size_t c = begin; c < end; ++c)
         {
-          const std::int32_t count = std::distance(e_dofs->begin(), dof_local);
-          const std::int32_t dof
-              = offset_local + num_entity_dofs * e_index_local + count;
-          dofs[cell_ptr[c] + *dof_local] = dof;
-          local_to_global[dof]
-              = offset_global + num_entity_dofs * e_index_global + count;
-          dof_entity[dof] = {d, e_index_local};
+          // Iterate over each topological dimension. Note: the cell
+          // index is handled separately because cell-cell connectivity
+          // is not created.
+          for (int d = 0; d <= D; ++d)
+          {
+            if (!needs_entities[d])
+              continue;
+
+            // Iterate over each entity of current dimension d
+            const std::vector<std::vector<int>>& e_dofs_d = entity_dofs[d];
+            for (std::size_t e = 0; e < e_dofs_d.size(); ++e)
+            {
+              const std::int32_t e_index_local
+                  = d == D ? c : connectivity[d]->links(c)[e];
+
+              // Loop over dofs belonging to entity e of dimension d
+              const std::vector<int>& e_dofs = e_dofs_d[e];
+              const std::int32_t dof0
+                  = offset_local[d] + e_dofs.size() * e_index_local;
+              for (std::size_t count = 0; count < e_dofs.size(); ++count)
+                dofs[cell_ptr[c] + e_dofs[count]] = dof0 + count;
+            }
+          }
         }
-      }
-      offset_local += entity_dofs[d][0].size() * num_mesh_entities_local[d];
-      offset_global += entity_dofs[d][0].size() * num_mesh_entities_global[d];
-    }
-  }
+      });
 
   return {
       graph::AdjacencyList<std::int32_t>(std::move(dofs), std::move(cell_ptr)),
@@ -486,25 +517,41 @@ std::pair<std::vector<std::int64_t>, std::vector<int>> get_global_indices(
 
     auto [neighbors, _] = dolfinx::MPI::neighbors(comm[d]);
 
-    // Build (global old, global new) map for dofs of dimension d
-    std::unordered_map<std::int64_t, std::pair<int64_t, int>> global_old_new;
-    for (std::size_t j = 0; j < all_dofs_received[d].size(); j += 2)
+    // Sort the received (global old, global new) pairs by the old
+    // global index so that the lookups below can use binary search.
+    // Keys are shifted to start at zero for the radix argsort.
+    const std::size_t num_recv = all_dofs_received[d].size() / 2;
+    std::vector<std::int64_t> keys(num_recv);
+    for (std::size_t j = 0; j < num_recv; ++j)
+      keys[j] = all_dofs_received[d][2 * j];
+    std::int64_t key0 = 0;
+    if (!keys.empty())
     {
-      const auto pos
-          = std::upper_bound(disp_recv[d].begin(), disp_recv[d].end(), j);
-      const int owner = std::distance(disp_recv[d].begin(), pos) - 1;
-      global_old_new.insert({all_dofs_received[d][j],
-                             {all_dofs_received[d][j + 1], neighbors[owner]}});
+      key0 = *std::min_element(keys.begin(), keys.end());
+      std::for_each(keys.begin(), keys.end(), [key0](auto& k) { k -= key0; });
     }
+    std::vector<std::int32_t> perm(num_recv);
+    std::iota(perm.begin(), perm.end(), 0);
+    dolfinx::argsort_radix<std::int64_t>(xtl::span<const std::int64_t>(keys),
+                                         xtl::span<std::int32_t>(perm));
+    std::vector<std::int64_t> keys_sorted(num_recv);
+    for (std::size_t j = 0; j < num_recv; ++j)
+      keys_sorted[j] = keys[perm[j]];
 
     // Build the dimension d part of local_to_global_new vector
     for (std::size_t i = 0; i < local_new_to_global_old[d].size(); i += 2)
     {
-      auto it = global_old_new.find(local_new_to_global_old[d][i]);
-      assert(it != global_old_new.end());
-      local_to_global_new[local_new_to_global_old[d][i + 1]] = it->second.first;
+      const std::int64_t key = local_new_to_global_old[d][i] - key0;
+      auto it = std::lower_bound(keys_sorted.begin(), keys_sorted.end(), key);
+      assert(it != keys_sorted.end() and *it == key);
+      const std::size_t j = perm[std::distance(keys_sorted.begin(), it)];
+      const auto pos
+          = std::upper_bound(disp_recv[d].begin(), disp_recv[d].end(), 2 * j);
+      const int owner = std::distance(disp_recv[d].begin(), pos) - 1;
+      local_to_global_new[local_new_to_global_old[d][i + 1]]
+          = all_dofs_received[d][2 * j + 1];
       local_to_global_new_owner[local_new_to_global_old[d][i + 1]]
-          = it->second.second;
+          = neighbors[owner];
     }
   }
 
@@ -563,20 +610,25 @@ fem::build_dofmap_data(
                               local_to_global_owner.end())),
       local_to_global_unowned, local_to_global_owner);
 
-  // Build re-ordered dofmap
+  // Build re-ordered dofmap. Cells write disjoint rows, so the loop is
+  // split across threads. Note: structured bindings cannot be captured
+  // by the lambda, hence the references.
+  const graph::AdjacencyList<std::int32_t>& graph0 = node_graph0;
+  const std::vector<std::int32_t>& remap = old_to_new;
   std::vector<std::int32_t> dofmap(node_graph0.array().size());
-  for (std::int32_t cell = 0; cell < node_graph0.num_nodes(); ++cell)
-  {
-    // Get dof order on this cell
-    auto old_nodes = node_graph0.links(cell);
-    const std::int32_t local_dim0 = old_nodes.size();
-    for (std::int32_t j = 0; j < local_dim0; ++j)
-    {
-      const std::int32_t old_node = old_nodes[j];
-      const std::int32_t new_node = old_to_new[old_node];
-      dofmap[local_dim0 * cell + j] = new_node;
-    }
-  }
+  parallel_for_ranges(node_graph0.num_nodes(),
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t cell = begin; cell < end; ++cell)
+                        {
+                          // Get dof order on this cell
+                          auto old_nodes = graph0.links(cell);
+                          const std::int32_t local_dim0 = old_nodes.size();
+                          for (std::int32_t j = 0; j < local_dim0; ++j)
+                            dofmap[local_dim0 * cell + j]
+                                = remap[old_nodes[j]];
+                        }
+                      });
 
   assert(dofmap.size() % node_graph0.num_nodes() == 0);
   return {std::move(index_map), element_dof_layout.block_size(),
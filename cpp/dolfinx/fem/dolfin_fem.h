@@ -18,7 +18,11 @@ namespace dolfinx
 #include <dolfinx/fem/Form.h>
 #include <dolfinx/fem/Function.h>
 #include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/IncrementalAssembler.h>
+#include <dolfinx/fem/MatrixFreeOperator.h>
 #include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/condensation.h>
 #include <dolfinx/fem/discreteoperators.h>
+#include <dolfinx/fem/reduced_assembly.h>
 #include <dolfinx/fem/sparsitybuild.h>
 #include <dolfinx/fem/utils.h>
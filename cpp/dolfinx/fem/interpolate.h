@@ -9,7 +9,14 @@
 #include "CoordinateElement.h"
 #include "DofMap.h"
 #include "FiniteElement.h"
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ScratchArena.h>
+#include <dolfinx/common/ThreadPool.h>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/utils.h>
+#include <dolfinx/mesh/Mesh.h>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <vector>
 #include <xtensor/xarray.hpp>
@@ -38,34 +45,72 @@ namespace impl
 /// f1(x0), f0(x1), f1(x1), ...)
 /// @param[out] coeffs The degrees of freedom to compute
 /// @param[in] bs The block size
+/// @param[in] ident Set to true when Pi is the identity (point
+/// evaluation elements) to copy the data straight into the
+/// coefficients, skipping the matrix-vector product
 template <typename U, typename V, typename T>
 void interpolation_apply(const U& Pi, const V& data, std::vector<T>& coeffs,
-                         int bs)
+                         int bs, bool ident = false)
 {
-  // Compute coefficients = Pi * x (matrix-vector multiply)
+  // Fast path: the interpolation operator is the identity, so the
+  // (reordered) data are the coefficients
+  if (ident)
+  {
+    if (bs == 1)
+    {
+      assert(coeffs.size() == data.shape(0) * data.shape(1));
+      const std::size_t rows = data.shape(0);
+      for (std::size_t k = 0; k < data.shape(1); ++k)
+        for (std::size_t j = 0; j < rows; ++j)
+          coeffs[k * rows + j] = data(j, k);
+    }
+    else
+    {
+      assert(coeffs.size() == bs * data.shape(0));
+      for (std::size_t i = 0; i < data.shape(0); ++i)
+        for (int k = 0; k < bs; ++k)
+          coeffs[bs * i + k] = data(i, k);
+    }
+    return;
+  }
+
+  // Compute coefficients = Pi * x (matrix-vector multiply). The data
+  // are first packed contiguously in the column order of Pi so that
+  // each coefficient is a dot product of two contiguous ranges.
+  common::ScratchArena::Frame scratch;
   if (bs == 1)
   {
     assert(data.shape(0) * data.shape(1) == Pi.shape(1));
+    const std::size_t cols = Pi.shape(1);
+    const std::size_t rows = data.shape(0);
+    const xtl::span<T> d = scratch.allocate<T>(cols);
+    for (std::size_t k = 0; k < data.shape(1); ++k)
+      for (std::size_t j = 0; j < rows; ++j)
+        d[k * rows + j] = data(j, k);
+
     for (std::size_t i = 0; i < Pi.shape(0); ++i)
     {
-      coeffs[i] = 0.0;
-      for (std::size_t k = 0; k < data.shape(1); ++k)
-        for (std::size_t j = 0; j < data.shape(0); ++j)
-          coeffs[i] += Pi(i, k * data.shape(0) + j) * data(j, k);
+      T acc = 0;
+      for (std::size_t j = 0; j < cols; ++j)
+        acc += Pi(i, j) * d[j];
+      coeffs[i] = acc;
     }
   }
   else
   {
     const std::size_t cols = Pi.shape(1);
     assert(data.shape(0) == Pi.shape(1));
-    assert(data.shape(1) == bs);
+    assert(data.shape(1) == (std::size_t)bs);
+    const xtl::span<T> d = scratch.allocate<T>(cols);
     for (int k = 0; k < bs; ++k)
     {
+      for (std::size_t j = 0; j < cols; ++j)
+        d[j] = data(j, k);
       for (std::size_t i = 0; i < Pi.shape(0); ++i)
       {
         T acc = 0;
         for (std::size_t j = 0; j < cols; ++j)
-          acc += Pi(i, j) * data(j, k);
+          acc += Pi(i, j) * d[j];
         coeffs[bs * i + k] = acc;
       }
     }
@@ -244,6 +289,7 @@ void interpolate_nonmatching_maps(Function<T>& u1, const Function<T>& u0)
 
   // Get interpolation operator
   const xt::xtensor<double, 2>& Pi_1 = element1->interpolation_operator();
+  const bool ident1 = element1->interpolation_ident();
 
   using u_t = xt::xview<decltype(basis_reference0)&, std::size_t,
                         xt::xall<std::size_t>, xt::xall<std::size_t>>;
@@ -279,11 +325,10 @@ void interpolate_nonmatching_maps(Function<T>& u1, const Function<T>& u0)
     J.fill(0);
     for (std::size_t p = 0; p < X.shape(0); ++p)
     {
-      auto _J = xt::view(J, p, xt::all(), xt::all());
-      cmap.compute_jacobian(dphi, coordinate_dofs, _J);
-      cmap.compute_jacobian_inverse(_J, xt::view(K, p, xt::all(), xt::all()));
-      detJ[p] = cmap.compute_jacobian_determinant(_J);
+      cmap.compute_jacobian(dphi, coordinate_dofs,
+                            xt::view(J, p, xt::all(), xt::all()));
     }
+    cmap.compute_jacobian_inverse_batch(J, K, detJ);
 
     // Get evaluated basis on reference, apply DOF transformations, and
     // push forward to physical element
@@ -338,7 +383,7 @@ void interpolate_nonmatching_maps(Function<T>& u1, const Function<T>& u0)
     }
 
     auto _mapped_values0 = xt::view(mapped_values0, xt::all(), 0, xt::all());
-    interpolation_apply(Pi_1, _mapped_values0, local1, bs1);
+    interpolation_apply(Pi_1, _mapped_values0, local1, bs1, ident1);
     apply_inverse_dof_transform1(local1, cell_info, c, 1);
 
     // Copy local coefficients to the correct position in u dof array
@@ -416,11 +461,57 @@ void interpolate(
     cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
   }
 
-  // Evaluate function at physical points. The returned array has a
-  // number of rows equal to the number of components of the function,
-  // and the number of columns is equal to the number of evaluation
-  // points.
-  xt::xarray<T> values = f(x);
+  // Evaluate function at physical points. The array has a number of
+  // rows equal to the number of components of the function, and the
+  // number of columns is equal to the number of evaluation points. The
+  // mapping of values to points is by column, so the point array can
+  // be split into blocks and the function invoked per block on the
+  // thread pool. The function must therefore be safe to call
+  // concurrently.
+  common::ThreadPool& pool = common::thread_pool();
+  const std::size_t num_points = x.shape(1);
+  xt::xarray<T> values;
+  if (pool.num_workers() == 0 or num_points < 1024)
+    values = f(x);
+  else
+  {
+    const int num_blocks = pool.num_workers() + 1;
+    std::vector<xt::xarray<T>> values_b(num_blocks);
+    {
+      common::ThreadPool::TaskGroup tasks(pool);
+      for (int b = 0; b < num_blocks; ++b)
+      {
+        tasks.run(
+            [&, b]()
+            {
+              const std::size_t begin = (num_points * b) / num_blocks;
+              const std::size_t end = (num_points * (b + 1)) / num_blocks;
+              const xt::xtensor<double, 2> x_b
+                  = xt::view(x, xt::all(), xt::range(begin, end));
+              values_b[b] = f(x_b);
+            });
+      }
+    }
+
+    // Check the block shapes and splice the blocks back together
+    values.resize(
+        {static_cast<std::size_t>(element->value_size()), num_points});
+    for (int b = 0; b < num_blocks; ++b)
+    {
+      const std::size_t begin = (num_points * b) / num_blocks;
+      const std::size_t end = (num_points * (b + 1)) / num_blocks;
+      xt::xarray<T>& v_b = values_b[b];
+      if (v_b.dimension() == 1)
+      {
+        if (element->value_size() != 1)
+          throw std::runtime_error("Interpolation data has the wrong shape.");
+        v_b.reshape({std::size_t(1), end - begin});
+      }
+      if (v_b.shape(0) != values.shape(0) or v_b.shape(1) != end - begin)
+        throw std::runtime_error("Interpolation data has the wrong shape.");
+      xt::view(values, xt::all(), xt::range(begin, end)) = v_b;
+    }
+  }
 
   if (values.dimension() == 1)
   {
@@ -446,7 +537,6 @@ void interpolate(
   const int value_size = element->value_size() / element_bs;
 
   xtl::span<T> coeffs = u.x()->mutable_array();
-  std::vector<T> _coeffs(num_scalar_dofs);
 
   const std::function<void(const xtl::span<T>&,
                            const xtl::span<const std::uint32_t>&, std::int32_t,
@@ -455,25 +545,35 @@ void interpolate(
       = element->get_dof_transformation_function<T>(true, true, true);
 
   // This assumes that any element with an identity interpolation matrix
-  // is a point evaluation
+  // is a point evaluation. The scatter is threaded over chunks of
+  // cells; cells sharing a dof write the same interpolated value to
+  // the common entry of the coefficient array.
   if (element->interpolation_ident())
   {
-    for (std::int32_t c : cells)
-    {
-      xtl::span<const std::int32_t> dofs = dofmap->cell_dofs(c);
-      for (int k = 0; k < element_bs; ++k)
-      {
-        for (int i = 0; i < num_scalar_dofs; ++i)
-          _coeffs[i] = values(k, c * num_scalar_dofs + i);
-        apply_inverse_transpose_dof_transformation(_coeffs, cell_info, c, 1);
-        for (int i = 0; i < num_scalar_dofs; ++i)
+    pool.parallel_for(
+        cells.size(),
+        [&](std::size_t begin, std::size_t end)
         {
-          const int dof = i * element_bs + k;
-          std::div_t pos = std::div(dof, dofmap_bs);
-          coeffs[dofmap_bs * dofs[pos.quot] + pos.rem] = _coeffs[i];
-        }
-      }
-    }
+          std::vector<T> _coeffs(num_scalar_dofs);
+          for (std::size_t index = begin; index < end; ++index)
+          {
+            std::int32_t c = cells[index];
+            xtl::span<const std::int32_t> dofs = dofmap->cell_dofs(c);
+            for (int k = 0; k < element_bs; ++k)
+            {
+              for (int i = 0; i < num_scalar_dofs; ++i)
+                _coeffs[i] = values(k, c * num_scalar_dofs + i);
+              apply_inverse_transpose_dof_transformation(_coeffs, cell_info, c,
+                                                         1);
+              for (int i = 0; i < num_scalar_dofs; ++i)
+              {
+                const int dof = i * element_bs + k;
+                std::div_t pos = std::div(dof, dofmap_bs);
+                coeffs[dofmap_bs * dofs[pos.quot] + pos.rem] = _coeffs[i];
+              }
+            }
+          }
+        });
   }
   else
   {
@@ -487,17 +587,6 @@ void interpolate(
     const int num_dofs_g = x_dofmap.num_links(0);
     const xt::xtensor<double, 2>& x_g = mesh->geometry().x();
 
-    // Create data structures for Jacobian info
-    xt::xtensor<double, 3> J = xt::empty<double>({int(X.shape(0)), gdim, tdim});
-    xt::xtensor<double, 3> K = xt::empty<double>({int(X.shape(0)), tdim, gdim});
-    xt::xtensor<double, 1> detJ = xt::empty<double>({X.shape(0)});
-
-    xt::xtensor<double, 2> coordinate_dofs
-        = xt::empty<double>({num_dofs_g, gdim});
-
-    xt::xtensor<T, 3> reference_data({X.shape(0), 1, value_size});
-    xt::xtensor<T, 3> _vals({X.shape(0), 1, value_size});
-
     // Tabulate 1st order derivatives of shape functions at interpolation coords
     xt::xtensor<double, 3> dphi = xt::view(
         cmap.tabulate(1, X), xt::range(1, tdim + 1), xt::all(), xt::all(), 0);
@@ -511,66 +600,88 @@ void interpolate(
     // Get interpolation operator
     const xt::xtensor<double, 2>& Pi = element->interpolation_operator();
 
-    using U_t = xt::xview<decltype(reference_data)&, std::size_t,
+    using U_t = xt::xview<xt::xtensor<T, 3>&, std::size_t,
+                          xt::xall<std::size_t>, xt::xall<std::size_t>>;
+    using J_t = xt::xview<xt::xtensor<double, 3>&, std::size_t,
                           xt::xall<std::size_t>, xt::xall<std::size_t>>;
-    using J_t = xt::xview<decltype(J)&, std::size_t, xt::xall<std::size_t>,
-                          xt::xall<std::size_t>>;
     auto pull_back_fn = element->map_fn<U_t, U_t, J_t, J_t>();
 
-    for (std::int32_t c : cells)
-    {
-      auto x_dofs = x_dofmap.links(c);
-      for (int i = 0; i < num_dofs_g; ++i)
-        for (int j = 0; j < gdim; ++j)
-          coordinate_dofs(i, j) = x_g(x_dofs[i], j);
-
-      // Compute J, detJ and K
-      J.fill(0);
-      for (std::size_t p = 0; p < X.shape(0); ++p)
-      {
-        cmap.compute_jacobian(xt::view(dphi, xt::all(), p, xt::all()),
-                              coordinate_dofs,
-                              xt::view(J, p, xt::all(), xt::all()));
-        cmap.compute_jacobian_inverse(xt::view(J, p, xt::all(), xt::all()),
-                                      xt::view(K, p, xt::all(), xt::all()));
-        detJ[p] = cmap.compute_jacobian_determinant(
-            xt::view(J, p, xt::all(), xt::all()));
-      }
-
-      xtl::span<const std::int32_t> dofs = dofmap->cell_dofs(c);
-      for (int k = 0; k < element_bs; ++k)
-      {
-        // Extract computed expression values for element block k
-        for (int m = 0; m < value_size; ++m)
-        {
-          std::copy_n(&values(k * value_size + m, c * X.shape(0)), X.shape(0),
-                      xt::view(_vals, xt::all(), 0, m).begin());
-        }
-
-        // Get element degrees of freedom for block
-        for (std::size_t i = 0; i < X.shape(0); ++i)
-        {
-          auto _K = xt::view(K, i, xt::all(), xt::all());
-          auto _J = xt::view(J, i, xt::all(), xt::all());
-          auto _u = xt::view(_vals, i, xt::all(), xt::all());
-          auto _U = xt::view(reference_data, i, xt::all(), xt::all());
-          pull_back_fn(_U, _u, _K, 1.0 / detJ[i], _J);
-        }
-
-        auto ref_data = xt::view(reference_data, xt::all(), 0, xt::all());
-        impl::interpolation_apply(Pi, ref_data, _coeffs, element_bs);
-        apply_inverse_transpose_dof_transformation(_coeffs, cell_info, c, 1);
-
-        // Copy interpolation dofs into coefficient vector
-        assert(_coeffs.size() == num_scalar_dofs);
-        for (int i = 0; i < num_scalar_dofs; ++i)
+    // Interpolate over chunks of cells on the thread pool, with
+    // per-chunk scratch data. Cells sharing a dof write the same
+    // interpolated value to the common entry of the coefficient array.
+    pool.parallel_for(
+        cells.size(),
+        [&](std::size_t chunk_begin, std::size_t chunk_end)
         {
-          const int dof = i * element_bs + k;
-          std::div_t pos = std::div(dof, dofmap_bs);
-          coeffs[dofmap_bs * dofs[pos.quot] + pos.rem] = _coeffs[i];
-        }
-      }
-    }
+          // Create data structures for Jacobian info
+          xt::xtensor<double, 3> J
+              = xt::empty<double>({int(X.shape(0)), gdim, tdim});
+          xt::xtensor<double, 3> K
+              = xt::empty<double>({int(X.shape(0)), tdim, gdim});
+          xt::xtensor<double, 1> detJ = xt::empty<double>({X.shape(0)});
+
+          xt::xtensor<double, 2> coordinate_dofs
+              = xt::empty<double>({num_dofs_g, gdim});
+
+          xt::xtensor<T, 3> reference_data({X.shape(0), 1, value_size});
+          xt::xtensor<T, 3> _vals({X.shape(0), 1, value_size});
+          std::vector<T> _coeffs(num_scalar_dofs);
+
+          for (std::size_t index = chunk_begin; index < chunk_end; ++index)
+          {
+            std::int32_t c = cells[index];
+            auto x_dofs = x_dofmap.links(c);
+            for (int i = 0; i < num_dofs_g; ++i)
+              for (int j = 0; j < gdim; ++j)
+                coordinate_dofs(i, j) = x_g(x_dofs[i], j);
+
+            // Compute J, detJ and K
+            J.fill(0);
+            for (std::size_t p = 0; p < X.shape(0); ++p)
+            {
+              cmap.compute_jacobian(xt::view(dphi, xt::all(), p, xt::all()),
+                                    coordinate_dofs,
+                                    xt::view(J, p, xt::all(), xt::all()));
+            }
+            cmap.compute_jacobian_inverse_batch(J, K, detJ);
+
+            xtl::span<const std::int32_t> dofs = dofmap->cell_dofs(c);
+            for (int k = 0; k < element_bs; ++k)
+            {
+              // Extract computed expression values for element block k
+              for (int m = 0; m < value_size; ++m)
+              {
+                std::copy_n(&values(k * value_size + m, c * X.shape(0)),
+                            X.shape(0),
+                            xt::view(_vals, xt::all(), 0, m).begin());
+              }
+
+              // Get element degrees of freedom for block
+              for (std::size_t i = 0; i < X.shape(0); ++i)
+              {
+                auto _K = xt::view(K, i, xt::all(), xt::all());
+                auto _J = xt::view(J, i, xt::all(), xt::all());
+                auto _u = xt::view(_vals, i, xt::all(), xt::all());
+                auto _U = xt::view(reference_data, i, xt::all(), xt::all());
+                pull_back_fn(_U, _u, _K, 1.0 / detJ[i], _J);
+              }
+
+              auto ref_data = xt::view(reference_data, xt::all(), 0, xt::all());
+              impl::interpolation_apply(Pi, ref_data, _coeffs, element_bs);
+              apply_inverse_transpose_dof_transformation(_coeffs, cell_info, c,
+                                                         1);
+
+              // Copy interpolation dofs into coefficient vector
+              assert(_coeffs.size() == num_scalar_dofs);
+              for (int i = 0; i < num_scalar_dofs; ++i)
+              {
+                const int dof = i * element_bs + k;
+                std::div_t pos = std::div(dof, dofmap_bs);
+                coeffs[dofmap_bs * dofs[pos.quot] + pos.rem] = _coeffs[i];
+              }
+            }
+          }
+        });
   }
 }
 
@@ -615,6 +726,209 @@ void interpolate_c(
   interpolate<T>(u, fn, x, cells);
 }
 
+/// Interpolate a finite element Function defined on a non-matching
+/// mesh
+///
+/// The interpolation points of `u` (physical coordinates) are located
+/// in the mesh of `v` using the supplied bounding box tree. Points
+/// that are not inside any cell on this process are exchanged with the
+/// other ranks; each such point is assigned to the rank whose closest
+/// cell is nearest to it and the evaluated values are combined with a
+/// global reduction. The tree must be built over the cells of the mesh
+/// of `v`. Callers transferring fields repeatedly (e.g. every coupling
+/// step) should build the tree once and re-use it.
+/// @param[out] u The function to interpolate into
+/// @param[in] v The function to interpolate from, defined on a
+/// different mesh than `u`
+/// @param[in] tree Bounding box tree over the cells of the mesh of `v`
+template <typename T>
+void interpolate_nonmatching(Function<T>& u, const Function<T>& v,
+                             const geometry::BoundingBoxTree& tree)
+{
+  assert(u.function_space());
+  assert(v.function_space());
+  auto mesh1 = u.function_space()->mesh();
+  auto mesh0 = v.function_space()->mesh();
+  assert(mesh0);
+  assert(mesh1);
+  const int tdim0 = mesh0->topology().dim();
+
+  auto element1 = u.function_space()->element();
+  assert(element1);
+  const std::size_t value_size = element1->value_size();
+
+  // Physical coordinates of the interpolation points of u on all local
+  // cells
+  auto cell_map1 = mesh1->topology().index_map(mesh1->topology().dim());
+  assert(cell_map1);
+  const std::int32_t num_cells1
+      = cell_map1->size_local() + cell_map1->num_ghosts();
+  std::vector<std::int32_t> cells1(num_cells1);
+  std::iota(cells1.begin(), cells1.end(), 0);
+  const xt::xtensor<double, 2> x
+      = interpolation_coords(*element1, *mesh1, cells1);
+  const std::size_t num_points = x.shape(1);
+  xt::xtensor<double, 2> points({num_points, 3});
+  for (std::size_t p = 0; p < num_points; ++p)
+    for (std::size_t j = 0; j < 3; ++j)
+      points(p, j) = x(j, p);
+
+  // Locate points in the source mesh (local search). Returns -1 for
+  // points inside no local cell.
+  auto locate = [&tree, &mesh0](const xt::xtensor<double, 2>& xp)
+  {
+    const graph::AdjacencyList<std::int32_t> candidates
+        = geometry::compute_collisions(tree, xp);
+    const graph::AdjacencyList<int> colliding
+        = geometry::compute_colliding_cells(*mesh0, candidates, xp);
+    std::vector<std::int32_t> cells(xp.shape(0), -1);
+    for (std::size_t p = 0; p < xp.shape(0); ++p)
+    {
+      if (colliding.num_links(p) > 0)
+        cells[p] = colliding.links(p)[0];
+    }
+    return cells;
+  };
+
+  // Find the closest local cell (and squared distance) for points
+  // inside no local cell, e.g. points just outside the boundary of the
+  // source mesh due to non-matching discretisations
+  auto locate_closest =
+      [&tree, &mesh0, tdim0](const xt::xtensor<double, 2>& xp,
+                             std::vector<std::int32_t>& cells,
+                             std::vector<double>& dist)
+  {
+    std::vector<std::size_t> missing;
+    for (std::size_t p = 0; p < cells.size(); ++p)
+    {
+      if (cells[p] < 0)
+        missing.push_back(p);
+      else
+        dist[p] = 0.0;
+    }
+    if (missing.empty())
+      return;
+
+    auto cell_map = mesh0->topology().index_map(tdim0);
+    assert(cell_map);
+    std::vector<std::int32_t> all_cells(cell_map->size_local()
+                                        + cell_map->num_ghosts());
+    std::iota(all_cells.begin(), all_cells.end(), 0);
+    const geometry::BoundingBoxTree midpoint_tree
+        = geometry::create_midpoint_tree(*mesh0, tdim0, all_cells);
+
+    xt::xtensor<double, 2> xp_missing({missing.size(), std::size_t(3)});
+    for (std::size_t i = 0; i < missing.size(); ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        xp_missing(i, j) = xp(missing[i], j);
+
+    const std::vector<std::int32_t> closest = geometry::compute_closest_entity(
+        tree, midpoint_tree, *mesh0, xp_missing);
+    const xt::xtensor<double, 1> d2
+        = geometry::squared_distance(*mesh0, tdim0, closest, xp_missing);
+    for (std::size_t i = 0; i < missing.size(); ++i)
+    {
+      cells[missing[i]] = closest[i];
+      dist[missing[i]] = d2[i];
+    }
+  };
+
+  std::vector<std::int32_t> cells0 = locate(points);
+
+  xt::xtensor<T, 2> values = xt::zeros<T>({num_points, value_size});
+
+  MPI_Comm comm = mesh1->mpi_comm();
+  if (dolfinx::MPI::size(comm) == 1)
+  {
+    // Take the closest cell for points that collide with no cell
+    std::vector<double> dist(num_points,
+                             std::numeric_limits<double>::max());
+    locate_closest(points, cells0, dist);
+    v.eval(points, cells0, values);
+  }
+  else
+  {
+    v.eval(points, cells0, values);
+
+    // Points not found in any local cell are evaluated on the rank
+    // whose closest cell is nearest to the point
+    std::vector<std::size_t> unresolved;
+    for (std::size_t p = 0; p < num_points; ++p)
+    {
+      if (cells0[p] < 0)
+        unresolved.push_back(p);
+    }
+
+    // Gather unresolved points from all ranks
+    const int mpi_size = dolfinx::MPI::size(comm);
+    const int rank = dolfinx::MPI::rank(comm);
+    const int num_local = 3 * unresolved.size();
+    std::vector<int> sizes(mpi_size);
+    MPI_Allgather(&num_local, 1, MPI_INT, sizes.data(), 1, MPI_INT, comm);
+    std::vector<int> disp(mpi_size + 1, 0);
+    std::partial_sum(sizes.begin(), sizes.end(), std::next(disp.begin()));
+    if (disp.back() > 0)
+    {
+      std::vector<double> x_send(num_local);
+      for (std::size_t i = 0; i < unresolved.size(); ++i)
+        for (std::size_t j = 0; j < 3; ++j)
+          x_send[3 * i + j] = points(unresolved[i], j);
+      std::vector<double> x_recv(disp.back());
+      MPI_Allgatherv(x_send.data(), num_local, MPI_DOUBLE, x_recv.data(),
+                     sizes.data(), disp.data(), MPI_DOUBLE, comm);
+
+      const std::size_t num_remote = disp.back() / 3;
+      xt::xtensor<double, 2> points_r({num_remote, std::size_t(3)});
+      std::copy(x_recv.begin(), x_recv.end(), points_r.begin());
+
+      // Locate the gathered points locally, falling back to the
+      // closest cell, and determine the owning rank of each point by a
+      // global (distance, rank) reduction
+      std::vector<std::int32_t> cells_r = locate(points_r);
+      std::vector<double> dist(num_remote,
+                               std::numeric_limits<double>::max());
+      locate_closest(points_r, cells_r, dist);
+
+      std::vector<std::pair<double, int>> dist_rank(num_remote),
+          dist_owner(num_remote);
+      for (std::size_t i = 0; i < num_remote; ++i)
+        dist_rank[i] = {dist[i], rank};
+      MPI_Allreduce(dist_rank.data(), dist_owner.data(), num_remote,
+                    MPI_DOUBLE_INT, MPI_MINLOC, comm);
+
+      // Evaluate the points owned by this rank and sum the
+      // contributions over all ranks
+      for (std::size_t i = 0; i < num_remote; ++i)
+      {
+        if (dist_owner[i].second != rank)
+          cells_r[i] = -1;
+      }
+      xt::xtensor<T, 2> values_r = xt::zeros<T>({num_remote, value_size});
+      v.eval(points_r, cells_r, values_r);
+      MPI_Allreduce(MPI_IN_PLACE, values_r.data(), num_remote * value_size,
+                    dolfinx::MPI::mpi_type<T>(), MPI_SUM, comm);
+
+      // Extract the values of the points this rank asked for
+      const std::size_t offset = disp[rank] / 3;
+      for (std::size_t i = 0; i < unresolved.size(); ++i)
+        for (std::size_t j = 0; j < value_size; ++j)
+          values(unresolved[i], j) = values_r(offset + i, j);
+    }
+  }
+
+  // Interpolate the evaluated values. The expression callback returns
+  // the values by component, i.e. transposed.
+  auto f = [&values](const xt::xtensor<double, 2>& /*x*/) -> xt::xarray<T>
+  {
+    xt::xarray<T> vals = xt::empty<T>({values.shape(1), values.shape(0)});
+    for (std::size_t i = 0; i < values.shape(0); ++i)
+      for (std::size_t j = 0; j < values.shape(1); ++j)
+        vals(j, i) = values(i, j);
+    return vals;
+  };
+  interpolate<T>(u, f, x, cells1);
+}
+
 /// Interpolate from one finite element Function to another on the same
 /// mesh
 /// @param[out] u The function to interpolate into
@@ -633,13 +947,19 @@ void interpolate(Function<T>& u, const Function<T>& v)
   }
   else
   {
-    // Get mesh and check that functions share the same mesh
+    // Get mesh and check whether the functions share the same mesh
     const auto mesh = u.function_space()->mesh();
     assert(mesh);
     if (mesh != v.function_space()->mesh())
     {
-      throw std::runtime_error(
-          "Interpolation on different meshes not supported (yet).");
+      // Non-matching meshes: locate the interpolation points of u in
+      // the mesh of v
+      auto mesh0 = v.function_space()->mesh();
+      assert(mesh0);
+      const geometry::BoundingBoxTree tree(*mesh0,
+                                           mesh0->topology().dim());
+      interpolate_nonmatching(u, v, tree);
+      return;
     }
 
     // Get elements
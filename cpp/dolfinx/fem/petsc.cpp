@@ -9,24 +9,198 @@
 #include "assembler.h"
 #include "sparsitybuild.h"
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/log.h>
 #include <dolfinx/la/PETScMatrix.h>
 #include <dolfinx/la/PETScVector.h>
 #include <dolfinx/la/SparsityPattern.h>
+#include <tuple>
 #include <xtl/xspan.hpp>
 
 using namespace dolfinx;
 
+namespace
+{
+// Cache of assembled sparsity patterns, keyed on the dofmap pair, the
+// integral types and the mesh each pattern was built from. Patterns
+// for unchanged discretizations are expensive to rebuild at every
+// solver setup, so repeated fem::create_matrix (and
+// fem::create_matrix_block) calls on the same Form return a shared
+// pattern. One key entry per block: (dofmap0, dofmap1, integral type
+// signature); a monolithic pattern has a single entry.
+using PatternKey = std::vector<std::tuple<const void*, const void*, int>>;
+
+// A cached pattern, together with weak references to the objects the
+// key pointers refer to. Keys hold raw pointers, so an entry is only
+// valid while the mesh and dofmaps it was built from are still alive;
+// the weak references are checked on every lookup so a re-created
+// mesh or dofmap at the same address cannot alias a stale pattern.
+struct PatternCacheEntry
+{
+  std::vector<std::weak_ptr<const fem::DofMap>> dofmaps;
+  std::weak_ptr<const mesh::Mesh> mesh;
+  std::shared_ptr<const la::SparsityPattern> pattern;
+};
+
+std::map<PatternKey, PatternCacheEntry>& pattern_cache()
+{
+  static std::map<PatternKey, PatternCacheEntry> cache;
+  return cache;
+}
+
+/// Integral type signature of a form (one bit per IntegralType with at
+/// least one integral)
+int integral_signature(const fem::Form<PetscScalar>& a)
+{
+  int signature = 0;
+  for (fem::IntegralType type :
+       {fem::IntegralType::cell, fem::IntegralType::exterior_facet,
+        fem::IntegralType::interior_facet, fem::IntegralType::vertex})
+  {
+    if (a.num_integrals(type) > 0)
+      signature |= 1 << static_cast<int>(type);
+  }
+  return signature;
+}
+
+/// Find a cached pattern for @p key, validating the entry against the
+/// mesh and dofmaps it was built from. Stale and expired entries are
+/// evicted. Returns nullptr if no valid pattern is cached.
+std::shared_ptr<const la::SparsityPattern> pattern_cache_lookup(
+    const PatternKey& key, const std::shared_ptr<const mesh::Mesh>& mesh,
+    const std::vector<std::shared_ptr<const fem::DofMap>>& dofmaps)
+{
+  std::map<PatternKey, PatternCacheEntry>& cache = pattern_cache();
+  if (const auto it = cache.find(key); it != cache.end())
+  {
+    const PatternCacheEntry& entry = it->second;
+    bool valid = entry.mesh.lock() == mesh
+                 and entry.dofmaps.size() == dofmaps.size();
+    for (std::size_t i = 0; valid and i < dofmaps.size(); ++i)
+      valid = entry.dofmaps[i].lock() == dofmaps[i];
+    if (valid)
+      return entry.pattern;
+    cache.erase(it);
+  }
+
+  // Drop entries whose mesh no longer exists
+  for (auto it = cache.begin(); it != cache.end();)
+  {
+    if (it->second.mesh.expired())
+      it = cache.erase(it);
+    else
+      ++it;
+  }
+
+  return nullptr;
+}
+
+/// Store an assembled pattern in the cache
+void pattern_cache_insert(
+    const PatternKey& key, const std::shared_ptr<const mesh::Mesh>& mesh,
+    const std::vector<std::shared_ptr<const fem::DofMap>>& dofmaps,
+    std::shared_ptr<const la::SparsityPattern> pattern)
+{
+  PatternCacheEntry entry;
+  entry.dofmaps.assign(dofmaps.begin(), dofmaps.end());
+  entry.mesh = mesh;
+  entry.pattern = std::move(pattern);
+  pattern_cache().insert({key, std::move(entry)});
+}
+
+// Cache of concatenated index maps for block vectors, keyed on the
+// sub-map addresses, block sizes and sizes. Building the stacked map
+// involves parallel communication (common::stack_index_maps), which is
+// wasteful when a block vector is re-created at every time step for an
+// unchanged layout. The sizes in the key guard against a re-created
+// map at the same address aliasing a stale entry.
+using BlockMapKey
+    = std::vector<std::tuple<const void*, int, std::int32_t, std::int32_t>>;
+
+std::map<BlockMapKey, std::shared_ptr<const common::IndexMap>>&
+block_map_cache()
+{
+  static std::map<BlockMapKey, std::shared_ptr<const common::IndexMap>> cache;
+  return cache;
+}
+
+/// Return the concatenated index map for a list of (map, block size)
+/// pairs, building and caching it on first use
+std::shared_ptr<const common::IndexMap> blocked_index_map(
+    const std::vector<
+        std::pair<std::reference_wrapper<const common::IndexMap>, int>>& maps)
+{
+  BlockMapKey key;
+  for (auto& map : maps)
+  {
+    key.push_back({&map.first.get(), map.second, map.first.get().size_local(),
+                   map.first.get().num_ghosts()});
+  }
+
+  std::map<BlockMapKey, std::shared_ptr<const common::IndexMap>>& cache
+      = block_map_cache();
+  if (const auto it = cache.find(key); it != cache.end())
+    return it->second;
+
+  auto [rank_offset, local_offset, ghosts_new, ghost_new_owners]
+      = common::stack_index_maps(maps);
+  std::int32_t local_size = local_offset.back();
+
+  std::vector<std::int64_t> ghosts;
+  for (auto& sub_ghost : ghosts_new)
+    ghosts.insert(ghosts.end(), sub_ghost.begin(), sub_ghost.end());
+
+  std::vector<int> ghost_owners;
+  for (auto& sub_owner : ghost_new_owners)
+    ghost_owners.insert(ghost_owners.end(), sub_owner.begin(), sub_owner.end());
+
+  std::vector<int> dest_ranks;
+  for (auto& map : maps)
+  {
+    const auto [_, ranks] = dolfinx::MPI::neighbors(
+        map.first.get().comm(common::IndexMap::Direction::forward));
+    dest_ranks.insert(dest_ranks.end(), ranks.begin(), ranks.end());
+  }
+  std::sort(dest_ranks.begin(), dest_ranks.end());
+  dest_ranks.erase(std::unique(dest_ranks.begin(), dest_ranks.end()),
+                   dest_ranks.end());
+
+  auto index_map = std::make_shared<common::IndexMap>(
+      maps[0].first.get().comm(), local_size, dest_ranks, ghosts, ghost_owners);
+  cache.insert({key, index_map});
+  return index_map;
+}
+} // namespace
+
 //-----------------------------------------------------------------------------
 Mat dolfinx::fem::create_matrix(const Form<PetscScalar>& a,
                                 const std::string& type)
 {
-  // Build sparsitypattern
-  la::SparsityPattern pattern = fem::create_sparsity_pattern(a);
+  const std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+  const std::vector<std::shared_ptr<const fem::DofMap>> dofmaps
+      = {a.function_spaces().at(0)->dofmap(),
+         a.function_spaces().at(1)->dofmap()};
+  const PatternKey key
+      = {{dofmaps[0].get(), dofmaps[1].get(), integral_signature(a)}};
+
+  std::shared_ptr<const la::SparsityPattern> pattern
+      = pattern_cache_lookup(key, mesh, dofmaps);
+  if (pattern)
+    LOG(INFO) << "Re-using cached sparsity pattern";
+  else
+  {
+    // Build sparsity pattern
+    auto p = std::make_shared<la::SparsityPattern>(
+        fem::create_sparsity_pattern(a));
 
-  // Finalise communication
-  pattern.assemble();
+    // Finalise communication
+    p->assemble();
 
-  return la::create_petsc_matrix(a.mesh()->mpi_comm(), pattern, type);
+    pattern = p;
+    pattern_cache_insert(key, mesh, dofmaps, pattern);
+  }
+
+  return la::create_petsc_matrix(mesh->mpi_comm(), *pattern, type);
 }
 //-----------------------------------------------------------------------------
 Mat fem::create_matrix_block(
@@ -47,49 +221,26 @@ Mat fem::create_matrix_block(
   assert(mesh);
   const int tdim = mesh->topology().dim();
 
-  // Build sparsity pattern for each block
-  std::vector<std::vector<std::unique_ptr<la::SparsityPattern>>> patterns(
-      V[0].size());
+  // Build cache key, one entry per block (missing blocks marked with a
+  // negative integral signature)
+  PatternKey key;
+  std::vector<std::shared_ptr<const fem::DofMap>> dofmaps_key;
+  for (std::size_t d = 0; d < 2; ++d)
+    for (auto& space : V[d])
+      dofmaps_key.push_back(space->dofmap());
   for (std::size_t row = 0; row < V[0].size(); ++row)
   {
     for (std::size_t col = 0; col < V[1].size(); ++col)
     {
-      const std::array<std::shared_ptr<const common::IndexMap>, 2> index_maps
-          = {{V[0][row]->dofmap()->index_map, V[1][col]->dofmap()->index_map}};
-      const std::array bs = {V[0][row]->dofmap()->index_map_bs(),
-                             V[1][col]->dofmap()->index_map_bs()};
-      if (const fem::Form<PetscScalar>* form = a[row][col]; form)
-      {
-        // Create sparsity pattern for block
-        patterns[row].push_back(std::make_unique<la::SparsityPattern>(
-            mesh->mpi_comm(), index_maps, bs));
-
-        // Build sparsity pattern for block
-        assert(V[0][row]->dofmap());
-        assert(V[1][col]->dofmap());
-        std::array<const std::reference_wrapper<const fem::DofMap>, 2> dofmaps{
-            *V[0][row]->dofmap(), *V[1][col]->dofmap()};
-        assert(patterns[row].back());
-        auto& sp = patterns[row].back();
-        assert(sp);
-        if (form->num_integrals(IntegralType::cell) > 0)
-          sparsitybuild::cells(*sp, mesh->topology(), dofmaps);
-        if (form->num_integrals(IntegralType::interior_facet) > 0)
-        {
-          mesh->topology_mutable().create_entities(tdim - 1);
-          sparsitybuild::interior_facets(*sp, mesh->topology(), dofmaps);
-        }
-        if (form->num_integrals(IntegralType::exterior_facet) > 0)
-        {
-          mesh->topology_mutable().create_entities(tdim - 1);
-          sparsitybuild::exterior_facets(*sp, mesh->topology(), dofmaps);
-        }
-      }
-      else
-        patterns[row].push_back(nullptr);
+      const fem::Form<PetscScalar>* form = a[row][col];
+      key.push_back({V[0][row]->dofmap().get(), V[1][col]->dofmap().get(),
+                     form ? integral_signature(*form) : -1});
     }
   }
 
+  std::shared_ptr<const la::SparsityPattern> pattern
+      = pattern_cache_lookup(key, mesh, dofmaps_key);
+
   // Compute offsets for the fields
   std::array<std::vector<std::pair<
                  std::reference_wrapper<const common::IndexMap>, int>>,
@@ -104,6 +255,67 @@ Mat fem::create_matrix_block(
     }
   }
 
+  if (pattern)
+    LOG(INFO) << "Re-using cached block sparsity pattern";
+  else
+  {
+    // Build sparsity pattern for each block
+    std::vector<std::vector<std::unique_ptr<la::SparsityPattern>>> patterns(
+        V[0].size());
+    for (std::size_t row = 0; row < V[0].size(); ++row)
+    {
+      for (std::size_t col = 0; col < V[1].size(); ++col)
+      {
+        const std::array<std::shared_ptr<const common::IndexMap>, 2> index_maps
+            = {{V[0][row]->dofmap()->index_map,
+                V[1][col]->dofmap()->index_map}};
+        const std::array bs = {V[0][row]->dofmap()->index_map_bs(),
+                               V[1][col]->dofmap()->index_map_bs()};
+        if (const fem::Form<PetscScalar>* form = a[row][col]; form)
+        {
+          // Create sparsity pattern for block
+          patterns[row].push_back(std::make_unique<la::SparsityPattern>(
+              mesh->mpi_comm(), index_maps, bs));
+
+          // Build sparsity pattern for block
+          assert(V[0][row]->dofmap());
+          assert(V[1][col]->dofmap());
+          std::array<const std::reference_wrapper<const fem::DofMap>, 2>
+              dofmaps{*V[0][row]->dofmap(), *V[1][col]->dofmap()};
+          assert(patterns[row].back());
+          auto& sp = patterns[row].back();
+          assert(sp);
+          if (form->num_integrals(IntegralType::cell) > 0)
+            sparsitybuild::cells(*sp, mesh->topology(), dofmaps);
+          if (form->num_integrals(IntegralType::interior_facet) > 0)
+          {
+            mesh->topology_mutable().create_entities(tdim - 1);
+            sparsitybuild::interior_facets(*sp, mesh->topology(), dofmaps);
+          }
+          if (form->num_integrals(IntegralType::exterior_facet) > 0)
+          {
+            mesh->topology_mutable().create_entities(tdim - 1);
+            sparsitybuild::exterior_facets(*sp, mesh->topology(), dofmaps);
+          }
+        }
+        else
+          patterns[row].push_back(nullptr);
+      }
+    }
+
+    // Create merged sparsity pattern
+    std::vector<std::vector<const la::SparsityPattern*>> p(V[0].size());
+    for (std::size_t row = 0; row < V[0].size(); ++row)
+      for (std::size_t col = 0; col < V[1].size(); ++col)
+        p[row].push_back(patterns[row][col].get());
+    auto merged = std::make_shared<la::SparsityPattern>(mesh->mpi_comm(), p,
+                                                        maps, bs_dofs);
+    merged->assemble();
+
+    pattern = merged;
+    pattern_cache_insert(key, mesh, dofmaps_key, pattern);
+  }
+
   // FIXME: This is computed again inside the SparsityPattern
   // constructor, but we also need to outside to build the PETSc
   // local-to-global map. Compute outside and pass into SparsityPattern
@@ -111,19 +323,11 @@ Mat fem::create_matrix_block(
   auto [rank_offset, local_offset, ghosts, owner]
       = common::stack_index_maps(maps[0]);
 
-  // Create merged sparsity pattern
-  std::vector<std::vector<const la::SparsityPattern*>> p(V[0].size());
-  for (std::size_t row = 0; row < V[0].size(); ++row)
-    for (std::size_t col = 0; col < V[1].size(); ++col)
-      p[row].push_back(patterns[row][col].get());
-  la::SparsityPattern pattern(mesh->mpi_comm(), p, maps, bs_dofs);
-  pattern.assemble();
-
   // FIXME: Add option to pass customised local-to-global map to PETSc
   // Mat constructor
 
   // Initialise matrix
-  Mat A = la::create_petsc_matrix(mesh->mpi_comm(), pattern, type);
+  Mat A = la::create_petsc_matrix(mesh->mpi_comm(), *pattern, type);
 
   // Create row and column local-to-global maps (field0, field1, field2,
   // etc), i.e. ghosts of field0 appear before owned indices of field1
@@ -183,7 +387,9 @@ Mat fem::create_matrix_nest(
   if (!types.empty())
     _types = types;
 
-  // Loop over each form and create matrix
+  // Loop over each form and create matrix. Blocks that use the same
+  // function spaces and integral types share a sparsity pattern
+  // through the pattern cache in create_matrix.
   const int rows = a.size();
   const int cols = a[0].size();
   std::vector<Mat> mats(rows * cols, nullptr);
@@ -213,40 +419,145 @@ Mat fem::create_matrix_nest(
   return A;
 }
 //-----------------------------------------------------------------------------
-Vec fem::create_vector_block(
-    const std::vector<
-        std::pair<std::reference_wrapper<const common::IndexMap>, int>>& maps)
+void fem::assemble_matrix_nest(
+    Mat A, const std::vector<std::vector<const fem::Form<PetscScalar>*>>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+    PetscScalar diagonal)
 {
-  // FIXME: handle constant block size > 1
+  // Assemble each block. PETSc matrix insertion is not thread-safe, so
+  // blocks are visited sequentially; within a block the assembly sweep
+  // runs on the common thread pool, and all blocks read the shared
+  // mesh geometry in place.
+  std::vector<std::pair<Mat, const fem::Form<PetscScalar>*>> blocks;
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    for (std::size_t j = 0; j < a[i].size(); ++j)
+    {
+      if (const fem::Form<PetscScalar>* form = a[i][j]; form)
+      {
+        Mat Asub = nullptr;
+        MatNestGetSubMat(A, i, j, &Asub);
+        assert(Asub);
+        blocks.push_back({Asub, form});
+        assemble_matrix(la::PETScMatrix::set_block_fn(Asub, ADD_VALUES), *form,
+                        bcs);
+      }
+    }
+  }
 
-  auto [rank_offset, local_offset, ghosts_new, ghost_new_owners]
-      = common::stack_index_maps(maps);
-  std::int32_t local_size = local_offset.back();
+  if (!bcs.empty())
+  {
+    // Flush all blocks with overlapped communication to switch from
+    // add to insert mode for the boundary condition diagonal
+    for (auto& block : blocks)
+      MatAssemblyBegin(block.first, MAT_FLUSH_ASSEMBLY);
+    for (auto& block : blocks)
+      MatAssemblyEnd(block.first, MAT_FLUSH_ASSEMBLY);
+
+    for (auto& [Asub, form] : blocks)
+    {
+      if (form->function_spaces()[0] == form->function_spaces()[1])
+      {
+        set_diagonal(la::PETScMatrix::set_fn(Asub, INSERT_VALUES),
+                     *form->function_spaces()[0], bcs, diagonal);
+      }
+    }
+  }
 
-  std::vector<std::int64_t> ghosts;
-  for (auto& sub_ghost : ghosts_new)
-    ghosts.insert(ghosts.end(), sub_ghost.begin(), sub_ghost.end());
+  // Finalise all blocks, posting every MatAssemblyBegin before any
+  // MatAssemblyEnd so the communication overlaps across blocks
+  for (auto& block : blocks)
+    MatAssemblyBegin(block.first, MAT_FINAL_ASSEMBLY);
+  for (auto& block : blocks)
+    MatAssemblyEnd(block.first, MAT_FINAL_ASSEMBLY);
+  MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+  MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+}
+//-----------------------------------------------------------------------------
+void fem::assemble_matrix_block(
+    Mat A, const std::vector<std::vector<const fem::Form<PetscScalar>*>>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+    PetscScalar diagonal)
+{
+  std::array<std::vector<std::shared_ptr<const fem::FunctionSpace>>, 2> V
+      = fem::common_function_spaces(extract_function_spaces(a));
 
-  std::vector<int> ghost_owners;
-  for (auto& sub_owner : ghost_new_owners)
-    ghost_owners.insert(ghost_owners.end(), sub_owner.begin(), sub_owner.end());
+  // Index sets addressing each block of the stacked local layout
+  std::array<std::vector<IS>, 2> is;
+  for (int d = 0; d < 2; ++d)
+  {
+    std::vector<std::pair<std::reference_wrapper<const common::IndexMap>, int>>
+        maps;
+    for (auto& space : V[d])
+    {
+      maps.push_back(
+          {*space->dofmap()->index_map, space->dofmap()->index_map_bs()});
+    }
+    is[d] = la::create_petsc_index_sets(maps);
+  }
 
-  std::vector<int> dest_ranks;
-  for (auto& map : maps)
+  // Assemble each block through a local sub-matrix view. Unrolled
+  // (expanded) insertion is used since local sub-matrix views do not
+  // support blocked insertion.
+  for (std::size_t i = 0; i < a.size(); ++i)
   {
-    const auto [_, ranks] = dolfinx::MPI::neighbors(
-        map.first.get().comm(common::IndexMap::Direction::forward));
-    dest_ranks.insert(dest_ranks.end(), ranks.begin(), ranks.end());
+    for (std::size_t j = 0; j < a[i].size(); ++j)
+    {
+      if (const fem::Form<PetscScalar>* form = a[i][j]; form)
+      {
+        Mat Asub = nullptr;
+        MatGetLocalSubMatrix(A, is[0][i], is[1][j], &Asub);
+        assemble_matrix(
+            la::PETScMatrix::set_block_expand_fn(Asub, V[0][i]->dofmap()->bs(),
+                                                 V[1][j]->dofmap()->bs(),
+                                                 ADD_VALUES),
+            *form, bcs);
+        MatRestoreLocalSubMatrix(A, is[0][i], is[1][j], &Asub);
+      }
+    }
   }
-  std::sort(dest_ranks.begin(), dest_ranks.end());
-  dest_ranks.erase(std::unique(dest_ranks.begin(), dest_ranks.end()),
-                   dest_ranks.end());
 
-  // Create map for combined problem, and create vector
-  common::IndexMap index_map(maps[0].first.get().comm(), local_size, dest_ranks,
-                             ghosts, ghost_owners);
+  if (!bcs.empty())
+  {
+    // Flush to switch from add to insert mode for the boundary
+    // condition diagonal
+    MatAssemblyBegin(A, MAT_FLUSH_ASSEMBLY);
+    MatAssemblyEnd(A, MAT_FLUSH_ASSEMBLY);
+
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+      for (std::size_t j = 0; j < a[i].size(); ++j)
+      {
+        const fem::Form<PetscScalar>* form = a[i][j];
+        if (form and form->function_spaces()[0] == form->function_spaces()[1])
+        {
+          Mat Asub = nullptr;
+          MatGetLocalSubMatrix(A, is[0][i], is[1][j], &Asub);
+          set_diagonal(la::PETScMatrix::set_fn(Asub, INSERT_VALUES),
+                       *form->function_spaces()[0], bcs, diagonal);
+          MatRestoreLocalSubMatrix(A, is[0][i], is[1][j], &Asub);
+        }
+      }
+    }
+  }
+
+  MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+  MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+
+  for (int d = 0; d < 2; ++d)
+    for (IS& index_set : is[d])
+      ISDestroy(&index_set);
+}
+//-----------------------------------------------------------------------------
+Vec fem::create_vector_block(
+    const std::vector<
+        std::pair<std::reference_wrapper<const common::IndexMap>, int>>& maps)
+{
+  // FIXME: handle constant block size > 1
 
-  return la::create_petsc_vector(index_map, 1);
+  // Get (cached) map for combined problem, and create vector
+  std::shared_ptr<const common::IndexMap> index_map = blocked_index_map(maps);
+  return la::create_petsc_vector(*index_map, 1);
 }
 //-----------------------------------------------------------------------------
 Vec fem::create_vector_nest(
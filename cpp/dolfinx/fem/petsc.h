@@ -28,6 +28,12 @@ class DirichletBC;
 class FunctionSpace;
 
 /// Create a matrix
+///
+/// The assembled sparsity pattern is cached, keyed on the dofmaps,
+/// integral types and mesh of @p a, so repeated calls for an
+/// unchanged discretization (e.g. at each step of a time-dependent
+/// solve) re-use the pattern rather than re-building it.
+///
 /// @param[in] a A bilinear form
 /// @param[in] type The PETSc matrix type to create
 /// @return A sparse matrix with a layout and sparsity that matches the
@@ -36,7 +42,9 @@ class FunctionSpace;
 Mat create_matrix(const Form<PetscScalar>& a,
                   const std::string& type = std::string());
 
-/// Initialise a monolithic matrix for an array of bilinear forms
+/// Initialise a monolithic matrix for an array of bilinear forms. The
+/// merged sparsity pattern is cached in the same way as for
+/// create_matrix.
 /// @param[in] a Rectangular array of bilinear forms. The `a(i, j)` form
 /// will correspond to the `(i, j)` block in the returned matrix
 /// @param[in] type The type of PETSc Mat. If empty the PETSc default is
@@ -48,13 +56,58 @@ Mat create_matrix_block(
     const std::vector<std::vector<const fem::Form<PetscScalar>*>>& a,
     const std::string& type = std::string());
 
-/// Create nested (MatNest) matrix
+/// Create nested (MatNest) matrix. Sub-matrix blocks that use the same
+/// function spaces and integral types share a cached sparsity pattern.
 ///
 /// The caller is responsible for destroying the Mat object
 Mat create_matrix_nest(
     const std::vector<std::vector<const fem::Form<PetscScalar>*>>& a,
     const std::vector<std::vector<std::string>>& types);
 
+// -- Matrices ---------------------------------------------------------------
+
+/// Assemble an array of bilinear forms into the blocks of a nested
+/// (MatNest) matrix (see create_matrix_nest). All blocks read the
+/// shared mesh geometry in place, and within each block the assembly
+/// sweep is threaded on the common thread pool. The sub-matrices are
+/// finalised with overlapped communication: MatAssemblyBegin is posted
+/// for every block before any MatAssemblyEnd is called.
+///
+/// @param[in,out] A The nested matrix to assemble into. It is not
+/// zeroed before assembly.
+/// @param[in] a Rectangular array of bilinear forms. The `a(i, j)`
+/// form is assembled into the `(i, j)` block of `A`. Null blocks are
+/// permitted.
+/// @param[in] bcs Boundary conditions to apply. Rows and columns with
+/// a condition applied are zeroed, and @p diagonal is inserted on the
+/// diagonal of blocks whose test and trial spaces are the same.
+/// @param[in] diagonal Value inserted on the diagonal for boundary
+/// condition rows
+void assemble_matrix_nest(
+    Mat A, const std::vector<std::vector<const Form<PetscScalar>*>>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+    PetscScalar diagonal = 1.0);
+
+/// Assemble an array of bilinear forms into a monolithic matrix (see
+/// create_matrix_block). Blocks are addressed through local sub-matrix
+/// views of `A` and the assembly and boundary condition handling
+/// otherwise follow assemble_matrix_nest.
+///
+/// @param[in,out] A The block matrix to assemble into. It is not
+/// zeroed before assembly.
+/// @param[in] a Rectangular array of bilinear forms. The `a(i, j)`
+/// form is assembled into the `(i, j)` block of `A`. Null blocks are
+/// permitted.
+/// @param[in] bcs Boundary conditions to apply. Rows and columns with
+/// a condition applied are zeroed, and @p diagonal is inserted on the
+/// diagonal of blocks whose test and trial spaces are the same.
+/// @param[in] diagonal Value inserted on the diagonal for boundary
+/// condition rows
+void assemble_matrix_block(
+    Mat A, const std::vector<std::vector<const Form<PetscScalar>*>>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+    PetscScalar diagonal = 1.0);
+
 /// Initialise monolithic vector. Vector is not zeroed.
 ///
 /// The caller is responsible for destroying the Mat object
@@ -0,0 +1,433 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DirichletBC.h"
+#include "DofMap.h"
+#include "Form.h"
+#include "FunctionSpace.h"
+#include "utils.h"
+#include <algorithm>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <memory>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::fem
+{
+
+/// Contiguous renumbering of the degrees of freedom of a function
+/// space that are not constrained by a set of Dirichlet boundary
+/// conditions. The unconstrained dofs owned by each rank are numbered
+/// contiguously (in ascending order of the full dof index), followed
+/// by the unconstrained ghost dofs, and an IndexMap (block size 1)
+/// over the reduced index set is built. Assembling into the reduced
+/// index set (see assemble_matrix_reduced) eliminates the boundary
+/// condition rows and columns from the system instead of zeroing
+/// them, so Krylov solvers and preconditioners never see the trivial
+/// dofs.
+///
+/// The boundary condition markers must be consistent across ranks
+/// (ghost dofs are marked on every rank that sees them, as produced by
+/// locate_dofs_topological/locate_dofs_geometrical with remote
+/// marking). Built once per (function space, boundary condition set)
+/// and re-used across assemblies and time steps.
+class ReducedDofMap
+{
+public:
+  /// Create a reduced dof numbering for a function space
+  ///
+  /// @note Collective
+  /// @param[in] V The function space
+  /// @param[in] bcs Boundary conditions constraining dofs of @p V.
+  /// Conditions on spaces not contained in @p V are ignored.
+  template <typename T>
+  ReducedDofMap(const std::shared_ptr<const FunctionSpace>& V,
+                const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+  {
+    assert(V);
+    std::shared_ptr<const DofMap> dofmap = V->dofmap();
+    assert(dofmap);
+    std::shared_ptr<const common::IndexMap> map = dofmap->index_map;
+    assert(map);
+    const int bs = dofmap->index_map_bs();
+    const std::int32_t num_local = bs * map->size_local();
+    const std::int32_t num_ghost = bs * map->num_ghosts();
+
+    // Mark constrained dofs
+    std::vector<bool> marker(num_local + num_ghost, false);
+    for (std::size_t k = 0; k < bcs.size(); ++k)
+    {
+      assert(bcs[k]);
+      assert(bcs[k]->function_space());
+      if (V->contains(*bcs[k]->function_space()))
+        bcs[k]->mark_dofs(marker);
+    }
+
+    // Number the owned unconstrained dofs contiguously
+    _full_to_reduced.assign(num_local + num_ghost, -1);
+    std::int32_t num_owned = 0;
+    for (std::int32_t i = 0; i < num_local; ++i)
+    {
+      if (!marker[i])
+        _full_to_reduced[i] = num_owned++;
+    }
+
+    // Global offset of the owned reduced dofs
+    assert(V->mesh());
+    MPI_Comm comm = V->mesh()->mpi_comm();
+    const std::int64_t size_owned = num_owned;
+    std::int64_t offset = 0;
+    MPI_Exscan(&size_owned, &offset, 1, MPI_INT64_T, MPI_SUM, comm);
+
+    // Send the new global index of each owned dof (-1 for constrained
+    // dofs) to the ranks ghosting it
+    std::vector<std::int64_t> global_owned(num_local, -1);
+    for (std::int32_t i = 0; i < num_local; ++i)
+    {
+      if (_full_to_reduced[i] >= 0)
+        global_owned[i] = offset + _full_to_reduced[i];
+    }
+    std::vector<std::int64_t> global_ghost(num_ghost);
+    map->scatter_fwd(xtl::span<const std::int64_t>(global_owned),
+                     xtl::span<std::int64_t>(global_ghost), bs);
+
+    // Number the unconstrained ghost dofs after the owned dofs
+    std::vector<std::int64_t> ghosts;
+    std::int32_t g = 0;
+    for (std::int32_t i = 0; i < num_ghost; ++i)
+    {
+      if (!marker[num_local + i] and global_ghost[i] >= 0)
+      {
+        _full_to_reduced[num_local + i] = num_owned + g++;
+        ghosts.push_back(global_ghost[i]);
+      }
+    }
+
+    _reduced_to_full.resize(num_owned + g);
+    for (std::int32_t i = 0; i < num_local + num_ghost; ++i)
+    {
+      if (_full_to_reduced[i] >= 0)
+        _reduced_to_full[_full_to_reduced[i]] = i;
+    }
+
+    _index_map = std::make_shared<common::IndexMap>(
+        common::create_index_map(comm, num_owned, ghosts));
+  }
+
+  /// Index map over the reduced (unconstrained) dofs, with block size 1
+  std::shared_ptr<const common::IndexMap> index_map() const
+  {
+    return _index_map;
+  }
+
+  /// Map from full dof indices (unrolled by the index map block size,
+  /// owned followed by ghosts) to reduced indices. Constrained dofs
+  /// map to -1.
+  const std::vector<std::int32_t>& full_to_reduced() const
+  {
+    return _full_to_reduced;
+  }
+
+  /// Map from reduced dof indices to full dof indices
+  const std::vector<std::int32_t>& reduced_to_full() const
+  {
+    return _reduced_to_full;
+  }
+
+  /// Gather the unconstrained entries of a full vector into a reduced
+  /// vector
+  /// @param[in] full Array over the full dofs (owned and ghost)
+  /// @param[in,out] reduced Array over the reduced dofs
+  template <typename T>
+  void restrict(const xtl::span<const T>& full, xtl::span<T> reduced) const
+  {
+    assert(full.size() >= _full_to_reduced.size());
+    assert(reduced.size() >= _reduced_to_full.size());
+    for (std::size_t i = 0; i < _reduced_to_full.size(); ++i)
+      reduced[i] = full[_reduced_to_full[i]];
+  }
+
+  /// Scatter a reduced vector into the unconstrained entries of a full
+  /// vector. Constrained entries are not modified; combine with
+  /// DirichletBC::set to impose the boundary values.
+  /// @param[in] reduced Array over the reduced dofs
+  /// @param[in,out] full Array over the full dofs (owned and ghost)
+  template <typename T>
+  void expand(const xtl::span<const T>& reduced, xtl::span<T> full) const
+  {
+    assert(full.size() >= _full_to_reduced.size());
+    assert(reduced.size() >= _reduced_to_full.size());
+    for (std::size_t i = 0; i < _reduced_to_full.size(); ++i)
+      full[_reduced_to_full[i]] = reduced[i];
+  }
+
+private:
+  // Index map over the reduced dofs
+  std::shared_ptr<const common::IndexMap> _index_map;
+
+  // Full dof index -> reduced dof index (-1 for constrained dofs)
+  std::vector<std::int32_t> _full_to_reduced;
+
+  // Reduced dof index -> full dof index
+  std::vector<std::int32_t> _reduced_to_full;
+};
+
+/// Create a sparsity pattern for the reduced operator of a bilinear
+/// form, i.e. the couplings between unconstrained test and trial dofs
+/// only. The form must have cell integrals only.
+/// @param[in] a The bilinear form
+/// @param[in] rdofmap0 Reduced numbering of the test space dofs
+/// @param[in] rdofmap1 Reduced numbering of the trial space dofs
+/// @return Sparsity pattern over the reduced index maps. The caller is
+/// responsible for calling SparsityPattern::assemble.
+template <typename T>
+la::SparsityPattern
+create_sparsity_pattern_reduced(const Form<T>& a, const ReducedDofMap& rdofmap0,
+                                const ReducedDofMap& rdofmap1)
+{
+  if (a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    throw std::runtime_error("Reduced assembly supports cell integrals only");
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+  const int bs0 = dofmap0->bs();
+  const int bs1 = dofmap1->bs();
+
+  const std::vector<std::int32_t>& f2r0 = rdofmap0.full_to_reduced();
+  const std::vector<std::int32_t>& f2r1 = rdofmap1.full_to_reduced();
+
+  la::SparsityPattern pattern(
+      mesh->mpi_comm(), {rdofmap0.index_map(), rdofmap1.index_map()}, {1, 1});
+
+  std::vector<std::int32_t> rows, cols;
+  for (int id : a.integral_ids(IntegralType::cell))
+  {
+    for (std::int32_t c : a.cell_domains(id))
+    {
+      rows.clear();
+      for (std::int32_t dof : dofs0.links(c))
+      {
+        for (int k = 0; k < bs0; ++k)
+        {
+          const std::int32_t r = f2r0[bs0 * dof + k];
+          if (r >= 0)
+            rows.push_back(r);
+        }
+      }
+
+      cols.clear();
+      for (std::int32_t dof : dofs1.links(c))
+      {
+        for (int k = 0; k < bs1; ++k)
+        {
+          const std::int32_t r = f2r1[bs1 * dof + k];
+          if (r >= 0)
+            cols.push_back(r);
+        }
+      }
+
+      pattern.insert(rows, cols);
+    }
+  }
+
+  return pattern;
+}
+
+/// Assemble a bilinear form directly into the reduced operator, with
+/// the boundary condition rows and columns eliminated rather than
+/// zeroed. For each cell the element tensor rows/columns at
+/// constrained dofs are dropped, the remaining block is added at the
+/// reduced indices, and the constrained columns are folded into the
+/// right-hand side during the same sweep:
+///
+///     b_r <- b_r - sum_j A_rj g_j
+///
+/// over the constrained dofs j with boundary value g_j, replacing a
+/// separate apply_lifting pass. The reduced system needs no
+/// set_diagonal step, and solvers iterate over the unconstrained dofs
+/// only.
+///
+/// The form must have cell integrals only and the elements must not
+/// require dof transformations. The load vector is assembled
+/// separately over the full dofs and restricted with
+/// ReducedDofMap::restrict, then combined with @p b.
+/// @param[in] mat_add The function for adding values into the reduced
+/// matrix
+/// @param[in] a The bilinear form to assemble
+/// @param[in] rdofmap0 Reduced numbering of the test space dofs
+/// @param[in] rdofmap1 Reduced numbering of the trial space dofs
+/// @param[in] bcs Boundary conditions supplying the values folded into
+/// @p b
+/// @param[in,out] b Array over the reduced test space dofs (owned and
+/// ghost) receiving the boundary condition terms. It is not zeroed
+/// before assembly; ghost contributions are accumulated with a reverse
+/// scatter (add) over the reduced index map by the caller.
+template <typename T>
+void assemble_matrix_reduced(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    const Form<T>& a, const ReducedDofMap& rdofmap0,
+    const ReducedDofMap& rdofmap1,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+    xtl::span<T> b)
+{
+  if (a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    throw std::runtime_error("Reduced assembly supports cell integrals only");
+  }
+  if (a.function_spaces().at(0)->element()->needs_dof_transformations()
+      or a.function_spaces().at(1)->element()->needs_dof_transformations())
+  {
+    throw std::runtime_error(
+        "Reduced assembly does not support dof transformations");
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+  const int bs0 = dofmap0->bs();
+  const int bs1 = dofmap1->bs();
+  const int num_dofs0 = dofs0.links(0).size();
+  const int num_dofs1 = dofs1.links(0).size();
+  const int ndim0 = bs0 * num_dofs0;
+  const int ndim1 = bs1 * num_dofs1;
+
+  const std::vector<std::int32_t>& f2r0 = rdofmap0.full_to_reduced();
+  const std::vector<std::int32_t>& f2r1 = rdofmap1.full_to_reduced();
+
+  // Gather the boundary values on the trial space dofs
+  auto map1 = dofmap1->index_map;
+  assert(map1);
+  std::vector<T> bc_values(dofmap1->index_map_bs()
+                               * (map1->size_local() + map1->num_ghosts()),
+                           0);
+  for (std::size_t k = 0; k < bcs.size(); ++k)
+  {
+    assert(bcs[k]);
+    assert(bcs[k]->function_space());
+    if (a.function_spaces().at(1)->contains(*bcs[k]->function_space()))
+      bcs[k]->dof_values(xtl::span<T>(bc_values));
+  }
+
+  // Pack constants and coefficients
+  const std::vector<T>& constants = a.packed_constants();
+  const auto coefficients = pack_coefficients(a);
+
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap
+      = mesh->geometry().dofmap();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = mesh->geometry().x();
+
+  std::vector<double> coordinate_dofs(3 * num_dofs_g);
+  std::vector<T> Ae(ndim0 * ndim1), Ar(ndim0 * ndim1);
+  std::vector<std::int32_t> rdofs0(ndim0), rdofs1(ndim1);
+  std::vector<std::int32_t> rows(ndim0), cols(ndim1);
+  std::vector<int> row_pos(ndim0), col_pos(ndim1);
+
+  for (int id : a.integral_ids(IntegralType::cell))
+  {
+    const auto& kernel = a.kernel(IntegralType::cell, id);
+    const auto& [coeffs, cstride] = coefficients.at({IntegralType::cell, id});
+    const std::vector<std::int32_t>& cells = a.cell_domains(id);
+    for (std::size_t index = 0; index < cells.size(); ++index)
+    {
+      std::int32_t c = cells[index];
+
+      // Get cell coordinates/geometry
+      auto x_dofs = x_dofmap.links(c);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+      {
+        std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                    std::next(coordinate_dofs.begin(), 3 * i));
+      }
+
+      // Tabulate element tensor
+      std::fill(Ae.begin(), Ae.end(), 0);
+      kernel(Ae.data(), coeffs.data() + index * cstride, constants.data(),
+             coordinate_dofs.data(), nullptr, nullptr);
+
+      // Map element dofs to reduced indices (-1 for constrained dofs)
+      auto dofs_cell0 = dofs0.links(c);
+      auto dofs_cell1 = dofs1.links(c);
+      for (int i = 0; i < num_dofs0; ++i)
+      {
+        for (int k = 0; k < bs0; ++k)
+          rdofs0[bs0 * i + k] = f2r0[bs0 * dofs_cell0[i] + k];
+      }
+      for (int j = 0; j < num_dofs1; ++j)
+      {
+        for (int k = 0; k < bs1; ++k)
+          rdofs1[bs1 * j + k] = f2r1[bs1 * dofs_cell1[j] + k];
+      }
+
+      // Collect unconstrained rows and columns
+      std::int32_t nr = 0;
+      for (int i = 0; i < ndim0; ++i)
+      {
+        if (rdofs0[i] >= 0)
+        {
+          row_pos[nr] = i;
+          rows[nr++] = rdofs0[i];
+        }
+      }
+      std::int32_t nc = 0;
+      for (int j = 0; j < ndim1; ++j)
+      {
+        if (rdofs1[j] >= 0)
+        {
+          col_pos[nc] = j;
+          cols[nc++] = rdofs1[j];
+        }
+        else
+        {
+          // Fold the constrained column into the right-hand side
+          const T bc = bc_values[bs1 * dofs_cell1[j / bs1] + j % bs1];
+          for (std::int32_t i = 0; i < nr; ++i)
+            b[rows[i]] -= Ae[row_pos[i] * ndim1 + j] * bc;
+        }
+      }
+
+      // Compact the unconstrained block and add at the reduced indices
+      for (std::int32_t i = 0; i < nr; ++i)
+      {
+        for (std::int32_t j = 0; j < nc; ++j)
+          Ar[i * nc + j] = Ae[row_pos[i] * ndim1 + col_pos[j]];
+      }
+      mat_add(nr, rows.data(), nc, cols.data(), Ar.data());
+    }
+  }
+}
+
+} // namespace dolfinx::fem
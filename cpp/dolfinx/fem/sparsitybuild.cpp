@@ -23,11 +23,19 @@ void sparsitybuild::cells(
   const int D = topology.dim();
   auto cells = topology.connectivity(D, 0);
   assert(cells);
-  for (int c = 0; c < cells->num_nodes(); ++c)
-  {
-    pattern.insert(dofmaps[0].get().cell_dofs(c),
-                   dofmaps[1].get().cell_dofs(c));
-  }
+
+  // Bulk-insert over the dofmap adjacency lists; per-cell spans are
+  // never formed
+  assert(dofmaps[0].get().list().num_nodes() == cells->num_nodes());
+  pattern.insert(dofmaps[0].get().list(), dofmaps[1].get().list());
+}
+//-----------------------------------------------------------------------------
+void sparsitybuild::cells(
+    la::SparsityPattern& pattern, const xtl::span<const std::int32_t>& cells,
+    const std::array<const std::reference_wrapper<const fem::DofMap>, 2>&
+        dofmaps)
+{
+  pattern.insert(dofmaps[0].get().list(), dofmaps[1].get().list(), cells);
 }
 //-----------------------------------------------------------------------------
 void sparsitybuild::interior_facets(
@@ -7,7 +7,9 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <functional>
+#include <xtl/xspan.hpp>
 
 namespace dolfinx::la
 {
@@ -33,6 +35,16 @@ void cells(la::SparsityPattern& pattern, const mesh::Topology& topology,
            const std::array<const std::reference_wrapper<const fem::DofMap>, 2>&
                dofmaps);
 
+/// Iterate over a list of cells and insert entries into sparsity
+/// pattern
+/// @param[in,out] pattern The sparsity pattern to insert into
+/// @param[in] cells The cell indices
+/// @param[in] dofmaps The dofmap pair (trial, test) for the cells
+void cells(la::SparsityPattern& pattern,
+           const xtl::span<const std::int32_t>& cells,
+           const std::array<const std::reference_wrapper<const fem::DofMap>, 2>&
+               dofmaps);
+
 /// Iterate over interior facets and insert entries into sparsity pattern
 void interior_facets(
     la::SparsityPattern& pattern, const mesh::Topology& topology,
@@ -0,0 +1,170 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+/// Sum-factorization kernels for tensor-product (quadrilateral and
+/// hexahedral) elements. A Q_p operator that factorises as a Kronecker
+/// product of 1D matrices, e.g. the mass action (M1 x M1 x M1) or the
+/// stiffness action sum_i (... x K1 x ...), can be applied in O(p^4)
+/// per cell (3D) instead of evaluating the dense p^3 x p^3 element
+/// tensor, which is the difference between O(p^7) and O(p^9) work per
+/// assembly. These kernels are the execution layer for matrix-free
+/// operators on structured hex/quad meshes; the 1D factor matrices
+/// (mass, stiffness, differentiation at quadrature points) are
+/// tabulated by the caller from the 1D interval element.
+namespace dolfinx::fem
+{
+
+/// Apply the Kronecker product (A0 x A1) of two dense row-major
+/// matrices to a vector: out = (A0 x A1) in, where Ai is mi x ni and
+/// `in` has length n0*n1. `out` must have length m0*m1 and is
+/// overwritten. Work scales as O(n0 n1 (m0 + m1)).
+/// @param[in] A0 First (slowest index) factor, shape (m0, n0)
+/// @param[in] A1 Second factor, shape (m1, n1)
+/// @param[in] m0 Rows of A0
+/// @param[in] n0 Columns of A0
+/// @param[in] m1 Rows of A1
+/// @param[in] n1 Columns of A1
+/// @param[in] in Input vector (length n0*n1)
+/// @param[out] out Output vector (length m0*m1)
+/// @param[in] scratch Work array of length at least m0*n1
+template <typename T>
+void tensor_apply_2d(const xtl::span<const double>& A0,
+                     const xtl::span<const double>& A1, int m0, int n0, int m1,
+                     int n1, const xtl::span<const T>& in,
+                     const xtl::span<T>& out, const xtl::span<T>& scratch)
+{
+  // t(i0, j1) = sum_j0 A0(i0, j0) in(j0, j1)
+  for (int i0 = 0; i0 < m0; ++i0)
+  {
+    for (int j1 = 0; j1 < n1; ++j1)
+    {
+      T s = 0;
+      for (int j0 = 0; j0 < n0; ++j0)
+        s += A0[i0 * n0 + j0] * in[j0 * n1 + j1];
+      scratch[i0 * n1 + j1] = s;
+    }
+  }
+
+  // out(i0, i1) = sum_j1 A1(i1, j1) t(i0, j1)
+  for (int i0 = 0; i0 < m0; ++i0)
+  {
+    for (int i1 = 0; i1 < m1; ++i1)
+    {
+      T s = 0;
+      for (int j1 = 0; j1 < n1; ++j1)
+        s += A1[i1 * n1 + j1] * scratch[i0 * n1 + j1];
+      out[i0 * m1 + i1] = s;
+    }
+  }
+}
+
+/// Apply the Kronecker product (A0 x A1 x A2) of three dense row-major
+/// matrices to a vector: out = (A0 x A1 x A2) in, where Ai is mi x ni
+/// and `in` has length n0*n1*n2 with index (j0, j1, j2) flattened as
+/// (j0*n1 + j1)*n2 + j2. `out` must have length m0*m1*m2 and is
+/// overwritten. The contraction is performed one direction at a time,
+/// giving O(p^4) work per application for mi = ni = p + 1.
+/// @param[in] A0 First (slowest index) factor, shape (m0, n0)
+/// @param[in] A1 Second factor, shape (m1, n1)
+/// @param[in] A2 Third (fastest index) factor, shape (m2, n2)
+/// @param[in] m0 Rows of A0
+/// @param[in] n0 Columns of A0
+/// @param[in] m1 Rows of A1
+/// @param[in] n1 Columns of A1
+/// @param[in] m2 Rows of A2
+/// @param[in] n2 Columns of A2
+/// @param[in] in Input vector (length n0*n1*n2)
+/// @param[out] out Output vector (length m0*m1*m2)
+/// @param[in] scratch Work array of length at least
+/// max(m0*n1*n2 + m0*m1*n2, ...) = m0*n1*n2 + m0*m1*n2
+template <typename T>
+void tensor_apply_3d(const xtl::span<const double>& A0,
+                     const xtl::span<const double>& A1,
+                     const xtl::span<const double>& A2, int m0, int n0, int m1,
+                     int n1, int m2, int n2, const xtl::span<const T>& in,
+                     const xtl::span<T>& out, const xtl::span<T>& scratch)
+{
+  const xtl::span<T> t0 = scratch.subspan(0, m0 * n1 * n2);
+  const xtl::span<T> t1 = scratch.subspan(m0 * n1 * n2, m0 * m1 * n2);
+
+  // t0(i0, j1, j2) = sum_j0 A0(i0, j0) in(j0, j1, j2)
+  for (int i0 = 0; i0 < m0; ++i0)
+  {
+    for (int j12 = 0; j12 < n1 * n2; ++j12)
+    {
+      T s = 0;
+      for (int j0 = 0; j0 < n0; ++j0)
+        s += A0[i0 * n0 + j0] * in[j0 * n1 * n2 + j12];
+      t0[i0 * n1 * n2 + j12] = s;
+    }
+  }
+
+  // t1(i0, i1, j2) = sum_j1 A1(i1, j1) t0(i0, j1, j2)
+  for (int i0 = 0; i0 < m0; ++i0)
+  {
+    for (int i1 = 0; i1 < m1; ++i1)
+    {
+      for (int j2 = 0; j2 < n2; ++j2)
+      {
+        T s = 0;
+        for (int j1 = 0; j1 < n1; ++j1)
+          s += A1[i1 * n1 + j1] * t0[(i0 * n1 + j1) * n2 + j2];
+        t1[(i0 * m1 + i1) * n2 + j2] = s;
+      }
+    }
+  }
+
+  // out(i0, i1, i2) = sum_j2 A2(i2, j2) t1(i0, i1, j2)
+  for (int i01 = 0; i01 < m0 * m1; ++i01)
+  {
+    for (int i2 = 0; i2 < m2; ++i2)
+    {
+      T s = 0;
+      for (int j2 = 0; j2 < n2; ++j2)
+        s += A2[i2 * n2 + j2] * t1[i01 * n2 + j2];
+      out[i01 * m2 + i2] = s;
+    }
+  }
+}
+
+/// Apply a separable 3D operator of the form
+///
+///     A = sum_d (B^{d,0} x B^{d,1} x B^{d,2})
+///
+/// to a vector, accumulating into `out` (out += A in). The stiffness
+/// operator on an axis-aligned hexahedron is of this form with three
+/// terms (d = 0, 1, 2), each term using the 1D stiffness matrix in
+/// direction d and 1D mass matrices in the others; the mass operator
+/// is a single term of 1D mass matrices.
+/// @param[in] factors Factor matrices, `factors[d][i]` is the 1D
+/// matrix applied in direction i of term d, each of shape (n, n)
+/// row-major
+/// @param[in] n 1D matrix dimension (p + 1 for degree p)
+/// @param[in] in Input vector (length n^3)
+/// @param[in,out] out Output vector (length n^3), accumulated into
+template <typename T>
+void tensor_accumulate_3d(
+    const std::vector<std::array<xtl::span<const double>, 3>>& factors, int n,
+    const xtl::span<const T>& in, const xtl::span<T>& out)
+{
+  std::vector<T> result(n * n * n), scratch(2 * n * n * n);
+  for (const std::array<xtl::span<const double>, 3>& term : factors)
+  {
+    tensor_apply_3d<T>(term[0], term[1], term[2], n, n, n, n, n, n, in,
+                       xtl::span<T>(result), xtl::span<T>(scratch));
+    for (int i = 0; i < n * n * n; ++i)
+      out[i] += result[i];
+  }
+}
+
+} // namespace dolfinx::fem
@@ -13,16 +13,22 @@
 #include "FunctionSpace.h"
 #include "dofmapbuilder.h"
 #include "sparsitybuild.h"
+#include <algorithm>
 #include <array>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/MeshTags.h>
 #include <dolfinx/mesh/Topology.h>
 #include <dolfinx/mesh/topologycomputation.h>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <ufc.h>
 
 using namespace dolfinx;
@@ -234,3 +240,233 @@ fem::FunctionSpace fem::create_functionspace(
           mesh->mpi_comm(), *ufc_map, mesh->topology(), reorder_fn, element)));
 }
 //-----------------------------------------------------------------------------
+std::shared_ptr<const std::vector<std::int32_t>>
+fem::cell_integration_entities(const mesh::MeshTags<int>& tags, int value)
+{
+  // Cached lists, keyed by the MeshTags identity and the tag value
+  static std::mutex cache_mutex;
+  static std::map<std::pair<std::size_t, int>,
+                  std::shared_ptr<const std::vector<std::int32_t>>>
+      cache;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (auto it = cache.find({tags.id(), value}); it != cache.end())
+      return it->second;
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = tags.mesh();
+  assert(mesh);
+  const mesh::Topology& topology = mesh->topology();
+  const int tdim = topology.dim();
+  if (tags.dim() != tdim)
+  {
+    throw std::runtime_error("Invalid MeshTags dimension: "
+                             + std::to_string(tags.dim()));
+  }
+
+  // Limit the scan to the owned tagged cells
+  const std::vector<std::int32_t>& indices = tags.indices();
+  const std::vector<int>& values = tags.values();
+  assert(topology.index_map(tdim));
+  const std::size_t n = std::distance(
+      indices.begin(),
+      std::lower_bound(indices.begin(), indices.end(),
+                       topology.index_map(tdim)->size_local()));
+
+  // Mark the matching cells in parallel, then compact (keeping the
+  // sorted order of the tag indices)
+  std::vector<std::uint8_t> match(n, 0);
+  common::thread_pool().parallel_for(
+      n,
+      [&match, &values, value](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+          match[i] = (values[i] == value);
+      });
+
+  auto entities = std::make_shared<std::vector<std::int32_t>>();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (match[i])
+      entities->push_back(indices[i]);
+  }
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache.insert({{tags.id(), value}, entities}).first->second;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const std::vector<std::pair<std::int32_t, int>>>
+fem::exterior_facet_integration_entities(const mesh::MeshTags<int>& tags,
+                                         int value)
+{
+  // Cached lists, keyed by the MeshTags identity and the tag value
+  static std::mutex cache_mutex;
+  static std::map<std::pair<std::size_t, int>,
+                  std::shared_ptr<const std::vector<std::pair<std::int32_t,
+                                                              int>>>>
+      cache;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (auto it = cache.find({tags.id(), value}); it != cache.end())
+      return it->second;
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = tags.mesh();
+  assert(mesh);
+  const mesh::Topology& topology = mesh->topology();
+  const int tdim = topology.dim();
+  if (tags.dim() != tdim - 1)
+  {
+    throw std::runtime_error("Invalid MeshTags dimension: "
+                             + std::to_string(tags.dim()));
+  }
+
+  mesh->topology_mutable().create_connectivity(tdim - 1, tdim);
+  mesh->topology_mutable().create_connectivity(tdim, tdim - 1);
+  auto f_to_c = topology.connectivity(tdim - 1, tdim);
+  assert(f_to_c);
+  auto c_to_f = topology.connectivity(tdim, tdim - 1);
+  assert(c_to_f);
+
+  // Owned facets that are ghosted elsewhere, to exclude
+  // partition-boundary facets when the mesh has no ghost cells (see
+  // Form::set_domains)
+  assert(topology.index_map(tdim));
+  std::vector<std::int32_t> fwd_shared_facets;
+  if (topology.index_map(tdim)->num_ghosts() == 0)
+  {
+    const std::vector<std::int32_t>& fwd_indices
+        = topology.index_map(tdim - 1)->scatter_fwd_indices().array();
+    fwd_shared_facets.assign(fwd_indices.begin(), fwd_indices.end());
+    std::sort(fwd_shared_facets.begin(), fwd_shared_facets.end());
+  }
+
+  // Limit the scan to the owned tagged facets
+  const std::vector<std::int32_t>& indices = tags.indices();
+  const std::vector<int>& values = tags.values();
+  assert(topology.index_map(tdim - 1));
+  const std::size_t n = std::distance(
+      indices.begin(),
+      std::lower_bound(indices.begin(), indices.end(),
+                       topology.index_map(tdim - 1)->size_local()));
+
+  // Resolve the facet-to-cell lookups in parallel, then compact
+  // (keeping the sorted order of the tag indices)
+  std::vector<std::uint8_t> match(n, 0);
+  std::vector<std::pair<std::int32_t, int>> pairs(n);
+  common::thread_pool().parallel_for(
+      n,
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          const std::int32_t f = indices[i];
+          if (values[i] != value or f_to_c->num_links(f) != 1
+              or std::binary_search(fwd_shared_facets.begin(),
+                                    fwd_shared_facets.end(), f))
+          {
+            continue;
+          }
+          const std::int32_t c = f_to_c->links(f)[0];
+          auto facets = c_to_f->links(c);
+          auto it = std::find(facets.begin(), facets.end(), f);
+          assert(it != facets.end());
+          pairs[i] = {c, int(std::distance(facets.begin(), it))};
+          match[i] = 1;
+        }
+      });
+
+  auto entities = std::make_shared<std::vector<std::pair<std::int32_t, int>>>();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (match[i])
+      entities->push_back(pairs[i]);
+  }
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache.insert({{tags.id(), value}, entities}).first->second;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<
+    const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>>
+fem::interior_facet_integration_entities(const mesh::MeshTags<int>& tags,
+                                         int value)
+{
+  // Cached lists, keyed by the MeshTags identity and the tag value
+  static std::mutex cache_mutex;
+  static std::map<
+      std::pair<std::size_t, int>,
+      std::shared_ptr<
+          const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>>>
+      cache;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (auto it = cache.find({tags.id(), value}); it != cache.end())
+      return it->second;
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = tags.mesh();
+  assert(mesh);
+  const mesh::Topology& topology = mesh->topology();
+  const int tdim = topology.dim();
+  if (tags.dim() != tdim - 1)
+  {
+    throw std::runtime_error("Invalid MeshTags dimension: "
+                             + std::to_string(tags.dim()));
+  }
+
+  mesh->topology_mutable().create_connectivity(tdim - 1, tdim);
+  mesh->topology_mutable().create_connectivity(tdim, tdim - 1);
+  auto f_to_c = topology.connectivity(tdim - 1, tdim);
+  assert(f_to_c);
+  auto c_to_f = topology.connectivity(tdim, tdim - 1);
+  assert(c_to_f);
+
+  // Limit the scan to the owned tagged facets
+  const std::vector<std::int32_t>& indices = tags.indices();
+  const std::vector<int>& values = tags.values();
+  assert(topology.index_map(tdim - 1));
+  const std::size_t n = std::distance(
+      indices.begin(),
+      std::lower_bound(indices.begin(), indices.end(),
+                       topology.index_map(tdim - 1)->size_local()));
+
+  // Resolve the facet-to-cell lookups in parallel, then compact
+  // (keeping the sorted order of the tag indices)
+  std::vector<std::uint8_t> match(n, 0);
+  std::vector<std::tuple<std::int32_t, int, std::int32_t, int>> tuples(n);
+  common::thread_pool().parallel_for(
+      n,
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          const std::int32_t f = indices[i];
+          if (values[i] != value or f_to_c->num_links(f) != 2)
+            continue;
+          auto cells = f_to_c->links(f);
+          std::array<int, 2> local_f;
+          for (int k = 0; k < 2; ++k)
+          {
+            auto facets = c_to_f->links(cells[k]);
+            auto it = std::find(facets.begin(), facets.end(), f);
+            assert(it != facets.end());
+            local_f[k] = std::distance(facets.begin(), it);
+          }
+          tuples[i] = {cells[0], local_f[0], cells[1], local_f[1]};
+          match[i] = 1;
+        }
+      });
+
+  auto entities = std::make_shared<
+      std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>>();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (match[i])
+      entities->push_back(tuples[i]);
+  }
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache.insert({{tags.id(), value}, entities}).first->second;
+}
+//-----------------------------------------------------------------------------
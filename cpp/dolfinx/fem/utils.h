@@ -12,12 +12,16 @@
 #include "Expression.h"
 #include "Form.h"
 #include "Function.h"
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/mesh/cell_types.h>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <ufc.h>
 #include <utility>
 #include <vector>
@@ -633,6 +637,12 @@ pack_coefficients(const Form<T>& u, fem::IntegralType integral_type, int id)
           "Could not pack coefficient. Integral type not supported.");
     }
   }
+
+  // Account for the packed coefficient array. Packed coefficients are
+  // transient, so only the high-water mark is meaningful.
+  register_memory("Packed coefficients", sizeof(T) * c.size());
+  register_memory("Packed coefficients", -std::int64_t(sizeof(T) * c.size()));
+
   return {std::move(c), cstride};
 }
 
@@ -664,6 +674,131 @@ pack_coefficients(const Form<T>& u)
   return coefficients;
 }
 
+/// Cache of packed coefficients for a Form. The cache records the
+/// version counter (Function::version) of each coefficient at pack
+/// time, and update() re-packs only the coefficients whose data has
+/// changed since the last pack, writing in-place into the cached
+/// storage. Coefficients that do not move between assemblies (e.g.
+/// material fields in a Newton loop) are therefore not re-gathered.
+/// When common::num_threads() > 1, stale coefficients are packed in
+/// parallel (each coefficient occupies a disjoint column range of the
+/// packed array).
+template <typename T>
+class CoefficientCache
+{
+public:
+  /// Create a cache for the coefficients of a form
+  explicit CoefficientCache(std::shared_ptr<const Form<T>> form)
+      : _form(form), _versions(form->coefficients().size(),
+                               std::numeric_limits<std::size_t>::max())
+  {
+  }
+
+  /// Packed coefficients for all integrals of the form. Re-packs stale
+  /// coefficients only.
+  const std::map<std::pair<IntegralType, int>, std::pair<std::vector<T>, int>>&
+  update()
+  {
+    const std::vector<std::shared_ptr<const Function<T>>> coefficients
+        = _form->coefficients();
+
+    // Find coefficients that changed since the last pack
+    std::vector<int> stale;
+    for (std::size_t i = 0; i < coefficients.size(); ++i)
+    {
+      if (_versions[i] != coefficients[i]->version())
+      {
+        stale.push_back(i);
+        _versions[i] = coefficients[i]->version();
+      }
+    }
+
+    if (_data.empty())
+    {
+      // First call: pack everything
+      _data = pack_coefficients(*_form);
+      return _data;
+    }
+
+    if (stale.empty())
+      return _data;
+
+    // Re-pack a single coefficient into the cached storage for all
+    // integral domains
+    auto pack_one = [this, &coefficients](int coeff)
+    {
+      const std::vector<int> offsets = _form->coefficient_offsets();
+      const fem::FiniteElement* element
+          = coefficients[coeff]->function_space()->element().get();
+      const fem::DofMap* dofmap
+          = coefficients[coeff]->function_space()->dofmap().get();
+      const xtl::span<const T> v = coefficients[coeff]->x()->array();
+      xtl::span<const std::uint32_t> cell_info;
+      if (element->needs_dof_transformations())
+      {
+        cell_info
+            = xtl::span(_form->mesh()->topology().get_cell_permutation_info());
+      }
+      const auto transform
+          = element->get_dof_transformation_function<T>(false, true);
+
+      for (auto& [key, data] : _data)
+      {
+        auto& [c, cstride] = data;
+        switch (key.first)
+        {
+        case IntegralType::cell:
+          impl::pack_coefficient_cell(
+              xtl::span<T>(c), cstride, v, cell_info, *dofmap,
+              _form->cell_domains(key.second), offsets[coeff],
+              element->space_dimension(), transform);
+          break;
+        case IntegralType::exterior_facet:
+          impl::pack_coefficient_exterior_facet<T>(
+              xtl::span<T>(c), cstride, v, cell_info, *dofmap,
+              _form->exterior_facet_domains(key.second), offsets[coeff],
+              element->space_dimension(), transform);
+          break;
+        case IntegralType::interior_facet:
+          impl::pack_coefficient_interior_facet<T>(
+              xtl::span<T>(c), cstride, v, cell_info, *dofmap,
+              _form->interior_facet_domains(key.second), offsets[coeff],
+              offsets[coeff + 1], element->space_dimension(), transform);
+          break;
+        default:
+          throw std::runtime_error(
+              "Could not pack coefficient. Integral type not supported.");
+        }
+      }
+    };
+
+    if (dolfinx::common::num_threads() > 1 and stale.size() > 1)
+    {
+      std::vector<std::thread> threads;
+      for (int coeff : stale)
+        threads.emplace_back(pack_one, coeff);
+      for (std::thread& thread : threads)
+        thread.join();
+    }
+    else
+    {
+      for (int coeff : stale)
+        pack_one(coeff);
+    }
+
+    return _data;
+  }
+
+private:
+  std::shared_ptr<const Form<T>> _form;
+
+  // Version of each coefficient at the last pack
+  std::vector<std::size_t> _versions;
+
+  // Packed coefficient storage, keyed on (integral type, domain id)
+  std::map<std::pair<IntegralType, int>, std::pair<std::vector<T>, int>> _data;
+};
+
 /// Pack coefficients of a Expression u for a give list of active cells
 ///
 /// @param[in] u The Expression
@@ -756,4 +891,47 @@ std::vector<typename U::scalar_type> pack_constants(const U& u)
   return constant_values;
 }
 
+/// Compute the owned cells tagged with @p value, as consumed by cell
+/// integrals (see Form::set_domains). The scan over the tags runs on
+/// the thread pool, and the result is cached and shared: repeated
+/// calls for the same (tags, value) pair return the same list, so the
+/// conversion is paid once per tag value for all forms on the mesh.
+/// The cache is keyed on the MeshTags identity and entries live for
+/// the duration of the process.
+/// @param[in] tags Tagged cells (dimension must be the cell dimension)
+/// @param[in] value The tag value to select
+/// @return Sorted list of owned tagged cells (local indices)
+std::shared_ptr<const std::vector<std::int32_t>>
+cell_integration_entities(const mesh::MeshTags<int>& tags, int value);
+
+/// Compute the (cell, local facet) pairs for the owned exterior facets
+/// tagged with @p value, as consumed by exterior facet integrals (see
+/// Form::set_domains). The facet-to-cell lookups run on the thread
+/// pool and the result is cached, see cell_integration_entities.
+/// Facets that are not on the exterior boundary are skipped.
+/// @param[in] tags Tagged facets (dimension must be the facet
+/// dimension)
+/// @param[in] value The tag value to select
+/// @return (cell, local facet index) for each owned tagged exterior
+/// facet, ordered by facet index
+std::shared_ptr<const std::vector<std::pair<std::int32_t, int>>>
+exterior_facet_integration_entities(const mesh::MeshTags<int>& tags,
+                                    int value);
+
+/// Compute the (cell0, local facet0, cell1, local facet1) tuples for
+/// the owned interior facets tagged with @p value, as consumed by
+/// interior facet integrals (see Form::set_domains). The facet-to-cell
+/// lookups run on the thread pool and the result is cached, see
+/// cell_integration_entities. Facets connected to fewer than two cells
+/// are skipped.
+/// @param[in] tags Tagged facets (dimension must be the facet
+/// dimension)
+/// @param[in] value The tag value to select
+/// @return The cells and cell-local facet indices on both sides of
+/// each owned tagged interior facet, ordered by facet index
+std::shared_ptr<
+    const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>>
+interior_facet_integration_entities(const mesh::MeshTags<int>& tags,
+                                    int value);
+
 } // namespace dolfinx::fem
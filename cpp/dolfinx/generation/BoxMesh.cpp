@@ -5,10 +5,12 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "BoxMesh.h"
+#include <algorithm>
 #include <cfloat>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <functional>
 #include <xtensor/xfixed.hpp>
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xview.hpp>
@@ -19,8 +21,8 @@ using namespace dolfinx::generation;
 namespace
 {
 //-----------------------------------------------------------------------------
-xt::xtensor<double, 2>
-create_geom(MPI_Comm comm, const std::array<std::array<double, 3>, 2>& p,
+std::function<std::array<double, 3>(std::int64_t)>
+create_geom(const std::array<std::array<double, 3>, 2>& p,
             std::array<std::size_t, 3> n)
 {
   // Extract data
@@ -30,10 +32,6 @@ create_geom(MPI_Comm comm, const std::array<std::array<double, 3>, 2>& p,
   std::int64_t ny = n[1];
   std::int64_t nz = n[2];
 
-  const std::int64_t n_points = (nx + 1) * (ny + 1) * (nz + 1);
-  std::array range_p = dolfinx::MPI::local_range(
-      dolfinx::MPI::rank(comm), n_points, dolfinx::MPI::size(comm));
-
   // Extract minimum and maximum coordinates
   const double x0 = std::min(p0[0], p1[0]);
   const double x1 = std::max(p0[0], p1[0]);
@@ -66,25 +64,20 @@ create_geom(MPI_Comm comm, const std::array<std::array<double, 3>, 2>& p,
         "BoxMesh has non-positive number of vertices in some dimension");
   }
 
-  xt::xtensor<double, 2> geom(
-      {static_cast<std::size_t>(range_p[1] - range_p[0]), 3});
+  // Vertex coordinates are a closed-form function of the structured
+  // (input global) vertex index, so the geometry is kept implicit: no
+  // coordinate array is built or communicated (see mesh::Geometry)
   const std::int64_t sqxy = (nx + 1) * (ny + 1);
-  std::array<double, 3> point;
-  for (std::int64_t v = range_p[0]; v < range_p[1]; ++v)
+  return [a, ab, c, cd, e, ef, nx,
+          sqxy](std::int64_t v) -> std::array<double, 3>
   {
     const std::int64_t iz = v / sqxy;
-    const std::int64_t p = v % sqxy;
-    const std::int64_t iy = p / (nx + 1);
-    const std::int64_t ix = p % (nx + 1);
-    const double z = e + ef * static_cast<double>(iz);
-    const double y = c + cd * static_cast<double>(iy);
-    const double x = a + ab * static_cast<double>(ix);
-    point = {x, y, z};
-    for (std::size_t i = 0; i < 3; i++)
-      geom(v - range_p[0], i) = point[i];
-  }
-
-  return geom;
+    const std::int64_t q = v % sqxy;
+    const std::int64_t iy = q / (nx + 1);
+    const std::int64_t ix = q % (nx + 1);
+    return {a + ab * static_cast<double>(ix), c + cd * static_cast<double>(iy),
+            e + ef * static_cast<double>(iz)};
+  };
 }
 //-----------------------------------------------------------------------------
 mesh::Mesh build_tet(MPI_Comm comm,
@@ -95,7 +88,8 @@ mesh::Mesh build_tet(MPI_Comm comm,
 {
   common::Timer timer("Build BoxMesh");
 
-  xt::xtensor<double, 2> geom = create_geom(comm, p, n);
+  const std::function<std::array<double, 3>(std::int64_t)> geom
+      = create_geom(p, n);
 
   const std::int64_t nx = n[0];
   const std::int64_t ny = n[1];
@@ -141,7 +135,7 @@ mesh::Mesh build_tet(MPI_Comm comm,
   return mesh::create_mesh(
       comm,
       graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
-      element, geom, ghost_mode, partitioner);
+      element, geom, 3, ghost_mode, partitioner);
 }
 //-----------------------------------------------------------------------------
 mesh::Mesh build_hex(MPI_Comm comm,
@@ -150,7 +144,8 @@ mesh::Mesh build_hex(MPI_Comm comm,
                      const mesh::GhostMode ghost_mode,
                      const mesh::CellPartitionFunction& partitioner)
 {
-  xt::xtensor<double, 2> geom = create_geom(comm, p, n);
+  const std::function<std::array<double, 3>(std::int64_t)> geom
+      = create_geom(p, n);
 
   const std::int64_t nx = n[0];
   const std::int64_t ny = n[1];
@@ -192,7 +187,65 @@ mesh::Mesh build_hex(MPI_Comm comm,
   return mesh::create_mesh(
       comm,
       graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
-      element, geom, ghost_mode, partitioner);
+      element, geom, 3, ghost_mode, partitioner);
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh build_hex_q2(MPI_Comm comm,
+                        const std::array<std::array<double, 3>, 2>& p,
+                        std::array<std::size_t, 3> n,
+                        const mesh::GhostMode ghost_mode,
+                        const mesh::CellPartitionFunction& partitioner)
+{
+  // The 27 nodes of a quadratic hexahedron live on the half-step
+  // lattice with degree * n + 1 points per direction, so the node
+  // coordinates are the closed-form vertex coordinates of the doubled
+  // grid and nodes shared between cells (on common vertices, edges
+  // and faces) get the same lattice number analytically
+  const std::function<std::array<double, 3>(std::int64_t)> geom
+      = create_geom(p, {2 * n[0], 2 * n[1], 2 * n[2]});
+
+  const std::int64_t nx = n[0];
+  const std::int64_t ny = n[1];
+  const std::int64_t nz = n[2];
+  const std::int64_t n_cells = nx * ny * nz;
+  std::array range_c = dolfinx::MPI::local_range(
+      dolfinx::MPI::rank(comm), n_cells, dolfinx::MPI::size(comm));
+  const std::size_t cell_range = range_c[1] - range_c[0];
+  xt::xtensor<std::int64_t, 2> cells({cell_range, 27});
+
+  // Lattice offsets of the nodes within one cell: the eight vertices,
+  // then the edge midpoints, face centres and the body centre, in the
+  // entity order of the coordinate element
+  constexpr std::array<std::array<std::int64_t, 3>, 27> node_offset
+      = {{{0, 0, 0}, {2, 0, 0}, {0, 2, 0}, {2, 2, 0}, {0, 0, 2}, {2, 0, 2},
+          {0, 2, 2}, {2, 2, 2}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {2, 1, 0},
+          {2, 0, 1}, {1, 2, 0}, {0, 2, 1}, {2, 2, 1}, {1, 0, 2}, {0, 1, 2},
+          {2, 1, 2}, {1, 2, 2}, {1, 1, 0}, {1, 0, 1}, {0, 1, 1}, {2, 1, 1},
+          {1, 2, 1}, {1, 1, 2}, {1, 1, 1}}};
+
+  for (std::int64_t i = range_c[0]; i < range_c[1]; ++i)
+  {
+    const std::int64_t iz = i / (nx * ny);
+    const std::int64_t j = i % (nx * ny);
+    const std::int64_t iy = j / nx;
+    const std::int64_t ix = j % nx;
+
+    for (std::size_t q = 0; q < node_offset.size(); ++q)
+    {
+      const std::int64_t ax = 2 * ix + node_offset[q][0];
+      const std::int64_t ay = 2 * iy + node_offset[q][1];
+      const std::int64_t az = 2 * iz + node_offset[q][2];
+      cells(i - range_c[0], q)
+          = (az * (2 * ny + 1) + ay) * (2 * nx + 1) + ax;
+    }
+  }
+
+  fem::CoordinateElement element(mesh::CellType::hexahedron, 2);
+  auto [data, offset] = graph::create_adjacency_data(cells);
+  return mesh::create_mesh(
+      comm,
+      graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
+      element, geom, 3, ghost_mode, partitioner);
 }
 //-----------------------------------------------------------------------------
 mesh::Mesh build_prism(MPI_Comm comm,
@@ -201,7 +254,8 @@ mesh::Mesh build_prism(MPI_Comm comm,
                      const mesh::GhostMode ghost_mode,
                      const mesh::CellPartitionFunction& partitioner)
 {
-  xt::xtensor<double, 2> geom = create_geom(comm, p, n);
+  const std::function<std::array<double, 3>(std::int64_t)> geom
+      = create_geom(p, n);
 
   const std::int64_t nx = n[0];
   const std::int64_t ny = n[1];
@@ -243,7 +297,7 @@ mesh::Mesh build_prism(MPI_Comm comm,
   return mesh::create_mesh(
       comm,
       graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
-      element, geom, ghost_mode, partitioner);
+      element, geom, 3, ghost_mode, partitioner);
 }
 //-----------------------------------------------------------------------------
 
@@ -257,6 +311,31 @@ mesh::Mesh BoxMesh::create(MPI_Comm comm,
                            const mesh::GhostMode ghost_mode,
                            const mesh::CellPartitionFunction& partitioner)
 {
+  return create(comm, p, n, celltype, 1, ghost_mode, partitioner);
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh BoxMesh::create(MPI_Comm comm,
+                           const std::array<std::array<double, 3>, 2>& p,
+                           std::array<std::size_t, 3> n,
+                           mesh::CellType celltype, int degree,
+                           const mesh::GhostMode ghost_mode,
+                           const mesh::CellPartitionFunction& partitioner)
+{
+  if (degree == 2)
+  {
+    if (celltype != mesh::CellType::hexahedron)
+    {
+      throw std::runtime_error(
+          "Degree 2 box meshes are supported for hexahedral cells only");
+    }
+    return build_hex_q2(comm, p, n, ghost_mode, partitioner);
+  }
+  else if (degree != 1)
+  {
+    throw std::runtime_error(
+        "Generate box mesh. Coordinate degree must be 1 or 2");
+  }
+
   switch (celltype)
   {
   case mesh::CellType::tetrahedron:
@@ -270,3 +349,88 @@ mesh::Mesh BoxMesh::create(MPI_Comm comm,
   }
 }
 //-----------------------------------------------------------------------------
+mesh::CellPartitionFunction
+BoxMesh::structured_partitioner(std::array<std::size_t, 3> n,
+                                mesh::CellType celltype)
+{
+  int cells_per_cuboid = 0;
+  switch (celltype)
+  {
+  case mesh::CellType::tetrahedron:
+    cells_per_cuboid = 6;
+    break;
+  case mesh::CellType::prism:
+    cells_per_cuboid = 2;
+    break;
+  case mesh::CellType::hexahedron:
+    cells_per_cuboid = 1;
+    break;
+  default:
+    throw std::runtime_error("Generate box mesh. Wrong cell type");
+  }
+
+  return [n, cells_per_cuboid](
+             MPI_Comm comm, int nparts, int /*tdim*/,
+             const graph::AdjacencyList<std::int64_t>& cells,
+             mesh::GhostMode ghost_mode)
+  {
+    const std::int64_t nx = n[0];
+    const std::int64_t ny = n[1];
+    const std::int64_t nz = n[2];
+    const std::int64_t n_cuboids = nx * ny * nz;
+
+    // Global index of the first cell on this rank
+    const std::int64_t num_local = cells.num_nodes();
+    std::int64_t cell_offset = 0;
+    MPI_Exscan(&num_local, &cell_offset, 1, MPI_INT64_T, MPI_SUM, comm);
+
+    const bool ghosting = (ghost_mode != mesh::GhostMode::none);
+    std::vector<std::int32_t> data;
+    std::vector<std::int32_t> offsets(1, 0);
+    data.reserve(num_local);
+    offsets.reserve(num_local + 1);
+    std::vector<std::int32_t> dests;
+    for (std::int64_t k = 0; k < num_local; ++k)
+    {
+      // Cells are generated cuboid-by-cuboid, so the enclosing cuboid
+      // and its grid position follow from the global cell index
+      const std::int64_t i = (cell_offset + k) / cells_per_cuboid;
+      const std::int64_t iz = i / (nx * ny);
+      const std::int64_t iy = (i / nx) % ny;
+      const std::int64_t ix = i % nx;
+      const int owner = dolfinx::MPI::index_owner(nparts, i, n_cuboids);
+      dests.assign(1, owner);
+      if (ghosting)
+      {
+        // Ghost the cell on the owners of the face-neighboring cuboids
+        auto add_neighbor
+            = [&](std::int64_t jx, std::int64_t jy, std::int64_t jz)
+        {
+          if (jx < 0 or jx >= nx or jy < 0 or jy >= ny or jz < 0 or jz >= nz)
+            return;
+          const std::int64_t j = (jz * ny + jy) * nx + jx;
+          if (const int r = dolfinx::MPI::index_owner(nparts, j, n_cuboids);
+              r != owner)
+          {
+            dests.push_back(r);
+          }
+        };
+        add_neighbor(ix - 1, iy, iz);
+        add_neighbor(ix + 1, iy, iz);
+        add_neighbor(ix, iy - 1, iz);
+        add_neighbor(ix, iy + 1, iz);
+        add_neighbor(ix, iy, iz - 1);
+        add_neighbor(ix, iy, iz + 1);
+        std::sort(std::next(dests.begin()), dests.end());
+        dests.erase(std::unique(std::next(dests.begin()), dests.end()),
+                    dests.end());
+      }
+      data.insert(data.end(), dests.begin(), dests.end());
+      offsets.push_back(data.size());
+    }
+
+    return graph::AdjacencyList<std::int32_t>(std::move(data),
+                                              std::move(offsets));
+  };
+}
+//-----------------------------------------------------------------------------
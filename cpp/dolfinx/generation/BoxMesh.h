@@ -41,4 +41,45 @@ create(MPI_Comm comm, const std::array<std::array<double, 3>, 2>& p,
        = static_cast<graph::AdjacencyList<std::int32_t> (*)(
            MPI_Comm, int, int, const graph::AdjacencyList<std::int64_t>&,
            mesh::GhostMode)>(&mesh::partition_cells_graph));
+
+/// Create a uniform mesh::Mesh over a rectangular prism with a
+/// higher-order coordinate element. The geometry nodes are generated
+/// directly on the refined structured lattice (`degree * n[i] + 1`
+/// points per direction), so the coordinates are in closed form and
+/// nodes shared between cells get the same number by construction --
+/// no deduplication pass is needed.
+///
+/// @param[in] comm MPI communicator to build mesh on
+/// @param[in] p Points of box
+/// @param[in] n Number of cells in each direction.
+/// @param[in] celltype Cell shape. Degree 2 is supported for
+/// hexahedral cells only.
+/// @param[in] degree Polynomial degree of the coordinate element (1
+/// or 2)
+/// @param[in] ghost_mode Ghost mode
+/// @param[in] partitioner Partitioning function to use for
+/// determining the parallel distribution of cells across MPI ranks
+/// @return Mesh
+mesh::Mesh
+create(MPI_Comm comm, const std::array<std::array<double, 3>, 2>& p,
+       std::array<std::size_t, 3> n, mesh::CellType celltype, int degree,
+       const mesh::GhostMode ghost_mode,
+       const mesh::CellPartitionFunction& partitioner
+       = static_cast<graph::AdjacencyList<std::int32_t> (*)(
+           MPI_Comm, int, int, const graph::AdjacencyList<std::int64_t>&,
+           mesh::GhostMode)>(&mesh::partition_cells_graph));
+
+/// Create a cell partitioning function that assigns the cells of a
+/// structured box mesh to ranks by closed-form index arithmetic. Cells
+/// are distributed in contiguous slabs of the cell grid, and ghost
+/// destinations (for ghost modes other than none) are the owners of
+/// the face-neighboring grid cells, so dual graph construction and the
+/// graph partitioner are bypassed entirely. Pass the returned function
+/// to BoxMesh::create with the same @p n and @p celltype.
+///
+/// @param[in] n Number of cells in each direction
+/// @param[in] celltype Cell shape
+/// @return A cell partitioning function for use with BoxMesh::create
+mesh::CellPartitionFunction
+structured_partitioner(std::array<std::size_t, 3> n, mesh::CellType celltype);
 } // namespace dolfinx::generation::BoxMesh
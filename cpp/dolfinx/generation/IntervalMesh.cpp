@@ -5,6 +5,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "IntervalMesh.h"
+#include <algorithm>
 #include <cfloat>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/graph/AdjacencyList.h>
@@ -81,3 +82,53 @@ mesh::Mesh IntervalMesh::create(MPI_Comm comm, std::size_t n,
   return build(comm, n, x, ghost_mode, partitioner);
 }
 //-----------------------------------------------------------------------------
+mesh::CellPartitionFunction IntervalMesh::structured_partitioner(std::size_t n)
+{
+  return [n](MPI_Comm comm, int nparts, int /*tdim*/,
+             const graph::AdjacencyList<std::int64_t>& cells,
+             mesh::GhostMode ghost_mode)
+  {
+    const std::int64_t n_cells = n;
+
+    // Global index of the first cell on this rank
+    const std::int64_t num_local = cells.num_nodes();
+    std::int64_t cell_offset = 0;
+    MPI_Exscan(&num_local, &cell_offset, 1, MPI_INT64_T, MPI_SUM, comm);
+
+    const bool ghosting = (ghost_mode != mesh::GhostMode::none);
+    std::vector<std::int32_t> data;
+    std::vector<std::int32_t> offsets(1, 0);
+    data.reserve(num_local);
+    offsets.reserve(num_local + 1);
+    std::vector<std::int32_t> dests;
+    for (std::int64_t k = 0; k < num_local; ++k)
+    {
+      const std::int64_t i = cell_offset + k;
+      const int owner = dolfinx::MPI::index_owner(nparts, i, n_cells);
+      dests.assign(1, owner);
+      if (ghosting)
+      {
+        // Ghost the cell on the owners of the neighboring cells
+        for (std::int64_t j : {i - 1, i + 1})
+        {
+          if (j < 0 or j >= n_cells)
+            continue;
+          if (const int r = dolfinx::MPI::index_owner(nparts, j, n_cells);
+              r != owner)
+          {
+            dests.push_back(r);
+          }
+        }
+        std::sort(std::next(dests.begin()), dests.end());
+        dests.erase(std::unique(std::next(dests.begin()), dests.end()),
+                    dests.end());
+      }
+      data.insert(data.end(), dests.begin(), dests.end());
+      offsets.push_back(data.size());
+    }
+
+    return graph::AdjacencyList<std::int32_t>(std::move(data),
+                                              std::move(offsets));
+  };
+}
+//-----------------------------------------------------------------------------
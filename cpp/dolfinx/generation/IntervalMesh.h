@@ -35,4 +35,17 @@ create(MPI_Comm comm, std::size_t n, std::array<double, 2> x,
        = static_cast<graph::AdjacencyList<std::int32_t> (*)(
            MPI_Comm, int, int, const graph::AdjacencyList<std::int64_t>&,
            mesh::GhostMode)>(&mesh::partition_cells_graph));
+
+/// Create a cell partitioning function that assigns the cells of a
+/// structured interval mesh to ranks by closed-form index arithmetic.
+/// Cells are distributed in contiguous blocks, and ghost destinations
+/// (for ghost modes other than none) are the owners of the neighboring
+/// cells, so dual graph construction and the graph partitioner are
+/// bypassed entirely. Pass the returned function to
+/// IntervalMesh::create with the same @p n.
+///
+/// @param[in] n The number of cells
+/// @return A cell partitioning function for use with
+/// IntervalMesh::create
+mesh::CellPartitionFunction structured_partitioner(std::size_t n);
 } // namespace dolfinx::generation::IntervalMesh
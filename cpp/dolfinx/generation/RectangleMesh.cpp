@@ -5,6 +5,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "RectangleMesh.h"
+#include <algorithm>
 #include <cfloat>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/graph/AdjacencyList.h>
@@ -29,18 +30,6 @@ mesh::Mesh build_tri(MPI_Comm comm,
 {
   fem::CoordinateElement element(mesh::CellType::triangle, 1);
 
-  // Receive mesh if not rank 0
-  if (dolfinx::MPI::rank(comm) != 0)
-  {
-    xt::xtensor<double, 2> geom({0, 2});
-    xt::xtensor<std::int64_t, 2> cells({0, 3});
-    auto [data, offset] = graph::create_adjacency_data(cells);
-    return mesh::create_mesh(
-        comm,
-        graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
-        element, geom, ghost_mode, partitioner);
-  }
-
   // Check options
   if (diagonal != "left" && diagonal != "right" && diagonal != "right/left"
       && diagonal != "left/right" && diagonal != "crossed")
@@ -80,50 +69,47 @@ mesh::Mesh build_tri(MPI_Comm comm,
         "number of vertices must be at least 1 in each dimension");
   }
 
-  // Create vertices and cells
-  std::size_t nv, nc;
-  if (diagonal == "crossed")
-  {
-    nv = (nx + 1) * (ny + 1) + nx * ny;
-    nc = 4 * nx * ny;
-  }
-  else
-  {
-    nv = (nx + 1) * (ny + 1);
-    nc = 2 * nx * ny;
-  }
-
-  xt::xtensor<double, 2> geom({nv, 2});
-  xt::xtensor<std::int64_t, 2> cells({nc, 3});
-
-  // Create main vertices
-  std::size_t vertex = 0;
-  for (std::size_t iy = 0; iy <= ny; iy++)
+  // Vertex coordinates are a closed-form function of the structured
+  // (input global) vertex index, so the geometry is kept implicit: no
+  // coordinate array is built or communicated (see mesh::Geometry).
+  // Indices beyond the main (nx + 1) x (ny + 1) grid are the cell
+  // midpoints of the "crossed" layout.
+  const std::int64_t nv_main = (nx + 1) * (ny + 1);
+  const auto geom = [a, ab, c, cd, nx,
+                     nv_main](std::int64_t v) -> std::array<double, 3>
   {
-    const double x1 = c + cd * static_cast<double>(iy);
-    for (std::size_t ix = 0; ix <= nx; ix++)
+    if (v < nv_main)
     {
-      geom(vertex, 0) = a + ab * static_cast<double>(ix);
-      geom(vertex, 1) = x1;
-      ++vertex;
+      const std::int64_t iy = v / (nx + 1);
+      const std::int64_t ix = v % (nx + 1);
+      return {a + ab * static_cast<double>(ix),
+              c + cd * static_cast<double>(iy), 0.0};
     }
-  }
-
-  // Create midpoint vertices if the mesh type is crossed
-  if (diagonal == "crossed")
-  {
-    for (std::size_t iy = 0; iy < ny; iy++)
+    else
     {
-      const double x1 = c + cd * (static_cast<double>(iy) + 0.5);
-      for (std::size_t ix = 0; ix < nx; ix++)
-      {
-        geom(vertex, 0) = a + ab * (static_cast<double>(ix) + 0.5);
-        geom(vertex, 1) = x1;
-        ++vertex;
-      }
+      const std::int64_t w = v - nv_main;
+      const std::int64_t iy = w / nx;
+      const std::int64_t ix = w % nx;
+      return {a + ab * (static_cast<double>(ix) + 0.5),
+              c + cd * (static_cast<double>(iy) + 0.5), 0.0};
     }
+  };
+
+  // Receive mesh if not rank 0
+  if (dolfinx::MPI::rank(comm) != 0)
+  {
+    xt::xtensor<std::int64_t, 2> cells({0, 3});
+    auto [data, offset] = graph::create_adjacency_data(cells);
+    return mesh::create_mesh(
+        comm,
+        graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
+        element, geom, 2, ghost_mode, partitioner);
   }
 
+  // Create cells
+  const std::size_t nc = (diagonal == "crossed") ? 4 * nx * ny : 2 * nx * ny;
+  xt::xtensor<std::int64_t, 2> cells({nc, 3});
+
   // Create triangles
   if (diagonal == "crossed")
   {
@@ -218,7 +204,7 @@ mesh::Mesh build_tri(MPI_Comm comm,
   return mesh::create_mesh(
       comm,
       graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
-      element, geom, ghost_mode, partitioner);
+      element, geom, 2, ghost_mode, partitioner);
 }
 
 } // namespace
@@ -231,18 +217,6 @@ mesh::Mesh build_quad(MPI_Comm comm,
 {
   fem::CoordinateElement element(mesh::CellType::quadrilateral, 1);
 
-  // Receive mesh if not rank 0
-  if (dolfinx::MPI::rank(comm) != 0)
-  {
-    xt::xtensor<double, 2> geom({0, 2});
-    xt::xtensor<std::int64_t, 2> cells({0, 4});
-    auto [data, offset] = graph::create_adjacency_data(cells);
-    return mesh::create_mesh(
-        comm,
-        graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
-        element, geom, ghost_mode, partitioner);
-  }
-
   const std::size_t nx = n[0];
   const std::size_t ny = n[1];
 
@@ -254,18 +228,27 @@ mesh::Mesh build_quad(MPI_Comm comm,
   const double d = p[1][1];
   const double cd = (d - c) / static_cast<double>(ny);
 
-  // Create vertices
-  xt::xtensor<double, 2> geom({(nx + 1) * (ny + 1), 2});
-  std::size_t vertex = 0;
-  for (std::size_t ix = 0; ix <= nx; ix++)
+  // Vertex coordinates are a closed-form function of the structured
+  // (input global) vertex index (vertices are generated with y as the
+  // fastest direction), so the geometry is kept implicit: no
+  // coordinate array is built or communicated (see mesh::Geometry)
+  const auto geom = [a, ab, c, cd, ny](std::int64_t v) -> std::array<double, 3>
   {
-    double x0 = a + ab * static_cast<double>(ix);
-    for (std::size_t iy = 0; iy <= ny; iy++)
-    {
-      geom(vertex, 0) = x0;
-      geom(vertex, 1) = c + cd * static_cast<double>(iy);
-      ++vertex;
-    }
+    const std::int64_t ix = v / (ny + 1);
+    const std::int64_t iy = v % (ny + 1);
+    return {a + ab * static_cast<double>(ix), c + cd * static_cast<double>(iy),
+            0.0};
+  };
+
+  // Receive mesh if not rank 0
+  if (dolfinx::MPI::rank(comm) != 0)
+  {
+    xt::xtensor<std::int64_t, 2> cells({0, 4});
+    auto [data, offset] = graph::create_adjacency_data(cells);
+    return mesh::create_mesh(
+        comm,
+        graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
+        element, geom, 2, ghost_mode, partitioner);
   }
 
   // Create rectangles
@@ -290,7 +273,7 @@ mesh::Mesh build_quad(MPI_Comm comm,
   return mesh::create_mesh(
       comm,
       graph::AdjacencyList<std::int64_t>(std::move(data), std::move(offset)),
-      element, geom, ghost_mode, partitioner);
+      element, geom, 2, ghost_mode, partitioner);
 }
 //-----------------------------------------------------------------------------
 mesh::Mesh RectangleMesh::create(MPI_Comm comm,
@@ -327,3 +310,89 @@ mesh::Mesh RectangleMesh::create(MPI_Comm comm,
   }
 }
 //-----------------------------------------------------------------------------
+mesh::CellPartitionFunction
+RectangleMesh::structured_partitioner(std::array<std::size_t, 2> n,
+                                      mesh::CellType celltype,
+                                      const std::string& diagonal)
+{
+  // Number of mesh cells per grid cell, and whether the grid is
+  // linearized with x or y as the fastest direction (triangles are
+  // generated row-by-row in y, quadrilaterals column-by-column in x)
+  int cells_per_quad = 0;
+  bool x_fastest = true;
+  switch (celltype)
+  {
+  case mesh::CellType::triangle:
+    cells_per_quad = (diagonal == "crossed") ? 4 : 2;
+    break;
+  case mesh::CellType::quadrilateral:
+    cells_per_quad = 1;
+    x_fastest = false;
+    break;
+  default:
+    throw std::runtime_error("Generate rectangle mesh. Wrong cell type");
+  }
+
+  return [n, cells_per_quad, x_fastest](
+             MPI_Comm comm, int nparts, int /*tdim*/,
+             const graph::AdjacencyList<std::int64_t>& cells,
+             mesh::GhostMode ghost_mode)
+  {
+    const std::int64_t nx = n[0];
+    const std::int64_t ny = n[1];
+    const std::int64_t n_quads = nx * ny;
+    const std::int64_t n_fast = x_fastest ? nx : ny;
+
+    // Global index of the first cell on this rank
+    const std::int64_t num_local = cells.num_nodes();
+    std::int64_t cell_offset = 0;
+    MPI_Exscan(&num_local, &cell_offset, 1, MPI_INT64_T, MPI_SUM, comm);
+
+    const bool ghosting = (ghost_mode != mesh::GhostMode::none);
+    std::vector<std::int32_t> data;
+    std::vector<std::int32_t> offsets(1, 0);
+    data.reserve(num_local);
+    offsets.reserve(num_local + 1);
+    std::vector<std::int32_t> dests;
+    for (std::int64_t k = 0; k < num_local; ++k)
+    {
+      // Cells are generated grid-cell by grid-cell, so the enclosing
+      // grid cell and its position follow from the global cell index
+      const std::int64_t i = (cell_offset + k) / cells_per_quad;
+      const std::int64_t i_slow = i / n_fast;
+      const std::int64_t i_fast = i % n_fast;
+      const int owner = dolfinx::MPI::index_owner(nparts, i, n_quads);
+      dests.assign(1, owner);
+      if (ghosting)
+      {
+        // Ghost the cell on the owners of the edge-neighboring grid
+        // cells
+        const std::int64_t n_slow = x_fastest ? ny : nx;
+        auto add_neighbor = [&](std::int64_t jf, std::int64_t js)
+        {
+          if (jf < 0 or jf >= n_fast or js < 0 or js >= n_slow)
+            return;
+          const std::int64_t j = js * n_fast + jf;
+          if (const int r = dolfinx::MPI::index_owner(nparts, j, n_quads);
+              r != owner)
+          {
+            dests.push_back(r);
+          }
+        };
+        add_neighbor(i_fast - 1, i_slow);
+        add_neighbor(i_fast + 1, i_slow);
+        add_neighbor(i_fast, i_slow - 1);
+        add_neighbor(i_fast, i_slow + 1);
+        std::sort(std::next(dests.begin()), dests.end());
+        dests.erase(std::unique(std::next(dests.begin()), dests.end()),
+                    dests.end());
+      }
+      data.insert(data.end(), dests.begin(), dests.end());
+      offsets.push_back(data.size());
+    }
+
+    return graph::AdjacencyList<std::int32_t>(std::move(data),
+                                              std::move(offsets));
+  };
+}
+//-----------------------------------------------------------------------------
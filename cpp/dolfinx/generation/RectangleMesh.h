@@ -58,4 +58,23 @@ mesh::Mesh create(MPI_Comm comm, const std::array<std::array<double, 3>, 2>& p,
                   const mesh::GhostMode ghost_mode,
                   const mesh::CellPartitionFunction& partitioner,
                   const std::string& diagonal = "right");
+
+/// Create a cell partitioning function that assigns the cells of a
+/// structured rectangle mesh to ranks by closed-form index arithmetic.
+/// Cells are distributed in contiguous slabs of the cell grid, and
+/// ghost destinations (for ghost modes other than none) are the owners
+/// of the edge-neighboring grid cells, so dual graph construction and
+/// the graph partitioner are bypassed entirely. Pass the returned
+/// function to RectangleMesh::create with the same @p n, @p celltype
+/// and @p diagonal.
+///
+/// @param[in] n Number of cells in each direction
+/// @param[in] celltype Cell shape
+/// @param[in] diagonal Direction of diagonals: "left", "right",
+/// "left/right", "crossed"
+/// @return A cell partitioning function for use with
+/// RectangleMesh::create
+mesh::CellPartitionFunction
+structured_partitioner(std::array<std::size_t, 2> n, mesh::CellType celltype,
+                       const std::string& diagonal = "right");
 } // namespace dolfinx::generation::RectangleMesh
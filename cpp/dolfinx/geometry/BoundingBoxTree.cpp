@@ -7,17 +7,24 @@
 
 #include "BoundingBoxTree.h"
 #include "utils.h"
+#include <cstdint>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/utils.h>
+#include <functional>
+#include <numeric>
 
 using namespace dolfinx;
 using namespace dolfinx::geometry;
 
 namespace
 {
+// Bounding box of a mesh entity, with the entity index
+using BBoxLeaf
+    = std::pair<std::array<std::array<double, 3>, 2>, std::int32_t>;
 //-----------------------------------------------------------------------------
 std::vector<std::int32_t> range(const mesh::Mesh& mesh, int tdim)
 {
@@ -88,11 +95,36 @@ std::array<std::array<double, 3>, 2> compute_bbox_of_bboxes(
   return b;
 }
 //------------------------------------------------------------------------------
-int _build_from_leaf(
-    xtl::span<std::pair<std::array<std::array<double, 3>, 2>, std::int32_t>>
-        leaf_bboxes,
-    std::vector<std::array<int, 2>>& bboxes,
-    std::vector<double>& bbox_coordinates)
+// Partition the leaves at the median along the longest box axis. With
+// presorted leaves (Morton order) the midpoint split is kept as-is.
+xtl::span<BBoxLeaf>::iterator
+partition_leaves(xtl::span<BBoxLeaf> leaf_bboxes,
+                 const std::array<std::array<double, 3>, 2>& b, bool presorted)
+{
+  auto middle = std::next(leaf_bboxes.begin(), leaf_bboxes.size() / 2);
+  if (presorted)
+    return middle;
+
+  // Sort bounding boxes along longest axis
+  std::array<double, 3> b_diff;
+  std::transform(b[1].begin(), b[1].end(), b[0].begin(), b_diff.begin(),
+                 std::minus<double>());
+  const std::size_t axis = std::distance(
+      b_diff.begin(), std::max_element(b_diff.begin(), b_diff.end()));
+
+  std::nth_element(leaf_bboxes.begin(), middle, leaf_bboxes.end(),
+                   [axis](const auto& p0, const auto& p1) -> bool
+                   {
+                     const double x0 = p0.first[0][axis] + p0.first[1][axis];
+                     const double x1 = p1.first[0][axis] + p1.first[1][axis];
+                     return x0 < x1;
+                   });
+  return middle;
+}
+//-----------------------------------------------------------------------------
+int _build_from_leaf(xtl::span<BBoxLeaf> leaf_bboxes,
+                     std::vector<std::array<int, 2>>& bboxes,
+                     std::vector<double>& bbox_coordinates, bool presorted)
 {
   if (leaf_bboxes.size() == 1)
   {
@@ -117,28 +149,13 @@ int _build_from_leaf(
     std::array<double, 3> b0 = b[0];
     std::array<double, 3> b1 = b[1];
 
-    // Sort bounding boxes along longest axis
-    std::array<double, 3> b_diff;
-    std::transform(b1.begin(), b1.end(), b0.begin(), b_diff.begin(),
-                   std::minus<double>());
-    const std::size_t axis = std::distance(
-        b_diff.begin(), std::max_element(b_diff.begin(), b_diff.end()));
-
-    auto middle = std::next(leaf_bboxes.begin(), leaf_bboxes.size() / 2);
-
-    std::nth_element(leaf_bboxes.begin(), middle, leaf_bboxes.end(),
-                     [axis](const auto& p0, const auto& p1) -> bool
-                     {
-                       const double x0 = p0.first[0][axis] + p0.first[1][axis];
-                       const double x1 = p1.first[0][axis] + p1.first[1][axis];
-                       return x0 < x1;
-                     });
+    auto middle = partition_leaves(leaf_bboxes, b, presorted);
 
     // Split bounding boxes into two groups and call recursively
     std::array bbox{_build_from_leaf(xtl::span(leaf_bboxes.begin(), middle),
-                                     bboxes, bbox_coordinates),
+                                     bboxes, bbox_coordinates, presorted),
                     _build_from_leaf(xtl::span(middle, leaf_bboxes.end()),
-                                     bboxes, bbox_coordinates)};
+                                     bboxes, bbox_coordinates, presorted)};
 
     // Store bounding box data. Note that root box will be added last.
     bboxes.push_back(bbox);
@@ -148,24 +165,207 @@ int _build_from_leaf(
   }
 }
 //-----------------------------------------------------------------------------
-std::pair<std::vector<std::int32_t>, std::vector<double>> build_from_leaf(
-    std::vector<std::pair<std::array<std::array<double, 3>, 2>, std::int32_t>>
-        leaf_bboxes)
+// Node recorded by the serial split phase of the parallel build. The
+// top of the tree is partitioned into segments of leaves whose
+// subtrees are built as independent tasks; the recorded splits are
+// emitted on top of the segment subtrees afterwards.
+struct SplitNode
 {
-  std::vector<std::array<std::int32_t, 2>> bboxes;
-  std::vector<double> bbox_coordinates;
-  _build_from_leaf(leaf_bboxes, bboxes, bbox_coordinates);
+  std::array<std::array<double, 3>, 2> b;
+  std::array<int, 2> children = {-1, -1};
+  int segment = -1;
+};
+//-----------------------------------------------------------------------------
+int _split_top(xtl::span<BBoxLeaf> leaf_bboxes, std::size_t target_size,
+               bool presorted, std::vector<SplitNode>& splits,
+               std::vector<xtl::span<BBoxLeaf>>& segments)
+{
+  SplitNode node;
+  node.b = compute_bbox_of_bboxes(leaf_bboxes);
+  if (leaf_bboxes.size() <= target_size)
+  {
+    node.segment = segments.size();
+    segments.push_back(leaf_bboxes);
+  }
+  else
+  {
+    auto middle = partition_leaves(leaf_bboxes, node.b, presorted);
+    node.children[0] = _split_top(xtl::span(leaf_bboxes.begin(), middle),
+                                  target_size, presorted, splits, segments);
+    node.children[1] = _split_top(xtl::span(middle, leaf_bboxes.end()),
+                                  target_size, presorted, splits, segments);
+  }
+
+  splits.push_back(node);
+  return splits.size() - 1;
+}
+//-----------------------------------------------------------------------------
+std::pair<std::vector<std::int32_t>, std::vector<double>>
+build_from_leaf(std::vector<BBoxLeaf> leaf_bboxes, bool presorted = false)
+{
+  common::ThreadPool& pool = common::thread_pool();
+  if (pool.num_workers() == 0 or leaf_bboxes.size() < 512)
+  {
+    std::vector<std::array<std::int32_t, 2>> bboxes;
+    std::vector<double> bbox_coordinates;
+    _build_from_leaf(leaf_bboxes, bboxes, bbox_coordinates, presorted);
+
+    std::vector<std::int32_t> bbox_array(2 * bboxes.size());
+    for (std::size_t i = 0; i < bboxes.size(); ++i)
+    {
+      bbox_array[2 * i] = bboxes[i][0];
+      bbox_array[2 * i + 1] = bboxes[i][1];
+    }
 
-  std::vector<std::int32_t> bbox_array(2 * bboxes.size());
-  for (std::size_t i = 0; i < bboxes.size(); ++i)
+    return {std::move(bbox_array), std::move(bbox_coordinates)};
+  }
+
+  // Partition the top of the tree serially into a few segments per
+  // thread, then build the segment subtrees as independent tasks
+  const std::size_t target_size = std::max<std::size_t>(
+      1, leaf_bboxes.size() / (4 * (pool.num_workers() + 1)));
+  std::vector<SplitNode> splits;
+  std::vector<xtl::span<BBoxLeaf>> segments;
+  const int top_root = _split_top(xtl::span(leaf_bboxes), target_size,
+                                  presorted, splits, segments);
+
+  std::vector<std::vector<std::array<int, 2>>> bboxes(segments.size());
+  std::vector<std::vector<double>> coordinates(segments.size());
+  {
+    common::ThreadPool::TaskGroup group(pool);
+    for (std::size_t s = 0; s < segments.size(); ++s)
+    {
+      group.run([s, presorted, &segments, &bboxes, &coordinates]() {
+        _build_from_leaf(segments[s], bboxes[s], coordinates[s], presorted);
+      });
+    }
+    group.wait();
+  }
+
+  // Splice the segment subtrees, offsetting the child indices of
+  // internal nodes. Leaf nodes store entity indices, which are kept.
+  std::size_t num_nodes = splits.size() - segments.size();
+  for (const std::vector<std::array<int, 2>>& b : bboxes)
+    num_nodes += b.size();
+  std::vector<std::int32_t> bbox_array;
+  bbox_array.reserve(2 * num_nodes);
+  std::vector<double> bbox_coordinates;
+  bbox_coordinates.reserve(6 * num_nodes);
+  std::vector<std::int32_t> segment_root(segments.size());
+  for (std::size_t s = 0; s < segments.size(); ++s)
   {
-    bbox_array[2 * i] = bboxes[i][0];
-    bbox_array[2 * i + 1] = bboxes[i][1];
+    const std::int32_t offset = bbox_array.size() / 2;
+    for (const std::array<int, 2>& box : bboxes[s])
+    {
+      if (box[0] == box[1])
+      {
+        bbox_array.push_back(box[0]);
+        bbox_array.push_back(box[1]);
+      }
+      else
+      {
+        bbox_array.push_back(box[0] + offset);
+        bbox_array.push_back(box[1] + offset);
+      }
+    }
+    bbox_coordinates.insert(bbox_coordinates.end(), coordinates[s].begin(),
+                            coordinates[s].end());
+    segment_root[s] = offset + bboxes[s].size() - 1;
   }
 
+  // Emit the recorded split nodes on top, children before their
+  // parent, so the root box is stored last
+  std::function<std::int32_t(int)> emit = [&](int i) -> std::int32_t
+  {
+    const SplitNode& node = splits[i];
+    if (node.segment >= 0)
+      return segment_root[node.segment];
+
+    const std::int32_t c0 = emit(node.children[0]);
+    const std::int32_t c1 = emit(node.children[1]);
+    bbox_array.push_back(c0);
+    bbox_array.push_back(c1);
+    bbox_coordinates.insert(bbox_coordinates.end(), node.b[0].begin(),
+                            node.b[0].end());
+    bbox_coordinates.insert(bbox_coordinates.end(), node.b[1].begin(),
+                            node.b[1].end());
+    return bbox_array.size() / 2 - 1;
+  };
+  emit(top_root);
+
   return {std::move(bbox_array), std::move(bbox_coordinates)};
 }
 //-----------------------------------------------------------------------------
+// Spread the lowest 10 bits of x, inserting two zero bits between
+// consecutive bits
+std::uint32_t spread_bits(std::uint32_t x)
+{
+  x = (x | (x << 16)) & 0x030000ff;
+  x = (x | (x << 8)) & 0x0300f00f;
+  x = (x | (x << 4)) & 0x030c30c3;
+  x = (x | (x << 2)) & 0x09249249;
+  return x;
+}
+//-----------------------------------------------------------------------------
+// Order the leaf boxes along the Morton (Z-order) curve of their
+// centroids, quantized to 10 bits per axis, using a least-significant
+// digit radix sort of the 30-bit codes in two 15-bit passes
+void sort_by_morton_code(std::vector<BBoxLeaf>& leaf_bboxes)
+{
+  const std::array<std::array<double, 3>, 2> b
+      = compute_bbox_of_bboxes(leaf_bboxes);
+
+  std::vector<std::uint32_t> codes(leaf_bboxes.size());
+  common::thread_pool().parallel_for(
+      leaf_bboxes.size(),
+      [&leaf_bboxes, &codes, &b](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          std::uint32_t code = 0;
+          for (int j = 0; j < 3; ++j)
+          {
+            const double extent = b[1][j] - b[0][j];
+            const double c = 0.5
+                             * (leaf_bboxes[i].first[0][j]
+                                + leaf_bboxes[i].first[1][j]);
+            std::uint32_t q = 0;
+            if (extent > 0.0)
+            {
+              q = std::min(
+                  std::uint32_t(1024.0 * (c - b[0][j]) / extent),
+                  std::uint32_t(1023));
+            }
+            code |= spread_bits(q) << j;
+          }
+          codes[i] = code;
+        }
+      });
+
+  // Two stable counting passes over 15-bit digits
+  constexpr int digit_bits = 15;
+  constexpr std::uint32_t mask = (1 << digit_bits) - 1;
+  std::vector<BBoxLeaf> leaf_buffer(leaf_bboxes.size());
+  std::vector<std::uint32_t> code_buffer(codes.size());
+  std::vector<std::int32_t> offsets((1 << digit_bits) + 1);
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    const int shift = pass * digit_bits;
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for (std::uint32_t code : codes)
+      ++offsets[((code >> shift) & mask) + 1];
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    for (std::size_t i = 0; i < codes.size(); ++i)
+    {
+      const std::int32_t pos = offsets[(codes[i] >> shift) & mask]++;
+      leaf_buffer[pos] = leaf_bboxes[i];
+      code_buffer[pos] = codes[i];
+    }
+    std::swap(leaf_bboxes, leaf_buffer);
+    std::swap(codes, code_buffer);
+  }
+}
+//-----------------------------------------------------------------------------
 int _build_from_point(
     xtl::span<std::pair<std::array<double, 3>, std::int32_t>> points,
     std::vector<std::array<std::int32_t, 2>>& bboxes,
@@ -221,16 +421,17 @@ int _build_from_point(
 
 //-----------------------------------------------------------------------------
 BoundingBoxTree::BoundingBoxTree(const mesh::Mesh& mesh, int tdim,
-                                 double padding)
-    : BoundingBoxTree::BoundingBoxTree(mesh, tdim, range(mesh, tdim), padding)
+                                 double padding, Method method)
+    : BoundingBoxTree::BoundingBoxTree(mesh, tdim, range(mesh, tdim), padding,
+                                       method)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
 BoundingBoxTree::BoundingBoxTree(const mesh::Mesh& mesh, int tdim,
                                  const xtl::span<const std::int32_t>& entities,
-                                 double padding)
-    : _tdim(tdim)
+                                 double padding, Method method)
+    : _tdim(tdim), _padding(padding)
 {
   if (tdim < 0 or tdim > mesh.topology().dim())
   {
@@ -258,7 +459,12 @@ BoundingBoxTree::BoundingBoxTree(const mesh::Mesh& mesh, int tdim,
 
   // Recursively build the bounding box tree from the leaves
   if (!leaf_bboxes.empty())
-    std::tie(_bboxes, _bbox_coordinates) = build_from_leaf(leaf_bboxes);
+  {
+    if (method == Method::morton)
+      sort_by_morton_code(leaf_bboxes);
+    std::tie(_bboxes, _bbox_coordinates) = build_from_leaf(
+        std::move(leaf_bboxes), method == Method::morton);
+  }
 
   LOG(INFO) << "Computed bounding box tree with " << num_bboxes()
             << " nodes for " << entities.size() << " entities.";
@@ -294,6 +500,72 @@ BoundingBoxTree::BoundingBoxTree(std::vector<std::int32_t>&& bboxes,
   // Do nothing
 }
 //-----------------------------------------------------------------------------
+void BoundingBoxTree::refit(const mesh::Mesh& mesh)
+{
+  const std::int32_t num_nodes = num_bboxes();
+  if (num_nodes == 0)
+    return;
+
+  // Collect the entities stored in the leaves. The leaf ordering fixed
+  // at construction is kept, only the box extents are updated.
+  std::vector<std::int32_t> leaf_nodes, leaf_entities;
+  for (std::int32_t i = 0; i < num_nodes; ++i)
+  {
+    if (_bboxes[2 * i] == _bboxes[2 * i + 1])
+    {
+      leaf_nodes.push_back(i);
+      leaf_entities.push_back(_bboxes[2 * i + 1]);
+    }
+  }
+
+  // Recompute leaf extents from the updated geometry in one batch
+  mesh.topology_mutable().create_connectivity(_tdim, mesh.topology().dim());
+  const xt::xtensor<std::int32_t, 2> geom_indices
+      = mesh::entities_to_geometry(mesh, _tdim, leaf_entities, false);
+  const xt::xtensor<double, 2>& xg = mesh.geometry().x();
+  for (std::size_t l = 0; l < leaf_nodes.size(); ++l)
+  {
+    double* b = _bbox_coordinates.data() + 6 * leaf_nodes[l];
+    for (int j = 0; j < 3; ++j)
+    {
+      b[j] = xg(geom_indices(l, 0), j);
+      b[j + 3] = b[j];
+    }
+    for (std::size_t v = 1; v < geom_indices.shape(1); ++v)
+    {
+      for (int j = 0; j < 3; ++j)
+      {
+        b[j] = std::min(b[j], xg(geom_indices(l, v), j));
+        b[j + 3] = std::max(b[j + 3], xg(geom_indices(l, v), j));
+      }
+    }
+    for (int j = 0; j < 3; ++j)
+    {
+      b[j] -= _padding;
+      b[j + 3] += _padding;
+    }
+  }
+
+  // Update the internal nodes bottom-up. Children are stored before
+  // their parent, so a forward pass visits every node after both of
+  // its children have been updated.
+  for (std::int32_t i = 0; i < num_nodes; ++i)
+  {
+    const std::int32_t c0 = _bboxes[2 * i];
+    const std::int32_t c1 = _bboxes[2 * i + 1];
+    if (c0 == c1)
+      continue;
+    double* b = _bbox_coordinates.data() + 6 * i;
+    const double* b0 = _bbox_coordinates.data() + 6 * c0;
+    const double* b1 = _bbox_coordinates.data() + 6 * c1;
+    for (int j = 0; j < 3; ++j)
+    {
+      b[j] = std::min(b0[j], b1[j]);
+      b[j + 3] = std::max(b0[j + 3], b1[j + 3]);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 BoundingBoxTree BoundingBoxTree::create_global_tree(const MPI_Comm& comm) const
 {
   // Build tree for each rank
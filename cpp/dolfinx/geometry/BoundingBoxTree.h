@@ -27,6 +27,18 @@ class BoundingBoxTree
 {
 
 public:
+  /// Algorithm used to build the tree from the leaf bounding boxes
+  enum class Method
+  {
+    /// Recursive median splits along the longest box axis
+    bisection,
+    /// Radix sort of the leaf Morton codes in two passes, then
+    /// midpoint splits of the sorted leaves. Cheaper to build on
+    /// large meshes; the boxes of sibling nodes can overlap slightly
+    /// more than with bisection.
+    morton
+  };
+
   /// Constructor
   /// @param[in] mesh The mesh for building the bounding box tree
   /// @param[in] tdim The topological dimension of the mesh entities to
@@ -35,9 +47,10 @@ public:
   /// compute the bounding box for (may be empty, if none).
   /// @param[in] padding A float perscribing how much the bounding box
   /// of each entity should be padded
+  /// @param[in] method Algorithm used to build the tree
   BoundingBoxTree(const mesh::Mesh& mesh, int tdim,
                   const xtl::span<const std::int32_t>& entities,
-                  double padding = 0);
+                  double padding = 0, Method method = Method::bisection);
 
   /// Constructor
   /// @param[in] mesh The mesh for building the bounding box tree
@@ -45,7 +58,9 @@ public:
   /// build the bounding box tree for
   /// @param[in] padding A float perscribing how much the bounding box
   /// of each entity should be padded
-  BoundingBoxTree(const mesh::Mesh& mesh, int tdim, double padding = 0);
+  /// @param[in] method Algorithm used to build the tree
+  BoundingBoxTree(const mesh::Mesh& mesh, int tdim, double padding = 0,
+                  Method method = Method::bisection);
 
   /// Constructor @param[in] points Cloud of points, with associated
   /// point identifier index, to build the bounding box tree around
@@ -73,6 +88,19 @@ public:
   /// the upper corner
   xt::xtensor_fixed<double, xt::xshape<2, 3>> get_bbox(std::size_t node) const;
 
+  /// Recompute the bounding box extents from updated mesh geometry
+  ///
+  /// The tree structure and the leaf ordering determined at
+  /// construction are kept, and only the box coordinates are
+  /// recomputed bottom-up — an O(n) pass that avoids the
+  /// sort-and-split recursion of a full rebuild. Intended for meshes
+  /// whose coordinates move (e.g. ALE) while the topology is
+  /// unchanged. The padding prescribed at construction is re-applied.
+  /// @pre The tree must have been built from mesh entities (not from
+  /// a point cloud) of a mesh with the same topology as @p mesh
+  /// @param[in] mesh The mesh with updated geometry
+  void refit(const mesh::Mesh& mesh);
+
   /// Compute a global bounding tree (collective on comm)
   /// This can be used to find which process a point might have a
   /// collision with.
@@ -102,6 +130,17 @@ public:
     return {_bboxes[2 * node], _bboxes[2 * node + 1]};
   }
 
+  /// Get the flat array of bounding box coordinates for all nodes in
+  /// the tree. The lower and upper corners of node `i` are stored
+  /// contiguously at positions `[6 * i, 6 * i + 3)` and
+  /// `[6 * i + 3, 6 * i + 6)`, respectively, so traversals can read
+  /// box extents directly without copying them into a tensor (see
+  /// BoundingBoxTree::get_bbox).
+  xtl::span<const double> bbox_coordinates() const
+  {
+    return xtl::span<const double>(_bbox_coordinates);
+  }
+
 private:
   // Constructor
   BoundingBoxTree(std::vector<std::int32_t>&& bboxes,
@@ -118,5 +157,9 @@ private:
 
   // List of bounding box coordinates
   std::vector<double> _bbox_coordinates;
+
+  // Padding applied to the leaf bounding boxes at construction,
+  // re-applied by refit()
+  double _padding = 0;
 };
 } // namespace dolfinx::geometry
@@ -0,0 +1,231 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "PointLocator.h"
+#include "utils.h"
+#include <algorithm>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/utils.h>
+#include <numeric>
+
+using namespace dolfinx;
+using namespace dolfinx::geometry;
+
+namespace
+{
+//-----------------------------------------------------------------------------
+// Exact test whether a cell contains a point (x has shape (1, 3)).
+// Uses the same GJK distance and tolerance as compute_colliding_cells.
+bool cell_contains(const mesh::Mesh& mesh, std::int32_t cell,
+                   const xt::xtensor<double, 2>& x)
+{
+  constexpr double eps2 = 1e-20;
+  const std::array<std::int32_t, 1> c = {cell};
+  return geometry::squared_distance(mesh, mesh.topology().dim(), c, x)[0]
+         < eps2;
+}
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+PointLocator::PointLocator(std::shared_ptr<const mesh::Mesh> mesh,
+                           double padding, bool build_grid)
+    : _mesh(std::move(mesh)), _tree(*_mesh, _mesh->topology().dim(), padding),
+      _has_grid(false), _grid_x0({0, 0, 0}), _grid_spacing(1),
+      _grid_dims({1, 1, 1})
+{
+  const int tdim = _mesh->topology().dim();
+
+  // Connectivity for walking from a hinted cell to its vertex
+  // neighbors
+  _mesh->topology_mutable().create_connectivity(tdim, 0);
+  _mesh->topology_mutable().create_connectivity(0, tdim);
+
+  auto map = _mesh->topology().index_map(tdim);
+  assert(map);
+  _num_cells = map->size_local() + map->num_ghosts();
+
+  if (build_grid and _num_cells > 0)
+  {
+    // Bin cells by midpoint on a uniform grid with spacing equal to
+    // the largest cell diameter. A cell containing a point then has
+    // its midpoint in the bin of the point or in one of the
+    // neighboring bins.
+    std::vector<std::int32_t> cells(_num_cells);
+    std::iota(cells.begin(), cells.end(), 0);
+    const auto [h, midpoints] = mesh::cell_metrics(*_mesh, cells, tdim);
+    const double h_max = *std::max_element(h.begin(), h.end());
+    _grid_spacing = h_max > 0.0 ? h_max : 1.0;
+    for (int j = 0; j < 3; ++j)
+    {
+      double x_min = midpoints(0, j);
+      double x_max = x_min;
+      for (std::int32_t c = 1; c < _num_cells; ++c)
+      {
+        x_min = std::min(x_min, midpoints(c, j));
+        x_max = std::max(x_max, midpoints(c, j));
+      }
+      _grid_x0[j] = x_min;
+      _grid_dims[j] = static_cast<std::int32_t>((x_max - x_min) / _grid_spacing)
+                      + 1;
+    }
+
+    // Count cells per bin, then fill by insertion position
+    const auto bin = [this](std::int32_t c,
+                            const xt::xtensor<double, 2>& midpoints)
+    {
+      std::array<std::int32_t, 3> b;
+      for (int j = 0; j < 3; ++j)
+      {
+        b[j] = std::clamp(
+            static_cast<std::int32_t>((midpoints(c, j) - _grid_x0[j])
+                                      / _grid_spacing),
+            0, _grid_dims[j] - 1);
+      }
+      return (b[2] * _grid_dims[1] + b[1]) * _grid_dims[0] + b[0];
+    };
+
+    const std::int32_t num_bins
+        = _grid_dims[0] * _grid_dims[1] * _grid_dims[2];
+    _grid_offsets.assign(num_bins + 1, 0);
+    for (std::int32_t c = 0; c < _num_cells; ++c)
+      _grid_offsets[bin(c, midpoints) + 1] += 1;
+    std::partial_sum(_grid_offsets.begin(), _grid_offsets.end(),
+                     _grid_offsets.begin());
+    _grid_cells.resize(_num_cells);
+    std::vector<std::int32_t> pos(_grid_offsets.begin(),
+                                  std::prev(_grid_offsets.end()));
+    for (std::int32_t c = 0; c < _num_cells; ++c)
+      _grid_cells[pos[bin(c, midpoints)]++] = c;
+    _has_grid = true;
+  }
+}
+//-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+PointLocator::locate(const xt::xtensor<double, 2>& points,
+                     const xtl::span<const std::int32_t>& hints) const
+{
+  assert(points.shape(1) == 3);
+  assert(hints.empty() or hints.size() == points.shape(0));
+  const std::size_t num_points = points.shape(0);
+  std::vector<std::int32_t> cells(num_points, -1);
+
+  const int tdim = _mesh->topology().dim();
+  auto c_to_v = _mesh->topology().connectivity(tdim, 0);
+  auto v_to_c = _mesh->topology().connectivity(0, tdim);
+  assert(c_to_v);
+  assert(v_to_c);
+
+  std::vector<std::size_t> missed;
+  std::vector<std::int32_t> candidates;
+  xt::xtensor<double, 2> x({1, 3});
+  for (std::size_t p = 0; p < num_points; ++p)
+  {
+    for (std::size_t j = 0; j < 3; ++j)
+      x(0, j) = points(p, j);
+
+    // Test the hinted cell, then the cells sharing a vertex with it
+    if (!hints.empty() and hints[p] >= 0 and hints[p] < _num_cells)
+    {
+      const std::int32_t c = hints[p];
+      if (cell_contains(*_mesh, c, x))
+      {
+        cells[p] = c;
+        continue;
+      }
+
+      candidates.clear();
+      for (std::int32_t v : c_to_v->links(c))
+        for (std::int32_t c1 : v_to_c->links(v))
+          if (c1 != c)
+            candidates.push_back(c1);
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                       candidates.end());
+      for (std::int32_t c1 : candidates)
+      {
+        if (cell_contains(*_mesh, c1, x))
+        {
+          cells[p] = c1;
+          break;
+        }
+      }
+      if (cells[p] >= 0)
+        continue;
+    }
+
+    // Test the cells binned in the grid neighborhood of the point
+    if (_has_grid)
+    {
+      std::array<std::int32_t, 3> b;
+      for (int j = 0; j < 3; ++j)
+      {
+        b[j] = std::clamp(
+            static_cast<std::int32_t>((points(p, j) - _grid_x0[j])
+                                      / _grid_spacing),
+            0, _grid_dims[j] - 1);
+      }
+      for (std::int32_t bz = std::max(b[2] - 1, 0);
+           bz <= std::min(b[2] + 1, _grid_dims[2] - 1) and cells[p] < 0; ++bz)
+      {
+        for (std::int32_t by = std::max(b[1] - 1, 0);
+             by <= std::min(b[1] + 1, _grid_dims[1] - 1) and cells[p] < 0;
+             ++by)
+        {
+          for (std::int32_t bx = std::max(b[0] - 1, 0);
+               bx <= std::min(b[0] + 1, _grid_dims[0] - 1) and cells[p] < 0;
+               ++bx)
+          {
+            const std::int32_t bb = (bz * _grid_dims[1] + by) * _grid_dims[0]
+                                    + bx;
+            for (std::int32_t i = _grid_offsets[bb]; i < _grid_offsets[bb + 1];
+                 ++i)
+            {
+              if (cell_contains(*_mesh, _grid_cells[i], x))
+              {
+                cells[p] = _grid_cells[i];
+                break;
+              }
+            }
+          }
+        }
+      }
+      if (cells[p] >= 0)
+        continue;
+    }
+
+    missed.push_back(p);
+  }
+
+  // Fall back to the tree for points that missed the hint and the grid
+  if (!missed.empty())
+  {
+    xt::xtensor<double, 2> x_missed({missed.size(), 3});
+    for (std::size_t i = 0; i < missed.size(); ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        x_missed(i, j) = points(missed[i], j);
+    const graph::AdjacencyList<std::int32_t> bbox_cells
+        = compute_collisions(_tree, x_missed);
+    const graph::AdjacencyList<std::int32_t> colliding
+        = compute_colliding_cells(*_mesh, bbox_cells, x_missed);
+    for (std::size_t i = 0; i < missed.size(); ++i)
+    {
+      auto links = colliding.links(i);
+      if (!links.empty())
+        cells[missed[i]] = links.front();
+    }
+  }
+
+  return cells;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+PointLocator::locate(const xt::xtensor<double, 2>& points) const
+{
+  return locate(points, xtl::span<const std::int32_t>());
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "BoundingBoxTree.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <xtensor/xtensor.hpp>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::mesh
+{
+class Mesh;
+}
+
+namespace dolfinx::geometry
+{
+
+/// Point location session for repeated, temporally coherent queries
+///
+/// For query sequences where points move little between calls (e.g.
+/// particle tracking), restarting the bounding box tree traversal from
+/// the root for every point wastes most of the work. A PointLocator
+/// holds the search structures for a mesh and accepts per-point cell
+/// hints: the hinted cell and the cells sharing a vertex with it are
+/// tested first, an optional uniform grid over cell midpoints second,
+/// and the BoundingBoxTree is only traversed for points that miss
+/// both.
+class PointLocator
+{
+public:
+  /// Create a point location session for the cells of a mesh
+  /// @param[in] mesh The mesh
+  /// @param[in] padding Padding applied to the bounding boxes of the
+  /// cells in the fallback tree
+  /// @param[in] build_grid Build a uniform grid over the cell
+  /// midpoints, with spacing equal to the largest cell diameter, for
+  /// O(1) candidate lookup. Effective for quasi-uniform meshes; for
+  /// strongly graded meshes the grid bins become large and the tree
+  /// fallback is usually faster.
+  PointLocator(std::shared_ptr<const mesh::Mesh> mesh, double padding = 0,
+               bool build_grid = false);
+
+  /// Move constructor
+  PointLocator(PointLocator&& locator) = default;
+
+  /// Copy constructor
+  PointLocator(const PointLocator& locator) = delete;
+
+  /// Destructor
+  ~PointLocator() = default;
+
+  /// Locate the cells containing a set of points
+  /// @param[in] points The points (shape=(num_points, 3))
+  /// @param[in] hints Per-point cell hints, typically the cells
+  /// returned by the previous call for the same points. May be empty
+  /// (no hints); a negative entry means no hint for that point.
+  /// @return The index of a cell (local to process) containing each
+  /// point, or -1 if no cell contains it
+  std::vector<std::int32_t>
+  locate(const xt::xtensor<double, 2>& points,
+         const xtl::span<const std::int32_t>& hints) const;
+
+  /// Locate the cells containing a set of points, without hints
+  /// @param[in] points The points (shape=(num_points, 3))
+  /// @return The index of a cell (local to process) containing each
+  /// point, or -1 if no cell contains it
+  std::vector<std::int32_t> locate(const xt::xtensor<double, 2>& points) const;
+
+private:
+  // Mesh to locate points in
+  std::shared_ptr<const mesh::Mesh> _mesh;
+
+  // Fallback search tree over the cells
+  BoundingBoxTree _tree;
+
+  // Number of cells (including ghosts)
+  std::int32_t _num_cells;
+
+  // Uniform grid over cell midpoints (empty if not built): origin,
+  // spacing, number of bins per axis, and the cells binned by
+  // midpoint as (offsets, flattened cell indices)
+  bool _has_grid;
+  std::array<double, 3> _grid_x0;
+  double _grid_spacing;
+  std::array<std::int32_t, 3> _grid_dims;
+  std::vector<std::int32_t> _grid_offsets;
+  std::vector<std::int32_t> _grid_cells;
+};
+} // namespace dolfinx::geometry
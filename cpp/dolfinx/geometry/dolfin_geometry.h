@@ -12,4 +12,5 @@ namespace dolfinx
 // DOLFINx geometry interface
 
 #include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/PointLocator.h>
 #include <dolfinx/geometry/gjk.h>
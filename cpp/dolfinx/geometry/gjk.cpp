@@ -5,64 +5,83 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "gjk.h"
-#include <dolfinx/common/math.h>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
 #include <stdexcept>
-#include <tuple>
-#include <xtensor/xbuilder.hpp>
-#include <xtensor/xfixed.hpp>
-#include <xtensor/xnorm.hpp>
-#include <xtensor/xsort.hpp>
-#include <xtensor/xtensor.hpp>
-#include <xtensor/xview.hpp>
 
 using namespace dolfinx;
 
 namespace
 {
+// The GJK iteration runs on fixed-size arrays (a simplex has at most
+// four vertices) so that no heap or tensor allocation happens on the
+// per-pair hot path.
 
-// Find the resulting sub-simplex of the input simplex which is nearest to the
-// origin. Also, return the shortest vector from the origin to the resulting
-// simplex.
-std::pair<xt::xtensor<double, 2>, xt::xtensor_fixed<double, xt::xshape<3>>>
-nearest_simplex(const xt::xtensor<double, 2>& s)
+//----------------------------------------------------------------------------
+constexpr double dot3(const std::array<double, 3>& a,
+                      const std::array<double, 3>& b)
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+//----------------------------------------------------------------------------
+constexpr std::array<double, 3> sub3(const std::array<double, 3>& a,
+                                     const std::array<double, 3>& b)
+{
+  return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+//----------------------------------------------------------------------------
+constexpr std::array<double, 3> cross3(const std::array<double, 3>& a,
+                                       const std::array<double, 3>& b)
 {
-  assert(s.shape(1) == 3);
-  const std::size_t s_rows = s.shape(0);
-  switch (s_rows)
+  return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+          a[0] * b[1] - a[1] * b[0]};
+}
+//----------------------------------------------------------------------------
+// Find the sub-simplex of the simplex s (of size n) nearest to the
+// origin. The sub-simplex is written back into the leading entries of
+// s and its size returned; v is set to the shortest vector from the
+// origin to the sub-simplex.
+std::size_t nearest_simplex(std::array<std::array<double, 3>, 4>& s,
+                            std::size_t n, std::array<double, 3>& v)
+{
+  switch (n)
   {
   case 2:
   {
-    auto s0 = xt::row(s, 0);
-    auto s1 = xt::row(s, 1);
-    const double lm = -xt::sum(s0 * (s1 - s0))() / xt::norm_sq(s1 - s0)();
+    const std::array<double, 3> ds = sub3(s[1], s[0]);
+    const double lm = -dot3(s[0], ds) / dot3(ds, ds);
     if (lm >= 0.0 and lm <= 1.0)
     {
       // The origin is between A and B
-      auto v = s0 + lm * (s1 - s0);
-      return {s, v};
+      for (int j = 0; j < 3; ++j)
+        v[j] = s[0][j] + lm * ds[j];
+      return 2;
     }
 
     if (lm < 0.0)
-      return {xt::reshape_view(s0, {1, 3}), s0};
+    {
+      v = s[0];
+      return 1;
+    }
     else
-      return {xt::reshape_view(s1, {1, 3}), s1};
+    {
+      v = s[1];
+      s[0] = s[1];
+      return 1;
+    }
   }
   case 4:
   {
-    auto s0 = xt::row(s, 0);
-    auto s1 = xt::row(s, 1);
-    auto s2 = xt::row(s, 2);
-    auto s3 = xt::row(s, 3);
-    auto W1 = math::cross(s0, s1);
-    auto W2 = math::cross(s2, s3);
-
-    xt::xtensor_fixed<double, xt::xshape<4>> B;
-    B[0] = xt::sum(s2 * W1)();
-    B[1] = -xt::sum(s3 * W1)();
-    B[2] = xt::sum(s0 * W2)();
-    B[3] = -xt::sum(s1 * W2)();
-
-    const bool signDetM = std::signbit(xt::sum(B)());
+    const std::array<double, 3> W1 = cross3(s[0], s[1]);
+    const std::array<double, 3> W2 = cross3(s[2], s[3]);
+
+    const std::array<double, 4> B
+        = {dot3(s[2], W1), -dot3(s[3], W1), dot3(s[0], W2), -dot3(s[1], W2)};
+
+    const bool signDetM = std::signbit(B[0] + B[1] + B[2] + B[3]);
     std::array<bool, 4> f_inside;
     for (int i = 0; i < 4; ++i)
       f_inside[i] = (std::signbit(B[i]) == signDetM);
@@ -70,53 +89,60 @@ nearest_simplex(const xt::xtensor<double, 2>& s)
     if (f_inside[1] and f_inside[2] and f_inside[3])
     {
       if (f_inside[0]) // The origin is inside the tetrahedron
-        return {s, xt::zeros<double>({3})};
+      {
+        v = {0, 0, 0};
+        return 4;
+      }
       else // The origin projection P faces BCD
-        return nearest_simplex(xt::view(s, xt::range(0, 3), xt::all()));
+        return nearest_simplex(s, 3, v);
     }
 
-    // Test ACD, ABD and/or ABC.
-    xt::xtensor<double, 2> smin;
-    xt::xtensor_fixed<double, xt::xshape<3>> vmin = xt::zeros<double>({3});
+    // Test ACD, ABD and/or ABC
     constexpr int facets[3][3] = {{0, 1, 3}, {0, 2, 3}, {1, 2, 3}};
+    std::array<std::array<double, 3>, 4> smin = {};
+    std::size_t smin_size = 0;
+    std::array<double, 3> vmin = {0, 0, 0};
     double qmin = std::numeric_limits<double>::max();
     for (int i = 0; i < 3; ++i)
     {
       if (f_inside[i + 1] == false)
       {
-        xt::xtensor_fixed<double, xt::xshape<3, 3>> M;
-        xt::row(M, 0) = xt::row(s, facets[i][0]);
-        xt::row(M, 1) = xt::row(s, facets[i][1]);
-        xt::row(M, 2) = xt::row(s, facets[i][2]);
-
-        const auto [snew, v] = nearest_simplex(M);
-        const double q = xt::norm_sq(v)();
+        std::array<std::array<double, 3>, 4> M
+            = {s[facets[i][0]], s[facets[i][1]], s[facets[i][2]]};
+        std::array<double, 3> vM;
+        const std::size_t M_size = nearest_simplex(M, 3, vM);
+        const double q = dot3(vM, vM);
         if (q < qmin)
         {
           qmin = q;
-          vmin = v;
-          smin = snew;
+          vmin = vM;
+          smin = M;
+          smin_size = M_size;
         }
       }
     }
 
-    return {std::move(smin), vmin};
+    s = smin;
+    v = vmin;
+    return smin_size;
   }
   }
 
-  assert(s.shape(0) == 3);
-  const auto a = xt::row(s, 0);
-  const auto b = xt::row(s, 1);
-  const auto c = xt::row(s, 2);
-  const double ab2 = xt::norm_sq(a - b)();
-  const double ac2 = xt::norm_sq(a - c)();
-  const double bc2 = xt::norm_sq(b - c)();
-  const xt::xtensor_fixed<double, xt::xshape<3>> lm
-      = {xt::sum(a * (a - b))() / ab2, xt::sum(a * (a - c))() / ac2,
-         xt::sum(b * (b - c))() / bc2};
+  assert(n == 3);
+  const std::array<double, 3> a = s[0];
+  const std::array<double, 3> b = s[1];
+  const std::array<double, 3> c = s[2];
+  const std::array<double, 3> ab = sub3(a, b);
+  const std::array<double, 3> ac = sub3(a, c);
+  const std::array<double, 3> bc = sub3(b, c);
+  const double ab2 = dot3(ab, ab);
+  const double ac2 = dot3(ac, ac);
+  const double bc2 = dot3(bc, bc);
+  const std::array<double, 3> lm
+      = {dot3(a, ab) / ab2, dot3(a, ac) / ac2, dot3(b, bc) / bc2};
 
   // Calculate triangle ABC
-  const double caba = xt::sum((c - a) * (b - a))();
+  const double caba = dot3(sub3(c, a), sub3(b, a));
   const double c2 = 1 - caba * caba / (ab2 * ac2);
   const double lbb = (lm[0] - lm[1] * caba / ab2) / c2;
   const double lcc = (lm[1] - lm[0] * caba / ac2) / c2;
@@ -125,58 +151,75 @@ nearest_simplex(const xt::xtensor<double, 2>& s)
   if (lbb >= 0.0 and lcc >= 0.0 and (lbb + lcc) <= 1.0)
   {
     // Calculate intersection more accurately
-    auto v = math::cross(c - a, b - a);
+    std::array<double, 3> n = cross3(sub3(c, a), sub3(b, a));
 
     // Barycentre of triangle
-    auto p = (a + b + c) / 3.0;
+    const std::array<double, 3> p
+        = {(a[0] + b[0] + c[0]) / 3.0, (a[1] + b[1] + c[1]) / 3.0,
+           (a[2] + b[2] + c[2]) / 3.0};
 
     // Renormalise n in plane of ABC
-    v *= xt::sum(v * p) / xt::norm_sq(v);
-    return {std::move(s), v};
+    const double r = dot3(n, p) / dot3(n, n);
+    for (int j = 0; j < 3; ++j)
+      n[j] *= r;
+    v = n;
+    return 3;
   }
 
   // Get closest point
-  std::size_t i = xt::argmin(xt::norm_sq(s, {1}))();
-  xt::xtensor_fixed<double, xt::xshape<3>> vmin = xt::row(s, i);
-  double qmin = xt::norm_sq(vmin)();
-
-  xt::xtensor<double, 2> smin({1, 3});
-  xt::row(smin, 0) = vmin;
+  std::size_t i_min = 0;
+  double qmin = dot3(s[0], s[0]);
+  for (std::size_t i = 1; i < 3; ++i)
+  {
+    if (const double q = dot3(s[i], s[i]); q < qmin)
+    {
+      qmin = q;
+      i_min = i;
+    }
+  }
+  std::array<double, 3> vmin = s[i_min];
+  std::array<std::array<double, 3>, 2> smin = {vmin, vmin};
+  std::size_t smin_size = 1;
 
   // Check if edges are closer
   constexpr const int f[3][2] = {{0, 1}, {0, 2}, {1, 2}};
-  for (std::size_t i = 0; i < s.shape(0); ++i)
+  for (std::size_t i = 0; i < 3; ++i)
   {
-    auto s0 = xt::row(s, f[i][0]);
-    auto s1 = xt::row(s, f[i][1]);
+    const std::array<double, 3>& s0 = s[f[i][0]];
+    const std::array<double, 3>& s1 = s[f[i][1]];
     if (lm[i] > 0 and lm[i] < 1)
     {
-      auto v = s0 + lm[i] * (s1 - s0);
-      const double qnorm = xt::norm_sq(v)();
+      std::array<double, 3> vl;
+      for (int j = 0; j < 3; ++j)
+        vl[j] = s0[j] + lm[i] * (s1[j] - s0[j]);
+      const double qnorm = dot3(vl, vl);
       if (qnorm < qmin)
       {
-        vmin = v;
+        vmin = vl;
         qmin = qnorm;
-        smin.resize({2, 3});
-        xt::row(smin, 0) = s0;
-        xt::row(smin, 1) = s1;
+        smin = {s0, s1};
+        smin_size = 2;
       }
     }
   }
 
-  return {std::move(smin), vmin};
+  s[0] = smin[0];
+  s[1] = smin[1];
+  v = vmin;
+  return smin_size;
 }
 //----------------------------------------------------------------------------
-// Support function, finds point p in bd which maximises p.v
-xt::xtensor_fixed<double, xt::xshape<3>>
-support(const xt::xtensor<double, 2>& bd,
-        const xt::xtensor_fixed<double, xt::xshape<3>>& v)
+// Support function, finds point p in bd which maximises p.v. The dot
+// products over the vertices are a flat loop over contiguous rows so
+// the compiler can vectorise them.
+std::array<double, 3> support(const xt::xtensor<double, 2>& bd,
+                              const std::array<double, 3>& v)
 {
-  int i = 0;
-  double qmax = xt::sum(xt::row(bd, 0) * v)();
+  std::size_t i = 0;
+  double qmax = bd(0, 0) * v[0] + bd(0, 1) * v[1] + bd(0, 2) * v[2];
   for (std::size_t m = 1; m < bd.shape(0); ++m)
   {
-    double q = xt::sum(xt::row(bd, m) * v)();
+    const double q = bd(m, 0) * v[0] + bd(m, 1) * v[1] + bd(m, 2) * v[2];
     if (q > qmax)
     {
       qmax = q;
@@ -184,63 +227,57 @@ support(const xt::xtensor<double, 2>& bd,
     }
   }
 
-  return xt::row(bd, i);
+  return {bd(i, 0), bd(i, 1), bd(i, 2)};
 }
-} // namespace
 //----------------------------------------------------------------------------
-xt::xtensor_fixed<double, xt::xshape<3>>
-geometry::compute_distance_gjk(const xt::xtensor<double, 2>& p,
-                               const xt::xtensor<double, 2>& q)
+// GJK iteration, starting from the point v_init of the Minkowski
+// difference of the two bodies
+std::array<double, 3> gjk_kernel(const xt::xtensor<double, 2>& p,
+                                 const xt::xtensor<double, 2>& q,
+                                 const std::array<double, 3>& v_init)
 {
-  assert(p.shape(1) == 3);
-  assert(q.shape(1) == 3);
-
   constexpr int maxk = 10; // Maximum number of iterations of the GJK algorithm
 
   // Tolerance
   constexpr double eps = 1e-12;
 
   // Initialise vector and simplex
-  xt::xtensor_fixed<double, xt::xshape<3>> v = xt::row(p, 0) - xt::row(q, 0);
-  xt::xtensor<double, 2> s({1, 3});
-  xt::row(s, 0) = v;
+  std::array<double, 3> v = v_init;
+  std::array<std::array<double, 3>, 4> s = {};
+  s[0] = v;
+  std::size_t s_size = 1;
 
   // Begin GJK iteration
   int k;
   for (k = 0; k < maxk; ++k)
   {
     // Support function
-    const xt::xtensor_fixed<double, xt::xshape<3>> w
-        = support(p, -v) - support(q, v);
+    const std::array<double, 3> w
+        = sub3(support(p, {-v[0], -v[1], -v[2]}), support(q, v));
 
     // Break if any existing points are the same as w
-    assert(s.shape(1) == 3);
     std::size_t m;
-    for (m = 0; m < s.shape(0); ++m)
+    for (m = 0; m < s_size; ++m)
     {
-      if (xt::row(s, m) == w)
+      if (s[m] == w)
         break;
     }
 
-    if (m != s.shape(0))
+    if (m != s_size)
       break;
 
     // 1st exit condition (v - w).v = 0
-    const double vnorm2 = xt::norm_sq(v)();
-    const double vw = vnorm2 - xt::sum(v * w)();
+    const double vnorm2 = dot3(v, v);
+    const double vw = vnorm2 - dot3(v, w);
     if (vw < (eps * vnorm2) or vw < eps)
       break;
 
-    // Add new vertex to simplex
-    s = xt::vstack(xt::xtuple(s, xt::reshape_view(w, {1, 3})));
-    assert(s.shape(1) == 3);
-
-    // Find nearest subset of simplex
-    std::tie(s, v) = nearest_simplex(s);
-    assert(s.shape(1) == 3);
+    // Add new vertex to simplex and find its nearest subset
+    s[s_size] = w;
+    s_size = nearest_simplex(s, s_size + 1, v);
 
     // 2nd exit condition - intersecting or touching
-    if (xt::norm_sq(v)() < eps * eps)
+    if (dot3(v, v) < eps * eps)
       break;
   }
 
@@ -250,3 +287,39 @@ geometry::compute_distance_gjk(const xt::xtensor<double, 2>& p,
   return v;
 }
 //----------------------------------------------------------------------------
+} // namespace
+//----------------------------------------------------------------------------
+xt::xtensor_fixed<double, xt::xshape<3>>
+geometry::compute_distance_gjk(const xt::xtensor<double, 2>& p,
+                               const xt::xtensor<double, 2>& q)
+{
+  assert(p.shape(1) == 3);
+  assert(q.shape(1) == 3);
+
+  const std::array<double, 3> v0
+      = {p(0, 0) - q(0, 0), p(0, 1) - q(0, 1), p(0, 2) - q(0, 2)};
+  const std::array<double, 3> v = gjk_kernel(p, q, v0);
+  return {v[0], v[1], v[2]};
+}
+//----------------------------------------------------------------------------
+xt::xtensor_fixed<double, xt::xshape<3>>
+geometry::compute_distance_gjk(const xt::xtensor<double, 2>& p,
+                               const xt::xtensor<double, 2>& q,
+                               const std::array<double, 3>& v0)
+{
+  assert(p.shape(1) == 3);
+  assert(q.shape(1) == 3);
+
+  // Seed the simplex with the support point along the warm-start
+  // direction; for a direction close to the solution the iteration
+  // then converges in very few steps. A zero direction carries no
+  // information, so fall back to the cold-start initialisation.
+  if (v0 == std::array<double, 3>{0, 0, 0})
+    return compute_distance_gjk(p, q);
+
+  const std::array<double, 3> w
+      = sub3(support(p, {-v0[0], -v0[1], -v0[2]}), support(q, v0));
+  const std::array<double, 3> v = gjk_kernel(p, q, w);
+  return {v[0], v[1], v[2]};
+}
+//----------------------------------------------------------------------------
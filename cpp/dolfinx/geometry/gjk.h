@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <array>
 #include <xtensor/xfixed.hpp>
 #include <xtensor/xtensor.hpp>
 
@@ -23,4 +24,24 @@ xt::xtensor_fixed<double, xt::xshape<3>>
 compute_distance_gjk(const xt::xtensor<double, 2>& p,
                      const xt::xtensor<double, 2>& q);
 
+/// Calculate the distance between two convex bodies p and q using the
+/// Gilbert–Johnson–Keerthi (GJK) distance algorithm, warm-started with
+/// a search direction.
+///
+/// For coherent query streams (e.g. contact search between bodies that
+/// move little between steps) the shortest vector returned by the
+/// previous query is a good starting direction and typically saves
+/// most of the GJK iterations.
+///
+/// @param[in] p Body 1 list of points, shape (num_points, 3)
+/// @param[in] q Body 2 list of points, shape (num_points, 3)
+/// @param[in] v0 Initial search direction, e.g. the result of the
+/// previous query for the same pair of bodies. If zero, the cold-start
+/// initialisation is used.
+/// @return shortest vector between bodies
+xt::xtensor_fixed<double, xt::xshape<3>>
+compute_distance_gjk(const xt::xtensor<double, 2>& p,
+                     const xt::xtensor<double, 2>& q,
+                     const std::array<double, 3>& v0);
+
 } // namespace dolfinx::geometry
@@ -8,10 +8,16 @@
 #include "utils.h"
 #include "BoundingBoxTree.h"
 #include "gjk.h"
+#include <dolfinx/common/MPI.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/utils.h>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <thread>
 #include <xtensor/xfixed.hpp>
 #include <xtensor/xnorm.hpp>
 
@@ -36,13 +42,42 @@ bool point_in_bbox(const xt::xtensor_fixed<double, xt::xshape<2, 3>>& b,
          and xt::all(x <= xt::row(b, 1) + eps);
 }
 //-----------------------------------------------------------------------------
-bool bbox_in_bbox(const xt::xtensor_fixed<double, xt::xshape<2, 3>>& a,
-                  const xt::xtensor_fixed<double, xt::xshape<2, 3>>& b)
+// Point-in-box test on the flat bounding box coordinates of a tree
+// node, b = [xmin, ymin, zmin, xmax, ymax, zmax]. Avoids building a
+// tensor per visited node on hot traversal paths.
+bool point_in_bbox(const double* b, const double* x)
 {
   constexpr double rtol = 1e-14;
-  auto eps = rtol * (xt::row(b, 1) - xt::row(b, 0));
-  return xt::all(xt::row(b, 0) - eps <= xt::row(a, 1))
-         and xt::all(xt::row(b, 1) + eps >= xt::row(a, 0));
+  bool in = true;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double eps = rtol * (b[i + 3] - b[i]);
+    in = in and x[i] >= b[i] - eps and x[i] <= b[i + 3] + eps;
+  }
+  return in;
+}
+//-----------------------------------------------------------------------------
+// Overlap tests of a packet of candidate box pairs on the flat
+// bounding box coordinates of the trees, b = [xmin, ymin, zmin, xmax,
+// ymax, zmax]. Testing a packet per call keeps the loop trip counts
+// fixed so the comparisons vectorise.
+template <int N>
+void overlap_packet(const std::array<const double*, N>& a,
+                    const std::array<const double*, N>& b,
+                    std::array<bool, N>& hit)
+{
+  constexpr double rtol = 1e-14;
+  for (int p = 0; p < N; ++p)
+  {
+    bool in = true;
+    for (int i = 0; i < 3; ++i)
+    {
+      const double eps = rtol * (b[p][i + 3] - b[p][i]);
+      in = in and b[p][i] - eps <= a[p][i + 3]
+           and b[p][i + 3] + eps >= a[p][i];
+    }
+    hit[p] = in;
+  }
 }
 //-----------------------------------------------------------------------------
 // Compute closest entity {closest_entity, R2} (recursive)
@@ -106,90 +141,144 @@ _compute_closest_entity(const geometry::BoundingBoxTree& tree,
   }
 }
 //-----------------------------------------------------------------------------
-// Compute collisions with point (recursive)
-void _compute_collisions_point(
-    const geometry::BoundingBoxTree& tree,
-    const xt::xtensor_fixed<double, xt::xshape<3>>& p, int node,
-    std::vector<int>& entities)
+// Compute collisions between a block of points [begin, end) and a tree.
+// Entities colliding with point p are appended to `entities` in point
+// order and the number of collisions for each point is written to
+// `counts[p]`. The traversal is iterative over the flat node and
+// coordinate arrays of the tree, visiting children in the same order as
+// the recursive formulation (child_0 before child_1).
+void _compute_collisions_points(const geometry::BoundingBoxTree& tree,
+                                const xt::xtensor<double, 2>& points,
+                                std::size_t begin, std::size_t end,
+                                std::vector<std::int32_t>& entities,
+                                const xtl::span<std::int32_t>& counts)
 {
-  // Get children of current bounding box node
-  const std::array bbox = tree.bbox(node);
-
-  if (!point_in_bbox(tree.get_bbox(node), p))
-  {
-    // If point is not in bounding box, then don't search further
-    return;
-  }
-  else if (is_leaf(bbox))
+  const xtl::span<const double> coords = tree.bbox_coordinates();
+  const std::int32_t num_nodes = tree.num_bboxes();
+  std::vector<std::int32_t> stack;
+  stack.reserve(64);
+  for (std::size_t p = begin; p < end; ++p)
   {
-    // If box is a leaf (which we know contains the point), then add it
-
-    // child_1 denotes entity for leaves
-    const int entity_index = bbox[1];
+    const std::array<double, 3> x = {points(p, 0), points(p, 1), points(p, 2)};
+    const std::size_t size0 = entities.size();
+    if (num_nodes > 0)
+      stack.push_back(num_nodes - 1);
+    while (!stack.empty())
+    {
+      const std::int32_t node = stack.back();
+      stack.pop_back();
+      if (!point_in_bbox(coords.data() + 6 * node, x.data()))
+      {
+        // If point is not in bounding box, then don't search further
+        continue;
+      }
 
-    // Add the candidate
-    entities.push_back(entity_index);
-  }
-  else
-  {
-    // Check both children
-    _compute_collisions_point(tree, p, bbox[0], entities);
-    _compute_collisions_point(tree, p, bbox[1], entities);
+      const std::array bbox = tree.bbox(node);
+      if (is_leaf(bbox))
+      {
+        // If box is a leaf (which we know contains the point), then add
+        // it. child_1 denotes entity for leaves.
+        entities.push_back(bbox[1]);
+      }
+      else
+      {
+        // Push both children (child_0 on top so it is visited first)
+        stack.push_back(bbox[1]);
+        stack.push_back(bbox[0]);
+      }
+    }
+    counts[p] = entities.size() - size0;
   }
 }
 //-----------------------------------------------------------------------------
-// Compute collisions with tree (recursive)
-void _compute_collisions_tree(const geometry::BoundingBoxTree& A,
-                              const geometry::BoundingBoxTree& B, int node_A,
-                              int node_B,
-                              std::vector<std::array<int, 2>>& entities)
+// Expand an overlapping node pair (node_a, node_b), of which at least
+// one is an internal node, into its overlapping child pairs, appended
+// to `out`. The candidate children are tested in one packet.
+void expand_pair(const geometry::BoundingBoxTree& A,
+                 const geometry::BoundingBoxTree& B, int node_a, int node_b,
+                 std::vector<std::array<int, 2>>& out)
 {
-  // If bounding boxes don't collide, then don't search further
-  if (!bbox_in_bbox(A.get_bbox(node_A), B.get_bbox(node_B)))
-    return;
-
-  // Get bounding boxes for current nodes
-  const std::array bbox_A = A.bbox(node_A);
-  const std::array bbox_B = B.bbox(node_B);
-
-  // Check whether we've reached a leaf in A or B
-  const bool is_leaf_A = is_leaf(bbox_A);
-  const bool is_leaf_B = is_leaf(bbox_B);
-  if (is_leaf_A and is_leaf_B)
+  const double* ca = A.bbox_coordinates().data();
+  const double* cb = B.bbox_coordinates().data();
+  const std::array bbox_a = A.bbox(node_a);
+  const std::array bbox_b = B.bbox(node_b);
+  const bool leaf_a = is_leaf(bbox_a);
+  const bool leaf_b = is_leaf(bbox_b);
+  assert(!(leaf_a and leaf_b));
+  if (leaf_a)
   {
-    // If both boxes are leaves (which we know collide), then add them
-    // child_1 denotes entity for leaves
-    entities.push_back({bbox_A[1], bbox_B[1]});
+    // Reached the leaf in A, descend B
+    std::array<bool, 2> hit;
+    overlap_packet<2>({ca + 6 * node_a, ca + 6 * node_a},
+                      {cb + 6 * bbox_b[0], cb + 6 * bbox_b[1]}, hit);
+    if (hit[1])
+      out.push_back({node_a, bbox_b[1]});
+    if (hit[0])
+      out.push_back({node_a, bbox_b[0]});
   }
-  else if (is_leaf_A)
+  else if (leaf_b)
   {
-    // If we reached the leaf in A, then descend B
-    _compute_collisions_tree(A, B, node_A, bbox_B[0], entities);
-    _compute_collisions_tree(A, B, node_A, bbox_B[1], entities);
+    // Reached the leaf in B, descend A
+    std::array<bool, 2> hit;
+    overlap_packet<2>({ca + 6 * bbox_a[0], ca + 6 * bbox_a[1]},
+                      {cb + 6 * node_b, cb + 6 * node_b}, hit);
+    if (hit[1])
+      out.push_back({bbox_a[1], node_b});
+    if (hit[0])
+      out.push_back({bbox_a[0], node_b});
   }
-  else if (is_leaf_B)
-  {
-    // If we reached the leaf in B, then descend A
-    _compute_collisions_tree(A, B, bbox_A[0], node_B, entities);
-    _compute_collisions_tree(A, B, bbox_A[1], node_B, entities);
-  }
-  else if (node_A > node_B)
+  else
   {
-    // At this point, we know neither is a leaf so descend the largest
-    // tree first. Note that nodes are added in reverse order with the
-    // top bounding box at the end so the largest tree (the one with the
-    // the most boxes left to traverse) has the largest node number.
-    _compute_collisions_tree(A, B, bbox_A[0], node_B, entities);
-    _compute_collisions_tree(A, B, bbox_A[1], node_B, entities);
+    // Neither is a leaf: test all four child pairs in one packet
+    std::array<bool, 4> hit;
+    overlap_packet<4>({ca + 6 * bbox_a[0], ca + 6 * bbox_a[0],
+                       ca + 6 * bbox_a[1], ca + 6 * bbox_a[1]},
+                      {cb + 6 * bbox_b[0], cb + 6 * bbox_b[1],
+                       cb + 6 * bbox_b[0], cb + 6 * bbox_b[1]},
+                      hit);
+    if (hit[3])
+      out.push_back({bbox_a[1], bbox_b[1]});
+    if (hit[2])
+      out.push_back({bbox_a[1], bbox_b[0]});
+    if (hit[1])
+      out.push_back({bbox_a[0], bbox_b[1]});
+    if (hit[0])
+      out.push_back({bbox_a[0], bbox_b[0]});
   }
-  else
+}
+//-----------------------------------------------------------------------------
+// Iterative tree-tree traversal from an overlapping seed pair, with an
+// explicit stack reused across calls. Returns the number of colliding
+// leaf pairs; when `entities` is non-null the pairs are also written
+// there (count pass with nullptr, then fill pass into the exact slot).
+std::int32_t _compute_collisions_tree(const geometry::BoundingBoxTree& A,
+                                      const geometry::BoundingBoxTree& B,
+                                      const std::array<int, 2>& seed,
+                                      std::vector<std::array<int, 2>>& stack,
+                                      std::array<int, 2>* entities)
+{
+  std::int32_t n = 0;
+  stack.clear();
+  stack.push_back(seed);
+  while (!stack.empty())
   {
-    _compute_collisions_tree(A, B, node_A, bbox_B[0], entities);
-    _compute_collisions_tree(A, B, node_A, bbox_B[1], entities);
+    const std::array<int, 2> pair = stack.back();
+    stack.pop_back();
+    const std::array bbox_a = A.bbox(pair[0]);
+    const std::array bbox_b = B.bbox(pair[1]);
+    if (is_leaf(bbox_a) and is_leaf(bbox_b))
+    {
+      // Both boxes are leaves (which we know collide). child_1 denotes
+      // the entity for leaves.
+      if (entities)
+        entities[n] = {bbox_a[1], bbox_b[1]};
+      ++n;
+    }
+    else
+      expand_pair(A, B, pair[0], pair[1], stack);
   }
 
-  // Note that cases above can be collected in fewer cases but this way
-  // the logic is easier to follow.
+  return n;
 }
 //-----------------------------------------------------------------------------
 
@@ -217,18 +306,122 @@ geometry::create_midpoint_tree(const mesh::Mesh& mesh, int tdim,
   return geometry::BoundingBoxTree(points);
 }
 //-----------------------------------------------------------------------------
+geometry::BoundingBoxTree
+geometry::create_midpoint_tree(const BoundingBoxTree& tree)
+{
+  LOG(INFO) << "Building point search tree from the leaf boxes of an "
+               "existing bounding box tree.";
+
+  // Collect the centre of each leaf box, with the entity stored in the
+  // leaf. Symmetric padding does not move the centre.
+  const xtl::span<const double> coords = tree.bbox_coordinates();
+  std::vector<std::pair<std::array<double, 3>, std::int32_t>> points;
+  for (std::int32_t node = 0; node < tree.num_bboxes(); ++node)
+  {
+    const std::array bbox = tree.bbox(node);
+    if (bbox[0] != bbox[1])
+      continue;
+    const double* b = coords.data() + 6 * node;
+    points.push_back(
+        {{0.5 * (b[0] + b[3]), 0.5 * (b[1] + b[4]), 0.5 * (b[2] + b[5])},
+         bbox[1]});
+  }
+
+  // Build tree
+  return geometry::BoundingBoxTree(points);
+}
+//-----------------------------------------------------------------------------
 std::vector<std::array<int, 2>>
 geometry::compute_collisions(const BoundingBoxTree& tree0,
                              const BoundingBoxTree& tree1)
 {
-  // Call recursive find function
-  std::vector<std::array<int, 2>> entities;
-  if (tree0.num_bboxes() > 0 and tree1.num_bboxes() > 0)
+  if (tree0.num_bboxes() == 0 or tree1.num_bboxes() == 0)
+    return {};
+
+  const std::array<int, 2> root
+      = {tree0.num_bboxes() - 1, tree1.num_bboxes() - 1};
+  std::array<bool, 1> root_hit;
+  overlap_packet<1>({tree0.bbox_coordinates().data() + 6 * root[0]},
+                    {tree1.bbox_coordinates().data() + 6 * root[1]}, root_hit);
+  if (!root_hit[0])
+    return {};
+
+  // Expand the root pair breadth-first into independent subtree pairs
+  // that the threads traverse
+  const std::size_t num_threads = common::num_threads();
+  std::vector<std::array<int, 2>> seeds = {root};
+  if (num_threads > 1)
   {
-    _compute_collisions_tree(tree0, tree1, tree0.num_bboxes() - 1,
-                             tree1.num_bboxes() - 1, entities);
+    const std::size_t target = 4 * num_threads;
+    while (seeds.size() < target)
+    {
+      std::vector<std::array<int, 2>> next;
+      next.reserve(2 * seeds.size());
+      bool expanded = false;
+      for (const std::array<int, 2>& pair : seeds)
+      {
+        if (is_leaf(tree0.bbox(pair[0])) and is_leaf(tree1.bbox(pair[1])))
+          next.push_back(pair);
+        else
+        {
+          expand_pair(tree0, tree1, pair[0], pair[1], next);
+          expanded = true;
+        }
+      }
+      seeds.swap(next);
+      if (!expanded or seeds.empty())
+        break;
+    }
   }
 
+  // Traverse the subtree pairs twice: a count pass sizing the output,
+  // then a fill pass writing each subtree's collisions into its exact
+  // slot. The traversal stacks are preallocated and reused between the
+  // passes.
+  std::vector<std::int32_t> counts(seeds.size(), 0);
+  std::vector<std::int64_t> offsets(seeds.size() + 1, 0);
+  std::vector<std::array<int, 2>> entities;
+  auto run_pass
+      = [&tree0, &tree1, &seeds, &counts, &offsets, &entities](
+            std::size_t begin, std::size_t end, bool fill)
+  {
+    std::vector<std::array<int, 2>> stack;
+    stack.reserve(1024);
+    for (std::size_t s = begin; s < end; ++s)
+    {
+      std::array<int, 2>* out = fill ? entities.data() + offsets[s] : nullptr;
+      counts[s] = _compute_collisions_tree(tree0, tree1, seeds[s], stack, out);
+    }
+  };
+
+  auto parallel_over_seeds = [&seeds, num_threads](const auto& fn)
+  {
+    if (num_threads <= 1)
+    {
+      fn(std::size_t(0), seeds.size());
+      return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    for (std::size_t t = 0; t < num_threads; ++t)
+    {
+      const std::size_t begin = (seeds.size() * t) / num_threads;
+      const std::size_t end = (seeds.size() * (t + 1)) / num_threads;
+      if (begin != end)
+        workers.emplace_back(fn, begin, end);
+    }
+    for (std::thread& w : workers)
+      w.join();
+  };
+
+  parallel_over_seeds([&run_pass](std::size_t begin, std::size_t end)
+                      { run_pass(begin, end, false); });
+  std::partial_sum(counts.begin(), counts.end(), std::next(offsets.begin()));
+  entities.resize(offsets.back());
+  parallel_over_seeds([&run_pass](std::size_t begin, std::size_t end)
+                      { run_pass(begin, end, true); });
+
   return entities;
 }
 //-----------------------------------------------------------------------------
@@ -236,25 +429,61 @@ graph::AdjacencyList<std::int32_t>
 geometry::compute_collisions(const BoundingBoxTree& tree,
                              const xt::xtensor<double, 2>& points)
 {
-  if (tree.num_bboxes() > 0)
+  const std::size_t num_points = points.shape(0);
+  if (tree.num_bboxes() == 0)
   {
-    std::vector<std::int32_t> entities, offsets({0});
-    for (std::size_t p = 0; p < points.shape(0); ++p)
-    {
-      _compute_collisions_point(tree, xt::row(points, p), tree.num_bboxes() - 1,
-                                entities);
-      offsets.push_back(entities.size());
-    }
+    return graph::AdjacencyList<std::int32_t>(
+        std::vector<std::int32_t>(),
+        std::vector<std::int32_t>(num_points + 1, 0));
+  }
+
+  std::vector<std::int32_t> counts(num_points, 0);
+  std::vector<std::int32_t> offsets(num_points + 1, 0);
 
+  const std::size_t num_threads = common::num_threads();
+  if (num_threads <= 1 or num_points == 0)
+  {
+    std::vector<std::int32_t> entities;
+    _compute_collisions_points(tree, points, 0, num_points, entities, counts);
+    std::partial_sum(counts.begin(), counts.end(), std::next(offsets.begin()));
     return graph::AdjacencyList<std::int32_t>(std::move(entities),
                                               std::move(offsets));
   }
-  else
+
+  // Thread over blocks of points, each thread collecting its entities
+  // in a private buffer
+  std::vector<std::size_t> bounds(num_threads + 1);
+  for (std::size_t t = 0; t <= num_threads; ++t)
+    bounds[t] = (num_points * t) / num_threads;
+  std::vector<std::vector<std::int32_t>> entities_t(num_threads);
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads);
+  for (std::size_t t = 0; t < num_threads; ++t)
   {
-    return graph::AdjacencyList<std::int32_t>(
-        std::vector<std::int32_t>(),
-        std::vector<std::int32_t>(points.shape(0) + 1, 0));
+    if (bounds[t] == bounds[t + 1])
+      continue;
+    workers.emplace_back(
+        [&tree, &points, &counts](std::size_t begin, std::size_t end,
+                                  std::vector<std::int32_t>& entities) {
+          _compute_collisions_points(tree, points, begin, end, entities,
+                                     counts);
+        },
+        bounds[t], bounds[t + 1], std::ref(entities_t[t]));
+  }
+  for (std::thread& w : workers)
+    w.join();
+
+  // Stitch the per-thread buffers back together in point order
+  std::partial_sum(counts.begin(), counts.end(), std::next(offsets.begin()));
+  std::vector<std::int32_t> entities(offsets.back());
+  for (std::size_t t = 0; t < num_threads; ++t)
+  {
+    std::copy(entities_t[t].begin(), entities_t[t].end(),
+              std::next(entities.begin(), offsets[bounds[t]]));
   }
+
+  return graph::AdjacencyList<std::int32_t>(std::move(entities),
+                                            std::move(offsets));
 }
 //-----------------------------------------------------------------------------
 std::vector<std::int32_t> geometry::compute_closest_entity(
@@ -304,6 +533,216 @@ std::vector<std::int32_t> geometry::compute_closest_entity(
   }
 }
 
+//-----------------------------------------------------------------------------
+std::vector<std::array<std::int32_t, 2>>
+geometry::compute_closest_entity_global(MPI_Comm comm,
+                                        const BoundingBoxTree& tree,
+                                        const BoundingBoxTree& midpoint_tree,
+                                        const mesh::Mesh& mesh,
+                                        const xt::xtensor<double, 2>& points)
+{
+  assert(points.shape(1) == 3);
+  const std::size_t num_points = points.shape(0);
+  const int mpi_rank = dolfinx::MPI::rank(comm);
+  const int mpi_size = dolfinx::MPI::size(comm);
+  constexpr double inf = std::numeric_limits<double>::max();
+
+  // Exchange the tree root bounding boxes. The seventh entry flags
+  // ranks with a non-empty tree.
+  std::array<double, 7> send_bbox = {0, 0, 0, 0, 0, 0, 0};
+  if (tree.num_bboxes() > 0)
+  {
+    const auto box = tree.get_bbox(tree.num_bboxes() - 1);
+    std::copy_n(box.begin(), 6, send_bbox.begin());
+    send_bbox[6] = 1;
+  }
+  std::vector<double> recv_bbox(7 * mpi_size);
+  MPI_Allgather(send_bbox.data(), 7, MPI_DOUBLE, recv_bbox.data(), 7,
+                MPI_DOUBLE, comm);
+
+  // Cheap per-point upper bound on the local closest-entity distance:
+  // the distance to the nearest entity midpoint (a point inside the
+  // entity). This bounds the candidate ranks without running the local
+  // GJK pass first, so the point exchange can overlap it below.
+  std::vector<double> R2_up(num_points, inf);
+  if (midpoint_tree.num_bboxes() > 0)
+  {
+    for (std::size_t i = 0; i < num_points; ++i)
+    {
+      xt::xtensor_fixed<double, xt::xshape<3>> diff
+          = xt::row(midpoint_tree.get_bbox(0), 0);
+      diff -= xt::row(points, i);
+      const auto [m_index, m_distance2] = _compute_closest_entity(
+          midpoint_tree, xt::reshape_view(xt::row(points, i), {1, 3}),
+          midpoint_tree.num_bboxes() - 1, mesh, 0, xt::norm_sq(diff)());
+      R2_up[i] = m_distance2;
+    }
+  }
+
+  // Batch the points by candidate rank: ranks whose root box lies
+  // within the upper bound can hold a closer entity
+  std::vector<std::vector<std::int32_t>> send_index(mpi_size);
+  for (int r = 0; r < mpi_size; ++r)
+  {
+    if (r == mpi_rank or recv_bbox[7 * r + 6] == 0)
+      continue;
+    xt::xtensor_fixed<double, xt::xshape<2, 3>> box_r;
+    std::copy_n(std::next(recv_bbox.begin(), 7 * r), 6, box_r.begin());
+    for (std::size_t i = 0; i < num_points; ++i)
+    {
+      const xt::xtensor_fixed<double, xt::xshape<3>> x
+          = {points(i, 0), points(i, 1), points(i, 2)};
+      if (compute_squared_distance_bbox(box_r, x) < R2_up[i])
+        send_index[r].push_back(i);
+    }
+  }
+
+  // Build a symmetric neighborhood from the destination ranks and the
+  // ranks that send to us
+  std::set<int> dests;
+  for (int r = 0; r < mpi_size; ++r)
+  {
+    if (!send_index[r].empty())
+      dests.insert(r);
+  }
+  const std::vector<int> sources
+      = dolfinx::MPI::compute_graph_edges_nbx(comm, dests);
+  std::vector<int> neighbors(dests.begin(), dests.end());
+  neighbors.insert(neighbors.end(), sources.begin(), sources.end());
+  std::sort(neighbors.begin(), neighbors.end());
+  neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                  neighbors.end());
+  const int num_neighbors = neighbors.size();
+  MPI_Comm neighbor_comm;
+  MPI_Dist_graph_create_adjacent(comm, neighbors.size(), neighbors.data(),
+                                 MPI_UNWEIGHTED, neighbors.size(),
+                                 neighbors.data(), MPI_UNWEIGHTED,
+                                 MPI_INFO_NULL, false, &neighbor_comm);
+
+  // Exchange the number of point values sent to each neighbor
+  std::vector<int> send_counts(num_neighbors, 0);
+  for (int n = 0; n < num_neighbors; ++n)
+    send_counts[n] = 3 * send_index[neighbors[n]].size();
+  std::vector<int> recv_counts(num_neighbors, 0);
+  MPI_Neighbor_alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1,
+                        MPI_INT, neighbor_comm);
+  std::vector<int> send_disp(num_neighbors + 1, 0);
+  std::partial_sum(send_counts.begin(), send_counts.end(),
+                   std::next(send_disp.begin()));
+  std::vector<int> recv_disp(num_neighbors + 1, 0);
+  std::partial_sum(recv_counts.begin(), recv_counts.end(),
+                   std::next(recv_disp.begin()));
+
+  // Start the (non-blocking) point exchange
+  std::vector<double> send_x(send_disp.back());
+  for (int n = 0; n < num_neighbors; ++n)
+  {
+    double* x = send_x.data() + send_disp[n];
+    for (std::int32_t i : send_index[neighbors[n]])
+    {
+      for (std::size_t j = 0; j < 3; ++j)
+        *x++ = points(i, j);
+    }
+  }
+  std::vector<double> recv_x(recv_disp.back());
+  MPI_Request request;
+  MPI_Ineighbor_alltoallv(send_x.data(), send_counts.data(), send_disp.data(),
+                          MPI_DOUBLE, recv_x.data(), recv_counts.data(),
+                          recv_disp.data(), MPI_DOUBLE, neighbor_comm,
+                          &request);
+
+  // Local closest-entity (GJK) pass for the points of this rank while
+  // the point exchange is in flight
+  const int tdim = mesh.topology().dim();
+  const std::vector<std::int32_t> local_entity
+      = compute_closest_entity(tree, midpoint_tree, mesh, points);
+  std::vector<double> best_R2(num_points, inf);
+  if (tree.num_bboxes() > 0)
+  {
+    const xt::xtensor<double, 1> d2
+        = squared_distance(mesh, tdim, local_entity, points);
+    std::copy(d2.begin(), d2.end(), best_R2.begin());
+  }
+
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+  // Answer the incoming points
+  const std::size_t num_incoming = recv_x.size() / 3;
+  xt::xtensor<double, 2> x_in({num_incoming, 3});
+  std::copy(recv_x.begin(), recv_x.end(), x_in.begin());
+  const std::vector<std::int32_t> entity_in
+      = compute_closest_entity(tree, midpoint_tree, mesh, x_in);
+  std::vector<double> send_reply(2 * num_incoming, inf);
+  if (tree.num_bboxes() > 0)
+  {
+    const xt::xtensor<double, 1> d2
+        = squared_distance(mesh, tdim, entity_in, x_in);
+    for (std::size_t i = 0; i < num_incoming; ++i)
+    {
+      send_reply[2 * i] = entity_in[i];
+      send_reply[2 * i + 1] = d2[i];
+    }
+  }
+  else
+  {
+    for (std::size_t i = 0; i < num_incoming; ++i)
+      send_reply[2 * i] = -1;
+  }
+
+  // Start the (non-blocking) reply exchange: two values per received
+  // point, back along the reversed edges
+  std::vector<int> reply_send_counts(num_neighbors),
+      reply_recv_counts(num_neighbors);
+  std::vector<int> reply_send_disp(num_neighbors + 1, 0),
+      reply_recv_disp(num_neighbors + 1, 0);
+  for (int n = 0; n < num_neighbors; ++n)
+  {
+    reply_send_counts[n] = 2 * (recv_counts[n] / 3);
+    reply_recv_counts[n] = 2 * (send_counts[n] / 3);
+    reply_send_disp[n + 1] = reply_send_disp[n] + reply_send_counts[n];
+    reply_recv_disp[n + 1] = reply_recv_disp[n] + reply_recv_counts[n];
+  }
+  std::vector<double> recv_reply(reply_recv_disp.back());
+  MPI_Ineighbor_alltoallv(send_reply.data(), reply_send_counts.data(),
+                          reply_send_disp.data(), MPI_DOUBLE,
+                          recv_reply.data(), reply_recv_counts.data(),
+                          reply_recv_disp.data(), MPI_DOUBLE, neighbor_comm,
+                          &request);
+
+  // Initialise the result from the local pass while the replies are in
+  // flight
+  std::vector<std::array<std::int32_t, 2>> closest(num_points, {-1, -1});
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    if (local_entity[i] >= 0)
+      closest[i] = {mpi_rank, local_entity[i]};
+  }
+
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+  MPI_Comm_free(&neighbor_comm);
+
+  // Keep the closest entity over all replies. Ties are broken towards
+  // the lowest rank so the result is independent of the reply order.
+  for (int n = 0; n < num_neighbors; ++n)
+  {
+    const double* reply = recv_reply.data() + reply_recv_disp[n];
+    for (std::int32_t i : send_index[neighbors[n]])
+    {
+      const auto e = static_cast<std::int32_t>(*reply++);
+      const double d2 = *reply++;
+      if (e >= 0
+          and (d2 < best_R2[i]
+               or (d2 == best_R2[i]
+                   and (closest[i][0] == -1 or neighbors[n] < closest[i][0]))))
+      {
+        best_R2[i] = d2;
+        closest[i] = {neighbors[n], e};
+      }
+    }
+  }
+
+  return closest;
+}
 //-----------------------------------------------------------------------------
 double geometry::compute_squared_distance_bbox(
     const xt::xtensor_fixed<double, xt::xshape<2, 3>>& b,
@@ -397,25 +836,105 @@ graph::AdjacencyList<std::int32_t> geometry::compute_colliding_cells(
     const graph::AdjacencyList<std::int32_t>& candidate_cells,
     const xt::xtensor<double, 2>& points)
 {
-  std::vector<std::int32_t> offsets = {0};
-  offsets.reserve(candidate_cells.num_nodes() + 1);
-  std::vector<std::int32_t> colliding_cells;
   constexpr double eps2 = 1e-20;
-  const int tdim = mesh.topology().dim();
-  std::vector<std::int32_t> result;
-  for (std::int32_t i = 0; i < candidate_cells.num_nodes(); i++)
+  const mesh::Geometry& geometry = mesh.geometry();
+  const xt::xtensor<double, 2>& geom_dofs = geometry.x();
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+
+  const std::int32_t num_points = candidate_cells.num_nodes();
+  const std::vector<std::int32_t>& cells = candidate_cells.array();
+  const std::vector<std::int32_t>& cand_offsets = candidate_cells.offsets();
+
+  // Group the (point, candidate cell) pairs by cell so that the cell
+  // geometry is gathered once for all points tested against the cell
+  std::vector<std::int32_t> pair_point(cells.size());
+  for (std::int32_t i = 0; i < num_points; ++i)
   {
-    auto cells = candidate_cells.links(i);
-    xt::xtensor<double, 2> _point({cells.size(), 3});
-    for (std::size_t j = 0; j < cells.size(); j++)
-      xt::row(_point, j) = xt::row(points, i);
+    for (std::int32_t k = cand_offsets[i]; k < cand_offsets[i + 1]; ++k)
+      pair_point[k] = i;
+  }
+  std::vector<std::int32_t> order(cells.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&cells](std::int32_t k0, std::int32_t k1)
+            { return cells[k0] < cells[k1]; });
+
+  // Group boundaries: positions in `order` where the cell changes
+  std::vector<std::int32_t> group_offsets = {0};
+  for (std::size_t k = 1; k < order.size(); ++k)
+  {
+    if (cells[order[k]] != cells[order[k - 1]])
+      group_offsets.push_back(k);
+  }
+  if (!order.empty())
+    group_offsets.push_back(order.size());
+  const std::size_t num_groups = group_offsets.size() - 1;
+
+  // Run the exact (GJK) test for each group, one thread per block of
+  // groups. Each pair's verdict is recorded at its original position,
+  // so the writes of different groups do not overlap.
+  std::vector<std::uint8_t> collides(cells.size(), 0);
+  auto run_groups
+      = [&cells, &order, &group_offsets, &pair_point, &points, &geom_dofs,
+         &x_dofmap, &collides](std::size_t begin, std::size_t end)
+  {
+    xt::xtensor<double, 2> point({1, 3});
+    for (std::size_t g = begin; g < end; ++g)
+    {
+      const std::int32_t cell = cells[order[group_offsets[g]]];
+      auto dofs = x_dofmap.links(cell);
+      xt::xtensor<double, 2> nodes({dofs.size(), 3});
+      for (std::size_t i = 0; i < dofs.size(); ++i)
+        for (std::size_t j = 0; j < 3; ++j)
+          nodes(i, j) = geom_dofs(dofs[i], j);
 
-    xt::xtensor<double, 1> distances_sq
-        = geometry::squared_distance(mesh, tdim, cells, _point);
-    for (std::size_t j = 0; j < cells.size(); j++)
-      if (distances_sq[j] < eps2)
-        colliding_cells.push_back(cells[j]);
+      // The points tested against one cell form a coherent query
+      // stream; warm-start each query with the previous shortest
+      // vector
+      std::array<double, 3> v = {0, 0, 0};
+      for (std::int32_t k = group_offsets[g]; k < group_offsets[g + 1]; ++k)
+      {
+        const std::int32_t p = pair_point[order[k]];
+        for (std::size_t j = 0; j < 3; ++j)
+          point(0, j) = points(p, j);
+        const xt::xtensor_fixed<double, xt::xshape<3>> d
+            = compute_distance_gjk(point, nodes, v);
+        v = {d[0], d[1], d[2]};
+        if (d[0] * d[0] + d[1] * d[1] + d[2] * d[2] < eps2)
+          collides[order[k]] = 1;
+      }
+    }
+  };
 
+  const std::size_t num_threads = common::num_threads();
+  if (num_threads <= 1 or num_groups <= 1)
+    run_groups(0, num_groups);
+  else
+  {
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    for (std::size_t t = 0; t < num_threads; ++t)
+    {
+      const std::size_t begin = (num_groups * t) / num_threads;
+      const std::size_t end = (num_groups * (t + 1)) / num_threads;
+      if (begin != end)
+        workers.emplace_back(run_groups, begin, end);
+    }
+    for (std::thread& w : workers)
+      w.join();
+  }
+
+  // Collect the colliding cells in the original point order
+  std::vector<std::int32_t> offsets = {0};
+  offsets.reserve(num_points + 1);
+  std::vector<std::int32_t> colliding_cells;
+  for (std::int32_t i = 0; i < num_points; ++i)
+  {
+    for (std::int32_t k = cand_offsets[i]; k < cand_offsets[i + 1]; ++k)
+    {
+      if (collides[k])
+        colliding_cells.push_back(cells[k]);
+    }
     offsets.push_back(colliding_cells.size());
   }
 
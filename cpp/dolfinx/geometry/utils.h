@@ -8,6 +8,7 @@
 
 #include <array>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <mpi.h>
 #include <vector>
 #include <xtensor/xfixed.hpp>
 #include <xtensor/xshape.hpp>
@@ -33,6 +34,18 @@ BoundingBoxTree
 create_midpoint_tree(const mesh::Mesh& mesh, int tdim,
                      const xtl::span<const std::int32_t>& entity_indices);
 
+/// Create a midpoint tree directly from the leaf boxes of an existing
+/// bounding box tree, avoiding a second pass over the mesh geometry
+/// when the caller has just built the full tree over the same
+/// entities. The midpoint of each entity is taken as the centre of its
+/// leaf box (the padding cancels), which for the purpose of
+/// accelerating compute_closest_entity is as good a proxy as the
+/// vertex average used by the mesh-based overload.
+/// @param[in] tree A bounding box tree built from mesh entities
+/// @return Bounding box tree for the centres of the leaf boxes of
+/// @p tree
+BoundingBoxTree create_midpoint_tree(const BoundingBoxTree& tree);
+
 /// Compute all collisions between two BoundingBoxTrees (local to
 /// process)
 /// @param[in] tree0 First BoundingBoxTree
@@ -43,6 +56,8 @@ compute_collisions(const BoundingBoxTree& tree0, const BoundingBoxTree& tree1);
 
 /// Compute all collisions between bounding boxes and for a set of
 /// points
+/// @note Blocks of points are processed in parallel when
+/// `DOLFINX_NUM_THREADS` is set
 /// @param[in] tree The bounding box tree
 /// @param[in] points The points (shape=(num_points, 3))
 /// @return An adjacency list where the ith node corresponds to the
@@ -64,6 +79,30 @@ std::vector<std::int32_t> compute_closest_entity(
     const BoundingBoxTree& tree, const BoundingBoxTree& midpoint_tree,
     const mesh::Mesh& mesh, const xt::xtensor<double, 2>& points);
 
+/// Compute the closest mesh entity to a set of points across all ranks
+/// (collective on comm)
+///
+/// Each rank supplies its own points and the trees over its local mesh
+/// entities. The local search is first bounded by the cheap
+/// nearest-midpoint distance, each point is then batched to the ranks
+/// whose tree root boxes lie within that bound, and the point and
+/// reply exchanges use non-blocking neighborhood collectives. The
+/// (expensive) local GJK pass runs while the point exchange is in
+/// flight, overlapping communication and geometry work.
+/// @param[in] comm The MPI communicator
+/// @param[in] tree The bounding box tree for the local entities
+/// @param[in] midpoint_tree A bounding box tree with the midpoints of
+/// all the local mesh entities. This is used to accelerate the search.
+/// @param[in] mesh The mesh
+/// @param[in] points The set of points (shape=(num_points, 3))
+/// @return For the ith point, the rank and the (local to that rank)
+/// index of the closest entity over all ranks. Returns {-1, -1} if
+/// the trees on all ranks are empty.
+std::vector<std::array<std::int32_t, 2>> compute_closest_entity_global(
+    MPI_Comm comm, const BoundingBoxTree& tree,
+    const BoundingBoxTree& midpoint_tree, const mesh::Mesh& mesh,
+    const xt::xtensor<double, 2>& points);
+
 /// Compute squared distance between point and bounding box
 /// @param[in] b Bounding box coordinates
 /// @param[in] x A point
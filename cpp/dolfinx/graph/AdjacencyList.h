@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <numeric>
 #include <sstream>
 #include <utility>
@@ -175,6 +177,279 @@ private:
   std::vector<std::int32_t> _offsets;
 };
 
+/// A non-owning view with the same read interface as AdjacencyList. It
+/// allows adjacency data held in caller-owned buffers, e.g. an external
+/// mesh database, to be used without copying. The caller must guarantee
+/// that the underlying buffers outlive the view.
+template <typename T>
+class AdjacencyListView
+{
+public:
+  /// Construct a view over caller-owned arrays
+  /// @param [in] data Adjacency array
+  /// @param [in] offsets The index to the adjacency list in the data
+  /// array for node i
+  AdjacencyListView(const xtl::span<const T>& data,
+                    const xtl::span<const std::int32_t>& offsets)
+      : _array(data), _offsets(offsets)
+  {
+    assert(!_offsets.empty());
+    assert(_offsets.back() == (std::int32_t)_array.size());
+  }
+
+  /// Construct a view of an AdjacencyList
+  /// @param [in] list The adjacency list to view. Must outlive the
+  /// view.
+  AdjacencyListView(const AdjacencyList<T>& list)
+      : _array(list.array()), _offsets(list.offsets())
+  {
+    // Do nothing
+  }
+
+  /// Get the number of nodes
+  /// @return The number of nodes
+  std::int32_t num_nodes() const { return _offsets.size() - 1; }
+
+  /// Number of connections for given node
+  /// @param [in] node Node index
+  /// @return The number of outgoing links (edges) from the node
+  int num_links(int node) const
+  {
+    assert((node + 1) < (int)_offsets.size());
+    return _offsets[node + 1] - _offsets[node];
+  }
+
+  /// Get the links (edges) for given node
+  /// @param [in] node Node index
+  /// @return Array of outgoing links for the node. The length will be
+  /// AdjacencyListView:num_links(node).
+  xtl::span<const T> links(int node) const
+  {
+    return _array.subspan(_offsets[node], _offsets[node + 1] - _offsets[node]);
+  }
+
+  /// Return contiguous array of links for all nodes
+  xtl::span<const T> array() const { return _array; }
+
+  /// Offset for each node in array()
+  xtl::span<const std::int32_t> offsets() const { return _offsets; }
+
+  /// Copy the viewed data into an owning AdjacencyList
+  AdjacencyList<T> copy() const
+  {
+    return AdjacencyList<T>(
+        std::vector<T>(_array.begin(), _array.end()),
+        std::vector<std::int32_t>(_offsets.begin(), _offsets.end()));
+  }
+
+private:
+  // Connections for all entities stored as a contiguous array
+  xtl::span<const T> _array;
+
+  // Position of first connection for each entity (using local index)
+  xtl::span<const std::int32_t> _offsets;
+};
+
+/// A non-owning adjacency list with the same number of links (edges)
+/// for every node and implicit offsets. Cell-vertex and dofmap lists
+/// on meshes with a single cell type have constant degree, so the
+/// offsets of an AdjacencyList are pure redundancy: the links of node
+/// i always start at `i * degree`. This class stores only the
+/// adjacency array and the degree, which removes the offsets storage
+/// and, more importantly in hot loops, the dependent offsets load on
+/// every links() call. The caller must guarantee that the underlying
+/// buffer outlives the view.
+template <typename T>
+class FixedDegreeAdjacencyList
+{
+public:
+  /// Construct from a flat adjacency array
+  /// @param [in] data Adjacency array, `degree` entries per node
+  /// @param [in] degree The number of (outgoing) edges for each node
+  FixedDegreeAdjacencyList(const xtl::span<const T>& data, int degree)
+      : _array(data), _degree(degree)
+  {
+    assert(_degree > 0);
+    assert(_array.size() % _degree == 0);
+  }
+
+  /// Construct a view of a constant-degree AdjacencyList. The list
+  /// must have the same number of links for every node and must
+  /// outlive the view.
+  /// @param [in] list The adjacency list to view
+  FixedDegreeAdjacencyList(const AdjacencyList<T>& list)
+      : _array(list.array()),
+        _degree(list.num_nodes() > 0 ? list.num_links(0) : 1)
+  {
+    assert((std::int32_t)_array.size() == list.num_nodes() * _degree);
+  }
+
+  /// Get the number of nodes
+  /// @return The number of nodes
+  std::int32_t num_nodes() const { return _array.size() / _degree; }
+
+  /// Number of connections for given node (the same for every node)
+  /// @return The number of outgoing links (edges) from the node
+  int num_links(int) const { return _degree; }
+
+  /// The number of links per node
+  int degree() const { return _degree; }
+
+  /// Get the links (edges) for given node
+  /// @param [in] node Node index
+  /// @return Array of outgoing links for the node. The length will be
+  /// FixedDegreeAdjacencyList::degree().
+  xtl::span<const T> links(int node) const
+  {
+    return _array.subspan(node * _degree, _degree);
+  }
+
+  /// Return contiguous array of links for all nodes
+  xtl::span<const T> array() const { return _array; }
+
+private:
+  // Connections for all entities stored as a contiguous array
+  xtl::span<const T> _array;
+
+  // Number of connections for every entity
+  int _degree;
+};
+
+/// Compressed read-only storage for an adjacency list with 32-bit
+/// links. Each row is delta-encoded against its smallest link: rows
+/// whose link span fits in 16 bits -- the common case for entity-local
+/// connectivities, where locality-preserving reordering keeps the
+/// links of an entity close together in the numbering -- store one
+/// std::uint16_t per link, and the remaining rows escape to two
+/// std::uint16_t per link. This roughly halves the storage of large
+/// connectivity tables. Rows are decompressed into a caller-provided
+/// buffer, so entity loops can fuse the decompression with the work on
+/// the row.
+class CompressedAdjacencyList
+{
+public:
+  /// Compress an adjacency list
+  /// @param[in] list The list to compress
+  explicit CompressedAdjacencyList(const AdjacencyList<std::int32_t>& list)
+      : _offsets(list.offsets()), _base(list.num_nodes(), 0),
+        _escape(list.num_nodes(), 0),
+        _packed_offsets(list.num_nodes() + 1, 0)
+  {
+    const std::int32_t n = list.num_nodes();
+    for (std::int32_t node = 0; node < n; ++node)
+    {
+      auto links = list.links(node);
+      std::int32_t base = 0, span = 0;
+      if (!links.empty())
+      {
+        auto [min, max] = std::minmax_element(links.begin(), links.end());
+        base = *min;
+        span = *max - *min;
+      }
+      _base[node] = base;
+      _escape[node] = span > 0xffff ? 1 : 0;
+      _packed_offsets[node + 1]
+          = _packed_offsets[node] + (_escape[node] ? 2 : 1) * links.size();
+    }
+
+    _deltas.resize(_packed_offsets.back());
+    for (std::int32_t node = 0; node < n; ++node)
+    {
+      auto links = list.links(node);
+      std::size_t p = _packed_offsets[node];
+      if (!_escape[node])
+      {
+        for (std::int32_t link : links)
+          _deltas[p++] = link - _base[node];
+      }
+      else
+      {
+        for (std::int32_t link : links)
+        {
+          const std::uint32_t delta = link - _base[node];
+          _deltas[p++] = delta >> 16;
+          _deltas[p++] = delta & 0xffff;
+        }
+      }
+    }
+  }
+
+  /// Number of nodes
+  std::int32_t num_nodes() const { return _base.size(); }
+
+  /// Number of connections for given node
+  int num_links(int node) const
+  {
+    return _offsets[node + 1] - _offsets[node];
+  }
+
+  /// Decompress the links of a node into a caller-provided buffer
+  /// @param[in] node Node index
+  /// @param[in,out] links Buffer of size num_links(node) receiving the
+  /// links of the node
+  void links(int node, const xtl::span<std::int32_t>& links) const
+  {
+    assert((int)links.size() == num_links(node));
+    const std::int32_t base = _base[node];
+    const std::size_t p = _packed_offsets[node];
+    if (!_escape[node])
+    {
+      for (std::size_t i = 0; i < links.size(); ++i)
+        links[i] = base + _deltas[p + i];
+    }
+    else
+    {
+      for (std::size_t i = 0; i < links.size(); ++i)
+      {
+        links[i] = base
+                   + ((std::uint32_t(_deltas[p + 2 * i]) << 16)
+                      | _deltas[p + 2 * i + 1]);
+      }
+    }
+  }
+
+  /// Offset for each node in the (uncompressed) link array
+  const std::vector<std::int32_t>& offsets() const { return _offsets; }
+
+  /// Decompress into a plain adjacency list
+  AdjacencyList<std::int32_t> decompress() const
+  {
+    std::vector<std::int32_t> array(_offsets.back());
+    for (std::int32_t node = 0; node < num_nodes(); ++node)
+    {
+      this->links(node, xtl::span<std::int32_t>(array.data() + _offsets[node],
+                                                num_links(node)));
+    }
+    std::vector<std::int32_t> offsets = _offsets;
+    return AdjacencyList<std::int32_t>(std::move(array), std::move(offsets));
+  }
+
+  /// Bytes used by the compressed storage
+  std::int64_t storage_bytes() const
+  {
+    return std::int64_t(sizeof(std::uint16_t)) * _deltas.size()
+           + sizeof(std::int32_t)
+                 * (_offsets.size() + _base.size() + _packed_offsets.size())
+           + sizeof(std::uint8_t) * _escape.size();
+  }
+
+private:
+  // Offset for each node in the uncompressed link array
+  std::vector<std::int32_t> _offsets;
+
+  // Smallest link of each row (the delta base)
+  std::vector<std::int32_t> _base;
+
+  // 1 for rows stored with two std::uint16_t per link
+  std::vector<std::uint8_t> _escape;
+
+  // Offset for each node in _deltas
+  std::vector<std::int32_t> _packed_offsets;
+
+  // Delta-encoded links
+  std::vector<std::uint16_t> _deltas;
+};
+
 /// Construct an adjacency list from array of data for a graph with
 /// constant degree (valency). A constant degree graph has the same
 /// number of edges for every node.
@@ -0,0 +1,206 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "coloring.h"
+#include <algorithm>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/common/utils.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+using namespace dolfinx;
+
+namespace
+{
+//-----------------------------------------------------------------------------
+// Assign to each node in [begin, end) of the worklist the smallest
+// colour not found on its distance-1 (or distance-2) neighbourhood.
+// Reads of colours that are being assigned concurrently by other
+// threads are speculative; the conflicts this can cause are detected
+// and resolved in a later round.
+void color_block(const graph::AdjacencyList<std::int32_t>& graph,
+                 const xtl::span<const std::int32_t>& worklist,
+                 std::size_t begin, std::size_t end, int distance,
+                 std::vector<std::int32_t>& colors)
+{
+  // Scratch array marking colours used in the neighbourhood of the
+  // current node. Entry c is set to the current node index when colour
+  // c is found on a neighbour.
+  std::vector<std::int32_t> forbidden;
+  for (std::size_t i = begin; i < end; ++i)
+  {
+    const std::int32_t v = worklist[i];
+    auto mark = [&forbidden, &colors, v](std::int32_t w)
+    {
+      const std::int32_t c = colors[w];
+      if (c >= 0)
+      {
+        if (c >= (std::int32_t)forbidden.size())
+          forbidden.resize(c + 1, -1);
+        forbidden[c] = v;
+      }
+    };
+
+    for (std::int32_t w : graph.links(v))
+    {
+      mark(w);
+      if (distance == 2)
+      {
+        for (std::int32_t u : graph.links(w))
+        {
+          if (u != v)
+            mark(u);
+        }
+      }
+    }
+
+    // Pick smallest colour not used in the neighbourhood
+    std::int32_t c = 0;
+    while (c < (std::int32_t)forbidden.size() and forbidden[c] == v)
+      ++c;
+    colors[v] = c;
+  }
+}
+//-----------------------------------------------------------------------------
+// Find the nodes in [begin, end) of the worklist whose colour collides
+// with a node within the colouring distance. Of two conflicting nodes
+// the one with the larger index is re-coloured, so the smallest node
+// of the worklist is never re-added and each round makes progress.
+void detect_conflicts(const graph::AdjacencyList<std::int32_t>& graph,
+                      const xtl::span<const std::int32_t>& worklist,
+                      std::size_t begin, std::size_t end, int distance,
+                      const std::vector<std::int32_t>& colors,
+                      std::vector<std::int32_t>& conflicts)
+{
+  for (std::size_t i = begin; i < end; ++i)
+  {
+    const std::int32_t v = worklist[i];
+    const std::int32_t cv = colors[v];
+    bool conflict = false;
+    auto check = [&colors, &conflict, v, cv](std::int32_t w)
+    {
+      if (w < v and colors[w] == cv)
+        conflict = true;
+    };
+
+    for (std::int32_t w : graph.links(v))
+    {
+      check(w);
+      if (distance == 2)
+      {
+        for (std::int32_t u : graph.links(w))
+        {
+          if (u != v)
+            check(u);
+        }
+      }
+    }
+
+    if (conflict)
+      conflicts.push_back(v);
+  }
+}
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+graph::color(const graph::AdjacencyList<std::int32_t>& graph, int distance)
+{
+  common::Timer timer("Compute graph colouring");
+
+  if (distance != 1 and distance != 2)
+    throw std::runtime_error("Graph colouring supports distance 1 and 2.");
+
+  const std::int32_t n = graph.num_nodes();
+  std::vector<std::int32_t> colors(n, -1);
+
+  // Nodes still to be coloured
+  std::vector<std::int32_t> worklist(n);
+  std::iota(worklist.begin(), worklist.end(), 0);
+
+  const int num_threads = common::num_threads();
+  if (num_threads <= 1)
+  {
+    color_block(graph, worklist, 0, worklist.size(), distance, colors);
+    return colors;
+  }
+
+  while (!worklist.empty())
+  {
+    // Speculatively colour the remaining nodes in parallel
+    {
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (int t = 0; t < num_threads; ++t)
+      {
+        const std::size_t begin = (worklist.size() * t) / num_threads;
+        const std::size_t end = (worklist.size() * (t + 1)) / num_threads;
+        if (begin == end)
+          continue;
+        threads.emplace_back([&graph, &worklist, begin, end, distance,
+                              &colors]() {
+          color_block(graph, worklist, begin, end, distance, colors);
+        });
+      }
+      for (std::thread& thread : threads)
+        thread.join();
+    }
+
+    // Detect conflicts across block boundaries and build the worklist
+    // for the next round
+    std::vector<std::vector<std::int32_t>> conflicts(num_threads);
+    {
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (int t = 0; t < num_threads; ++t)
+      {
+        const std::size_t begin = (worklist.size() * t) / num_threads;
+        const std::size_t end = (worklist.size() * (t + 1)) / num_threads;
+        if (begin == end)
+          continue;
+        threads.emplace_back([&graph, &worklist, begin, end, distance,
+                              &colors, &conflict = conflicts[t]]() {
+          detect_conflicts(graph, worklist, begin, end, distance, colors,
+                           conflict);
+        });
+      }
+      for (std::thread& thread : threads)
+        thread.join();
+    }
+
+    worklist.clear();
+    for (const std::vector<std::int32_t>& c : conflicts)
+      worklist.insert(worklist.end(), c.begin(), c.end());
+  }
+
+  return colors;
+}
+//-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t>
+graph::color_classes(const xtl::span<const std::int32_t>& colors)
+{
+  const std::int32_t num_colors
+      = colors.empty() ? 0
+                       : *std::max_element(colors.begin(), colors.end()) + 1;
+
+  // Counting sort of the nodes by colour
+  std::vector<std::int32_t> offsets(num_colors + 1, 0);
+  for (std::int32_t c : colors)
+    offsets[c + 1]++;
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  std::vector<std::int32_t> nodes(colors.size());
+  std::vector<std::int32_t> pos(offsets.begin(), std::prev(offsets.end()));
+  for (std::size_t v = 0; v < colors.size(); ++v)
+    nodes[pos[colors[v]]++] = v;
+
+  return graph::AdjacencyList<std::int32_t>(std::move(nodes),
+                                            std::move(offsets));
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,49 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::graph
+{
+template <typename T>
+class AdjacencyList;
+
+/// Compute a greedy (first-fit) colouring of a graph such that no two
+/// nodes within the requested distance share a colour. A distance-1
+/// colouring separates adjacent nodes, e.g. for conflict-free threaded
+/// assembly over the dual graph of a mesh; a distance-2 colouring also
+/// separates nodes with a common neighbour, e.g. for dof-conflict
+/// graphs.
+///
+/// When more than one thread is available (see common::num_threads),
+/// the graph is coloured with speculative parallel colouring: each
+/// thread colours a block of nodes greedily, and nodes that end up in
+/// conflict across block boundaries are re-coloured in further rounds.
+/// The colouring depends on the number of threads, but is always
+/// valid.
+///
+/// @param[in] graph The graph to colour
+/// @param[in] distance The colouring distance (1 or 2)
+/// @return Colour for each node, where `colour[i]` is the colour of
+/// node `i`. Colours are numbered contiguously from zero.
+std::vector<std::int32_t> color(const AdjacencyList<std::int32_t>& graph,
+                                int distance = 1);
+
+/// Group coloured graph nodes into colour classes
+///
+/// @param[in] colors Colour for each node, e.g. computed by color()
+/// @return Adjacency list in which the links of node c are the graph
+/// nodes with colour c. The nodes of one class are mutually
+/// non-adjacent (within the colouring distance), so they can be
+/// processed concurrently without synchronisation.
+AdjacencyList<std::int32_t>
+color_classes(const xtl::span<const std::int32_t>& colors);
+
+} // namespace dolfinx::graph
@@ -7,6 +7,7 @@
 #include "ordering.h"
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/graph/AdjacencyList.h>
@@ -350,6 +351,75 @@ std::vector<int> gps_reorder_unlabelled(const graph::AdjacencyList<int>& graph,
 
   return rv;
 }
+//-----------------------------------------------------------------------------
+// Reverse Cuthill-McKee ordering of the nodes which are yet unlabelled
+// (indicated with -1 in the vector rlabel)
+std::vector<int> rcm_reorder_unlabelled(const graph::AdjacencyList<int>& graph,
+                                        const xtl::span<const int>& rlabel)
+{
+  const int n = graph.num_nodes();
+
+  // Degree comparison function
+  auto cmp_degree = [&graph](int a, int b)
+  { return (graph.num_links(a) < graph.num_links(b)); };
+
+  // Pick an arbitrary unlabelled vertex of minimal degree and call it v
+  int v = 0;
+  int dmin = std::numeric_limits<int>::max();
+  for (int i = 0; i < n; ++i)
+  {
+    if (int d = graph.num_links(i); d < dmin and rlabel[i] == -1)
+    {
+      v = i;
+      dmin = d;
+    }
+  }
+
+  // Find a pseudo-peripheral root: repeatedly move to a minimal-degree
+  // node of the deepest level until the level structure stops growing
+  graph::AdjacencyList<int> lv = create_level_structure(graph, v);
+  bool done = false;
+  while (!done)
+  {
+    auto lv_final = lv.links(lv.num_nodes() - 1);
+    const int s
+        = *std::min_element(lv_final.begin(), lv_final.end(), cmp_degree);
+    auto ls = create_level_structure(graph, s);
+    if (ls.num_nodes() > lv.num_nodes())
+    {
+      v = s;
+      lv = std::move(ls);
+    }
+    else
+      done = true;
+  }
+
+  // Cuthill-McKee: breadth-first traversal from the root, visiting the
+  // unlabelled neighbours of each node in order of increasing degree
+  std::vector<std::int8_t> labelled(n, false);
+  std::vector<int> rv = {v};
+  rv.reserve(lv.array().size());
+  labelled[v] = true;
+  std::vector<int> nbr;
+  for (std::size_t c = 0; c < rv.size(); ++c)
+  {
+    nbr.clear();
+    for (int w : graph.links(rv[c]))
+    {
+      if (!labelled[w])
+      {
+        nbr.push_back(w);
+        labelled[w] = true;
+      }
+    }
+    std::sort(nbr.begin(), nbr.end(), cmp_degree);
+    rv.insert(rv.end(), nbr.begin(), nbr.end());
+  }
+
+  // Reverse the Cuthill-McKee numbering
+  std::reverse(rv.begin(), rv.end());
+  return rv;
+}
 
 } // namespace
 
@@ -377,3 +447,45 @@ std::vector<int> graph::reorder_gps(const graph::AdjacencyList<int>& graph)
   return r;
 }
 //-----------------------------------------------------------------------------
+std::vector<int> graph::reorder_rcm(const graph::AdjacencyList<int>& graph)
+{
+  common::Timer timer("Reverse Cuthill-McKee ordering");
+
+  const int n = graph.num_nodes();
+  std::vector<int> r(n, -1);
+
+  // Repeat for each disconnected part of the graph
+  int count = 0;
+  while (count < n)
+  {
+    const std::vector<int> rv = rcm_reorder_unlabelled(graph, r);
+    assert(rv.size() > 0);
+
+    // Reverse permutation
+    for (int q : rv)
+      r[q] = count++;
+  }
+
+  // Check all labelled
+  assert(std::find(r.begin(), r.end(), -1) == r.end());
+  return r;
+}
+//-----------------------------------------------------------------------------
+std::int32_t graph::bandwidth(const graph::AdjacencyList<int>& graph,
+                              const xtl::span<const int>& perm)
+{
+  assert(perm.empty()
+         or perm.size() == std::size_t(graph.num_nodes()));
+  std::int32_t b = 0;
+  for (int i = 0; i < graph.num_nodes(); ++i)
+  {
+    const int pi = perm.empty() ? i : perm[i];
+    for (int w : graph.links(i))
+    {
+      const int pw = perm.empty() ? w : perm[w];
+      b = std::max(b, std::abs(pi - pw));
+    }
+  }
+  return b;
+}
+//-----------------------------------------------------------------------------
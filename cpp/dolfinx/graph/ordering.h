@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
+#include <xtl/xspan.hpp>
 
 namespace dolfinx::graph
 {
@@ -24,4 +26,29 @@ class AdjacencyList;
 /// node `i`
 std::vector<int> reorder_gps(const graph::AdjacencyList<int>& graph);
 
+/// Reverse Cuthill-McKee ordering: a breadth-first traversal from a
+/// pseudo-peripheral node, visiting the neighbours of each node in
+/// order of increasing degree, with the resulting numbering reversed.
+/// Cheaper to compute than reorder_gps and usually of comparable
+/// bandwidth, so it can be preferable for very large graphs, e.g. as
+/// the `reorder_fn` for dofmap construction.
+///
+/// @param[in] graph The graph to compute a re-ordering for
+/// @return Reordering vector map, when `map[i]` is the new index on
+/// node `i`
+std::vector<int> reorder_rcm(const graph::AdjacencyList<int>& graph);
+
+/// Compute the bandwidth of a graph, i.e. the maximum of |i - j| over
+/// all edges (i, j). For the dual graph of a mesh or a dof
+/// connectivity graph this bounds the bandwidth of the assembled
+/// sparse matrix, and is the quantity that the reordering functions
+/// (reorder_gps, reorder_rcm) aim to reduce.
+///
+/// @param[in] graph The graph
+/// @param[in] perm Reordering map (new index for each node). If
+/// non-empty, the bandwidth of the reordered graph is computed.
+/// @return The graph bandwidth
+std::int32_t bandwidth(const graph::AdjacencyList<int>& graph,
+                       const xtl::span<const int>& perm = {});
+
 } // namespace dolfinx::graph
\ No newline at end of file
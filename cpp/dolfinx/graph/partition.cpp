@@ -7,6 +7,8 @@
 #include "partition.h"
 #include "partitioners.h"
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/graph/AdjacencyList.h>
@@ -15,6 +17,13 @@
 
 using namespace dolfinx;
 
+namespace
+{
+// Magic number identifying partition files written by
+// graph::build::write_destinations
+constexpr std::int64_t partition_file_magic = 0x44585054'30303031;
+} // namespace
+
 //-----------------------------------------------------------------------------
 graph::AdjacencyList<std::int32_t>
 graph::partition_graph(MPI_Comm comm, int nparts,
@@ -35,6 +44,25 @@ graph::partition_graph(MPI_Comm comm, int nparts,
 #endif
 }
 //-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t> graph::partition_graph_weighted(
+    MPI_Comm comm, int nparts, const AdjacencyList<std::int64_t>& local_graph,
+    const xtl::span<const std::int32_t>& node_weights,
+    std::int32_t num_ghost_nodes, bool ghosting)
+{
+#if HAS_PTSCOTCH
+  return graph::scotch::weighted_partitioner()(
+      comm, nparts, local_graph, node_weights, num_ghost_nodes, ghosting);
+#elif HAS_PARMETIS
+  return graph::parmetis::weighted_partitioner()(
+      comm, nparts, local_graph, node_weights, num_ghost_nodes, ghosting);
+#elif HAS_KAHIP
+  return graph::kahip::weighted_partitioner()(
+      comm, nparts, local_graph, node_weights, num_ghost_nodes, ghosting);
+#else
+// Should never reach this point
+#endif
+}
+//-----------------------------------------------------------------------------
 std::tuple<graph::AdjacencyList<std::int64_t>, std::vector<int>,
            std::vector<std::int64_t>, std::vector<int>>
 graph::build::distribute(MPI_Comm comm,
@@ -52,118 +80,248 @@ graph::build::distribute(MPI_Comm comm,
               dolfinx::MPI::mpi_type<std::int64_t>(), MPI_SUM, comm,
               &request_offset_scan);
 
-  const int size = dolfinx::MPI::size(comm);
-
-  // Compute number of links to send to each process
-  std::vector<int> num_per_dest_send(size, 0);
+  const int mpi_rank = MPI::rank(comm);
+
+  // Build the sorted set of destination ranks. Nodes that stay on this
+  // rank (as owned or ghost) are kept out of the MPI buffers and
+  // handled locally, so when most destinations are unchanged, e.g.
+  // after an adaptive repartitioning, only the migrating nodes are
+  // communicated.
+  std::vector<int> dest(destinations.array().begin(),
+                        destinations.array().end());
+  std::sort(dest.begin(), dest.end());
+  dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
+  if (auto it = std::lower_bound(dest.begin(), dest.end(), mpi_rank);
+      it != dest.end() and *it == mpi_rank)
+  {
+    dest.erase(it);
+  }
+  const auto dest_index = [&dest](std::int32_t d)
+  {
+    auto it = std::lower_bound(dest.begin(), dest.end(), d);
+    assert(it != dest.end() and *it == d);
+    return std::distance(dest.begin(), it);
+  };
+
+  // Count the rows going to each destination
+  std::vector<std::int32_t> rows_per_dest(dest.size(), 0);
+  std::int32_t num_local_rows = 0;
   for (int i = 0; i < destinations.num_nodes(); ++i)
   {
-    int list_num_links = list.num_links(i) + 3;
-    auto dests = destinations.links(i);
-    for (std::int32_t d : dests)
-      num_per_dest_send[d] += list_num_links;
+    for (std::int32_t d : destinations.links(i))
+    {
+      if (d == mpi_rank)
+        ++num_local_rows;
+      else
+        ++rows_per_dest[dest_index(d)];
+    }
   }
 
-  // Compute send array displacements
-  std::vector<int> disp_send(size + 1, 0);
-  std::partial_sum(num_per_dest_send.begin(), num_per_dest_send.end(),
-                   disp_send.begin() + 1);
-
-  // Send/receive number of items to communicate
-  std::vector<int> num_per_dest_recv(size, 0);
-  MPI_Alltoall(num_per_dest_send.data(), 1, MPI_INT, num_per_dest_recv.data(),
-               1, MPI_INT, comm);
+  // Only the small row headers [owner, global index, num_links] are
+  // packed and exchanged with the NBX sparse all-to-all, which also
+  // discovers the source ranks. The row payloads are neither staged
+  // nor copied: they are sent directly from the adjacency list storage
+  // and received directly into their final positions with derived
+  // datatypes built below.
+  std::vector<std::int32_t> header_disp(dest.size() + 1, 0);
+  for (std::size_t k = 0; k < dest.size(); ++k)
+    header_disp[k + 1] = header_disp[k] + 3 * rows_per_dest[k];
+  std::vector<std::int64_t> header_send(header_disp.back());
+
+  // Per destination, the number of links and the byte displacement in
+  // the source array of each payload row, ordered as the header rows
+  std::vector<std::vector<int>> send_lengths(dest.size());
+  std::vector<std::vector<MPI_Aint>> send_displs(dest.size());
+  for (std::size_t k = 0; k < dest.size(); ++k)
+  {
+    send_lengths[k].reserve(rows_per_dest[k]);
+    send_displs[k].reserve(rows_per_dest[k]);
+  }
 
-  // Compute receive array displacements
-  std::vector<int> disp_recv(size + 1, 0);
-  std::partial_sum(num_per_dest_recv.begin(), num_per_dest_recv.end(),
-                   disp_recv.begin() + 1);
+  // Rows that stay on this rank, and their headers
+  std::vector<std::int32_t> local_rows;
+  local_rows.reserve(num_local_rows);
+  std::vector<std::int64_t> local_header;
+  local_header.reserve(3 * num_local_rows);
 
   // Complete global_offset scan
   MPI_Wait(&request_offset_scan, MPI_STATUS_IGNORE);
 
-  // Prepare send buffer
-  std::vector<int> offset = disp_send;
-  std::vector<std::int64_t> data_send(disp_send.back());
-  for (int i = 0; i < list.num_nodes(); ++i)
+  const std::vector<std::int32_t>& list_off = list.offsets();
+  {
+    std::vector<std::int32_t> offset = header_disp;
+    for (int i = 0; i < list.num_nodes(); ++i)
+    {
+      auto dests = destinations.links(i);
+      const std::int64_t num_links = list.num_links(i);
+      for (auto d : dests)
+      {
+        if (d == mpi_rank)
+        {
+          local_rows.push_back(i);
+          local_header.push_back(dests[0]);
+          local_header.push_back(i + offset_global);
+          local_header.push_back(num_links);
+        }
+        else
+        {
+          const std::size_t k = dest_index(d);
+          header_send[offset[k]++] = dests[0];
+          header_send[offset[k]++] = i + offset_global;
+          header_send[offset[k]++] = num_links;
+          send_lengths[k].push_back(num_links);
+          send_displs[k].push_back(sizeof(std::int64_t)
+                                   * MPI_Aint(list_off[i]));
+        }
+      }
+    }
+  }
+
+  // Exchange the headers, discovering the source ranks with the NBX
+  // sparse exchange: cost scales with the number of neighbors rather
+  // than the communicator size
+  const auto [src_ranks, recv_header] = dolfinx::MPI::sparse_all_to_all(
+      comm, dest,
+      graph::AdjacencyList<std::int64_t>(std::move(header_send),
+                                         std::move(header_disp)));
+
+  // Header blocks in ascending source rank order, with the local block
+  // (kept out of the exchange) at its position in the rank ordering.
+  // The index of the block in src_ranks is kept for building the
+  // receive datatypes; -1 marks the local block.
+  std::vector<std::pair<int, xtl::span<const std::int64_t>>> blocks;
+  blocks.reserve(src_ranks.size() + 1);
   {
-    auto links = list.links(i);
-    auto dests = destinations.links(i);
-    for (auto dest : dests)
+    bool local_done = false;
+    for (int p = 0; p < recv_header.num_nodes(); ++p)
     {
-      data_send[offset[dest]++] = dests[0];
-      data_send[offset[dest]++] = i + offset_global;
-      data_send[offset[dest]++] = links.size();
-      std::copy(links.cbegin(), links.cend(),
-                std::next(data_send.begin(), offset[dest]));
-      offset[dest] += links.size();
+      if (!local_done and src_ranks[p] > mpi_rank)
+      {
+        blocks.emplace_back(-1, xtl::span<const std::int64_t>(local_header));
+        local_done = true;
+      }
+      blocks.emplace_back(p, recv_header.links(p));
+    }
+    if (!local_done)
+      blocks.emplace_back(-1, xtl::span<const std::int64_t>(local_header));
+  }
+
+  // Compute the sizes of the owned and ghost regions of the final
+  // array from the headers. Owned rows fill the front of the array in
+  // arrival order and ghost rows the back, so received payloads land
+  // directly in their final positions.
+  std::int64_t num_owned_links = 0, num_ghost_links = 0;
+  for (const auto& [b, h] : blocks)
+  {
+    for (std::size_t i = 0; i < h.size(); i += 3)
+    {
+      if (h[i] == mpi_rank)
+        num_owned_links += h[i + 2];
+      else
+        num_ghost_links += h[i + 2];
     }
   }
 
-  // Send/receive data
-  std::vector<std::int64_t> data_recv(disp_recv.back());
-  MPI_Alltoallv(data_send.data(), num_per_dest_send.data(), disp_send.data(),
-                MPI_INT64_T, data_recv.data(), num_per_dest_recv.data(),
-                disp_recv.data(), MPI_INT64_T, comm);
-
-  // Force memory to be freed
-  std::vector<int>().swap(num_per_dest_send);
-  std::vector<int>().swap(disp_send);
-  std::vector<int>().swap(num_per_dest_recv);
-  std::vector<std::int64_t>().swap(data_send);
-
-  // Unpack receive buffer
-  int mpi_rank = MPI::rank(comm);
-  std::vector<std::int64_t> array;
-  std::vector<std::int64_t> ghost_array;
+  std::vector<std::int64_t> array(num_owned_links + num_ghost_links);
   std::vector<std::int64_t> global_indices;
   std::vector<std::int64_t> ghost_global_indices;
   std::vector<std::int32_t> list_offset = {0};
-  std::vector<std::int32_t> ghost_list_offset = {0};
+  std::vector<std::int32_t> ghost_num_links;
   std::vector<int> src;
   std::vector<int> ghost_src;
   std::vector<int> ghost_index_owner;
 
-  for (std::size_t p = 0; p < disp_recv.size() - 1; ++p)
+  // Per source, the number of links and the byte displacement in the
+  // final array of each payload row, ordered as the header rows
+  std::vector<std::vector<int>> recv_lengths(src_ranks.size());
+  std::vector<std::vector<MPI_Aint>> recv_displs(src_ranks.size());
+
+  std::int64_t pos_owned = 0;
+  std::int64_t pos_ghost = num_owned_links;
+  std::size_t local_row = 0;
+  for (const auto& [b, h] : blocks)
   {
-    for (int i = disp_recv[p]; i < disp_recv[p + 1];)
+    const int p = b >= 0 ? src_ranks[b] : mpi_rank;
+    for (std::size_t i = 0; i < h.size(); i += 3)
     {
-      if (data_recv[i] == mpi_rank)
+      const std::int64_t num_links = h[i + 2];
+      std::int64_t pos;
+      if (h[i] == mpi_rank)
       {
         src.push_back(p);
-        i++; // index_owner.push_back(data_recv[i++]);
-        global_indices.push_back(data_recv[i++]);
-        const std::int64_t num_links = data_recv[i++];
-        array.insert(array.end(), std::next(data_recv.begin(), i),
-                     std::next(data_recv.begin(), i + num_links));
-        i += num_links;
+        global_indices.push_back(h[i + 1]);
         list_offset.push_back(list_offset.back() + num_links);
+        pos = pos_owned;
+        pos_owned += num_links;
       }
       else
       {
         ghost_src.push_back(p);
-        ghost_index_owner.push_back(data_recv[i++]);
-        ghost_global_indices.push_back(data_recv[i++]);
-        const std::int64_t num_links = data_recv[i++];
-        ghost_array.insert(ghost_array.end(), std::next(data_recv.begin(), i),
-                           std::next(data_recv.begin(), i + num_links));
-        i += num_links;
-        ghost_list_offset.push_back(ghost_list_offset.back() + num_links);
+        ghost_index_owner.push_back(h[i]);
+        ghost_global_indices.push_back(h[i + 1]);
+        ghost_num_links.push_back(num_links);
+        pos = pos_ghost;
+        pos_ghost += num_links;
+      }
+
+      if (b >= 0)
+      {
+        recv_lengths[b].push_back(num_links);
+        recv_displs[b].push_back(sizeof(std::int64_t) * MPI_Aint(pos));
+      }
+      else
+      {
+        // Rows that stay on this rank are copied straight from the
+        // source storage
+        const std::int32_t r = local_rows[local_row++];
+        std::copy_n(std::next(list.array().begin(), list_off[r]), num_links,
+                    std::next(array.begin(), pos));
       }
     }
   }
 
-  // Attach all ghost cells at the end of the list
+  // Build the derived datatypes and exchange the payloads: one message
+  // per neighbor, sent from the adjacency list storage and received
+  // into the final array without intermediate buffers
+  const int tag = 1202;
+  std::vector<MPI_Request> requests;
+  requests.reserve(src_ranks.size() + dest.size());
+  std::vector<MPI_Datatype> types;
+  types.reserve(src_ranks.size() + dest.size());
+  for (std::size_t b = 0; b < src_ranks.size(); ++b)
+  {
+    MPI_Datatype type;
+    MPI_Type_create_hindexed(recv_lengths[b].size(), recv_lengths[b].data(),
+                             recv_displs[b].data(),
+                             dolfinx::MPI::mpi_type<std::int64_t>(), &type);
+    MPI_Type_commit(&type);
+    types.push_back(type);
+    requests.emplace_back();
+    MPI_Irecv(array.data(), 1, type, src_ranks[b], tag, comm,
+              &requests.back());
+  }
+  for (std::size_t k = 0; k < dest.size(); ++k)
+  {
+    MPI_Datatype type;
+    MPI_Type_create_hindexed(send_lengths[k].size(), send_lengths[k].data(),
+                             send_displs[k].data(),
+                             dolfinx::MPI::mpi_type<std::int64_t>(), &type);
+    MPI_Type_commit(&type);
+    types.push_back(type);
+    requests.emplace_back();
+    MPI_Isend(list.array().data(), 1, type, dest[k], tag, comm,
+              &requests.back());
+  }
+  MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+  for (MPI_Datatype& type : types)
+    MPI_Type_free(&type);
+
+  // Attach all ghost rows at the end of the list
   src.insert(src.end(), ghost_src.begin(), ghost_src.end());
   global_indices.insert(global_indices.end(), ghost_global_indices.begin(),
                         ghost_global_indices.end());
-  array.insert(array.end(), ghost_array.begin(), ghost_array.end());
-  int ghost_offset = list_offset.back();
-  list_offset.pop_back();
-  std::for_each(ghost_list_offset.begin(), ghost_list_offset.end(),
-                [ghost_offset](auto& offset) { offset += ghost_offset; });
-  list_offset.insert(list_offset.end(), ghost_list_offset.begin(),
-                     ghost_list_offset.end());
+  for (std::int32_t num_links : ghost_num_links)
+    list_offset.push_back(list_offset.back() + num_links);
 
   array.shrink_to_fit();
   list_offset.shrink_to_fit();
@@ -176,6 +334,316 @@ graph::build::distribute(MPI_Comm comm,
           std::move(ghost_index_owner)};
 }
 //-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t> graph::build::expand_destinations(
+    MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& graph,
+    const graph::AdjacencyList<std::int32_t>& destinations, int num_layers)
+{
+  common::Timer timer("Expand destination ranks to deep ghost layers");
+
+  assert(graph.num_nodes() == destinations.num_nodes());
+  if (num_layers < 1)
+    throw std::runtime_error("Number of ghost layers must be at least 1.");
+
+  const int size = dolfinx::MPI::size(comm);
+  const std::int32_t num_nodes = graph.num_nodes();
+
+  // Compute the global index range of every rank, to locate the
+  // storage rank of remote graph nodes. The global index of a node is
+  // its local index plus the offset for its rank.
+  const std::int64_t num_local = num_nodes;
+  std::vector<std::int64_t> node_offsets(size + 1, 0);
+  MPI_Allgather(&num_local, 1, MPI_INT64_T, node_offsets.data() + 1, 1,
+                MPI_INT64_T, comm);
+  std::partial_sum(node_offsets.begin(), node_offsets.end(),
+                   node_offsets.begin());
+  const std::int64_t offset = node_offsets[dolfinx::MPI::rank(comm)];
+
+  // Current destination set of each node (sorted, including the
+  // owner), with the owning rank kept separately
+  std::vector<std::int32_t> owner(num_nodes);
+  std::vector<std::vector<std::int32_t>> dest(num_nodes);
+  for (std::int32_t i = 0; i < num_nodes; ++i)
+  {
+    auto d = destinations.links(i);
+    assert(!d.empty());
+    owner[i] = d[0];
+    dest[i].assign(d.begin(), d.end());
+    std::sort(dest[i].begin(), dest[i].end());
+    dest[i].erase(std::unique(dest[i].begin(), dest[i].end()), dest[i].end());
+  }
+
+  // The graph does not change between rounds: set up the request
+  // pattern for the destination sets of remote neighbors once
+  std::vector<std::int64_t> remote;
+  for (std::int64_t g : graph.array())
+  {
+    if (g < offset or g >= offset + num_nodes)
+      remote.push_back(g);
+  }
+  std::sort(remote.begin(), remote.end());
+  remote.erase(std::unique(remote.begin(), remote.end()), remote.end());
+
+  // remote is sorted, so requests are already grouped by storage rank
+  std::vector<int> num_req_send(size, 0);
+  for (std::int64_t g : remote)
+  {
+    const int r = std::distance(node_offsets.begin(),
+                                std::upper_bound(node_offsets.begin(),
+                                                 node_offsets.end(), g))
+                  - 1;
+    num_req_send[r]++;
+  }
+  std::vector<int> disp_req_send(size + 1, 0);
+  std::partial_sum(num_req_send.begin(), num_req_send.end(),
+                   disp_req_send.begin() + 1);
+
+  std::vector<int> num_req_recv(size);
+  MPI_Alltoall(num_req_send.data(), 1, MPI_INT, num_req_recv.data(), 1, MPI_INT,
+               comm);
+  std::vector<int> disp_req_recv(size + 1, 0);
+  std::partial_sum(num_req_recv.begin(), num_req_recv.end(),
+                   disp_req_recv.begin() + 1);
+
+  std::vector<std::int64_t> req_recv(disp_req_recv.back());
+  MPI_Alltoallv(remote.data(), num_req_send.data(), disp_req_send.data(),
+                MPI_INT64_T, req_recv.data(), num_req_recv.data(),
+                disp_req_recv.data(), MPI_INT64_T, comm);
+
+  // Grow the destination sets one layer per round. The first layer is
+  // already present in the partitioner output.
+  for (int layer = 1; layer < num_layers; ++layer)
+  {
+    // Reply to each request with the current destination set of the
+    // requested node, prefixed with its length
+    std::vector<int> num_reply_send(size, 0);
+    for (int p = 0; p < size; ++p)
+    {
+      for (int j = disp_req_recv[p]; j < disp_req_recv[p + 1]; ++j)
+      {
+        const std::int32_t node = req_recv[j] - offset;
+        assert(node >= 0 and node < num_nodes);
+        num_reply_send[p] += dest[node].size() + 1;
+      }
+    }
+    std::vector<int> disp_reply_send(size + 1, 0);
+    std::partial_sum(num_reply_send.begin(), num_reply_send.end(),
+                     disp_reply_send.begin() + 1);
+
+    std::vector<std::int32_t> reply_send(disp_reply_send.back());
+    {
+      std::vector<int> pos(disp_reply_send.begin(),
+                           std::prev(disp_reply_send.end()));
+      for (int p = 0; p < size; ++p)
+      {
+        for (int j = disp_req_recv[p]; j < disp_req_recv[p + 1]; ++j)
+        {
+          const std::int32_t node = req_recv[j] - offset;
+          reply_send[pos[p]++] = dest[node].size();
+          std::copy(dest[node].begin(), dest[node].end(),
+                    std::next(reply_send.begin(), pos[p]));
+          pos[p] += dest[node].size();
+        }
+      }
+    }
+
+    std::vector<int> num_reply_recv(size);
+    MPI_Alltoall(num_reply_send.data(), 1, MPI_INT, num_reply_recv.data(), 1,
+                 MPI_INT, comm);
+    std::vector<int> disp_reply_recv(size + 1, 0);
+    std::partial_sum(num_reply_recv.begin(), num_reply_recv.end(),
+                     disp_reply_recv.begin() + 1);
+
+    std::vector<std::int32_t> reply_recv(disp_reply_recv.back());
+    MPI_Alltoallv(reply_send.data(), num_reply_send.data(),
+                  disp_reply_send.data(), MPI_INT32_T, reply_recv.data(),
+                  num_reply_recv.data(), disp_reply_recv.data(), MPI_INT32_T,
+                  comm);
+
+    // Replies arrive in the order of the (sorted) requests: build
+    // offsets into the reply data for each remote node
+    std::vector<std::int32_t> reply_begin(remote.size()),
+        reply_end(remote.size());
+    {
+      std::size_t pos = 0;
+      for (std::size_t k = 0; k < remote.size(); ++k)
+      {
+        const std::int32_t len = reply_recv[pos];
+        reply_begin[k] = pos + 1;
+        reply_end[k] = pos + 1 + len;
+        pos += len + 1;
+      }
+      assert(pos == reply_recv.size());
+    }
+
+    // Union each node's destination set with the sets of its graph
+    // neighbors
+    const std::vector<std::vector<std::int32_t>> dest_prev = dest;
+    for (std::int32_t i = 0; i < num_nodes; ++i)
+    {
+      std::vector<std::int32_t>& d = dest[i];
+      for (std::int64_t g : graph.links(i))
+      {
+        if (g >= offset and g < offset + num_nodes)
+        {
+          const std::vector<std::int32_t>& dn = dest_prev[g - offset];
+          d.insert(d.end(), dn.begin(), dn.end());
+        }
+        else
+        {
+          auto it = std::lower_bound(remote.begin(), remote.end(), g);
+          assert(it != remote.end() and *it == g);
+          const std::size_t k = std::distance(remote.begin(), it);
+          d.insert(d.end(), std::next(reply_recv.begin(), reply_begin[k]),
+                   std::next(reply_recv.begin(), reply_end[k]));
+        }
+      }
+      std::sort(d.begin(), d.end());
+      d.erase(std::unique(d.begin(), d.end()), d.end());
+    }
+  }
+
+  // Build the destination list with the owning rank first
+  std::vector<std::int32_t> data;
+  std::vector<std::int32_t> offsets = {0};
+  for (std::int32_t i = 0; i < num_nodes; ++i)
+  {
+    data.push_back(owner[i]);
+    for (std::int32_t r : dest[i])
+    {
+      if (r != owner[i])
+        data.push_back(r);
+    }
+    offsets.push_back(data.size());
+  }
+
+  return graph::AdjacencyList<std::int32_t>(std::move(data),
+                                            std::move(offsets));
+}
+//-----------------------------------------------------------------------------
+void graph::build::write_destinations(
+    MPI_Comm comm, const std::string& filename,
+    const graph::AdjacencyList<std::int32_t>& destinations)
+{
+  common::Timer timer("Write graph partition to file");
+
+  const int size = dolfinx::MPI::size(comm);
+  const int rank = dolfinx::MPI::rank(comm);
+
+  // Payload for this rank: [num_nodes (int64), offsets (int32),
+  // destination ranks (int32)]
+  const std::vector<std::int32_t>& array = destinations.array();
+  const std::vector<std::int32_t>& offsets = destinations.offsets();
+  const std::int64_t num_nodes = destinations.num_nodes();
+  const std::int64_t local_bytes
+      = sizeof(std::int64_t)
+        + sizeof(std::int32_t) * (offsets.size() + array.size());
+
+  // Compute the byte offset of each rank's payload
+  std::vector<std::int64_t> bytes_per_rank(size);
+  MPI_Allgather(&local_bytes, 1, MPI_INT64_T, bytes_per_rank.data(), 1,
+                MPI_INT64_T, comm);
+  std::vector<std::int64_t> byte_offset(size + 1, 0);
+  std::partial_sum(bytes_per_rank.begin(), bytes_per_rank.end(),
+                   std::next(byte_offset.begin()));
+
+  // File layout: [magic, num_ranks, byte offset table (num_ranks + 1),
+  // payloads]
+  const std::int64_t header_bytes = (size + 3) * sizeof(std::int64_t);
+
+  MPI_File fh;
+  if (MPI_File_open(comm, filename.c_str(),
+                    MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh)
+      != MPI_SUCCESS)
+  {
+    throw std::runtime_error("Failed to open partition file '" + filename
+                             + "' for writing.");
+  }
+  MPI_File_set_size(fh, 0);
+
+  // Write header and offset table
+  if (rank == 0)
+  {
+    std::vector<std::int64_t> header = {partition_file_magic,
+                                        std::int64_t(size)};
+    header.insert(header.end(), byte_offset.begin(), byte_offset.end());
+    MPI_File_write_at(fh, 0, header.data(), header.size(), MPI_INT64_T,
+                      MPI_STATUS_IGNORE);
+  }
+
+  // Pack and write the payload for this rank
+  std::vector<char> buffer(local_bytes);
+  char* ptr = buffer.data();
+  std::memcpy(ptr, &num_nodes, sizeof(std::int64_t));
+  ptr += sizeof(std::int64_t);
+  std::memcpy(ptr, offsets.data(), sizeof(std::int32_t) * offsets.size());
+  ptr += sizeof(std::int32_t) * offsets.size();
+  std::memcpy(ptr, array.data(), sizeof(std::int32_t) * array.size());
+  MPI_File_write_at_all(fh, header_bytes + byte_offset[rank], buffer.data(),
+                        buffer.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+}
+//-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t>
+graph::build::read_destinations(MPI_Comm comm, const std::string& filename)
+{
+  common::Timer timer("Read graph partition from file");
+
+  const int size = dolfinx::MPI::size(comm);
+  const int rank = dolfinx::MPI::rank(comm);
+
+  MPI_File fh;
+  if (MPI_File_open(comm, filename.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL,
+                    &fh)
+      != MPI_SUCCESS)
+  {
+    throw std::runtime_error("Failed to open partition file '" + filename
+                             + "' for reading.");
+  }
+
+  // Read and check the header
+  std::array<std::int64_t, 2> header;
+  MPI_File_read_at_all(fh, 0, header.data(), header.size(), MPI_INT64_T,
+                       MPI_STATUS_IGNORE);
+  if (header[0] != partition_file_magic)
+  {
+    throw std::runtime_error("File '" + filename
+                             + "' is not a partition file.");
+  }
+  if (header[1] != size)
+  {
+    throw std::runtime_error(
+        "Partition file '" + filename + "' was written with "
+        + std::to_string(header[1]) + " ranks, but the communicator has "
+        + std::to_string(size) + " ranks.");
+  }
+
+  // Read the byte offsets of the payload for this rank
+  std::array<std::int64_t, 2> byte_offset;
+  MPI_File_read_at_all(fh, (2 + rank) * sizeof(std::int64_t),
+                       byte_offset.data(), byte_offset.size(), MPI_INT64_T,
+                       MPI_STATUS_IGNORE);
+
+  // Read and unpack the payload
+  const std::int64_t header_bytes = (size + 3) * sizeof(std::int64_t);
+  std::vector<char> buffer(byte_offset[1] - byte_offset[0]);
+  MPI_File_read_at_all(fh, header_bytes + byte_offset[0], buffer.data(),
+                       buffer.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+
+  const char* ptr = buffer.data();
+  std::int64_t num_nodes = 0;
+  std::memcpy(&num_nodes, ptr, sizeof(std::int64_t));
+  ptr += sizeof(std::int64_t);
+  std::vector<std::int32_t> offsets(num_nodes + 1);
+  std::memcpy(offsets.data(), ptr, sizeof(std::int32_t) * offsets.size());
+  ptr += sizeof(std::int32_t) * offsets.size();
+  std::vector<std::int32_t> array(offsets.back());
+  std::memcpy(array.data(), ptr, sizeof(std::int32_t) * array.size());
+
+  return graph::AdjacencyList<std::int32_t>(std::move(array),
+                                            std::move(offsets));
+}
+//-----------------------------------------------------------------------------
 std::vector<std::int64_t> graph::build::compute_ghost_indices(
     MPI_Comm comm, const xtl::span<const std::int64_t>& global_indices,
     const xtl::span<const int>& ghost_owners)
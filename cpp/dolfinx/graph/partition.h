@@ -13,6 +13,7 @@
 #include <dolfinx/graph/AdjacencyList.h>
 #include <functional>
 #include <mpi.h>
+#include <string>
 #include <utility>
 #include <vector>
 #include <xtl/xspan.hpp>
@@ -35,6 +36,28 @@ using partition_fn = std::function<graph::AdjacencyList<std::int32_t>(
     MPI_Comm comm, int nparts, const AdjacencyList<std::int64_t>& local_graph,
     std::int32_t num_ghost_nodes, bool ghosting)>;
 
+/// Signature of functions for computing the parallel partitioning of a
+/// distributed graph with computational weights attached to the graph
+/// nodes
+///
+/// @param comm MPI Communicator that the graph is distributed across
+/// @param nparts Number of partitions to divide graph nodes into
+/// @param local_graph Node connectivity graph
+/// @param node_weights Computational weight(s) for each node in @p
+/// local_graph, row-major with `ncon` weights per node, where `ncon =
+/// node_weights.size() / local_graph.num_nodes()` is the number of
+/// balancing constraints. Empty for an unweighted partitioning.
+/// Support for `ncon > 1` depends on the partitioner.
+/// @param num_ghost_nodes Number of graph nodes appearing in @p
+/// local_graph that are owned on other processes
+/// @param ghosting Flag to enable ghosting of the output node
+/// distribution
+/// @return Destination rank for each input node
+using partition_fn_weighted = std::function<graph::AdjacencyList<std::int32_t>(
+    MPI_Comm comm, int nparts, const AdjacencyList<std::int64_t>& local_graph,
+    const xtl::span<const std::int32_t>& node_weights,
+    std::int32_t num_ghost_nodes, bool ghosting)>;
+
 /// Partition graph across processes using the default graph partitioner
 ///
 /// @param comm MPI Communicator that the graph is distributed across
@@ -50,6 +73,25 @@ partition_graph(MPI_Comm comm, int nparts,
                 const AdjacencyList<std::int64_t>& local_graph,
                 std::int32_t num_ghost_nodes, bool ghosting);
 
+/// Partition graph across processes using the default graph
+/// partitioner, balancing computational weights attached to the graph
+/// nodes
+///
+/// @param comm MPI Communicator that the graph is distributed across
+/// @param nparts Number of partitions to divide graph nodes into
+/// @param local_graph Node connectivity graph
+/// @param node_weights Computational weight(s) for each node (see
+/// partition_fn_weighted). Empty for an unweighted partitioning.
+/// @param num_ghost_nodes Number of graph nodes appearing in @p
+/// local_graph that are owned on other processes
+/// @param ghosting Flag to enable ghosting of the output node
+/// distribution
+/// @return Destination rank for each input node
+AdjacencyList<std::int32_t> partition_graph_weighted(
+    MPI_Comm comm, int nparts, const AdjacencyList<std::int64_t>& local_graph,
+    const xtl::span<const std::int32_t>& node_weights,
+    std::int32_t num_ghost_nodes, bool ghosting);
+
 /// Tools for distributed graphs
 ///
 /// @todo Add a function that sends data to the 'owner'
@@ -71,6 +113,54 @@ std::tuple<graph::AdjacencyList<std::int64_t>, std::vector<int>,
 distribute(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& list,
            const graph::AdjacencyList<std::int32_t>& destinations);
 
+/// Expand the destination ranks of graph nodes to cover @p num_layers
+/// layers of overlap. The input destinations (owning rank first,
+/// followed by ghost ranks) describe a one-layer overlap, e.g. as
+/// produced by a graph partitioner with ghosting enabled. Each
+/// additional layer is added by exchanging the current destination
+/// sets of remote graph neighbors with their storage ranks and taking
+/// the union over the node and its neighbors, so that after expansion
+/// a rank is a destination for every node within @p num_layers edges
+/// of a node it owns.
+///
+/// @param[in] comm MPI Communicator
+/// @param[in] graph Node connectivity graph, with global link indices
+/// @param[in] destinations Destination ranks for each node, with the
+///   owning rank first (one layer of overlap)
+/// @param[in] num_layers Requested number of overlap layers (>= 1)
+/// @return Destination ranks for each node with the owning rank first,
+///   covering @p num_layers layers of overlap
+graph::AdjacencyList<std::int32_t>
+expand_destinations(MPI_Comm comm,
+                    const graph::AdjacencyList<std::int64_t>& graph,
+                    const graph::AdjacencyList<std::int32_t>& destinations,
+                    int num_layers);
+
+/// Write computed destination ranks to a file (collective). The
+/// destination lists of all ranks are stored in a single binary file
+/// using MPI-IO, together with the number of ranks, so that a computed
+/// partition can be reused across runs with the same mesh and rank
+/// count instead of re-running the graph partitioner.
+///
+/// @param[in] comm MPI Communicator
+/// @param[in] filename Name of the file to write. An existing file is
+///   overwritten.
+/// @param[in] destinations Destination ranks for the ith node on this
+///   rank, e.g. as computed by a graph partitioner
+void write_destinations(MPI_Comm comm, const std::string& filename,
+                        const graph::AdjacencyList<std::int32_t>& destinations);
+
+/// Read destination ranks written by write_destinations (collective).
+/// The communicator must have the same number of ranks as the
+/// communicator used when writing the file, and each rank must hold
+/// the same nodes as when the partition was computed.
+///
+/// @param[in] comm MPI Communicator
+/// @param[in] filename Name of the file to read
+/// @return Destination ranks for the ith node on this rank
+graph::AdjacencyList<std::int32_t>
+read_destinations(MPI_Comm comm, const std::string& filename);
+
 /// Compute ghost indices in a global IndexMap space, from a list of arbitrary
 /// global indices, where the ghosts are at the end of the list, and their
 /// owning processes are known.
@@ -5,6 +5,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "partitioners.h"
+#include <algorithm>
 #include <cstdint>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Timer.h>
@@ -12,6 +13,7 @@
 #include <map>
 #include <numeric>
 #include <set>
+#include <stdexcept>
 #include <vector>
 
 #ifdef HAS_PTSCOTCH
@@ -178,55 +180,6 @@ graph::AdjacencyList<std::int32_t> compute_destination_ranks(
 //-----------------------------------------------------------------------------
 #ifdef HAS_PARMETIS
 template <typename T>
-std::vector<int> adaptive_repartition(MPI_Comm comm,
-                                      const graph::AdjacencyList<T>& adj_graph,
-                                      double weight)
-{
-  common::Timer timer(
-      "Compute graph partition (ParMETIS Adaptive Repartition)");
-
-  // Options for ParMETIS
-  idx_t options[4];
-  options[0] = 1;
-  options[1] = 0;
-  options[2] = 15;
-  options[3] = PARMETIS_PSR_UNCOUPLED;
-  // For repartition, PARMETIS_PSR_COUPLED seems to suppress all
-  // migration if already balanced.  Try PARMETIS_PSR_UNCOUPLED for
-  // better edge cut.
-
-  common::Timer timer1("ParMETIS: call ParMETIS_V3_AdaptiveRepart");
-  real_t _itr = weight;
-  std::vector<idx_t> part(adj_graph.num_nodes());
-  std::vector<idx_t> vsize(part.size(), 1);
-  assert(!part.empty());
-
-  // Number of partitions (one for each process)
-  idx_t nparts = dolfinx::MPI::size(comm);
-
-  // Remaining ParMETIS parameters
-  idx_t ncon = 1;
-  idx_t* elmwgt = nullptr;
-  idx_t wgtflag = 0;
-  idx_t edgecut = 0;
-  idx_t numflag = 0;
-  std::vector<real_t> tpwgts(ncon * nparts, 1.0 / static_cast<real_t>(nparts));
-  std::vector<real_t> ubvec(ncon, 1.05);
-
-  // Call ParMETIS to repartition graph
-  int err = ParMETIS_V3_AdaptiveRepart(
-      adj_graph.node_distribution().data(), adj_graph.nodes().data(),
-      adj_graph.edges().data(), elmwgt, nullptr, vsize.data(), &wgtflag,
-      &numflag, &ncon, &nparts, tpwgts.data(), ubvec.data(), &_itr, options,
-      &edgecut, part.data(), &comm);
-  assert(err == METIS_OK);
-  timer1.stop();
-
-  // Copy cell partition data and return
-  return std::vector<int>(part.begin(), part.end());
-}
-//-----------------------------------------------------------------------------
-template <typename T>
 std::vector<int> refine(MPI_Comm comm, const graph::AdjacencyList<T>& adj_graph)
 {
   common::Timer timer("Compute graph partition (ParMETIS Refine)");
@@ -281,13 +234,15 @@ std::vector<int> refine(MPI_Comm comm, const graph::AdjacencyList<T>& adj_graph)
 
 //-----------------------------------------------------------------------------
 #ifdef HAS_PTSCOTCH
-graph::partition_fn graph::scotch::partitioner(graph::scotch::strategy strategy,
-                                               double imbalance, int seed)
+graph::partition_fn_weighted
+graph::scotch::weighted_partitioner(graph::scotch::strategy strategy,
+                                    double imbalance, int seed)
 {
-  return
-      [imbalance, strategy, seed](MPI_Comm comm, int nparts,
-                                  const AdjacencyList<std::int64_t>& graph,
-                                  std::int32_t num_ghost_nodes, bool ghosting)
+  return [imbalance, strategy,
+          seed](MPI_Comm comm, int nparts,
+                const AdjacencyList<std::int64_t>& graph,
+                const xtl::span<const std::int32_t>& node_weights,
+                std::int32_t num_ghost_nodes, bool ghosting)
   {
     LOG(INFO) << "Compute graph partition using PT-SCOTCH";
     common::Timer timer("Compute graph partition (SCOTCH)");
@@ -307,14 +262,28 @@ graph::partition_fn graph::scotch::partitioner(graph::scotch::strategy strategy,
     if (err != 0)
       throw std::runtime_error("Error initializing SCOTCH graph");
 
-    // FIXME: If the nodes have weights but this rank has no nodes, then
-    //        SCOTCH may deadlock since vload.data() will be nullptr on
-    //        this rank but not null on all other ranks.
-    // Handle node weights (disabled for now)
-    std::vector<SCOTCH_Num> node_weights;
+    // SCOTCH balances a single constraint, so exactly one weight per
+    // node is expected
+    if (!node_weights.empty()
+        and node_weights.size() != std::size_t(graph.num_nodes()))
+    {
+      throw std::runtime_error("SCOTCH balances a single constraint: pass "
+                               "exactly one weight per graph node.");
+    }
+
+    // Copy node weights to the SCOTCH integer type. SCOTCH can
+    // deadlock if the weight array is null on some ranks but not on
+    // others, which happens naturally when a rank has no nodes, so
+    // agree globally on whether the graph is weighted and keep at
+    // least one (unread) entry on ranks without nodes.
+    std::int8_t weighted = node_weights.empty() ? 0 : 1;
+    MPI_Allreduce(MPI_IN_PLACE, &weighted, 1, MPI_INT8_T, MPI_MAX, comm);
     std::vector<SCOTCH_Num> vload;
-    if (!node_weights.empty())
+    if (weighted)
+    {
       vload.assign(node_weights.begin(), node_weights.end());
+      vload.resize(std::max<std::size_t>(1, vload.size()), 1);
+    }
 
     // Set seed and reset SCOTCH random number generator to produce
     // deterministic partitions on repeated calls
@@ -326,7 +295,8 @@ graph::partition_fn graph::scotch::partitioner(graph::scotch::strategy strategy,
     common::Timer timer1("SCOTCH: call SCOTCH_dgraphBuild");
     err = SCOTCH_dgraphBuild(
         &dgrafdat, baseval, graph.num_nodes(), graph.num_nodes(),
-        vertloctab.data(), nullptr, vload.data(), nullptr, edgeloctab.size(),
+        vertloctab.data(), nullptr, weighted ? vload.data() : nullptr, nullptr,
+        edgeloctab.size(),
         edgeloctab.size(), edgeloctab.data(), nullptr, nullptr);
     if (err != 0)
       throw std::runtime_error("Error building SCOTCH graph");
@@ -463,14 +433,29 @@ graph::partition_fn graph::scotch::partitioner(graph::scotch::strategy strategy,
                                               std::move(offsets));
   };
 }
+//-----------------------------------------------------------------------------
+graph::partition_fn graph::scotch::partitioner(graph::scotch::strategy strategy,
+                                               double imbalance, int seed)
+{
+  return [p = scotch::weighted_partitioner(strategy, imbalance, seed)](
+             MPI_Comm comm, int nparts,
+             const AdjacencyList<std::int64_t>& graph,
+             std::int32_t num_ghost_nodes, bool ghosting)
+  {
+    return p(comm, nparts, graph, xtl::span<const std::int32_t>(),
+             num_ghost_nodes, ghosting);
+  };
+}
 #endif
 //-----------------------------------------------------------------------------
 #ifdef HAS_PARMETIS
-graph::partition_fn graph::parmetis::partitioner(double imbalance,
-                                                 std::array<int, 3> options)
+graph::partition_fn_weighted
+graph::parmetis::weighted_partitioner(double imbalance,
+                                      std::array<int, 3> options)
 {
   return [imbalance, options](MPI_Comm comm, idx_t nparts,
                               const graph::AdjacencyList<std::int64_t>& graph,
+                              const xtl::span<const std::int32_t>& node_weights,
                               std::int32_t, bool ghosting)
   {
     LOG(INFO) << "Compute graph partition using ParMETIS";
@@ -486,13 +471,24 @@ graph::partition_fn graph::parmetis::partitioner(double imbalance,
     // Options for ParMETIS
     std::array<idx_t, 3> _options = {options[0], options[1], options[2]};
 
-    // Data for  ParMETIS
+    // Data for ParMETIS, with the number of balancing constraints
+    // (ncon) deduced from the node weights layout
+    std::vector<idx_t> vwgt(node_weights.begin(), node_weights.end());
     idx_t ncon = 1;
-    idx_t* elmwgt = nullptr;
     idx_t wgtflag(0), edgecut(0), numflag(0);
+    if (!vwgt.empty())
+    {
+      if (vwgt.size() % graph.num_nodes() != 0)
+      {
+        throw std::runtime_error("Number of node weights must be a multiple "
+                                 "of the number of graph nodes.");
+      }
+      ncon = vwgt.size() / graph.num_nodes();
+      wgtflag = 2; // Weights on graph nodes only
+    }
     std::vector<real_t> tpwgts(ncon * nparts,
                                1.0 / static_cast<real_t>(nparts));
-    std::array<real_t, 1> ubvec = {static_cast<real_t>(imbalance)};
+    std::vector<real_t> ubvec(ncon, static_cast<real_t>(imbalance));
 
     // Build adjacency list data
     common::Timer timer1("ParMETIS: build adjacency data");
@@ -504,9 +500,10 @@ graph::partition_fn graph::parmetis::partitioner(double imbalance,
     common::Timer timer2("ParMETIS: call ParMETIS_V3_PartKway");
     std::vector<idx_t> part(graph.num_nodes());
     int err = ParMETIS_V3_PartKway(
-        node_disp.data(), _offsets.data(), array.data(), elmwgt, nullptr,
-        &wgtflag, &numflag, &ncon, &nparts, tpwgts.data(), ubvec.data(),
-        _options.data(), &edgecut, part.data(), &comm);
+        node_disp.data(), _offsets.data(), array.data(),
+        vwgt.empty() ? nullptr : vwgt.data(), nullptr, &wgtflag, &numflag,
+        &ncon, &nparts, tpwgts.data(), ubvec.data(), _options.data(), &edgecut,
+        part.data(), &comm);
     if (err != METIS_OK)
     {
       throw std::runtime_error("ParMETIS_V3_PartKway failed. Error code: "
@@ -524,29 +521,116 @@ graph::partition_fn graph::parmetis::partitioner(double imbalance,
   };
 }
 //-----------------------------------------------------------------------------
+graph::partition_fn graph::parmetis::partitioner(double imbalance,
+                                                 std::array<int, 3> options)
+{
+  return [p = parmetis::weighted_partitioner(imbalance, options)](
+             MPI_Comm comm, int nparts,
+             const graph::AdjacencyList<std::int64_t>& graph,
+             std::int32_t num_ghost_nodes, bool ghosting)
+  {
+    return p(comm, nparts, graph, xtl::span<const std::int32_t>(),
+             num_ghost_nodes, ghosting);
+  };
+}
+//-----------------------------------------------------------------------------
+graph::partition_fn graph::parmetis::adaptive_repartitioner(double imbalance,
+                                                            double itr)
+{
+  return [imbalance, itr](MPI_Comm comm, idx_t nparts,
+                          const graph::AdjacencyList<std::int64_t>& graph,
+                          std::int32_t, bool ghosting)
+  {
+    LOG(INFO) << "Compute graph repartition using ParMETIS AdaptiveRepart";
+    common::Timer timer("Compute graph partition (ParMETIS AdaptiveRepart)");
+
+    if (graph.num_nodes() == 0)
+    {
+      throw std::runtime_error(
+          "ParMETIS cannot partition a graph where one of the MPI ranks has no "
+          "data. Try PT-SCOTCH or KaHIP instead.");
+    }
+
+    // Options for ParMETIS repartitioning. For repartition,
+    // PARMETIS_PSR_COUPLED seems to suppress all migration if already
+    // balanced. Try PARMETIS_PSR_UNCOUPLED for better edge cut.
+    std::array<idx_t, 4> _options = {1, 0, 15, PARMETIS_PSR_UNCOUPLED};
+
+    // Data for ParMETIS
+    idx_t ncon = 1;
+    idx_t wgtflag(0), edgecut(0), numflag(0);
+    std::vector<real_t> tpwgts(ncon * nparts,
+                               1.0 / static_cast<real_t>(nparts));
+    std::array<real_t, 1> ubvec = {static_cast<real_t>(imbalance)};
+    real_t _itr = itr;
+    std::vector<idx_t> vsize(graph.num_nodes(), 1);
+
+    // Build adjacency list data
+    common::Timer timer1("ParMETIS: build adjacency data");
+    auto [node_disp, array, _offsets]
+        = build_adjacency_data<idx_t>(comm, graph);
+    timer1.stop();
+
+    // The current ownership is the starting partition: node i is
+    // currently held by this rank
+    std::vector<idx_t> part(graph.num_nodes(), dolfinx::MPI::rank(comm));
+
+    // Call ParMETIS to repartition graph
+    common::Timer timer2("ParMETIS: call ParMETIS_V3_AdaptiveRepart");
+    int err = ParMETIS_V3_AdaptiveRepart(
+        node_disp.data(), _offsets.data(), array.data(), nullptr, vsize.data(),
+        nullptr, &wgtflag, &numflag, &ncon, &nparts, tpwgts.data(),
+        ubvec.data(), &_itr, _options.data(), &edgecut, part.data(), &comm);
+    if (err != METIS_OK)
+    {
+      throw std::runtime_error("ParMETIS_V3_AdaptiveRepart failed. Error code: "
+                               + std::to_string(err));
+    }
+    timer2.stop();
+
+    if (ghosting)
+      return compute_destination_ranks(comm, graph, node_disp, part);
+    else
+    {
+      return build_adjacency_list<std::int32_t>(
+          std::vector<std::int32_t>(part.begin(), part.end()), 1);
+    }
+  };
+}
+//-----------------------------------------------------------------------------
 #endif
 
 #ifdef HAS_KAHIP
 
 //----------------------------------------------------------------------------
-std::function<graph::AdjacencyList<std::int32_t>(
-    MPI_Comm, int, const graph::AdjacencyList<std::int64_t>&, std::int32_t,
-    bool)>
-graph::kahip::partitioner(int mode, int seed, double imbalance,
-                          bool suppress_output)
+graph::partition_fn_weighted
+graph::kahip::weighted_partitioner(int mode, int seed, double imbalance,
+                                   bool suppress_output)
 {
-  return [mode, seed, imbalance,
-          suppress_output](MPI_Comm comm, int nparts,
-                           const graph::AdjacencyList<std::int64_t>& graph,
-                           std::int32_t, bool ghosting)
+  return [mode, seed, imbalance, suppress_output](
+             MPI_Comm comm, int nparts,
+             const graph::AdjacencyList<std::int64_t>& graph,
+             const xtl::span<const std::int32_t>& node_weights, std::int32_t,
+             bool ghosting)
   {
     LOG(INFO) << "Compute graph partition using (parallel) KaHIP";
 
     common::Timer timer("Compute graph partition (KaHIP)");
 
-    // Graph does not have vertex or adjacency weights, so we use null
-    // pointers as arguments
-    unsigned long long *vwgt(nullptr), *adjcwgt(nullptr);
+    // KaHIP balances a single constraint, so exactly one weight per
+    // node is expected
+    if (!node_weights.empty()
+        and node_weights.size() != std::size_t(graph.num_nodes()))
+    {
+      throw std::runtime_error("KaHIP balances a single constraint: pass "
+                               "exactly one weight per graph node.");
+    }
+
+    // Copy node weights to the KaHIP integer type; adjacency (edge)
+    // weights are not used
+    std::vector<unsigned long long> vwgt(node_weights.begin(),
+                                         node_weights.end());
+    unsigned long long* adjcwgt = nullptr;
 
     // Build adjacency list data
     common::Timer timer1("KaHIP: build adjacency data");
@@ -559,9 +643,10 @@ graph::kahip::partitioner(int mode, int seed, double imbalance,
     std::vector<unsigned long long> part(graph.num_nodes());
     int edgecut = 0;
     double _imbalance = imbalance;
-    ParHIPPartitionKWay(node_disp.data(), offsets.data(), array.data(), vwgt,
-                        adjcwgt, &nparts, &_imbalance, suppress_output, seed,
-                        mode, &edgecut, part.data(), &comm);
+    ParHIPPartitionKWay(node_disp.data(), offsets.data(), array.data(),
+                        vwgt.empty() ? nullptr : vwgt.data(), adjcwgt, &nparts,
+                        &_imbalance, suppress_output, seed, mode, &edgecut,
+                        part.data(), &comm);
     timer2.stop();
 
     if (ghosting)
@@ -574,4 +659,349 @@ graph::kahip::partitioner(int mode, int seed, double imbalance,
   };
 }
 //----------------------------------------------------------------------------
+std::function<graph::AdjacencyList<std::int32_t>(
+    MPI_Comm, int, const graph::AdjacencyList<std::int64_t>&, std::int32_t,
+    bool)>
+graph::kahip::partitioner(int mode, int seed, double imbalance,
+                          bool suppress_output)
+{
+  return [p = kahip::weighted_partitioner(mode, seed, imbalance,
+                                          suppress_output)](
+             MPI_Comm comm, int nparts,
+             const graph::AdjacencyList<std::int64_t>& graph,
+             std::int32_t num_ghost_nodes, bool ghosting)
+  {
+    return p(comm, nparts, graph, xtl::span<const std::int32_t>(),
+             num_ghost_nodes, ghosting);
+  };
+}
+//----------------------------------------------------------------------------
 #endif
+//----------------------------------------------------------------------------
+graph::partition_fn graph::hierarchical_partitioner(partition_fn coarse,
+                                                    partition_fn fine)
+{
+  return [coarse = std::move(coarse), fine = std::move(fine)](
+             MPI_Comm comm, int nparts,
+             const graph::AdjacencyList<std::int64_t>& graph,
+             std::int32_t num_ghost_nodes, bool ghosting)
+  {
+    common::Timer timer("Compute graph partition (hierarchical)");
+
+    const int size = dolfinx::MPI::size(comm);
+    const int mpi_rank = dolfinx::MPI::rank(comm);
+    if (nparts != size)
+    {
+      throw std::runtime_error(
+          "Hierarchical partitioning requires one partition per rank.");
+    }
+
+    // Identify the compute node of each rank via the shared-memory
+    // split. Nodes are numbered by their lowest global rank.
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, mpi_rank, MPI_INFO_NULL,
+                        &node_comm);
+    const int node_size = dolfinx::MPI::size(node_comm);
+    int node_root = mpi_rank;
+    MPI_Bcast(&node_root, 1, MPI_INT, 0, node_comm);
+    std::vector<int> rank_to_root(size);
+    MPI_Allgather(&node_root, 1, MPI_INT, rank_to_root.data(), 1, MPI_INT,
+                  comm);
+    std::vector<int> roots = rank_to_root;
+    std::sort(roots.begin(), roots.end());
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    const int num_nodes = roots.size();
+
+    // A single node (or one rank per node): one level suffices
+    if (num_nodes == 1 or num_nodes == size)
+    {
+      MPI_Comm_free(&node_comm);
+      const partition_fn& p = (num_nodes == 1) ? fine : coarse;
+      return p(comm, nparts, graph, num_ghost_nodes, ghosting);
+    }
+
+    // Ranks of each node, ascending
+    std::vector<std::vector<int>> node_ranks(num_nodes);
+    for (int r = 0; r < size; ++r)
+    {
+      const auto it
+          = std::lower_bound(roots.begin(), roots.end(), rank_to_root[r]);
+      node_ranks[std::distance(roots.begin(), it)].push_back(r);
+    }
+    const int node_id = std::distance(
+        roots.begin(),
+        std::lower_bound(roots.begin(), roots.end(), rank_to_root[mpi_rank]));
+
+    // ---------
+    // Level 1: partition across the compute nodes, minimizing the
+    // inter-node cut
+    const graph::AdjacencyList<std::int32_t> node_dest
+        = coarse(comm, num_nodes, graph, num_ghost_nodes, false);
+    assert(node_dest.num_nodes() == graph.num_nodes());
+
+    // The global numbering of the input graph nodes is contiguous by
+    // rank: compute the rank offsets for owner lookups
+    std::vector<std::int64_t> cell_disp(size + 1, 0);
+    const std::int64_t num_local = graph.num_nodes();
+    MPI_Allgather(&num_local, 1, MPI_INT64_T, cell_disp.data() + 1, 1,
+                  MPI_INT64_T, comm);
+    std::partial_sum(cell_disp.begin(), cell_disp.end(), cell_disp.begin());
+    const std::int64_t offset = cell_disp[mpi_rank];
+    const auto owner_of = [&cell_disp](std::int64_t gid)
+    {
+      return std::distance(cell_disp.begin(),
+                           std::upper_bound(cell_disp.begin(), cell_disp.end(),
+                                            gid))
+             - 1;
+    };
+
+    // Exchange per-destination send buffers with the NBX sparse
+    // all-to-all
+    const auto exchange
+        = [comm](const std::map<int, std::vector<std::int64_t>>& send)
+    {
+      std::vector<int> dest;
+      std::vector<std::int64_t> data;
+      std::vector<std::int32_t> offsets = {0};
+      for (const auto& [d, buffer] : send)
+      {
+        dest.push_back(d);
+        data.insert(data.end(), buffer.begin(), buffer.end());
+        offsets.push_back(data.size());
+      }
+      return dolfinx::MPI::sparse_all_to_all(
+          comm, dest,
+          graph::AdjacencyList<std::int64_t>(std::move(data),
+                                             std::move(offsets)));
+    };
+
+    // ---------
+    // Move each graph node, with its links, to a rank of its target
+    // compute node (round-robin over the node's ranks for balance,
+    // staggered by source rank). Rows: [gid, num_links, links...].
+    std::vector<int> target(num_local), pos_in_target(num_local);
+    std::vector<int> rr(num_nodes, mpi_rank);
+    std::map<int, std::vector<std::int64_t>> send;
+    std::map<int, int> rows_sent;
+    for (std::int32_t i = 0; i < num_local; ++i)
+    {
+      const int g = node_dest.links(i)[0];
+      assert(g >= 0 and g < num_nodes);
+      const int t = node_ranks[g][rr[g]++ % node_ranks[g].size()];
+      auto links = graph.links(i);
+      std::vector<std::int64_t>& buffer = send[t];
+      buffer.push_back(offset + i);
+      buffer.push_back(links.size());
+      buffer.insert(buffer.end(), links.begin(), links.end());
+      target[i] = t;
+      pos_in_target[i] = rows_sent[t]++;
+    }
+    const auto [held_src, held] = exchange(send);
+    send.clear();
+
+    // Unpack the received rows. All received graph nodes belong to
+    // this rank's compute node.
+    std::vector<std::int64_t> held_gid, held_links;
+    std::vector<std::int32_t> held_offsets = {0};
+    std::vector<std::int32_t> rows_per_block(held.num_nodes(), 0);
+    for (int b = 0; b < held.num_nodes(); ++b)
+    {
+      auto block = held.links(b);
+      for (std::size_t i = 0; i < block.size();)
+      {
+        held_gid.push_back(block[i++]);
+        const std::int64_t nl = block[i++];
+        held_links.insert(held_links.end(), std::next(block.begin(), i),
+                          std::next(block.begin(), i + nl));
+        i += nl;
+        held_offsets.push_back(held_links.size());
+        rows_per_block[b]++;
+      }
+    }
+    const std::int64_t num_held = held_gid.size();
+
+    // Contiguous renumbering of this node's graph nodes across the
+    // ranks of the node
+    std::int64_t held_offset = 0;
+    MPI_Exscan(&num_held, &held_offset, 1, MPI_INT64_T, MPI_SUM, node_comm);
+
+    // Report the new global index of every received graph node back to
+    // its original owner, preserving the block row order
+    std::map<int, std::vector<std::int64_t>> reply;
+    std::int64_t row = 0;
+    for (int b = 0; b < held.num_nodes(); ++b)
+    {
+      std::vector<std::int64_t>& buffer = reply[held_src[b]];
+      for (std::int32_t k = 0; k < rows_per_block[b]; ++k)
+        buffer.push_back(held_offset + row++);
+    }
+    const auto [reply_src, reply_data] = exchange(reply);
+
+    // new_gid[i] for own graph node i, unpacked via the recorded
+    // (target rank, position) of each sent row
+    std::vector<int> block_of(size, -1);
+    for (std::size_t b = 0; b < reply_src.size(); ++b)
+      block_of[reply_src[b]] = b;
+    std::vector<std::int64_t> new_gid(num_local);
+    for (std::int32_t i = 0; i < num_local; ++i)
+    {
+      assert(block_of[target[i]] >= 0);
+      new_gid[i] = reply_data.links(block_of[target[i]])[pos_in_target[i]];
+    }
+
+    // Resolve the (node, new index) of every link endpoint through
+    // the original owner of the endpoint
+    std::vector<std::int64_t> query_gids(held_links);
+    std::sort(query_gids.begin(), query_gids.end());
+    query_gids.erase(std::unique(query_gids.begin(), query_gids.end()),
+                     query_gids.end());
+    std::map<int, std::vector<std::int64_t>> query;
+    for (std::int64_t gid : query_gids)
+      query[owner_of(gid)].push_back(gid);
+    const auto [q_src, q_data] = exchange(query);
+
+    std::map<int, std::vector<std::int64_t>> answer;
+    for (std::size_t b = 0; b < q_src.size(); ++b)
+    {
+      std::vector<std::int64_t>& buffer = answer[q_src[b]];
+      for (std::int64_t gid : q_data.links(b))
+      {
+        const std::int32_t i = gid - offset;
+        assert(i >= 0 and i < num_local);
+        buffer.push_back(node_dest.links(i)[0]);
+        buffer.push_back(new_gid[i]);
+      }
+    }
+    const auto [a_src, a_data] = exchange(answer);
+
+    // Queries were grouped by ascending owner rank and global ids
+    // are contiguous by owner, so the concatenated replies align
+    // with the sorted query_gids
+    assert(std::size_t(a_data.offsets().back())
+           == 2 * query_gids.size());
+    const std::vector<std::int64_t>& a_arr = a_data.array();
+    const auto lookup = [&query_gids, &a_arr](std::int64_t gid)
+    {
+      auto it
+          = std::lower_bound(query_gids.begin(), query_gids.end(), gid);
+      assert(it != query_gids.end() and *it == gid);
+      const std::size_t k = std::distance(query_gids.begin(), it);
+      return std::pair(int(a_arr[2 * k]), a_arr[2 * k + 1]);
+    };
+
+    // ---------
+    // Level 2: partition this node's block (links to other nodes are
+    // the coarse cut and are dropped) across the ranks of the node
+    std::vector<std::int64_t> sub_links;
+    std::vector<std::int32_t> sub_offsets = {0};
+    std::set<std::int64_t> sub_ghosts;
+    for (std::int64_t i = 0; i < num_held; ++i)
+    {
+      for (std::int32_t k = held_offsets[i]; k < held_offsets[i + 1]; ++k)
+      {
+        const auto [g, gid1] = lookup(held_links[k]);
+        if (g == node_id)
+        {
+          sub_links.push_back(gid1);
+          if (gid1 < held_offset or gid1 >= held_offset + num_held)
+            sub_ghosts.insert(gid1);
+        }
+      }
+      sub_offsets.push_back(sub_links.size());
+    }
+    const graph::AdjacencyList<std::int32_t> fine_dest
+        = fine(node_comm, node_size,
+               graph::AdjacencyList<std::int64_t>(std::move(sub_links),
+                                                  std::move(sub_offsets)),
+               sub_ghosts.size(), false);
+    assert(fine_dest.num_nodes() == num_held);
+
+    // Return the final destination rank of each held graph node to
+    // its original owner
+    std::map<int, std::vector<std::int64_t>> result;
+    row = 0;
+    for (int b = 0; b < held.num_nodes(); ++b)
+    {
+      std::vector<std::int64_t>& buffer = result[held_src[b]];
+      for (std::int32_t k = 0; k < rows_per_block[b]; ++k)
+      {
+        const int part = fine_dest.links(row++)[0];
+        assert(part >= 0 and part < node_size);
+        buffer.push_back(node_ranks[node_id][part]);
+      }
+    }
+    const auto [result_src, result_data] = exchange(result);
+
+    std::vector<int> result_block_of(size, -1);
+    for (std::size_t b = 0; b < result_src.size(); ++b)
+      result_block_of[result_src[b]] = b;
+    std::vector<std::int32_t> dest(num_local);
+    for (std::int32_t i = 0; i < num_local; ++i)
+    {
+      assert(result_block_of[target[i]] >= 0);
+      dest[i] = result_data.links(
+          result_block_of[target[i]])[pos_in_target[i]];
+    }
+
+    MPI_Comm_free(&node_comm);
+
+    if (!ghosting)
+    {
+      return graph::AdjacencyList<std::int32_t>(std::move(dest));
+    }
+
+    // Ghosting: each graph node is additionally sent to the
+    // destination ranks of its graph neighbors. Fetch the neighbor
+    // destinations through the original owners.
+    std::vector<std::int64_t> ghost_gids(graph.array().begin(),
+                                         graph.array().end());
+    std::sort(ghost_gids.begin(), ghost_gids.end());
+    ghost_gids.erase(std::unique(ghost_gids.begin(), ghost_gids.end()),
+                     ghost_gids.end());
+    std::map<int, std::vector<std::int64_t>> gquery;
+    for (std::int64_t gid : ghost_gids)
+      gquery[owner_of(gid)].push_back(gid);
+    const auto [gq_src, gq_data] = exchange(gquery);
+    std::map<int, std::vector<std::int64_t>> ganswer;
+    for (std::size_t b = 0; b < gq_src.size(); ++b)
+    {
+      std::vector<std::int64_t>& buffer = ganswer[gq_src[b]];
+      for (std::int64_t gid : gq_data.links(b))
+        buffer.push_back(dest[gid - offset]);
+    }
+    const auto [ga_src, ga_data] = exchange(ganswer);
+    assert(std::size_t(ga_data.offsets().back()) == ghost_gids.size());
+    const std::vector<std::int64_t>& ga_arr = ga_data.array();
+
+    std::vector<std::int32_t> gdata;
+    std::vector<std::int32_t> goffsets = {0};
+    std::vector<std::int32_t> row_dest;
+    for (std::int32_t i = 0; i < num_local; ++i)
+    {
+      row_dest.clear();
+      for (std::int64_t gid : graph.links(i))
+      {
+        auto it = std::lower_bound(ghost_gids.begin(), ghost_gids.end(),
+                                   gid);
+        assert(it != ghost_gids.end() and *it == gid);
+        row_dest.push_back(
+            ga_arr[std::distance(ghost_gids.begin(), it)]);
+      }
+      std::sort(row_dest.begin(), row_dest.end());
+      row_dest.erase(std::unique(row_dest.begin(), row_dest.end()),
+                     row_dest.end());
+
+      gdata.push_back(dest[i]);
+      for (std::int32_t d : row_dest)
+      {
+        if (d != dest[i])
+          gdata.push_back(d);
+      }
+      goffsets.push_back(gdata.size());
+    }
+
+    return graph::AdjacencyList<std::int32_t>(std::move(gdata),
+                                              std::move(goffsets));
+  };
+}
+//----------------------------------------------------------------------------
@@ -36,6 +36,20 @@ enum class strategy
 graph::partition_fn partitioner(scotch::strategy strategy = strategy::none,
                                 double imbalance = 0.025, int seed = 0);
 
+/// Create a graph partitioning function that uses SCOTCH and balances
+/// computational weights attached to the graph nodes. SCOTCH balances
+/// a single constraint, so exactly one weight per node must be
+/// supplied (or no weights at all for an unweighted partitioning).
+///
+/// @param[in] strategy The SCOTCH strategy
+/// @param[in] imbalance The allowable imbalance (between 0 and 1). The
+/// smaller value the more balanced the partitioning must be.
+/// @param[in] seed Random number generator seed
+/// @return A weighted graph partitioning function
+graph::partition_fn_weighted
+weighted_partitioner(scotch::strategy strategy = strategy::none,
+                     double imbalance = 0.025, int seed = 0);
+
 #endif
 
 } // namespace scotch
@@ -51,6 +65,36 @@ namespace parmetis
 graph::partition_fn partitioner(double imbalance = 1.02,
                                 std::array<int, 3> options = {0, 0, 0});
 
+/// Create a graph partitioning function that uses ParMETIS and
+/// balances computational weights attached to the graph nodes.
+/// Multiple balancing constraints are supported: pass `ncon` weights
+/// per node (row-major), e.g. a memory and a flop estimate, and
+/// ParMETIS balances every constraint to within @p imbalance.
+///
+/// @param[in] imbalance The allowable imbalance for each constraint
+/// @param[in] options The ParMETIS options. See ParMETIS manual for
+/// details.
+/// @return A weighted graph partitioning function
+graph::partition_fn_weighted
+weighted_partitioner(double imbalance = 1.02,
+                     std::array<int, 3> options = {0, 0, 0});
+
+/// Create a graph partitioning function that uses ParMETIS adaptive
+/// repartitioning (diffusion). The current distribution of the graph
+/// across ranks is taken as the starting partition, and the result
+/// trades partition quality against data migration volume, so after an
+/// incremental change such as adaptive refinement only a small
+/// fraction of the nodes move. Repartitioning from scratch, by
+/// contrast, migrates nearly every node.
+///
+/// @param[in] imbalance The allowable imbalance
+/// @param[in] itr Ratio of inter-process communication cost to data
+/// redistribution cost. Small values minimize migration volume, large
+/// values favour edge cut (see the ParMETIS manual).
+/// @return A graph partitioning function
+graph::partition_fn adaptive_repartitioner(double imbalance = 1.02,
+                                           double itr = 1000.0);
+
 #endif
 } // namespace parmetis
 
@@ -71,7 +115,42 @@ graph::partition_fn partitioner(int mode = 1, int seed = 1,
                                 double imbalance = 0.03,
                                 bool suppress_output = true);
 
+/// Create a graph partitioning function that uses KaHIP and balances
+/// computational weights attached to the graph nodes. KaHIP balances a
+/// single constraint, so exactly one weight per node must be supplied
+/// (or no weights at all for an unweighted partitioning).
+///
+/// @param[in] mode The KaHiP partitioning mode (see
+/// https://github.com/KaHIP/KaHIP/blob/master/parallel/parallel_src/interface/parhip_interface.h)
+/// @param[in] seed The KaHiP random number generator seed
+/// @param[in] imbalance The allowable imbalance
+/// @param[in] suppress_output Suppresses KaHIP output if true
+/// @return A weighted graph partitioning function
+graph::partition_fn_weighted weighted_partitioner(int mode = 1, int seed = 1,
+                                                  double imbalance = 0.03,
+                                                  bool suppress_output = true);
+
 #endif
 } // namespace kahip
 
+/// Create a two-level, node-aware graph partitioning function. The
+/// graph is first partitioned across the compute nodes of the
+/// communicator (detected with the shared-memory split), minimizing
+/// the inter-node edge cut specifically, and each node's block is then
+/// partitioned across the ranks of that node. Halo exchange between
+/// nodes is governed by the coarse cut alone, so the inter-node
+/// communication volume is typically much smaller than with a flat
+/// k-way partitioning into ranks.
+///
+/// The returned function requires one partition per rank of the
+/// communicator (nparts == communicator size). With ghosting enabled,
+/// each node of the graph is additionally sent to the destination
+/// ranks of its graph neighbors.
+///
+/// @param[in] coarse Partitioner used across compute nodes
+/// @param[in] fine Partitioner used across the ranks within a node
+/// @return A graph partitioning function
+graph::partition_fn hierarchical_partitioner(partition_fn coarse,
+                                             partition_fn fine);
+
 } // namespace dolfinx::graph
\ No newline at end of file
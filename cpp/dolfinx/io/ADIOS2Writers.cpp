@@ -48,13 +48,46 @@ adios2::Attribute<T> define_attribute(adios2::IO& io, const std::string& name,
 }
 //-----------------------------------------------------------------------------
 
+/// Attach the configured compression operator to a variable. The lossy
+/// operators (zfp, sz) support floating-point data only; integer
+/// (topology) arrays are compressed losslessly when blosc is selected
+/// and are otherwise written uncompressed. Operators act on the local
+/// (per-rank) block of the variable, which is contiguous, so no
+/// repacking is required.
+template <class T>
+void add_compression(adios2::Variable<T>& v, const ADIOS2Options& options)
+{
+  if (options.compression.empty())
+    return;
+
+  if (options.compression == "zfp" or options.compression == "sz")
+  {
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      v.AddOperation(
+          options.compression,
+          {{"accuracy", std::to_string(options.compression_accuracy)}});
+    }
+  }
+  else if (options.compression == "blosc")
+    v.AddOperation("blosc", {{"clevel", "9"}});
+  else
+  {
+    throw std::runtime_error("Unknown ADIOS2 compression operator: "
+                             + options.compression);
+  }
+}
+//-----------------------------------------------------------------------------
+
 /// Safe definition of a variable. First check if it has already been
-/// defined and return it. If not defined create new variable.
+/// defined and return it. If not defined create new variable, attaching
+/// the compression operator (if any) from @p options.
 template <class T>
 adios2::Variable<T> define_variable(adios2::IO& io, const std::string& name,
                                     const adios2::Dims& shape = adios2::Dims(),
                                     const adios2::Dims& start = adios2::Dims(),
-                                    const adios2::Dims& count = adios2::Dims())
+                                    const adios2::Dims& count = adios2::Dims(),
+                                    const ADIOS2Options* options = nullptr)
 {
   if (adios2::Variable<T> v = io.InquireVariable<T>(name); v)
   {
@@ -63,7 +96,30 @@ adios2::Variable<T> define_variable(adios2::IO& io, const std::string& name,
     return v;
   }
   else
-    return io.DefineVariable<T>(name, shape, start, count);
+  {
+    adios2::Variable<T> v = io.DefineVariable<T>(name, shape, start, count);
+    if (options)
+      add_compression(v, *options);
+    return v;
+  }
+}
+//-----------------------------------------------------------------------------
+
+/// "Put" a buffer. Without staging the Put is synchronous and the
+/// buffer can be re-used immediately. With staging the buffer is moved
+/// into the staging pool, which keeps the data alive for a deferred Put
+/// that is drained by EndStep.
+template <typename T>
+void put_buffer(adios2::Engine& engine, adios2::Variable<T>& v,
+                std::vector<T>&& buffer, std::vector<std::vector<T>>* staging)
+{
+  if (staging)
+  {
+    staging->push_back(std::move(buffer));
+    engine.Put<T>(v, staging->back().data(), adios2::Mode::Deferred);
+  }
+  else
+    engine.Put<T>(v, buffer.data(), adios2::Mode::Sync);
 }
 //-----------------------------------------------------------------------------
 
@@ -124,9 +180,14 @@ xt::xtensor<std::int64_t, 2> extract_vtk_connectivity(const mesh::Mesh& mesh)
 /// @param[in] io The ADIOS2 io object
 /// @param[in] engine The ADIOS2 engine object
 /// @param[in] u The function
+/// @param[in] options Output pipeline options
+/// @param[in] staging Staging buffers for deferred Puts (nullptr for
+/// synchronous output)
 template <typename Scalar>
 void vtx_write_data(adios2::IO& io, adios2::Engine& engine,
-                    const fem::Function<Scalar>& u)
+                    const fem::Function<Scalar>& u,
+                    const ADIOS2Options& options,
+                    ADIOS2Writer::StagingBuffers* staging)
 {
   // Get function data array and information about layout
   assert(u.x());
@@ -152,9 +213,10 @@ void vtx_write_data(adios2::IO& io, adios2::Engine& engine,
       for (int j = 0; j < index_map_bs; ++j)
         data[i * num_comp + j] = u_vector[i * index_map_bs + j];
     }
-    adios2::Variable<double> output
-        = define_variable<double>(io, u.name, {}, {}, {num_dofs, num_comp});
-    engine.Put<double>(output, data.data(), adios2::Mode::Sync);
+    adios2::Variable<double> output = define_variable<double>(
+        io, u.name, {}, {}, {num_dofs, num_comp}, &options);
+    put_buffer(engine, output, std::move(data),
+               staging ? &staging->real : nullptr);
   }
   else
   {
@@ -165,18 +227,20 @@ void vtx_write_data(adios2::IO& io, adios2::Engine& engine,
         data[i * num_comp + j] = std::real(u_vector[i * index_map_bs + j]);
     }
     adios2::Variable<double> output_real = define_variable<double>(
-        io, u.name + "_real", {}, {}, {num_dofs, num_comp});
-    engine.Put<double>(output_real, data.data(), adios2::Mode::Sync);
+        io, u.name + "_real", {}, {}, {num_dofs, num_comp}, &options);
+    put_buffer(engine, output_real, std::move(data),
+               staging ? &staging->real : nullptr);
 
-    std::fill(data.begin(), data.end(), 0);
+    data.assign(num_dofs * num_comp, 0);
     for (std::size_t i = 0; i < num_dofs; ++i)
     {
       for (int j = 0; j < index_map_bs; ++j)
         data[i * num_comp + j] = std::imag(u_vector[i * index_map_bs + j]);
     }
     adios2::Variable<double> output_imag = define_variable<double>(
-        io, u.name + "_imag", {}, {}, {num_dofs, num_comp});
-    engine.Put<double>(output_imag, data.data(), adios2::Mode::Sync);
+        io, u.name + "_imag", {}, {}, {num_dofs, num_comp}, &options);
+    put_buffer(engine, output_imag, std::move(data),
+               staging ? &staging->real : nullptr);
   }
 }
 //-----------------------------------------------------------------------------
@@ -274,21 +338,34 @@ tabulate_lagrange_dof_coordinates(const dolfinx::fem::FunctionSpace& V)
 /// @param[in] io The ADIOS2 io object
 /// @param[in] engine The ADIOS2 engine object
 /// @param[in] mesh The mesh
+/// @param[in] options Output pipeline options
+/// @param[in] staging Staging buffers for deferred Puts (nullptr for
+/// synchronous output)
 void vtx_write_mesh(adios2::IO& io, adios2::Engine& engine,
-                    const mesh::Mesh& mesh)
+                    const mesh::Mesh& mesh, const ADIOS2Options& options,
+                    ADIOS2Writer::StagingBuffers* staging)
 {
-  // "Put" geometry
+  // "Put" geometry. In asynchronous mode the geometry is copied since
+  // it may be updated before the step has been flushed.
   std::shared_ptr<const common::IndexMap> x_map = mesh.geometry().index_map();
   const std::uint32_t num_vertices = x_map->size_local() + x_map->num_ghosts();
-  adios2::Variable<double> local_geometry
-      = define_variable<double>(io, "geometry", {}, {}, {num_vertices, 3});
-  engine.Put<double>(local_geometry, mesh.geometry().x().data());
+  adios2::Variable<double> local_geometry = define_variable<double>(
+      io, "geometry", {}, {}, {num_vertices, 3}, &options);
+  if (staging)
+  {
+    const xt::xtensor<double, 2>& x = mesh.geometry().x();
+    staging->real.emplace_back(x.data(), x.data() + x.size());
+    engine.Put<double>(local_geometry, staging->real.back().data(),
+                       adios2::Mode::Deferred);
+  }
+  else
+    engine.Put<double>(local_geometry, mesh.geometry().x().data());
 
   // Put number of nodes. The mesh data is written with local indices,
   // therefore we need the ghost vertices.
   adios2::Variable<std::uint32_t> vertices = define_variable<std::uint32_t>(
       io, "NumberOfNodes", {adios2::LocalValueDim});
-  engine.Put<std::uint32_t>(vertices, num_vertices);
+  engine.Put<std::uint32_t>(vertices, num_vertices, adios2::Mode::Sync);
 
   // Add cell metadata
   const int tdim = mesh.topology().dim();
@@ -296,11 +373,12 @@ void vtx_write_mesh(adios2::IO& io, adios2::Engine& engine,
   adios2::Variable<std::uint32_t> cell_variable
       = define_variable<std::uint32_t>(io, "NumberOfCells",
                                        {adios2::LocalValueDim});
-  engine.Put<std::uint32_t>(cell_variable, num_cells);
+  engine.Put<std::uint32_t>(cell_variable, num_cells, adios2::Mode::Sync);
   adios2::Variable<std::uint32_t> celltype_variable
       = define_variable<std::uint32_t>(io, "types");
   engine.Put<std::uint32_t>(celltype_variable,
-                            cells::get_vtk_cell_type(mesh, tdim));
+                            cells::get_vtk_cell_type(mesh, tdim),
+                            adios2::Mode::Sync);
 
   // Get DOLFINx to VTK permutation
   // FIXME: Use better way to get number of nodes
@@ -316,9 +394,18 @@ void vtx_write_mesh(adios2::IO& io, adios2::Engine& engine,
 
   // Put topology (nodes)
   adios2::Variable<std::int64_t> local_topology = define_variable<std::int64_t>(
-      io, "connectivity", {}, {}, {num_cells, num_nodes + 1});
-  engine.Put<std::int64_t>(local_topology, topology.data());
-  engine.PerformPuts();
+      io, "connectivity", {}, {}, {num_cells, num_nodes + 1}, &options);
+  if (staging)
+  {
+    staging->int64.emplace_back(topology.begin(), topology.end());
+    engine.Put<std::int64_t>(local_topology, staging->int64.back().data(),
+                             adios2::Mode::Deferred);
+  }
+  else
+  {
+    engine.Put<std::int64_t>(local_topology, topology.data());
+    engine.PerformPuts();
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -329,8 +416,13 @@ void vtx_write_mesh(adios2::IO& io, adios2::Engine& engine,
 /// @param[in] io The ADIOS2 io object
 /// @param[in] engine The ADIOS2 engine object
 /// @param[in] u The function
+/// @param[in] options Output pipeline options
+/// @param[in] staging Staging buffers for deferred Puts (nullptr for
+/// synchronous output)
 void vtx_write_mesh_from_space(adios2::IO& io, adios2::Engine& engine,
-                               const fem::FunctionSpace& V)
+                               const fem::FunctionSpace& V,
+                               const ADIOS2Options& options,
+                               ADIOS2Writer::StagingBuffers* staging)
 {
   auto mesh = V.mesh();
   assert(mesh);
@@ -362,11 +454,11 @@ void vtx_write_mesh_from_space(adios2::IO& io, adios2::Engine& engine,
 
   // Define ADIOS2 variables for geometry, topology, celltypes and
   // corresponding VTK data
-  adios2::Variable<double> local_geometry
-      = define_variable<double>(io, "geometry", {}, {}, {num_dofs, 3});
+  adios2::Variable<double> local_geometry = define_variable<double>(
+      io, "geometry", {}, {}, {num_dofs, 3}, &options);
   adios2::Variable<std::uint64_t> local_topology
       = define_variable<std::uint64_t>(io, "connectivity", {}, {},
-                                       {num_cells, num_nodes + 1});
+                                       {num_cells, num_nodes + 1}, &options);
   adios2::Variable<std::uint32_t> cell_type
       = define_variable<std::uint32_t>(io, "types");
   adios2::Variable<std::uint32_t> vertices = define_variable<std::uint32_t>(
@@ -375,13 +467,27 @@ void vtx_write_mesh_from_space(adios2::IO& io, adios2::Engine& engine,
       io, "NumberOfEntities", {adios2::LocalValueDim});
 
   // Write mesh information to file
-  engine.Put<std::uint32_t>(vertices, num_dofs);
-  engine.Put<std::uint32_t>(elements, num_cells);
+  engine.Put<std::uint32_t>(vertices, num_dofs, adios2::Mode::Sync);
+  engine.Put<std::uint32_t>(elements, num_cells, adios2::Mode::Sync);
   engine.Put<std::uint32_t>(cell_type,
-                            dolfinx::io::cells::get_vtk_cell_type(*mesh, tdim));
-  engine.Put<double>(local_geometry, geometry.data());
-  engine.Put<std::uint64_t>(local_topology, vtk_topology.data());
-  engine.PerformPuts();
+                            dolfinx::io::cells::get_vtk_cell_type(*mesh, tdim),
+                            adios2::Mode::Sync);
+  if (staging)
+  {
+    staging->real.emplace_back(geometry.data(),
+                               geometry.data() + geometry.size());
+    engine.Put<double>(local_geometry, staging->real.back().data(),
+                       adios2::Mode::Deferred);
+    staging->uint64.push_back(std::move(vtk_topology));
+    engine.Put<std::uint64_t>(local_topology, staging->uint64.back().data(),
+                              adios2::Mode::Deferred);
+  }
+  else
+  {
+    engine.Put<double>(local_geometry, geometry.data());
+    engine.Put<std::uint64_t>(local_topology, vtk_topology.data());
+    engine.PerformPuts();
+  }
 }
 //-----------------------------------------------------------------------------
 // Extract name of functions and split into real and imaginary component
@@ -548,9 +654,14 @@ std::vector<Scalar> pack_function_data(const fem::Function<Scalar>& u)
 /// @param[in] io The ADIOS2 io object
 /// @param[in] engine The ADIOS2 engine object
 /// @param[in] u The function to write
+/// @param[in] options Output pipeline options
+/// @param[in] staging Staging buffers for deferred Puts (nullptr for
+/// synchronous output)
 template <typename Scalar>
 void fides_write_data(adios2::IO& io, adios2::Engine& engine,
-                      const fem::Function<Scalar>& u)
+                      const fem::Function<Scalar>& u,
+                      const ADIOS2Options& options,
+                      ADIOS2Writer::StagingBuffers* staging)
 {
   // FIXME: There is an implicit assumptions that u and the mesh have
   // the same ElementDoflayout
@@ -591,11 +702,21 @@ void fides_write_data(adios2::IO& io, adios2::Engine& engine,
     // ---- Real
     const std::string u_name = u.name;
     adios2::Variable<double> local_output = define_variable<double>(
-        io, u_name, {}, {}, {num_vertices, num_components});
+        io, u_name, {}, {}, {num_vertices, num_components}, &options);
 
-    // To reuse out_data, we use sync mode here
-    engine.Put<double>(local_output, data.data());
-    engine.PerformPuts();
+    if (staging)
+    {
+      // The dof array may be updated before the step has been flushed,
+      // so copy into a staging buffer
+      staging->real.emplace_back(data.begin(), data.end());
+      engine.Put<double>(local_output, staging->real.back().data(),
+                         adios2::Mode::Deferred);
+    }
+    else
+    {
+      engine.Put<double>(local_output, data.data());
+      engine.PerformPuts();
+    }
   }
   else
   {
@@ -603,17 +724,32 @@ void fides_write_data(adios2::IO& io, adios2::Engine& engine,
     std::vector<double> data_real(data.size()), data_imag(data.size());
 
     adios2::Variable<double> local_output_r = define_variable<double>(
-        io, u.name + "_real", {}, {}, {num_vertices, num_components});
+        io, u.name + "_real", {}, {}, {num_vertices, num_components},
+        &options);
     std::transform(data.cbegin(), data.cend(), data_real.begin(),
                    [](auto& x) -> double { return std::real(x); });
-    engine.Put<double>(local_output_r, data_real.data());
 
     adios2::Variable<double> local_output_c = define_variable<double>(
-        io, u.name + "_imag", {}, {}, {num_vertices, num_components});
+        io, u.name + "_imag", {}, {}, {num_vertices, num_components},
+        &options);
     std::transform(data.cbegin(), data.cend(), data_imag.begin(),
                    [](auto& x) -> double { return std::imag(x); });
-    engine.Put<double>(local_output_c, data_imag.data());
-    engine.PerformPuts();
+
+    if (staging)
+    {
+      staging->real.push_back(std::move(data_real));
+      engine.Put<double>(local_output_r, staging->real.back().data(),
+                         adios2::Mode::Deferred);
+      staging->real.push_back(std::move(data_imag));
+      engine.Put<double>(local_output_c, staging->real.back().data(),
+                         adios2::Mode::Deferred);
+    }
+    else
+    {
+      engine.Put<double>(local_output_r, data_real.data());
+      engine.Put<double>(local_output_c, data_imag.data());
+      engine.PerformPuts();
+    }
   }
 }
 //-----------------------------------------------------------------------------
@@ -622,15 +758,28 @@ void fides_write_data(adios2::IO& io, adios2::Engine& engine,
 /// @param[in] io The ADIOS2 IO
 /// @param[in] engine The ADIOS2 engine
 /// @param[in] mesh The mesh
+/// @param[in] options Output pipeline options
+/// @param[in] staging Staging buffers for deferred Puts (nullptr for
+/// synchronous output)
 void fides_write_mesh(adios2::IO& io, adios2::Engine& engine,
-                      const mesh::Mesh& mesh)
+                      const mesh::Mesh& mesh, const ADIOS2Options& options,
+                      ADIOS2Writer::StagingBuffers* staging)
 {
-  // "Put" geometry data
+  // "Put" geometry data. In asynchronous mode the geometry is copied
+  // since it may be updated before the step has been flushed.
   auto x_map = mesh.geometry().index_map();
   const std::uint32_t num_vertices = x_map->size_local() + x_map->num_ghosts();
-  adios2::Variable<double> local_geometry
-      = define_variable<double>(io, "points", {}, {}, {num_vertices, 3});
-  engine.Put<double>(local_geometry, mesh.geometry().x().data());
+  adios2::Variable<double> local_geometry = define_variable<double>(
+      io, "points", {}, {}, {num_vertices, 3}, &options);
+  if (staging)
+  {
+    const xt::xtensor<double, 2>& x = mesh.geometry().x();
+    staging->real.emplace_back(x.data(), x.data() + x.size());
+    engine.Put<double>(local_geometry, staging->real.back().data(),
+                       adios2::Mode::Deferred);
+  }
+  else
+    engine.Put<double>(local_geometry, mesh.geometry().x().data());
 
   // TODO: The DOLFINx and VTK topology are the same for some cell types
   // - no need to repack via extract_vtk_connectivity in these cases
@@ -645,10 +794,19 @@ void fides_write_mesh(adios2::IO& io, adios2::Engine& engine,
 
   // "Put" topology data in the result in the ADIOS2 file
   adios2::Variable<std::int64_t> local_topology = define_variable<std::int64_t>(
-      io, "connectivity", {}, {}, {std::size_t(num_cells * num_nodes)});
-  engine.Put<std::int64_t>(local_topology, topology.data());
-
-  engine.PerformPuts();
+      io, "connectivity", {}, {}, {std::size_t(num_cells * num_nodes)},
+      &options);
+  if (staging)
+  {
+    staging->int64.emplace_back(topology.begin(), topology.end());
+    engine.Put<std::int64_t>(local_topology, staging->int64.back().data(),
+                             adios2::Mode::Deferred);
+  }
+  else
+  {
+    engine.Put<std::int64_t>(local_topology, topology.data());
+    engine.PerformPuts();
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -736,27 +894,34 @@ void fides_initialize_function_attributes(adios2::IO& io,
 ADIOS2Writer::ADIOS2Writer(MPI_Comm comm, const std::string& filename,
                            const std::string& tag,
                            const std::shared_ptr<const mesh::Mesh>& mesh,
-                           const U& u)
+                           const U& u, const ADIOS2Options& options)
     : _adios(std::make_unique<adios2::ADIOS>(comm)),
       _io(std::make_unique<adios2::IO>(_adios->DeclareIO(tag))),
       _engine(std::make_unique<adios2::Engine>(
           _io->Open(filename, adios2::Mode::Write))),
-      _mesh(mesh), _u(u)
+      _mesh(mesh), _u(u), _options(options)
 {
   _io->SetEngine("BPFile");
+  if (options.num_aggregators > 0)
+  {
+    _io->SetParameter("NumAggregators",
+                      std::to_string(options.num_aggregators));
+  }
 }
 //-----------------------------------------------------------------------------
 ADIOS2Writer::ADIOS2Writer(MPI_Comm comm, const std::string& filename,
                            const std::string& tag,
-                           std::shared_ptr<const mesh::Mesh> mesh)
-    : ADIOS2Writer(comm, filename, tag, mesh, {})
+                           std::shared_ptr<const mesh::Mesh> mesh,
+                           const ADIOS2Options& options)
+    : ADIOS2Writer(comm, filename, tag, mesh, {}, options)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
 ADIOS2Writer::ADIOS2Writer(MPI_Comm comm, const std::string& filename,
-                           const std::string& tag, const U& u)
-    : ADIOS2Writer(comm, filename, tag, nullptr, u)
+                           const std::string& tag, const U& u,
+                           const ADIOS2Options& options)
+    : ADIOS2Writer(comm, filename, tag, nullptr, u, options)
 {
   // Extract mesh from first function
   assert(!u.empty());
@@ -794,15 +959,36 @@ ADIOS2Writer::~ADIOS2Writer() { close(); }
 void ADIOS2Writer::close()
 {
   assert(_engine);
+  flush_wait();
   // This looks a bit odd because ADIOS2 uses `operator bool()` to
   // test if the engine is open
   if (*_engine)
     _engine->Close();
 }
 //-----------------------------------------------------------------------------
+void ADIOS2Writer::flush_wait()
+{
+  if (_flush.joinable())
+    _flush.join();
+}
+//-----------------------------------------------------------------------------
+void ADIOS2Writer::end_step()
+{
+  assert(_engine);
+  if (_options.async)
+  {
+    // EndStep drains the deferred Puts. The staging buffers keep the
+    // data alive until the next flush_wait().
+    _flush = std::thread([this]() { _engine->EndStep(); });
+  }
+  else
+    _engine->EndStep();
+}
+//-----------------------------------------------------------------------------
 FidesWriter::FidesWriter(MPI_Comm comm, const std::string& filename,
-                         std::shared_ptr<const mesh::Mesh> mesh)
-    : ADIOS2Writer(comm, filename, "Fides mesh writer", mesh)
+                         std::shared_ptr<const mesh::Mesh> mesh,
+                         const ADIOS2Options& options)
+    : ADIOS2Writer(comm, filename, "Fides mesh writer", mesh, options)
 {
   assert(_io);
   assert(mesh);
@@ -810,8 +996,9 @@ FidesWriter::FidesWriter(MPI_Comm comm, const std::string& filename,
 }
 //-----------------------------------------------------------------------------
 FidesWriter::FidesWriter(MPI_Comm comm, const std::string& filename,
-                         const ADIOS2Writer::U& u)
-    : ADIOS2Writer(comm, filename, "Fides function writer", u)
+                         const ADIOS2Writer::U& u,
+                         const ADIOS2Options& options)
+    : ADIOS2Writer(comm, filename, "Fides function writer", u, options)
 {
   assert(!u.empty());
   const mesh::Mesh* mesh = nullptr;
@@ -869,28 +1056,38 @@ void FidesWriter::write(double t)
   assert(_io);
   assert(_engine);
 
+  // Wait for any in-flight step before the engine and staging buffers
+  // are re-used
+  flush_wait();
+  StagingBuffers* staging = _options.async ? &_staging : nullptr;
+  if (staging)
+    staging->clear();
+
   _engine->BeginStep();
   adios2::Variable<double> var_step = define_variable<double>(*_io, "step");
-  _engine->Put<double>(var_step, t);
+  _engine->Put<double>(var_step, t, adios2::Mode::Sync);
 
-  fides_write_mesh(*_io, *_engine, *_mesh);
+  fides_write_mesh(*_io, *_engine, *_mesh, _options, staging);
   for (auto& v : _u)
   {
     std::visit(overload{[&](const std::shared_ptr<const Fdr>& u) {
-                          fides_write_data<Fdr::value_type>(*_io, *_engine, *u);
+                          fides_write_data<Fdr::value_type>(*_io, *_engine, *u,
+                                                            _options, staging);
                         },
                         [&](const std::shared_ptr<const Fdc>& u) {
-                          fides_write_data<Fdc::value_type>(*_io, *_engine, *u);
+                          fides_write_data<Fdc::value_type>(*_io, *_engine, *u,
+                                                            _options, staging);
                         }},
                v);
   };
 
-  _engine->EndStep();
+  end_step();
 }
 //-----------------------------------------------------------------------------
 VTXWriter::VTXWriter(MPI_Comm comm, const std::string& filename,
-                     std::shared_ptr<const mesh::Mesh> mesh)
-    : ADIOS2Writer(comm, filename, "VTX mesh writer", mesh)
+                     std::shared_ptr<const mesh::Mesh> mesh,
+                     const ADIOS2Options& options)
+    : ADIOS2Writer(comm, filename, "VTX mesh writer", mesh, options)
 {
   // Define VTK scheme attribute for mesh
   std::string vtk_scheme = create_vtk_schema({}, {});
@@ -898,8 +1095,8 @@ VTXWriter::VTXWriter(MPI_Comm comm, const std::string& filename,
 }
 //-----------------------------------------------------------------------------
 VTXWriter::VTXWriter(MPI_Comm comm, const std::string& filename,
-                     const ADIOS2Writer::U& u)
-    : ADIOS2Writer(comm, filename, "VTX function writer", u)
+                     const ADIOS2Writer::U& u, const ADIOS2Options& options)
+    : ADIOS2Writer(comm, filename, "VTX function writer", u, options)
 {
   // Extract element from first function
   assert(!u.empty());
@@ -970,24 +1167,36 @@ void VTXWriter::write(double t)
 {
   assert(_io);
   assert(_engine);
+
+  // Wait for any in-flight step before the engine and staging buffers
+  // are re-used
+  flush_wait();
+  StagingBuffers* staging = _options.async ? &_staging : nullptr;
+  if (staging)
+    staging->clear();
+
   adios2::Variable<double> var_step = define_variable<double>(*_io, "step");
 
   _engine->BeginStep();
-  _engine->Put<double>(var_step, t);
+  _engine->Put<double>(var_step, t, adios2::Mode::Sync);
 
   // If we have no functions write the mesh to file
   if (_u.empty())
-    vtx_write_mesh(*_io, *_engine, *_mesh);
+    vtx_write_mesh(*_io, *_engine, *_mesh, _options, staging);
   else
   {
     // Write a single mesh for functions as they share finite element
-    std::visit(overload{[&](const std::shared_ptr<const Fdr>& u) {
+    std::visit(overload{[&](const std::shared_ptr<const Fdr>& u)
+                        {
                           vtx_write_mesh_from_space(*_io, *_engine,
-                                                    *u->function_space());
+                                                    *u->function_space(),
+                                                    _options, staging);
                         },
-                        [&](const std::shared_ptr<const Fdc>& u) {
+                        [&](const std::shared_ptr<const Fdc>& u)
+                        {
                           vtx_write_mesh_from_space(*_io, *_engine,
-                                                    *u->function_space());
+                                                    *u->function_space(),
+                                                    _options, staging);
                         }},
                _u[0]);
 
@@ -995,16 +1204,18 @@ void VTXWriter::write(double t)
     for (auto& v : _u)
     {
       std::visit(overload{[&](const std::shared_ptr<const Fdr>& u) {
-                            vtx_write_data<Fdr::value_type>(*_io, *_engine, *u);
+                            vtx_write_data<Fdr::value_type>(*_io, *_engine, *u,
+                                                            _options, staging);
                           },
                           [&](const std::shared_ptr<const Fdc>& u) {
-                            vtx_write_data<Fdc::value_type>(*_io, *_engine, *u);
+                            vtx_write_data<Fdc::value_type>(*_io, *_engine, *u,
+                                                            _options, staging);
                           }},
                  v);
     };
   }
 
-  _engine->EndStep();
+  end_step();
 }
 //-----------------------------------------------------------------------------
 
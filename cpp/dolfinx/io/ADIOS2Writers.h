@@ -10,9 +10,11 @@
 
 #include <cassert>
 #include <complex>
+#include <cstdint>
 #include <memory>
 #include <mpi.h>
 #include <string>
+#include <thread>
 #include <variant>
 #include <vector>
 
@@ -37,6 +39,33 @@ class Mesh;
 namespace dolfinx::io
 {
 
+/// Options controlling how ADIOS2-based writers move data to disk
+struct ADIOS2Options
+{
+  /// Flush each time step on a background thread so that file output
+  /// overlaps computation. The output data is copied into staging
+  /// buffers before write() returns, and the next write() (or close())
+  /// waits for the in-flight flush to complete.
+  bool async = false;
+
+  /// Number of BP aggregator processes (sub-files) used by the engine.
+  /// Zero keeps the engine default.
+  int num_aggregators = 0;
+
+  /// ADIOS2 compression operator applied to the geometry and function
+  /// value arrays: "zfp" and "sz" are accuracy-targeted lossy
+  /// operators, "blosc" is lossless (and also compresses the integer
+  /// topology arrays). An empty string writes uncompressed data. The
+  /// selected operator must be enabled in the ADIOS2 build.
+  std::string compression;
+
+  /// Absolute error bound for the lossy compression operators ("zfp",
+  /// "sz"). Visualization output rarely needs more than a few digits,
+  /// and a loose bound can reduce the output size by an order of
+  /// magnitude.
+  double compression_accuracy = 1e-6;
+};
+
 class ADIOS2Writer
 {
 public:
@@ -45,14 +74,36 @@ public:
   using U = std::vector<
       std::variant<std::shared_ptr<const Fdr>, std::shared_ptr<const Fdc>>>;
 
+  /// Buffers that keep the data behind deferred Puts alive until the
+  /// step has been flushed
+  struct StagingBuffers
+  {
+    /// Geometry and function value buffers
+    std::vector<std::vector<double>> real;
+    /// Topology (connectivity) buffers
+    std::vector<std::vector<std::int64_t>> int64;
+    /// Topology (connectivity) buffers
+    std::vector<std::vector<std::uint64_t>> uint64;
+
+    /// Release the buffers from the previous step
+    void clear()
+    {
+      real.clear();
+      int64.clear();
+      uint64.clear();
+    }
+  };
+
 private:
   /// Create an ADIOS2-based writer
   /// @param[in] comm The MPI communicator
   /// @param[in] filename Name of output file
   /// @param[in] tag The ADIOS2 object name
+  /// @param[in] options Output pipeline options
   ADIOS2Writer(MPI_Comm comm, const std::string& filename,
                const std::string& tag,
-               const std::shared_ptr<const mesh::Mesh>& mesh, const U& u);
+               const std::shared_ptr<const mesh::Mesh>& mesh, const U& u,
+               const ADIOS2Options& options);
 
 protected:
   /// Create an ADIOS2-based writer for a mesh
@@ -60,16 +111,20 @@ protected:
   /// @param[in] filename Name of output file
   /// @param[in] tag The ADIOS2 object name
   /// @param[in] mesh The mesh
+  /// @param[in] options Output pipeline options
   ADIOS2Writer(MPI_Comm comm, const std::string& filename,
-               const std::string& tag, std::shared_ptr<const mesh::Mesh> mesh);
+               const std::string& tag, std::shared_ptr<const mesh::Mesh> mesh,
+               const ADIOS2Options& options);
 
   /// Create an ADIOS2-based writer for a list of functions
   /// @param[in] comm The MPI communicator
   /// @param[in] filename Name of output file
   /// @param[in] tag The ADIOS2 object name
   /// @param[in] u List of functions
+  /// @param[in] options Output pipeline options
   ADIOS2Writer(MPI_Comm comm, const std::string& filename,
-               const std::string& tag, const U& u);
+               const std::string& tag, const U& u,
+               const ADIOS2Options& options);
 
   /// Move constructor
   ADIOS2Writer(ADIOS2Writer&& writer) = default;
@@ -87,15 +142,32 @@ protected:
   ADIOS2Writer& operator=(const ADIOS2Writer&) = delete;
 
 public:
-  /// Close the file
+  /// Close the file. Waits for any in-flight asynchronous flush.
   void close();
 
 protected:
+  /// Wait for an in-flight end-of-step (asynchronous mode) to complete
+  void flush_wait();
+
+  /// End the current step. In asynchronous mode the step is flushed on
+  /// a background thread and this call returns immediately.
+  void end_step();
+
   std::unique_ptr<adios2::ADIOS> _adios;
   std::unique_ptr<adios2::IO> _io;
   std::unique_ptr<adios2::Engine> _engine;
   std::shared_ptr<const mesh::Mesh> _mesh;
   U _u;
+
+  // Output pipeline options
+  ADIOS2Options _options;
+
+  // Staging buffers for asynchronous writes, valid until the step has
+  // been flushed
+  StagingBuffers _staging;
+
+  // Background thread driving EndStep in asynchronous mode
+  std::thread _flush;
 };
 
 /// Output of meshes and functions compatible with the Fides Paraview
@@ -108,10 +180,12 @@ public:
   /// @param[in] comm The MPI communicator to open the file on
   /// @param[in] filename Name of output file
   /// @param[in] mesh The mesh. The mesh must a degree 1 mesh.
+  /// @param[in] options Output pipeline options
   /// @note The mesh geometry can be updated between write steps but the
   /// topology should not be changed between write steps
   FidesWriter(MPI_Comm comm, const std::string& filename,
-              std::shared_ptr<const mesh::Mesh> mesh);
+              std::shared_ptr<const mesh::Mesh> mesh,
+              const ADIOS2Options& options = ADIOS2Options());
 
   /// Create Fides writer for list of functions
   /// @param[in] comm The MPI communicator
@@ -119,8 +193,10 @@ public:
   /// @param[in] u List of functions. The functions must (1) share the
   /// same mesh (degree 1) and (2) be degree 1 Lagrange. @note All
   /// functions in `u` must share the same Mesh
+  /// @param[in] options Output pipeline options
   FidesWriter(MPI_Comm comm, const std::string& filename,
-              const ADIOS2Writer::U& u);
+              const ADIOS2Writer::U& u,
+              const ADIOS2Options& options = ADIOS2Options());
 
   // Copy constructor
   FidesWriter(const FidesWriter&) = delete;
@@ -153,11 +229,13 @@ public:
   /// @param[in] comm The MPI communicator to open the file on
   /// @param[in] filename Name of output file
   /// @param[in] mesh The mesh to write
+  /// @param[in] options Output pipeline options
   /// @note This format support arbitrary degree meshes
   /// @note The mesh geometry can be updated between write steps but the
   /// topology should not be changed between write steps
   VTXWriter(MPI_Comm comm, const std::string& filename,
-            std::shared_ptr<const mesh::Mesh> mesh);
+            std::shared_ptr<const mesh::Mesh> mesh,
+            const ADIOS2Options& options = ADIOS2Options());
 
   /// Create a VTX writer for list of functions
   /// @param[in] comm The MPI communicator to open the file on
@@ -165,8 +243,10 @@ public:
   /// @param[in] u List of functions. The functions must (1) share the
   /// same mesh and (2) be (discontinuous) Lagrange functions. The
   /// element family and degree must be the same for all functions.
+  /// @param[in] options Output pipeline options
   /// @note This format supports arbitrary degree meshes
-  VTXWriter(MPI_Comm comm, const std::string& filename, const U& u);
+  VTXWriter(MPI_Comm comm, const std::string& filename, const U& u,
+            const ADIOS2Options& options = ADIOS2Options());
 
   // Copy constructor
   VTXWriter(const VTXWriter&) = delete;
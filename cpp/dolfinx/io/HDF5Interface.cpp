@@ -56,16 +56,30 @@ bool has_group(const hid_t handle, const std::string& group_name)
 
 //-----------------------------------------------------------------------------
 hid_t HDF5Interface::open_file(MPI_Comm comm, const std::string& filename,
-                               const std::string& mode, const bool use_mpi_io)
+                               const std::string& mode, const bool use_mpi_io,
+                               const HDF5Options& options)
 {
   // Set parallel access with communicator
   const hid_t plist_id = H5Pcreate(H5P_FILE_ACCESS);
 
+  // Align large file objects, e.g. to the file system stripe size
+  if (options.alignment > 0)
+  {
+    if (H5Pset_alignment(plist_id, options.alignment_threshold,
+                         options.alignment)
+        < 0)
+    {
+      throw std::runtime_error("Call to H5Pset_alignment unsuccessful");
+    }
+  }
+
 #ifdef H5_HAVE_PARALLEL
   if (use_mpi_io)
   {
     MPI_Info info;
     MPI_Info_create(&info);
+    for (const auto& [key, value] : options.mpi_hints)
+      MPI_Info_set(info, key.c_str(), value.c_str());
     if (H5Pset_fapl_mpio(plist_id, comm, info) < 0)
       throw std::runtime_error("Call to H5Pset_fapl_mpio unsuccessful");
     MPI_Info_free(&info);
@@ -6,19 +6,86 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
+#include <dolfinx/common/MPI.h>
 #include <dolfinx/common/log.h>
+#include <filesystem>
+#include <functional>
 #include <hdf5.h>
 #include <mpi.h>
+#include <numeric>
 #include <string>
+#include <utility>
 #include <vector>
+#include <xtl/xspan.hpp>
 
 namespace dolfinx::io
 {
 
+/// Tuning options for HDF5 file access and dataset transfers. The
+/// defaults reproduce the standard behaviour. On striped parallel file
+/// systems (e.g. Lustre) set the alignment to the stripe size and pass
+/// the collective buffering hints of the MPI-IO layer to approach the
+/// file system bandwidth for large writes.
+struct HDF5Options
+{
+  /// Use collective MPI-IO dataset transfers (independent transfers if
+  /// false). Only relevant when the file is opened with MPI-IO.
+  bool collective = true;
+
+  /// Minimum object size in bytes for which the file-space alignment
+  /// is applied (see @p alignment)
+  hsize_t alignment_threshold = 0;
+
+  /// Align file objects of at least @p alignment_threshold bytes to
+  /// multiples of this many bytes (H5Pset_alignment). Set to the file
+  /// system stripe size for stripe-aligned dataset placement. 0 keeps
+  /// the HDF5 default.
+  hsize_t alignment = 0;
+
+  /// Number of rows (first dimension) per chunk for created datasets.
+  /// 0 uses a contiguous layout, or the built-in chunk size heuristic
+  /// when chunking is requested by the caller.
+  std::int64_t chunk_rows = 0;
+
+  /// MPI-IO hints applied to the file access property list, e.g.
+  /// {"romio_cb_write", "enable"} or {"cb_nodes", "8"}. Only used when
+  /// the file is opened with MPI-IO.
+  std::vector<std::pair<std::string, std::string>> mpi_hints;
+
+  /// Append per-step function data to a single extensible (chunked)
+  /// HDF5 dataset per function rather than creating a new dataset for
+  /// every time step. Steps are stacked along the first dimension and
+  /// referenced from the XDMF file by hyperslab selections.
+  bool time_series = false;
+
+  /// Deflate (gzip) compression level, 0 (off) to 9, applied to
+  /// written datasets. Compression forces a chunked layout. With
+  /// MPI-IO the transfers must be collective (see @p collective).
+  int deflate = 0;
+
+  /// Apply the HDF5 byte-shuffle filter before compression. For slowly
+  /// varying fields the shuffled high-order bytes are nearly constant
+  /// from step to step, which substantially improves the deflate
+  /// ratio.
+  bool shuffle = false;
+
+  /// Aggregate dataset writes to one writer rank per shared-memory
+  /// node, in the style of the HDF5 subfiling VFD. Each node leader
+  /// gathers its node's rows over the intra-node communicator and
+  /// writes them serially to a per-node sub-file ("<filename>.<n>");
+  /// the dataset in the main file is created as a virtual dataset that
+  /// stitches the sub-files into a single logical dataset, so readers
+  /// are unaffected. At large rank counts this removes the file (lock)
+  /// contention of fully collective writes on striped file systems.
+  /// Requires MPI-IO and HDF5 1.10 or newer.
+  bool node_aggregation = false;
+};
+
 /// This class provides an interface to some HDF5 functionality
 
 class HDF5Interface
@@ -30,8 +97,11 @@ public:
   /// @param[in] filename Name of the HDF5 file to open
   /// @param[in] mode Mode in which to open the file (w, r, a)
   /// @param[in] use_mpi_io True if MPI-IO should be used
+  /// @param[in] options File access tuning options (alignment and
+  ///   MPI-IO hints)
   static hid_t open_file(MPI_Comm comm, const std::string& filename,
-                         const std::string& mode, const bool use_mpi_io);
+                         const std::string& mode, const bool use_mpi_io,
+                         const HDF5Options& options = HDF5Options());
 
   /// Close HDF5 file
   /// @param[in] handle HDF5 file handle
@@ -56,12 +126,68 @@ public:
   /// @param[in] global_size The global shape shape of the array
   /// @param[in] use_mpi_io True if MPI-IO should be used
   /// @param[in] use_chunking True if chunking should be used
+  /// @param[in] options Transfer tuning options (chunk shape and
+  ///   collective vs independent MPI-IO transfers)
   template <typename T>
   static void write_dataset(const hid_t handle, const std::string& dataset_path,
                             const T* data,
                             const std::array<std::int64_t, 2>& range,
                             const std::vector<std::int64_t>& global_size,
-                            bool use_mpi_io, bool use_chunking);
+                            bool use_mpi_io, bool use_chunking,
+                            const HDF5Options& options = HDF5Options());
+
+  /// Write data to an HDF5 file in bounded-size blocks produced on
+  /// demand. The dataset is created as by write_dataset(), but the
+  /// rows of this process' range are requested from @p pack in blocks
+  /// of at most @p block_rows rows, written, and the staging buffer
+  /// re-used, so peak memory is independent of the dataset size. With
+  /// collective MPI-IO transfers every process takes part in the same
+  /// (maximum) number of write rounds.
+  ///
+  /// @param[in] comm MPI communicator of the processes sharing the
+  ///   file
+  /// @param[in] handle HDF5 file handle
+  /// @param[in] dataset_path Path for the dataset in the HDF5 file
+  /// @param[in] pack Callback packing rows [row0, row0 + num_rows) of
+  ///   this process' range into the supplied buffer (row-major)
+  /// @param[in] range The local range on this processor
+  /// @param[in] global_size The global shape of the array
+  /// @param[in] block_rows Maximum number of rows per write
+  /// @param[in] use_mpi_io True if MPI-IO should be used
+  /// @param[in] options Transfer tuning options
+  template <typename T>
+  static void write_dataset_blocked(
+      MPI_Comm comm, const hid_t handle, const std::string& dataset_path,
+      const std::function<void(std::int64_t, std::int64_t, T*)>& pack,
+      const std::array<std::int64_t, 2>& range,
+      const std::vector<std::int64_t>& global_size, std::int64_t block_rows,
+      bool use_mpi_io, const HDF5Options& options = HDF5Options());
+
+  /// Append rows to an extensible HDF5 dataset, creating the dataset
+  /// on first use. The dataset is chunked with an unlimited first
+  /// dimension; every call extends it by the global number of rows and
+  /// writes each process' block into the new extent, so repeated calls
+  /// (e.g. one per time step) stack their data along the first
+  /// dimension of one dataset.
+  ///
+  /// @param[in] handle HDF5 file handle
+  /// @param[in] dataset_path Path for the dataset in the HDF5 file
+  /// @param[in] data Data to be written, flattened into 1D vector
+  ///   (row-major storage)
+  /// @param[in] range The local row range of this block on this
+  ///   processor
+  /// @param[in] global_size The global shape of this block
+  /// @param[in] use_mpi_io True if MPI-IO should be used
+  /// @param[in] options Transfer tuning options (chunk shape,
+  ///   compression and collective vs independent MPI-IO transfers)
+  /// @return The global row offset in the dataset at which this block
+  ///   begins
+  template <typename T>
+  static std::int64_t
+  append_dataset(const hid_t handle, const std::string& dataset_path,
+                 const T* data, const std::array<std::int64_t, 2>& range,
+                 const std::vector<std::int64_t>& global_size, bool use_mpi_io,
+                 const HDF5Options& options = HDF5Options());
 
   /// Read data from a HDF5 dataset "dataset_path" as defined by range
   /// blocks on each process.
@@ -76,6 +202,24 @@ public:
                                      const std::string& dataset_path,
                                      const std::array<std::int64_t, 2>& range);
 
+  /// Read selected rows of a HDF5 dataset. The rows need not be
+  /// contiguous; runs of consecutive rows are coalesced into hyperslab
+  /// blocks and read with a single union selection, so each process
+  /// reads exactly the rows it requires. The transfer is independent
+  /// (non-collective): processes may request different numbers of rows,
+  /// including none.
+  ///
+  /// @param[in] handle HDF5 file handle
+  /// @param[in] dataset_path Path for the dataset in the HDF5 file
+  /// @param[in] rows Rows (first dimension indices) to read, sorted in
+  ///   ascending order without duplicates
+  /// @return Flattened array of values for the selected rows, in the
+  ///   order of @p rows
+  template <typename T>
+  static std::vector<T>
+  read_dataset_rows(const hid_t handle, const std::string& dataset_path,
+                    const xtl::span<const std::int64_t>& rows);
+
   /// Check for existence of dataset in HDF5 file
   /// @param[in] handle HDF5 file handle
   /// @param[in] dataset_path Data set path
@@ -109,6 +253,20 @@ private:
   /// @param[in] dataset_path Data set path to add
   static void add_group(const hid_t handle, const std::string& dataset_path);
 
+  // Write a dataset through one writer rank per shared-memory node.
+  // Each node leader gathers its node's rows over the intra-node
+  // communicator (recovered from the file access property list) and
+  // writes them serially to the per-node sub-file; the dataset in
+  // handle is then created, collectively, as a virtual dataset
+  // stitching the sub-files together. Called by write_dataset() when
+  // HDF5Options::node_aggregation is set.
+  template <typename T>
+  static void
+  write_dataset_aggregated(const hid_t handle, const std::string& dataset_path,
+                           const T* data,
+                           const std::array<std::int64_t, 2>& range,
+                           const std::vector<std::int64_t>& global_size);
+
   // Return HDF5 data type
   template <typename T>
   static hid_t hdf5_type()
@@ -159,7 +317,8 @@ template <typename T>
 inline void HDF5Interface::write_dataset(
     const hid_t file_handle, const std::string& dataset_path, const T* data,
     const std::array<std::int64_t, 2>& range,
-    const std::vector<int64_t>& global_size, bool use_mpi_io, bool use_chunking)
+    const std::vector<int64_t>& global_size, bool use_mpi_io, bool use_chunking,
+    const HDF5Options& options)
 {
   // Data rank
   const int rank = global_size.size();
@@ -170,6 +329,15 @@ inline void HDF5Interface::write_dataset(
                              "Only rank 1 and rank 2 dataset are supported");
   }
 
+  if (options.node_aggregation)
+  {
+    if (!use_mpi_io)
+      throw std::runtime_error("Node-aggregated output requires MPI-IO.");
+    write_dataset_aggregated(file_handle, dataset_path, data, range,
+                             global_size);
+    return;
+  }
+
   // Get HDF5 data type
   const hid_t h5type = hdf5_type<T>();
 
@@ -189,23 +357,39 @@ inline void HDF5Interface::write_dataset(
   if (filespace0 == HDF5_FAIL)
     throw std::runtime_error("Failed to create HDF5 data space");
 
-  // Set chunking parameters
-  hid_t chunking_properties;
-  if (use_chunking)
+  // Set chunking parameters. An explicit chunk shape from the options
+  // takes precedence over the built-in heuristic. Compression filters
+  // require a chunked layout.
+  hid_t chunking_properties = H5P_DEFAULT;
+  if (options.chunk_rows > 0 or use_chunking or options.deflate > 0
+      or options.shuffle)
   {
-    // Set chunk size and limit to 1kB min/1MB max
-    hsize_t chunk_size = dimsf[0] / 2;
-    if (chunk_size > 1048576)
-      chunk_size = 1048576;
-    if (chunk_size < 1024)
-      chunk_size = 1024;
-
-    hsize_t chunk_dims[2] = {chunk_size, dimsf[1]};
+    hsize_t chunk_size;
+    if (options.chunk_rows > 0)
+      chunk_size = options.chunk_rows;
+    else
+    {
+      // Set chunk size and limit to 1kB min/1MB max
+      chunk_size = dimsf[0] / 2;
+      if (chunk_size > 1048576)
+        chunk_size = 1048576;
+      if (chunk_size < 1024)
+        chunk_size = 1024;
+    }
+
+    // A chunk may not be larger than the (fixed) dataset extent
+    if (dimsf[0] > 0 and chunk_size > dimsf[0])
+      chunk_size = dimsf[0];
+
+    std::vector<hsize_t> chunk_dims = dimsf;
+    chunk_dims[0] = chunk_size;
     chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
-    H5Pset_chunk(chunking_properties, rank, chunk_dims);
+    H5Pset_chunk(chunking_properties, rank, chunk_dims.data());
+    if (options.shuffle)
+      H5Pset_shuffle(chunking_properties);
+    if (options.deflate > 0)
+      H5Pset_deflate(chunking_properties, options.deflate);
   }
-  else
-    chunking_properties = H5P_DEFAULT;
 
   // Check that group exists and recursively create if required
   const std::string group_name(dataset_path, 0, dataset_path.rfind('/'));
@@ -243,7 +427,9 @@ inline void HDF5Interface::write_dataset(
   if (use_mpi_io)
   {
 #ifdef H5_HAVE_PARALLEL
-    status = H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+    status = H5Pset_dxpl_mpio(plist_id, options.collective
+                                            ? H5FD_MPIO_COLLECTIVE
+                                            : H5FD_MPIO_INDEPENDENT);
     if (status == HDF5_FAIL)
     {
       throw std::runtime_error(
@@ -263,12 +449,577 @@ inline void HDF5Interface::write_dataset(
         "Failed to write HDF5 local dataset into hyperslab.");
   }
 
-  if (use_chunking)
+  if (chunking_properties != H5P_DEFAULT)
+  {
+    // Close chunking properties
+    status = H5Pclose(chunking_properties);
+    if (status == HDF5_FAIL)
+      throw std::runtime_error("Failed to close HDF5 chunking properties.");
+  }
+
+  // Close dataset collectively
+  status = H5Dclose(dset_id);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to close HDF5 dataset.");
+
+  // Close hyperslab
+  status = H5Sclose(filespace1);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to close HDF5 hyperslab.");
+
+  // Close local dataset
+  status = H5Sclose(memspace);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to close local HDF5 dataset.");
+
+  // Release file-access template
+  status = H5Pclose(plist_id);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to release HDF5 file-access template.");
+}
+//---------------------------------------------------------------------------
+template <typename T>
+inline void HDF5Interface::write_dataset_aggregated(
+    const hid_t file_handle, const std::string& dataset_path, const T* data,
+    const std::array<std::int64_t, 2>& range,
+    const std::vector<std::int64_t>& global_size)
+{
+#if defined(H5_HAVE_PARALLEL) and H5_VERSION_GE(1, 10, 0)
+  // Data rank and number of values per row
+  const int rank = global_size.size();
+  std::int64_t row_size = 1;
+  for (int i = 1; i < rank; ++i)
+    row_size *= global_size[i];
+
+  // Recover the communicator the file was opened with
+  const hid_t fapl = H5Fget_access_plist(file_handle);
+  MPI_Comm comm = MPI_COMM_NULL;
+  MPI_Info info = MPI_INFO_NULL;
+  if (H5Pget_fapl_mpio(fapl, &comm, &info) < 0)
+  {
+    throw std::runtime_error(
+        "Node-aggregated output requires a file opened with MPI-IO.");
+  }
+  H5Pclose(fapl);
+
+  int mpi_rank, mpi_size;
+  MPI_Comm_rank(comm, &mpi_rank);
+  MPI_Comm_size(comm, &mpi_size);
+
+  // Intra-node communicator, with one leader (writer) rank per node
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, mpi_rank, MPI_INFO_NULL,
+                      &node_comm);
+  int node_rank, node_size;
+  MPI_Comm_rank(node_comm, &node_rank);
+  MPI_Comm_size(node_comm, &node_size);
+
+  // Number the sub-files by the global rank order of their writers
+  MPI_Comm leader_comm;
+  MPI_Comm_split(comm, node_rank == 0 ? 0 : MPI_UNDEFINED, mpi_rank,
+                 &leader_comm);
+  std::int64_t file_index = -1;
+  if (node_rank == 0)
+  {
+    int index;
+    MPI_Comm_rank(leader_comm, &index);
+    file_index = index;
+  }
+  MPI_Bcast(&file_index, 1, MPI_INT64_T, 0, node_comm);
+
+  // Every rank learns the sub-file and row range of every other rank,
+  // so that the virtual dataset mapping below can be built (it must be
+  // identical on all ranks) without further communication
+  const std::array<std::int64_t, 3> my_layout = {file_index, range[0],
+                                                 range[1]};
+  std::vector<std::int64_t> layout(3 * mpi_size);
+  MPI_Allgather(my_layout.data(), 3, MPI_INT64_T, layout.data(), 3,
+                MPI_INT64_T, comm);
+
+  // Gather this node's rows on the leader
+  const int num_local = (range[1] - range[0]) * row_size;
+  std::vector<int> recv_count(node_rank == 0 ? node_size : 0);
+  MPI_Gather(&num_local, 1, MPI_INT, recv_count.data(), 1, MPI_INT, 0,
+             node_comm);
+  std::vector<int> recv_disp(recv_count.size() + 1, 0);
+  std::partial_sum(recv_count.begin(), recv_count.end(),
+                   recv_disp.begin() + 1);
+  std::vector<T> node_data(recv_disp.back());
+  MPI_Gatherv(data, num_local, dolfinx::MPI::mpi_type<T>(), node_data.data(),
+              recv_count.data(), recv_disp.data(), dolfinx::MPI::mpi_type<T>(),
+              0, node_comm);
+
+  const std::string filename = get_filename(file_handle);
+  const std::string group_name(dataset_path, 0, dataset_path.rfind('/'));
+
+  // Leaders write their node's block to the sub-file, serially and
+  // without any inter-node coordination
+  if (node_rank == 0)
+  {
+    const std::string subfile = filename + "." + std::to_string(file_index);
+    hid_t subfile_handle;
+    if (std::filesystem::exists(subfile))
+      subfile_handle = H5Fopen(subfile.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+    else
+    {
+      subfile_handle
+          = H5Fcreate(subfile.c_str(), H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT);
+    }
+    if (subfile_handle == HDF5_FAIL)
+      throw std::runtime_error("Failed to open HDF5 sub-file.");
+
+    std::vector<hsize_t> subfile_dims(global_size.begin(), global_size.end());
+    subfile_dims[0] = node_data.size() / row_size;
+    const hid_t subfile_space
+        = H5Screate_simple(rank, subfile_dims.data(), nullptr);
+    if (subfile_space == HDF5_FAIL)
+      throw std::runtime_error("Failed to create HDF5 data space.");
+
+    add_group(subfile_handle, group_name);
+    const hid_t subfile_dset
+        = H5Dcreate2(subfile_handle, dataset_path.c_str(), hdf5_type<T>(),
+                     subfile_space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (subfile_dset == HDF5_FAIL)
+      throw std::runtime_error("Failed to create HDF5 sub-file dataset.");
+    if (H5Dwrite(subfile_dset, hdf5_type<T>(), H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                 node_data.data())
+        == HDF5_FAIL)
+    {
+      throw std::runtime_error("Failed to write HDF5 sub-file dataset.");
+    }
+    H5Dclose(subfile_dset);
+    H5Sclose(subfile_space);
+    close_file(subfile_handle);
+  }
+
+  // The sub-files must be complete before the virtual dataset that
+  // refers to them is created in the main file
+  MPI_Barrier(comm);
+
+  // Sub-file names are stored relative to the main file, so the set of
+  // files can be moved as a whole
+  std::string file_prefix = filename;
+  if (const std::size_t pos = filename.rfind('/'); pos != std::string::npos)
+    file_prefix = filename.substr(pos + 1);
+
+  // Build the virtual dataset mapping that stitches the sub-file
+  // blocks into a single logical dataset
+  const std::vector<hsize_t> dimsf(global_size.begin(), global_size.end());
+  const hid_t vspace = H5Screate_simple(rank, dimsf.data(), nullptr);
+  if (vspace == HDF5_FAIL)
+    throw std::runtime_error("Failed to create HDF5 data space.");
+  const hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+
+  std::int64_t num_files = 0;
+  for (int r = 0; r < mpi_size; ++r)
+    num_files = std::max(num_files, layout[3 * r] + 1);
+  for (std::int64_t f = 0; f < num_files; ++f)
+  {
+    // Sub-file row count
+    std::int64_t subfile_rows = 0;
+    for (int r = 0; r < mpi_size; ++r)
+    {
+      if (layout[3 * r] == f)
+        subfile_rows += layout[3 * r + 2] - layout[3 * r + 1];
+    }
+    if (subfile_rows == 0)
+      continue;
+
+    std::vector<hsize_t> src_dims = dimsf;
+    src_dims[0] = subfile_rows;
+    const hid_t src_space = H5Screate_simple(rank, src_dims.data(), nullptr);
+    const std::string src_file = file_prefix + "." + std::to_string(f);
+
+    // Map one hyperslab per run of globally consecutive row ranges.
+    // Ranks on a node are consecutive in the parent communicator, so
+    // normally a sub-file maps as a single contiguous run.
+    auto add_mapping = [&](std::int64_t row, std::int64_t src_row,
+                           std::int64_t num_rows)
+    {
+      std::vector<hsize_t> offset(rank, 0), count = dimsf;
+      offset[0] = row;
+      count[0] = num_rows;
+      H5Sselect_hyperslab(vspace, H5S_SELECT_SET, offset.data(), nullptr,
+                          count.data(), nullptr);
+      offset[0] = src_row;
+      H5Sselect_hyperslab(src_space, H5S_SELECT_SET, offset.data(), nullptr,
+                          count.data(), nullptr);
+      if (H5Pset_virtual(dcpl, vspace, src_file.c_str(), dataset_path.c_str(),
+                         src_space)
+          == HDF5_FAIL)
+      {
+        throw std::runtime_error("Failed to add HDF5 virtual mapping.");
+      }
+    };
+
+    std::int64_t run_row = -1, run_src_row = 0, run_rows = 0, src_row = 0;
+    for (int r = 0; r < mpi_size; ++r)
+    {
+      if (layout[3 * r] != f)
+        continue;
+      const std::int64_t rows = layout[3 * r + 2] - layout[3 * r + 1];
+      if (run_rows > 0 and layout[3 * r + 1] == run_row + run_rows)
+        run_rows += rows;
+      else
+      {
+        if (run_rows > 0)
+          add_mapping(run_row, run_src_row, run_rows);
+        run_row = layout[3 * r + 1];
+        run_src_row = src_row;
+        run_rows = rows;
+      }
+      src_row += rows;
+    }
+    if (run_rows > 0)
+      add_mapping(run_row, run_src_row, run_rows);
+
+    H5Sclose(src_space);
+  }
+
+  // Create the logical dataset in the main file. Dataset creation is
+  // collective metadata and the mapping is identical on all ranks.
+  add_group(file_handle, group_name);
+  const hid_t dset_id
+      = H5Dcreate2(file_handle, dataset_path.c_str(), hdf5_type<T>(), vspace,
+                   H5P_DEFAULT, dcpl, H5P_DEFAULT);
+  if (dset_id == HDF5_FAIL)
+    throw std::runtime_error("Failed to create HDF5 virtual dataset.");
+  H5Dclose(dset_id);
+  H5Pclose(dcpl);
+  H5Sclose(vspace);
+
+  MPI_Comm_free(&node_comm);
+  if (leader_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&leader_comm);
+  MPI_Comm_free(&comm);
+  if (info != MPI_INFO_NULL)
+    MPI_Info_free(&info);
+#else
+  throw std::runtime_error(
+      "Node-aggregated output requires parallel HDF5 1.10 or newer.");
+#endif
+}
+//---------------------------------------------------------------------------
+template <typename T>
+inline void HDF5Interface::write_dataset_blocked(
+    MPI_Comm comm, const hid_t file_handle, const std::string& dataset_path,
+    const std::function<void(std::int64_t, std::int64_t, T*)>& pack,
+    const std::array<std::int64_t, 2>& range,
+    const std::vector<std::int64_t>& global_size, std::int64_t block_rows,
+    bool use_mpi_io, const HDF5Options& options)
+{
+  assert(block_rows > 0);
+
+  // Data rank
+  const int rank = global_size.size();
+  assert(rank != 0);
+  if (rank > 2)
+  {
+    throw std::runtime_error("Cannot write dataset to HDF5 file. "
+                             "Only rank 1 and rank 2 datasets are supported");
+  }
+
+  // Get HDF5 data type and number of values per row
+  const hid_t h5type = hdf5_type<T>();
+  std::int64_t row_size = 1;
+  for (int i = 1; i < rank; ++i)
+    row_size *= global_size[i];
+
+  // Dataset dimensions
+  const std::vector<hsize_t> dimsf(global_size.begin(), global_size.end());
+
+  // Create a global data space
+  const hid_t filespace0 = H5Screate_simple(rank, dimsf.data(), nullptr);
+  if (filespace0 == HDF5_FAIL)
+    throw std::runtime_error("Failed to create HDF5 data space");
+
+  // Set chunking parameters (see write_dataset)
+  hid_t chunking_properties = H5P_DEFAULT;
+  if (options.chunk_rows > 0 or options.deflate > 0 or options.shuffle)
+  {
+    hsize_t chunk_size;
+    if (options.chunk_rows > 0)
+      chunk_size = options.chunk_rows;
+    else
+    {
+      chunk_size = dimsf[0] / 2;
+      if (chunk_size > 1048576)
+        chunk_size = 1048576;
+      if (chunk_size < 1024)
+        chunk_size = 1024;
+    }
+    if (dimsf[0] > 0 and chunk_size > dimsf[0])
+      chunk_size = dimsf[0];
+
+    std::vector<hsize_t> chunk_dims = dimsf;
+    chunk_dims[0] = chunk_size;
+    chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(chunking_properties, rank, chunk_dims.data());
+    if (options.shuffle)
+      H5Pset_shuffle(chunking_properties);
+    if (options.deflate > 0)
+      H5Pset_deflate(chunking_properties, options.deflate);
+  }
+
+  // Check that group exists and recursively create if required
+  const std::string group_name(dataset_path, 0, dataset_path.rfind('/'));
+  add_group(file_handle, group_name);
+
+  // Create global dataset (using dataset_path)
+  const hid_t dset_id
+      = H5Dcreate2(file_handle, dataset_path.c_str(), h5type, filespace0,
+                   H5P_DEFAULT, chunking_properties, H5P_DEFAULT);
+  if (dset_id == HDF5_FAIL)
+    throw std::runtime_error("Failed to create HDF5 global dataset.");
+
+  herr_t status = H5Sclose(filespace0);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to close HDF5 global data space.");
+
+  // Set parallel access
+  const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+  if (use_mpi_io)
+  {
+#ifdef H5_HAVE_PARALLEL
+    status = H5Pset_dxpl_mpio(plist_id, options.collective
+                                            ? H5FD_MPIO_COLLECTIVE
+                                            : H5FD_MPIO_INDEPENDENT);
+    if (status == HDF5_FAIL)
+    {
+      throw std::runtime_error(
+          "Failed to set HDF5 data transfer property list.");
+    }
+#else
+    throw std::runtime_error("HDF5 library has not been configured with MPI");
+#endif
+  }
+
+  // With collective transfers every process must take part in every
+  // write, so all processes make the maximum number of rounds (with an
+  // empty selection once their own rows are exhausted)
+  const std::int64_t num_local_rows = range[1] - range[0];
+  std::int64_t num_rounds = (num_local_rows + block_rows - 1) / block_rows;
+  if (use_mpi_io and options.collective)
   {
+    MPI_Allreduce(MPI_IN_PLACE, &num_rounds, 1, MPI_INT64_T, MPI_MAX, comm);
+  }
+
+  std::vector<T> buffer(block_rows * row_size);
+  const hid_t filespace1 = H5Dget_space(dset_id);
+  for (std::int64_t round = 0; round < num_rounds; ++round)
+  {
+    const std::int64_t row0 = std::min(round * block_rows, num_local_rows);
+    const std::int64_t num_rows = std::min(block_rows, num_local_rows - row0);
+    if (num_rows > 0)
+      pack(row0, num_rows, buffer.data());
+
+    std::vector<hsize_t> count = dimsf;
+    count[0] = num_rows;
+    const hid_t memspace = H5Screate_simple(rank, count.data(), nullptr);
+    if (memspace == HDF5_FAIL)
+      throw std::runtime_error("Failed to create HDF5 local data space.");
+
+    if (num_rows > 0)
+    {
+      std::vector<hsize_t> offset(rank, 0);
+      offset[0] = range[0] + row0;
+      status = H5Sselect_hyperslab(filespace1, H5S_SELECT_SET, offset.data(),
+                                   nullptr, count.data(), nullptr);
+    }
+    else
+      status = H5Sselect_none(filespace1);
+    if (status == HDF5_FAIL)
+      throw std::runtime_error("Failed to create HDF5 dataspace.");
+
+    status = H5Dwrite(dset_id, h5type, memspace, filespace1, plist_id,
+                      buffer.data());
+    if (status == HDF5_FAIL)
+    {
+      throw std::runtime_error(
+          "Failed to write HDF5 local dataset into hyperslab.");
+    }
+
+    status = H5Sclose(memspace);
+    if (status == HDF5_FAIL)
+      throw std::runtime_error("Failed to close local HDF5 dataset.");
+  }
+
+  if (chunking_properties != H5P_DEFAULT)
+  {
+    status = H5Pclose(chunking_properties);
+    if (status == HDF5_FAIL)
+      throw std::runtime_error("Failed to close HDF5 chunking properties.");
+  }
+  status = H5Dclose(dset_id);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to close HDF5 dataset.");
+  status = H5Sclose(filespace1);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to close HDF5 hyperslab.");
+  status = H5Pclose(plist_id);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to release HDF5 file-access template.");
+}
+//---------------------------------------------------------------------------
+template <typename T>
+inline std::int64_t HDF5Interface::append_dataset(
+    const hid_t file_handle, const std::string& dataset_path, const T* data,
+    const std::array<std::int64_t, 2>& range,
+    const std::vector<std::int64_t>& global_size, bool use_mpi_io,
+    const HDF5Options& options)
+{
+  // Data rank
+  const int rank = global_size.size();
+  assert(rank != 0);
+  if (rank > 2)
+  {
+    throw std::runtime_error("Cannot append dataset to HDF5 file. "
+                             "Only rank 1 and rank 2 datasets are supported");
+  }
+
+  // Get HDF5 data type
+  const hid_t h5type = hdf5_type<T>();
+
+  // Dimensions of the block being appended
+  const std::vector<hsize_t> block_dims(global_size.begin(), global_size.end());
+
+  // Generic status report
+  herr_t status;
+
+  hid_t dset_id;
+  hsize_t old_rows = 0;
+  if (!has_dataset(file_handle, dataset_path))
+  {
+    // Create an extensible dataset with an unlimited first dimension.
+    // A chunked layout is mandatory for extensible datasets.
+    std::vector<hsize_t> maxdims = block_dims;
+    maxdims[0] = H5S_UNLIMITED;
+    const hid_t filespace0
+        = H5Screate_simple(rank, block_dims.data(), maxdims.data());
+    if (filespace0 == HDF5_FAIL)
+      throw std::runtime_error("Failed to create HDF5 data space");
+
+    // One appended block per chunk by default, limited to 1kB min/1MB
+    // max rows
+    hsize_t chunk_size;
+    if (options.chunk_rows > 0)
+      chunk_size = options.chunk_rows;
+    else
+    {
+      chunk_size = block_dims[0];
+      if (chunk_size > 1048576)
+        chunk_size = 1048576;
+      if (chunk_size < 1024)
+        chunk_size = 1024;
+    }
+
+    std::vector<hsize_t> chunk_dims = block_dims;
+    chunk_dims[0] = chunk_size;
+    const hid_t chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(chunking_properties, rank, chunk_dims.data());
+    if (options.shuffle)
+      H5Pset_shuffle(chunking_properties);
+    if (options.deflate > 0)
+      H5Pset_deflate(chunking_properties, options.deflate);
+
+    // Check that group exists and recursively create if required
+    const std::string group_name(dataset_path, 0, dataset_path.rfind('/'));
+    add_group(file_handle, group_name);
+
+    // Create global dataset (using dataset_path)
+    dset_id = H5Dcreate2(file_handle, dataset_path.c_str(), h5type, filespace0,
+                         H5P_DEFAULT, chunking_properties, H5P_DEFAULT);
+    if (dset_id == HDF5_FAIL)
+      throw std::runtime_error("Failed to create HDF5 global dataset.");
+
     // Close chunking properties
     status = H5Pclose(chunking_properties);
     if (status == HDF5_FAIL)
       throw std::runtime_error("Failed to close HDF5 chunking properties.");
+
+    // Close global data space
+    status = H5Sclose(filespace0);
+    if (status == HDF5_FAIL)
+      throw std::runtime_error("Failed to close HDF5 global data space.");
+  }
+  else
+  {
+    // Open the existing dataset and extend it by the appended block
+    dset_id = H5Dopen2(file_handle, dataset_path.c_str(), H5P_DEFAULT);
+    if (dset_id == HDF5_FAIL)
+      throw std::runtime_error("Failed to open HDF5 global dataset.");
+
+    const hid_t dataspace = H5Dget_space(dset_id);
+    if (dataspace == HDF5_FAIL)
+      throw std::runtime_error("Failed to open HDF5 data space.");
+    std::vector<hsize_t> shape(rank);
+    const int ndims
+        = H5Sget_simple_extent_dims(dataspace, shape.data(), nullptr);
+    if (ndims != rank)
+      throw std::runtime_error("Wrong dimensionality of extensible dataset");
+    status = H5Sclose(dataspace);
+    if (status == HDF5_FAIL)
+      throw std::runtime_error("Failed to close HDF5 dataspace.");
+
+    for (int i = 1; i < rank; ++i)
+    {
+      if (shape[i] != block_dims[i])
+      {
+        throw std::runtime_error("Cannot append to HDF5 dataset. Trailing "
+                                 "dimensions do not match");
+      }
+    }
+
+    old_rows = shape[0];
+    std::vector<hsize_t> new_dims = shape;
+    new_dims[0] = old_rows + block_dims[0];
+    status = H5Dset_extent(dset_id, new_dims.data());
+    if (status == HDF5_FAIL)
+      throw std::runtime_error("Failed to extend HDF5 dataset.");
+  }
+
+  // Hyperslab selection for this process' rows of the appended block
+  std::vector<hsize_t> offset(rank, 0);
+  offset[0] = old_rows + range[0];
+  std::vector<hsize_t> count = block_dims;
+  count[0] = range[1] - range[0];
+
+  // Create a local data space
+  const hid_t memspace = H5Screate_simple(rank, count.data(), nullptr);
+  if (memspace == HDF5_FAIL)
+    throw std::runtime_error("Failed to create HDF5 local data space.");
+
+  // Create a file dataspace within the extended space - a hyperslab
+  const hid_t filespace1 = H5Dget_space(dset_id);
+  status = H5Sselect_hyperslab(filespace1, H5S_SELECT_SET, offset.data(),
+                               nullptr, count.data(), nullptr);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to create HDF5 dataspace.");
+
+  // Set parallel access
+  const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+  if (use_mpi_io)
+  {
+#ifdef H5_HAVE_PARALLEL
+    status = H5Pset_dxpl_mpio(plist_id, options.collective
+                                            ? H5FD_MPIO_COLLECTIVE
+                                            : H5FD_MPIO_INDEPENDENT);
+    if (status == HDF5_FAIL)
+    {
+      throw std::runtime_error(
+          "Failed to set HDF5 data transfer property list.");
+    }
+#else
+    throw std::runtime_error("HDF5 library has not been configured with MPI");
+#endif
+  }
+
+  // Write local dataset into selected hyperslab
+  status = H5Dwrite(dset_id, h5type, memspace, filespace1, plist_id, data);
+  if (status == HDF5_FAIL)
+  {
+    throw std::runtime_error(
+        "Failed to write HDF5 local dataset into hyperslab.");
   }
 
   // Close dataset collectively
@@ -290,6 +1041,8 @@ inline void HDF5Interface::write_dataset(
   status = H5Pclose(plist_id);
   if (status == HDF5_FAIL)
     throw std::runtime_error("Failed to release HDF5 file-access template.");
+
+  return old_rows;
 }
 //---------------------------------------------------------------------------
 template <typename T>
@@ -385,5 +1138,97 @@ HDF5Interface::read_dataset(const hid_t file_handle,
   return data;
 }
 //---------------------------------------------------------------------------
+template <typename T>
+inline std::vector<T> HDF5Interface::read_dataset_rows(
+    const hid_t file_handle, const std::string& dataset_path,
+    const xtl::span<const std::int64_t>& rows)
+{
+  assert(std::is_sorted(rows.begin(), rows.end()));
+
+  // Open the dataset
+  const hid_t dset_id
+      = H5Dopen2(file_handle, dataset_path.c_str(), H5P_DEFAULT);
+  if (dset_id == HDF5_FAIL)
+    throw std::runtime_error("Failed to open HDF5 global dataset.");
+
+  // Open dataspace
+  const hid_t dataspace = H5Dget_space(dset_id);
+  if (dataspace == HDF5_FAIL)
+    throw std::runtime_error("Failed to open HDF5 data space.");
+
+  // Get rank of data set
+  const int rank = H5Sget_simple_extent_ndims(dataspace);
+  assert(rank >= 1);
+  if (rank > 2)
+  {
+    throw std::runtime_error("Cannot read selected rows. Only rank 1 and "
+                             "rank 2 datasets are supported");
+  }
+
+  // Get size in each dimension
+  std::vector<hsize_t> shape(rank);
+  const int ndims = H5Sget_simple_extent_dims(dataspace, shape.data(), nullptr);
+  if (ndims != rank)
+    throw std::runtime_error("Failed to get dimensionality of dataspace");
+
+  // Build a union of hyperslabs, one block per run of consecutive rows.
+  // The union is read in increasing file order, which matches the order
+  // of the (sorted) requested rows.
+  [[maybe_unused]] herr_t status = H5Sselect_none(dataspace);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to clear HDF5 dataspace selection.");
+  std::vector<hsize_t> offset(rank, 0);
+  std::vector<hsize_t> count = shape;
+  for (std::size_t i = 0; i < rows.size();)
+  {
+    std::size_t j = i + 1;
+    while (j < rows.size() and rows[j] == rows[j - 1] + 1)
+      ++j;
+    offset[0] = rows[i];
+    count[0] = j - i;
+    status = H5Sselect_hyperslab(dataspace, H5S_SELECT_OR, offset.data(),
+                                 nullptr, count.data(), nullptr);
+    if (status == HDF5_FAIL)
+      throw std::runtime_error("Failed to select HDF5 hyperslab.");
+    i = j;
+  }
+
+  // Create a contiguous memory dataspace for the selected rows
+  count[0] = rows.size();
+  const hid_t memspace = H5Screate_simple(rank, count.data(), nullptr);
+  if (memspace == HDF5_FAIL)
+    throw std::runtime_error("Failed to create HDF5 dataspace.");
+
+  // Create local data to read into
+  std::size_t data_size = 1;
+  for (std::size_t i = 0; i < count.size(); ++i)
+    data_size *= count[i];
+  std::vector<T> data(data_size);
+
+  // Read data on each process
+  const hid_t h5type = hdf5_type<T>();
+  status
+      = H5Dread(dset_id, h5type, memspace, dataspace, H5P_DEFAULT, data.data());
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to read HDF5 data.");
+
+  // Close dataspace
+  status = H5Sclose(dataspace);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to close HDF5 dataspace.");
+
+  // Close memspace
+  status = H5Sclose(memspace);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to close HDF5 memory space.");
+
+  // Close dataset
+  status = H5Dclose(dset_id);
+  if (status == HDF5_FAIL)
+    throw std::runtime_error("Failed to close HDF5 dataset.");
+
+  return data;
+}
+//---------------------------------------------------------------------------
 /// @endcond
 } // namespace dolfinx::io
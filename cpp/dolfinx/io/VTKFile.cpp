@@ -16,11 +16,15 @@
 #include <dolfinx/fem/Function.h>
 #include <dolfinx/fem/FunctionSpace.h>
 #include <dolfinx/la/PETScVector.h>
+#include <cstdint>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <fstream>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <vector>
 #include <xtensor/xcomplex.hpp>
 #include <xtl/xspan.hpp>
 
@@ -104,16 +108,210 @@ std::int8_t get_vtk_cell_type(mesh::CellType cell, int dim)
   }
 }
 
-/// Convert an xtensor to a std::string
+//----------------------------------------------------------------------------
+/// Collects the binary blocks for the raw "AppendedData" section of a
+/// VTU file. Each block is prefixed by its byte count (UInt64 header).
+class AppendedData
+{
+public:
+  /// Append an array and return its byte offset into the section
+  template <typename T>
+  std::size_t add(const T* data, std::size_t size)
+  {
+    const std::size_t offset = _buffer.size();
+    const std::uint64_t num_bytes = size * sizeof(T);
+    const char* header = reinterpret_cast<const char*>(&num_bytes);
+    _buffer.insert(_buffer.end(), header, header + sizeof(num_bytes));
+    const char* bytes = reinterpret_cast<const char*>(data);
+    _buffer.insert(_buffer.end(), bytes, bytes + num_bytes);
+    return offset;
+  }
+
+  /// Append an already-encoded raw block (array headers included) and
+  /// return its byte offset into the section
+  std::size_t add_raw(const char* data, std::size_t size)
+  {
+    const std::size_t offset = _buffer.size();
+    _buffer.insert(_buffer.end(), data, data + size);
+    return offset;
+  }
+
+  /// The raw section data
+  const std::vector<char>& buffer() const { return _buffer; }
+
+private:
+  std::vector<char> _buffer;
+};
+//----------------------------------------------------------------------------
+/// Add a DataArray node. With appended encoding the data is pushed to
+/// the AppendedData section, otherwise it is written as ASCII text.
 template <typename T>
-std::string xt_to_string(const T& x, int precision)
+void add_data_array(pugi::xml_node& node, const std::string& type,
+                    const std::string& name, int num_components, const T* data,
+                    std::size_t size, AppendedData* appended)
 {
+  pugi::xml_node data_node = node.append_child("DataArray");
+  data_node.append_attribute("type") = type.c_str();
+  if (!name.empty())
+    data_node.append_attribute("Name") = name.c_str();
+  if (num_components > 0)
+    data_node.append_attribute("NumberOfComponents") = num_components;
+  if (appended)
+  {
+    data_node.append_attribute("format") = "appended";
+    data_node.append_attribute("offset")
+        = std::to_string(appended->add(data, size)).c_str();
+  }
+  else
+  {
+    data_node.append_attribute("format") = "ascii";
+    std::stringstream s;
+    s.precision(16);
+    for (std::size_t i = 0; i < size; ++i)
+      s << +data[i] << " ";
+    data_node.append_child(pugi::node_pcdata).set_value(s.str().c_str());
+  }
+}
+//----------------------------------------------------------------------------
+/// Save a VTU (or PVTU) XML document. With appended encoding the raw
+/// binary section is spliced in before the closing tag, since it holds
+/// arbitrary bytes and cannot go through pugixml.
+void save_vtu(pugi::xml_document& xml, const boost::filesystem::path& path,
+              const AppendedData* appended)
+{
+  if (!appended)
+  {
+    xml.save_file(path.c_str(), "  ");
+    return;
+  }
+
   std::stringstream s;
-  s.precision(precision);
-  std::for_each(x.begin(), x.end(), [&s](auto e) { s << e << " "; });
-  return s.str();
+  xml.save(s, "  ");
+  const std::string xml_str = s.str();
+  const std::string closing = "</VTKFile>";
+  const std::size_t pos = xml_str.rfind(closing);
+  assert(pos != std::string::npos);
+
+  std::ofstream file(path.string(), std::ios::binary);
+  if (!file)
+  {
+    throw std::runtime_error(
+        "Could not write VTKFile. Does the directory "
+        "exists and do you have read/write permissions?");
+  }
+  file.write(xml_str.data(), pos);
+  file << "<AppendedData encoding=\"raw\">\n_";
+  file.write(appended->buffer().data(), appended->buffer().size());
+  file << "\n</AppendedData>\n" << closing << "\n";
+}
+//----------------------------------------------------------------------------
+/// Compute the path of the .vtu file holding piece @p index
+boost::filesystem::path vtu_path(const boost::filesystem::path& p, int index,
+                                 const std::string& counter_str)
+{
+  boost::filesystem::path vtu(p.parent_path());
+  if (!p.parent_path().empty())
+    vtu += "/";
+  vtu += p.stem().string() + "_p" + std::to_string(index) + "_" + counter_str;
+  vtu.replace_extension("vtu");
+  return vtu;
 }
+//----------------------------------------------------------------------------
+/// Save this rank's VTU document. Without aggregation
+/// (node_comm == MPI_COMM_NULL) every rank saves its own piece file.
+/// Otherwise the Piece nodes of the aggregation group (and their
+/// appended data, with rebased offsets) are gathered on the group
+/// leader, which writes them as a single multi-piece .vtu file.
+void save_piece_files(MPI_Comm comm, MPI_Comm node_comm, int file_index,
+                      pugi::xml_document& xml_vtu,
+                      const AppendedData* appended,
+                      const boost::filesystem::path& p,
+                      const std::string& counter_str)
+{
+  if (node_comm == MPI_COMM_NULL)
+  {
+    save_vtu(xml_vtu, vtu_path(p, dolfinx::MPI::rank(comm), counter_str),
+             appended);
+    return;
+  }
+
+  // Serialize this rank's Piece subtree
+  std::stringstream s;
+  pugi::xml_node piece
+      = xml_vtu.child("VTKFile").child("UnstructuredGrid").child("Piece");
+  assert(piece);
+  piece.print(s, "  ");
+  const std::string piece_str = s.str();
+
+  const int node_rank = dolfinx::MPI::rank(node_comm);
+  const int node_size = dolfinx::MPI::size(node_comm);
+
+  // Gather the XML fragments (and the appended binary sections) of the
+  // group on the leader
+  auto gather_chars = [node_comm, node_rank,
+                       node_size](const char* data, int size,
+                                  std::vector<int>& disp)
+  {
+    std::vector<int> count(node_rank == 0 ? node_size : 0);
+    MPI_Gather(&size, 1, MPI_INT, count.data(), 1, MPI_INT, 0, node_comm);
+    disp.assign(count.size() + 1, 0);
+    std::partial_sum(count.begin(), count.end(), disp.begin() + 1);
+    std::vector<char> recv(disp.back());
+    MPI_Gatherv(data, size, MPI_CHAR, recv.data(), count.data(), disp.data(),
+                MPI_CHAR, 0, node_comm);
+    return recv;
+  };
+
+  std::vector<int> xml_disp, data_disp;
+  const std::vector<char> xml_recv
+      = gather_chars(piece_str.data(), int(piece_str.size()), xml_disp);
+  std::vector<char> data_recv;
+  if (appended)
+  {
+    data_recv = gather_chars(appended->buffer().data(),
+                             int(appended->buffer().size()), data_disp);
+  }
+
+  if (node_rank != 0)
+    return;
 
+  // Build the multi-piece VTU document, copying the root attributes of
+  // this rank's document
+  pugi::xml_document xml_agg;
+  pugi::xml_node vtk_node = xml_agg.append_child("VTKFile");
+  for (pugi::xml_attribute attr : xml_vtu.child("VTKFile").attributes())
+    vtk_node.append_copy(attr);
+  pugi::xml_node grid_node = vtk_node.append_child("UnstructuredGrid");
+
+  AppendedData merged;
+  if (appended)
+    merged.add_raw(data_recv.data(), data_recv.size());
+  for (int i = 0; i < node_size; ++i)
+  {
+    pugi::xml_document fragment;
+    [[maybe_unused]] pugi::xml_parse_result result = fragment.load_buffer(
+        xml_recv.data() + xml_disp[i], xml_disp[i + 1] - xml_disp[i]);
+    assert(result);
+
+    // Shift the appended-data offsets of this piece by the position of
+    // its binary section in the merged section
+    if (appended)
+    {
+      for (pugi::xpath_node xnode :
+           fragment.select_nodes("//DataArray[@format='appended']"))
+      {
+        pugi::xml_attribute offset = xnode.node().attribute("offset");
+        offset.set_value(
+            std::to_string(offset.as_ullong() + data_disp[i]).c_str());
+      }
+    }
+    grid_node.append_copy(fragment.child("Piece"));
+  }
+
+  save_vtu(xml_agg, vtu_path(p, file_index, counter_str),
+           appended ? &merged : nullptr);
+}
+//----------------------------------------------------------------------------
 void add_pvtu_mesh(pugi::xml_node& node)
 {
   pugi::xml_node vertex_data_node = node.append_child("PPoints");
@@ -125,7 +323,8 @@ void add_pvtu_mesh(pugi::xml_node& node)
 /// At data to a pugixml node
 template <typename Scalar>
 void _add_data(const fem::Function<Scalar>& u,
-               const xt::xtensor<Scalar, 2>& values, pugi::xml_node& data_node)
+               const xt::xtensor<Scalar, 2>& values, pugi::xml_node& data_node,
+               AppendedData* appended)
 {
   const int rank = u.function_space()->element()->value_rank();
   const int dim = u.function_space()->element()->value_size();
@@ -153,6 +352,9 @@ void _add_data(const fem::Function<Scalar>& u,
         "Cannot write data to VTK file. "
         "Only scalar, vector and tensor functions can be saved in VTK format");
   }
+  // Vectors and tensors are padded to three dimensions
+  const int ncomps = rank == 0 ? dim : (rank == 1 ? 3 : 9);
+
   // Loop for complex numbers, saved as real and imaginary part
   std::vector<std::string> components = {""};
   if constexpr (!std::is_scalar<Scalar>::value)
@@ -160,159 +362,56 @@ void _add_data(const fem::Function<Scalar>& u,
 
   for (const auto& component : components)
   {
-    if constexpr (!std::is_scalar<Scalar>::value)
+    // Flatten and pad the values. 2D vectors get a zero third
+    // component, and 2x2 tensors are placed in the upper-left block of
+    // a zeroed 3x3 tensor.
+    std::vector<double> data(values.shape(0) * ncomps, 0.0);
+    for (std::size_t i = 0; i < values.shape(0); ++i)
     {
-      pugi::xml_node field_node = data_node.append_child("DataArray");
-      field_node.append_attribute("type") = "Float64";
-      field_node.append_attribute("Name") = (component + "_" + u.name).c_str();
-      field_node.append_attribute("format") = "ascii";
-      xt::xtensor<double, 2> values_comp({values.shape()});
-
-      if (component == "real")
-        values_comp = xt::real(values);
-      else if (component == "imag")
-        values_comp = xt::imag(values);
-      if (rank == 0)
-      {
-        field_node.append_child(pugi::node_pcdata)
-            .set_value(xt_to_string(values_comp, 16).c_str());
-      }
-      else if (rank == 1)
-      {
-        field_node.append_attribute("NumberOfComponents") = 3;
-        if (dim == 2)
-        {
-          assert(values_comp.shape(1) == 2);
-          std::stringstream ss;
-          for (std::size_t i = 0; i < values_comp.shape(0); ++i)
-          {
-            for (int j = 0; j < 2; ++j)
-              ss << values_comp(i, j) << " ";
-            ss << 0.0 << " ";
-          }
-          field_node.append_child(pugi::node_pcdata)
-              .set_value(ss.str().c_str());
-        }
-        else
-        {
-          assert(values_comp.shape(2) == 3);
-          field_node.append_child(pugi::node_pcdata)
-              .set_value(xt_to_string(values_comp, 16).c_str());
-        }
-      }
-      else if (rank == 2)
+      for (std::size_t j = 0; j < values.shape(1); ++j)
       {
-        field_node.append_attribute("NumberOfComponents") = 9;
-        if (dim == 4)
+        const std::size_t jj
+            = (rank == 2 and dim == 4) ? 3 * (j / 2) + j % 2 : j;
+        if constexpr (!std::is_scalar<Scalar>::value)
         {
-          // Pad 2D tensors with 0.0 to make them 3D
-          std::stringstream ss;
-          for (std::size_t i = 0; i < values_comp.shape(0); ++i)
-          {
-            for (int j = 0; j < 2; ++j)
-            {
-              ss << values_comp(i, (2 * j + 0)) << " ";
-              ss << values_comp(i, (2 * j + 1)) << " ";
-              ss << 0.0 << " ";
-            }
-            ss << 0.0 << " ";
-            ss << 0.0 << " ";
-            ss << 0.0 << "  ";
-          }
-          field_node.append_child(pugi::node_pcdata)
-              .set_value(ss.str().c_str());
+          data[i * ncomps + jj] = component == "real"
+                                      ? std::real(values(i, j))
+                                      : std::imag(values(i, j));
         }
         else
-        {
-          field_node.append_child(pugi::node_pcdata)
-              .set_value(xt_to_string(values_comp, 16).c_str());
-        }
+          data[i * ncomps + jj] = values(i, j);
       }
     }
-    else
-    {
-      pugi::xml_node field_node = data_node.append_child("DataArray");
-      field_node.append_attribute("type") = "Float64";
-      field_node.append_attribute("Name") = (component + u.name).c_str();
-      field_node.append_attribute("format") = "ascii";
 
-      if (rank == 0)
-      {
-        field_node.append_child(pugi::node_pcdata)
-            .set_value(xt_to_string(values, 16).c_str());
-      }
-      else if (rank == 1)
-      {
-        field_node.append_attribute("NumberOfComponents") = 3;
-        if (dim == 2)
-        {
-          assert(values.shape(1) == 2);
-          std::stringstream ss;
-          for (size_t i = 0; i < values.shape(0); ++i)
-          {
-            for (int j = 0; j < 2; ++j)
-              ss << values(i, j) << " ";
-            ss << 0.0 << " ";
-          }
-          field_node.append_child(pugi::node_pcdata)
-              .set_value(ss.str().c_str());
-        }
-        else
-        {
-          assert(values.shape(1) == 3);
-          field_node.append_child(pugi::node_pcdata)
-              .set_value(xt_to_string(values, 16).c_str());
-        }
-      }
-      else if (rank == 2)
-      {
-        field_node.append_attribute("NumberOfComponents") = 9;
-        if (dim == 4)
-        {
-          // Pad 2D tensors with 0.0 to make them 3D
-          std::stringstream ss;
-          for (size_t i = 0; i < values.shape(0); ++i)
-          {
-            for (int j = 0; j < 2; ++j)
-            {
-              ss << values(i, (2 * j + 0)) << " ";
-              ss << values(i, (2 * j + 1)) << " ";
-              ss << 0.0 << " ";
-            }
-            ss << 0.0 << " ";
-            ss << 0.0 << " ";
-            ss << 0.0 << "  ";
-          }
-          field_node.append_child(pugi::node_pcdata)
-              .set_value(ss.str().c_str());
-        }
-        else
-        {
-          field_node.append_child(pugi::node_pcdata)
-              .set_value(xt_to_string(values, 16).c_str());
-        }
-      }
-    }
+    std::string name;
+    if constexpr (!std::is_scalar<Scalar>::value)
+      name = component + "_" + u.name;
+    else
+      name = u.name;
+    add_data_array(data_node, "Float64", name, rank > 0 ? ncomps : 0,
+                   data.data(), data.size(), appended);
   }
 }
 //----------------------------------------------------------------------------
 void add_data(const fem::Function<double>& u,
-              const xt::xtensor<double, 2>& values, pugi::xml_node& data_node)
+              const xt::xtensor<double, 2>& values, pugi::xml_node& data_node,
+              AppendedData* appended)
 {
-  _add_data(u, values, data_node);
+  _add_data(u, values, data_node, appended);
 }
 //----------------------------------------------------------------------------
 void add_data(const fem::Function<std::complex<double>>& u,
               const xt::xtensor<std::complex<double>, 2>& values,
-              pugi::xml_node& data_node)
+              pugi::xml_node& data_node, AppendedData* appended)
 {
-  _add_data(u, values, data_node);
+  _add_data(u, values, data_node, appended);
 }
 //----------------------------------------------------------------------------
 
 /// At mesh geometry and topology data to a pugixml node. The function /
 /// adds the Points and Cells nodes to the input node/
-void add_mesh(const mesh::Mesh& mesh, pugi::xml_node& piece_node)
+void add_mesh(const mesh::Mesh& mesh, pugi::xml_node& piece_node,
+              AppendedData* appended)
 {
   const mesh::Topology& topology = mesh.topology();
   const mesh::Geometry& geometry = mesh.geometry();
@@ -322,23 +421,14 @@ void add_mesh(const mesh::Mesh& mesh, pugi::xml_node& piece_node)
   // Add geometry (points)
 
   pugi::xml_node points_node = piece_node.append_child("Points");
-  pugi::xml_node x_node = points_node.append_child("DataArray");
-  x_node.append_attribute("type") = "Float64";
-  x_node.append_attribute("NumberOfComponents") = "3";
-  x_node.append_attribute("format") = "ascii";
   auto x = geometry.x();
-  x_node.append_child(pugi::node_pcdata).set_value(xt_to_string(x, 16).c_str());
+  add_data_array(points_node, "Float64", "", 3, x.data(), x.size(), appended);
 
   // Add topology(cells)
 
   pugi::xml_node cells_node = piece_node.append_child("Cells");
   const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
 
-  pugi::xml_node connectivity_node = cells_node.append_child("DataArray");
-  connectivity_node.append_attribute("type") = "Int32";
-  connectivity_node.append_attribute("Name") = "connectivity";
-  connectivity_node.append_attribute("format") = "ascii";
-
   // Get map from VTK index i to DOLFIN index j
   int num_nodes = geometry.cmap().create_dof_layout().num_dofs();
 
@@ -352,45 +442,34 @@ void add_mesh(const mesh::Mesh& mesh, pugi::xml_node& piece_node)
            22, 7, 2,  11, 5, 14, 8,  17, 20, 23, 24, 25, 26};
   }
 
-  std::stringstream ss;
+  std::vector<std::int32_t> connectivity;
+  connectivity.reserve(x_dofmap.array().size());
   for (int c = 0; c < x_dofmap.num_nodes(); ++c)
   {
     xtl::span<const std::int32_t> cell = x_dofmap.links(c);
     const int num_cell_dofs = cell.size();
     for (int i = 0; i < num_cell_dofs; ++i)
-      ss << cell[map[i]] << " ";
+      connectivity.push_back(cell[map[i]]);
   }
-  connectivity_node.append_child(pugi::node_pcdata).set_value(ss.str().c_str());
+  add_data_array(cells_node, "Int32", "connectivity", 0, connectivity.data(),
+                 connectivity.size(), appended);
 
-  pugi::xml_node offsets_node = cells_node.append_child("DataArray");
-  offsets_node.append_attribute("type") = "Int32";
-  offsets_node.append_attribute("Name") = "offsets";
-  offsets_node.append_attribute("format") = "ascii";
   const std::vector<std::int32_t>& offsets = x_dofmap.offsets();
-  std::stringstream ss_offset;
-  ss_offset.precision(0);
-  for (std::int32_t i = 1; i <= num_cells; ++i)
-    ss_offset << offsets[i] << " ";
-
-  offsets_node.append_child(pugi::node_pcdata)
-      .set_value(ss_offset.str().c_str());
-
-  pugi::xml_node type_node = cells_node.append_child("DataArray");
-  type_node.append_attribute("type") = "Int8";
-  type_node.append_attribute("Name") = "types";
-  type_node.append_attribute("format") = "ascii";
-  int celltype = get_vtk_cell_type(topology.cell_type(), tdim);
-  std::stringstream s;
-  for (std::int32_t c = 0; c < num_cells; ++c)
-    s << celltype << " ";
-  type_node.append_child(pugi::node_pcdata).set_value(s.str().c_str());
+  add_data_array(cells_node, "Int32", "offsets", 0, offsets.data() + 1,
+                 num_cells, appended);
+
+  const std::int8_t celltype = get_vtk_cell_type(topology.cell_type(), tdim);
+  const std::vector<std::int8_t> types(num_cells, celltype);
+  add_data_array(cells_node, "Int8", "types", 0, types.data(), types.size(),
+                 appended);
 }
 //----------------------------------------------------------------------------
 template <typename Scalar>
 void write_function(
     const std::vector<std::reference_wrapper<const fem::Function<Scalar>>>& u,
     double time, std::unique_ptr<pugi::xml_document>& xml_doc,
-    const std::string filename)
+    const std::string filename, io::VTKFile::Encoding encoding,
+    MPI_Comm node_comm, int file_index, int num_files)
 {
   if (!xml_doc)
     throw std::runtime_error("VTKFile has already been closed");
@@ -437,6 +516,14 @@ void write_function(
   pugi::xml_node vtk_node_vtu = xml_vtu.append_child("VTKFile");
   vtk_node_vtu.append_attribute("type") = "UnstructuredGrid";
   vtk_node_vtu.append_attribute("version") = "0.1";
+  AppendedData appended_data;
+  AppendedData* appended = nullptr;
+  if (encoding == io::VTKFile::Encoding::appended)
+  {
+    vtk_node_vtu.append_attribute("byte_order") = "LittleEndian";
+    vtk_node_vtu.append_attribute("header_type") = "UInt64";
+    appended = &appended_data;
+  }
   pugi::xml_node grid_node_vtu = vtk_node_vtu.append_child("UnstructuredGrid");
 
   // Add "Piece" node and required metadata
@@ -445,7 +532,7 @@ void write_function(
   piece_node.append_attribute("NumberOfCells") = num_cells;
 
   // Add mesh data to "Piece" node
-  add_mesh(*mesh, piece_node);
+  add_mesh(*mesh, piece_node, appended);
 
   // Loop through functions to add data types and ranks
   for (auto _u : u)
@@ -496,7 +583,7 @@ void write_function(
       }
       pugi::xml_node data_node = piece_node.child("CellData");
       assert(!data_node.empty());
-      add_data(_u, _values, data_node);
+      add_data(_u, _values, data_node, appended);
     }
     else
     {
@@ -605,7 +692,7 @@ void write_function(
           point_values = _u.get().compute_point_values();
         pugi::xml_node data_node = piece_node.child("PointData");
         assert(!data_node.empty());
-        add_data(_u, point_values, data_node);
+        add_data(_u, point_values, data_node, appended);
       }
       else
       {
@@ -614,21 +701,17 @@ void write_function(
         xt::xtensor<Scalar, 2> point_values = _u.get().compute_point_values();
         pugi::xml_node data_node = piece_node.child("PointData");
         assert(!data_node.empty());
-        add_data(_u, point_values, data_node);
+        add_data(_u, point_values, data_node, appended);
         // throw std::runtime_error("Can only visualize Lagrange finite
         // elements");
       }
     }
   }
 
-  // Save VTU XML to file
-  boost::filesystem::path vtu(p.parent_path());
-  if (!p.parent_path().empty())
-    vtu += "/";
-  vtu += p.stem().string() + "_p" + std::to_string(mpi_rank) + "_"
-         + counter_str;
-  vtu.replace_extension("vtu");
-  xml_vtu.save_file(vtu.c_str(), "  ");
+  // Save VTU XML to file (one file per rank, or one per aggregation
+  // group)
+  save_piece_files(comm, node_comm, file_index, xml_vtu, appended, p,
+                   counter_str);
 
   // Create a PVTU XML object on rank 0
   boost::filesystem::path p_pvtu(p.parent_path());
@@ -686,9 +769,11 @@ void write_function(
         data_node.append_attribute("NumberOfComponents") = ncomps;
       }
 
-      // Add data for each process to the PVTU object
-      const int mpi_size = dolfinx::MPI::size(comm);
-      for (int i = 0; i < mpi_size; ++i)
+      // Add data for each piece file to the PVTU object
+      const int num_pieces = node_comm == MPI_COMM_NULL
+                                 ? dolfinx::MPI::size(comm)
+                                 : num_files;
+      for (int i = 0; i < num_pieces; ++i)
       {
         boost::filesystem::path vtu = p.stem();
         vtu += "_p" + std::to_string(i) + "_" + counter_str;
@@ -715,8 +800,9 @@ void write_function(
 
 //----------------------------------------------------------------------------
 io::VTKFile::VTKFile(MPI_Comm comm, const std::string filename,
-                     const std::string)
-    : _filename(filename), _comm(comm)
+                     const std::string, const Encoding encoding,
+                     const Aggregation aggregation)
+    : _filename(filename), _comm(comm), _encoding(encoding)
 {
   _pvd_xml = std::make_unique<pugi::xml_document>();
   assert(_pvd_xml);
@@ -724,12 +810,38 @@ io::VTKFile::VTKFile(MPI_Comm comm, const std::string filename,
   vtk_node.append_attribute("type") = "Collection";
   vtk_node.append_attribute("version") = "0.1";
   vtk_node.append_child("Collection");
+
+  // Build the intra-group communicator used to aggregate pieces, and
+  // number the groups (one output .vtu file per group)
+  if (aggregation == Aggregation::all)
+  {
+    MPI_Comm_dup(_comm.comm(), &_node_comm);
+    _num_files = 1;
+  }
+  else if (aggregation == Aggregation::node)
+  {
+    MPI_Comm_split_type(_comm.comm(), MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                        &_node_comm);
+    const int node_rank = MPI::rank(_node_comm);
+    MPI_Comm leader_comm;
+    MPI_Comm_split(_comm.comm(), node_rank == 0 ? 0 : MPI_UNDEFINED,
+                   MPI::rank(_comm.comm()), &leader_comm);
+    if (leader_comm != MPI_COMM_NULL)
+    {
+      _file_index = MPI::rank(leader_comm);
+      _num_files = MPI::size(leader_comm);
+      MPI_Comm_free(&leader_comm);
+    }
+    MPI_Bcast(&_file_index, 1, MPI_INT, 0, _node_comm);
+  }
 }
 //----------------------------------------------------------------------------
 io::VTKFile::~VTKFile()
 {
   if (_pvd_xml and MPI::rank(_comm.comm()) == 0)
     _pvd_xml->save_file(_filename.c_str(), "  ");
+  if (_node_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&_node_comm);
 }
 //----------------------------------------------------------------------------
 void io::VTKFile::close()
@@ -759,7 +871,8 @@ void io::VTKFile::write(
     const std::vector<std::reference_wrapper<const fem::Function<double>>>& u,
     double time)
 {
-  write_function(u, time, _pvd_xml, _filename);
+  write_function(u, time, _pvd_xml, _filename, _encoding, _node_comm,
+                 _file_index, _num_files);
 }
 //----------------------------------------------------------------------------
 void io::VTKFile::write(
@@ -767,7 +880,8 @@ void io::VTKFile::write(
         std::reference_wrapper<const fem::Function<std::complex<double>>>>& u,
     double time)
 {
-  write_function(u, time, _pvd_xml, _filename);
+  write_function(u, time, _pvd_xml, _filename, _encoding, _node_comm,
+                 _file_index, _num_files);
 }
 //----------------------------------------------------------------------------
 void io::VTKFile::write(const mesh::Mesh& mesh, double time)
@@ -799,6 +913,14 @@ void io::VTKFile::write(const mesh::Mesh& mesh, double time)
   pugi::xml_node vtk_node_vtu = xml_vtu.append_child("VTKFile");
   vtk_node_vtu.append_attribute("type") = "UnstructuredGrid";
   vtk_node_vtu.append_attribute("version") = "0.1";
+  AppendedData appended_data;
+  AppendedData* appended = nullptr;
+  if (_encoding == Encoding::appended)
+  {
+    vtk_node_vtu.append_attribute("byte_order") = "LittleEndian";
+    vtk_node_vtu.append_attribute("header_type") = "UInt64";
+    appended = &appended_data;
+  }
   pugi::xml_node grid_node_vtu = vtk_node_vtu.append_child("UnstructuredGrid");
 
   // Add "Piece" node and required metadata
@@ -807,16 +929,12 @@ void io::VTKFile::write(const mesh::Mesh& mesh, double time)
   piece_node.append_attribute("NumberOfCells") = num_cells;
 
   // Add mesh data to "Piece" node
-  add_mesh(mesh, piece_node);
+  add_mesh(mesh, piece_node, appended);
 
-  // Save VTU XML to file
-  boost::filesystem::path vtu(p.parent_path());
-  if (!p.parent_path().empty())
-    vtu += "/";
-  vtu += p.stem().string() + "_p" + std::to_string(mpi_rank) + "_"
-         + counter_str;
-  vtu.replace_extension("vtu");
-  xml_vtu.save_file(vtu.c_str(), "  ");
+  // Save VTU XML to file (one file per rank, or one per aggregation
+  // group)
+  save_piece_files(_comm.comm(), _node_comm, _file_index, xml_vtu, appended, p,
+                   counter_str);
 
   // Create a PVTU XML object on rank 0
   boost::filesystem::path p_pvtu(p.parent_path());
@@ -836,9 +954,10 @@ void io::VTKFile::write(const mesh::Mesh& mesh, double time)
     // Add mesh metadata to PVTU object
     add_pvtu_mesh(grid_node);
 
-    // Add data for each process to the PVTU object
-    const int mpi_size = MPI::size(_comm.comm());
-    for (int i = 0; i < mpi_size; ++i)
+    // Add data for each piece file to the PVTU object
+    const int num_pieces
+        = _node_comm == MPI_COMM_NULL ? MPI::size(_comm.comm()) : _num_files;
+    for (int i = 0; i < num_pieces; ++i)
     {
       boost::filesystem::path vtu = p.stem();
       vtu += "_p" + std::to_string(i) + "_" + counter_str;
@@ -44,9 +44,38 @@ namespace dolfinx::io
 class VTKFile
 {
 public:
+  /// File encoding type. Appended encoding stores the array data as
+  /// raw binary in the "AppendedData" section of the VTU file, which
+  /// is much smaller and faster to write than ASCII. ASCII is retained
+  /// as a human-readable debug option.
+  enum class Encoding
+  {
+    appended,
+    ASCII
+  };
+
+  /// Default encoding type
+  static const Encoding default_encoding = Encoding::appended;
+
+  /// Aggregation of VTU pieces into shared files. With `node`
+  /// aggregation the pieces of all ranks on a shared-memory node are
+  /// gathered over the intra-node communicator and written as one
+  /// multi-piece .vtu file per node by the node leader; `all` gathers
+  /// every piece into a single .vtu written by rank 0. Aggregation
+  /// avoids creating one file per rank per step, which becomes a
+  /// metadata storm at large rank counts.
+  enum class Aggregation
+  {
+    none,
+    node,
+    all
+  };
+
   /// Create VTK file
   VTKFile(MPI_Comm comm, const std::string filename,
-          const std::string file_mode);
+          const std::string file_mode,
+          const Encoding encoding = default_encoding,
+          const Aggregation aggregation = Aggregation::none);
 
   /// Destructor
   ~VTKFile();
@@ -85,5 +114,19 @@ private:
 
   // MPI communicator
   dolfinx::MPI::Comm _comm;
+
+  // File encoding
+  Encoding _encoding;
+
+  // Intra-group communicator for piece aggregation (MPI_COMM_NULL when
+  // every rank writes its own piece file)
+  MPI_Comm _node_comm = MPI_COMM_NULL;
+
+  // Index of the .vtu file written by this rank's aggregation group
+  int _file_index = 0;
+
+  // Number of .vtu files per step (valid on rank 0, which writes the
+  // .pvtu)
+  int _num_files = 0;
 };
 } // namespace dolfinx::io
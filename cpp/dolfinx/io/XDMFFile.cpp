@@ -22,17 +22,52 @@
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/MeshTags.h>
 #include <dolfinx/mesh/utils.h>
+#include <fstream>
+#include <numeric>
 
 using namespace dolfinx;
 using namespace dolfinx::io;
 
 namespace
 {
+//-----------------------------------------------------------------------------
+
+/// Read an XML file on rank 0 and parse the broadcast bytes on every
+/// rank. Only one rank touches the file system, which avoids
+/// simultaneous metadata reads of the same small file at large rank
+/// counts; the parse itself is from memory and cheap.
+void load_xml_file(MPI_Comm comm, const std::string& filename,
+                   pugi::xml_document& xml_doc)
+{
+  std::vector<char> buffer;
+  std::int64_t size = -1;
+  if (dolfinx::MPI::rank(comm) == 0)
+  {
+    if (std::ifstream file(filename, std::ios::binary); file)
+    {
+      buffer.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+      size = buffer.size();
+    }
+  }
+
+  MPI_Bcast(&size, 1, MPI_INT64_T, 0, comm);
+  if (size < 0)
+    throw std::runtime_error("Failed to load xml document from file.");
+  buffer.resize(size);
+  MPI_Bcast(buffer.data(), size, MPI_CHAR, 0, comm);
+
+  pugi::xml_parse_result result
+      = xml_doc.load_buffer(buffer.data(), buffer.size());
+  if (!result)
+    throw std::runtime_error("Failed to load xml document from file.");
+}
+//-----------------------------------------------------------------------------
 template <typename Scalar>
 void _write_function(dolfinx::MPI::Comm& comm,
                      const fem::Function<Scalar>& function, const double t,
                      const std::string& mesh_xpath, pugi::xml_document& xml_doc,
-                     hid_t h5_id, const std::string& filename)
+                     hid_t h5_id, const io::HDF5Options& options)
 {
   const std::string timegrid_xpath
       = "/Xdmf/Domain/Grid[@GridType='Collection'][@Name='" + function.name
@@ -76,11 +111,73 @@ void _write_function(dolfinx::MPI::Comm& comm,
   assert(time_node);
 
   // Add the mesh Grid to the domain
-  xdmf_function::add_function(comm.comm(), function, t, grid_node, h5_id);
+  xdmf_function::add_function(comm.comm(), function, t, grid_node, h5_id,
+                              options);
+}
+//-----------------------------------------------------------------------------
+template <typename Scalar>
+void _write_function_restricted(dolfinx::MPI::Comm& comm,
+                                const fem::Function<Scalar>& function,
+                                const double t, int dim,
+                                const xtl::span<const std::int32_t>& entities,
+                                const std::string& name,
+                                pugi::xml_document& xml_doc, hid_t h5_id,
+                                const io::HDF5Options& options)
+{
+  assert(function.function_space());
+  std::shared_ptr<const mesh::Mesh> mesh = function.function_space()->mesh();
+  assert(mesh);
+
+  // Extract the region: entity selection, compact index maps and the
+  // restricted geometry
+  auto [submesh, entity_map, vertex_map, xdof_map]
+      = mesh::create_submesh(*mesh, dim, entities);
+
+  // Time-series collection Grid of this restricted output
+  const std::string timegrid_xpath
+      = "/Xdmf/Domain/Grid[@GridType='Collection'][@Name='" + name + "']";
+  pugi::xml_node timegrid_node
+      = xml_doc.select_node(timegrid_xpath.c_str()).node();
+  if (!timegrid_node)
+  {
+    pugi::xml_node domain_node = xml_doc.select_node("/Xdmf/Domain").node();
+    timegrid_node = domain_node.append_child("Grid");
+    timegrid_node.append_attribute("Name") = name.c_str();
+    timegrid_node.append_attribute("GridType") = "Collection";
+    timegrid_node.append_attribute("CollectionType") = "Temporal";
+  }
+  assert(timegrid_node);
+
+  pugi::xml_node grid_node = timegrid_node.append_child("Grid");
+  assert(grid_node);
+  grid_node.append_attribute("Name") = name.c_str();
+  grid_node.append_attribute("GridType") = "Uniform";
+
+  std::string t_str = boost::lexical_cast<std::string>(t);
+  pugi::xml_node time_node = grid_node.append_child("Time");
+  time_node.append_attribute("Value") = t_str.c_str();
+  assert(time_node);
 
-  // Save XML file (on process 0 only)
-  if (dolfinx::MPI::rank(comm.comm()) == 0)
-    xml_doc.save_file(filename.c_str(), "  ");
+  // Write the restricted topology and geometry of this step. The Grid
+  // is self-contained: it references only the restricted geometry
+  // written here, not a previously written full mesh.
+  std::replace(t_str.begin(), t_str.end(), '.', '_');
+  const std::string path_prefix = "/Region/" + name + "/" + t_str;
+  const int sub_tdim = submesh.topology().dim();
+  auto sub_map_e = submesh.topology().index_map(sub_tdim);
+  assert(sub_map_e);
+  std::vector<std::int32_t> sub_cells(sub_map_e->size_local());
+  std::iota(sub_cells.begin(), sub_cells.end(), 0);
+  xdmf_mesh::add_topology_data(comm.comm(), grid_node, h5_id, path_prefix,
+                               submesh.topology(), submesh.geometry(),
+                               sub_tdim, sub_cells, options);
+  xdmf_mesh::add_geometry_data(comm.comm(), grid_node, h5_id, path_prefix,
+                               submesh.geometry(), options);
+
+  // Gather and write the restricted values
+  xdmf_function::add_function_restricted(comm.comm(), function, t, grid_node,
+                                         h5_id, submesh, entity_map, xdof_map,
+                                         options);
 }
 //-----------------------------------------------------------------------------
 
@@ -88,9 +185,11 @@ void _write_function(dolfinx::MPI::Comm& comm,
 
 //-----------------------------------------------------------------------------
 XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename,
-                   const std::string file_mode, const Encoding encoding)
+                   const std::string file_mode, const Encoding encoding,
+                   const HDF5Options& hdf5_options)
     : _mpi_comm(comm), _filename(filename), _file_mode(file_mode),
-      _xml_doc(new pugi::xml_document), _encoding(encoding)
+      _xml_doc(new pugi::xml_document), _encoding(encoding),
+      _hdf5_options(hdf5_options)
 {
   // Handle HDF5 and XDMF files with the file mode. At the end of this
   // we will have _hdf5_file and _xml_doc both pointing to a valid and
@@ -105,7 +204,7 @@ XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename,
     const std::string hdf5_filename = xdmf_utils::get_hdf5_filename(_filename);
     const bool mpi_io = MPI::size(_mpi_comm.comm()) > 1 ? true : false;
     _h5_id = HDF5Interface::open_file(_mpi_comm.comm(), hdf5_filename,
-                                      file_mode, mpi_io);
+                                      file_mode, mpi_io, _hdf5_options);
     assert(_h5_id > 0);
     LOG(INFO) << "Opened HDF5 file with id \"" << _h5_id << "\"";
   }
@@ -117,10 +216,9 @@ XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename,
 
   if (_file_mode == "r")
   {
-    // Load XML doc from file
-    pugi::xml_parse_result result = _xml_doc->load_file(_filename.c_str());
-    if (!result)
-      throw std::runtime_error("Failed to load xml document from file.");
+    // Load XML doc from file (rank 0 reads, all ranks parse the
+    // broadcast bytes)
+    load_xml_file(_mpi_comm.comm(), _filename, *_xml_doc);
 
     if (_xml_doc->child("Xdmf").empty())
       throw std::runtime_error("Empty <Xdmf> root node.");
@@ -146,12 +244,18 @@ XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename,
   }
   else if (_file_mode == "a")
   {
-    if (boost::filesystem::exists(_filename))
+    // Check for an existing file on rank 0 only; the file system state
+    // seen by other ranks may lag behind
+    int exists = 0;
+    if (MPI::rank(_mpi_comm.comm()) == 0)
+      exists = boost::filesystem::exists(_filename) ? 1 : 0;
+    MPI_Bcast(&exists, 1, MPI_INT, 0, _mpi_comm.comm());
+
+    if (exists)
     {
-      // Load XML doc from file
-      [[maybe_unused]] pugi::xml_parse_result result
-          = _xml_doc->load_file(_filename.c_str());
-      assert(result);
+      // Load XML doc from file (rank 0 reads, all ranks parse the
+      // broadcast bytes)
+      load_xml_file(_mpi_comm.comm(), _filename, *_xml_doc);
 
       if (_xml_doc->child("Xdmf").empty())
         throw std::runtime_error("Empty <Xdmf> root node.");
@@ -183,11 +287,35 @@ XDMFFile::~XDMFFile() { close(); }
 //-----------------------------------------------------------------------------
 void XDMFFile::close()
 {
+  // Save any XML changes deferred by the flush interval
+  if (_xml_pending > 0)
+  {
+    if (MPI::rank(_mpi_comm.comm()) == 0)
+      _xml_doc->save_file(_filename.c_str(), "  ");
+    _xml_pending = 0;
+  }
+
   if (_h5_id > 0)
     HDF5Interface::close_file(_h5_id);
   _h5_id = -1;
 }
 //-----------------------------------------------------------------------------
+void XDMFFile::set_xml_flush_interval(int interval)
+{
+  _xml_flush_interval = interval;
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::save_xml()
+{
+  ++_xml_pending;
+  if (_xml_flush_interval > 0 and _xml_pending >= _xml_flush_interval)
+  {
+    if (MPI::rank(_mpi_comm.comm()) == 0)
+      _xml_doc->save_file(_filename.c_str(), "  ");
+    _xml_pending = 0;
+  }
+}
+//-----------------------------------------------------------------------------
 void XDMFFile::write_mesh(const mesh::Mesh& mesh, const std::string xpath)
 {
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
@@ -195,11 +323,11 @@ void XDMFFile::write_mesh(const mesh::Mesh& mesh, const std::string xpath)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
 
   // Add the mesh Grid to the domain
-  xdmf_mesh::add_mesh(_mpi_comm.comm(), node, _h5_id, mesh, mesh.name);
+  xdmf_mesh::add_mesh(_mpi_comm.comm(), node, _h5_id, mesh, mesh.name,
+                      _hdf5_options);
 
-  // Save XML file (on process 0 only)
-  if (MPI::rank(_mpi_comm.comm()) == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  // Save XML file (on process 0 only), subject to the flush interval
+  save_xml();
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::write_geometry(const mesh::Geometry& geometry,
@@ -217,30 +345,69 @@ void XDMFFile::write_geometry(const mesh::Geometry& geometry,
 
   const std::string path_prefix = "/Geometry/" + name;
   xdmf_mesh::add_geometry_data(_mpi_comm.comm(), grid_node, _h5_id, path_prefix,
-                               geometry);
+                               geometry, _hdf5_options);
 
-  // Save XML file (on process 0 only)
-  if (MPI::rank(_mpi_comm.comm()) == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  // Save XML file (on process 0 only), subject to the flush interval
+  save_xml();
 }
 //-----------------------------------------------------------------------------
 mesh::Mesh XDMFFile::read_mesh(const fem::CoordinateElement& element,
                                const mesh::GhostMode& mode,
-                               const std::string name,
-                               const std::string xpath) const
+                               const std::string name, const std::string xpath,
+                               const mesh::CellPartitionFunction&
+                                   cell_partitioner) const
 {
-  // Read mesh data
+  // Phase one: read only the topology (enough to partition the cells)
   const xt::xtensor<std::int64_t, 2> cells
       = XDMFFile::read_topology_data(name, xpath);
-  const xt::xtensor<double, 2> x = XDMFFile::read_geometry_data(name, xpath);
 
-  // Create mesh
   auto [data, offset] = graph::create_adjacency_data(cells);
   graph::AdjacencyList<std::int64_t> cells_adj(std::move(data),
                                                std::move(offset));
 
-  mesh::Mesh mesh
-      = mesh::create_mesh(_mpi_comm.comm(), cells_adj, element, x, mode);
+  const mesh::CellPartitionFunction partitioner
+      = cell_partitioner
+            ? cell_partitioner
+            : static_cast<graph::AdjacencyList<std::int32_t> (*)(
+                MPI_Comm, int, int, const graph::AdjacencyList<std::int64_t>&,
+                mesh::GhostMode)>(&mesh::partition_cells_graph);
+
+  pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
+  if (!node)
+    throw std::runtime_error("XML node '" + xpath + "' not found.");
+  pugi::xml_node grid_node
+      = node.select_node(("Grid[@Name='" + name + "']").c_str()).node();
+  if (!grid_node)
+    throw std::runtime_error("<Grid> with name '" + name + "' not found.");
+
+  // Check the storage format of the geometry data
+  pugi::xml_node geometry_data_node
+      = grid_node.child("Geometry").child("DataItem");
+  assert(geometry_data_node);
+  const std::string format
+      = geometry_data_node.attribute("Format").as_string();
+
+  if (_h5_id > 0 and format == "HDF")
+  {
+    // Phase two: each rank reads exactly the coordinates of the nodes
+    // of its owned and ghost cells by HDF5 hyperslab selections. The
+    // geometry is never read in full or redistributed.
+    mesh::Mesh mesh = mesh::create_mesh(
+        _mpi_comm.comm(), cells_adj, element,
+        [this, &grid_node](const xtl::span<const std::int64_t>& indices) {
+          return xdmf_mesh::read_geometry_data(_mpi_comm.comm(), _h5_id,
+                                               grid_node, indices);
+        },
+        mode, partitioner);
+    mesh.name = name;
+    return mesh;
+  }
+
+  // XML-stored (ASCII) geometry: read the full coordinate array and
+  // distribute it
+  const xt::xtensor<double, 2> x = XDMFFile::read_geometry_data(name, xpath);
+  mesh::Mesh mesh = mesh::create_mesh(_mpi_comm.comm(), cells_adj, element, x,
+                                      mode, partitioner);
   mesh.name = name;
   return mesh;
 }
@@ -282,13 +449,37 @@ XDMFFile::read_geometry_data(const std::string name,
 void XDMFFile::write_function(const fem::Function<double>& u, double t,
                               const std::string& mesh_xpath)
 {
-  _write_function(_mpi_comm, u, t, mesh_xpath, *_xml_doc, _h5_id, _filename);
+  _write_function(_mpi_comm, u, t, mesh_xpath, *_xml_doc, _h5_id,
+                  _hdf5_options);
+  save_xml();
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::write_function(const fem::Function<std::complex<double>>& u,
                               double t, const std::string& mesh_xpath)
 {
-  _write_function(_mpi_comm, u, t, mesh_xpath, *_xml_doc, _h5_id, _filename);
+  _write_function(_mpi_comm, u, t, mesh_xpath, *_xml_doc, _h5_id,
+                  _hdf5_options);
+  save_xml();
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::write_function(const fem::Function<double>& u, double t,
+                              int dim,
+                              const xtl::span<const std::int32_t>& entities,
+                              const std::string& name)
+{
+  _write_function_restricted(_mpi_comm, u, t, dim, entities, name, *_xml_doc,
+                             _h5_id, _hdf5_options);
+  save_xml();
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::write_function(const fem::Function<std::complex<double>>& u,
+                              double t, int dim,
+                              const xtl::span<const std::int32_t>& entities,
+                              const std::string& name)
+{
+  _write_function_restricted(_mpi_comm, u, t, dim, entities, name, *_xml_doc,
+                             _h5_id, _hdf5_options);
+  save_xml();
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::write_meshtags(const mesh::MeshTags<std::int32_t>& meshtags,
@@ -309,11 +500,10 @@ void XDMFFile::write_meshtags(const mesh::MeshTags<std::int32_t>& meshtags,
   geo_ref_node.append_attribute("xpointer") = geo_ref_path.c_str();
   assert(geo_ref_node);
   xdmf_meshtags::add_meshtags(_mpi_comm.comm(), meshtags, grid_node, _h5_id,
-                              meshtags.name);
+                              meshtags.name, _hdf5_options);
 
-  // Save XML file (on process 0 only)
-  if (MPI::rank(_mpi_comm.comm()) == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  // Save XML file (on process 0 only), subject to the flush interval
+  save_xml();
 }
 //-----------------------------------------------------------------------------
 mesh::MeshTags<std::int32_t>
@@ -395,9 +585,8 @@ void XDMFFile::write_information(const std::string name,
   info_node.append_attribute("Name") = name.c_str();
   info_node.append_attribute("Value") = value.c_str();
 
-  // Save XML file (on process 0 only)
-  if (MPI::rank(_mpi_comm.comm()) == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  // Save XML file (on process 0 only), subject to the flush interval
+  save_xml();
 }
 //-----------------------------------------------------------------------------
 std::string XDMFFile::read_information(const std::string name,
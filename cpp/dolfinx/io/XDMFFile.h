@@ -8,9 +8,11 @@
 
 #include "HDF5Interface.h"
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/cell_types.h>
 #include <memory>
 #include <string>
+#include <xtl/xspan.hpp>
 
 namespace pugi
 {
@@ -32,8 +34,6 @@ class Function;
 namespace dolfinx::mesh
 {
 class Geometry;
-enum class GhostMode : int;
-class Mesh;
 template <typename T>
 class MeshTags;
 } // namespace dolfinx::mesh
@@ -66,9 +66,17 @@ public:
   static const Encoding default_encoding = Encoding::HDF5;
 
   /// Constructor
+  /// @param[in] comm The MPI communicator
+  /// @param[in] filename Name of the file
+  /// @param[in] file_mode Mode in which to open the file (w, r, a)
+  /// @param[in] encoding File encoding type
+  /// @param[in] hdf5_options HDF5 tuning options (chunking, alignment
+  ///   and MPI-IO hints) applied to the underlying HDF5 file and to
+  ///   all datasets written through this file
   XDMFFile(MPI_Comm comm, const std::string filename,
            const std::string file_mode,
-           const Encoding encoding = default_encoding);
+           const Encoding encoding = default_encoding,
+           const HDF5Options& hdf5_options = HDF5Options());
 
   /// Destructor
   ~XDMFFile();
@@ -80,6 +88,15 @@ public:
   /// no effect.
   void close();
 
+  /// Set the number of XML-mutating write operations between saves of
+  /// the XML file. The default (1) rewrites the XML file after every
+  /// operation; an interval of n defers the rank-0 rewrite of the
+  /// growing XML file to every nth operation, and 0 defers it until
+  /// the file is closed. Pending changes are always saved by close(),
+  /// but are lost if the program aborts before then.
+  /// @param[in] interval Number of write operations between XML saves
+  void set_xml_flush_interval(int interval);
+
   /// Save Mesh
   /// @param[in] mesh
   /// @param[in] xpath XPath where Mesh Grid will be written
@@ -94,16 +111,29 @@ public:
                       const std::string xpath = "/Xdmf/Domain");
 
   /// Read in Mesh
+  ///
+  /// The read is performed in two phases: first only the topology is
+  /// read and partitioned (or a saved partition consumed via @p
+  /// cell_partitioner), then each rank reads the coordinates of the
+  /// nodes of its owned and ghost cells directly by HDF5 hyperslab
+  /// selections. The full coordinate array is never held in memory or
+  /// redistributed.
   /// @param[in] element Element that describes the geometry of a cell
   /// @param[in] mode The type of ghosting/halo to use for the mesh when
   ///   distributed in parallel
   /// @param[in] name
   /// @param[in] xpath XPath where Mesh Grid is located
+  /// @param[in] cell_partitioner Cell partitioning function. If not
+  ///   set, the default graph partitioner is used. Pass e.g.
+  ///   mesh::cell_partitioner_from_file to re-use a saved partition
+  ///   and skip graph partitioning.
   /// @return A Mesh distributed on the same communicator as the
   ///   XDMFFile
   mesh::Mesh read_mesh(const fem::CoordinateElement& element,
                        const mesh::GhostMode& mode, const std::string name,
-                       const std::string xpath = "/Xdmf/Domain") const;
+                       const std::string xpath = "/Xdmf/Domain",
+                       const mesh::CellPartitionFunction& cell_partitioner
+                       = nullptr) const;
 
   /// Read Topology data for Mesh
   /// @param[in] name Name of the mesh (Grid)
@@ -146,6 +176,30 @@ public:
                       const std::string& mesh_xpath
                       = "/Xdmf/Domain/Grid[@GridType='Uniform'][1]");
 
+  /// Write a Function restricted to a set of mesh entities, e.g. the
+  /// tagged regions of a MeshTags. Only the selected entities and the
+  /// geometry points they reference are written (as a self-contained
+  /// time-series Grid named @p name), so the output size scales with
+  /// the region rather than with the mesh. The restriction may be of
+  /// lower dimension than the mesh cells, e.g. a tagged surface;
+  /// cell-centred (DG0) data requires cell-dimension entities.
+  /// @param[in] u The Function to write to file
+  /// @param[in] t The time stamp to associate with the Function
+  /// @param[in] dim Topological dimension of the entities
+  /// @param[in] entities Entities to write (local to process), e.g.
+  /// from MeshTags::find
+  /// @param[in] name Name of the output Grid, used for all time steps
+  /// of the same restriction
+  void write_function(const fem::Function<double>& u, double t, int dim,
+                      const xtl::span<const std::int32_t>& entities,
+                      const std::string& name);
+
+  /// Write a restricted Function (complex version), see the real
+  /// overload
+  void write_function(const fem::Function<std::complex<double>>& u, double t,
+                      int dim, const xtl::span<const std::int32_t>& entities,
+                      const std::string& name);
+
   /// Write MeshTags
   /// @param[in] meshtags
   /// @param[in] geometry_xpath XPath where Geometry is already stored
@@ -199,6 +253,20 @@ private:
   std::unique_ptr<pugi::xml_document> _xml_doc;
 
   Encoding _encoding;
+
+  // HDF5 tuning options for the file and its datasets
+  HDF5Options _hdf5_options;
+
+  // Record a mutation of the XML tree and save the XML file (on rank 0
+  // only) when the flush interval has been reached
+  void save_xml();
+
+  // Number of XML-mutating write operations between XML saves (0
+  // defers all saves to close())
+  int _xml_flush_interval = 1;
+
+  // Number of XML mutations since the last save
+  int _xml_pending = 0;
 };
 
 } // namespace dolfinx::io
@@ -5,6 +5,8 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "cells.h"
+#include <algorithm>
+#include <cassert>
 #include <dolfinx/common/log.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/cell_types.h>
@@ -379,6 +381,36 @@ io::cells::compute_permutation(const xt::xtensor<std::int64_t, 2>& cells,
   return cells_new;
 }
 //-----------------------------------------------------------------------------
+void io::cells::apply_permutation(const xtl::span<std::int64_t>& cells,
+                                  const std::vector<std::uint8_t>& p)
+{
+  const std::size_t num_nodes = p.size();
+  assert(num_nodes > 0);
+  assert(cells.size() % num_nodes == 0);
+
+  // Nothing to do for an identity permutation (e.g. first-order
+  // simplices)
+  bool identity = true;
+  for (std::size_t i = 0; i < num_nodes; ++i)
+    identity = identity and p[i] == i;
+  if (identity)
+    return;
+
+  // Permute each cell through a small scratch buffer. The buffer is
+  // tiny (at most the number of nodes of the highest-order cell) and
+  // stays in registers/L1, so the topology array is only streamed
+  // through once and no permuted copy is created.
+  std::vector<std::int64_t> scratch(num_nodes);
+  const std::size_t num_cells = cells.size() / num_nodes;
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    std::int64_t* cell = cells.data() + c * num_nodes;
+    std::copy_n(cell, num_nodes, scratch.begin());
+    for (std::size_t i = 0; i < num_nodes; ++i)
+      cell[i] = scratch[p[i]];
+  }
+}
+//-----------------------------------------------------------------------------
 std::int8_t io::cells::get_vtk_cell_type(const dolfinx::mesh::Mesh& mesh,
                                          int dim)
 {
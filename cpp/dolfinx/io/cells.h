@@ -10,6 +10,7 @@
 #include <dolfinx/mesh/cell_types.h>
 #include <vector>
 #include <xtensor/xtensor.hpp>
+#include <xtl/xspan.hpp>
 
 namespace dolfinx::mesh
 {
@@ -120,6 +121,18 @@ xt::xtensor<std::int64_t, 2>
 compute_permutation(const xt::xtensor<std::int64_t, 2>& cells,
                     const std::vector<std::uint8_t>& p);
 
+/// Permute cell topology in place by applying a permutation array for
+/// each cell. Unlike compute_permutation, no permuted copy of the
+/// topology array is created, so this can be applied directly to a
+/// file read buffer. Identity permutations are detected and skipped.
+/// @param[in,out] cells Flattened (row-major) array of cell
+///   topologies, with each row representing a cell. The number of
+///   nodes per cell is `p.size()`.
+/// @param[in] p The permutation array that maps `a_p[i] = a[p[i]]`,
+///   where `a_p` is the permuted array
+void apply_permutation(const xtl::span<std::int64_t>& cells,
+                       const std::vector<std::uint8_t>& p);
+
 /// Get VTK cell identifier
 /// @param[in] mesh The Mesh
 /// @param[in] dim The topological dimension of the cell
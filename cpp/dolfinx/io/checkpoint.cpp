@@ -0,0 +1,304 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "checkpoint.h"
+#include "HDF5Interface.h"
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/fem/CoordinateElement.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <numeric>
+#include <set>
+#include <vector>
+#include <xtensor/xtensor.hpp>
+
+using namespace dolfinx;
+using namespace dolfinx::io;
+
+namespace
+{
+//-----------------------------------------------------------------------------
+
+/// Write one block of rows per rank to the dataset at @p path. The
+/// number of rows written by each rank is recorded in a companion
+/// "<path>_counts" dataset so the blocks can be recovered on restore.
+template <typename T>
+void write_blocked(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                   const T* data, std::int64_t num_rows, std::int64_t num_cols)
+{
+  const int mpi_size = dolfinx::MPI::size(comm);
+  const int mpi_rank = dolfinx::MPI::rank(comm);
+  const bool use_mpi_io = mpi_size > 1;
+
+  std::int64_t offset = 0;
+  MPI_Exscan(&num_rows, &offset, 1, MPI_INT64_T, MPI_SUM, comm);
+  std::int64_t global_rows = 0;
+  MPI_Allreduce(&num_rows, &global_rows, 1, MPI_INT64_T, MPI_SUM, comm);
+
+  std::vector<std::int64_t> shape = {global_rows};
+  if (num_cols > 1)
+    shape.push_back(num_cols);
+  HDF5Interface::write_dataset(h5_id, path, data, {offset, offset + num_rows},
+                               shape, use_mpi_io, false);
+
+  HDF5Interface::write_dataset(
+      h5_id, path + "_counts", &num_rows,
+      {std::int64_t(mpi_rank), std::int64_t(mpi_rank + 1)},
+      {std::int64_t(mpi_size)}, use_mpi_io, false);
+}
+//-----------------------------------------------------------------------------
+
+/// Read back the block of rows written by this rank via write_blocked
+template <typename T>
+std::vector<T> read_blocked(MPI_Comm comm, hid_t h5_id,
+                            const std::string& path)
+{
+  const int mpi_size = dolfinx::MPI::size(comm);
+  const int mpi_rank = dolfinx::MPI::rank(comm);
+
+  const std::vector<std::int64_t> counts_shape
+      = HDF5Interface::get_dataset_shape(h5_id, path + "_counts");
+  if (counts_shape[0] != mpi_size)
+  {
+    throw std::runtime_error(
+        "Cannot restore checkpoint written on "
+        + std::to_string(counts_shape[0]) + " ranks on "
+        + std::to_string(mpi_size) + " ranks.");
+  }
+
+  const std::vector<std::int64_t> counts
+      = HDF5Interface::read_dataset<std::int64_t>(h5_id, path + "_counts",
+                                                  {0, mpi_size});
+  const std::int64_t offset = std::accumulate(
+      counts.begin(), counts.begin() + mpi_rank, std::int64_t(0));
+  return HDF5Interface::read_dataset<T>(h5_id, path,
+                                        {offset, offset + counts[mpi_rank]});
+}
+//-----------------------------------------------------------------------------
+
+/// Write an adjacency list (array and offsets) to the group at @p path
+void write_adjacency_list(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                          const graph::AdjacencyList<std::int32_t>& list)
+{
+  const std::vector<std::int32_t>& array = list.array();
+  const std::vector<std::int32_t>& offsets = list.offsets();
+  write_blocked(comm, h5_id, path + "/array", array.data(), array.size(), 1);
+  write_blocked(comm, h5_id, path + "/offsets", offsets.data(), offsets.size(),
+                1);
+}
+//-----------------------------------------------------------------------------
+
+/// Read an adjacency list written by write_adjacency_list
+graph::AdjacencyList<std::int32_t>
+read_adjacency_list(MPI_Comm comm, hid_t h5_id, const std::string& path)
+{
+  std::vector<std::int32_t> array
+      = read_blocked<std::int32_t>(comm, h5_id, path + "/array");
+  std::vector<std::int32_t> offsets
+      = read_blocked<std::int32_t>(comm, h5_id, path + "/offsets");
+  return graph::AdjacencyList<std::int32_t>(std::move(array),
+                                            std::move(offsets));
+}
+//-----------------------------------------------------------------------------
+template <typename Scalar>
+void _write_values(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                   const fem::Function<Scalar>& u)
+{
+  assert(u.x());
+  xtl::span<const Scalar> x = u.x()->array();
+
+  // Complex values are stored as (real, imag) pairs
+  constexpr int ncols = sizeof(Scalar) / sizeof(double);
+  write_blocked(comm, h5_id, path, reinterpret_cast<const double*>(x.data()),
+                x.size(), ncols);
+}
+//-----------------------------------------------------------------------------
+template <typename Scalar>
+void _read_values(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                  fem::Function<Scalar>& u)
+{
+  const std::vector<double> data = read_blocked<double>(comm, h5_id, path);
+
+  assert(u.x());
+  xtl::span<Scalar> x = u.x()->mutable_array();
+  constexpr int ncols = sizeof(Scalar) / sizeof(double);
+  if (data.size() != ncols * x.size())
+  {
+    throw std::runtime_error(
+        "Checkpoint size does not match the Function dof array.");
+  }
+  std::copy(data.begin(), data.end(), reinterpret_cast<double*>(x.data()));
+}
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+void checkpoint::write_index_map(MPI_Comm comm, hid_t h5_id,
+                                 const std::string& path,
+                                 const common::IndexMap& map)
+{
+  const std::int64_t local_size = map.size_local();
+  write_blocked(comm, h5_id, path + "/local_size", &local_size, 1, 1);
+
+  const std::vector<std::int64_t>& ghosts = map.ghosts();
+  write_blocked(comm, h5_id, path + "/ghosts", ghosts.data(), ghosts.size(),
+                1);
+
+  const std::vector<int> owners = map.ghost_owner_rank();
+  write_blocked(comm, h5_id, path + "/ghost_owners", owners.data(),
+                owners.size(), 1);
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<common::IndexMap>
+checkpoint::read_index_map(MPI_Comm comm, hid_t h5_id, const std::string& path)
+{
+  const std::int64_t local_size
+      = read_blocked<std::int64_t>(comm, h5_id, path + "/local_size").front();
+  const std::vector<std::int64_t> ghosts
+      = read_blocked<std::int64_t>(comm, h5_id, path + "/ghosts");
+  const std::vector<int> owners
+      = read_blocked<int>(comm, h5_id, path + "/ghost_owners");
+
+  // Re-derive the ranks that ghost indices owned by this rank
+  const std::vector<int> dest_ranks = dolfinx::MPI::compute_graph_edges_nbx(
+      comm, std::set<int>(owners.begin(), owners.end()));
+
+  return std::make_shared<common::IndexMap>(
+      comm, std::int32_t(local_size), dest_ranks, ghosts, owners);
+}
+//-----------------------------------------------------------------------------
+void checkpoint::write_mesh(MPI_Comm comm, hid_t h5_id,
+                            const std::string& path, const mesh::Mesh& mesh)
+{
+  const mesh::Topology& topology = mesh.topology();
+  const int tdim = topology.dim();
+
+  // Topology: vertex and cell index maps, and cell-vertex connectivity
+  // (rank-local indices)
+  write_index_map(comm, h5_id, path + "/topology/vertex_map",
+                  *topology.index_map(0));
+  write_index_map(comm, h5_id, path + "/topology/cell_map",
+                  *topology.index_map(tdim));
+  auto cells = topology.connectivity(tdim, 0);
+  assert(cells);
+  write_adjacency_list(comm, h5_id, path + "/topology/cells", *cells);
+
+  // Geometry: node index map, coordinate dofmap, coordinates (owned and
+  // ghost rows) and input global indices
+  const mesh::Geometry& geometry = mesh.geometry();
+  assert(geometry.index_map());
+  write_index_map(comm, h5_id, path + "/geometry/node_map",
+                  *geometry.index_map());
+  write_adjacency_list(comm, h5_id, path + "/geometry/dofmap",
+                       geometry.dofmap());
+
+  const xt::xtensor<double, 2>& x = geometry.x();
+  write_blocked(comm, h5_id, path + "/geometry/x", x.data(), x.shape(0),
+                x.shape(1));
+
+  const std::vector<std::int64_t>& igi = geometry.input_global_indices();
+  write_blocked(comm, h5_id, path + "/geometry/input_global_indices",
+                igi.data(), igi.size(), 1);
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh checkpoint::read_mesh(MPI_Comm comm, hid_t h5_id,
+                                 const std::string& path,
+                                 const fem::CoordinateElement& element)
+{
+  // Restore the topology with the stored index maps and connectivity
+  mesh::Topology topology(comm, element.cell_shape());
+  const int tdim = topology.dim();
+
+  auto vertex_map
+      = read_index_map(comm, h5_id, path + "/topology/vertex_map");
+  auto cell_map = read_index_map(comm, h5_id, path + "/topology/cell_map");
+  auto cells = std::make_shared<graph::AdjacencyList<std::int32_t>>(
+      read_adjacency_list(comm, h5_id, path + "/topology/cells"));
+
+  topology.set_index_map(0, vertex_map);
+  auto c0 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
+      vertex_map->size_local() + vertex_map->num_ghosts());
+  topology.set_connectivity(c0, 0, 0);
+  topology.set_index_map(tdim, cell_map);
+  topology.set_connectivity(cells, tdim, 0);
+
+  // Restore the geometry
+  auto node_map = read_index_map(comm, h5_id, path + "/geometry/node_map");
+  graph::AdjacencyList<std::int32_t> x_dofmap
+      = read_adjacency_list(comm, h5_id, path + "/geometry/dofmap");
+
+  const std::vector<double> x_flat
+      = read_blocked<double>(comm, h5_id, path + "/geometry/x");
+  xt::xtensor<double, 2> x({x_flat.size() / 3, std::size_t(3)});
+  std::copy(x_flat.begin(), x_flat.end(), x.begin());
+
+  std::vector<std::int64_t> igi = read_blocked<std::int64_t>(
+      comm, h5_id, path + "/geometry/input_global_indices");
+
+  mesh::Geometry geometry(node_map, std::move(x_dofmap), element, std::move(x),
+                          std::move(igi));
+
+  return mesh::Mesh(comm, std::move(topology), std::move(geometry));
+}
+//-----------------------------------------------------------------------------
+void checkpoint::write_dofmap(MPI_Comm comm, hid_t h5_id,
+                              const std::string& path,
+                              const fem::DofMap& dofmap)
+{
+  assert(dofmap.index_map);
+  write_index_map(comm, h5_id, path + "/index_map", *dofmap.index_map);
+  write_adjacency_list(comm, h5_id, path + "/dofs", dofmap.list());
+
+  const std::int64_t bs[2] = {dofmap.index_map_bs(), dofmap.bs()};
+  write_blocked(comm, h5_id, path + "/bs", bs, 1, 2);
+}
+//-----------------------------------------------------------------------------
+fem::DofMap
+checkpoint::read_dofmap(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                        std::shared_ptr<const fem::ElementDofLayout> layout)
+{
+  auto index_map = read_index_map(comm, h5_id, path + "/index_map");
+  graph::AdjacencyList<std::int32_t> dofs
+      = read_adjacency_list(comm, h5_id, path + "/dofs");
+  const std::vector<std::int64_t> bs
+      = read_blocked<std::int64_t>(comm, h5_id, path + "/bs");
+  assert(bs.size() == 2);
+  return fem::DofMap(layout, index_map, bs[0], std::move(dofs), bs[1]);
+}
+//-----------------------------------------------------------------------------
+void checkpoint::write_values(MPI_Comm comm, hid_t h5_id,
+                              const std::string& path,
+                              const fem::Function<double>& u)
+{
+  _write_values(comm, h5_id, path, u);
+}
+//-----------------------------------------------------------------------------
+void checkpoint::write_values(MPI_Comm comm, hid_t h5_id,
+                              const std::string& path,
+                              const fem::Function<std::complex<double>>& u)
+{
+  _write_values(comm, h5_id, path, u);
+}
+//-----------------------------------------------------------------------------
+void checkpoint::read_values(MPI_Comm comm, hid_t h5_id,
+                             const std::string& path, fem::Function<double>& u)
+{
+  _read_values(comm, h5_id, path, u);
+}
+//-----------------------------------------------------------------------------
+void checkpoint::read_values(MPI_Comm comm, hid_t h5_id,
+                             const std::string& path,
+                             fem::Function<std::complex<double>>& u)
+{
+  _read_values(comm, h5_id, path, u);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <complex>
+#include <hdf5.h>
+#include <memory>
+#include <mpi.h>
+#include <string>
+
+namespace dolfinx::common
+{
+class IndexMap;
+}
+
+namespace dolfinx::fem
+{
+class CoordinateElement;
+class DofMap;
+class ElementDofLayout;
+template <typename T>
+class Function;
+} // namespace dolfinx::fem
+
+namespace dolfinx::mesh
+{
+class Mesh;
+}
+
+namespace dolfinx::io
+{
+/// Native parallel checkpointing. Topology connectivities, index map
+/// ownership data, dofmaps and function arrays are dumped per-rank
+/// through HDF5Interface and restored to the same distributed state
+/// without running the partitioner or the dofmap builder. Restore
+/// requires the same number of MPI ranks as the dump; the stored
+/// indices are global, so a rank-count conversion can be performed
+/// offline if required.
+namespace checkpoint
+{
+
+/// Write an IndexMap (local sizes, ghost indices and ghost owners) to
+/// file
+/// @param[in] comm The MPI communicator
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the group to write to
+/// @param[in] map The index map
+void write_index_map(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                     const common::IndexMap& map);
+
+/// Read an IndexMap written by write_index_map. The scatter pattern is
+/// re-derived from the stored ghost owners; the distribution is
+/// identical to the map that was written.
+/// @param[in] comm The MPI communicator (must have the same size as the
+///   communicator used for writing)
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the group to read from
+/// @return The index map
+std::shared_ptr<common::IndexMap>
+read_index_map(MPI_Comm comm, hid_t h5_id, const std::string& path);
+
+/// Write a Mesh (topology, index maps and geometry) to file, preserving
+/// the parallel distribution
+/// @param[in] comm The MPI communicator
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the group to write to
+/// @param[in] mesh The mesh
+void write_mesh(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                const mesh::Mesh& mesh);
+
+/// Read a Mesh written by write_mesh. The mesh is restored with the
+/// same partition, local numbering and ghosting as the mesh that was
+/// written, without calling the partitioner.
+/// @param[in] comm The MPI communicator (must have the same size as the
+///   communicator used for writing)
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the group to read from
+/// @param[in] element Element that describes the geometry of a cell
+/// @return The mesh
+mesh::Mesh read_mesh(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                     const fem::CoordinateElement& element);
+
+/// Write a DofMap (index map, block sizes and cell-to-dof adjacency) to
+/// file
+/// @param[in] comm The MPI communicator
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the group to write to
+/// @param[in] dofmap The dofmap
+void write_dofmap(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                  const fem::DofMap& dofmap);
+
+/// Read a DofMap written by write_dofmap. The dof numbering is
+/// identical to the dofmap that was written; the dofmap builder is not
+/// executed.
+/// @param[in] comm The MPI communicator (must have the same size as the
+///   communicator used for writing)
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the group to read from
+/// @param[in] layout The element dof layout for the dofmap
+/// @return The dofmap
+fem::DofMap read_dofmap(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                        std::shared_ptr<const fem::ElementDofLayout> layout);
+
+/// Write the dof array of a Function (owned and ghost entries) to file
+/// @param[in] comm The MPI communicator
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the dataset to write to
+/// @param[in] u The function
+void write_values(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                  const fem::Function<double>& u);
+
+/// Write the dof array of a Function (owned and ghost entries) to file
+/// @param[in] comm The MPI communicator
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the dataset to write to
+/// @param[in] u The function
+void write_values(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                  const fem::Function<std::complex<double>>& u);
+
+/// Read a dof array written by write_values into a Function. Ghost
+/// entries are restored from file, so no scatter is required.
+/// @param[in] comm The MPI communicator (must have the same size as the
+///   communicator used for writing)
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the dataset to read from
+/// @param[in,out] u The function to read into
+void read_values(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                 fem::Function<double>& u);
+
+/// Read a dof array written by write_values into a Function. Ghost
+/// entries are restored from file, so no scatter is required.
+/// @param[in] comm The MPI communicator (must have the same size as the
+///   communicator used for writing)
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] path Path of the dataset to read from
+/// @param[in,out] u The function to read into
+void read_values(MPI_Comm comm, hid_t h5_id, const std::string& path,
+                 fem::Function<std::complex<double>>& u);
+
+} // namespace checkpoint
+} // namespace dolfinx::io
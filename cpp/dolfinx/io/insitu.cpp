@@ -0,0 +1,311 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "insitu.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/fem/Form.h>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/utils.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+using namespace dolfinx;
+using namespace dolfinx::io;
+
+//-----------------------------------------------------------------------------
+StatisticsPipeline::StatisticsPipeline(MPI_Comm comm,
+                                       const std::string& filename,
+                                       int flush_interval)
+    : _comm(comm), _filename(filename), _flush_interval(flush_interval)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+StatisticsPipeline::~StatisticsPipeline()
+{
+  if (!_times.empty())
+    flush();
+}
+//-----------------------------------------------------------------------------
+void StatisticsPipeline::add(const std::string& name, Reduction reduction,
+                             const std::function<double(double)>& op)
+{
+  if (_header_written)
+  {
+    throw std::runtime_error(
+        "Cannot add a pipeline stage after the first flush.");
+  }
+  _stages.push_back({name, reduction, op});
+}
+//-----------------------------------------------------------------------------
+void StatisticsPipeline::add_functional(
+    const std::string& name, const std::shared_ptr<const fem::Form<double>>& M)
+{
+  assert(M);
+  add(name, Reduction::sum,
+      [M](double) { return fem::assemble_scalar(*M); });
+}
+//-----------------------------------------------------------------------------
+void StatisticsPipeline::add_probe(
+    const std::string& name,
+    const std::shared_ptr<const fem::Function<double>>& u,
+    const xt::xtensor<double, 2>& points)
+{
+  assert(u);
+  assert(u->function_space());
+  std::shared_ptr<const mesh::Mesh> mesh = u->function_space()->mesh();
+  assert(mesh);
+  const int tdim = mesh->topology().dim();
+
+  // Locate the owning cell of each probe point (once, at registration)
+  geometry::BoundingBoxTree tree(*mesh, tdim);
+  const graph::AdjacencyList<std::int32_t> candidates
+      = geometry::compute_collisions(tree, points);
+  const graph::AdjacencyList<int> colliding
+      = geometry::compute_colliding_cells(*mesh, candidates, points);
+  const std::int32_t num_local_cells
+      = mesh->topology().index_map(tdim)->size_local();
+  const std::size_t num_points = points.shape(0);
+  std::vector<std::int32_t> cells(num_points, -1);
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    for (int c : colliding.links(i))
+    {
+      if (c < num_local_cells)
+      {
+        cells[i] = c;
+        break;
+      }
+    }
+  }
+
+  // A point on a partition boundary is found by several ranks; keep it
+  // only on the lowest rank so the sum reduction counts it once
+  const int mpi_rank = dolfinx::MPI::rank(_comm.comm());
+  std::vector<int> owner(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
+    owner[i] = cells[i] >= 0 ? mpi_rank : std::numeric_limits<int>::max();
+  MPI_Allreduce(MPI_IN_PLACE, owner.data(), int(num_points), MPI_INT, MPI_MIN,
+                _comm.comm());
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    if (owner[i] != mpi_rank)
+      cells[i] = -1;
+  }
+
+  // Shared evaluation cache: the batched eval runs once per time step
+  // and serves every column of this probe
+  const std::size_t value_size = u->function_space()->element()->value_size();
+  struct ProbeData
+  {
+    std::shared_ptr<const fem::Function<double>> u;
+    xt::xtensor<double, 2> points;
+    std::vector<std::int32_t> cells;
+    xt::xtensor<double, 2> values;
+    double last_t = std::numeric_limits<double>::quiet_NaN();
+  };
+  auto data = std::make_shared<ProbeData>();
+  data->u = u;
+  data->points = points;
+  data->cells = std::move(cells);
+  data->values = xt::zeros<double>({num_points, value_size});
+
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    for (std::size_t j = 0; j < value_size; ++j)
+    {
+      std::string column = name + "_p" + std::to_string(i);
+      if (value_size > 1)
+        column += "_c" + std::to_string(j);
+      add(column, Reduction::sum,
+          [data, i, j](double t)
+          {
+            if (t != data->last_t)
+            {
+              data->values.fill(0.0);
+              data->u->eval(data->points, data->cells, data->values);
+              data->last_t = t;
+            }
+            return data->values(i, j);
+          });
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void StatisticsPipeline::add_min(
+    const std::string& name, const std::shared_ptr<const la::Vector<double>>& x)
+{
+  assert(x);
+  add(name, Reduction::min,
+      [x](double)
+      {
+        const std::int32_t n = x->bs() * x->map()->size_local();
+        const xtl::span<const double> values = x->array();
+        return *std::min_element(values.begin(), std::next(values.begin(), n));
+      });
+}
+//-----------------------------------------------------------------------------
+void StatisticsPipeline::add_max(
+    const std::string& name, const std::shared_ptr<const la::Vector<double>>& x)
+{
+  assert(x);
+  add(name, Reduction::max,
+      [x](double)
+      {
+        const std::int32_t n = x->bs() * x->map()->size_local();
+        const xtl::span<const double> values = x->array();
+        return *std::max_element(values.begin(), std::next(values.begin(), n));
+      });
+}
+//-----------------------------------------------------------------------------
+void StatisticsPipeline::add_histogram(
+    const std::string& name, const std::shared_ptr<const la::Vector<double>>& x,
+    double a, double b, int num_bins)
+{
+  assert(x);
+  assert(num_bins > 0);
+  assert(b > a);
+
+  // Shared counting cache: the owned entries are binned once per time
+  // step and every bin column reads from the same counts
+  struct HistogramData
+  {
+    std::shared_ptr<const la::Vector<double>> x;
+    double a, width;
+    std::vector<double> counts;
+    double last_t = std::numeric_limits<double>::quiet_NaN();
+  };
+  auto data = std::make_shared<HistogramData>();
+  data->x = x;
+  data->a = a;
+  data->width = (b - a) / num_bins;
+  data->counts.resize(num_bins);
+
+  for (int i = 0; i < num_bins; ++i)
+  {
+    add(name + "_b" + std::to_string(i), Reduction::sum,
+        [data, i, num_bins](double t)
+        {
+          if (t != data->last_t)
+          {
+            std::fill(data->counts.begin(), data->counts.end(), 0.0);
+            const std::int32_t n
+                = data->x->bs() * data->x->map()->size_local();
+            const xtl::span<const double> values = data->x->array();
+            for (std::int32_t k = 0; k < n; ++k)
+            {
+              const int bin = std::clamp(
+                  int(std::floor((values[k] - data->a) / data->width)), 0,
+                  num_bins - 1);
+              data->counts[bin] += 1.0;
+            }
+            data->last_t = t;
+          }
+          return data->counts[i];
+        });
+  }
+}
+//-----------------------------------------------------------------------------
+void StatisticsPipeline::eval(double t)
+{
+  _times.push_back(t);
+  for (const Stage& stage : _stages)
+    _values.push_back(stage.op(t));
+
+  if (_flush_interval > 0 and int(_times.size()) >= _flush_interval)
+    flush();
+}
+//-----------------------------------------------------------------------------
+void StatisticsPipeline::flush()
+{
+  const std::size_t num_steps = _times.size();
+  const std::size_t num_stages = _stages.size();
+  if (num_steps == 0)
+    return;
+
+  // Batch the recorded values by reduction type and combine each batch
+  // (all stages, all steps) in a single collective call
+  const int mpi_rank = dolfinx::MPI::rank(_comm.comm());
+  const std::array<std::pair<Reduction, MPI_Op>, 3> reductions
+      = {{{Reduction::sum, MPI_SUM},
+          {Reduction::min, MPI_MIN},
+          {Reduction::max, MPI_MAX}}};
+  for (auto [reduction, op] : reductions)
+  {
+    std::vector<std::size_t> columns;
+    for (std::size_t j = 0; j < num_stages; ++j)
+    {
+      if (_stages[j].reduction == reduction)
+        columns.push_back(j);
+    }
+    if (columns.empty())
+      continue;
+
+    std::vector<double> batch(num_steps * columns.size());
+    for (std::size_t i = 0; i < num_steps; ++i)
+      for (std::size_t j = 0; j < columns.size(); ++j)
+        batch[i * columns.size() + j] = _values[i * num_stages + columns[j]];
+
+    if (mpi_rank == 0)
+    {
+      MPI_Reduce(MPI_IN_PLACE, batch.data(), batch.size(), MPI_DOUBLE, op, 0,
+                 _comm.comm());
+    }
+    else
+    {
+      MPI_Reduce(batch.data(), nullptr, batch.size(), MPI_DOUBLE, op, 0,
+                 _comm.comm());
+    }
+
+    for (std::size_t i = 0; i < num_steps; ++i)
+      for (std::size_t j = 0; j < columns.size(); ++j)
+        _values[i * num_stages + columns[j]] = batch[i * columns.size() + j];
+  }
+
+  // Append the reduced rows to the CSV file on rank 0
+  if (mpi_rank == 0)
+  {
+    std::ofstream file(_filename, _header_written ? std::ios::app
+                                                  : std::ios::trunc);
+    if (!file)
+    {
+      throw std::runtime_error("Could not write statistics file \"" + _filename
+                               + "\".");
+    }
+    if (!_header_written)
+    {
+      file << "t";
+      for (const Stage& stage : _stages)
+        file << "," << stage.name;
+      file << "\n";
+      _header_written = true;
+    }
+    file.precision(16);
+    for (std::size_t i = 0; i < num_steps; ++i)
+    {
+      file << _times[i];
+      for (std::size_t j = 0; j < num_stages; ++j)
+        file << "," << _values[i * num_stages + j];
+      file << "\n";
+    }
+  }
+  else
+    _header_written = true;
+
+  _times.clear();
+  _values.clear();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,152 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/la/Vector.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <xtensor/xtensor.hpp>
+
+namespace dolfinx::fem
+{
+template <typename T>
+class Form;
+template <typename T>
+class Function;
+} // namespace dolfinx::fem
+
+namespace dolfinx::io
+{
+
+/// In-situ reduction pipeline. Registered stages (functionals, point
+/// probes, vector norms/extrema, histograms) are evaluated locally at
+/// each time step from the time-stepping loop; the cross-rank
+/// reductions of all stages and all recorded steps are batched into a
+/// few collective calls at flush time, and the reduced rows are
+/// appended to a CSV file by rank 0. This replaces bulk field output
+/// when only derived quantities are post-processed: kilobytes of
+/// results are written instead of the full fields.
+class StatisticsPipeline
+{
+public:
+  /// Cross-rank combination rule for a stage value
+  enum class Reduction
+  {
+    sum,
+    min,
+    max
+  };
+
+  /// Create a pipeline writing to a CSV file
+  /// @param[in] comm The MPI communicator
+  /// @param[in] filename Name of the output CSV file (truncated on
+  ///   creation)
+  /// @param[in] flush_interval Number of recorded steps after which
+  ///   eval() triggers a flush automatically
+  StatisticsPipeline(MPI_Comm comm, const std::string& filename,
+                     int flush_interval = 50);
+
+  /// Destructor. Flushes any recorded steps.
+  ~StatisticsPipeline();
+
+  /// Register a generic stage. The callback returns this rank's local
+  /// contribution at time t; contributions are combined across ranks
+  /// with the given reduction at flush time.
+  /// @param[in] name Column name in the CSV file
+  /// @param[in] reduction Cross-rank combination rule
+  /// @param[in] op Callback computing the local contribution
+  void add(const std::string& name, Reduction reduction,
+           const std::function<double(double)>& op);
+
+  /// Register a functional, assembled with fem::assemble_scalar and
+  /// sum-reduced across ranks
+  /// @param[in] name Column name in the CSV file
+  /// @param[in] M A scalar-valued (rank-0) form
+  void add_functional(const std::string& name,
+                      const std::shared_ptr<const fem::Form<double>>& M);
+
+  /// Register a point probe. The cells containing the points are
+  /// located once at registration; each point is evaluated by at most
+  /// one rank (via the batched fem::Function::eval) and the values are
+  /// sum-reduced. One column "<name>_p<i>[_c<j>]" is added per point
+  /// (and component). Points outside the mesh evaluate to zero.
+  /// @param[in] name Base column name in the CSV file
+  /// @param[in] u The function to probe
+  /// @param[in] points The probe coordinates (shape=(num_points, 3)).
+  ///   The same points must be passed on all ranks.
+  void add_probe(const std::string& name,
+                 const std::shared_ptr<const fem::Function<double>>& u,
+                 const xt::xtensor<double, 2>& points);
+
+  /// Register the minimum entry of a vector (owned entries only)
+  /// @param[in] name Column name in the CSV file
+  /// @param[in] x The vector
+  void add_min(const std::string& name,
+               const std::shared_ptr<const la::Vector<double>>& x);
+
+  /// Register the maximum entry of a vector (owned entries only)
+  /// @param[in] name Column name in the CSV file
+  /// @param[in] x The vector
+  void add_max(const std::string& name,
+               const std::shared_ptr<const la::Vector<double>>& x);
+
+  /// Register a histogram of the owned entries of a vector over
+  /// uniform bins on [a, b). Out-of-range entries are clamped to the
+  /// first/last bin. One sum-reduced column "<name>_b<i>" is added per
+  /// bin.
+  /// @param[in] name Base column name in the CSV file
+  /// @param[in] x The vector
+  /// @param[in] a Lower bound of the histogram range
+  /// @param[in] b Upper bound of the histogram range
+  /// @param[in] num_bins Number of bins
+  void add_histogram(const std::string& name,
+                     const std::shared_ptr<const la::Vector<double>>& x,
+                     double a, double b, int num_bins);
+
+  /// Record one row at time t. Only local evaluation is performed;
+  /// communication is deferred and batched. Flushes automatically
+  /// every flush_interval recorded steps.
+  /// @param[in] t The time to associate with the row
+  void eval(double t);
+
+  /// Reduce the recorded rows across ranks (one collective call per
+  /// reduction type in use) and append them to the CSV file on rank 0.
+  /// Must be called collectively.
+  void flush();
+
+private:
+  // Communicator for the batched reductions
+  dolfinx::MPI::Comm _comm;
+
+  // Output CSV filename
+  std::string _filename;
+
+  // Number of recorded steps between automatic flushes
+  int _flush_interval;
+
+  // True once the CSV header has been written
+  bool _header_written = false;
+
+  // Registered stages
+  struct Stage
+  {
+    std::string name;
+    Reduction reduction;
+    std::function<double(double)> op;
+  };
+  std::vector<Stage> _stages;
+
+  // Recorded times and local stage values (row-major, one row of
+  // _stages.size() values per recorded step)
+  std::vector<double> _times;
+  std::vector<double> _values;
+};
+
+} // namespace dolfinx::io
@@ -6,16 +6,20 @@
 
 #include "xdmf_function.h"
 #include "pugixml.hpp"
+#include "utils.h"
 #include "xdmf_mesh.h"
 #include "xdmf_utils.h"
 #include <boost/lexical_cast.hpp>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
 #include <dolfinx/fem/Function.h>
 #include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <algorithm>
 #include <string>
 
 using namespace dolfinx;
@@ -74,37 +78,72 @@ int get_padded_width(const fem::FiniteElement& e)
   return width;
 }
 //-----------------------------------------------------------------------------
-template <typename Scalar>
-void _add_function(MPI_Comm comm, const fem::Function<Scalar>& u,
-                   const double t, pugi::xml_node& xml_node, const hid_t h5_id)
-{
-  LOG(INFO) << "Adding function to node \"" << xml_node.path('/') << "\"";
 
-  assert(u.function_space());
-  std::shared_ptr<const mesh::Mesh> mesh = u.function_space()->mesh();
-  assert(mesh);
+// Append one step of attribute data to the per-function extensible
+// HDF5 dataset and add a DataItem node that references the appended
+// block by an XDMF hyperslab selection
+template <typename T>
+void add_time_series_data_item(pugi::xml_node& xml_node, const hid_t h5_id,
+                               const std::string& h5_path,
+                               const std::vector<T>& x,
+                               const std::int64_t offset,
+                               const std::vector<std::int64_t>& shape,
+                               const bool use_mpi_io,
+                               const HDF5Options& options)
+{
+  assert(xml_node);
+  assert(shape.size() == 2);
 
-  // Get fem::Function data values and shape
-  std::vector<Scalar> data_values;
-  const bool cell_centred = has_cell_centred_data(u);
-  if (cell_centred)
-    data_values = xdmf_utils::get_cell_data_values(u);
-  else
-    data_values = xdmf_utils::get_point_data_values(u);
+  // Append this step's values to the (extensible) dataset
+  const std::int64_t num_local = x.size() / shape[1];
+  const std::array local_range{offset, offset + num_local};
+  const std::int64_t step_offset = HDF5Interface::append_dataset(
+      h5_id, h5_path, x.data(), local_range, shape, use_mpi_io, options);
 
-  auto map_c = mesh->topology().index_map(mesh->topology().dim());
-  assert(map_c);
+  // Add hyperslab DataItem node selecting this step's block
+  pugi::xml_node slab_node = xml_node.append_child("DataItem");
+  assert(slab_node);
+  slab_node.append_attribute("ItemType") = "HyperSlab";
+  const std::string dims
+      = std::to_string(shape[0]) + " " + std::to_string(shape[1]);
+  slab_node.append_attribute("Dimensions") = dims.c_str();
 
-  auto map_v = mesh->geometry().index_map();
-  assert(map_v);
+  // Selection (start, stride, count) into the stacked dataset
+  pugi::xml_node selection_node = slab_node.append_child("DataItem");
+  assert(selection_node);
+  selection_node.append_attribute("Dimensions") = "3 2";
+  selection_node.append_attribute("Format") = "XML";
+  const std::string selection
+      = std::to_string(step_offset) + " 0 1 1 " + dims;
+  selection_node.append_child(pugi::node_pcdata).set_value(selection.c_str());
 
-  // Add attribute DataItem node and write data
-  const int width = get_padded_width(*u.function_space()->element());
+  // The stacked dataset itself
+  pugi::xml_node data_node = slab_node.append_child("DataItem");
+  assert(data_node);
+  const std::string stacked_dims
+      = std::to_string(step_offset + shape[0]) + " " + std::to_string(shape[1]);
+  data_node.append_attribute("Dimensions") = stacked_dims.c_str();
+  data_node.append_attribute("Format") = "HDF";
+  const std::string hdf5_filename = HDF5Interface::get_filename(h5_id);
+  const std::string filename = dolfinx::io::get_filename(hdf5_filename);
+  const std::string xdmf_path = filename + std::string(":") + h5_path;
+  data_node.append_child(pugi::node_pcdata).set_value(xdmf_path.c_str());
+}
+//-----------------------------------------------------------------------------
+// Add the Attribute node(s) for one step of a (possibly restricted)
+// function and write the data values, which must hold the owned rows
+// in the global row order of the written grid
+template <typename Scalar>
+void _write_attribute(MPI_Comm comm, const std::string& name,
+                      const fem::FiniteElement& element, bool cell_centred,
+                      const std::vector<Scalar>& data_values,
+                      std::int64_t num_values, const double t,
+                      pugi::xml_node& xml_node, const hid_t h5_id,
+                      const HDF5Options& options)
+{
+  const int width = get_padded_width(element);
   assert(data_values.size() % width == 0);
-  const int num_values
-      = cell_centred ? map_c->size_global() : map_v->size_global();
-
-  const int value_rank = u.function_space()->element()->value_rank();
+  const int value_rank = element.value_rank();
 
   std::vector<std::string> components = {""};
   if constexpr (!std::is_scalar<Scalar>::value)
@@ -116,19 +155,18 @@ void _add_function(MPI_Comm comm, const fem::Function<Scalar>& u,
   for (const auto& component : components)
   {
     std::string attr_name;
-    std::string dataset_name;
     if (component.empty())
-    {
-      attr_name = u.name;
-      dataset_name
-          = std::string("/Function/") + attr_name + std::string("/") + t_str;
-    }
+      attr_name = name;
     else
-    {
-      attr_name = component + std::string("_") + u.name;
-      dataset_name
-          = std::string("/Function/") + attr_name + std::string("/") + t_str;
-    }
+      attr_name = component + std::string("_") + name;
+
+    // In time-series mode all steps of a function share one extensible
+    // dataset; otherwise each step gets its own dataset named after
+    // the time stamp
+    const bool time_series = options.time_series and h5_id > 0;
+    const std::string dataset_name
+        = std::string("/Function/") + attr_name
+          + (time_series ? std::string() : std::string("/") + t_str);
     // Add attribute node
     pugi::xml_node attribute_node = xml_node.append_child("Attribute");
     assert(attribute_node);
@@ -160,9 +198,18 @@ void _add_function(MPI_Comm comm, const fem::Function<Scalar>& u,
       std::int64_t offset = 0;
       MPI_Exscan(&num_local, &offset, 1, dolfinx::MPI::mpi_type<std::int64_t>(),
                  MPI_SUM, comm);
-      xdmf_utils::add_data_item(attribute_node, h5_id, dataset_name,
-                                component_data_values, offset,
-                                {num_values, width}, "", use_mpi_io);
+      if (time_series)
+      {
+        add_time_series_data_item(attribute_node, h5_id, dataset_name,
+                                  component_data_values, offset,
+                                  {num_values, width}, use_mpi_io, options);
+      }
+      else
+      {
+        xdmf_utils::add_data_item(attribute_node, h5_id, dataset_name,
+                                  component_data_values, offset,
+                                  {num_values, width}, "", use_mpi_io, options);
+      }
     }
     else
     {
@@ -173,28 +220,146 @@ void _add_function(MPI_Comm comm, const fem::Function<Scalar>& u,
       std::int64_t offset = 0;
       MPI_Exscan(&num_local, &offset, 1, dolfinx::MPI::mpi_type<std::int64_t>(),
                  MPI_SUM, comm);
-      xdmf_utils::add_data_item(attribute_node, h5_id, dataset_name,
-                                data_values, offset, {num_values, width}, "",
-                                use_mpi_io);
+      if (time_series)
+      {
+        add_time_series_data_item(attribute_node, h5_id, dataset_name,
+                                  data_values, offset, {num_values, width},
+                                  use_mpi_io, options);
+      }
+      else
+      {
+        xdmf_utils::add_data_item(attribute_node, h5_id, dataset_name,
+                                  data_values, offset, {num_values, width}, "",
+                                  use_mpi_io, options);
+      }
     }
   }
 }
 //-----------------------------------------------------------------------------
+template <typename Scalar>
+void _add_function(MPI_Comm comm, const fem::Function<Scalar>& u,
+                   const double t, pugi::xml_node& xml_node, const hid_t h5_id,
+                   const HDF5Options& options)
+{
+  LOG(INFO) << "Adding function to node \"" << xml_node.path('/') << "\"";
+
+  assert(u.function_space());
+  std::shared_ptr<const mesh::Mesh> mesh = u.function_space()->mesh();
+  assert(mesh);
+
+  // Get fem::Function data values and shape
+  std::vector<Scalar> data_values;
+  const bool cell_centred = has_cell_centred_data(u);
+  if (cell_centred)
+    data_values = xdmf_utils::get_cell_data_values(u);
+  else
+    data_values = xdmf_utils::get_point_data_values(u);
+
+  auto map_c = mesh->topology().index_map(mesh->topology().dim());
+  assert(map_c);
+
+  auto map_v = mesh->geometry().index_map();
+  assert(map_v);
+
+  const std::int64_t num_values
+      = cell_centred ? map_c->size_global() : map_v->size_global();
+  _write_attribute(comm, u.name, *u.function_space()->element(), cell_centred,
+                   data_values, num_values, t, xml_node, h5_id, options);
+}
+//-----------------------------------------------------------------------------
+template <typename Scalar>
+void _add_function_restricted(MPI_Comm comm, const fem::Function<Scalar>& u,
+                              const double t, pugi::xml_node& xml_node,
+                              const hid_t h5_id, const mesh::Mesh& submesh,
+                              const xtl::span<const std::int32_t>& entity_map,
+                              const xtl::span<const std::int32_t>& xdof_map,
+                              const HDF5Options& options)
+{
+  LOG(INFO) << "Adding restricted function to node \"" << xml_node.path('/')
+            << "\"";
+
+  assert(u.function_space());
+  std::shared_ptr<const mesh::Mesh> mesh = u.function_space()->mesh();
+  assert(mesh);
+
+  const bool cell_centred = has_cell_centred_data(u);
+  const int sub_tdim = submesh.topology().dim();
+  if (cell_centred and sub_tdim != mesh->topology().dim())
+  {
+    throw std::runtime_error(
+        "Cell-centred data cannot be restricted to entities of lower "
+        "dimension than the cells.");
+  }
+
+  std::vector<Scalar> values_parent
+      = cell_centred ? xdmf_utils::get_cell_data_values(u)
+                     : xdmf_utils::get_point_data_values(u);
+  const std::size_t width = get_padded_width(*u.function_space()->element());
+
+  // Owned rows of the restricted data, in submesh global order. The
+  // submesh keeps parent ownership, so the owned submesh cells and
+  // geometry points map to owned parent rows.
+  std::shared_ptr<const common::IndexMap> sub_map
+      = cell_centred ? submesh.topology().index_map(sub_tdim)
+                     : submesh.geometry().index_map();
+  assert(sub_map);
+  const xtl::span<const std::int32_t> rows
+      = cell_centred ? entity_map.first(sub_map->size_local())
+                     : xdof_map.first(sub_map->size_local());
+
+  // Gather the restricted rows
+  std::vector<Scalar> data_values(rows.size() * width);
+  common::thread_pool().parallel_for(
+      rows.size(),
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          std::copy_n(std::next(values_parent.begin(), width * rows[i]), width,
+                      std::next(data_values.begin(), width * i));
+        }
+      });
+
+  _write_attribute(comm, u.name, *u.function_space()->element(), cell_centred,
+                   data_values, sub_map->size_global(), t, xml_node, h5_id,
+                   options);
+}
+//-----------------------------------------------------------------------------
 } // namespace
 
 //-----------------------------------------------------------------------------
 void xdmf_function::add_function(MPI_Comm comm, const fem::Function<double>& u,
                                  const double t, pugi::xml_node& xml_node,
-                                 const hid_t h5_id)
+                                 const hid_t h5_id, const HDF5Options& options)
 {
-  _add_function(comm, u, t, xml_node, h5_id);
+  _add_function(comm, u, t, xml_node, h5_id, options);
 }
 //-----------------------------------------------------------------------------
 void xdmf_function::add_function(MPI_Comm comm,
                                  const fem::Function<std::complex<double>>& u,
                                  const double t, pugi::xml_node& xml_node,
-                                 const hid_t h5_id)
+                                 const hid_t h5_id, const HDF5Options& options)
+{
+  _add_function(comm, u, t, xml_node, h5_id, options);
+}
+//-----------------------------------------------------------------------------
+void xdmf_function::add_function_restricted(
+    MPI_Comm comm, const fem::Function<double>& u, const double t,
+    pugi::xml_node& xml_node, const hid_t h5_id, const mesh::Mesh& submesh,
+    const xtl::span<const std::int32_t>& entity_map,
+    const xtl::span<const std::int32_t>& xdof_map, const HDF5Options& options)
+{
+  _add_function_restricted(comm, u, t, xml_node, h5_id, submesh, entity_map,
+                           xdof_map, options);
+}
+//-----------------------------------------------------------------------------
+void xdmf_function::add_function_restricted(
+    MPI_Comm comm, const fem::Function<std::complex<double>>& u, const double t,
+    pugi::xml_node& xml_node, const hid_t h5_id, const mesh::Mesh& submesh,
+    const xtl::span<const std::int32_t>& entity_map,
+    const xtl::span<const std::int32_t>& xdof_map, const HDF5Options& options)
 {
-  _add_function(comm, u, t, xml_node, h5_id);
+  _add_function_restricted(comm, u, t, xml_node, h5_id, submesh, entity_map,
+                           xdof_map, options);
 }
 //-----------------------------------------------------------------------------
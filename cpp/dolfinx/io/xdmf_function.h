@@ -6,9 +6,12 @@
 
 #pragma once
 
+#include "HDF5Interface.h"
 #include <complex>
+#include <cstdint>
 #include <hdf5.h>
 #include <mpi.h>
+#include <xtl/xspan.hpp>
 
 namespace pugi
 {
@@ -23,6 +26,11 @@ template <typename T>
 class Function;
 }
 
+namespace mesh
+{
+class Mesh;
+}
+
 namespace io
 {
 /// Low-level methods for reading/writing XDMF files
@@ -31,11 +39,44 @@ namespace xdmf_function
 
 /// TODO
 void add_function(MPI_Comm comm, const fem::Function<double>& u, const double t,
-                  pugi::xml_node& xml_node, const hid_t h5_id);
+                  pugi::xml_node& xml_node, const hid_t h5_id,
+                  const HDF5Options& options = HDF5Options());
 
 /// TODO
 void add_function(MPI_Comm comm, const fem::Function<std::complex<double>>& u,
-                  const double t, pugi::xml_node& xml_node, const hid_t h5_id);
+                  const double t, pugi::xml_node& xml_node, const hid_t h5_id,
+                  const HDF5Options& options = HDF5Options());
+
+/// Add a Function restricted to a submesh extracted from the mesh of
+/// the Function (see mesh::create_submesh). Only the values at the
+/// owned submesh cells (cell-centred data) or geometry points (point
+/// data) are gathered and written, in submesh global order, so the
+/// Attribute matches a Grid written from the submesh.
+/// @param[in] comm The MPI communicator
+/// @param[in] u The Function to write
+/// @param[in] t The time stamp
+/// @param[in] xml_node The Grid node of the restricted output
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] submesh The extracted submesh
+/// @param[in] entity_map Parent entity index of each submesh cell
+/// @param[in] xdof_map Parent geometry point index of each submesh
+/// geometry point
+/// @param[in] options HDF5 tuning options
+void add_function_restricted(MPI_Comm comm, const fem::Function<double>& u,
+                             const double t, pugi::xml_node& xml_node,
+                             const hid_t h5_id, const mesh::Mesh& submesh,
+                             const xtl::span<const std::int32_t>& entity_map,
+                             const xtl::span<const std::int32_t>& xdof_map,
+                             const HDF5Options& options = HDF5Options());
+
+/// Add a restricted Function (complex version), see the real overload
+void add_function_restricted(MPI_Comm comm,
+                             const fem::Function<std::complex<double>>& u,
+                             const double t, pugi::xml_node& xml_node,
+                             const hid_t h5_id, const mesh::Mesh& submesh,
+                             const xtl::span<const std::int32_t>& entity_map,
+                             const xtl::span<const std::int32_t>& xdof_map,
+                             const HDF5Options& options = HDF5Options());
 
 } // namespace xdmf_function
 } // namespace io
@@ -19,7 +19,8 @@ void xdmf_mesh::add_topology_data(
     MPI_Comm comm, pugi::xml_node& xml_node, const hid_t h5_id,
     const std::string path_prefix, const mesh::Topology& topology,
     const mesh::Geometry& geometry, int dim,
-    const xtl::span<const std::int32_t>& active_entities)
+    const xtl::span<const std::int32_t>& active_entities,
+    const HDF5Options& options)
 {
   LOG(INFO) << "Adding topology data to node \"" << xml_node.path('/') << "\"";
 
@@ -47,9 +48,6 @@ void xdmf_mesh::add_topology_data(
   assert(topology_node);
   topology_node.append_attribute("TopologyType") = vtk_cell_str.c_str();
 
-  // Pack topology data
-  std::vector<std::int64_t> topology_data;
-
   const graph::AdjacencyList<std::int32_t>& cells_g = geometry.dofmap();
   auto map_g = geometry.index_map();
   assert(map_g);
@@ -60,68 +58,82 @@ void xdmf_mesh::add_topology_data(
       io::cells::perm_vtk(entity_cell_type, num_nodes_per_entity));
   auto map_e = topology.index_map(dim);
   assert(map_e);
-  if (dim == tdim)
+
+  // Map a local geometry 'node' index to its global index
+  auto node_global = [&map_g, offset_g, &ghosts](std::int32_t node)
   {
-    for (std::int32_t c : active_entities)
-    {
-      assert(c < cells_g.num_nodes());
-      auto nodes = cells_g.links(c);
-      for (std::size_t i = 0; i < nodes.size(); ++i)
-      {
-        std::int64_t global_index = nodes[vtk_map[i]];
-        if (global_index < map_g->size_local())
-          global_index += offset_g;
-        else
-          global_index = ghosts[global_index - map_g->size_local()];
-        topology_data.push_back(global_index);
-      }
-    }
-  }
-  else
+    if (node < map_g->size_local())
+      return offset_g + node;
+    else
+      return ghosts[node - map_g->size_local()];
+  };
+
+  // Connectivity and geometry dof data for entities of lower dimension
+  // than the cells
+  std::shared_ptr<const graph::AdjacencyList<std::int32_t>> e_to_c, c_to_e;
+  std::vector<std::vector<int>> entity_dofs;
+  if (dim != tdim)
   {
-    auto e_to_c = topology.connectivity(dim, tdim);
+    e_to_c = topology.connectivity(dim, tdim);
     if (!e_to_c)
       throw std::runtime_error("Mesh is missing entity-cell connectivity.");
-    auto c_to_e = topology.connectivity(tdim, dim);
+    c_to_e = topology.connectivity(tdim, dim);
     if (!c_to_e)
       throw std::runtime_error("Mesh is missing cell-entity connectivity.");
 
     // Tabulate geometry dofs for local entities
-    std::vector<std::vector<int>> entity_dofs;
     for (int e = 0; e < mesh::cell_num_entities(topology.cell_type(), dim); ++e)
       entity_dofs.push_back(cmap_dof_layout.entity_closure_dofs(dim, e));
+  }
 
-    for (std::int32_t e : active_entities)
+  // Pack the topology for a block of entities, fusing the
+  // int32-to-int64 conversion, the local-to-global node map and the
+  // VTK permutation. Blocks are written as they are produced, so the
+  // full int64 connectivity is never materialised.
+  auto pack_block
+      = [&](std::int64_t row0, std::int64_t num_rows, std::int64_t* buffer)
+  {
+    if (dim == tdim)
     {
-      // Get first attached cell
-      std::int32_t c = e_to_c->links(e)[0];
-
-      // Find local number of entity wrt. cell
-      auto cell_entities = c_to_e->links(c);
-      auto it0 = std::find(cell_entities.begin(), cell_entities.end(), e);
-      assert(it0 != cell_entities.end());
-      const int local_cell_entity = std::distance(cell_entities.begin(), it0);
-
-      // Get geometry dofs for the entity
-      const std::vector<int>& entity_dofs_e = entity_dofs[local_cell_entity];
-
-      auto nodes = cells_g.links(c);
-      for (std::size_t i = 0; i < entity_dofs_e.size(); ++i)
+      for (std::int64_t j = 0; j < num_rows; ++j)
       {
-        std::int64_t global_index = nodes[entity_dofs_e[vtk_map[i]]];
-        if (global_index < map_g->size_local())
-          global_index += offset_g;
-        else
-          global_index = ghosts[global_index - map_g->size_local()];
-
-        topology_data.push_back(global_index);
+        const std::int32_t c = active_entities[row0 + j];
+        assert(c < cells_g.num_nodes());
+        auto nodes = cells_g.links(c);
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+          buffer[j * num_nodes_per_entity + i] = node_global(nodes[vtk_map[i]]);
       }
     }
-  }
+    else
+    {
+      for (std::int64_t j = 0; j < num_rows; ++j)
+      {
+        const std::int32_t e = active_entities[row0 + j];
+
+        // Get first attached cell
+        std::int32_t c = e_to_c->links(e)[0];
+
+        // Find local number of entity wrt. cell
+        auto cell_entities = c_to_e->links(c);
+        auto it0 = std::find(cell_entities.begin(), cell_entities.end(), e);
+        assert(it0 != cell_entities.end());
+        const int local_cell_entity
+            = std::distance(cell_entities.begin(), it0);
+
+        // Get geometry dofs for the entity
+        const std::vector<int>& entity_dofs_e = entity_dofs[local_cell_entity];
+
+        auto nodes = cells_g.links(c);
+        for (std::size_t i = 0; i < entity_dofs_e.size(); ++i)
+        {
+          buffer[j * num_nodes_per_entity + i]
+              = node_global(nodes[entity_dofs_e[vtk_map[i]]]);
+        }
+      }
+    }
+  };
 
-  assert(topology_data.size() % num_nodes_per_entity == 0);
-  const std::int64_t num_entities_local
-      = topology_data.size() / num_nodes_per_entity;
+  const std::int64_t num_entities_local = active_entities.size();
   std::int64_t num_entities_global = 0;
   MPI_Allreduce(&num_entities_local, &num_entities_global, 1, MPI_INT64_T,
                 MPI_SUM, comm);
@@ -140,14 +152,29 @@ void xdmf_mesh::add_topology_data(
   MPI_Exscan(&num_local, &offset, 1, dolfinx::MPI::mpi_type<std::int64_t>(),
              MPI_SUM, comm);
   const bool use_mpi_io = (dolfinx::MPI::size(comm) > 1);
-  xdmf_utils::add_data_item(topology_node, h5_id, h5_path, topology_data,
-                            offset, shape, number_type, use_mpi_io);
+  if (h5_id > 0)
+  {
+    // Stream blocks of bounded size directly to the HDF5 dataset
+    xdmf_utils::add_data_item<std::int64_t>(
+        comm, topology_node, h5_id, h5_path, pack_block, offset,
+        num_entities_local, shape, number_type, use_mpi_io, options);
+  }
+  else
+  {
+    // The ASCII (XML) encoding embeds the full dataset in the XML tree
+    std::vector<std::int64_t> topology_data(num_entities_local
+                                            * num_nodes_per_entity);
+    pack_block(0, num_entities_local, topology_data.data());
+    xdmf_utils::add_data_item(topology_node, h5_id, h5_path, topology_data,
+                              offset, shape, number_type, use_mpi_io, options);
+  }
 }
 //-----------------------------------------------------------------------------
 void xdmf_mesh::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                   const hid_t h5_id,
                                   const std::string path_prefix,
-                                  const mesh::Geometry& geometry)
+                                  const mesh::Geometry& geometry,
+                                  const HDF5Options& options)
 {
 
   LOG(INFO) << "Adding geometry data to node \"" << xml_node.path('/') << "\"";
@@ -194,12 +221,12 @@ void xdmf_mesh::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
              MPI_SUM, comm);
   const bool use_mpi_io = (dolfinx::MPI::size(comm) > 1);
   xdmf_utils::add_data_item(geometry_node, h5_id, h5_path, x, offset, shape, "",
-                            use_mpi_io);
+                            use_mpi_io, options);
 }
 //----------------------------------------------------------------------------
 void xdmf_mesh::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
                          const hid_t h5_id, const mesh::Mesh& mesh,
-                         const std::string name)
+                         const std::string name, const HDF5Options& options)
 {
   LOG(INFO) << "Adding mesh to node \"" << xml_node.path('/') << "\"";
 
@@ -223,10 +250,12 @@ void xdmf_mesh::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
 
   add_topology_data(comm, grid_node, h5_id, path_prefix, mesh.topology(),
                     mesh.geometry(), tdim,
-                    xtl::span<std::int32_t>(active_cells.data(), num_cells));
+                    xtl::span<std::int32_t>(active_cells.data(), num_cells),
+                    options);
 
   // Add geometry node and attributes (including writing data)
-  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh.geometry());
+  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh.geometry(),
+                    options);
 }
 //----------------------------------------------------------------------------
 xt::xtensor<double, 2> xdmf_mesh::read_geometry_data(MPI_Comm comm,
@@ -277,6 +306,56 @@ xt::xtensor<double, 2> xdmf_mesh::read_geometry_data(MPI_Comm comm,
   return x;
 }
 //----------------------------------------------------------------------------
+xt::xtensor<double, 2>
+xdmf_mesh::read_geometry_data(MPI_Comm /*comm*/, const hid_t h5_id,
+                              const pugi::xml_node& node,
+                              const xtl::span<const std::int64_t>& rows)
+{
+  // Get geometry node
+  pugi::xml_node geometry_node = node.child("Geometry");
+  assert(geometry_node);
+
+  // Determine geometric dimension
+  pugi::xml_attribute geometry_type_attr
+      = geometry_node.attribute("GeometryType");
+  assert(geometry_type_attr);
+  std::size_t gdim = 0;
+  const std::string geometry_type = geometry_type_attr.value();
+  if (geometry_type == "XY")
+    gdim = 2;
+  else if (geometry_type == "XYZ")
+    gdim = 3;
+  else
+  {
+    throw std::runtime_error(
+        "Cannot determine geometric dimension. GeometryType \"" + geometry_type
+        + "\" in XDMF file is unknown or unsupported");
+  }
+
+  // Get geometry dataitem node. The data must be stored in HDF5 for
+  // row selections to be possible.
+  pugi::xml_node geometry_data_node = geometry_node.child("DataItem");
+  assert(geometry_data_node);
+  pugi::xml_attribute format_attr = geometry_data_node.attribute("Format");
+  assert(format_attr);
+  if (std::string(format_attr.as_string()) != "HDF")
+  {
+    throw std::runtime_error("Cannot read selected geometry rows. Geometry "
+                             "data is not stored in HDF5 format");
+  }
+
+  // Read the selected rows only
+  const std::array paths = xdmf_utils::get_hdf5_paths(geometry_data_node);
+  std::vector<double> geometry_data
+      = HDF5Interface::read_dataset_rows<double>(h5_id, paths[1], rows);
+  assert(geometry_data.size() == rows.size() * gdim);
+
+  std::array<std::size_t, 2> shape = {rows.size(), gdim};
+  xt::xtensor<double, 2> x = xt::empty<double>(shape);
+  std::copy(geometry_data.begin(), geometry_data.end(), x.begin());
+  return x;
+}
+//----------------------------------------------------------------------------
 xt::xtensor<std::int64_t, 2>
 xdmf_mesh::read_topology_data(MPI_Comm comm, const hid_t h5_id,
                               const pugi::xml_node& node)
@@ -303,18 +382,20 @@ xdmf_mesh::read_topology_data(MPI_Comm comm, const hid_t h5_id,
       = xdmf_read::get_dataset<std::int64_t>(comm, topology_data_node, h5_id);
   const std::size_t num_local_cells = topology_data.size() / npoint_per_cell;
 
+  // Permute cells from VTK to DOLFINx ordering, in place on the read
+  // buffer so that no permuted copy of the topology is created
+  io::cells::apply_permutation(xtl::span<std::int64_t>(topology_data),
+                               io::cells::perm_vtk(cell_type, npoint_per_cell));
+
   std::array<std::size_t, 2> shape = {num_local_cells, npoint_per_cell};
 
   // The below should work, but misbehaves with the Intel icpx compiler
-  // auto cells_vtk = xt::adapt(topology_data.data(), topology_data.size(),
-  //                            xt::no_ownership(), shape);
+  // auto cells = xt::adapt(topology_data.data(), topology_data.size(),
+  //                        xt::no_ownership(), shape);
 
   // Explicitly copy to an xtensor
-  xt::xtensor<std::int64_t, 2> cells_vtk = xt::empty<std::int64_t>(shape);
-  std::copy(topology_data.begin(), topology_data.end(), cells_vtk.begin());
-
-  //  Permute cells from VTK to DOLFINx ordering
-  return io::cells::compute_permutation(
-      cells_vtk, io::cells::perm_vtk(cell_type, cells_vtk.shape(1)));
+  xt::xtensor<std::int64_t, 2> cells = xt::empty<std::int64_t>(shape);
+  std::copy(topology_data.begin(), topology_data.end(), cells.begin());
+  return cells;
 }
 //----------------------------------------------------------------------------
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "HDF5Interface.h"
 #include <hdf5.h>
 #include <mpi.h>
 #include <string>
@@ -36,7 +37,8 @@ namespace io::xdmf_mesh
 /// Creates new Grid with Topology and Geometry xml nodes for mesh. In
 /// HDF file data is stored under path prefix.
 void add_mesh(MPI_Comm comm, pugi::xml_node& xml_node, const hid_t h5_id,
-              const mesh::Mesh& mesh, const std::string path_prefix);
+              const mesh::Mesh& mesh, const std::string path_prefix,
+              const HDF5Options& options = HDF5Options());
 
 /// Add Topology xml node
 /// @param[in] comm
@@ -53,18 +55,34 @@ void add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
                        const hid_t h5_id, const std::string path_prefix,
                        const mesh::Topology& topology,
                        const mesh::Geometry& geometry, int cell_dim,
-                       const xtl::span<const std::int32_t>& active_entities);
+                       const xtl::span<const std::int32_t>& active_entities,
+                       const HDF5Options& options = HDF5Options());
 
 /// Add Geometry xml node
 void add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
                        const hid_t h5_id, const std::string path_prefix,
-                       const mesh::Geometry& geometry);
+                       const mesh::Geometry& geometry,
+                       const HDF5Options& options = HDF5Options());
 
 /// Read Geometry data
 /// @returns geometry
 xt::xtensor<double, 2> read_geometry_data(MPI_Comm comm, const hid_t h5_id,
                                           const pugi::xml_node& node);
 
+/// Read selected rows of the Geometry data by HDF5 hyperslab
+/// selections, so that each rank reads only the coordinates it
+/// requires. The geometry data must be stored in HDF5 format.
+/// @param[in] comm
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] node XML node of the Grid
+/// @param[in] rows Rows (global point indices) to read, sorted in
+///   ascending order without duplicates
+/// @returns The coordinates of the selected points, in the order of
+///   @p rows
+xt::xtensor<double, 2>
+read_geometry_data(MPI_Comm comm, const hid_t h5_id, const pugi::xml_node& node,
+                   const xtl::span<const std::int64_t>& rows);
+
 /// Read Topology data
 /// @returns ((cell type, degree), topology)
 xt::xtensor<std::int64_t, 2> read_topology_data(MPI_Comm comm,
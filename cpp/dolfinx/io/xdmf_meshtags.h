@@ -27,7 +27,8 @@ namespace xdmf_meshtags
 template <typename T>
 void add_meshtags(MPI_Comm comm, const mesh::MeshTags<T>& meshtags,
                   pugi::xml_node& xml_node, const hid_t h5_id,
-                  const std::string name)
+                  const std::string name,
+                  const HDF5Options& options = HDF5Options())
 {
   // Get mesh
   assert(meshtags.mesh());
@@ -48,7 +49,8 @@ void add_meshtags(MPI_Comm comm, const mesh::MeshTags<T>& meshtags,
       comm, xml_node, h5_id, path_prefix, mesh->topology(), mesh->geometry(),
       dim,
       xtl::span<const std::int32_t>(meshtags.indices().data(),
-                                    num_active_entities));
+                                    num_active_entities),
+      options);
 
   // Add attribute node with values
   pugi::xml_node attribute_node = xml_node.append_child("Attribute");
@@ -69,7 +71,7 @@ void add_meshtags(MPI_Comm comm, const mesh::MeshTags<T>& meshtags,
   xdmf_utils::add_data_item(
       attribute_node, h5_id, path_prefix + std::string("/Values"),
       xtl::span<const T>(meshtags.values().data(), num_active_entities), offset,
-      {global_num_values, 1}, "", use_mpi_io);
+      {global_num_values, 1}, "", use_mpi_io, options);
 }
 
 } // namespace xdmf_meshtags
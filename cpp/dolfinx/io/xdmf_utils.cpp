@@ -6,10 +6,13 @@
 
 #include "xdmf_utils.h"
 #include "pugixml.hpp"
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/sort.h>
 #include <dolfinx/fem/CoordinateElement.h>
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
@@ -22,6 +25,8 @@
 #include <dolfinx/mesh/cell_types.h>
 #include <dolfinx/mesh/utils.h>
 #include <map>
+#include <numeric>
+#include <set>
 #include <xtensor/xadapt.hpp>
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xview.hpp>
@@ -32,6 +37,42 @@ using namespace dolfinx::io;
 namespace
 {
 //-----------------------------------------------------------------------------
+// Mix a 64-bit value into a hash (splitmix64 finaliser). The same key
+// hashing is used for dual graph facet matching in mesh::graphbuild.
+constexpr std::uint64_t hash_mix(std::uint64_t x)
+{
+  x += UINT64_C(0x9e3779b97f4a7c15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+//-----------------------------------------------------------------------------
+// Exchange per-rank send buffers with the NBX sparse all-to-all,
+// sending only to ranks with a non-empty buffer. Returns the source
+// rank and received data for each non-empty incoming block.
+std::pair<std::vector<int>, graph::AdjacencyList<std::int64_t>>
+sparse_exchange(MPI_Comm comm,
+                const std::vector<std::vector<std::int64_t>>& send)
+{
+  std::vector<int> dest;
+  std::vector<std::int64_t> send_data;
+  std::vector<std::int32_t> send_offsets = {0};
+  for (std::size_t p = 0; p < send.size(); ++p)
+  {
+    if (!send[p].empty())
+    {
+      dest.push_back(p);
+      send_data.insert(send_data.end(), send[p].begin(), send[p].end());
+      send_offsets.push_back(send_data.size());
+    }
+  }
+
+  return dolfinx::MPI::sparse_all_to_all(
+      comm, dest,
+      graph::AdjacencyList<std::int64_t>(std::move(send_data),
+                                         std::move(send_offsets)));
+}
+//-----------------------------------------------------------------------------
 // Get data width - normally the same as u.value_size(), but expand for
 // 2D vector/tensor because XDMF presents everything as 3D
 std::int64_t get_padded_width(const fem::FiniteElement& e)
@@ -416,138 +457,248 @@ xdmf_utils::distribute_entity_data(const mesh::Mesh& mesh, int entity_dim,
   }
 
   // -------------------
-  // 1. Send this rank's global "input" nodes indices to the
-  //    'postmaster' rank, and receive global "input" nodes for which
-  //    this rank is the postmaster
+  // 1. Send each tagged entity (sorted vertex key and tag value) to a
+  //    match-making rank determined by a hash of its key. Hash routing
+  //    balances the matching work across ranks irrespective of the
+  //    global vertex numbering; tagged boundary entities are typically
+  //    clustered in index space, which badly imbalanced the previous
+  //    lowest-index 'postmaster' scheme.
 
   // Get "input" global node indices (as in the input file before any
   // internal re-ordering)
   const std::vector<std::int64_t>& nodes_g
       = mesh.geometry().input_global_indices();
-
-  // Send input global indices to 'post master' rank, based on input
-  // global index value
-  const std::int64_t num_nodes_g = mesh.geometry().index_map()->size_global();
   const MPI_Comm comm = mesh.mpi_comm();
   const int comm_size = MPI::size(comm);
-  // NOTE: could make this int32_t be sending: index <- index - dest_rank_offset
-  std::vector<std::vector<std::int64_t>> nodes_g_send(comm_size);
-  for (std::int64_t node : nodes_g)
+
+  const std::size_t nv = num_vertices_per_entity;
+
+  // Pack rows [v0, ..., v_{nv-1}, tag, hash] for the match-making rank
+  // hash % comm_size
+  const std::size_t file_shape1 = nv + 2;
+  std::vector<std::vector<std::int64_t>> file_send(comm_size);
   {
-    // TODO: Optimise this call by adding 'vectorised verion of
-    //       MPI::index_owner
-    // Figure out which process is the postmaster for the input global index
-    const std::int32_t p
-        = dolfinx::MPI::index_owner(comm_size, node, num_nodes_g);
-    nodes_g_send[p].push_back(node);
+    std::vector<std::int64_t> entity(nv);
+    for (std::size_t e = 0; e < entities_vertices.shape(0); ++e)
+    {
+      // Copy vertices for entity and sort
+      auto ev = xt::row(entities_vertices, e);
+      std::copy(ev.cbegin(), ev.cend(), entity.begin());
+      std::sort(entity.begin(), entity.end());
+
+      std::uint64_t h = 0;
+      for (std::int64_t v : entity)
+        h = hash_mix(h ^ std::uint64_t(v));
+
+      // Discard the top hash bit so the value is non-negative when
+      // stored in the std::int64_t exchange buffer
+      const std::int64_t hash = std::int64_t(h >> 1);
+      const int dest = hash % comm_size;
+      file_send[dest].insert(file_send[dest].end(), entity.begin(),
+                             entity.end());
+      file_send[dest].push_back(data[e]);
+      file_send[dest].push_back(hash);
+    }
   }
 
-  // Send/receive
-  const graph::AdjacencyList<std::int64_t> nodes_g_recv
-      = MPI::all_to_all(comm, graph::AdjacencyList<std::int64_t>(nodes_g_send));
+  const graph::AdjacencyList<std::int64_t> file_recv
+      = sparse_exchange(comm, file_send).second;
 
   // -------------------
-  // 2. Send the entity key (nodes list) and tag to the postmaster based
-  //    on the lowest index node in the entity 'key'
-  //
-  //    NOTE: Stage 2 doesn't depend on the data received in Step 1, so
-  //    data (i) the communication could be combined, or (ii) the
-  //    communication in Step 1 could be make non-blocking.
-
-  std::vector<std::vector<std::int64_t>> entities_send(comm_size);
-  std::vector<std::vector<std::int32_t>> data_send(comm_size);
-  std::vector<std::int64_t> entity(num_vertices_per_entity);
-  for (std::size_t e = 0; e < entities_vertices.shape(0); ++e)
+  // 2. Send every candidate entity on this rank (each cell sub-entity
+  //    of dimension entity_dim, keyed by the sorted input global
+  //    indices of its vertices) to the same match-making ranks.
+  //    Duplicate keys from entities shared by several local cells are
+  //    removed after a radix sort of the hashes.
+
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::AdjacencyList<int> e_to_v
+      = mesh::get_entity_vertices(mesh.topology().cell_type(), entity_dim);
+  const int num_entities_per_cell
+      = mesh::cell_num_entities(mesh.topology().cell_type(), entity_dim);
+
+  const std::int32_t num_cells = c_to_v->num_nodes();
+  std::vector<std::int64_t> cand_keys, cand_hash;
+  cand_keys.reserve(num_cells * num_entities_per_cell * nv);
+  cand_hash.reserve(num_cells * num_entities_per_cell);
   {
-    // Copy vertices for entity and sort
-    auto ev = xt::row(entities_vertices, e);
-    std::copy(ev.cbegin(), ev.cend(), entity.begin());
-    std::sort(entity.begin(), entity.end());
-
-    // Determine postmaster based on lowest entity node
-    const std::int32_t p
-        = dolfinx::MPI::index_owner(comm_size, entity.front(), num_nodes_g);
-    entities_send[p].insert(entities_send[p].end(), entity.begin(),
-                            entity.end());
-    data_send[p].push_back(data[e]);
+    std::vector<std::int64_t> entity(nv);
+    for (std::int32_t c = 0; c < num_cells; ++c)
+    {
+      auto x_dofs = x_dofmap.links(c);
+      for (int e = 0; e < num_entities_per_cell; ++e)
+      {
+        auto ev = e_to_v.links(e);
+        for (std::size_t k = 0; k < nv; ++k)
+          entity[k] = nodes_g[x_dofs[cell_vertex_dofs[ev[k]]]];
+        std::sort(entity.begin(), entity.end());
+        std::uint64_t h = 0;
+        for (std::int64_t v : entity)
+          h = hash_mix(h ^ std::uint64_t(v));
+        cand_keys.insert(cand_keys.end(), entity.begin(), entity.end());
+        cand_hash.push_back(std::int64_t(h >> 1));
+      }
+    }
+  }
+
+  // Radix sort candidate entities by hash and drop duplicate keys
+  std::vector<std::int32_t> cand_perm(cand_hash.size());
+  std::iota(cand_perm.begin(), cand_perm.end(), 0);
+  dolfinx::argsort_radix<std::int64_t>(
+      xtl::span<const std::int64_t>(cand_hash),
+      xtl::span<std::int32_t>(cand_perm));
+
+  // Pack rows [v0, ..., v_{nv-1}, hash]
+  const std::size_t cand_shape1 = nv + 1;
+  std::vector<std::vector<std::int64_t>> cand_send(comm_size);
+  for (std::size_t i = 0; i < cand_perm.size(); ++i)
+  {
+    const std::int32_t e = cand_perm[i];
+    if (i > 0)
+    {
+      // Skip duplicates: equal hash and equal key to the previous
+      // (sorted) candidate
+      const std::int32_t e0 = cand_perm[i - 1];
+      if (cand_hash[e] == cand_hash[e0]
+          and std::equal(std::next(cand_keys.begin(), e * nv),
+                         std::next(cand_keys.begin(), (e + 1) * nv),
+                         std::next(cand_keys.begin(), e0 * nv)))
+      {
+        continue;
+      }
+    }
+
+    const int dest = cand_hash[e] % comm_size;
+    cand_send[dest].insert(cand_send[dest].end(),
+                           std::next(cand_keys.begin(), e * nv),
+                           std::next(cand_keys.begin(), (e + 1) * nv));
+    cand_send[dest].push_back(cand_hash[e]);
   }
 
-  // TODO: Pack into one MPI call
-  const graph::AdjacencyList<std::int64_t> entities_recv = MPI::all_to_all(
-      comm, graph::AdjacencyList<std::int64_t>(entities_send));
-  const graph::AdjacencyList<std::int32_t> data_recv
-      = MPI::all_to_all(comm, graph::AdjacencyList<std::int32_t>(data_send));
+  const auto [cand_src_ranks, cand_recv] = sparse_exchange(comm, cand_send);
 
   // -------------------
-  // 3. As 'postmaster', send back the entity key (vertex list) and tag
-  //    value to ranks that possibly need the data. Do this based on the
-  //    first node index in the entity key.
-
-  // NOTE: Could: (i) use a std::unordered_multimap, or (ii) only send
-  // owned nodes to the postmaster and use map, unordered_map or
-  // std::vector<pair>>, followed by a neighborhood all_to_all at the
-  // end.
-  //
-  // Build map from global node index to ranks that have the node
-  std::multimap<std::int64_t, int> node_to_rank;
-  for (int p = 0; p < nodes_g_recv.num_nodes(); ++p)
+  // 3. As match-maker, radix sort both sides by hash, match tagged
+  //    entities to candidate keys (exact key comparison within runs of
+  //    equal hashes, so a hash collision cannot produce a false match)
+  //    and return (key, tag) to the ranks holding the entity through a
+  //    neighborhood collective.
+
+  const std::size_t num_file = file_recv.array().size() / file_shape1;
+  const std::size_t num_cand = cand_recv.array().size() / cand_shape1;
+  const std::vector<std::int64_t>& file_arr = file_recv.array();
+  const std::vector<std::int64_t>& cand_arr = cand_recv.array();
+
+  // Build candidate index to source rank array
+  std::vector<int> cand_src(num_cand);
+  for (int p = 0; p < cand_recv.num_nodes(); ++p)
   {
-    auto nodes = nodes_g_recv.links(p);
-    for (std::int32_t node : nodes)
-      node_to_rank.insert({node, p});
+    const std::size_t f0 = cand_recv.offsets()[p] / cand_shape1;
+    const std::size_t f1 = cand_recv.offsets()[p + 1] / cand_shape1;
+    for (std::size_t f = f0; f < f1; ++f)
+      cand_src[f] = cand_src_ranks[p];
   }
 
-  // Figure out which processes are owners of received nodes
-  std::vector<std::vector<std::int64_t>> send_nodes_owned(comm_size);
-  std::vector<std::vector<std::int32_t>> send_vals_owned(comm_size);
-  std::array<std::size_t, 2> shape
-      = {entities_recv.array().size() / num_vertices_per_entity,
-         num_vertices_per_entity};
-  auto _entities_recv
-      = xt::adapt(entities_recv.array().data(), entities_recv.array().size(),
-                  xt::no_ownership(), shape);
-
-  const std::vector<std::int32_t>& _data_recv = data_recv.array();
-  assert(_data_recv.size() == _entities_recv.shape(0));
-  for (std::size_t e = 0; e < _entities_recv.shape(0); ++e)
+  std::vector<std::int64_t> file_hash(num_file), cand_hash1(num_cand);
+  for (std::size_t e = 0; e < num_file; ++e)
+    file_hash[e] = file_arr[e * file_shape1 + nv + 1];
+  for (std::size_t e = 0; e < num_cand; ++e)
+    cand_hash1[e] = cand_arr[e * cand_shape1 + nv];
+
+  std::vector<std::int32_t> file_perm(num_file), cand_perm1(num_cand);
+  std::iota(file_perm.begin(), file_perm.end(), 0);
+  std::iota(cand_perm1.begin(), cand_perm1.end(), 0);
+  dolfinx::argsort_radix<std::int64_t>(
+      xtl::span<const std::int64_t>(file_hash),
+      xtl::span<std::int32_t>(file_perm));
+  dolfinx::argsort_radix<std::int64_t>(
+      xtl::span<const std::int64_t>(cand_hash1),
+      xtl::span<std::int32_t>(cand_perm1));
+
+  // Merge-walk the two hash-sorted lists, sending each match back to
+  // the rank that submitted the candidate key. Rows have the form
+  // [v0, ..., v_{nv-1}, tag].
+  std::map<int, std::vector<std::int64_t>> matched_send;
   {
-    auto e_recv = xt::row(_entities_recv, e);
-
-    // Find ranks that have node0
-    auto [it0, it1] = node_to_rank.equal_range(e_recv[0]);
-    for (auto it = it0; it != it1; ++it)
+    std::size_t c = 0;
+    for (std::size_t f = 0; f < num_file; ++f)
     {
-      const int p1 = it->second;
-      send_nodes_owned[p1].insert(send_nodes_owned[p1].end(), e_recv.begin(),
-                                  e_recv.end());
-      send_vals_owned[p1].push_back(_data_recv[e]);
+      const std::int32_t ef = file_perm[f];
+      const std::int64_t h = file_hash[ef];
+      while (c < num_cand and cand_hash1[cand_perm1[c]] < h)
+        ++c;
+      for (std::size_t c1 = c; c1 < num_cand; ++c1)
+      {
+        const std::int32_t ec = cand_perm1[c1];
+        if (cand_hash1[ec] != h)
+          break;
+        if (std::equal(std::next(file_arr.begin(), ef * file_shape1),
+                       std::next(file_arr.begin(), ef * file_shape1 + nv),
+                       std::next(cand_arr.begin(), ec * cand_shape1)))
+        {
+          std::vector<std::int64_t>& buffer = matched_send[cand_src[ec]];
+          buffer.insert(buffer.end(),
+                        std::next(file_arr.begin(), ef * file_shape1),
+                        std::next(file_arr.begin(), ef * file_shape1 + nv));
+          buffer.push_back(file_arr[ef * file_shape1 + nv]);
+        }
+      }
     }
   }
 
-  // TODO: Pack into one MPI call
-  const graph::AdjacencyList<std::int64_t> recv_ents = MPI::all_to_all(
-      comm, graph::AdjacencyList<std::int64_t>(send_nodes_owned));
-  const graph::AdjacencyList<std::int32_t> recv_vals = MPI::all_to_all(
-      comm, graph::AdjacencyList<std::int32_t>(send_vals_owned));
+  // Determine source ranks of the match send-back and create a
+  // neighborhood communicator
+  std::vector<int> match_dest;
+  match_dest.reserve(matched_send.size());
+  for (const auto& [rank, buffer] : matched_send)
+    match_dest.push_back(rank);
+  const std::vector<int> match_src = dolfinx::MPI::compute_graph_edges_nbx(
+      comm, std::set<int>(match_dest.begin(), match_dest.end()));
+
+  MPI_Comm neigh_comm;
+  MPI_Dist_graph_create_adjacent(comm, match_src.size(), match_src.data(),
+                                 MPI_UNWEIGHTED, match_dest.size(),
+                                 match_dest.data(), MPI_UNWEIGHTED,
+                                 MPI_INFO_NULL, false, &neigh_comm);
+
+  // Pack send buffer in neighbor (destination) order
+  std::vector<std::int64_t> matched_buffer;
+  std::vector<std::int32_t> matched_offsets(1, 0);
+  for (const int rank : match_dest)
+  {
+    const std::vector<std::int64_t>& buffer = matched_send[rank];
+    matched_buffer.insert(matched_buffer.end(), buffer.begin(), buffer.end());
+    matched_offsets.push_back(matched_buffer.size());
+  }
+
+  const graph::AdjacencyList<std::int64_t> recv_matched
+      = MPI::neighbor_all_to_all(
+          neigh_comm, graph::AdjacencyList<std::int64_t>(
+                          std::move(matched_buffer), std::move(matched_offsets)));
+  MPI_Comm_free(&neigh_comm);
+
+  // Unpack received (key, tag) rows
+  const std::size_t num_matched = recv_matched.array().size() / cand_shape1;
+  std::vector<std::int64_t> recv_ents;
+  recv_ents.reserve(num_matched * nv);
+  std::vector<std::int32_t> recv_vals;
+  recv_vals.reserve(num_matched);
+  for (std::size_t e = 0; e < num_matched; ++e)
+  {
+    recv_ents.insert(recv_ents.end(),
+                     std::next(recv_matched.array().begin(), e * cand_shape1),
+                     std::next(recv_matched.array().begin(),
+                               e * cand_shape1 + nv));
+    recv_vals.push_back(recv_matched.array()[e * cand_shape1 + nv]);
+  }
 
   // -------------------
-  // 4. From the received (key, value) data, determine which keys
-  //    (entities) are on this process.
-
-  // TODO: Rather than using std::map<std::vector<std::int64_t>,
-  //       std::int32_t>, use a rectangular array to avoid the
-  //       cost of std::vector<std::int64_t> allocations, and sort the
-  //       Array by row.
-  //
-  // TODO: We have already received possibly tagged entities from other
-  //       ranks, so we could use the received data to avoid creating
-  //       the std::map for *all* entities and just for candidate
-  //       entities.
+  // 4. Convert the received (key, value) data to local vertex indices.
+  //    Keys were only returned to ranks that submitted the matching
+  //    candidate, so every received key is resolvable locally.
 
   // Build map from input global indices to local vertex numbers
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
   std::map<std::int64_t, std::int32_t> igi_to_vertex;
-
   for (int c = 0; c < c_to_v->num_nodes(); ++c)
   {
     auto vertices = c_to_v->links(c);
@@ -557,18 +708,17 @@ xdmf_utils::distribute_entity_data(const mesh::Mesh& mesh, int entity_dim,
   }
 
   std::vector<std::int32_t> entities_new;
-  entities_new.reserve(recv_ents.array().size());
+  entities_new.reserve(recv_ents.size());
   std::vector<std::int32_t> data_new;
-  data_new.reserve(recv_vals.array().size());
-  for (std::size_t e = 0;
-       e < recv_ents.array().size() / num_vertices_per_entity; ++e)
+  data_new.reserve(recv_vals.size());
+  for (std::size_t e = 0; e < recv_ents.size() / num_vertices_per_entity; ++e)
   {
     bool entity_found = true;
     std::vector<std::int32_t> entity(num_vertices_per_entity);
     for (std::size_t i = 0; i < num_vertices_per_entity; ++i)
     {
-      const auto it = igi_to_vertex.find(
-          recv_ents.array()[e * num_vertices_per_entity + i]);
+      const auto it
+          = igi_to_vertex.find(recv_ents[e * num_vertices_per_entity + i]);
       if (it == igi_to_vertex.end())
       {
         // As soon as this received index is not in locally owned input
@@ -582,7 +732,7 @@ xdmf_utils::distribute_entity_data(const mesh::Mesh& mesh, int entity_dim,
     if (entity_found == true)
     {
       entities_new.insert(entities_new.end(), entity.begin(), entity.end());
-      data_new.push_back(recv_vals.array()[e]);
+      data_new.push_back(recv_vals[e]);
     }
   }
 
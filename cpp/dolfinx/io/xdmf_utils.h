@@ -12,6 +12,7 @@
 #include <array>
 #include <dolfinx/common/utils.h>
 #include <dolfinx/mesh/cell_types.h>
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -108,7 +109,8 @@ void add_data_item(pugi::xml_node& xml_node, const hid_t h5_id,
                    const std::string h5_path, const T& x,
                    const std::int64_t offset,
                    const std::vector<std::int64_t> shape,
-                   const std::string number_type, const bool use_mpi_io)
+                   const std::string number_type, const bool use_mpi_io,
+                   const HDF5Options& options = HDF5Options())
 {
   // Add DataItem node
   assert(xml_node);
@@ -157,7 +159,7 @@ void add_data_item(pugi::xml_node& xml_node, const hid_t h5_id,
 
     const std::array local_range{offset, offset + local_shape0};
     HDF5Interface::write_dataset(h5_id, h5_path, x.data(), local_range, shape,
-                                 use_mpi_io, false);
+                                 use_mpi_io, false, options);
 
     // Add partitioning attribute to dataset
     // std::vector<std::size_t> partitions;
@@ -168,5 +170,71 @@ void add_data_item(pugi::xml_node& xml_node, const hid_t h5_id,
   }
 }
 
+/// Add a DataItem node whose HDF5 dataset is written in bounded-size
+/// blocks produced on demand (HDF5 encoding only, i.e. @p h5_id must
+/// be a valid file handle). Rows [row0, row0 + num_rows) of this
+/// process' range are packed into the supplied buffer by @p pack,
+/// written, and the buffer re-used, so the full local contribution is
+/// never materialised.
+/// @param[in] comm MPI communicator of the processes sharing the file
+/// @param[in] xml_node XML node to add the DataItem to
+/// @param[in] h5_id HDF5 file handle
+/// @param[in] h5_path Path for the dataset in the HDF5 file
+/// @param[in] pack Callback packing rows of this process' range
+/// @param[in] offset Global row offset of this process' range
+/// @param[in] num_local_rows Number of rows on this process
+/// @param[in] shape The global shape of the dataset
+/// @param[in] number_type XDMF number type attribute ("" to omit)
+/// @param[in] use_mpi_io True if MPI-IO should be used
+/// @param[in] options Transfer tuning options
+template <typename T>
+void add_data_item(
+    MPI_Comm comm, pugi::xml_node& xml_node, const hid_t h5_id,
+    const std::string h5_path,
+    const std::function<void(std::int64_t, std::int64_t, T*)>& pack,
+    const std::int64_t offset, const std::int64_t num_local_rows,
+    const std::vector<std::int64_t> shape, const std::string number_type,
+    const bool use_mpi_io, const HDF5Options& options = HDF5Options())
+{
+  assert(h5_id > 0);
+
+  // Add DataItem node
+  assert(xml_node);
+  pugi::xml_node data_item_node = xml_node.append_child("DataItem");
+  assert(data_item_node);
+
+  // Add dimensions attribute
+  std::string dims;
+  for (auto d : shape)
+    dims += std::to_string(d) + std::string(" ");
+  dims.pop_back();
+  data_item_node.append_attribute("Dimensions") = dims.c_str();
+
+  // Set type for topology data (needed by XDMF to prevent default to
+  // float)
+  if (!number_type.empty())
+    data_item_node.append_attribute("NumberType") = number_type.c_str();
+
+  data_item_node.append_attribute("Format") = "HDF";
+
+  // Add HDF5 filename and HDF5 internal path to XML file
+  const std::string hdf5_filename = HDF5Interface::get_filename(h5_id);
+  const std::string filename = dolfinx::io::get_filename(hdf5_filename);
+  const std::string xdmf_path = filename + std::string(":") + h5_path;
+  data_item_node.append_child(pugi::node_pcdata).set_value(xdmf_path.c_str());
+
+  // Bound the staging buffer to 32 MB per process
+  std::int64_t row_size = 1;
+  for (std::size_t i = 1; i < shape.size(); ++i)
+    row_size *= shape[i];
+  const std::int64_t block_bytes = 1 << 25;
+  const std::int64_t block_rows = std::max(
+      std::int64_t(1), block_bytes / std::int64_t(row_size * sizeof(T)));
+
+  const std::array local_range{offset, offset + num_local_rows};
+  HDF5Interface::write_dataset_blocked(comm, h5_id, h5_path, pack, local_range,
+                                       shape, block_rows, use_mpi_io, options);
+}
+
 } // namespace io::xdmf_utils
 } // namespace dolfinx
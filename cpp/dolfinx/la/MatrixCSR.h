@@ -0,0 +1,453 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "SparsityPattern.h"
+#include <algorithm>
+#include <array>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::la
+{
+
+/// Distributed sparse matrix in compressed sparse row (CSR) format.
+///
+/// The matrix is built directly on an assembled la::SparsityPattern:
+/// storage is preallocated exactly, with the owned rows split into a
+/// diagonal (owned columns) and an off-diagonal (ghost columns) CSR
+/// block, plus a CSR block for rows that are ghosted on this process.
+/// Values are accumulated with add(), which writes only to the rows it
+/// is given; threads inserting into distinct rows may therefore call
+/// add() concurrently without locks or atomics, e.g. from a coloured
+/// assembly loop. finalize() sends the accumulated ghost row values to
+/// the owning processes in a neighborhood collective and zeroes the
+/// ghost rows.
+///
+/// The row and column block size of the sparsity pattern must be 1.
+/// The CSR arrays of the owned blocks can be accessed directly, e.g.
+/// for a zero-copy handoff to a solver library (see
+/// la::create_petsc_matrix for PETSc).
+template <typename T>
+class MatrixCSR
+{
+public:
+  /// The value type
+  using value_type = T;
+
+  /// Create a distributed matrix
+  /// @param[in] p The sparsity pattern. Must be assembled.
+  MatrixCSR(const SparsityPattern& p)
+      : _index_maps({p.index_map(0), p.index_map(1)}),
+        _col_ghosts(p.column_indices())
+  {
+    if (p.block_size(0) != 1 or p.block_size(1) != 1)
+    {
+      throw std::runtime_error(
+          "MatrixCSR requires a sparsity pattern with block size 1.");
+    }
+
+    assert(_index_maps[0]);
+    assert(_index_maps[1]);
+    const std::int32_t local_size1 = _index_maps[1]->size_local();
+
+    // Keep the global indices of the ghost columns only
+    _col_ghosts.erase(_col_ghosts.begin(), _col_ghosts.begin() + local_size1);
+
+    // Owned rows, diagonal (owned columns) block. Column indices in
+    // the pattern are sorted, which add() relies on.
+    const graph::AdjacencyList<std::int32_t>& diag = p.diagonal_pattern();
+    _row_ptr.assign(diag.offsets().begin(), diag.offsets().end());
+    _cols.assign(diag.array().begin(), diag.array().end());
+    _data.assign(_cols.size(), 0);
+
+    // Owned rows, off-diagonal (ghost columns) block. Columns are
+    // stored as positions in the ghost column array.
+    const graph::AdjacencyList<std::int32_t>& off = p.off_diagonal_pattern();
+    _row_ptr_off.assign(off.offsets().begin(), off.offsets().end());
+    _cols_off.resize(off.array().size());
+    std::transform(off.array().begin(), off.array().end(), _cols_off.begin(),
+                   [local_size1](std::int32_t c) { return c - local_size1; });
+    _data_off.assign(_cols_off.size(), 0);
+
+    // Ghost rows, using the combined local column indexing
+    const graph::AdjacencyList<std::int32_t>& ghost = p.ghost_row_pattern();
+    _ghost_row_ptr.assign(ghost.offsets().begin(), ghost.offsets().end());
+    _ghost_cols.assign(ghost.array().begin(), ghost.array().end());
+    _ghost_data.assign(_ghost_cols.size(), 0);
+  }
+
+  // Copying a matrix is expensive and normally unintended
+  MatrixCSR(const MatrixCSR&) = delete;
+
+  /// Move constructor
+  MatrixCSR(MatrixCSR&& A) = default;
+
+  /// Destructor
+  ~MatrixCSR() = default;
+
+  /// Add values to the matrix using local indices
+  ///
+  /// Entries must exist in the sparsity pattern the matrix was built
+  /// from. Only the given rows are written, so concurrent calls are
+  /// safe provided they touch distinct rows.
+  /// @param[in] nr Number of rows
+  /// @param[in] rows Local row indices (owned rows first, then ghosts)
+  /// @param[in] nc Number of columns
+  /// @param[in] cols Local column indices
+  /// @param[in] vals Row-major block of values (nr x nc)
+  int add(std::int32_t nr, const std::int32_t* rows, std::int32_t nc,
+          const std::int32_t* cols, const T* vals)
+  {
+    const std::int32_t num_owned = _index_maps[0]->size_local();
+    const std::int32_t local_size1 = _index_maps[1]->size_local();
+    for (std::int32_t i = 0; i < nr; ++i)
+    {
+      const std::int32_t row = rows[i];
+      const T* vals_row = vals + i * nc;
+      if (row < num_owned)
+      {
+        for (std::int32_t j = 0; j < nc; ++j)
+        {
+          const std::int32_t col = cols[j];
+          if (col < local_size1)
+            add_entry(_data, _cols, _row_ptr[row], _row_ptr[row + 1], col,
+                      vals_row[j]);
+          else
+          {
+            add_entry(_data_off, _cols_off, _row_ptr_off[row],
+                      _row_ptr_off[row + 1], col - local_size1, vals_row[j]);
+          }
+        }
+      }
+      else
+      {
+        const std::int32_t rg = row - num_owned;
+        for (std::int32_t j = 0; j < nc; ++j)
+        {
+          add_entry(_ghost_data, _ghost_cols, _ghost_row_ptr[rg],
+                    _ghost_row_ptr[rg + 1], cols[j], vals_row[j]);
+        }
+      }
+    }
+    return 0;
+  }
+
+  /// Direct offset of an entry into the stored values, counted over
+  /// the concatenation [diagonal | off-diagonal | ghost rows] of the
+  /// value arrays. The entry must exist in the sparsity pattern. The
+  /// offset stays valid for the lifetime of the matrix, so the column
+  /// search can be paid once and subsequent insertions stream values
+  /// with add_at().
+  /// @param[in] row Local row index (owned rows first, then ghosts)
+  /// @param[in] col Local column index
+  /// @return Offset of the entry for use with add_at()
+  std::int64_t entry_offset(std::int32_t row, std::int32_t col) const
+  {
+    const std::int32_t num_owned = _index_maps[0]->size_local();
+    const std::int32_t local_size1 = _index_maps[1]->size_local();
+    if (row < num_owned)
+    {
+      if (col < local_size1)
+        return find_entry(_cols, _row_ptr[row], _row_ptr[row + 1], col);
+      else
+      {
+        return std::int64_t(_data.size())
+               + find_entry(_cols_off, _row_ptr_off[row], _row_ptr_off[row + 1],
+                            col - local_size1);
+      }
+    }
+    else
+    {
+      const std::int32_t rg = row - num_owned;
+      return std::int64_t(_data.size()) + _data_off.size()
+             + find_entry(_ghost_cols, _ghost_row_ptr[rg],
+                          _ghost_row_ptr[rg + 1], col);
+    }
+  }
+
+  /// Add values at offsets precomputed with entry_offset(). Negative
+  /// offsets are skipped, which lets callers mask entries (e.g. rows
+  /// and columns with a Dirichlet condition) in a precomputed offset
+  /// map. No index search is performed. As for add(), concurrent calls
+  /// are safe provided they touch distinct rows.
+  /// @param[in] offsets Value offsets, from entry_offset(), or negative
+  /// to skip
+  /// @param[in] n Number of entries
+  /// @param[in] vals Values to add
+  void add_at(const std::int64_t* offsets, std::int32_t n, const T* vals)
+  {
+    const std::int64_t na = _data.size();
+    const std::int64_t nb = na + std::int64_t(_data_off.size());
+    for (std::int32_t k = 0; k < n; ++k)
+    {
+      const std::int64_t q = offsets[k];
+      if (q < 0)
+        continue;
+      else if (q < na)
+        _data[q] += vals[k];
+      else if (q < nb)
+        _data_off[q - na] += vals[k];
+      else
+        _ghost_data[q - nb] += vals[k];
+    }
+  }
+
+  /// Positions of the diagonal entries of the owned rows in the value
+  /// array of the diagonal block, computed with one column search per
+  /// row on first call and cached for the lifetime of the matrix.
+  /// Rows without a diagonal entry in the sparsity pattern (possible
+  /// for rectangular operators) hold -1.
+  const std::vector<std::int32_t>& diagonal_positions() const
+  {
+    const std::int32_t num_owned = _index_maps[0]->size_local();
+    if (_diag_pos.empty() and num_owned > 0)
+    {
+      const std::int32_t local_size1 = _index_maps[1]->size_local();
+      _diag_pos.resize(num_owned);
+      for (std::int32_t row = 0; row < num_owned; ++row)
+      {
+        _diag_pos[row] = row < local_size1
+                             ? find_entry(_cols, _row_ptr[row],
+                                          _row_ptr[row + 1], row)
+                             : -1;
+      }
+    }
+    return _diag_pos;
+  }
+
+  /// Overwrite the diagonal entry of the given owned rows, streaming
+  /// through the precomputed diagonal-position array with no per-row
+  /// column search and no insertion-function indirection. Typically
+  /// called for the Dirichlet rows after assembly, which zeroes them.
+  /// @param[in] rows Local indices of the owned rows to set
+  /// @param[in] diagonal The value to set on the diagonal
+  void set_diagonal(const xtl::span<const std::int32_t>& rows, T diagonal)
+  {
+    const std::vector<std::int32_t>& pos = diagonal_positions();
+    for (std::int32_t row : rows)
+    {
+      assert(row < _index_maps[0]->size_local());
+      assert(pos[row] >= 0);
+      _data[pos[row]] = diagonal;
+    }
+  }
+
+  /// Insertion function compatible with the fem assembly entry points.
+  /// The function references this matrix, which must outlive it.
+  std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                    const std::int32_t*, const T*)>
+  mat_add_values()
+  {
+    return [this](std::int32_t nr, const std::int32_t* rows, std::int32_t nc,
+                  const std::int32_t* cols, const T* vals)
+    { return this->add(nr, rows, nc, cols, vals); };
+  }
+
+  /// Send the accumulated ghost row values to the owning processes,
+  /// where they are added to the owned rows, and zero the ghost rows.
+  /// Collective over the ghost->owner neighborhood of the row IndexMap.
+  void finalize()
+  {
+    const std::int32_t num_ghosts0 = _index_maps[0]->num_ghosts();
+    const std::vector<std::int64_t>& ghosts0 = _index_maps[0]->ghosts();
+    const std::vector<int> ghost_owners0 = _index_maps[0]->ghost_owner_rank();
+    const std::array local_range0 = _index_maps[0]->local_range();
+    const std::int32_t local_size1 = _index_maps[1]->size_local();
+    const std::array local_range1 = _index_maps[1]->local_range();
+
+    // Get ghost->owner communicator for rows
+    MPI_Comm comm = _index_maps[0]->comm(common::IndexMap::Direction::reverse);
+    const std::vector<int> dest_ranks = dolfinx::MPI::neighbors(comm)[1];
+
+    // Map ghost rows to their neighborhood rank and compute the data
+    // size for each destination
+    std::vector<int> ghost_to_neighbour_rank(num_ghosts0, -1);
+    std::vector<std::int32_t> data_per_proc(dest_ranks.size(), 0);
+    for (std::int32_t i = 0; i < num_ghosts0; ++i)
+    {
+      const auto it
+          = std::find(dest_ranks.begin(), dest_ranks.end(), ghost_owners0[i]);
+      assert(it != dest_ranks.end());
+      ghost_to_neighbour_rank[i] = std::distance(dest_ranks.begin(), it);
+      data_per_proc[ghost_to_neighbour_rank[i]]
+          += _ghost_row_ptr[i + 1] - _ghost_row_ptr[i];
+    }
+
+    // Compute send displacements
+    std::vector<std::int32_t> send_disp(dest_ranks.size() + 1, 0);
+    std::partial_sum(data_per_proc.begin(), data_per_proc.end(),
+                     std::next(send_disp.begin()));
+
+    // Pack (global row, global column) pairs and values for each ghost
+    // row entry, grouped by destination
+    std::vector<std::int32_t> insert_pos(send_disp.begin(),
+                                         std::prev(send_disp.end()));
+    std::vector<std::int64_t> index_send(2 * send_disp.back());
+    std::vector<T> value_send(send_disp.back());
+    for (std::int32_t i = 0; i < num_ghosts0; ++i)
+    {
+      const int neighbour_rank = ghost_to_neighbour_rank[i];
+      for (std::int32_t k = _ghost_row_ptr[i]; k < _ghost_row_ptr[i + 1]; ++k)
+      {
+        const std::int32_t pos = insert_pos[neighbour_rank]++;
+        index_send[2 * pos] = ghosts0[i];
+        index_send[2 * pos + 1]
+            = _ghost_cols[k] < local_size1
+                  ? _ghost_cols[k] + local_range1[0]
+                  : _col_ghosts[_ghost_cols[k] - local_size1];
+        value_send[pos] = _ghost_data[k];
+      }
+    }
+
+    // Exchange indices and values with the row-owning processes
+    std::vector<std::int32_t> index_offsets(send_disp.size());
+    std::transform(send_disp.begin(), send_disp.end(), index_offsets.begin(),
+                   [](std::int32_t d) { return 2 * d; });
+    const graph::AdjacencyList<std::int64_t> index_recv
+        = MPI::neighbor_all_to_all(
+            comm, graph::AdjacencyList<std::int64_t>(std::move(index_send),
+                                                     std::move(index_offsets)));
+    const graph::AdjacencyList<T> value_recv = MPI::neighbor_all_to_all(
+        comm, graph::AdjacencyList<T>(std::move(value_send),
+                                      std::move(send_disp)));
+
+    // Add the received values to the owned rows
+    const std::vector<std::int64_t>& index_data = index_recv.array();
+    const std::vector<T>& value_data = value_recv.array();
+    for (std::size_t e = 0; e < value_data.size(); ++e)
+    {
+      const std::int32_t row = index_data[2 * e] - local_range0[0];
+      const std::int64_t col = index_data[2 * e + 1];
+      assert(row >= 0 and row < _index_maps[0]->size_local());
+      if (col >= local_range1[0] and col < local_range1[1])
+      {
+        add_entry(_data, _cols, _row_ptr[row], _row_ptr[row + 1],
+                  col - local_range1[0], value_data[e]);
+      }
+      else
+      {
+        const auto it
+            = std::find(_col_ghosts.begin(), _col_ghosts.end(), col);
+        assert(it != _col_ghosts.end());
+        add_entry(_data_off, _cols_off, _row_ptr_off[row], _row_ptr_off[row + 1],
+                  std::distance(_col_ghosts.begin(), it), value_data[e]);
+      }
+    }
+
+    // Ghost row contributions have been handed over
+    std::fill(_ghost_data.begin(), _ghost_data.end(), 0);
+  }
+
+  /// Set all stored entries (owned and ghost rows) to a value,
+  /// typically zero before re-assembly
+  void set(T x)
+  {
+    std::fill(_data.begin(), _data.end(), x);
+    std::fill(_data_off.begin(), _data_off.end(), x);
+    std::fill(_ghost_data.begin(), _ghost_data.end(), x);
+  }
+
+  /// Index maps for the row (0) and column (1) space
+  std::shared_ptr<const common::IndexMap> index_map(int dim) const
+  {
+    return _index_maps.at(dim);
+  }
+
+  /// Row pointer array of the owned diagonal block
+  xtl::span<const std::int32_t> row_ptr() const { return _row_ptr; }
+
+  /// Column indices (owned, local) of the diagonal block
+  xtl::span<const std::int32_t> cols() const { return _cols; }
+
+  /// Values of the diagonal block
+  xtl::span<const T> values() const { return _data; }
+
+  /// Values of the diagonal block
+  xtl::span<T> values() { return _data; }
+
+  /// Row pointer array of the off-diagonal block
+  xtl::span<const std::int32_t> off_diag_row_ptr() const
+  {
+    return _row_ptr_off;
+  }
+
+  /// Column indices of the off-diagonal block, as positions in the
+  /// ghost column array
+  xtl::span<const std::int32_t> off_diag_cols() const { return _cols_off; }
+
+  /// Values of the off-diagonal block
+  xtl::span<const T> off_diag_values() const { return _data_off; }
+
+  /// Values of the off-diagonal block
+  xtl::span<T> off_diag_values() { return _data_off; }
+
+  /// Global indices of the ghost columns, indexed by the off-diagonal
+  /// column positions
+  const std::vector<std::int64_t>& column_ghosts() const
+  {
+    return _col_ghosts;
+  }
+
+private:
+  // Position of the entry with column index col in the sorted segment
+  // [begin, end) of the column array
+  static std::int32_t find_entry(const std::vector<std::int32_t>& cols,
+                                 std::int32_t begin, std::int32_t end,
+                                 std::int32_t col)
+  {
+    const auto it = std::lower_bound(std::next(cols.begin(), begin),
+                                     std::next(cols.begin(), end), col);
+    assert(it != std::next(cols.begin(), end) and *it == col);
+    return std::distance(cols.begin(), it);
+  }
+
+  // Add a value to the entry with column index col in the sorted
+  // segment [begin, end) of the column array
+  static void add_entry(std::vector<T>& data,
+                        const std::vector<std::int32_t>& cols,
+                        std::int32_t begin, std::int32_t end, std::int32_t col,
+                        T x)
+  {
+    const auto it = std::lower_bound(std::next(cols.begin(), begin),
+                                     std::next(cols.begin(), end), col);
+    assert(it != std::next(cols.begin(), end) and *it == col);
+    data[std::distance(cols.begin(), it)] += x;
+  }
+
+  // Index maps for the row (0) and column (1) space
+  std::array<std::shared_ptr<const common::IndexMap>, 2> _index_maps;
+
+  // Owned rows, diagonal (owned columns) block
+  std::vector<std::int32_t> _row_ptr, _cols;
+  std::vector<T> _data;
+
+  // Owned rows, off-diagonal (ghost columns) block. Column indices are
+  // positions in _col_ghosts.
+  std::vector<std::int32_t> _row_ptr_off, _cols_off;
+  std::vector<T> _data_off;
+
+  // Lazily built positions of the owned diagonal entries in _data (see
+  // diagonal_positions). Empty means not built.
+  mutable std::vector<std::int32_t> _diag_pos;
+
+  // Ghost rows, using the combined local column indexing
+  std::vector<std::int32_t> _ghost_row_ptr, _ghost_cols;
+  std::vector<T> _ghost_data;
+
+  // Global indices of the ghost columns
+  std::vector<std::int64_t> _col_ghosts;
+};
+
+} // namespace dolfinx::la
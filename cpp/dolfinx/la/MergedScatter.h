@@ -0,0 +1,388 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Vector.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Telemetry.h>
+#include <memory>
+#include <mpi.h>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::la
+{
+
+/// Merged ghost scatters for a set of vectors on (possibly) different
+/// index maps. The messages of all vectors to a given rank are merged
+/// into one, so each scatter costs one message per neighbor rank for
+/// the whole set rather than per vector, e.g. for the per-field ghost
+/// updates of a coupled solver at the latency-dominated strong-scaling
+/// limit. The merged communication plan (neighborhood communicators
+/// and packing orders) is built once at construction and re-used by
+/// every scatter.
+///
+/// For vectors that share a single IndexMap the free functions
+/// la::scatter_fwd/la::scatter_rev achieve the same message count
+/// without a persistent plan. All index maps must be defined on
+/// congruent communicators, so that ranks are comparable across maps.
+class MergedScatter
+{
+public:
+  /// Create a merged communication plan for a set of vector layouts
+  /// @note Collective
+  /// @param[in] maps The (index map, block size) pair of each vector
+  /// in the set, in the order the vectors are later passed to the
+  /// scatters
+  explicit MergedScatter(
+      const std::vector<std::pair<std::shared_ptr<const common::IndexMap>,
+                                  int>>& maps)
+      : _maps(maps)
+  {
+    if (maps.empty())
+      throw std::runtime_error("No index maps provided");
+
+    // Destination (ghosting) ranks of each map, in the neighbor order
+    // of its owner-to-ghost communicator. The neighborhood
+    // communicators share the group of the base communicator, so the
+    // ranks are comparable across maps.
+    const std::size_t nv = maps.size();
+    std::vector<std::vector<int>> dst(nv);
+    for (std::size_t m = 0; m < nv; ++m)
+    {
+      assert(maps[m].first);
+      MPI_Comm fwd = maps[m].first->comm(common::IndexMap::Direction::forward);
+      int indegree(-1), outdegree(-1), weighted(-1);
+      MPI_Dist_graph_neighbors_count(fwd, &indegree, &outdegree, &weighted);
+      std::vector<int> src(indegree);
+      dst[m].resize(outdegree);
+      MPI_Dist_graph_neighbors(fwd, indegree, src.data(), MPI_UNWEIGHTED,
+                               outdegree, dst[m].data(), MPI_UNWEIGHTED);
+    }
+
+    // Merged destination rank set
+    for (std::size_t m = 0; m < nv; ++m)
+      _dest_ranks.insert(_dest_ranks.end(), dst[m].begin(), dst[m].end());
+    std::sort(_dest_ranks.begin(), _dest_ranks.end());
+    _dest_ranks.erase(std::unique(_dest_ranks.begin(), _dest_ranks.end()),
+                      _dest_ranks.end());
+
+    // Send plan: for each destination rank, the owned indices each map
+    // sends to it, maps in order. Within a (rank, map) block the
+    // indices keep the order of the map's own scatter, which is the
+    // order the receiver expects.
+    _send_sizes.assign(_dest_ranks.size(), 0);
+    for (std::size_t r = 0; r < _dest_ranks.size(); ++r)
+    {
+      for (std::size_t m = 0; m < nv; ++m)
+      {
+        auto it = std::find(dst[m].begin(), dst[m].end(), _dest_ranks[r]);
+        if (it == dst[m].end())
+          continue;
+        const int p = std::distance(dst[m].begin(), it);
+        auto indices = maps[m].first->scatter_fwd_indices().links(p);
+        for (std::int32_t idx : indices)
+          _send_plan.push_back({std::int32_t(m), idx});
+        _send_sizes[r] += maps[m].second * indices.size();
+      }
+    }
+    _send_displs.resize(_dest_ranks.size() + 1, 0);
+    std::partial_sum(_send_sizes.begin(), _send_sizes.end(),
+                     std::next(_send_displs.begin()));
+
+    // Merged source (owning) rank set
+    std::vector<std::vector<int>> owners(nv);
+    for (std::size_t m = 0; m < nv; ++m)
+    {
+      owners[m] = maps[m].first->ghost_owner_rank();
+      _src_ranks.insert(_src_ranks.end(), owners[m].begin(), owners[m].end());
+    }
+    std::sort(_src_ranks.begin(), _src_ranks.end());
+    _src_ranks.erase(std::unique(_src_ranks.begin(), _src_ranks.end()),
+                     _src_ranks.end());
+
+    // Receive plan: for each source rank, the ghosts each map receives
+    // from it, maps in order. Within a (rank, map) block the ghosts
+    // are ordered by their position in the map's own receive buffer,
+    // which is the order the owner packs them.
+    _recv_sizes.assign(_src_ranks.size(), 0);
+    for (std::size_t r = 0; r < _src_ranks.size(); ++r)
+    {
+      for (std::size_t m = 0; m < nv; ++m)
+      {
+        const std::vector<std::int32_t>& pos
+            = maps[m].first->scatter_fwd_ghost_positions();
+        std::vector<std::int32_t> ghosts;
+        for (std::size_t i = 0; i < owners[m].size(); ++i)
+        {
+          if (owners[m][i] == _src_ranks[r])
+            ghosts.push_back(i);
+        }
+        std::sort(ghosts.begin(), ghosts.end(),
+                  [&pos](std::int32_t a, std::int32_t b)
+                  { return pos[a] < pos[b]; });
+        for (std::int32_t g : ghosts)
+          _recv_plan.push_back({std::int32_t(m), g});
+        _recv_sizes[r] += maps[m].second * ghosts.size();
+      }
+    }
+    _recv_displs.resize(_src_ranks.size() + 1, 0);
+    std::partial_sum(_recv_sizes.begin(), _recv_sizes.end(),
+                     std::next(_recv_displs.begin()));
+
+    // Merged neighborhood communicators for the two directions
+    MPI_Comm base = maps.front().first->comm();
+    MPI_Dist_graph_create_adjacent(
+        base, _src_ranks.size(), _src_ranks.data(), MPI_UNWEIGHTED,
+        _dest_ranks.size(), _dest_ranks.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+        false, &_comm_fwd);
+    MPI_Dist_graph_create_adjacent(
+        base, _dest_ranks.size(), _dest_ranks.data(), MPI_UNWEIGHTED,
+        _src_ranks.size(), _src_ranks.data(), MPI_UNWEIGHTED, MPI_INFO_NULL,
+        false, &_comm_rev);
+  }
+
+  // Copy constructor (deleted)
+  MergedScatter(const MergedScatter&) = delete;
+
+  /// Move constructor
+  MergedScatter(MergedScatter&& scatter)
+      : _maps(std::move(scatter._maps)),
+        _dest_ranks(std::move(scatter._dest_ranks)),
+        _send_sizes(std::move(scatter._send_sizes)),
+        _send_displs(std::move(scatter._send_displs)),
+        _send_plan(std::move(scatter._send_plan)),
+        _src_ranks(std::move(scatter._src_ranks)),
+        _recv_sizes(std::move(scatter._recv_sizes)),
+        _recv_displs(std::move(scatter._recv_displs)),
+        _recv_plan(std::move(scatter._recv_plan)),
+        _comm_fwd(std::exchange(scatter._comm_fwd, MPI_COMM_NULL)),
+        _comm_rev(std::exchange(scatter._comm_rev, MPI_COMM_NULL))
+  {
+  }
+
+  // Copy assignment (deleted)
+  MergedScatter& operator=(const MergedScatter&) = delete;
+
+  // Move assignment (deleted)
+  MergedScatter& operator=(MergedScatter&&) = delete;
+
+  /// Destructor
+  ~MergedScatter()
+  {
+    if (_comm_fwd != MPI_COMM_NULL)
+      MPI_Comm_free(&_comm_fwd);
+    if (_comm_rev != MPI_COMM_NULL)
+      MPI_Comm_free(&_comm_rev);
+  }
+
+  /// Scatter the owned data of the vectors to their ghost positions,
+  /// with one message per neighbor rank for the whole set
+  /// @note Collective MPI operation
+  /// @param[in,out] x Vectors to update, matching the layouts the plan
+  /// was built with
+  template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+  void
+  scatter_fwd(const std::vector<std::reference_wrapper<Vector<T, Allocator>>>&
+                  x) const
+  {
+    check_layouts(x);
+
+    // Pack the owned shared entries of all vectors, ordered by
+    // destination rank
+    std::vector<const T*> data(_maps.size());
+    for (std::size_t m = 0; m < _maps.size(); ++m)
+      data[m] = x[m].get().array().data();
+    std::vector<T> send_buffer(_send_displs.back());
+    std::size_t offset = 0;
+    for (auto [m, idx] : _send_plan)
+    {
+      const int bs = _maps[m].second;
+      std::copy_n(data[m] + bs * idx, bs,
+                  std::next(send_buffer.begin(), offset));
+      offset += bs;
+    }
+
+    common::telemetry::emit(common::telemetry::Channel::scatter_forward,
+                            send_buffer.size(),
+                            double(sizeof(T)) * send_buffer.size());
+
+    std::vector<T> recv_buffer(_recv_displs.back());
+    MPI_Neighbor_alltoallv(send_buffer.data(), _send_sizes.data(),
+                           _send_displs.data(), dolfinx::MPI::mpi_type<T>(),
+                           recv_buffer.data(), _recv_sizes.data(),
+                           _recv_displs.data(), dolfinx::MPI::mpi_type<T>(),
+                           _comm_fwd);
+
+    // Unpack into the ghost entries of each vector
+    std::vector<T*> wdata(_maps.size());
+    for (std::size_t m = 0; m < _maps.size(); ++m)
+      wdata[m] = x[m].get().mutable_array().data();
+    offset = 0;
+    for (auto [m, g] : _recv_plan)
+    {
+      const int bs = _maps[m].second;
+      const std::int32_t pos = _maps[m].first->size_local() + g;
+      std::copy_n(std::next(recv_buffer.cbegin(), offset), bs,
+                  wdata[m] + bs * pos);
+      offset += bs;
+    }
+  }
+
+  /// Scatter the ghost data of the vectors to their owners, with one
+  /// message per neighbor rank for the whole set
+  /// @note Collective MPI operation
+  /// @param[in,out] x Vectors to update, matching the layouts the plan
+  /// was built with
+  /// @param[in] op The operation applied to received values (insert,
+  /// add, min or max). The min and max modes require ordered (real)
+  /// data.
+  template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+  void
+  scatter_rev(const std::vector<std::reference_wrapper<Vector<T, Allocator>>>&
+                  x,
+              common::IndexMap::Mode op) const
+  {
+    check_layouts(x);
+
+    // Pack the ghost entries of all vectors, ordered by owning rank
+    std::vector<const T*> data(_maps.size());
+    for (std::size_t m = 0; m < _maps.size(); ++m)
+      data[m] = x[m].get().array().data();
+    std::vector<T> send_buffer(_recv_displs.back());
+    std::size_t offset = 0;
+    for (auto [m, g] : _recv_plan)
+    {
+      const int bs = _maps[m].second;
+      const std::int32_t pos = _maps[m].first->size_local() + g;
+      std::copy_n(data[m] + bs * pos, bs,
+                  std::next(send_buffer.begin(), offset));
+      offset += bs;
+    }
+
+    common::telemetry::emit(common::telemetry::Channel::scatter_reverse,
+                            send_buffer.size(),
+                            double(sizeof(T)) * send_buffer.size());
+
+    std::vector<T> recv_buffer(_send_displs.back());
+    MPI_Neighbor_alltoallv(send_buffer.data(), _recv_sizes.data(),
+                           _recv_displs.data(), dolfinx::MPI::mpi_type<T>(),
+                           recv_buffer.data(), _send_sizes.data(),
+                           _send_displs.data(), dolfinx::MPI::mpi_type<T>(),
+                           _comm_rev);
+
+    // Copy/accumulate into the owned part of each vector
+    std::vector<T*> wdata(_maps.size());
+    for (std::size_t m = 0; m < _maps.size(); ++m)
+      wdata[m] = x[m].get().mutable_array().data();
+    offset = 0;
+    switch (op)
+    {
+    case common::IndexMap::Mode::insert:
+      for (auto [m, idx] : _send_plan)
+      {
+        const int bs = _maps[m].second;
+        std::copy_n(std::next(recv_buffer.cbegin(), offset), bs,
+                    wdata[m] + bs * idx);
+        offset += bs;
+      }
+      break;
+    case common::IndexMap::Mode::add:
+      for (auto [m, idx] : _send_plan)
+      {
+        const int bs = _maps[m].second;
+        for (int k = 0; k < bs; ++k)
+          wdata[m][bs * idx + k] += recv_buffer[offset + k];
+        offset += bs;
+      }
+      break;
+    case common::IndexMap::Mode::min:
+      if constexpr (std::is_arithmetic<T>::value)
+      {
+        for (auto [m, idx] : _send_plan)
+        {
+          const int bs = _maps[m].second;
+          for (int k = 0; k < bs; ++k)
+          {
+            T& u = wdata[m][bs * idx + k];
+            u = std::min(u, recv_buffer[offset + k]);
+          }
+          offset += bs;
+        }
+      }
+      else
+        throw std::runtime_error("Mode::min requires ordered data.");
+      break;
+    case common::IndexMap::Mode::max:
+      if constexpr (std::is_arithmetic<T>::value)
+      {
+        for (auto [m, idx] : _send_plan)
+        {
+          const int bs = _maps[m].second;
+          for (int k = 0; k < bs; ++k)
+          {
+            T& u = wdata[m][bs * idx + k];
+            u = std::max(u, recv_buffer[offset + k]);
+          }
+          offset += bs;
+        }
+      }
+      else
+        throw std::runtime_error("Mode::max requires ordered data.");
+      break;
+    }
+  }
+
+private:
+  // Check that the vectors match the layouts the plan was built with
+  template <typename T, class Allocator>
+  void check_layouts(
+      const std::vector<std::reference_wrapper<Vector<T, Allocator>>>& x)
+      const
+  {
+    if (x.size() != _maps.size())
+      throw std::runtime_error("Wrong number of vectors for the plan");
+    for (std::size_t m = 0; m < _maps.size(); ++m)
+    {
+      const Vector<T, Allocator>& xm = x[m];
+      if (xm.map() != _maps[m].first or xm.bs() != _maps[m].second)
+        throw std::runtime_error("Vector layout does not match the plan");
+    }
+  }
+
+  // (index map, block size) of each vector in the set
+  std::vector<std::pair<std::shared_ptr<const common::IndexMap>, int>> _maps;
+
+  // Destination (ghosting) ranks, sorted, and the per-rank message
+  // sizes/offsets in scalars
+  std::vector<int> _dest_ranks;
+  std::vector<int> _send_sizes, _send_displs;
+
+  // Packing order of the send buffer: (vector, owned block index)
+  std::vector<std::array<std::int32_t, 2>> _send_plan;
+
+  // Source (owning) ranks, sorted, and the per-rank message
+  // sizes/offsets in scalars
+  std::vector<int> _src_ranks;
+  std::vector<int> _recv_sizes, _recv_displs;
+
+  // Unpacking order of the receive buffer: (vector, ghost index)
+  std::vector<std::array<std::int32_t, 2>> _recv_plan;
+
+  // Merged neighborhood communicators (owner-to-ghost and
+  // ghost-to-owner)
+  MPI_Comm _comm_fwd = MPI_COMM_NULL;
+  MPI_Comm _comm_rev = MPI_COMM_NULL;
+};
+
+} // namespace dolfinx::la
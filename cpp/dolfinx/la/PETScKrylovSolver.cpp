@@ -9,20 +9,44 @@
 #include "PETScOptions.h"
 #include "VectorSpaceBasis.h"
 #include "utils.h"
+#include <dolfinx/common/Telemetry.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/subsystem.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// KSP monitor publishing per-iteration residual norms to the
+// telemetry sink
+PetscErrorCode telemetry_monitor(KSP, PetscInt it, PetscReal rnorm, void*)
+{
+  dolfinx::common::telemetry::emit(
+      dolfinx::common::telemetry::Channel::krylov_residual, it, rnorm);
+  return 0;
+}
+} // namespace
 
 using namespace dolfinx::la;
 
 //-----------------------------------------------------------------------------
 PETScKrylovSolver::PETScKrylovSolver(MPI_Comm comm) : _ksp(nullptr)
 {
+  dolfinx::common::subsystem::ensure_petsc_initialized();
   PetscErrorCode ierr;
 
   // Create PETSc KSP object
   ierr = KSPCreate(comm, &_ksp);
   if (ierr != 0)
     petsc_error(ierr, __FILE__, "KSPCreate");
+
+  // Stream per-iteration residuals to the telemetry sink. The monitor
+  // is a no-op (one atomic load) when no sink is attached.
+  ierr = KSPMonitorSet(_ksp, telemetry_monitor, nullptr, nullptr);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "KSPMonitorSet");
 }
 //-----------------------------------------------------------------------------
 PETScKrylovSolver::PETScKrylovSolver(KSP ksp, bool inc_ref_count) : _ksp(ksp)
@@ -37,13 +61,23 @@ PETScKrylovSolver::PETScKrylovSolver(KSP ksp, bool inc_ref_count) : _ksp(ksp)
 }
 //-----------------------------------------------------------------------------
 PETScKrylovSolver::PETScKrylovSolver(PETScKrylovSolver&& solver)
-    : _ksp(std::exchange(solver._ksp, nullptr))
+    : _ksp(std::exchange(solver._ksp, nullptr)),
+      _extrapolation_order(solver._extrapolation_order),
+      _history(std::move(solver._history)), _max_basis(solver._max_basis),
+      _basis(std::move(solver._basis)),
+      _basis_Aw(std::move(solver._basis_Aw))
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
 PETScKrylovSolver::~PETScKrylovSolver()
 {
+  for (Vec v : _history)
+    VecDestroy(&v);
+  for (Vec v : _basis)
+    VecDestroy(&v);
+  for (Vec v : _basis_Aw)
+    VecDestroy(&v);
   if (_ksp)
     KSPDestroy(&_ksp);
 }
@@ -51,6 +85,11 @@ PETScKrylovSolver::~PETScKrylovSolver()
 PETScKrylovSolver& PETScKrylovSolver::operator=(PETScKrylovSolver&& solver)
 {
   std::swap(_ksp, solver._ksp);
+  std::swap(_extrapolation_order, solver._extrapolation_order);
+  std::swap(_history, solver._history);
+  std::swap(_max_basis, solver._max_basis);
+  std::swap(_basis, solver._basis);
+  std::swap(_basis_Aw, solver._basis_Aw);
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -61,11 +100,87 @@ void PETScKrylovSolver::set_operators(const Mat A, const Mat P)
   assert(A);
   assert(_ksp);
   PetscErrorCode ierr;
+
+  // If the handles are the operators already attached to the solver,
+  // leave the KSP untouched: the matrix values may have been updated
+  // in place and PETSc will refresh the numeric factorization of the
+  // preconditioner on the next solve while re-using the symbolic
+  // factorization for the unchanged pattern.
+  PetscBool amat_set = PETSC_FALSE, pmat_set = PETSC_FALSE;
+  ierr = KSPGetOperatorsSet(_ksp, &amat_set, &pmat_set);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "KSPGetOperatorsSet");
+  if (amat_set == PETSC_TRUE and pmat_set == PETSC_TRUE)
+  {
+    Mat A0 = nullptr, P0 = nullptr;
+    ierr = KSPGetOperators(_ksp, &A0, &P0);
+    if (ierr != 0)
+      petsc_error(ierr, __FILE__, "KSPGetOperators");
+    if (A0 == A and P0 == P)
+      return;
+  }
+
+  // A change of operator invalidates the retained deflation basis
+  for (Vec v : _basis)
+    VecDestroy(&v);
+  for (Vec v : _basis_Aw)
+    VecDestroy(&v);
+  _basis.clear();
+  _basis_Aw.clear();
+
   ierr = KSPSetOperators(_ksp, A, P);
   if (ierr != 0)
     petsc_error(ierr, __FILE__, "KSPSetOperators");
 }
 //-----------------------------------------------------------------------------
+void PETScKrylovSolver::set_reuse_preconditioner(ReusePolicy policy,
+                                                int interval)
+{
+  assert(_ksp);
+  if (policy == ReusePolicy::periodic and interval < 1)
+  {
+    throw std::runtime_error(
+        "Preconditioner refresh interval must be at least 1.");
+  }
+
+  _reuse_policy = policy;
+  _refresh_interval = interval;
+  _num_solves = 0;
+
+  const PetscBool reuse
+      = policy == ReusePolicy::rebuild ? PETSC_FALSE : PETSC_TRUE;
+  PetscErrorCode ierr = KSPSetReusePreconditioner(_ksp, reuse);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "KSPSetReusePreconditioner");
+}
+//-----------------------------------------------------------------------------
+void PETScKrylovSolver::set_guess_extrapolation(int order)
+{
+  _extrapolation_order = order;
+  while (int(_history.size()) > order + 1)
+  {
+    VecDestroy(&_history.front());
+    _history.erase(_history.begin());
+  }
+}
+//-----------------------------------------------------------------------------
+void PETScKrylovSolver::set_recycling(int max_basis)
+{
+  if (max_basis < 0)
+  {
+    throw std::runtime_error(
+        "Number of retained Krylov directions cannot be negative.");
+  }
+  _max_basis = max_basis;
+  while (int(_basis.size()) > max_basis)
+  {
+    VecDestroy(&_basis.front());
+    VecDestroy(&_basis_Aw.front());
+    _basis.erase(_basis.begin());
+    _basis_Aw.erase(_basis_Aw.begin());
+  }
+}
+//-----------------------------------------------------------------------------
 int PETScKrylovSolver::solve(Vec x, const Vec b, bool transpose) const
 {
   common::Timer timer("PETSc Krylov solver");
@@ -97,6 +212,75 @@ int PETScKrylovSolver::solve(Vec x, const Vec b, bool transpose) const
   // Solve linear system
   LOG(INFO) << "PETSc Krylov solver starting to solve system.";
 
+  // Time-sequence acceleration: extrapolate the initial guess from
+  // the solutions of previous solves and deflate the system against
+  // the retained A-conjugate directions
+  const bool extrapolate
+      = !transpose and _extrapolation_order >= 0 and !_history.empty();
+  const bool deflate = !transpose and !_basis.empty();
+  Vec x0 = nullptr;
+  if (extrapolate)
+  {
+    // Polynomial extrapolation x = sum_j c_j x_{n-j} with the
+    // coefficients c_j = (-1)^j binom(k+1, j+1) of the degree-k
+    // extrapolant through the last k+1 solutions
+    const int k = std::min(_extrapolation_order, int(_history.size()) - 1);
+    std::vector<PetscScalar> c(k + 1);
+    std::vector<Vec> xs(k + 1);
+    PetscScalar binom = k + 1;
+    for (int j = 0; j <= k; ++j)
+    {
+      c[j] = (j % 2 == 0) ? binom : -binom;
+      binom *= PetscScalar(k - j) / PetscScalar(j + 2);
+      xs[j] = _history[_history.size() - 1 - j];
+    }
+    VecZeroEntries(x);
+    VecMAXPY(x, k + 1, c.data(), xs.data());
+  }
+  else if (deflate)
+    VecZeroEntries(x);
+  if (deflate)
+  {
+    // Galerkin projection of the residual onto the retained subspace:
+    // x += sum_i (w_i . r) w_i, with the coefficients gathered in one
+    // batched inner product
+    Vec r = nullptr;
+    VecDuplicate(b, &r);
+    if (extrapolate)
+    {
+      MatMult(_A, x, r);
+      VecAYPX(r, -1.0, b);
+    }
+    else
+      VecCopy(b, r);
+    const int nb = int(_basis.size());
+    std::vector<PetscScalar> coeff(nb);
+    VecMDot(r, nb, _basis.data(), coeff.data());
+    VecMAXPY(x, nb, coeff.data(), _basis.data());
+    VecDestroy(&r);
+
+    // Keep the projected guess to distill the new direction after the
+    // solve
+    VecDuplicate(x, &x0);
+    VecCopy(x, x0);
+  }
+  if (extrapolate or deflate)
+  {
+    ierr = KSPSetInitialGuessNonzero(_ksp, PETSC_TRUE);
+    if (ierr != 0)
+      petsc_error(ierr, __FILE__, "KSPSetInitialGuessNonzero");
+  }
+
+  // Force a preconditioner rebuild on this solve if a periodic
+  // refresh is due
+  if (_reuse_policy == ReusePolicy::periodic
+      and _num_solves % _refresh_interval == 0)
+  {
+    ierr = KSPSetReusePreconditioner(_ksp, PETSC_FALSE);
+    if (ierr != 0)
+      petsc_error(ierr, __FILE__, "KSPSetReusePreconditioner");
+  }
+
   // Solve system
   if (!transpose)
   {
@@ -111,6 +295,49 @@ int PETScKrylovSolver::solve(Vec x, const Vec b, bool transpose) const
       petsc_error(ierr, __FILE__, "KSPSolve");
   }
 
+  // Re-instate re-use after a periodic refresh
+  if (_reuse_policy == ReusePolicy::periodic)
+  {
+    ierr = KSPSetReusePreconditioner(_ksp, PETSC_TRUE);
+    if (ierr != 0)
+      petsc_error(ierr, __FILE__, "KSPSetReusePreconditioner");
+  }
+  ++_num_solves;
+
+  // With re-use until divergence, rebuild the preconditioner and
+  // repeat the solve if the iteration diverged with the re-used
+  // preconditioner
+  if (_reuse_policy == ReusePolicy::on_divergence)
+  {
+    KSPConvergedReason reuse_reason;
+    ierr = KSPGetConvergedReason(_ksp, &reuse_reason);
+    if (ierr != 0)
+      petsc_error(ierr, __FILE__, "KSPGetConvergedReason");
+    if (reuse_reason < 0)
+    {
+      LOG(INFO) << "Krylov solve diverged with re-used preconditioner. "
+                   "Rebuilding preconditioner and re-solving.";
+      ierr = KSPSetReusePreconditioner(_ksp, PETSC_FALSE);
+      if (ierr != 0)
+        petsc_error(ierr, __FILE__, "KSPSetReusePreconditioner");
+      if (!transpose)
+      {
+        ierr = KSPSolve(_ksp, b, x);
+        if (ierr != 0)
+          petsc_error(ierr, __FILE__, "KSPSolve");
+      }
+      else
+      {
+        ierr = KSPSolveTranspose(_ksp, b, x);
+        if (ierr != 0)
+          petsc_error(ierr, __FILE__, "KSPSolve");
+      }
+      ierr = KSPSetReusePreconditioner(_ksp, PETSC_TRUE);
+      if (ierr != 0)
+        petsc_error(ierr, __FILE__, "KSPSetReusePreconditioner");
+    }
+  }
+
   // FIXME: Remove ghost updating?
   // Update ghost values in solution vector
   Vec xg;
@@ -123,6 +350,70 @@ int PETScKrylovSolver::solve(Vec x, const Vec b, bool transpose) const
     VecGhostUpdateEnd(x, INSERT_VALUES, SCATTER_FORWARD);
   }
 
+  // Update the extrapolation history with this solution, recycling
+  // the oldest slot once the history is full
+  if (!transpose and _extrapolation_order >= 0)
+  {
+    Vec xc = nullptr;
+    if (int(_history.size()) == _extrapolation_order + 1)
+    {
+      xc = _history.front();
+      _history.erase(_history.begin());
+    }
+    else
+      VecDuplicate(x, &xc);
+    VecCopy(x, xc);
+    _history.push_back(xc);
+  }
+
+  // Distill the direction the Krylov iteration added on top of the
+  // projected guess, A-orthonormalize it against the retained basis
+  // and append it, discarding the oldest direction when the basis is
+  // full
+  if (!transpose and _max_basis > 0)
+  {
+    Vec w = nullptr, z = nullptr;
+    VecDuplicate(x, &w);
+    VecCopy(x, w);
+    if (x0)
+      VecAXPY(w, -1.0, x0);
+    VecDuplicate(b, &z);
+    MatMult(_A, w, z);
+    if (const int nb = int(_basis.size()); nb > 0)
+    {
+      std::vector<PetscScalar> h(nb);
+      VecMDot(z, nb, _basis.data(), h.data());
+      for (PetscScalar& c : h)
+        c = -c;
+      VecMAXPY(w, nb, h.data(), _basis.data());
+      VecMAXPY(z, nb, h.data(), _basis_Aw.data());
+    }
+    PetscScalar nrm2(0);
+    VecDot(w, z, &nrm2);
+    const PetscReal nrm = std::sqrt(std::abs(nrm2));
+    if (nrm > 0.0)
+    {
+      VecScale(w, 1.0 / nrm);
+      VecScale(z, 1.0 / nrm);
+      if (int(_basis.size()) == _max_basis)
+      {
+        VecDestroy(&_basis.front());
+        VecDestroy(&_basis_Aw.front());
+        _basis.erase(_basis.begin());
+        _basis_Aw.erase(_basis_Aw.begin());
+      }
+      _basis.push_back(w);
+      _basis_Aw.push_back(z);
+    }
+    else
+    {
+      VecDestroy(&w);
+      VecDestroy(&z);
+    }
+  }
+  if (x0)
+    VecDestroy(&x0);
+
   // Get the number of iterations
   PetscInt num_iterations = 0;
   ierr = KSPGetIterationNumber(_ksp, &num_iterations);
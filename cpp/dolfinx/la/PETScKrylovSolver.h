@@ -11,6 +11,7 @@
 #include <petscmat.h>
 #include <petscvec.h>
 #include <string>
+#include <vector>
 
 namespace dolfinx::fem
 {
@@ -26,6 +27,17 @@ namespace dolfinx::la
 class PETScKrylovSolver
 {
 public:
+  /// Preconditioner re-use policy applied across repeated solves
+  enum class ReusePolicy
+  {
+    rebuild,      ///< Rebuild the preconditioner at every solve (PETSc
+                  ///< default)
+    freeze,       ///< Build the preconditioner once and re-use it
+    periodic,     ///< Rebuild the preconditioner every n solves
+    on_divergence ///< Re-use the preconditioner until a solve
+                  ///< diverges, then rebuild it and repeat the solve
+  };
+
   /// Create Krylov solver for a particular method and named
   /// preconditioner
   explicit PETScKrylovSolver(MPI_Comm comm);
@@ -54,8 +66,50 @@ public:
   void set_operator(const Mat A);
 
   /// Set operator and preconditioner matrix (Mat)
+  ///
+  /// If the handles are the matrices already attached to the solver
+  /// (i.e. only the matrix values have changed), the KSP is left
+  /// untouched and PETSc re-uses the symbolic factorization of the
+  /// preconditioner, refreshing only the numeric factorization on the
+  /// next solve.
   void set_operators(const Mat A, const Mat P);
 
+  /// Set the preconditioner re-use policy. With
+  /// ReusePolicy::rebuild (the default) the preconditioner is rebuilt
+  /// at every solve. The other policies keep the preconditioner set up
+  /// in an earlier solve, which is typically much cheaper when the
+  /// operator changes little between solves.
+  /// @param[in] policy The re-use policy
+  /// @param[in] interval Number of solves between preconditioner
+  ///   rebuilds. Used by ReusePolicy::periodic only.
+  void set_reuse_preconditioner(ReusePolicy policy, int interval = 1);
+
+  /// Use polynomial extrapolation of the solutions of previous calls
+  /// to solve() as the initial guess of the next solve. Intended for
+  /// time-stepping loops, where successive solutions differ slowly:
+  /// the Krylov iteration then only has to resolve the change from
+  /// the extrapolated guess. The solver keeps copies of the last
+  /// `order + 1` solutions and marks the guess as nonzero on the KSP.
+  /// @param[in] order Extrapolation order: 0 re-uses the previous
+  ///   solution, 1 extrapolates linearly, 2 quadratically. Pass -1 to
+  ///   disable (the default) and release the stored history.
+  void set_guess_extrapolation(int order);
+
+  /// Retain a basis of A-conjugate directions distilled from the
+  /// solutions of previous calls to solve() and deflate each new
+  /// system against it: the solution component in the retained
+  /// subspace is recovered by a Galerkin projection (one batched
+  /// inner product) before the Krylov iteration starts, which then
+  /// only has to resolve the remainder. Composes with guess
+  /// extrapolation, where the projection is applied to the residual
+  /// of the extrapolated guess. Assumes a symmetric positive-definite
+  /// operator that does not change between solves; the basis is
+  /// released when new operator handles are set. When the basis is
+  /// full the oldest direction is discarded.
+  /// @param[in] max_basis Maximum number of retained directions. Pass
+  ///   0 to disable (the default) and release the stored basis.
+  void set_recycling(int max_basis);
+
   /// Solve linear system Ax = b and return number of iterations (A^t x
   /// = b if transpose is true)
   int solve(Vec x, const Vec b, bool transpose = false) const;
@@ -83,5 +137,28 @@ public:
 private:
   // PETSc solver pointer
   KSP _ksp;
+
+  // Preconditioner re-use policy
+  ReusePolicy _reuse_policy = ReusePolicy::rebuild;
+
+  // Number of solves between rebuilds for ReusePolicy::periodic
+  int _refresh_interval = 1;
+
+  // Number of calls to solve() since the policy was set
+  mutable int _num_solves = 0;
+
+  // Order of initial-guess extrapolation (-1 disables)
+  int _extrapolation_order = -1;
+
+  // Solutions of previous solves for guess extrapolation, most recent
+  // last
+  mutable std::vector<Vec> _history;
+
+  // Maximum number of retained deflation directions (0 disables)
+  int _max_basis = 0;
+
+  // Retained A-conjugate directions w_i (normalized so that
+  // w_i^T A w_j = delta_ij) and their images A w_i
+  mutable std::vector<Vec> _basis, _basis_Aw;
 };
 } // namespace dolfinx::la
@@ -6,6 +6,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "PETScMatrix.h"
+#include "MatrixCSR.h"
 #include "PETScVector.h"
 #include "VectorSpaceBasis.h"
 #include "utils.h"
@@ -13,8 +14,13 @@
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/subsystem.h>
+#include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/la/SparsityPattern.h>
+#include <algorithm>
+#include <cassert>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 
 using namespace dolfinx;
@@ -25,6 +31,7 @@ Mat la::create_petsc_matrix(MPI_Comm comm,
                             const dolfinx::la::SparsityPattern& sp,
                             const std::string& type)
 {
+  common::subsystem::ensure_petsc_initialized();
   PetscErrorCode ierr;
   Mat A;
   ierr = MatCreate(comm, &A);
@@ -35,8 +42,19 @@ Mat la::create_petsc_matrix(MPI_Comm comm,
   std::array maps = {sp.index_map(0), sp.index_map(1)};
   const std::array bs = {sp.block_size(0), sp.block_size(1)};
 
+  // Find a common block size across rows/columns
+  const int _bs = (bs[0] == bs[1] ? bs[0] : 1);
+
   if (!type.empty())
     MatSetType(A, type.c_str());
+  else if (_bs > 1)
+  {
+    // The pattern is genuinely blocked: default to BAIJ so the bs x bs
+    // blocked kernels are used for MatMult and factorisations. A
+    // -mat_type given in the options database (applied below by
+    // MatSetFromOptions) still overrides this.
+    MatSetType(A, MATBAIJ);
+  }
 
   // Get global and local dimensions
   const std::int64_t M = bs[0] * maps[0]->size_global();
@@ -61,9 +79,6 @@ Mat la::create_petsc_matrix(MPI_Comm comm,
   if (ierr != 0)
     petsc_error(ierr, __FILE__, "MatSetFromOptions");
 
-  // Find a common block size across rows/columns
-  const int _bs = (bs[0] == bs[1] ? bs[0] : 1);
-
   // Build data to initialise sparsity pattern (modify for block size)
   std::vector<PetscInt> _nnz_diag, _nnz_offdiag;
   if (bs[0] == bs[1])
@@ -152,9 +167,126 @@ Mat la::create_petsc_matrix(MPI_Comm comm,
   if (ierr != 0)
     petsc_error(ierr, __FILE__, "MatSetOption");
 
+  // For symmetric (SBAIJ) storage only the upper triangle is kept.
+  // Ignore insertions into the lower triangle so that the assemblers
+  // can add complete (symmetric) element tensors unchanged.
+  MatType mat_type;
+  ierr = MatGetType(A, &mat_type);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "MatGetType");
+  if (std::string(mat_type).find("sbaij") != std::string::npos)
+  {
+    ierr = MatSetOption(A, MAT_IGNORE_LOWER_TRIANGULAR, PETSC_TRUE);
+    if (ierr != 0)
+      petsc_error(ierr, __FILE__, "MatSetOption");
+  }
+
   return A;
 }
 //-----------------------------------------------------------------------------
+Mat la::create_petsc_matrix(MPI_Comm comm, la::MatrixCSR<PetscScalar>& A)
+{
+  common::subsystem::ensure_petsc_initialized();
+  PetscErrorCode ierr;
+  std::shared_ptr<const common::IndexMap> map0 = A.index_map(0);
+  std::shared_ptr<const common::IndexMap> map1 = A.index_map(1);
+  assert(map0);
+  assert(map1);
+  const std::int32_t m = map0->size_local();
+  const std::int32_t n = map1->size_local();
+  const std::int64_t M = map0->size_global();
+  const std::int64_t N = map1->size_global();
+
+#ifndef PETSC_USE_64BIT_INDICES
+  // PETSc and MatrixCSR index types match: wrap the CSR arrays of the
+  // diagonal and off-diagonal blocks directly. PETSc does not copy the
+  // arrays, so A must outlive the returned Mat. The ghost column array
+  // is allocated with PetscMalloc as the Mat takes ownership of it.
+  static_assert(sizeof(PetscInt) == sizeof(std::int32_t));
+  PetscInt* garray = nullptr;
+  ierr = PetscMalloc1(A.column_ghosts().size(), &garray);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "PetscMalloc1");
+  std::copy(A.column_ghosts().begin(), A.column_ghosts().end(), garray);
+
+  Mat mat;
+  ierr = MatCreateMPIAIJWithSplitArrays(
+      comm, m, n, M, N,
+      const_cast<PetscInt*>(
+          reinterpret_cast<const PetscInt*>(A.row_ptr().data())),
+      const_cast<PetscInt*>(
+          reinterpret_cast<const PetscInt*>(A.cols().data())),
+      A.values().data(),
+      const_cast<PetscInt*>(
+          reinterpret_cast<const PetscInt*>(A.off_diag_row_ptr().data())),
+      const_cast<PetscInt*>(
+          reinterpret_cast<const PetscInt*>(A.off_diag_cols().data())),
+      A.off_diag_values().data(), garray, &mat);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "MatCreateMPIAIJWithSplitArrays");
+
+  return mat;
+#else
+  // Index arrays must be widened to 64-bit PETSc indices, so the
+  // matrix is copied row-by-row
+  const xtl::span<const std::int32_t> row_ptr = A.row_ptr();
+  const xtl::span<const std::int32_t> cols = A.cols();
+  const xtl::span<const PetscScalar> values = A.values();
+  const xtl::span<const std::int32_t> row_ptr_off = A.off_diag_row_ptr();
+  const xtl::span<const std::int32_t> cols_off = A.off_diag_cols();
+  const xtl::span<const PetscScalar> values_off = A.off_diag_values();
+  const std::vector<std::int64_t>& col_ghosts = A.column_ghosts();
+
+  std::vector<PetscInt> nnz_diag(m), nnz_offdiag(m);
+  for (std::int32_t i = 0; i < m; ++i)
+  {
+    nnz_diag[i] = row_ptr[i + 1] - row_ptr[i];
+    nnz_offdiag[i] = row_ptr_off[i + 1] - row_ptr_off[i];
+  }
+
+  Mat mat;
+  ierr = MatCreateAIJ(comm, m, n, M, N, 0, nnz_diag.data(), 0,
+                      nnz_offdiag.data(), &mat);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "MatCreateAIJ");
+
+  const std::int64_t row0 = map0->local_range()[0];
+  const std::int64_t col0 = map1->local_range()[0];
+  std::vector<PetscInt> columns;
+  std::vector<PetscScalar> row_values;
+  for (std::int32_t i = 0; i < m; ++i)
+  {
+    columns.clear();
+    row_values.clear();
+    for (std::int32_t k = row_ptr[i]; k < row_ptr[i + 1]; ++k)
+    {
+      columns.push_back(col0 + cols[k]);
+      row_values.push_back(values[k]);
+    }
+    for (std::int32_t k = row_ptr_off[i]; k < row_ptr_off[i + 1]; ++k)
+    {
+      columns.push_back(col_ghosts[cols_off[k]]);
+      row_values.push_back(values_off[k]);
+    }
+
+    const PetscInt row = row0 + i;
+    ierr = MatSetValues(mat, 1, &row, columns.size(), columns.data(),
+                        row_values.data(), INSERT_VALUES);
+    if (ierr != 0)
+      petsc_error(ierr, __FILE__, "MatSetValues");
+  }
+
+  ierr = MatAssemblyBegin(mat, MAT_FINAL_ASSEMBLY);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "MatAssemblyBegin");
+  ierr = MatAssemblyEnd(mat, MAT_FINAL_ASSEMBLY);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "MatAssemblyEnd");
+
+  return mat;
+#endif
+}
+//-----------------------------------------------------------------------------
 MatNullSpace la::create_petsc_nullspace(MPI_Comm comm,
                                         const la::VectorSpaceBasis& nullspace)
 {
@@ -183,6 +315,259 @@ MatNullSpace la::create_petsc_nullspace(MPI_Comm comm,
 }
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
+MatrixInsertBuffer::MatrixInsertBuffer(Mat A, int capacity)
+    : _matA(A), _capacity(capacity)
+{
+  assert(capacity > 0);
+}
+//-----------------------------------------------------------------------------
+MatrixInsertBuffer::~MatrixInsertBuffer() { flush(); }
+//-----------------------------------------------------------------------------
+std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                  const std::int32_t*, const PetscScalar*)>
+MatrixInsertBuffer::add_fn()
+{
+  return [this](std::int32_t m, const std::int32_t* rows, std::int32_t n,
+                const std::int32_t* cols, const PetscScalar* vals) -> int
+  { return this->add(m, rows, n, cols, vals); };
+}
+//-----------------------------------------------------------------------------
+int MatrixInsertBuffer::add(std::int32_t m, const std::int32_t* rows,
+                            std::int32_t n, const std::int32_t* cols,
+                            const PetscScalar* vals)
+{
+  _rows.insert(_rows.end(), rows, rows + m);
+  _cols.insert(_cols.end(), cols, cols + n);
+  _vals.insert(_vals.end(), vals, vals + m * n);
+  _shapes.push_back({m, n});
+  if (++_count < _capacity)
+    return 0;
+  else
+    return flush();
+}
+//-----------------------------------------------------------------------------
+int MatrixInsertBuffer::flush()
+{
+  if (_count == 0)
+    return 0;
+
+  // Build sorted union of the buffered rows and columns
+  _union_rows.assign(_rows.begin(), _rows.end());
+  std::sort(_union_rows.begin(), _union_rows.end());
+  _union_rows.erase(std::unique(_union_rows.begin(), _union_rows.end()),
+                    _union_rows.end());
+  _union_cols.assign(_cols.begin(), _cols.end());
+  std::sort(_union_cols.begin(), _union_cols.end());
+  _union_cols.erase(std::unique(_union_cols.begin(), _union_cols.end()),
+                    _union_cols.end());
+
+  // Accumulate the element matrices into the dense union block
+  // (entries not covered by an element matrix remain zero, which is
+  // a no-op under ADD_VALUES)
+  const std::size_t num_cols = _union_cols.size();
+  _union_vals.assign(_union_rows.size() * num_cols, 0.0);
+  std::size_t r = 0, c = 0, v = 0;
+  for (const std::array<std::int32_t, 2>& shape : _shapes)
+  {
+    for (std::int32_t i = 0; i < shape[0]; ++i)
+    {
+      const std::size_t ri
+          = std::distance(_union_rows.begin(),
+                          std::lower_bound(_union_rows.begin(),
+                                           _union_rows.end(), _rows[r + i]));
+      for (std::int32_t j = 0; j < shape[1]; ++j)
+      {
+        const std::size_t cj
+            = std::distance(_union_cols.begin(),
+                            std::lower_bound(_union_cols.begin(),
+                                             _union_cols.end(), _cols[c + j]));
+        _union_vals[ri * num_cols + cj] += _vals[v + i * shape[1] + j];
+      }
+    }
+    r += shape[0];
+    c += shape[1];
+    v += shape[0] * shape[1];
+  }
+
+  const PetscErrorCode ierr = MatSetValuesLocal(
+      _matA, _union_rows.size(), _union_rows.data(), _union_cols.size(),
+      _union_cols.data(), _union_vals.data(), ADD_VALUES);
+#ifdef DEBUG
+  if (ierr != 0)
+    la::petsc_error(ierr, __FILE__, "MatSetValuesLocal");
+#endif
+
+  _rows.clear();
+  _cols.clear();
+  _vals.clear();
+  _shapes.clear();
+  _count = 0;
+
+  return ierr;
+}
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+GhostRowMatrixBuffer::GhostRowMatrixBuffer(Mat A, const SparsityPattern& sp)
+    : _matA(A), _index_maps({sp.index_map(0), sp.index_map(1)}),
+      _col_ghosts(sp.column_indices())
+{
+  if (sp.block_size(0) != 1 or sp.block_size(1) != 1)
+  {
+    throw std::runtime_error(
+        "GhostRowMatrixBuffer requires a sparsity pattern with block size 1.");
+  }
+
+  assert(_index_maps[0]);
+  assert(_index_maps[1]);
+
+  // Keep the global indices of the ghost columns only
+  _col_ghosts.erase(_col_ghosts.begin(),
+                    _col_ghosts.begin() + _index_maps[1]->size_local());
+
+  // Staging block for the ghost rows. Column indices in the pattern
+  // are sorted, which add() relies on.
+  const graph::AdjacencyList<std::int32_t>& ghost = sp.ghost_row_pattern();
+  _ghost_row_ptr.assign(ghost.offsets().begin(), ghost.offsets().end());
+  _ghost_cols.assign(ghost.array().begin(), ghost.array().end());
+  _ghost_data.assign(_ghost_cols.size(), 0);
+}
+//-----------------------------------------------------------------------------
+std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                  const std::int32_t*, const PetscScalar*)>
+GhostRowMatrixBuffer::add_fn()
+{
+  return [this](std::int32_t m, const std::int32_t* rows, std::int32_t n,
+                const std::int32_t* cols, const PetscScalar* vals) -> int
+  { return this->add(m, rows, n, cols, vals); };
+}
+//-----------------------------------------------------------------------------
+int GhostRowMatrixBuffer::add(std::int32_t m, const std::int32_t* rows,
+                              std::int32_t n, const std::int32_t* cols,
+                              const PetscScalar* vals)
+{
+  const std::int32_t num_owned = _index_maps[0]->size_local();
+#ifdef PETSC_USE_64BIT_INDICES
+  const std::vector<PetscInt> cache(cols, cols + n);
+  const PetscInt* _cols = cache.data();
+#else
+  const PetscInt* _cols = cols;
+#endif
+  for (std::int32_t i = 0; i < m; ++i)
+  {
+    const std::int32_t row = rows[i];
+    const PetscScalar* vals_row = vals + i * n;
+    if (row < num_owned)
+    {
+      const PetscInt _row = row;
+      const PetscErrorCode ierr = MatSetValuesLocal(_matA, 1, &_row, n, _cols,
+                                                    vals_row, ADD_VALUES);
+      if (ierr != 0)
+      {
+#ifdef DEBUG
+        la::petsc_error(ierr, __FILE__, "MatSetValuesLocal");
+#endif
+        return ierr;
+      }
+    }
+    else
+    {
+      const std::int32_t rg = row - num_owned;
+      for (std::int32_t j = 0; j < n; ++j)
+      {
+        const auto it = std::lower_bound(
+            std::next(_ghost_cols.begin(), _ghost_row_ptr[rg]),
+            std::next(_ghost_cols.begin(), _ghost_row_ptr[rg + 1]), cols[j]);
+        assert(it != std::next(_ghost_cols.begin(), _ghost_row_ptr[rg + 1])
+               and *it == cols[j]);
+        _ghost_data[std::distance(_ghost_cols.begin(), it)] += vals_row[j];
+      }
+    }
+  }
+  return 0;
+}
+//-----------------------------------------------------------------------------
+void GhostRowMatrixBuffer::finalize()
+{
+  const std::int32_t num_ghosts0 = _index_maps[0]->num_ghosts();
+  const std::vector<std::int64_t>& ghosts0 = _index_maps[0]->ghosts();
+  const std::vector<int> ghost_owners0 = _index_maps[0]->ghost_owner_rank();
+  const std::int32_t local_size1 = _index_maps[1]->size_local();
+  const std::array local_range1 = _index_maps[1]->local_range();
+
+  // Get ghost->owner communicator for rows
+  MPI_Comm comm = _index_maps[0]->comm(common::IndexMap::Direction::reverse);
+  const std::vector<int> dest_ranks = dolfinx::MPI::neighbors(comm)[1];
+
+  // Map ghost rows to their neighborhood rank and compute the data
+  // size for each destination
+  std::vector<int> ghost_to_neighbour_rank(num_ghosts0, -1);
+  std::vector<std::int32_t> data_per_proc(dest_ranks.size(), 0);
+  for (std::int32_t i = 0; i < num_ghosts0; ++i)
+  {
+    const auto it
+        = std::find(dest_ranks.begin(), dest_ranks.end(), ghost_owners0[i]);
+    assert(it != dest_ranks.end());
+    ghost_to_neighbour_rank[i] = std::distance(dest_ranks.begin(), it);
+    data_per_proc[ghost_to_neighbour_rank[i]]
+        += _ghost_row_ptr[i + 1] - _ghost_row_ptr[i];
+  }
+
+  // Compute send displacements
+  std::vector<std::int32_t> send_disp(dest_ranks.size() + 1, 0);
+  std::partial_sum(data_per_proc.begin(), data_per_proc.end(),
+                   std::next(send_disp.begin()));
+
+  // Pack (global row, global column) pairs and values for each staged
+  // entry, grouped by destination
+  std::vector<std::int32_t> insert_pos(send_disp.begin(),
+                                       std::prev(send_disp.end()));
+  std::vector<std::int64_t> index_send(2 * send_disp.back());
+  std::vector<PetscScalar> value_send(send_disp.back());
+  for (std::int32_t i = 0; i < num_ghosts0; ++i)
+  {
+    const int neighbour_rank = ghost_to_neighbour_rank[i];
+    for (std::int32_t k = _ghost_row_ptr[i]; k < _ghost_row_ptr[i + 1]; ++k)
+    {
+      const std::int32_t pos = insert_pos[neighbour_rank]++;
+      index_send[2 * pos] = ghosts0[i];
+      index_send[2 * pos + 1]
+          = _ghost_cols[k] < local_size1
+                ? _ghost_cols[k] + local_range1[0]
+                : _col_ghosts[_ghost_cols[k] - local_size1];
+      value_send[pos] = _ghost_data[k];
+    }
+  }
+
+  // Exchange indices and values with the row-owning processes
+  std::vector<std::int32_t> index_offsets(send_disp.size());
+  std::transform(send_disp.begin(), send_disp.end(), index_offsets.begin(),
+                 [](std::int32_t d) { return 2 * d; });
+  const graph::AdjacencyList<std::int64_t> index_recv
+      = MPI::neighbor_all_to_all(
+          comm, graph::AdjacencyList<std::int64_t>(std::move(index_send),
+                                                   std::move(index_offsets)));
+  const graph::AdjacencyList<PetscScalar> value_recv = MPI::neighbor_all_to_all(
+      comm, graph::AdjacencyList<PetscScalar>(std::move(value_send),
+                                              std::move(send_disp)));
+
+  // Add the received values to the owned rows of the matrix. The rows
+  // are owned here, so these insertions do not touch the stash.
+  const std::vector<std::int64_t>& index_data = index_recv.array();
+  const std::vector<PetscScalar>& value_data = value_recv.array();
+  for (std::size_t e = 0; e < value_data.size(); ++e)
+  {
+    const PetscInt row = index_data[2 * e];
+    const PetscInt col = index_data[2 * e + 1];
+    const PetscErrorCode ierr
+        = MatSetValues(_matA, 1, &row, 1, &col, &value_data[e], ADD_VALUES);
+    if (ierr != 0)
+      la::petsc_error(ierr, __FILE__, "MatSetValues");
+  }
+
+  // Ghost row contributions have been handed over
+  std::fill(_ghost_data.begin(), _ghost_data.end(), 0);
+}
+//-----------------------------------------------------------------------------
 std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                   const std::int32_t*, const PetscScalar*)>
 PETScMatrix::set_fn(Mat A, InsertMode mode)
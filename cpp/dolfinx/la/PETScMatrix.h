@@ -9,25 +9,180 @@
 
 #include "PETScOperator.h"
 #include "utils.h"
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <petscmat.h>
 #include <string>
+#include <vector>
+
+namespace dolfinx::common
+{
+class IndexMap;
+}
 
 namespace dolfinx::la
 {
+template <typename T>
+class MatrixCSR;
 class SparsityPattern;
 class VectorSpaceBasis;
 
 /// Create a PETSc Mat. Caller is responsible for destroying the
 /// returned object.
+///
+/// When the sparsity pattern has a common row/column block size greater
+/// than one and no type is passed, a blocked ("baij") matrix is created
+/// so the bs x bs blocked kernels are used. A `-mat_type` set in the
+/// PETSc options database overrides the default.
+///
+/// For symmetric operators a symmetric storage type ("sbaij") can be
+/// passed, halving matrix memory. The matrix is then configured to
+/// ignore insertions into the lower triangle, so the assemblers can
+/// add complete element tensors and only the upper triangle is
+/// stored. The sparsity pattern is used unchanged for preallocation,
+/// which over-reserves the lower-triangle entries of each row.
 Mat create_petsc_matrix(MPI_Comm comm, const SparsityPattern& sp,
                         const std::string& type = std::string());
 
+/// Create a PETSc MATMPIAIJ Mat that wraps the CSR arrays of a
+/// MatrixCSR for solving. Caller is responsible for destroying the
+/// returned object.
+///
+/// When PETSc is built with 32-bit indices the Mat references the
+/// matrix arrays directly (no copy), so `A` must be finalized and must
+/// outlive the returned Mat, and further modification of `A` requires
+/// re-finalizing before the Mat is used. With 64-bit PETSc indices the
+/// index arrays must be widened and the handoff copies the matrix.
+Mat create_petsc_matrix(MPI_Comm comm, MatrixCSR<PetscScalar>& A);
+
 /// Create PETSc MatNullSpace. Caller is responsible for destruction
 /// returned object.
 MatNullSpace create_petsc_nullspace(MPI_Comm comm,
                                     const VectorSpaceBasis& nullspace);
 
+/// Buffer for batched element-matrix insertion into a PETSc Mat.
+/// Element contributions are accumulated until the buffer holds
+/// `capacity` element matrices and are then flushed as a single
+/// MatSetValuesLocal call covering the union of the buffered rows and
+/// columns, with absent entries padded by zero. This amortises the
+/// MatSetValues call overhead, which is significant for small element
+/// matrices (e.g. P1 tetrahedra). The union stays small when cells are
+/// inserted in dofmap-locality order, as produced by the assemblers.
+///
+/// Only ADD_VALUES insertion is supported (zero padding and merging of
+/// duplicate entries rely on additive semantics). flush() must be
+/// called (or the buffer destroyed) before finalising assembly of the
+/// matrix.
+class MatrixInsertBuffer
+{
+public:
+  /// Create an insertion buffer for a matrix
+  /// @param[in] A The matrix to add values to
+  /// @param[in] capacity Number of element matrices to accumulate
+  /// before flushing
+  MatrixInsertBuffer(Mat A, int capacity = 16);
+
+  // Copying would duplicate pending insertions
+  MatrixInsertBuffer(const MatrixInsertBuffer&) = delete;
+  MatrixInsertBuffer& operator=(const MatrixInsertBuffer&) = delete;
+
+  /// Destructor. Flushes any pending values.
+  ~MatrixInsertBuffer();
+
+  /// Return an insertion function compatible with the assembly entry
+  /// points (same interface as PETScMatrix::set_fn). The function
+  /// references this buffer, which must outlive it.
+  std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                    const std::int32_t*, const PetscScalar*)>
+  add_fn();
+
+  /// Add an element matrix to the buffer, flushing if the buffer is
+  /// full
+  int add(std::int32_t m, const std::int32_t* rows, std::int32_t n,
+          const std::int32_t* cols, const PetscScalar* vals);
+
+  /// Flush buffered values to the matrix with a batched
+  /// MatSetValuesLocal call
+  int flush();
+
+private:
+  Mat _matA;
+  int _capacity;
+
+  // Number of buffered element matrices
+  int _count = 0;
+
+  // Flattened rows/cols/values of the buffered element matrices, with
+  // offsets per element
+  std::vector<PetscInt> _rows, _cols;
+  std::vector<PetscScalar> _vals;
+  std::vector<std::array<std::int32_t, 2>> _shapes;
+
+  // Scratch for the union insert
+  std::vector<PetscInt> _union_rows, _union_cols;
+  std::vector<PetscScalar> _union_vals;
+};
+
+/// Staging buffer that assembles ghost-row contributions into a PETSc
+/// Mat without PETSc's MatStash. Contributions to rows owned by this
+/// process are added to the matrix directly; contributions to ghost
+/// rows are accumulated in a CSR block preallocated from the ghost rows
+/// of the sparsity pattern and sent to the owning processes by a single
+/// neighborhood all-to-all in finalize(), where they are added to owned
+/// rows. All buffer and message sizes are known from the IndexMap, so
+/// no dynamic stash memory or rendezvous communication is needed and
+/// the subsequent MatAssemblyBegin/End finds an empty stash.
+///
+/// Only ADD_VALUES insertion with local indices is supported, and the
+/// sparsity pattern must have block size 1 (as for la::MatrixCSR).
+class GhostRowMatrixBuffer
+{
+public:
+  /// Create a ghost-row staging buffer for a matrix
+  /// @param[in] A The matrix to add values to
+  /// @param[in] sp The sparsity pattern the matrix was created from.
+  /// Must be assembled and have block size 1.
+  GhostRowMatrixBuffer(Mat A, const SparsityPattern& sp);
+
+  // Copying would duplicate pending contributions
+  GhostRowMatrixBuffer(const GhostRowMatrixBuffer&) = delete;
+  GhostRowMatrixBuffer& operator=(const GhostRowMatrixBuffer&) = delete;
+
+  /// Return an insertion function compatible with the assembly entry
+  /// points (same interface as PETScMatrix::set_fn with ADD_VALUES).
+  /// The function references this buffer, which must outlive it.
+  std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                    const std::int32_t*, const PetscScalar*)>
+  add_fn();
+
+  /// Add values using local indices. Owned rows go straight to the
+  /// matrix, ghost rows into the staging block.
+  int add(std::int32_t m, const std::int32_t* rows, std::int32_t n,
+          const std::int32_t* cols, const PetscScalar* vals);
+
+  /// Send the staged ghost row values to the owning processes, where
+  /// they are added to the matrix, and zero the staging block. Must be
+  /// called before finalising assembly of the matrix. Collective over
+  /// the ghost->owner neighborhood of the row IndexMap.
+  void finalize();
+
+private:
+  Mat _matA;
+
+  // Index maps for the row (0) and column (1) space
+  std::array<std::shared_ptr<const common::IndexMap>, 2> _index_maps;
+
+  // Staged ghost rows, CSR with the combined (owned then ghost) local
+  // column indexing of the sparsity pattern
+  std::vector<std::int32_t> _ghost_row_ptr, _ghost_cols;
+  std::vector<PetscScalar> _ghost_data;
+
+  // Global indices of the ghost columns
+  std::vector<std::int64_t> _col_ghosts;
+};
+
 /// It is a simple wrapper for a PETSc matrix pointer (Mat). Its main
 /// purpose is to assist memory management of PETSc Mat objects.
 ///
@@ -9,6 +9,7 @@
 #include "PETScVector.h"
 #include "utils.h"
 #include <boost/lexical_cast.hpp>
+#include <dolfinx/common/subsystem.h>
 #include <petscoptions.h>
 #include <string>
 
@@ -34,6 +35,7 @@ public:
     if (option[0] != '-')
       option = '-' + option;
 
+    common::subsystem::ensure_petsc_initialized();
     PetscErrorCode ierr;
     ierr
         = PetscOptionsSetValue(nullptr, option.c_str(),
@@ -11,6 +11,8 @@
 #include <cstddef>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/subsystem.h>
+#include <type_traits>
 
 using namespace dolfinx;
 using namespace dolfinx::la;
@@ -66,10 +68,24 @@ Vec la::create_ghosted_vector(const common::IndexMap& map, int bs,
 {
   const std::int32_t size_local = bs * map.size_local();
   const std::int64_t size_global = bs * map.size_global();
-  const std::vector<PetscInt> ghosts(map.ghosts().begin(), map.ghosts().end());
   Vec vec;
-  VecCreateGhostBlockWithArray(map.comm(), bs, size_local, size_global,
-                               ghosts.size(), ghosts.data(), x.data(), &vec);
+  if constexpr (std::is_same<PetscInt, std::int64_t>::value)
+  {
+    // PetscInt matches the IndexMap ghost index type, so the ghost
+    // block indices can be passed without a copy. The wrap is then
+    // fully zero-copy, which matters when vectors are re-wrapped in
+    // tight loops, e.g. every Newton iteration.
+    VecCreateGhostBlockWithArray(map.comm(), bs, size_local, size_global,
+                                 map.ghosts().size(), map.ghosts().data(),
+                                 x.data(), &vec);
+  }
+  else
+  {
+    const std::vector<PetscInt> ghosts(map.ghosts().begin(),
+                                       map.ghosts().end());
+    VecCreateGhostBlockWithArray(map.comm(), bs, size_local, size_global,
+                                 ghosts.size(), ghosts.data(), x.data(), &vec);
+  }
   return vec;
 }
 //-----------------------------------------------------------------------------
@@ -82,6 +98,7 @@ Vec la::create_petsc_vector(const dolfinx::common::IndexMap& map, int bs)
 Vec la::create_petsc_vector(MPI_Comm comm, std::array<std::int64_t, 2> range,
                             const std::vector<std::int64_t>& ghosts, int bs)
 {
+  common::subsystem::ensure_petsc_initialized();
   PetscErrorCode ierr;
 
   // Get local size
@@ -184,6 +201,31 @@ void la::scatter_local_vectors(
   VecGhostRestoreLocalForm(x, &x_local);
 }
 //-----------------------------------------------------------------------------
+std::vector<std::array<xtl::span<PetscScalar>, 2>> la::local_vector_views(
+    const xtl::span<PetscScalar>& x,
+    const std::vector<
+        std::pair<std::reference_wrapper<const common::IndexMap>, int>>& maps)
+{
+  // Ghost segments start after the owned segments of all fields
+  std::int32_t offset_ghost = 0;
+  for (auto& map : maps)
+    offset_ghost += map.first.get().size_local() * map.second;
+
+  std::vector<std::array<xtl::span<PetscScalar>, 2>> views;
+  std::int32_t offset = 0;
+  for (auto& map : maps)
+  {
+    const std::int32_t size_owned = map.first.get().size_local() * map.second;
+    const std::int32_t size_ghost = map.first.get().num_ghosts() * map.second;
+    views.push_back({x.subspan(offset, size_owned),
+                     x.subspan(offset_ghost, size_ghost)});
+    offset += size_owned;
+    offset_ghost += size_ghost;
+  }
+
+  return views;
+}
+//-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 PETScVector::PETScVector(const common::IndexMap& map, int bs)
     : _x(la::create_petsc_vector(map, bs))
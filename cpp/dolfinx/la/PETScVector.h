@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "Vector.h"
 #include "utils.h"
 #include <array>
 #include <cstdint>
@@ -32,6 +33,19 @@ namespace dolfinx::la
 Vec create_ghosted_vector(const common::IndexMap& map, int bs,
                           xtl::span<PetscScalar> x);
 
+/// Create a PETSc Vec that shares the data of a la::Vector, without
+/// copying. The la::Vector retains ownership of the data and must
+/// outlive the Vec; solves then operate in place on the vector's
+/// memory, whichever memory space its allocator placed it in. The
+/// caller is responsible for destroying the Vec.
+/// @param[in] x The vector to wrap
+/// @return A PETSc Vec object that shares the data of @p x
+template <class Allocator>
+Vec create_petsc_vector_wrap(Vector<PetscScalar, Allocator>& x)
+{
+  return create_ghosted_vector(*x.map(), x.bs(), x.mutable_array());
+}
+
 /// Print error message for PETSc calls that return an error
 void petsc_error(int error_code, std::string filename,
                  std::string petsc_function);
@@ -85,6 +99,24 @@ void scatter_local_vectors(
     const std::vector<
         std::pair<std::reference_wrapper<const common::IndexMap>, int>>& maps);
 
+/// In-place views of the blocks of a monolithic vector's local array.
+/// The local array of a ghosted block vector is laid out as [owned_0,
+/// ..., owned_n, ghost_0, ..., ghost_n]; for each field this returns
+/// the {owned, ghost} pair of spans into @p x. Reading and writing
+/// through the views accesses the block vector directly, so moving
+/// data between the block vector and per-field storage needs no
+/// copies, unlike get_local_vectors/scatter_local_vectors.
+///
+/// @param[in] x The local array of the block vector (including
+/// ghosts), e.g. obtained with VecGhostGetLocalForm and VecGetArray.
+/// The views are valid only while the array is held.
+/// @param[in] maps Pairs of (index map, block size) for each field
+/// @return For each field, spans of the owned and the ghost segments
+std::vector<std::array<xtl::span<PetscScalar>, 2>> local_vector_views(
+    const xtl::span<PetscScalar>& x,
+    const std::vector<
+        std::pair<std::reference_wrapper<const common::IndexMap>, int>>& maps);
+
 /// A simple wrapper for a PETSc vector pointer (Vec). Its main purpose
 /// is to assist with memory/lifetime management of PETSc Vec objects.
 ///
@@ -101,6 +133,21 @@ public:
   /// @param[in] bs the block size
   PETScVector(const common::IndexMap& map, int bs);
 
+  /// Create a vector that wraps the data of a la::Vector with zero
+  /// copies (see la::create_petsc_vector_wrap). The ghost region
+  /// follows the owned entries, matching the IndexMap layout, so data
+  /// moves in both directions without copying. The la::Vector retains
+  /// ownership of the data and must outlive this object.
+  ///
+  /// Collective
+  ///
+  /// @param[in] x The vector to wrap
+  template <class Allocator>
+  explicit PETScVector(Vector<PetscScalar, Allocator>& x)
+      : PETScVector(create_petsc_vector_wrap(x), false)
+  {
+  }
+
   // Delete copy constructor to avoid accidental copying of 'heavy' data
   PETScVector(const PETScVector& x) = delete;
 
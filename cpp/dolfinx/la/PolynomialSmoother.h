@@ -0,0 +1,184 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Vector.h"
+#include <array>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace dolfinx::la
+{
+
+/// A matrix-free polynomial (Jacobi/Chebyshev) smoother. The smoother
+/// consumes any operator application `op(x, y)` computing y += A x
+/// (e.g. fem::MatrixFreeOperator::apply) together with the assembled
+/// operator diagonal, and never touches an assembled matrix.
+///
+/// One call to PolynomialSmoother::smooth applies the full smoothing
+/// polynomial x <- x + p(A)(b - A x) as a fused sweep: the work
+/// vectors stay resident across polynomial terms and each term costs
+/// exactly one operator application, whose internal forward/reverse
+/// scatters are the only ghost updates. All other vector updates are
+/// local to owned entries.
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+class PolynomialSmoother
+{
+public:
+  /// Smoother polynomial type
+  enum class Type
+  {
+    jacobi,   ///< Damped Jacobi iteration
+    chebyshev ///< Chebyshev polynomial of the first kind
+  };
+
+  /// Create a polynomial smoother
+  /// @param[in] op The operator application, computing y += A x. Ghost
+  /// updates of x and y are the responsibility of the operator.
+  /// @param[in] diag The assembled diagonal of the operator, e.g. from
+  /// a cell-wise diagonal assembly by the fem layer
+  /// @param[in] eig_range Estimated extreme eigenvalues [lmin, lmax]
+  /// of the diagonally preconditioned operator D^{-1} A. Used by
+  /// Type::chebyshev only.
+  /// @param[in] degree The polynomial degree, i.e. the number of
+  /// operator applications per smoothing sweep
+  /// @param[in] type The smoother polynomial type
+  PolynomialSmoother(
+      std::function<void(Vector<T, Allocator>&, Vector<T, Allocator>&)> op,
+      const Vector<T, Allocator>& diag, std::array<double, 2> eig_range,
+      int degree, Type type = Type::chebyshev)
+      : _op(std::move(op)), _eig(eig_range), _degree(degree), _type(type),
+        _dinv(diag.map(), diag.bs()), _r(diag.map(), diag.bs()),
+        _d(diag.map(), diag.bs()), _t(diag.map(), diag.bs())
+  {
+    if (degree < 1)
+      throw std::runtime_error("Polynomial degree must be at least 1.");
+    if (type == Type::chebyshev and !(eig_range[1] > eig_range[0]))
+    {
+      throw std::runtime_error(
+          "Invalid eigenvalue range for Chebyshev smoother.");
+    }
+
+    // Invert the diagonal once
+    const xtl::span<const T> d = diag.array();
+    const xtl::span<T> dinv = _dinv.mutable_array();
+    for (std::size_t i = 0; i < d.size(); ++i)
+      dinv[i] = T(1) / d[i];
+  }
+
+  /// Set the damping factor for Type::jacobi (default 2/3)
+  void set_damping(double omega) { _omega = omega; }
+
+  /// Apply the smoothing polynomial: x <- x + p(A)(b - A x)
+  /// @param[in] b The right-hand side vector
+  /// @param[in,out] x The vector to smooth. Ghost values are updated
+  /// by the operator before each application.
+  void smooth(const Vector<T, Allocator>& b, Vector<T, Allocator>& x)
+  {
+    if (_type == Type::chebyshev)
+      smooth_chebyshev(b, x);
+    else
+      smooth_jacobi(b, x);
+  }
+
+private:
+  // Chebyshev (first kind) smoother on the interval [lmin, lmax] of
+  // D^{-1} A, using the standard three-term recurrence
+  void smooth_chebyshev(const Vector<T, Allocator>& b,
+                        Vector<T, Allocator>& x)
+  {
+    const double theta = 0.5 * (_eig[1] + _eig[0]);
+    const double delta = 0.5 * (_eig[1] - _eig[0]);
+    const double sigma = theta / delta;
+    double rho = 1.0 / sigma;
+
+    const std::size_t n = _r.bs() * _r.map()->size_local();
+    const xtl::span<const T> b_arr = b.array();
+    const xtl::span<const T> dinv = _dinv.array();
+    const xtl::span<T> r = _r.mutable_array();
+    const xtl::span<T> d = _d.mutable_array();
+    const xtl::span<T> t = _t.mutable_array();
+    const xtl::span<T> x_arr = x.mutable_array();
+
+    // r = b - A x
+    std::fill(r.begin(), r.end(), T(0));
+    _op(x, _r);
+    for (std::size_t i = 0; i < n; ++i)
+      r[i] = b_arr[i] - r[i];
+
+    // d = D^{-1} r / theta
+    const T c0 = static_cast<T>(1.0 / theta);
+    for (std::size_t i = 0; i < n; ++i)
+      d[i] = c0 * dinv[i] * r[i];
+
+    for (int k = 1; k < _degree; ++k)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        x_arr[i] += d[i];
+
+      // r -= A d (one operator application per polynomial term)
+      std::fill(t.begin(), t.end(), T(0));
+      _op(_d, _t);
+      for (std::size_t i = 0; i < n; ++i)
+        r[i] -= t[i];
+
+      const double rho_new = 1.0 / (2.0 * sigma - rho);
+      const T c1 = static_cast<T>(rho_new * rho);
+      const T c2 = static_cast<T>(2.0 * rho_new / delta);
+      for (std::size_t i = 0; i < n; ++i)
+        d[i] = c1 * d[i] + c2 * dinv[i] * r[i];
+      rho = rho_new;
+    }
+
+    for (std::size_t i = 0; i < n; ++i)
+      x_arr[i] += d[i];
+  }
+
+  // Damped Jacobi iteration x <- x + omega D^{-1} (b - A x)
+  void smooth_jacobi(const Vector<T, Allocator>& b, Vector<T, Allocator>& x)
+  {
+    const std::size_t n = _r.bs() * _r.map()->size_local();
+    const xtl::span<const T> b_arr = b.array();
+    const xtl::span<const T> dinv = _dinv.array();
+    const xtl::span<T> r = _r.mutable_array();
+    const xtl::span<T> x_arr = x.mutable_array();
+    const T w = static_cast<T>(_omega);
+
+    for (int k = 0; k < _degree; ++k)
+    {
+      // r = b - A x
+      std::fill(r.begin(), r.end(), T(0));
+      _op(x, _r);
+      for (std::size_t i = 0; i < n; ++i)
+        r[i] = b_arr[i] - r[i];
+
+      for (std::size_t i = 0; i < n; ++i)
+        x_arr[i] += w * dinv[i] * r[i];
+    }
+  }
+
+  // Operator application y += A x
+  std::function<void(Vector<T, Allocator>&, Vector<T, Allocator>&)> _op;
+
+  // Eigenvalue estimates [lmin, lmax] of D^{-1} A
+  std::array<double, 2> _eig;
+
+  // Polynomial degree
+  int _degree;
+
+  // Smoother type
+  Type _type;
+
+  // Damping factor for Type::jacobi
+  double _omega = 2.0 / 3.0;
+
+  // Inverse of the operator diagonal and resident work vectors
+  Vector<T, Allocator> _dinv;
+  Vector<T, Allocator> _r, _d, _t;
+};
+} // namespace dolfinx::la
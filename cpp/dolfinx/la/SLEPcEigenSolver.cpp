@@ -11,6 +11,7 @@
 #include "utils.h"
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/subsystem.h>
 #include <dolfinx/la/PETScVector.h>
 #include <petscmat.h>
 #include <slepcversion.h>
@@ -19,7 +20,11 @@ using namespace dolfinx;
 using namespace dolfinx::la;
 
 //-----------------------------------------------------------------------------
-SLEPcEigenSolver::SLEPcEigenSolver(MPI_Comm comm) { EPSCreate(comm, &_eps); }
+SLEPcEigenSolver::SLEPcEigenSolver(MPI_Comm comm)
+{
+  common::subsystem::ensure_petsc_initialized();
+  EPSCreate(comm, &_eps);
+}
 //-----------------------------------------------------------------------------
 SLEPcEigenSolver::SLEPcEigenSolver(EPS eps, bool inc_ref_count) : _eps(eps)
 {
@@ -36,13 +41,17 @@ SLEPcEigenSolver::SLEPcEigenSolver(EPS eps, bool inc_ref_count) : _eps(eps)
 }
 //-----------------------------------------------------------------------------
 SLEPcEigenSolver::SLEPcEigenSolver(SLEPcEigenSolver&& solver)
-    : _eps(std::exchange(solver._eps, nullptr))
+    : _eps(std::exchange(solver._eps, nullptr)), _reuse_st(solver._reuse_st),
+      _deflate(solver._deflate), _num_solves(solver._num_solves),
+      _deflation(std::move(solver._deflation))
 {
-  // Do nothing
+  solver._deflation.clear();
 }
 //-----------------------------------------------------------------------------
 SLEPcEigenSolver::~SLEPcEigenSolver()
 {
+  for (Vec v : _deflation)
+    VecDestroy(&v);
   if (_eps)
     EPSDestroy(&_eps);
 }
@@ -50,6 +59,10 @@ SLEPcEigenSolver::~SLEPcEigenSolver()
 SLEPcEigenSolver& SLEPcEigenSolver::operator=(SLEPcEigenSolver&& solver)
 {
   std::swap(_eps, solver._eps);
+  std::swap(_reuse_st, solver._reuse_st);
+  std::swap(_deflate, solver._deflate);
+  std::swap(_num_solves, solver._num_solves);
+  std::swap(_deflation, solver._deflation);
   return *this;
 }
 //-----------------------------------------------------------------------------
@@ -59,6 +72,39 @@ void SLEPcEigenSolver::set_operators(const Mat A, const Mat B)
   EPSSetOperators(_eps, A, B);
 }
 //-----------------------------------------------------------------------------
+void SLEPcEigenSolver::set_reuse_spectral_transform(bool reuse)
+{
+  _reuse_st = reuse;
+}
+//-----------------------------------------------------------------------------
+void SLEPcEigenSolver::set_deflation_from_converged(bool enable)
+{
+  _deflate = enable;
+}
+//-----------------------------------------------------------------------------
+void SLEPcEigenSolver::reset_sequence()
+{
+  for (Vec v : _deflation)
+    VecDestroy(&v);
+  _deflation.clear();
+  _num_solves = 0;
+
+  // Rebuild the spectral transformation factorization on the next
+  // solve
+  if (_eps)
+  {
+    ST st = nullptr;
+    EPSGetST(_eps, &st);
+    if (st)
+    {
+      KSP ksp = nullptr;
+      STGetKSP(st, &ksp);
+      if (ksp)
+        KSPSetReusePreconditioner(ksp, PETSC_FALSE);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 void SLEPcEigenSolver::solve()
 {
   // Get operators
@@ -91,8 +137,36 @@ void SLEPcEigenSolver::solve(std::int64_t n)
   // Set any options from the PETSc database
   EPSSetFromOptions(_eps);
 
+  // From the second solve of a sequence onwards, keep the spectral
+  // transformation factorization from the earlier solve and use it as
+  // the preconditioner of the inner KSP
+  if (_reuse_st and _num_solves > 0)
+  {
+    ST st = nullptr;
+    EPSGetST(_eps, &st);
+    assert(st);
+    KSP ksp = nullptr;
+    STGetKSP(st, &ksp);
+    assert(ksp);
+    KSPType ksp_type = nullptr;
+    KSPGetType(ksp, &ksp_type);
+    if (ksp_type and std::string(ksp_type) == KSPPREONLY)
+    {
+      LOG(WARNING) << "Re-using the spectral transformation factorization "
+                      "with a KSPPREONLY inner solver makes the "
+                      "transformation inexact. Use an iterative inner KSP.";
+    }
+    KSPSetReusePreconditioner(ksp, PETSC_TRUE);
+  }
+
+  // Deflate against eigenvectors converged in earlier solves of the
+  // sequence
+  if (!_deflation.empty())
+    EPSSetDeflationSpace(_eps, _deflation.size(), _deflation.data());
+
   // Solve eigenvalue problem
   EPSSolve(_eps);
+  ++_num_solves;
 
   // Check for convergence
   EPSConvergedReason reason;
@@ -100,6 +174,26 @@ void SLEPcEigenSolver::solve(std::int64_t n)
   if (reason < 0)
     LOG(WARNING) << "Eigenvalue solver did not converge";
 
+  // Accumulate the converged eigenvectors for deflation of later
+  // solves in the sequence
+  if (_deflate)
+  {
+    PetscInt num_converged = 0;
+    EPSGetConverged(_eps, &num_converged);
+    if (num_converged > 0)
+    {
+      Mat A = nullptr;
+      EPSGetOperators(_eps, &A, nullptr);
+      for (PetscInt i = 0; i < num_converged; ++i)
+      {
+        Vec vr = nullptr;
+        MatCreateVecs(A, &vr, nullptr);
+        EPSGetEigenvector(_eps, i, vr, nullptr);
+        _deflation.push_back(vr);
+      }
+    }
+  }
+
   // Report solver status
   PetscInt num_iterations = 0;
   EPSGetIterationNumber(_eps, &num_iterations);
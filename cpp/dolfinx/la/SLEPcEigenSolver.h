@@ -14,6 +14,7 @@
 #include <petscvec.h>
 #include <slepceps.h>
 #include <string>
+#include <vector>
 
 namespace dolfinx::la
 {
@@ -50,6 +51,31 @@ public:
   /// problems)
   void set_operators(const Mat A, const Mat B);
 
+  /// Retain the spectral transformation factorization (e.g. the
+  /// shift-invert LU) across solves in a sequence. From the second
+  /// solve onwards the inner KSP re-uses the factorization from the
+  /// first solve as its preconditioner, so when only a low-rank part
+  /// of the operator changes each subsequent solve costs a fraction
+  /// of the first.
+  ///
+  /// @note The inner KSP of the spectral transformation must use an
+  /// iterative method; with KSPPREONLY the retained factorization
+  /// would be applied as an (inexact) direct solve of the modified
+  /// operator.
+  void set_reuse_spectral_transform(bool reuse);
+
+  /// Deflate subsequent solves in a sequence against the eigenvectors
+  /// that converged in earlier solves. Converged eigenvectors are
+  /// accumulated after each solve and passed to the next solve as a
+  /// deflation space, so a sequence of modal analyses does not
+  /// re-compute eigenpairs it already knows.
+  void set_deflation_from_converged(bool enable);
+
+  /// Reset the solve-sequence state: drop the accumulated deflation
+  /// vectors and rebuild the spectral transformation factorization on
+  /// the next solve
+  void reset_sequence();
+
   /// Compute all eigenpairs of the matrix A (solve Ax = \lambda x)
   void solve();
 
@@ -89,6 +115,19 @@ public:
 private:
   // SLEPc solver pointer
   EPS _eps;
+
+  // Re-use the spectral transformation factorization across solves
+  bool _reuse_st = false;
+
+  // Accumulate converged eigenvectors for deflation of later solves
+  bool _deflate = false;
+
+  // Number of solves since the sequence state was last reset
+  int _num_solves = 0;
+
+  // Eigenvectors converged in earlier solves of the sequence, used as
+  // a deflation space (owned by this class)
+  std::vector<Vec> _deflation;
 };
 } // namespace dolfinx::la
 #endif
@@ -6,16 +6,98 @@
 
 #include "SparsityPattern.h"
 #include <algorithm>
+#include <atomic>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/memory.h>
+#include <dolfinx/common/sort.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <map>
 
 using namespace dolfinx;
 using namespace dolfinx::la;
 
+namespace
+{
+/// Execute f(begin, end) over the index range [0, n) on the shared
+/// thread pool. Writes from different sub-ranges must not overlap.
+template <typename Fn>
+void parallel_for_ranges(std::size_t n, Fn&& f)
+{
+  dolfinx::common::thread_pool().parallel_for(n, f);
+}
+
+/// Append the entries (i, j), i in dofmap0.links(cell(k)), j in
+/// dofmap1.links(cell(k)), for k in [0, num_cells) to the flat
+/// insertion buffers. Entry counts are computed up front so the
+/// buffers are resized once and filled in threaded fashion.
+/// `cell(k)` maps the position k to a cell index.
+template <typename CellIndex>
+void bulk_insert(std::vector<std::int32_t>& insert_rows,
+                 std::vector<std::int32_t>& insert_cols,
+                 const graph::AdjacencyList<std::int32_t>& dofmap0,
+                 const graph::AdjacencyList<std::int32_t>& dofmap1,
+                 std::size_t num_cells, const CellIndex& cell,
+                 std::int32_t size0)
+{
+  // Count entries per cell and compute insertion offsets
+  std::vector<std::size_t> offsets(num_cells + 1, 0);
+  parallel_for_ranges(num_cells,
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t k = begin; k < end; ++k)
+                        {
+                          const std::int32_t c = cell(k);
+                          offsets[k + 1] = std::size_t(dofmap0.num_links(c))
+                                           * dofmap1.num_links(c);
+                        }
+                      });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  const std::size_t base = insert_rows.size();
+  insert_rows.resize(base + offsets.back());
+  insert_cols.resize(base + offsets.back());
+
+  // Fill the buffers, each thread writing a disjoint slice. Workers do
+  // not throw; out-of-range rows are flagged and reported after the
+  // join.
+  std::atomic<bool> row_out_of_range(false);
+  parallel_for_ranges(
+      num_cells,
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t k = begin; k < end; ++k)
+        {
+          const std::int32_t c = cell(k);
+          auto rows = dofmap0.links(c);
+          auto cols = dofmap1.links(c);
+          std::size_t pos = base + offsets[k];
+          for (std::int32_t row : rows)
+          {
+            if (row >= size0)
+              row_out_of_range = true;
+            for (std::int32_t col : cols)
+            {
+              insert_rows[pos] = row;
+              insert_cols[pos] = col;
+              ++pos;
+            }
+          }
+        }
+      });
+
+  if (row_out_of_range)
+  {
+    throw std::runtime_error(
+        "Cannot insert rows that do not exist in the IndexMap.");
+  }
+}
+} // namespace
+
 //-----------------------------------------------------------------------------
 SparsityPattern::SparsityPattern(
     MPI_Comm comm,
@@ -24,8 +106,6 @@ SparsityPattern::SparsityPattern(
     : _mpi_comm(comm), _index_maps(maps), _bs(bs)
 {
   assert(maps[0]);
-  _cache_owned.resize(maps[0]->size_local());
-  _cache_unowned.resize(maps[0]->num_ghosts());
 }
 //-----------------------------------------------------------------------------
 SparsityPattern::SparsityPattern(
@@ -77,15 +157,11 @@ SparsityPattern::SparsityPattern(
           comm, std::set<int>(ghost_owners1.begin(), ghost_owners1.end())),
       ghosts1, ghost_owners1);
 
-  _cache_owned.resize(_index_maps[0]->size_local());
-  _cache_unowned.resize(_index_maps[0]->num_ghosts());
-
   // Iterate over block rows
   for (std::size_t row = 0; row < patterns.size(); ++row)
   {
     const common::IndexMap& map_row = maps[0][row].first;
     const std::int32_t num_rows_local = map_row.size_local();
-    const std::int32_t num_ghost_rows_local = map_row.num_ghosts();
 
     // Iterate over block columns of current row (block)
     for (std::size_t col = 0; col < patterns[row].size(); ++col)
@@ -106,40 +182,30 @@ SparsityPattern::SparsityPattern(
       const int bs_dof0 = bs[0][row];
       const int bs_dof1 = bs[1][col];
 
-      // Iterate over owned rows cache
-      for (std::int32_t i = 0; i < num_rows_local; ++i)
-      {
-        for (std::int32_t c_old : p->_cache_owned[i])
-        {
-          const std::int32_t r_new = bs_dof0 * i + local_offset0[row];
-          const std::int32_t c_new = (c_old < num_cols_local)
-                                         ? bs_dof1 * c_old + local_offset1[col]
-                                         : bs_dof1 * (c_old - num_cols_local)
-                                               + local_offset1.back()
-                                               + ghost_offsets1[col];
-
-          for (int k0 = 0; k0 < bs_dof0; ++k0)
-          {
-            for (int k1 = 0; k1 < bs_dof1; ++k1)
-              _cache_owned[r_new + k0].push_back(c_new + k1);
-          }
-        }
-      }
-      // Iterate over unowned rows cache
-      for (std::int32_t i = 0; i < num_ghost_rows_local; ++i)
+      // Iterate over the unassembled entries of this block. Ghost rows
+      // of the block map to rows following the owned rows of the
+      // stacked map.
+      assert(p->_insert_rows.size() == p->_insert_cols.size());
+      for (std::size_t k = 0; k < p->_insert_rows.size(); ++k)
       {
-        for (std::int32_t c_old : p->_cache_unowned[i])
+        const std::int32_t r_old = p->_insert_rows[k];
+        const std::int32_t c_old = p->_insert_cols[k];
+        const std::int32_t r_new
+            = (r_old < num_rows_local)
+                  ? bs_dof0 * r_old + local_offset0[row]
+                  : bs_dof0 * (r_old - num_rows_local) + local_offset0.back()
+                        + ghost_offsets0[row];
+        const std::int32_t c_new = (c_old < num_cols_local)
+                                       ? bs_dof1 * c_old + local_offset1[col]
+                                       : bs_dof1 * (c_old - num_cols_local)
+                                             + local_offset1.back()
+                                             + ghost_offsets1[col];
+        for (int k0 = 0; k0 < bs_dof0; ++k0)
         {
-          const std::int32_t r_new = bs_dof0 * i + ghost_offsets0[row];
-          const std::int32_t c_new = (c_old < num_cols_local)
-                                         ? bs_dof1 * c_old + local_offset1[col]
-                                         : bs_dof1 * (c_old - num_cols_local)
-                                               + local_offset1.back()
-                                               + ghost_offsets1[col];
-          for (int k0 = 0; k0 < bs_dof0; ++k0)
+          for (int k1 = 0; k1 < bs_dof1; ++k1)
           {
-            for (int k1 = 0; k1 < bs_dof1; ++k1)
-              _cache_unowned[r_new + k0].push_back(c_new + k1);
+            _insert_rows.push_back(r_new + k0);
+            _insert_cols.push_back(c_new + k1);
           }
         }
       }
@@ -182,13 +248,13 @@ void SparsityPattern::insert(const xtl::span<const std::int32_t>& rows,
 
   for (std::int32_t row : rows)
   {
-    if (row < local_size0)
-      _cache_owned[row].insert(_cache_owned[row].end(), cols.begin(),
-                               cols.end());
-    else if (row < size0)
+    if (row < size0)
     {
-      _cache_unowned[row - local_size0].insert(
-          _cache_unowned[row - local_size0].end(), cols.begin(), cols.end());
+      for (std::int32_t col : cols)
+      {
+        _insert_rows.push_back(row);
+        _insert_cols.push_back(col);
+      }
     }
     else
     {
@@ -198,6 +264,41 @@ void SparsityPattern::insert(const xtl::span<const std::int32_t>& rows,
   }
 }
 //-----------------------------------------------------------------------------
+void SparsityPattern::insert(const graph::AdjacencyList<std::int32_t>& dofmap0,
+                             const graph::AdjacencyList<std::int32_t>& dofmap1,
+                             const xtl::span<const std::int32_t>& cells)
+{
+  if (_diagonal)
+  {
+    throw std::runtime_error(
+        "Cannot insert into sparsity pattern. It has already been assembled");
+  }
+
+  assert(_index_maps[0]);
+  const std::int32_t size0
+      = _index_maps[0]->size_local() + _index_maps[0]->num_ghosts();
+  bulk_insert(
+      _insert_rows, _insert_cols, dofmap0, dofmap1, cells.size(),
+      [&cells](std::size_t k) { return cells[k]; }, size0);
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::insert(const graph::AdjacencyList<std::int32_t>& dofmap0,
+                             const graph::AdjacencyList<std::int32_t>& dofmap1)
+{
+  if (_diagonal)
+  {
+    throw std::runtime_error(
+        "Cannot insert into sparsity pattern. It has already been assembled");
+  }
+
+  assert(_index_maps[0]);
+  const std::int32_t size0
+      = _index_maps[0]->size_local() + _index_maps[0]->num_ghosts();
+  bulk_insert(
+      _insert_rows, _insert_cols, dofmap0, dofmap1, dofmap0.num_nodes(),
+      [](std::size_t k) { return std::int32_t(k); }, size0);
+}
+//-----------------------------------------------------------------------------
 void SparsityPattern::insert_diagonal(const std::vector<int32_t>& rows)
 {
   if (_diagonal)
@@ -212,10 +313,11 @@ void SparsityPattern::insert_diagonal(const std::vector<int32_t>& rows)
 
   for (std::int32_t row : rows)
   {
-    if (row < local_size0)
-      _cache_owned[row].push_back(row);
-    else if (row < size0)
-      _cache_unowned[row - local_size0].push_back(row);
+    if (row < size0)
+    {
+      _insert_rows.push_back(row);
+      _insert_cols.push_back(row);
+    }
     else
     {
       throw std::runtime_error(
@@ -260,6 +362,7 @@ void SparsityPattern::assemble()
     dest_proc_to_neighbor.insert({dest_ranks[i], i});
 
   // Compute size of data to send to each process
+  assert(_insert_rows.size() == _insert_cols.size());
   std::vector<std::int32_t> data_per_proc(dest_ranks.size(), 0);
   std::vector<int> ghost_to_neighbour_rank(num_ghosts0, -1);
   for (int i = 0; i < num_ghosts0; ++i)
@@ -268,10 +371,12 @@ void SparsityPattern::assemble()
     const auto it = dest_proc_to_neighbor.find(ghost_owners0[i]);
     assert(it != dest_proc_to_neighbor.end());
     ghost_to_neighbour_rank[i] = it->second;
-
-    // Add to src size
     assert(ghost_to_neighbour_rank[i] < (int)data_per_proc.size());
-    data_per_proc[ghost_to_neighbour_rank[i]] += 2 * _cache_unowned[i].size();
+  }
+  for (std::int32_t r : _insert_rows)
+  {
+    if (r >= local_size0)
+      data_per_proc[ghost_to_neighbour_rank[r - local_size0]] += 2;
   }
 
   // Compute send displacements
@@ -279,27 +384,29 @@ void SparsityPattern::assemble()
   std::partial_sum(data_per_proc.begin(), data_per_proc.end(),
                    std::next(send_disp.begin(), 1));
 
-  // For each ghost row, pack and send (global row, global col,
-  // col_owner) triplets to send to neighborhood
+  // For each ghost row entry, pack (global row, global col) pairs to
+  // send to neighborhood
   std::vector<int> insert_pos(send_disp);
   std::vector<std::int64_t> ghost_data(send_disp.back());
-  for (int i = 0; i < num_ghosts0; ++i)
+  for (std::size_t k = 0; k < _insert_rows.size(); ++k)
   {
+    if (_insert_rows[k] < local_size0)
+      continue;
+    const std::int32_t i = _insert_rows[k] - local_size0;
+    const std::int32_t col_local = _insert_cols[k];
+
+    // Get index in send buffer
     const int neighbour_rank = ghost_to_neighbour_rank[i];
-    for (std::int32_t col_local : _cache_unowned[i])
-    {
-      // Get index in send buffer
-      const std::int32_t pos = insert_pos[neighbour_rank];
+    const std::int32_t pos = insert_pos[neighbour_rank];
 
-      // Pack send data
-      ghost_data[pos] = ghosts0[i];
-      if (col_local < local_size1)
-        ghost_data[pos + 1] = col_local + local_range1[0];
-      else
-        ghost_data[pos + 1] = _col_ghosts[col_local - local_size1];
+    // Pack send data
+    ghost_data[pos] = ghosts0[i];
+    if (col_local < local_size1)
+      ghost_data[pos + 1] = col_local + local_range1[0];
+    else
+      ghost_data[pos + 1] = _col_ghosts[col_local - local_size1];
 
-      insert_pos[neighbour_rank] += 2;
-    }
+    insert_pos[neighbour_rank] += 2;
   }
 
   // Create and communicate adjacency list to neighborhood
@@ -314,58 +421,128 @@ void SparsityPattern::assemble()
   {
     const std::int32_t row_local = in_ghost_data[i] - local_range0[0];
     const std::int64_t col = in_ghost_data[i + 1];
+    _insert_rows.push_back(row_local);
     if (col >= local_range1[0] and col < local_range1[1])
     {
       // Convert to local column index
-      const std::int32_t J = col - local_range1[0];
-      _cache_owned[row_local].push_back(J);
+      _insert_cols.push_back(col - local_range1[0]);
     }
     else
     {
       // Column index may not exist in column indexmap
-      auto it = global_to_local.insert({col, local_i});
+      const auto it = global_to_local.insert({col, local_i});
       if (it.second)
       {
         _col_ghosts.push_back(col);
         ++local_i;
       }
-      const std::int32_t col_local = it.first->second;
-      _cache_owned[row_local].push_back(col_local);
+      _insert_cols.push_back(it.first->second);
     }
   }
 
-  // Sort and remove duplicate column indices in each owned row
+  const std::int32_t size0 = local_size0 + num_ghosts0;
+
+  // Pass 1: count the entries on each row (owned and ghost) and
+  // compute exact insertion offsets
+  std::vector<std::int32_t> row_offsets(size0 + 1, 0);
+  for (std::int32_t r : _insert_rows)
+    ++row_offsets[r + 1];
+  std::partial_sum(row_offsets.begin(), row_offsets.end(),
+                   row_offsets.begin());
+
+  // Pass 2: scatter the column indices into an exact-size work array,
+  // grouped by row
+  std::vector<std::int32_t> pos(row_offsets.begin(),
+                                std::prev(row_offsets.end()));
+  std::vector<std::int32_t> cols_tmp(_insert_rows.size());
+  for (std::size_t k = 0; k < _insert_rows.size(); ++k)
+    cols_tmp[pos[_insert_rows[k]]++] = _insert_cols[k];
+
+  // The insertion buffers and the row-grouped work array coexist only
+  // during the scatter above; record the high-water mark before
+  // releasing the buffers
+  const std::size_t peak_bytes
+      = sizeof(std::int32_t)
+        * (_insert_rows.size() + _insert_cols.size() + cols_tmp.size()
+           + row_offsets.size() + pos.size());
+  register_memory("SparsityPattern (scratch)", peak_bytes);
+  std::vector<std::int32_t>().swap(_insert_rows);
+  std::vector<std::int32_t>().swap(_insert_cols);
+
+  // Sort and remove duplicate column indices in each row, splitting
+  // the rows across threads. Rows are independent, so each thread
+  // works on a disjoint slice of the work array. Unique entries are
+  // packed to the front of each row segment and the counts recorded,
+  // split into owned and non-owned columns for owned rows.
   std::vector<std::int32_t> adj_counts(local_size0, 0),
       adj_counts_off(local_size0, 0);
-  std::vector<std::int32_t> adj_data, adj_data_off;
-  for (std::int32_t i = 0; i < local_size0; ++i)
-  {
-    std::vector<std::int32_t>& row = _cache_owned[i];
-    std::sort(row.begin(), row.end());
-    const std::vector<std::int32_t>::iterator it_end
-        = std::unique(row.begin(), row.end());
-
-    // Find position of first "off-diagonal" column
-    const std::vector<std::int32_t>::iterator it_diag
-        = std::lower_bound(row.begin(), it_end, local_size1);
-
-    // Store owned columns
-    adj_data.insert(adj_data.end(), row.begin(), it_diag);
-    adj_counts[i] += (it_diag - row.begin());
-
-    // Store non-owned columns
-    adj_data_off.insert(adj_data_off.end(), it_diag, it_end);
-    adj_counts_off[i] += (it_end - it_diag);
-  }
-  std::vector<std::vector<std::int32_t>>().swap(_cache_owned);
+  std::vector<std::int32_t> ghost_counts(num_ghosts0, 0);
+  parallel_for_ranges(
+      size0,
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          const xtl::span<std::int32_t> row(cols_tmp.data() + row_offsets[i],
+                                            row_offsets[i + 1]
+                                                - row_offsets[i]);
+          dolfinx::radix_sort(row);
+          const auto it_end = std::unique(row.begin(), row.end());
+          if (i < std::size_t(local_size0))
+          {
+            // Find position of first "off-diagonal" column
+            const auto it_diag
+                = std::lower_bound(row.begin(), it_end, local_size1);
+            adj_counts[i] = std::distance(row.begin(), it_diag);
+            adj_counts_off[i] = std::distance(it_diag, it_end);
+          }
+          else
+            ghost_counts[i - local_size0] = std::distance(row.begin(), it_end);
+        }
+      });
 
-  // Compute offsets for diagonal and off-diagonal block adjacency lists
-  std::vector<std::int32_t> adj_offsets(local_size0 + 1),
-      adj_offsets_off(local_size0 + 1);
+  // Compute offsets for the diagonal and off-diagonal block adjacency
+  // lists and for the ghost rows
+  std::vector<std::int32_t> adj_offsets(local_size0 + 1, 0),
+      adj_offsets_off(local_size0 + 1, 0);
   std::partial_sum(adj_counts.begin(), adj_counts.end(),
-                   adj_offsets.begin() + 1);
+                   std::next(adj_offsets.begin()));
   std::partial_sum(adj_counts_off.begin(), adj_counts_off.end(),
-                   adj_offsets_off.begin() + 1);
+                   std::next(adj_offsets_off.begin()));
+  std::vector<std::int32_t> ghost_offsets(num_ghosts0 + 1, 0);
+  std::partial_sum(ghost_counts.begin(), ghost_counts.end(),
+                   std::next(ghost_offsets.begin()));
+
+  // Copy the deduplicated rows into exact-size adjacency arrays, again
+  // splitting the rows across threads
+  std::vector<std::int32_t> adj_data(adj_offsets.back());
+  std::vector<std::int32_t> adj_data_off(adj_offsets_off.back());
+  std::vector<std::int32_t> ghost_row_data(ghost_offsets.back());
+  parallel_for_ranges(
+      size0,
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          const std::int32_t* row = cols_tmp.data() + row_offsets[i];
+          if (i < std::size_t(local_size0))
+          {
+            std::copy_n(row, adj_counts[i], adj_data.begin() + adj_offsets[i]);
+            std::copy_n(row + adj_counts[i], adj_counts_off[i],
+                        adj_data_off.begin() + adj_offsets_off[i]);
+          }
+          else
+          {
+            std::copy_n(row, ghost_counts[i - local_size0],
+                        ghost_row_data.begin() + ghost_offsets[i - local_size0]);
+          }
+        }
+      });
+
+  LOG(INFO) << "Sparsity pattern assembled with a peak of " << peak_bytes
+            << " scratch bytes for "
+            << adj_offsets.back() + adj_offsets_off.back()
+            << " owned non-zeros";
 
   // FIXME: after assembly, there are no ghost rows, i.e. the IndexMap for rows
   // should be non-overlapping. However, we are retaining the row overlap
@@ -384,6 +561,24 @@ void SparsityPattern::assemble()
 
   _off_diagonal = std::make_shared<graph::AdjacencyList<std::int32_t>>(
       std::move(adj_data_off), std::move(adj_offsets_off));
+
+  // The ghost row data has been sent to the owning processes above,
+  // but the pattern is retained so that matrix classes can preallocate
+  // storage for ghost row contributions.
+  _unowned = std::make_shared<graph::AdjacencyList<std::int32_t>>(
+      std::move(ghost_row_data), std::move(ghost_offsets));
+
+  // Account for the assembled pattern; the scratch buffers have been
+  // released
+  register_memory(
+      "SparsityPattern",
+      sizeof(std::int32_t)
+          * std::int64_t(_diagonal->array().size() + _diagonal->offsets().size()
+                         + _off_diagonal->array().size()
+                         + _off_diagonal->offsets().size()
+                         + _unowned->array().size()
+                         + _unowned->offsets().size()));
+  register_memory("SparsityPattern (scratch)", -std::int64_t(peak_bytes));
 }
 //-----------------------------------------------------------------------------
 std::int64_t SparsityPattern::num_nonzeros() const
@@ -410,5 +605,13 @@ SparsityPattern::off_diagonal_pattern() const
   return *_off_diagonal;
 }
 //-----------------------------------------------------------------------------
+const graph::AdjacencyList<std::int32_t>&
+SparsityPattern::ghost_row_pattern() const
+{
+  if (!_unowned)
+    throw std::runtime_error("Sparsity pattern has not been finalised.");
+  return *_unowned;
+}
+//-----------------------------------------------------------------------------
 MPI_Comm SparsityPattern::mpi_comm() const { return _mpi_comm.comm(); }
 //-----------------------------------------------------------------------------
@@ -91,6 +91,30 @@ public:
   void insert(const xtl::span<const std::int32_t>& rows,
               const xtl::span<const std::int32_t>& cols);
 
+  /// Insert non-zero locations for a list of cells in one call. For
+  /// each cell c in @p cells the entries (i, j) with i in
+  /// `dofmap0.links(c)` and j in `dofmap1.links(c)` are inserted. This
+  /// is equivalent to calling insert once per cell with the cell dof
+  /// spans, but counts the entries up front and fills the insertion
+  /// buffers in blocked, threaded fashion, which avoids the per-cell
+  /// call and reallocation overhead on large meshes.
+  ///
+  /// @param[in] dofmap0 Row indices (local) for each cell
+  /// @param[in] dofmap1 Column indices (local) for each cell
+  /// @param[in] cells Cells (nodes of the adjacency lists) to insert
+  void insert(const graph::AdjacencyList<std::int32_t>& dofmap0,
+              const graph::AdjacencyList<std::int32_t>& dofmap1,
+              const xtl::span<const std::int32_t>& cells);
+
+  /// Insert non-zero locations for all cells of a pair of dofmaps (see
+  /// the cell-list overload). Equivalent to inserting every cell, but
+  /// without materializing a cell list.
+  ///
+  /// @param[in] dofmap0 Row indices (local) for each cell
+  /// @param[in] dofmap1 Column indices (local) for each cell
+  void insert(const graph::AdjacencyList<std::int32_t>& dofmap0,
+              const graph::AdjacencyList<std::int32_t>& dofmap1);
+
   /// Insert non-zero locations on the diagonal
   /// @param[in] rows The rows in local (process-wise) indices. The
   ///   indices must exist in the row IndexMap.
@@ -110,6 +134,15 @@ public:
   /// indices for the columns. Translate to global with column IndexMap.
   const graph::AdjacencyList<std::int32_t>& off_diagonal_pattern() const;
 
+  /// Sparsity pattern for rows that are ghosted on this process, i.e.
+  /// rows owned by another process to which this process contributes.
+  /// Row i corresponds to ghost row i of the row IndexMap. Columns use
+  /// the same local indexing as the owned-row patterns: [0,
+  /// size_local) for owned columns, with ghost columns following. Used
+  /// to preallocate storage for ghost-row contributions before they
+  /// are sent to the owning process.
+  const graph::AdjacencyList<std::int32_t>& ghost_row_pattern() const;
+
   /// Return MPI communicator
   MPI_Comm mpi_comm() const;
 
@@ -124,12 +157,19 @@ private:
   // Non-zero ghost columns in owned rows
   std::vector<std::int64_t> _col_ghosts;
 
-  // Caches for unassembled entries on owned and unowned (ghost) rows
-  std::vector<std::vector<std::int32_t>> _cache_owned;
-  std::vector<std::vector<std::int32_t>> _cache_unowned;
+  // Unassembled entries, stored as matching (row, column) arrays. Rows
+  // [0, size_local) are owned and rows [size_local, size_local +
+  // num_ghosts) are ghost rows. Flat storage keeps the memory overhead
+  // of the insertion phase at exactly two integers per entry.
+  std::vector<std::int32_t> _insert_rows;
+  std::vector<std::int32_t> _insert_cols;
 
   // Sparsity pattern data (computed once pattern is finalised)
   std::shared_ptr<graph::AdjacencyList<std::int32_t>> _diagonal;
   std::shared_ptr<graph::AdjacencyList<std::int32_t>> _off_diagonal;
+
+  // Sparsity pattern for ghost rows (computed once pattern is
+  // finalised)
+  std::shared_ptr<graph::AdjacencyList<std::int32_t>> _unowned;
 };
 } // namespace dolfinx::la
@@ -7,62 +7,174 @@
 #pragma once
 
 #include "utils.h"
+#include <algorithm>
+#include <cmath>
 #include <complex>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/allocator.h>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <numeric>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <xtl/xspan.hpp>
 
 namespace dolfinx::la
 {
 
-/// Distributed vector
+/// Lazy vector expression nodes, see la::operator*(T, const Vector&)
+/// and Vector::operator=(const E&). Expressions reference vector data;
+/// the referenced vectors must be kept alive until the expression is
+/// assigned.
+namespace expr
+{
+/// The scaled term `a * x` in a vector expression
+template <typename T>
+struct Scaled
+{
+  /// Scalar factor
+  T a;
+  /// Vector data
+  const T* x;
+  /// Number of entries
+  std::size_t size;
+  /// Evaluate entry i
+  T operator[](std::size_t i) const { return a * x[i]; }
+};
 
-template <typename T, class Allocator = std::allocator<T>>
+/// The sum of two vector (sub-)expressions
+template <class E0, class E1>
+struct Sum
+{
+  /// Left operand
+  E0 e0;
+  /// Right operand
+  E1 e1;
+  /// Number of entries
+  std::size_t size;
+  /// Evaluate entry i
+  auto operator[](std::size_t i) const { return e0[i] + e1[i]; }
+};
+
+/// Identify vector expression nodes
+template <class E>
+struct is_expression : std::false_type
+{
+};
+/// Scaled terms are expression nodes
+template <typename T>
+struct is_expression<Scaled<T>> : std::true_type
+{
+};
+/// Sums of expression nodes are expression nodes
+template <class E0, class E1>
+struct is_expression<Sum<E0, E1>> : std::true_type
+{
+};
+} // namespace expr
+
+/// Distributed vector. The data (payload and ghost scatter buffers) is
+/// allocated with `Allocator`, by default a 64-byte aligned pool
+/// allocator so array access can be vectorized and buffers are recycled
+/// rather than re-allocated.
+///
+/// The allocator also determines the memory space: with a device or
+/// unified-memory allocator the payload and both scatter buffers are
+/// device-resident, and the halo exchange posts MPI operations
+/// directly on those buffers, so a device-aware MPI implementation
+/// never bounces the data through host staging copies. The pack and
+/// unpack loops dereference the buffers through ordinary pointers, so
+/// the memory must be host-accessible (e.g. unified/managed memory).
+/// See la::create_petsc_vector_wrap for sharing the payload with a
+/// PETSc Vec without copying.
+
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
 class Vector
 {
 public:
+  /// Reduced-precision scalar type used for compressed ghost scatters,
+  /// see set_compressed_scatter
+  using compressed_type
+      = std::conditional_t<std::is_same<T, std::complex<double>>::value,
+                           std::complex<float>,
+                           std::conditional_t<std::is_same<T, double>::value,
+                                              float, T>>;
+
   /// Create a distributed vector
   Vector(const std::shared_ptr<const common::IndexMap>& map, int bs,
          const Allocator& alloc = Allocator())
       : _map(map), _bs(bs),
+        _buffer_send_fwd(bs * map->scatter_fwd_indices().array().size(), alloc),
+        _buffer_recv_fwd(bs * map->num_ghosts(), alloc),
+        _buffer_send_fwd32(Allocator32(alloc)),
+        _buffer_recv_fwd32(Allocator32(alloc)),
         _x(bs * (map->size_local() + map->num_ghosts()), alloc)
   {
     if (bs == 1)
+    {
       _datatype = MPI::mpi_type<T>();
+      _datatype32 = MPI::mpi_type<compressed_type>();
+    }
     else
     {
       MPI_Type_contiguous(bs, dolfinx::MPI::mpi_type<T>(), &_datatype);
       MPI_Type_commit(&_datatype);
+      MPI_Type_contiguous(bs, dolfinx::MPI::mpi_type<compressed_type>(),
+                          &_datatype32);
+      MPI_Type_commit(&_datatype32);
     }
   }
 
   /// Copy constructor
   Vector(const Vector& x)
-      : _map(x._map), _bs(x._bs), _request(MPI_REQUEST_NULL),
-        _buffer_send_fwd(x._buffer_send_fwd),
-        _buffer_recv_fwd(x._buffer_recv_fwd), _x(x._x)
+      : _map(x._map), _bs(x._bs), _request_fwd(MPI_REQUEST_NULL),
+        _request_rev(MPI_REQUEST_NULL), _buffer_send_fwd(x._buffer_send_fwd),
+        _buffer_recv_fwd(x._buffer_recv_fwd),
+        _buffer_send_fwd32(x._buffer_send_fwd32),
+        _buffer_recv_fwd32(x._buffer_recv_fwd32),
+        _compress_scatter(x._compress_scatter), _x(x._x)
   {
     MPI_Type_dup(x._datatype, &_datatype);
+    MPI_Type_dup(x._datatype32, &_datatype32);
   }
 
   /// Move constructor
   Vector(Vector&& x)
       : _map(std::move(x._map)), _bs(std::move(x._bs)),
         _datatype(std::exchange(x._datatype, MPI_DATATYPE_NULL)),
-        _request(std::exchange(x._request, MPI_REQUEST_NULL)),
+        _datatype32(std::exchange(x._datatype32, MPI_DATATYPE_NULL)),
+        _request_fwd(std::exchange(x._request_fwd, MPI_REQUEST_NULL)),
+        _request_rev(std::exchange(x._request_rev, MPI_REQUEST_NULL)),
+        _request_fwd32(std::exchange(x._request_fwd32, MPI_REQUEST_NULL)),
+        _request_rev32(std::exchange(x._request_rev32, MPI_REQUEST_NULL)),
         _buffer_send_fwd(std::move(x._buffer_send_fwd)),
-        _buffer_recv_fwd(std::move(x._buffer_recv_fwd)), _x(std::move(x._x))
+        _buffer_recv_fwd(std::move(x._buffer_recv_fwd)),
+        _buffer_send_fwd32(std::move(x._buffer_send_fwd32)),
+        _buffer_recv_fwd32(std::move(x._buffer_recv_fwd32)),
+        _compress_scatter(x._compress_scatter), _x(std::move(x._x))
   {
   }
 
   /// Destructor
   ~Vector()
   {
+    // Free persistent scatter channels (inactive requests only; a
+    // completed scatter leaves the persistent request allocated)
+    if (_request_fwd != MPI_REQUEST_NULL)
+      MPI_Request_free(&_request_fwd);
+    if (_request_rev != MPI_REQUEST_NULL)
+      MPI_Request_free(&_request_rev);
+    if (_request_fwd32 != MPI_REQUEST_NULL)
+      MPI_Request_free(&_request_fwd32);
+    if (_request_rev32 != MPI_REQUEST_NULL)
+      MPI_Request_free(&_request_rev32);
     if (_bs != 1)
+    {
       MPI_Type_free(&_datatype);
+      MPI_Type_free(&_datatype32);
+    }
   }
 
   // Assignment operator (disabled)
@@ -71,6 +183,38 @@ public:
   /// Move Assignment operator
   Vector& operator=(Vector&& x) = default;
 
+  /// Assign a lazy vector expression, e.g. `w = a*x + b*y + c*z` (see
+  /// la::operator*). The expression is evaluated in a single streamed
+  /// loop over the array, including ghost entries.
+  template <class E,
+            typename = std::enable_if_t<expr::is_expression<E>::value>>
+  Vector& operator=(const E& e)
+  {
+    assert(e.size == _x.size());
+    for (std::size_t i = 0; i < _x.size(); ++i)
+      _x[i] = e[i];
+    return *this;
+  }
+
+  /// Enable or disable compressed ghost scatters. When enabled, values
+  /// are narrowed to `compressed_type` (e.g. float for a double vector)
+  /// when packed into the send buffers and widened on receive, halving
+  /// the number of bytes on the wire in scatter_fwd/scatter_rev. Only
+  /// available for double precision scalar types.
+  /// @param[in] compress Pack scatter buffers in reduced precision
+  void set_compressed_scatter(bool compress)
+  {
+    if (compress and std::is_same<compressed_type, T>::value)
+    {
+      throw std::runtime_error(
+          "Compressed scatter requires a double precision scalar type.");
+    }
+    _compress_scatter = compress;
+  }
+
+  /// True if ghost scatters pack data in reduced precision
+  bool compressed_scatter() const { return _compress_scatter; }
+
   /// Begin scatter of local data from owner to ghosts on other ranks
   /// @note Collective MPI operation
   void scatter_fwd_begin()
@@ -80,16 +224,35 @@ public:
     // Pack send buffer
     const std::vector<std::int32_t>& indices
         = _map->scatter_fwd_indices().array();
-    _buffer_send_fwd.resize(_bs * indices.size());
-    for (std::size_t i = 0; i < indices.size(); ++i)
+    if (!_compress_scatter)
     {
-      std::copy_n(std::next(_x.cbegin(), _bs * indices[i]), _bs,
-                  std::next(_buffer_send_fwd.begin(), _bs * i));
+      assert(_buffer_send_fwd.size() == _bs * indices.size());
+      for (std::size_t i = 0; i < indices.size(); ++i)
+      {
+        std::copy_n(std::next(_x.cbegin(), _bs * indices[i]), _bs,
+                    std::next(_buffer_send_fwd.begin(), _bs * i));
+      }
+
+      _map->scatter_fwd_start(xtl::span<const T>(_buffer_send_fwd), _datatype,
+                              _request_fwd, xtl::span<T>(_buffer_recv_fwd));
     }
+    else
+    {
+      // Pack in reduced precision
+      _buffer_send_fwd32.resize(_bs * indices.size());
+      for (std::size_t i = 0; i < indices.size(); ++i)
+      {
+        std::transform(std::next(_x.cbegin(), _bs * indices[i]),
+                       std::next(_x.cbegin(), _bs * indices[i] + _bs),
+                       std::next(_buffer_send_fwd32.begin(), _bs * i),
+                       [](T v) { return static_cast<compressed_type>(v); });
+      }
 
-    _buffer_recv_fwd.resize(_bs * _map->num_ghosts());
-    _map->scatter_fwd_begin(xtl::span<const T>(_buffer_send_fwd), _datatype,
-                            _request, xtl::span<T>(_buffer_recv_fwd));
+      _buffer_recv_fwd32.resize(_bs * _map->num_ghosts());
+      _map->scatter_fwd_start(
+          xtl::span<const compressed_type>(_buffer_send_fwd32), _datatype32,
+          _request_fwd32, xtl::span<compressed_type>(_buffer_recv_fwd32));
+    }
   }
 
   /// End scatter of local data from owner to ghosts on other ranks
@@ -99,16 +262,31 @@ public:
     assert(_map);
     const std::int32_t local_size = _bs * _map->size_local();
     xtl::span xremote(_x.data() + local_size, _map->num_ghosts() * _bs);
-    _map->scatter_fwd_end(_request);
 
     // Copy received data into ghost positions
     const std::vector<std::int32_t>& scatter_fwd_ghost_pos
         = _map->scatter_fwd_ghost_positions();
-    for (std::size_t i = 0; i < _map->num_ghosts(); ++i)
+    if (!_compress_scatter)
+    {
+      _map->scatter_fwd_wait(_request_fwd);
+      for (std::size_t i = 0; i < _map->num_ghosts(); ++i)
+      {
+        const int pos = scatter_fwd_ghost_pos[i];
+        std::copy_n(std::next(_buffer_recv_fwd.cbegin(), _bs * pos), _bs,
+                    std::next(xremote.begin(), _bs * i));
+      }
+    }
+    else
     {
-      const int pos = scatter_fwd_ghost_pos[i];
-      std::copy_n(std::next(_buffer_recv_fwd.cbegin(), _bs * pos), _bs,
-                  std::next(xremote.begin(), _bs * i));
+      _map->scatter_fwd_wait(_request_fwd32);
+      for (std::size_t i = 0; i < _map->num_ghosts(); ++i)
+      {
+        const int pos = scatter_fwd_ghost_pos[i];
+        std::transform(std::next(_buffer_recv_fwd32.cbegin(), _bs * pos),
+                       std::next(_buffer_recv_fwd32.cbegin(), _bs * pos + _bs),
+                       std::next(xremote.begin(), _bs * i),
+                       [](compressed_type v) { return static_cast<T>(v); });
+      }
     }
   }
 
@@ -130,30 +308,56 @@ public:
                                _map->num_ghosts() * _bs);
     const std::vector<std::int32_t>& scatter_fwd_ghost_pos
         = _map->scatter_fwd_ghost_positions();
-    _buffer_recv_fwd.resize(_bs * scatter_fwd_ghost_pos.size());
-    for (std::size_t i = 0; i < scatter_fwd_ghost_pos.size(); ++i)
+    if (!_compress_scatter)
     {
-      const int pos = scatter_fwd_ghost_pos[i];
-      std::copy_n(std::next(xremote.cbegin(), _bs * i), _bs,
-                  std::next(_buffer_recv_fwd.begin(), _bs * pos));
+      assert(_buffer_recv_fwd.size() == _bs * scatter_fwd_ghost_pos.size());
+      for (std::size_t i = 0; i < scatter_fwd_ghost_pos.size(); ++i)
+      {
+        const int pos = scatter_fwd_ghost_pos[i];
+        std::copy_n(std::next(xremote.cbegin(), _bs * i), _bs,
+                    std::next(_buffer_recv_fwd.begin(), _bs * pos));
+      }
+
+      _map->scatter_rev_start(xtl::span<const T>(_buffer_recv_fwd), _datatype,
+                              _request_rev, xtl::span<T>(_buffer_send_fwd));
     }
+    else
+    {
+      // Pack in reduced precision
+      _buffer_recv_fwd32.resize(_bs * scatter_fwd_ghost_pos.size());
+      for (std::size_t i = 0; i < scatter_fwd_ghost_pos.size(); ++i)
+      {
+        const int pos = scatter_fwd_ghost_pos[i];
+        std::transform(std::next(xremote.cbegin(), _bs * i),
+                       std::next(xremote.cbegin(), _bs * i + _bs),
+                       std::next(_buffer_recv_fwd32.begin(), _bs * pos),
+                       [](T v) { return static_cast<compressed_type>(v); });
+      }
 
-    // Resize receive buffer and begin scatter
-    _buffer_send_fwd.resize(_bs * _map->scatter_fwd_indices().array().size());
-    _map->scatter_rev_begin(xtl::span<const T>(_buffer_recv_fwd), _datatype,
-                            _request, xtl::span<T>(_buffer_send_fwd));
+      _buffer_send_fwd32.resize(_bs
+                                * _map->scatter_fwd_indices().array().size());
+      _map->scatter_rev_start(
+          xtl::span<const compressed_type>(_buffer_recv_fwd32), _datatype32,
+          _request_rev32, xtl::span<compressed_type>(_buffer_send_fwd32));
+    }
   }
 
   /// End scatter of ghost data to owner. This process may receive data
-  /// from more than one process, and the received data can be summed or
-  /// inserted into the local portion of the vector.
-  /// @param op The operation to perform when adding/setting received
-  /// values (add or insert)
+  /// from more than one process, and the received data can be summed,
+  /// inserted or combined by minimum/maximum into the local portion of
+  /// the vector.
+  /// @param op The operation applied to received values (insert, add,
+  /// min or max). The min and max modes require ordered (real) data.
   /// @note Collective MPI operation
   void scatter_rev_end(common::IndexMap::Mode op)
   {
+    ++_version;
+
     // Complete scatter
-    _map->scatter_rev_end(_request);
+    if (!_compress_scatter)
+      _map->scatter_rev_wait(_request_rev);
+    else
+      _map->scatter_rev_wait(_request_rev32);
 
     // Copy/accumulate into owned part of the vector
     const std::vector<std::int32_t>& shared_indices
@@ -163,22 +367,116 @@ public:
     case common::IndexMap::Mode::insert:
       for (std::size_t i = 0; i < shared_indices.size(); ++i)
       {
-        std::copy_n(std::next(_buffer_send_fwd.cbegin(), _bs * i), _bs,
-                    std::next(_x.begin(), _bs * shared_indices[i]));
+        if (!_compress_scatter)
+        {
+          std::copy_n(std::next(_buffer_send_fwd.cbegin(), _bs * i), _bs,
+                      std::next(_x.begin(), _bs * shared_indices[i]));
+        }
+        else
+        {
+          std::transform(std::next(_buffer_send_fwd32.cbegin(), _bs * i),
+                         std::next(_buffer_send_fwd32.cbegin(), _bs * i + _bs),
+                         std::next(_x.begin(), _bs * shared_indices[i]),
+                         [](compressed_type v) { return static_cast<T>(v); });
+        }
       }
       break;
     case common::IndexMap::Mode::add:
       for (std::size_t i = 0; i < shared_indices.size(); ++i)
+      {
         for (int j = 0; j < _bs; ++j)
-          _x[shared_indices[i] * _bs + j] += _buffer_send_fwd[i * _bs + j];
+        {
+          if (!_compress_scatter)
+            _x[shared_indices[i] * _bs + j] += _buffer_send_fwd[i * _bs + j];
+          else
+          {
+            _x[shared_indices[i] * _bs + j]
+                += static_cast<T>(_buffer_send_fwd32[i * _bs + j]);
+          }
+        }
+      }
+      break;
+    case common::IndexMap::Mode::min:
+      if constexpr (std::is_arithmetic<T>::value)
+      {
+        for (std::size_t i = 0; i < shared_indices.size(); ++i)
+        {
+          for (int j = 0; j < _bs; ++j)
+          {
+            T& u = _x[shared_indices[i] * _bs + j];
+            if (!_compress_scatter)
+              u = std::min(u, _buffer_send_fwd[i * _bs + j]);
+            else
+              u = std::min(u, static_cast<T>(_buffer_send_fwd32[i * _bs + j]));
+          }
+        }
+      }
+      else
+        throw std::runtime_error("Mode::min requires ordered data.");
+      break;
+    case common::IndexMap::Mode::max:
+      if constexpr (std::is_arithmetic<T>::value)
+      {
+        for (std::size_t i = 0; i < shared_indices.size(); ++i)
+        {
+          for (int j = 0; j < _bs; ++j)
+          {
+            T& u = _x[shared_indices[i] * _bs + j];
+            if (!_compress_scatter)
+              u = std::max(u, _buffer_send_fwd[i * _bs + j]);
+            else
+              u = std::max(u, static_cast<T>(_buffer_send_fwd32[i * _bs + j]));
+          }
+        }
+      }
+      else
+        throw std::runtime_error("Mode::max requires ordered data.");
       break;
     }
   }
 
+  /// End scatter of ghost data to owner, combining received values into
+  /// the local portion of the vector with a caller-supplied binary
+  /// operation
+  /// @param op Binary operation combining the current owned value
+  /// (first argument) with one received contribution (second argument),
+  /// applied once per contribution. The operation should be associative
+  /// and commutative since the order in which contributions arrive is
+  /// not defined.
+  /// @note Collective MPI operation
+  template <typename BinaryOp,
+            typename
+            = std::enable_if_t<std::is_invocable_r<T, BinaryOp, T, T>::value>>
+  void scatter_rev_end(BinaryOp op)
+  {
+    ++_version;
+
+    // Complete scatter
+    if (!_compress_scatter)
+      _map->scatter_rev_wait(_request_rev);
+    else
+      _map->scatter_rev_wait(_request_rev32);
+
+    // Combine received contributions into the owned part of the vector
+    const std::vector<std::int32_t>& shared_indices
+        = _map->scatter_fwd_indices().array();
+    for (std::size_t i = 0; i < shared_indices.size(); ++i)
+    {
+      for (int j = 0; j < _bs; ++j)
+      {
+        T& u = _x[shared_indices[i] * _bs + j];
+        if (!_compress_scatter)
+          u = op(u, _buffer_send_fwd[i * _bs + j]);
+        else
+          u = op(u, static_cast<T>(_buffer_send_fwd32[i * _bs + j]));
+      }
+    }
+  }
+
   /// Scatter ghost data to owner. This process may receive data from
   /// more than one process, and the received data can be summed or
   /// inserted into the local portion of the vector.
-  /// @param op IndexMap operation (add or insert)
+  /// @param op IndexMap operation (insert, add, min or max)
   /// @note Collective MPI operation
   void scatter_rev(dolfinx::common::IndexMap::Mode op)
   {
@@ -186,6 +484,21 @@ public:
     this->scatter_rev_end(op);
   }
 
+  /// Scatter ghost data to owner, combining received values into the
+  /// local portion of the vector with a caller-supplied binary
+  /// operation (see scatter_rev_end)
+  /// @param op Binary operation combining the current owned value with
+  /// one received contribution
+  /// @note Collective MPI operation
+  template <typename BinaryOp,
+            typename
+            = std::enable_if_t<std::is_invocable_r<T, BinaryOp, T, T>::value>>
+  void scatter_rev(BinaryOp op)
+  {
+    this->scatter_rev_begin();
+    this->scatter_rev_end(op);
+  }
+
   /// Compute the norm of the vector
   /// @note Collective MPI operation
   /// @param type Norm type (supported types are \f$L^2\f$ and \f$L^\infty\f$)
@@ -239,7 +552,20 @@ public:
   xtl::span<const T> array() const { return xtl::span<const T>(_x); }
 
   /// Get local part of the vector
-  xtl::span<T> mutable_array() { return xtl::span(_x); }
+  /// @note Requesting write access bumps the version counter, see
+  /// version()
+  xtl::span<T> mutable_array()
+  {
+    ++_version;
+    return xtl::span(_x);
+  }
+
+  /// Version counter for the vector values. The counter is incremented
+  /// whenever the values may have been modified through this class
+  /// (write access via mutable_array, or a reverse scatter), and can
+  /// be used to invalidate caches of data derived from the vector in
+  /// O(1), without comparing values.
+  std::size_t version() const noexcept { return _version; }
 
 private:
   // Map describing the data layout
@@ -248,10 +574,27 @@ private:
   // Block size
   int _bs;
 
-  // Data type and buffers for ghost scatters
+  // Version counter for the vector values (see version())
+  std::size_t _version = 0;
+
+  // Data type, persistent scatter channels and buffers for ghost
+  // scatters. The channel requests are bound to the buffers, so the
+  // buffers are sized once at construction and never reallocated.
   MPI_Datatype _datatype = MPI_DATATYPE_NULL;
-  MPI_Request _request = MPI_REQUEST_NULL;
-  std::vector<T> _buffer_send_fwd, _buffer_recv_fwd;
+  MPI_Datatype _datatype32 = MPI_DATATYPE_NULL;
+  MPI_Request _request_fwd = MPI_REQUEST_NULL;
+  MPI_Request _request_rev = MPI_REQUEST_NULL;
+  MPI_Request _request_fwd32 = MPI_REQUEST_NULL;
+  MPI_Request _request_rev32 = MPI_REQUEST_NULL;
+  std::vector<T, Allocator> _buffer_send_fwd, _buffer_recv_fwd;
+
+  // Reduced-precision buffers and mode flag for compressed scatters,
+  // see set_compressed_scatter
+  using Allocator32 = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<compressed_type>;
+  std::vector<compressed_type, Allocator32> _buffer_send_fwd32,
+      _buffer_recv_fwd32;
+  bool _compress_scatter = false;
 
   // Data
   std::vector<T, Allocator> _x;
@@ -292,4 +635,544 @@ T inner_product(const Vector<T, Allocator>& a, const Vector<T, Allocator>& b)
   return result;
 }
 
+/// Compute the inner product of a vector with each vector in a list,
+/// with a single combined MPI reduction. Squared norms can be fused
+/// with other products by including the vector itself in the list, e.g.
+/// `inner_product(r, {r, z})` returns `{||r||^2, r^H z}` with one
+/// reduction. All vectors must have the same parallel layout.
+/// @note Collective
+/// @param a A vector
+/// @param b List of vectors
+/// @return `a^{H} b[i]` for each vector in `b`
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+std::vector<T> inner_product(
+    const Vector<T, Allocator>& a,
+    const std::vector<std::reference_wrapper<const Vector<T, Allocator>>>& b)
+{
+  const std::int32_t local_size = a.bs() * a.map()->size_local();
+  xtl::span<const T> x_a = a.array();
+
+  // Accumulate all products in one pass over the data
+  std::vector<T> local(b.size(), 0);
+  std::vector<const T*> x_b(b.size());
+  for (std::size_t j = 0; j < b.size(); ++j)
+  {
+    const Vector<T, Allocator>& bj = b[j];
+    if (local_size != bj.bs() * bj.map()->size_local())
+      throw std::runtime_error("Incompatible vector sizes");
+    x_b[j] = bj.array().data();
+  }
+
+  for (std::int32_t i = 0; i < local_size; ++i)
+  {
+    T ai = x_a[i];
+    if constexpr (std::is_same<T, std::complex<double>>::value
+                  or std::is_same<T, std::complex<float>>::value)
+    {
+      ai = std::conj(ai);
+    }
+    for (std::size_t j = 0; j < b.size(); ++j)
+      local[j] += ai * x_b[j][i];
+  }
+
+  std::vector<T> result(b.size());
+  MPI_Allreduce(local.data(), result.data(), b.size(),
+                dolfinx::MPI::mpi_type<T>(), MPI_SUM, a.map()->comm());
+  return result;
+}
+
+/// Compute the inner product of each pair of vectors in a list with a
+/// single combined MPI reduction, e.g. for the simultaneous products
+/// required by block solvers. The local passes are fused into one
+/// sweep when all pairs share the first vector; otherwise each pair is
+/// reduced locally on its own. All vectors must be distributed over
+/// the same communicator.
+/// @note Collective
+/// @param[in] pairs List of vector pairs (a, b)
+/// @return `a^{H} b` (`a^{T} b` if the vectors are real) for each pair
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+std::vector<T> inner_products(
+    const std::vector<
+        std::pair<std::reference_wrapper<const Vector<T, Allocator>>,
+                  std::reference_wrapper<const Vector<T, Allocator>>>>& pairs)
+{
+  if (pairs.empty())
+    return {};
+
+  // If every pair shares the same first vector, reduce all products in
+  // a single pass over its data
+  const Vector<T, Allocator>& a = pairs.front().first;
+  if (std::all_of(pairs.begin(), pairs.end(),
+                  [&a](const auto& p) { return &p.first.get() == &a; }))
+  {
+    std::vector<std::reference_wrapper<const Vector<T, Allocator>>> b;
+    b.reserve(pairs.size());
+    for (const auto& p : pairs)
+      b.push_back(p.second);
+    return inner_product(a, b);
+  }
+
+  std::vector<T> local(pairs.size(), 0);
+  for (std::size_t j = 0; j < pairs.size(); ++j)
+  {
+    const Vector<T, Allocator>& aj = pairs[j].first;
+    const Vector<T, Allocator>& bj = pairs[j].second;
+    const std::int32_t local_size = aj.bs() * aj.map()->size_local();
+    if (local_size != bj.bs() * bj.map()->size_local())
+      throw std::runtime_error("Incompatible vector sizes");
+    xtl::span<const T> x_a = aj.array();
+    xtl::span<const T> x_b = bj.array();
+    local[j] = std::transform_reduce(
+        x_a.begin(), x_a.begin() + local_size, x_b.begin(), static_cast<T>(0),
+        std::plus<T>(),
+        [](T a, T b) -> T
+        {
+          if constexpr (std::is_same<T, std::complex<double>>::value
+                        or std::is_same<T, std::complex<float>>::value)
+          {
+            return std::conj(a) * b;
+          }
+          else
+            return a * b;
+        });
+  }
+
+  std::vector<T> result(pairs.size());
+  MPI_Allreduce(local.data(), result.data(), pairs.size(),
+                dolfinx::MPI::mpi_type<T>(), MPI_SUM,
+                pairs.front().first.get().map()->comm());
+  return result;
+}
+
+/// Compute the squared L2 norms of several vectors with a single
+/// combined MPI reduction, e.g. for per-field monitoring. All vectors
+/// must be distributed over the same communicator.
+/// @note Collective
+/// @param[in] x List of vectors
+/// @return The squared norm of each vector in @p x
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+std::vector<double> squared_norms(
+    const std::vector<std::reference_wrapper<const Vector<T, Allocator>>>& x)
+{
+  if (x.empty())
+    return {};
+
+  std::vector<double> local(x.size());
+  for (std::size_t j = 0; j < x.size(); ++j)
+  {
+    const Vector<T, Allocator>& xj = x[j];
+    const std::int32_t size_local = xj.bs() * xj.map()->size_local();
+    xtl::span<const T> _x = xj.array();
+    local[j] = std::transform_reduce(
+        _x.begin(), std::next(_x.begin(), size_local), 0.0,
+        std::plus<double>(), [](T val) { return std::norm(val); });
+  }
+
+  std::vector<double> result(x.size());
+  MPI_Allreduce(local.data(), result.data(), x.size(), MPI_DOUBLE, MPI_SUM,
+                x.front().get().map()->comm());
+  return result;
+}
+
+/// Compute the L2 norms of several vectors with a single combined MPI
+/// reduction, see squared_norms.
+/// @note Collective
+/// @param[in] x List of vectors
+/// @return The norm of each vector in @p x
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+std::vector<double>
+norms(const std::vector<std::reference_wrapper<const Vector<T, Allocator>>>& x)
+{
+  std::vector<double> n = squared_norms(x);
+  for (double& v : n)
+    v = std::sqrt(v);
+  return n;
+}
+
+/// Scatter the owned data of several vectors with the same parallel
+/// layout to their ghost positions with a single message per neighbor
+/// rank: the shared entries of all vectors are interleaved into one
+/// buffer and sent with an N-fold payload, so the per-message latency
+/// is paid once for the set rather than once per vector, e.g. for the
+/// per-field ghost updates of a coupled solver. All vectors must have
+/// the same IndexMap and block size. For vectors on different index
+/// maps see MergedScatter.
+/// @note Collective MPI operation
+/// @param[in,out] x Vectors to update
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+void scatter_fwd(
+    const std::vector<std::reference_wrapper<Vector<T, Allocator>>>& x)
+{
+  if (x.empty())
+    return;
+
+  std::shared_ptr<const common::IndexMap> map = x.front().get().map();
+  const int bs = x.front().get().bs();
+  const int nv = x.size();
+  const int n = nv * bs;
+  for (const Vector<T, Allocator>& xj : x)
+  {
+    if (xj.map() != map or xj.bs() != bs)
+      throw std::runtime_error("Vectors must have the same parallel layout");
+  }
+
+  // Pack the owned shared entries of all vectors, interleaved per
+  // index
+  const std::vector<std::int32_t>& indices
+      = map->scatter_fwd_indices().array();
+  std::vector<const T*> data(nv);
+  for (int j = 0; j < nv; ++j)
+    data[j] = x[j].get().array().data();
+  std::vector<T> send_buffer(n * indices.size());
+  for (std::size_t i = 0; i < indices.size(); ++i)
+  {
+    for (int j = 0; j < nv; ++j)
+    {
+      std::copy_n(data[j] + bs * indices[i], bs,
+                  std::next(send_buffer.begin(), n * i + bs * j));
+    }
+  }
+
+  MPI_Datatype data_type;
+  MPI_Type_contiguous(n, dolfinx::MPI::mpi_type<T>(), &data_type);
+  MPI_Type_commit(&data_type);
+  std::vector<T> recv_buffer(n * map->num_ghosts());
+  MPI_Request request;
+  map->scatter_fwd_begin(xtl::span<const T>(send_buffer), data_type, request,
+                         xtl::span<T>(recv_buffer));
+  map->scatter_fwd_end(request);
+  MPI_Type_free(&data_type);
+
+  // Unpack into the ghost entries of each vector
+  const std::vector<std::int32_t>& ghost_pos
+      = map->scatter_fwd_ghost_positions();
+  const std::int32_t local_size = bs * map->size_local();
+  for (int j = 0; j < nv; ++j)
+  {
+    xtl::span<T> xj = x[j].get().mutable_array();
+    for (std::int32_t i = 0; i < map->num_ghosts(); ++i)
+    {
+      std::copy_n(std::next(recv_buffer.cbegin(), n * ghost_pos[i] + bs * j),
+                  bs, std::next(xj.begin(), local_size + bs * i));
+    }
+  }
+}
+
+/// Scatter the ghost data of several vectors with the same parallel
+/// layout to their owners with a single message per neighbor rank,
+/// see the fused scatter_fwd. All vectors must have the same IndexMap
+/// and block size.
+/// @note Collective MPI operation
+/// @param[in,out] x Vectors to update
+/// @param[in] op The operation applied to received values (insert,
+/// add, min or max). The min and max modes require ordered (real)
+/// data.
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+void scatter_rev(
+    const std::vector<std::reference_wrapper<Vector<T, Allocator>>>& x,
+    common::IndexMap::Mode op)
+{
+  if (x.empty())
+    return;
+
+  std::shared_ptr<const common::IndexMap> map = x.front().get().map();
+  const int bs = x.front().get().bs();
+  const int nv = x.size();
+  const int n = nv * bs;
+  for (const Vector<T, Allocator>& xj : x)
+  {
+    if (xj.map() != map or xj.bs() != bs)
+      throw std::runtime_error("Vectors must have the same parallel layout");
+  }
+
+  // Pack the ghost entries of all vectors into wire order, interleaved
+  // per index
+  const std::vector<std::int32_t>& ghost_pos
+      = map->scatter_fwd_ghost_positions();
+  const std::int32_t local_size = bs * map->size_local();
+  std::vector<const T*> data(nv);
+  for (int j = 0; j < nv; ++j)
+    data[j] = x[j].get().array().data();
+  std::vector<T> send_buffer(n * map->num_ghosts());
+  for (std::int32_t i = 0; i < map->num_ghosts(); ++i)
+  {
+    for (int j = 0; j < nv; ++j)
+    {
+      std::copy_n(data[j] + local_size + bs * i, bs,
+                  std::next(send_buffer.begin(), n * ghost_pos[i] + bs * j));
+    }
+  }
+
+  const std::vector<std::int32_t>& indices
+      = map->scatter_fwd_indices().array();
+  MPI_Datatype data_type;
+  MPI_Type_contiguous(n, dolfinx::MPI::mpi_type<T>(), &data_type);
+  MPI_Type_commit(&data_type);
+  std::vector<T> recv_buffer(n * indices.size());
+  MPI_Request request;
+  map->scatter_rev_begin(xtl::span<const T>(send_buffer), data_type, request,
+                         xtl::span<T>(recv_buffer));
+  map->scatter_rev_wait(request);
+  MPI_Type_free(&data_type);
+
+  // Copy/accumulate into the owned part of each vector
+  std::vector<T*> wdata(nv);
+  for (int j = 0; j < nv; ++j)
+    wdata[j] = x[j].get().mutable_array().data();
+  switch (op)
+  {
+  case common::IndexMap::Mode::insert:
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+      for (int j = 0; j < nv; ++j)
+      {
+        std::copy_n(std::next(recv_buffer.cbegin(), n * i + bs * j), bs,
+                    wdata[j] + bs * indices[i]);
+      }
+    }
+    break;
+  case common::IndexMap::Mode::add:
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+      for (int j = 0; j < nv; ++j)
+      {
+        for (int k = 0; k < bs; ++k)
+          wdata[j][bs * indices[i] + k] += recv_buffer[n * i + bs * j + k];
+      }
+    }
+    break;
+  case common::IndexMap::Mode::min:
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+      for (std::size_t i = 0; i < indices.size(); ++i)
+      {
+        for (int j = 0; j < nv; ++j)
+        {
+          for (int k = 0; k < bs; ++k)
+          {
+            T& u = wdata[j][bs * indices[i] + k];
+            u = std::min(u, recv_buffer[n * i + bs * j + k]);
+          }
+        }
+      }
+    }
+    else
+      throw std::runtime_error("Mode::min requires ordered data.");
+    break;
+  case common::IndexMap::Mode::max:
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+      for (std::size_t i = 0; i < indices.size(); ++i)
+      {
+        for (int j = 0; j < nv; ++j)
+        {
+          for (int k = 0; k < bs; ++k)
+          {
+            T& u = wdata[j][bs * indices[i] + k];
+            u = std::max(u, recv_buffer[n * i + bs * j + k]);
+          }
+        }
+      }
+    }
+    else
+      throw std::runtime_error("Mode::max requires ordered data.");
+    break;
+  }
+}
+
+/// Handle for a pending split-phase reduction. The reduction is
+/// started with MPI_Iallreduce when the handle is created (by the
+/// `*_begin` functions below) and completed by get(), so pipelined
+/// Krylov methods can overlap the global reduction with operator
+/// application or preconditioning. The handle owns the communication
+/// buffers and is therefore not copyable or movable.
+template <typename T>
+class Reduction
+{
+public:
+  /// Start the element-wise reduction of local values over a
+  /// communicator
+  /// @param[in] local The local values to reduce
+  /// @param[in] op The MPI reduction operation
+  /// @param[in] comm The communicator to reduce over
+  Reduction(std::vector<T>&& local, MPI_Op op, MPI_Comm comm)
+      : _local(std::move(local)), _global(_local.size())
+  {
+    MPI_Iallreduce(_local.data(), _global.data(), _local.size(),
+                   dolfinx::MPI::mpi_type<T>(), op, comm, &_request);
+  }
+
+  // The MPI request holds pointers into this object
+  Reduction(const Reduction&) = delete;
+  Reduction& operator=(const Reduction&) = delete;
+
+  /// Destructor. Completes the reduction if still pending.
+  ~Reduction() { MPI_Wait(&_request, MPI_STATUS_IGNORE); }
+
+  /// Wait for the reduction and return the global values
+  const std::vector<T>& get()
+  {
+    MPI_Wait(&_request, MPI_STATUS_IGNORE);
+    return _global;
+  }
+
+private:
+  std::vector<T> _local, _global;
+  MPI_Request _request = MPI_REQUEST_NULL;
+};
+
+/// Start a non-blocking inner product of a vector with each vector in
+/// a list. The local pass is performed immediately and the global
+/// reduction is started; the returned handle completes it on get().
+/// Squared norms can be fused with other products by including the
+/// vector itself in the list, as for the blocking inner_product.
+/// @note Collective
+/// @param[in] a A vector
+/// @param[in] b List of vectors, each with the same layout as `a`
+/// @return Handle for the pending values `a^{H} b[i]`
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+Reduction<T> inner_product_begin(
+    const Vector<T, Allocator>& a,
+    const std::vector<std::reference_wrapper<const Vector<T, Allocator>>>& b)
+{
+  const std::int32_t local_size = a.bs() * a.map()->size_local();
+  xtl::span<const T> x_a = a.array();
+
+  // Accumulate all products in one pass over the data
+  std::vector<T> local(b.size(), 0);
+  std::vector<const T*> x_b(b.size());
+  for (std::size_t j = 0; j < b.size(); ++j)
+  {
+    const Vector<T, Allocator>& bj = b[j];
+    if (local_size != bj.bs() * bj.map()->size_local())
+      throw std::runtime_error("Incompatible vector sizes");
+    x_b[j] = bj.array().data();
+  }
+
+  for (std::int32_t i = 0; i < local_size; ++i)
+  {
+    T ai = x_a[i];
+    if constexpr (std::is_same<T, std::complex<double>>::value
+                  or std::is_same<T, std::complex<float>>::value)
+    {
+      ai = std::conj(ai);
+    }
+    for (std::size_t j = 0; j < b.size(); ++j)
+      local[j] += ai * x_b[j][i];
+  }
+
+  return Reduction<T>(std::move(local), MPI_SUM, a.map()->comm());
+}
+
+/// Start a non-blocking inner product of two vectors, see
+/// inner_product_begin for a list of vectors. The pending value is the
+/// single entry of the handle's result.
+/// @note Collective
+/// @param[in] a A vector
+/// @param[in] b A vector with the same layout as `a`
+/// @return Handle for the pending value `a^{H} b`
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+Reduction<T> inner_product_begin(const Vector<T, Allocator>& a,
+                                 const Vector<T, Allocator>& b)
+{
+  return inner_product_begin(
+      a, std::vector<std::reference_wrapper<const Vector<T, Allocator>>>{b});
+}
+
+/// Start a non-blocking reduction of the squared L2 norms of several
+/// vectors, see squared_norms. The returned handle completes the
+/// reduction on get().
+/// @note Collective
+/// @param[in] x List of vectors
+/// @return Handle for the pending squared norms
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+Reduction<double> squared_norm_begin(
+    const std::vector<std::reference_wrapper<const Vector<T, Allocator>>>& x)
+{
+  std::vector<double> local(x.size());
+  for (std::size_t j = 0; j < x.size(); ++j)
+  {
+    const Vector<T, Allocator>& xj = x[j];
+    const std::int32_t size_local = xj.bs() * xj.map()->size_local();
+    xtl::span<const T> _x = xj.array();
+    local[j] = std::transform_reduce(
+        _x.begin(), std::next(_x.begin(), size_local), 0.0,
+        std::plus<double>(), [](T val) { return std::norm(val); });
+  }
+
+  MPI_Comm comm = x.empty() ? MPI_COMM_SELF : x.front().get().map()->comm();
+  return Reduction<double>(std::move(local), MPI_SUM, comm);
+}
+
+/// Compute the fused update `w = a*x + b*y + c*z` in a single pass over
+/// the data (including ghost entries). All vectors must have the same
+/// parallel layout.
+/// @param[out] w The vector to assign to. May alias an input vector.
+/// @param[in] a Scalar factor for `x`
+/// @param[in] x A vector
+/// @param[in] b Scalar factor for `y`
+/// @param[in] y A vector
+/// @param[in] c Scalar factor for `z`
+/// @param[in] z A vector
+template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+void axpbypcz(Vector<T, Allocator>& w, T a, const Vector<T, Allocator>& x, T b,
+              const Vector<T, Allocator>& y, T c,
+              const Vector<T, Allocator>& z)
+{
+  xtl::span<T> x_w = w.mutable_array();
+  xtl::span<const T> x_x = x.array();
+  xtl::span<const T> x_y = y.array();
+  xtl::span<const T> x_z = z.array();
+  if (x_x.size() != x_w.size() or x_y.size() != x_w.size()
+      or x_z.size() != x_w.size())
+  {
+    throw std::runtime_error("Incompatible vector sizes");
+  }
+
+  for (std::size_t i = 0; i < x_w.size(); ++i)
+    x_w[i] = a * x_x[i] + b * x_y[i] + c * x_z[i];
+}
+
+/// Create the lazy scaled term `a * x` of a vector expression. Terms
+/// can be summed with la::operator+ and assigned to a Vector, e.g.
+/// `w = a*x + b*y + c*z`, which evaluates as a single streamed loop.
+/// @param a Scalar factor
+/// @param x A vector. Must be kept alive until the expression is
+/// assigned.
+template <typename T, class Allocator>
+expr::Scaled<T> operator*(T a, const Vector<T, Allocator>& x)
+{
+  return {a, x.array().data(), x.array().size()};
+}
+
+/// Lazy sum of two vector expressions
+template <class E0, class E1,
+          typename = std::enable_if_t<expr::is_expression<E0>::value
+                                      and expr::is_expression<E1>::value>>
+expr::Sum<E0, E1> operator+(const E0& e0, const E1& e1)
+{
+  assert(e0.size == e1.size);
+  return {e0, e1, e0.size};
+}
+
+/// Lazy sum of a vector expression and an (unscaled) vector
+template <class E0, typename T, class Allocator,
+          typename = std::enable_if_t<expr::is_expression<E0>::value>>
+expr::Sum<E0, expr::Scaled<T>> operator+(const E0& e0,
+                                         const Vector<T, Allocator>& x)
+{
+  assert(e0.size == x.array().size());
+  return {e0, {T(1), x.array().data(), x.array().size()}, e0.size};
+}
+
+/// Lazy sum of an (unscaled) vector and a vector expression
+template <class E1, typename T, class Allocator,
+          typename = std::enable_if_t<expr::is_expression<E1>::value>>
+expr::Sum<expr::Scaled<T>, E1> operator+(const Vector<T, Allocator>& x,
+                                         const E1& e1)
+{
+  assert(e1.size == x.array().size());
+  return {{T(1), x.array().data(), x.array().size()}, e1, e1.size};
+}
+
 } // namespace dolfinx::la
@@ -0,0 +1,17 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "VectorPool.h"
+
+using namespace dolfinx;
+
+//-----------------------------------------------------------------------------
+la::VectorPool& la::vector_pool()
+{
+  static VectorPool pool;
+  return pool;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,113 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Vector.h"
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/allocator.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <typeindex>
+#include <vector>
+
+namespace dolfinx::la
+{
+
+/// Pool of workspace vectors keyed by (index map, block size, scalar
+/// type). Krylov methods, Newton solvers and stepping codes need
+/// short-lived temporaries with the layout of the solution vector;
+/// constructing a la::Vector allocates the owned+ghost storage and the
+/// scatter buffers afresh and sets up the ghost communication
+/// channels. checkout() hands out a previously returned vector with
+/// the requested layout when one is available, so steady-state time
+/// stepping performs no vector allocations and re-uses the persistent
+/// scatter channels.
+///
+/// Checked-out vectors are returned automatically when the last
+/// shared_ptr to them is dropped. The values of a checked-out vector
+/// are unspecified (whatever the previous user left); callers must
+/// initialize it. Thread-safe.
+class VectorPool
+{
+public:
+  /// Create an empty pool
+  VectorPool() = default;
+
+  // Copy constructor (deleted)
+  VectorPool(const VectorPool&) = delete;
+
+  // Copy assignment (deleted)
+  VectorPool& operator=(const VectorPool&) = delete;
+
+  /// Borrow a vector with the given layout, re-using a returned vector
+  /// when one with the same (index map, block size, scalar type) is in
+  /// the pool and allocating otherwise. The vector is returned to the
+  /// pool when the last shared_ptr to it is dropped.
+  /// @param[in] map The index map of the vector
+  /// @param[in] bs The block size
+  /// @return A vector with the requested layout and unspecified values
+  template <typename T, class Allocator = common::AlignedPoolAllocator<T>>
+  std::shared_ptr<Vector<T, Allocator>>
+  checkout(const std::shared_ptr<const common::IndexMap>& map, int bs)
+  {
+    // The pooled vector keeps the index map alive, so keying on the
+    // address cannot alias a recycled map while entries for it exist
+    const std::tuple<const common::IndexMap*, int, std::type_index> key(
+        map.get(), bs, std::type_index(typeid(Vector<T, Allocator>)));
+
+    std::shared_ptr<Vector<T, Allocator>> v;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _free.find(key);
+      if (it != _free.end() and !it->second.empty())
+      {
+        v = std::static_pointer_cast<Vector<T, Allocator>>(
+            it->second.back());
+        it->second.pop_back();
+      }
+    }
+    if (!v)
+      v = std::make_shared<Vector<T, Allocator>>(map, bs);
+
+    // Hand out a pointer whose deleter returns the vector to the pool
+    // rather than destroying it
+    return std::shared_ptr<Vector<T, Allocator>>(
+        v.get(),
+        [this, key, v](Vector<T, Allocator>*) mutable
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _free[key].push_back(std::move(v));
+        });
+  }
+
+  /// Destroy all vectors currently in the pool, releasing their
+  /// storage and communication channels. Vectors checked out at the
+  /// time of the call are unaffected and are pooled again when
+  /// returned. Call before MPI is finalized if the pool outlives the
+  /// MPI subsystem (vectors hold MPI datatypes and channels).
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _free.clear();
+  }
+
+private:
+  // Serializes access to the free lists
+  std::mutex _mutex;
+
+  // Returned vectors by (index map, block size, vector type)
+  std::map<std::tuple<const common::IndexMap*, int, std::type_index>,
+           std::vector<std::shared_ptr<void>>>
+      _free;
+};
+
+/// The process-wide workspace vector pool, created on first use
+VectorPool& vector_pool();
+
+} // namespace dolfinx::la
@@ -22,17 +22,25 @@ VectorSpaceBasis::VectorSpaceBasis(
 //-----------------------------------------------------------------------------
 void VectorSpaceBasis::orthonormalize(double tol)
 {
+  std::vector<Vec> prev;
+  prev.reserve(_basis.size());
+  std::vector<PetscScalar> dots(_basis.size(), 0.0);
+
   // Loop over each vector in basis
   for (std::size_t i = 0; i < _basis.size(); ++i)
   {
     assert(_basis[i]);
-    // Orthogonalize vector i with respect to previously orthonormalized
-    // vectors
-    for (std::size_t j = 0; j < i; ++j)
+
+    // Orthogonalize vector i with respect to previously
+    // orthonormalized vectors. The projections onto all previous
+    // vectors are computed as one blocked reduction (a single MPI
+    // allreduce), followed by a blocked AXPY update.
+    if (i > 0)
     {
-      PetscScalar dot_ij = 0.0;
-      VecDot(_basis[i]->vec(), _basis[j]->vec(), &dot_ij);
-      VecAXPY(_basis[i]->vec(), -dot_ij, _basis[j]->vec());
+      VecMDot(_basis[i]->vec(), i, prev.data(), dots.data());
+      for (std::size_t j = 0; j < i; ++j)
+        dots[j] = -dots[j];
+      VecMAXPY(_basis[i]->vec(), i, dots.data(), prev.data());
     }
 
     // Normalise basis function
@@ -43,6 +51,8 @@ void VectorSpaceBasis::orthonormalize(double tol)
       throw std::runtime_error(
           "VectorSpaceBasis has linear dependency. Cannot orthogonalize.");
     }
+
+    prev.push_back(_basis[i]->vec());
   }
 }
 //-----------------------------------------------------------------------------
@@ -114,13 +124,24 @@ bool VectorSpaceBasis::in_nullspace(const Mat A, double tol) const
 //-----------------------------------------------------------------------------
 void VectorSpaceBasis::orthogonalize(PETScVector& x) const
 {
-  for (std::size_t i = 0; i < _basis.size(); i++)
+  if (_basis.empty())
+    return;
+
+  // Project onto all basis vectors with one blocked reduction (a
+  // single MPI allreduce) and one blocked AXPY update
+  std::vector<Vec> basis;
+  basis.reserve(_basis.size());
+  for (const auto& v : _basis)
   {
-    assert(_basis[i]);
-    PetscScalar dot = 0.0;
-    VecDot(_basis[i]->vec(), x.vec(), &dot);
-    VecAXPY(x.vec(), -dot, _basis[i]->vec());
+    assert(v);
+    basis.push_back(v->vec());
   }
+
+  std::vector<PetscScalar> dots(_basis.size(), 0.0);
+  VecMDot(x.vec(), basis.size(), basis.data(), dots.data());
+  for (PetscScalar& dot : dots)
+    dot = -dot;
+  VecMAXPY(x.vec(), basis.size(), dots.data(), basis.data());
 }
 //-----------------------------------------------------------------------------
 int VectorSpaceBasis::dim() const { return _basis.size(); }
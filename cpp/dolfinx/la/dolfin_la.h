@@ -11,11 +11,15 @@ namespace dolfinx
 
 // DOLFINx la interface
 
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/MergedScatter.h>
 #include <dolfinx/la/PETScKrylovSolver.h>
 #include <dolfinx/la/PETScMatrix.h>
 #include <dolfinx/la/PETScOperator.h>
 #include <dolfinx/la/PETScOptions.h>
 #include <dolfinx/la/PETScVector.h>
+#include <dolfinx/la/PolynomialSmoother.h>
 #include <dolfinx/la/SLEPcEigenSolver.h>
 #include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/VectorPool.h>
 #include <dolfinx/la/VectorSpaceBasis.h>
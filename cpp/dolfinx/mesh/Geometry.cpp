@@ -6,15 +6,35 @@
 
 #include "Geometry.h"
 #include "Topology.h"
+#include "cell_types.h"
+#include <basix/cell.h>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/memory.h>
 #include <dolfinx/common/sort.h>
 #include <dolfinx/fem/ElementDofLayout.h>
 #include <dolfinx/fem/dofmapbuilder.h>
 #include <dolfinx/graph/partition.h>
+#include <xtensor/xmath.hpp>
+#include <xtensor/xview.hpp>
 
 using namespace dolfinx;
 using namespace dolfinx::mesh;
 
+//-----------------------------------------------------------------------------
+Geometry::Geometry(
+    const std::shared_ptr<const common::IndexMap>& index_map,
+    graph::AdjacencyList<std::int32_t>&& dofmap,
+    const fem::CoordinateElement& element,
+    std::function<std::array<double, 3>(std::int64_t)> implicit_x, int dim,
+    std::vector<std::int64_t>&& input_global_indices)
+    : _dim(dim), _dofmap(std::move(dofmap)), _index_map(index_map),
+      _cmap(element), _implicit_x(std::move(implicit_x)),
+      _input_global_indices(std::move(input_global_indices))
+{
+  assert(_implicit_x);
+  if (_dim < 1 or _dim > 3)
+    throw std::runtime_error("Geometry dimension must be 1, 2 or 3");
+}
 //-----------------------------------------------------------------------------
 int Geometry::dim() const { return _dim; }
 //-----------------------------------------------------------------------------
@@ -23,22 +43,208 @@ const graph::AdjacencyList<std::int32_t>& Geometry::dofmap() const
   return _dofmap;
 }
 //-----------------------------------------------------------------------------
+graph::FixedDegreeAdjacencyList<std::int32_t> Geometry::dofmap_fixed() const
+{
+  return graph::FixedDegreeAdjacencyList<std::int32_t>(_dofmap);
+}
+//-----------------------------------------------------------------------------
 std::shared_ptr<const common::IndexMap> Geometry::index_map() const
 {
   return _index_map;
 }
 //-----------------------------------------------------------------------------
-xt::xtensor<double, 2>& Geometry::x() { return _x; }
+xt::xtensor<double, 2>& Geometry::x()
+{
+  // The caller may modify the coordinates: materialize an implicit
+  // geometry and drop the closed-form map (the mesh may deform), drop
+  // the cached alternative layouts so they are rebuilt from the
+  // updated data, and bump the version counter so consumers can detect
+  // stale derived data
+  materialize();
+  _implicit_x = nullptr;
+  _x_padded.clear();
+  for (std::vector<double>& component : _x_soa)
+    component.clear();
+  ++_version;
+  return _x;
+}
 //-----------------------------------------------------------------------------
-const xt::xtensor<double, 2>& Geometry::x() const { return _x; }
+std::size_t Geometry::version() const noexcept { return _version; }
+//-----------------------------------------------------------------------------
+const xt::xtensor<double, 2>& Geometry::x() const
+{
+  materialize();
+  return _x;
+}
+//-----------------------------------------------------------------------------
+bool Geometry::is_implicit() const
+{
+  return bool(_implicit_x) and _x.size() == 0;
+}
+//-----------------------------------------------------------------------------
+void Geometry::pack_x(const xtl::span<const std::int32_t>& nodes,
+                      const xtl::span<double>& coords) const
+{
+  assert(coords.size() == 3 * nodes.size());
+  if (_x.size() == 0 and _implicit_x)
+  {
+    // Synthesize the coordinates from the closed-form map
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      const std::array<double, 3> p
+          = _implicit_x(_input_global_indices[nodes[i]]);
+      std::copy(p.begin(), p.end(), std::next(coords.begin(), 3 * i));
+    }
+  }
+  else
+  {
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      for (std::size_t j = 0; j < 3; ++j)
+        coords[3 * i + j] = _x(nodes[i], j);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+void Geometry::materialize() const
+{
+  if (_x.size() > 0 or !_implicit_x)
+    return;
+
+  const std::size_t num_points = _input_global_indices.size();
+  _x = xt::xtensor<double, 2>({num_points, 3});
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    const std::array<double, 3> p = _implicit_x(_input_global_indices[i]);
+    for (std::size_t j = 0; j < 3; ++j)
+      _x(i, j) = p[j];
+  }
+
+  // The coordinate array is only now allocated (see create_geometry
+  // for the explicit case)
+  register_memory("Geometry", std::int64_t(sizeof(double)) * 3 * num_points);
+  common::advise_huge_pages(_x.data(), _x.size() * sizeof(double));
+}
+//-----------------------------------------------------------------------------
+const std::vector<double, common::AlignedPoolAllocator<double>>&
+Geometry::x_padded() const
+{
+  if (_x_padded.empty())
+  {
+    materialize();
+    const std::size_t num_points = _x.shape(0);
+    _x_padded.assign(4 * num_points, 0.0);
+    for (std::size_t i = 0; i < num_points; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        _x_padded[4 * i + j] = _x(i, j);
+  }
+  return _x_padded;
+}
+//-----------------------------------------------------------------------------
+const std::array<std::vector<double>, 3>& Geometry::x_soa() const
+{
+  if (_x_soa[0].empty())
+  {
+    materialize();
+    const std::size_t num_points = _x.shape(0);
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      _x_soa[j].resize(num_points);
+      for (std::size_t i = 0; i < num_points; ++i)
+        _x_soa[j][i] = _x(i, j);
+    }
+  }
+  return _x_soa;
+}
 //-----------------------------------------------------------------------------
 const fem::CoordinateElement& Geometry::cmap() const { return _cmap; }
 //-----------------------------------------------------------------------------
+void Geometry::classify_affine_cells(double tol)
+{
+  const std::int32_t num_cells = _dofmap.num_nodes();
+  _cell_is_affine.assign(num_cells, 1);
+  if (_cmap.is_affine())
+    return;
+
+  // Sample points: the reference cell vertices plus the cell midpoint.
+  // The geometry map of a cell is exactly affine iff its Jacobian is
+  // constant, and the Jacobian of a polynomial map that agrees at
+  // these samples only deviates in pathological (warped interior)
+  // cases.
+  const xt::xtensor<double, 2> vertices
+      = basix::cell::geometry(cell_type_to_basix_type(_cmap.cell_shape()));
+  const std::size_t tdim = vertices.shape(1);
+  const std::size_t num_points = vertices.shape(0) + 1;
+  xt::xtensor<double, 2> X = xt::zeros<double>({num_points, tdim});
+  for (std::size_t p = 0; p < vertices.shape(0); ++p)
+  {
+    for (std::size_t j = 0; j < tdim; ++j)
+    {
+      X(p, j) = vertices(p, j);
+      X(num_points - 1, j) += vertices(p, j) / vertices.shape(0);
+    }
+  }
+
+  // Tabulate the map derivatives at the sample points, once for all
+  // cells
+  xt::xtensor<double, 4> basis(_cmap.tabulate_shape(1, num_points));
+  _cmap.tabulate(1, X, basis);
+
+  materialize();
+  const std::size_t gdim = _dim;
+  const std::size_t num_dofs_g = _dofmap.num_links(0);
+  xt::xtensor<double, 2> coordinate_dofs({num_dofs_g, gdim});
+  xt::xtensor<double, 2> J0 = xt::zeros<double>({gdim, tdim});
+  xt::xtensor<double, 2> J = xt::zeros<double>({gdim, tdim});
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    auto x_dofs = _dofmap.links(c);
+    for (std::size_t i = 0; i < num_dofs_g; ++i)
+      for (std::size_t j = 0; j < gdim; ++j)
+        coordinate_dofs(i, j) = _x(x_dofs[i], j);
+
+    // Compare the Jacobian at each sample point against the one at
+    // vertex 0
+    auto dphi0 = xt::view(basis, xt::range(1, tdim + 1), 0, xt::all(), 0);
+    J0.fill(0);
+    fem::CoordinateElement::compute_jacobian(dphi0, coordinate_dofs, J0);
+    const double scale = xt::amax(xt::abs(J0))();
+    for (std::size_t p = 1; p < num_points; ++p)
+    {
+      auto dphi = xt::view(basis, xt::range(1, tdim + 1), p, xt::all(), 0);
+      J.fill(0);
+      fem::CoordinateElement::compute_jacobian(dphi, coordinate_dofs, J);
+      if (xt::amax(xt::abs(J - J0))() > tol * scale)
+      {
+        _cell_is_affine[c] = 0;
+        break;
+      }
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+const std::vector<std::uint8_t>& Geometry::cell_is_affine() const noexcept
+{
+  return _cell_is_affine;
+}
+//-----------------------------------------------------------------------------
 const std::vector<std::int64_t>& Geometry::input_global_indices() const
 {
   return _input_global_indices;
 }
 //-----------------------------------------------------------------------------
+void Geometry::compact()
+{
+  // Implicit coordinates are synthesized from the input global
+  // indices: switch to the explicit array before dropping them
+  materialize();
+  _implicit_x = nullptr;
+
+  register_memory("Geometry", -std::int64_t(sizeof(std::int64_t))
+                                  * _input_global_indices.size());
+  std::vector<std::int64_t>().swap(_input_global_indices);
+}
+//-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 mesh::Geometry mesh::create_geometry(
@@ -48,6 +254,24 @@ mesh::Geometry mesh::create_geometry(
     const xt::xtensor<double, 2>& x,
     const std::function<std::vector<int>(
         const graph::AdjacencyList<std::int32_t>&)>& reorder_fn)
+{
+  // Fetch node coordinates by global index from the distributed
+  // coordinate array
+  return create_geometry(
+      comm, topology, coordinate_element, cell_nodes,
+      [comm, &x](const xtl::span<const std::int64_t>& indices)
+      { return graph::build::distribute_data<double>(comm, indices, x); },
+      reorder_fn);
+}
+//-----------------------------------------------------------------------------
+mesh::Geometry mesh::create_geometry(
+    MPI_Comm comm, const Topology& topology,
+    const fem::CoordinateElement& coordinate_element,
+    const graph::AdjacencyList<std::int64_t>& cell_nodes,
+    const std::function<xt::xtensor<double, 2>(
+        const xtl::span<const std::int64_t>&)>& fetch_coords,
+    const std::function<std::vector<int>(
+        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn)
 {
   // TODO: make sure required entities are initialised, or extend
   // fem::build_dofmap_data
@@ -76,10 +300,9 @@ mesh::Geometry mesh::create_geometry(
   dolfinx::radix_sort(xtl::span(indices));
   indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
 
-  //  Fetch node coordinates by global index from other ranks. Order of
-  //  coords matches order of the indices in 'indices'
-  xt::xtensor<double, 2> coords
-      = graph::build::distribute_data<double>(comm, indices, x);
+  //  Fetch node coordinates by global index. Order of coords matches
+  //  order of the indices in 'indices'
+  xt::xtensor<double, 2> coords = fetch_coords(indices);
 
   // Compute local-to-global map from local indices in dofmap to the
   // corresponding global indices in cell_nodes
@@ -105,7 +328,74 @@ mesh::Geometry mesh::create_geometry(
   std::transform(l2l.cbegin(), l2l.cend(), igi.begin(),
                  [&indices](auto index) { return indices[index]; });
 
+  // Account for the geometry storage (coordinates are padded to 3D by
+  // the Geometry constructor)
+  register_memory("Geometry",
+                  std::int64_t(sizeof(double)) * 3 * xg.shape(0)
+                      + sizeof(std::int64_t) * igi.size()
+                      + sizeof(std::int32_t)
+                            * (dofmap.array().size()
+                               + dofmap.offsets().size()));
+
   return Geometry(dof_index_map, std::move(dofmap), coordinate_element,
                   std::move(xg), std::move(igi));
 }
 //-----------------------------------------------------------------------------
+mesh::Geometry mesh::create_geometry(
+    MPI_Comm comm, const Topology& topology,
+    const fem::CoordinateElement& coordinate_element,
+    const graph::AdjacencyList<std::int64_t>& cell_nodes,
+    const std::function<std::array<double, 3>(std::int64_t)>& implicit_x,
+    int dim,
+    const std::function<std::vector<int>(
+        const graph::AdjacencyList<std::int32_t>&)>& reorder_fn)
+{
+  //  Build 'geometry' dofmap on the topology
+  auto [_dof_index_map, bs, dofmap] = fem::build_dofmap_data(
+      comm, topology, coordinate_element.create_dof_layout(), reorder_fn);
+  auto dof_index_map
+      = std::make_shared<common::IndexMap>(std::move(_dof_index_map));
+
+  // If the mesh has higher order geometry, permute the dofmap
+  if (coordinate_element.needs_dof_permutations())
+  {
+    const int D = topology.dim();
+    const int num_cells = topology.connectivity(D, 0)->num_nodes();
+    const std::vector<std::uint32_t>& cell_info
+        = topology.get_cell_permutation_info();
+
+    for (std::int32_t cell = 0; cell < num_cells; ++cell)
+      coordinate_element.unpermute_dofs(dofmap.links(cell), cell_info[cell]);
+  }
+
+  // Build list of unique (global) node indices from adjacency list
+  // (geometry nodes)
+  std::vector<std::int64_t> indices = cell_nodes.array();
+  dolfinx::radix_sort(xtl::span(indices));
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+  // Compute local-to-global map from local indices in dofmap to the
+  // corresponding global indices in cell_nodes
+  std::vector l2g
+      = graph::build::compute_local_to_global_links(cell_nodes, dofmap);
+
+  // Compute local (dof) to local (position in indices) map
+  std::vector l2l = graph::build::compute_local_to_local(l2g, indices);
+
+  // Allocate space for input global indices and copy data
+  std::vector<std::int64_t> igi(indices.size());
+  std::transform(l2l.cbegin(), l2l.cend(), igi.begin(),
+                 [&indices](auto index) { return indices[index]; });
+
+  // No coordinate array is stored for an implicit geometry; only the
+  // dofmap and the input global indices are accounted for
+  register_memory("Geometry",
+                  std::int64_t(sizeof(std::int64_t)) * igi.size()
+                      + sizeof(std::int32_t)
+                            * (dofmap.array().size()
+                               + dofmap.offsets().size()));
+
+  return Geometry(dof_index_map, std::move(dofmap), coordinate_element,
+                  implicit_x, dim, std::move(igi));
+}
+//-----------------------------------------------------------------------------
@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <array>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/allocator.h>
+#include <dolfinx/common/memory.h>
 #include <dolfinx/fem/CoordinateElement.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <functional>
@@ -15,6 +18,7 @@
 #include <xtensor/xbuilder.hpp>
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xview.hpp>
+#include <xtl/xspan.hpp>
 
 namespace dolfinx::common
 {
@@ -25,6 +29,16 @@ namespace dolfinx::mesh
 {
 class Topology;
 
+/// Storage layouts for the mesh coordinate array. The row-major
+/// (num_points, 3) array is canonical; the alternative layouts are
+/// opt-in copies for kernels with layout-sensitive gather loops.
+enum class GeometryLayout
+{
+  interleaved, ///< Row-major (num_points, 3) array (the default)
+  padded,      ///< Rows padded to four doubles for aligned SIMD loads
+  soa          ///< Separate x/y/z streams (structure-of-arrays)
+};
+
 /// Geometry stores the geometry imposed on a mesh.
 
 class Geometry
@@ -56,8 +70,32 @@ public:
 
       std::swap(c, _x);
     }
+
+    // Large coordinate arrays benefit from huge-page backing (no-op
+    // unless enabled, see common::advise_huge_pages)
+    common::advise_huge_pages(_x.data(), _x.size() * sizeof(double));
   }
 
+  /// Constructor for an implicit (analytic) geometry, where the
+  /// coordinates of a point are a closed-form function of its input
+  /// global index, e.g. for generated structured meshes. No coordinate
+  /// array is stored; coordinates are synthesized on demand (see
+  /// pack_x), and the explicit array is materialized only when the
+  /// full array is requested via x().
+  /// @param[in] index_map Index map for the geometry dofs
+  /// @param[in] dofmap The geometry (point) dofmap
+  /// @param[in] element The coordinate element
+  /// @param[in] implicit_x Closed-form map from the input global index
+  /// of a point to its coordinates (always three components)
+  /// @param[in] dim The Euclidean dimension of the coordinates
+  /// @param[in] input_global_indices The input global index of each
+  /// point
+  Geometry(const std::shared_ptr<const common::IndexMap>& index_map,
+           graph::AdjacencyList<std::int32_t>&& dofmap,
+           const fem::CoordinateElement& element,
+           std::function<std::array<double, 3>(std::int64_t)> implicit_x,
+           int dim, std::vector<std::int64_t>&& input_global_indices);
+
   /// Copy constructor
   Geometry(const Geometry&) = default;
 
@@ -79,22 +117,111 @@ public:
   /// DOF map
   const graph::AdjacencyList<std::int32_t>& dofmap() const;
 
+  /// DOF map as a constant-stride view. The geometry dofmap has the
+  /// same number of nodes for every cell, so the offsets can be
+  /// computed rather than loaded (see
+  /// graph::FixedDegreeAdjacencyList). The view is valid for the
+  /// lifetime of this Geometry.
+  graph::FixedDegreeAdjacencyList<std::int32_t> dofmap_fixed() const;
+
   /// Index map
   std::shared_ptr<const common::IndexMap> index_map() const;
 
   /// Geometry degrees-of-freedom
+  /// @note Requesting write access invalidates the cached alternative
+  /// layouts (see x_padded and x_soa). For an implicit geometry the
+  /// coordinate array is materialized and the closed-form map is
+  /// dropped, since the mesh may deform.
   xt::xtensor<double, 2>& x();
 
-  /// Geometry degrees-of-freedom
+  /// Geometry degrees-of-freedom. For an implicit geometry the
+  /// coordinate array is materialized on first call.
   const xt::xtensor<double, 2>& x() const;
 
+  /// True if the geometry is implicit, i.e. coordinates are generated
+  /// on demand from a closed-form map and no coordinate array is held
+  bool is_implicit() const;
+
+  /// Pack the coordinates of a set of points into a caller-provided
+  /// buffer, three values per point. For an implicit geometry the
+  /// coordinates are synthesized directly into the buffer without
+  /// materializing the coordinate array; otherwise they are gathered
+  /// from x(). Assembly-style loops should prefer this over indexing
+  /// x() so that implicit geometries stay implicit.
+  /// @param[in] nodes Local indices of the points to pack
+  /// @param[in,out] coords Buffer of size `3 * nodes.size()` receiving
+  /// the coordinates
+  void pack_x(const xtl::span<const std::int32_t>& nodes,
+              const xtl::span<double>& coords) const;
+
+  /// Geometry degrees-of-freedom in a 4-padded row layout: point i
+  /// occupies entries [4 * i, 4 * i + 3), with the fourth entry zero.
+  /// The 32-byte rows in cache line-aligned storage permit aligned
+  /// SIMD loads in coordinate gather loops. Built lazily on first call
+  /// and cached until the coordinates are accessed for modification
+  /// via x().
+  const std::vector<double, common::AlignedPoolAllocator<double>>&
+  x_padded() const;
+
+  /// Geometry degrees-of-freedom as structure-of-arrays x/y/z streams.
+  /// Built lazily on first call and cached until the coordinates are
+  /// accessed for modification via x().
+  const std::array<std::vector<double>, 3>& x_soa() const;
+
+  /// Access the coordinates in the layout selected by a compile-time
+  /// tag, e.g. `geometry.x_data<GeometryLayout::padded>()`. This lets
+  /// kernels templated over GeometryLayout pick their storage without
+  /// run-time branching.
+  template <GeometryLayout Layout>
+  decltype(auto) x_data() const
+  {
+    if constexpr (Layout == GeometryLayout::padded)
+      return x_padded();
+    else if constexpr (Layout == GeometryLayout::soa)
+      return x_soa();
+    else
+      return x();
+  }
+
+  /// A version counter for the coordinates. It is incremented every
+  /// time write access to the coordinates is requested via x(), and
+  /// can be used to detect stale data derived from the geometry (e.g.
+  /// cached dof coordinates).
+  std::size_t version() const noexcept;
+
   /// The element that describes the geometry map
   /// @return The coordinate/geometry element
   const fem::CoordinateElement& cmap() const;
 
+  /// Classify each cell as exactly affine or curved. Imported
+  /// higher-order meshes are typically affine away from a thin curved
+  /// boundary layer, and the per-cell flags let evaluation and
+  /// assembly loops run the cheap constant-Jacobian variant on the
+  /// affine partition. A cell is classified affine when its geometry
+  /// map Jacobian is constant (to within @p tol, relative) across the
+  /// reference cell vertices and midpoint. When the coordinate
+  /// element itself is affine every cell is trivially affine.
+  /// @param[in] tol Relative tolerance on the Jacobian variation
+  void classify_affine_cells(double tol = 1e-8);
+
+  /// Per-cell affine flags computed by classify_affine_cells (flag[c]
+  /// is 1 if cell c is exactly affine). Empty if the classification
+  /// pass has not been run.
+  const std::vector<std::uint8_t>& cell_is_affine() const noexcept;
+
   /// Global user indices
   const std::vector<std::int64_t>& input_global_indices() const;
 
+  /// Drop the construction-time data of the geometry to reclaim
+  /// memory: the input global index of each node, which is needed only
+  /// while building the mesh and for output keyed on the input node
+  /// ordering (e.g. checkpoints). Such output must be written before
+  /// compacting; afterwards input_global_indices() returns an empty
+  /// array. An implicit geometry is materialized first, since the
+  /// closed-form coordinate map is keyed on the input indices. See
+  /// Mesh::compact.
+  void compact();
+
 private:
   // Geometric dimension
   int _dim;
@@ -108,11 +235,32 @@ private:
   // The coordinate element
   fem::CoordinateElement _cmap;
 
-  // Coordinates for all points stored as a contiguous array
-  xt::xtensor<double, 2> _x;
+  // Materialize _x from _implicit_x (no-op for explicit geometries and
+  // when already materialized)
+  void materialize() const;
+
+  // Coordinates for all points stored as a contiguous array. Empty for
+  // an implicit geometry until materialized (hence mutable)
+  mutable xt::xtensor<double, 2> _x;
+
+  // Closed-form map from input global point index to coordinates for
+  // implicit geometries (empty for explicit geometries)
+  std::function<std::array<double, 3>(std::int64_t)> _implicit_x;
+
+  // Version counter for _x (see version())
+  std::size_t _version = 0;
+
+  // Lazily built alternative layouts of _x (see x_padded and x_soa).
+  // Empty means not built.
+  mutable std::vector<double, common::AlignedPoolAllocator<double>> _x_padded;
+  mutable std::array<std::vector<double>, 3> _x_soa;
 
   // Global indices as provided on Geometry creation
   std::vector<std::int64_t> _input_global_indices;
+
+  // Per-cell affine flags (see classify_affine_cells). Empty until the
+  // classification pass is run.
+  std::vector<std::uint8_t> _cell_is_affine;
 };
 
 /// Build Geometry
@@ -126,4 +274,46 @@ create_geometry(MPI_Comm comm, const Topology& topology,
                     const graph::AdjacencyList<std::int32_t>&)>& reorder_fn
                 = nullptr);
 
+/// Build Geometry, fetching node coordinates through a callback rather
+/// than from a distributed coordinate array. The callback is passed
+/// the sorted global input indices of the geometry nodes required on
+/// this rank and must return their coordinates, one row per index, in
+/// the same order. This allows the coordinates to be read from file on
+/// demand (e.g. via HDF5 hyperslab selections), so that the full
+/// coordinate array is never redistributed or held in memory.
+mesh::Geometry
+create_geometry(MPI_Comm comm, const Topology& topology,
+                const fem::CoordinateElement& coordinate_element,
+                const graph::AdjacencyList<std::int64_t>& cells,
+                const std::function<xt::xtensor<double, 2>(
+                    const xtl::span<const std::int64_t>&)>& fetch_coords,
+                const std::function<std::vector<int>(
+                    const graph::AdjacencyList<std::int32_t>&)>& reorder_fn
+                = nullptr);
+
+/// Build an implicit Geometry, where the coordinates of a point are a
+/// closed-form function of its input global index (e.g. generated
+/// structured meshes). No coordinate array is built or communicated;
+/// coordinates are synthesized on demand (see Geometry::pack_x) and
+/// the explicit array is materialized only if requested via
+/// Geometry::x().
+/// @param[in] comm The MPI communicator
+/// @param[in] topology The mesh topology
+/// @param[in] coordinate_element The coordinate element
+/// @param[in] cells The global point indices for each cell
+/// @param[in] implicit_x Closed-form map from the input global index
+/// of a point to its coordinates (always three components)
+/// @param[in] dim The Euclidean dimension of the coordinates
+/// @param[in] reorder_fn The graph re-ordering function for the dofs
+mesh::Geometry
+create_geometry(MPI_Comm comm, const Topology& topology,
+                const fem::CoordinateElement& coordinate_element,
+                const graph::AdjacencyList<std::int64_t>& cells,
+                const std::function<std::array<double, 3>(std::int64_t)>&
+                    implicit_x,
+                int dim,
+                const std::function<std::vector<int>(
+                    const graph::AdjacencyList<std::int32_t>&)>& reorder_fn
+                = nullptr);
+
 } // namespace dolfinx::mesh
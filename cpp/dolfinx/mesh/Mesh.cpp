@@ -10,7 +10,9 @@
 #include "Topology.h"
 #include "topologycomputation.h"
 #include "utils.h"
+#include <algorithm>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/log.h>
 #include <dolfinx/common/utils.h>
 #include <dolfinx/fem/CoordinateElement.h>
 #include <dolfinx/graph/AdjacencyList.h>
@@ -18,6 +20,8 @@
 #include <dolfinx/graph/partition.h>
 #include <dolfinx/mesh/cell_types.h>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
 
 #include "graphbuild.h"
 
@@ -71,12 +75,54 @@ Mesh mesh::create_mesh(MPI_Comm comm,
           mesh::GhostMode)>(&mesh::partition_cells_graph));
 }
 //-----------------------------------------------------------------------------
+Mesh mesh::create_mesh(MPI_Comm comm,
+                       const graph::AdjacencyList<std::int64_t>& cells,
+                       const fem::CoordinateElement& element,
+                       const xt::xtensor<double, 2>& x,
+                       mesh::GhostMode ghost_mode, int num_ghost_layers)
+{
+  return create_mesh(
+      comm, cells, element, x, ghost_mode,
+      [num_ghost_layers](MPI_Comm comm, int nparts, int tdim,
+                         const graph::AdjacencyList<std::int64_t>& cells,
+                         mesh::GhostMode ghost_mode)
+      {
+        return mesh::partition_cells_graph(comm, nparts, tdim, cells,
+                                           ghost_mode, num_ghost_layers,
+                                           &graph::partition_graph);
+      });
+}
+//-----------------------------------------------------------------------------
 Mesh mesh::create_mesh(MPI_Comm comm,
                        const graph::AdjacencyList<std::int64_t>& cells,
                        const fem::CoordinateElement& element,
                        const xt::xtensor<double, 2>& x,
                        mesh::GhostMode ghost_mode,
                        const mesh::CellPartitionFunction& cell_partitioner)
+{
+  // Fetch node coordinates by global index from the distributed
+  // coordinate array
+  return create_mesh(
+      comm, cells, element,
+      [comm, &x](const xtl::span<const std::int64_t>& indices)
+      { return graph::build::distribute_data<double>(comm, indices, x); },
+      ghost_mode, cell_partitioner);
+}
+//-----------------------------------------------------------------------------
+namespace
+{
+/// Shared implementation of create_mesh: partition and distribute the
+/// cells, re-order them locally, build the topology, and delegate
+/// geometry construction to `make_geometry`, which is passed the
+/// topology and the cell-node connectivity restricted to the cells
+/// required by the ghost mode.
+template <typename MakeGeometry>
+Mesh create_mesh_impl(MPI_Comm comm,
+                      const graph::AdjacencyList<std::int64_t>& cells,
+                      const fem::CoordinateElement& element,
+                      mesh::GhostMode ghost_mode,
+                      const mesh::CellPartitionFunction& cell_partitioner,
+                      MakeGeometry&& make_geometry)
 {
   if (ghost_mode == mesh::GhostMode::shared_vertex)
     throw std::runtime_error("Ghost mode via vertex currently disabled.");
@@ -121,6 +167,149 @@ Mesh mesh::create_mesh(MPI_Comm comm,
 
   // Compute re-ordering of local dual graph
   std::vector<int> remap = graph::reorder_gps(g);
+  LOG(INFO) << "Cell reordering: local dual graph bandwidth reduced from "
+            << graph::bandwidth(g) << " to " << graph::bandwidth(g, remap);
+
+  // Create re-ordered cell lists
+  std::vector<std::int64_t> original_cell_index(original_cell_index0);
+  for (std::size_t i = 0; i < remap.size(); ++i)
+    original_cell_index[remap[i]] = original_cell_index0[i];
+  const graph::AdjacencyList<std::int64_t> cells_extracted
+      = reorder_list(cells_extracted0, remap);
+  const graph::AdjacencyList<std::int64_t> cell_nodes
+      = reorder_list(cell_nodes0, remap);
+
+  // Create cells and vertices with the ghosting requested. Input
+  // topology includes cells shared via facet, but ghosts will be
+  // removed later if not required by ghost_mode.
+  Topology topology
+      = mesh::create_topology(comm, cells_extracted, original_cell_index,
+                              ghost_owners, element.cell_shape(), ghost_mode);
+
+  // Create connectivity required to compute the Geometry (extra
+  // connectivities for higher-order geometries)
+  for (int e = 1; e < tdim; ++e)
+  {
+    if (dof_layout.num_entity_dofs(e) > 0)
+    {
+      auto [cell_entity, entity_vertex, index_map]
+          = mesh::compute_entities(comm, topology, e);
+      if (cell_entity)
+        topology.set_connectivity(cell_entity, tdim, e);
+      if (entity_vertex)
+        topology.set_connectivity(entity_vertex, e, 0);
+      if (index_map)
+        topology.set_index_map(e, index_map);
+    }
+  }
+
+  const int n_cells_local = topology.index_map(tdim)->size_local()
+                            + topology.index_map(tdim)->num_ghosts();
+
+  // Remove ghost cells from geometry data, if not required
+  std::vector<std::int32_t> off1(
+      cell_nodes.offsets().begin(),
+      std::next(cell_nodes.offsets().begin(), n_cells_local + 1));
+  std::vector<std::int64_t> data1(
+      cell_nodes.array().begin(),
+      std::next(cell_nodes.array().begin(), off1[n_cells_local]));
+  graph::AdjacencyList<std::int64_t> cell_nodes1(std::move(data1),
+                                                 std::move(off1));
+  if (element.needs_dof_permutations())
+    topology.create_entity_permutations();
+
+  return Mesh(comm, std::move(topology),
+              make_geometry(topology, cell_nodes1));
+}
+} // namespace
+//-----------------------------------------------------------------------------
+Mesh mesh::create_mesh(MPI_Comm comm,
+                       const graph::AdjacencyList<std::int64_t>& cells,
+                       const fem::CoordinateElement& element,
+                       const std::function<xt::xtensor<double, 2>(
+                           const xtl::span<const std::int64_t>&)>& fetch_coords,
+                       mesh::GhostMode ghost_mode,
+                       const mesh::CellPartitionFunction& cell_partitioner)
+{
+  return create_mesh_impl(
+      comm, cells, element, ghost_mode, cell_partitioner,
+      [&](const Topology& topology,
+          const graph::AdjacencyList<std::int64_t>& cell_nodes)
+      {
+        return mesh::create_geometry(comm, topology, element, cell_nodes,
+                                     fetch_coords);
+      });
+}
+//-----------------------------------------------------------------------------
+Mesh mesh::create_mesh(MPI_Comm comm,
+                       const graph::AdjacencyList<std::int64_t>& cells,
+                       const fem::CoordinateElement& element,
+                       const std::function<std::array<double, 3>(std::int64_t)>&
+                           implicit_x,
+                       int gdim, mesh::GhostMode ghost_mode,
+                       const mesh::CellPartitionFunction& cell_partitioner)
+{
+  return create_mesh_impl(
+      comm, cells, element, ghost_mode, cell_partitioner,
+      [&](const Topology& topology,
+          const graph::AdjacencyList<std::int64_t>& cell_nodes)
+      {
+        return mesh::create_geometry(comm, topology, element, cell_nodes,
+                                     implicit_x, gdim);
+      });
+}
+//-----------------------------------------------------------------------------
+Mesh mesh::create_mesh(MPI_Comm comm,
+                       graph::AdjacencyList<std::int64_t>&& cells,
+                       const fem::CoordinateElement& element,
+                       const xt::xtensor<double, 2>& x,
+                       mesh::GhostMode ghost_mode)
+{
+  if (ghost_mode == mesh::GhostMode::shared_vertex)
+    throw std::runtime_error("Ghost mode via vertex currently disabled.");
+
+  const fem::ElementDofLayout dof_layout = element.create_dof_layout();
+
+  // Extract topology data, e.g. just the vertices. See the
+  // CellPartitionFunction overload for details.
+  const graph::AdjacencyList<std::int64_t> cells_topology
+      = mesh::extract_topology(element.cell_shape(), dof_layout, cells);
+
+  // Compute the destination rank for cells on this process via graph
+  // partitioning. Always get the ghost cells via facet, though these
+  // may be discarded later.
+  const int size = dolfinx::MPI::size(comm);
+  const int tdim = mesh::cell_dim(element.cell_shape());
+  const graph::AdjacencyList<std::int32_t> dest = mesh::partition_cells_graph(
+      comm, size, tdim, cells_topology, GhostMode::shared_facet);
+
+  // Distribute cells to destination rank
+  auto [cell_nodes0, src, original_cell_index0, ghost_owners]
+      = graph::build::distribute(comm, cells, dest);
+
+  // The input cell data has been redistributed; release the buffers to
+  // reduce the peak memory use during the remainder of the build
+  cells = graph::AdjacencyList<std::int64_t>(0);
+
+  // Extract cell 'topology', i.e. the vertices for each cell
+  const graph::AdjacencyList<std::int64_t> cells_extracted0
+      = mesh::extract_topology(element.cell_shape(), dof_layout, cell_nodes0);
+
+  // Build local dual graph for owned cells to apply re-ordering to
+  const std::int32_t num_owned_cells
+      = cells_extracted0.num_nodes() - ghost_owners.size();
+  const auto [g, m] = mesh::build_local_dual_graph(
+      xtl::span<const std::int64_t>(
+          cells_extracted0.array().data(),
+          cells_extracted0.offsets()[num_owned_cells]),
+      xtl::span<const std::int32_t>(cells_extracted0.offsets().data(),
+                                    num_owned_cells + 1),
+      tdim);
+
+  // Compute re-ordering of local dual graph
+  std::vector<int> remap = graph::reorder_gps(g);
+  LOG(INFO) << "Cell reordering: local dual graph bandwidth reduced from "
+            << graph::bandwidth(g) << " to " << graph::bandwidth(g, remap);
 
   // Create re-ordered cell lists
   std::vector<std::int64_t> original_cell_index(original_cell_index0);
@@ -131,6 +320,9 @@ Mesh mesh::create_mesh(MPI_Comm comm,
   const graph::AdjacencyList<std::int64_t> cell_nodes
       = reorder_list(cell_nodes0, remap);
 
+  // Release the pre-reordering cell arrays
+  cell_nodes0 = graph::AdjacencyList<std::int64_t>(0);
+
   // Create cells and vertices with the ghosting requested. Input
   // topology includes cells shared via facet, but ghosts will be
   // removed later if not required by ghost_mode.
@@ -174,6 +366,158 @@ Mesh mesh::create_mesh(MPI_Comm comm,
               mesh::create_geometry(comm, topology, element, cell_nodes1, x));
 }
 //-----------------------------------------------------------------------------
+mesh::CellPartitionFunction
+mesh::cell_partitioner_from_file(const std::string& filename)
+{
+  return [filename](MPI_Comm comm, int /*nparts*/, int /*tdim*/,
+                    const graph::AdjacencyList<std::int64_t>& cells,
+                    mesh::GhostMode /*ghost_mode*/)
+  {
+    graph::AdjacencyList<std::int32_t> dest
+        = graph::build::read_destinations(comm, filename);
+    if (dest.num_nodes() != cells.num_nodes())
+    {
+      throw std::runtime_error(
+          "Saved partition in '" + filename + "' does not match the input "
+          + "cells: expected " + std::to_string(cells.num_nodes())
+          + " cells, file has " + std::to_string(dest.num_nodes()) + ".");
+    }
+    return dest;
+  };
+}
+//-----------------------------------------------------------------------------
+mesh::CellPartitionFunction
+mesh::weighted_cell_partitioner(std::vector<std::int32_t> cell_weights,
+                                const graph::partition_fn_weighted& partfn)
+{
+  return [cell_weights = std::move(cell_weights),
+          partfn](MPI_Comm comm, int nparts, int tdim,
+                  const graph::AdjacencyList<std::int64_t>& cells,
+                  mesh::GhostMode ghost_mode)
+  {
+    return mesh::partition_cells_graph(comm, nparts, tdim, cells, ghost_mode,
+                                       cell_weights, partfn);
+  };
+}
+//-----------------------------------------------------------------------------
+mesh::CellPartitionFunction
+mesh::subcomm_cell_partitioner(int num_compute_ranks, int num_dest_ranks,
+                               const graph::partition_fn& partfn)
+{
+  if (num_compute_ranks < 1)
+    throw std::runtime_error("Number of compute ranks must be at least 1.");
+  if (num_dest_ranks < 0)
+    throw std::runtime_error("Number of destination ranks cannot be negative.");
+
+  return [num_compute_ranks, num_dest_ranks,
+          partfn](MPI_Comm comm, int nparts, int tdim,
+                  const graph::AdjacencyList<std::int64_t>& cells,
+                  mesh::GhostMode ghost_mode)
+  {
+    const int size = dolfinx::MPI::size(comm);
+    const int rank = dolfinx::MPI::rank(comm);
+    const int parts
+        = num_dest_ranks > 0 ? std::min(num_dest_ranks, nparts) : nparts;
+
+    // Nothing to shrink: partition on the full communicator
+    if (num_compute_ranks >= size)
+    {
+      return mesh::partition_cells_graph(comm, parts, tdim, cells, ghost_mode,
+                                         partfn);
+    }
+
+    // Split the ranks into num_compute_ranks contiguous groups; the
+    // lowest rank of each group is a compute rank. Grouping in rank
+    // order keeps the gathered cells in rank order, so the implicit
+    // contiguous global cell numbering is unchanged.
+    const int group
+        = static_cast<int>(std::int64_t(rank) * num_compute_ranks / size);
+    MPI_Comm group_comm;
+    MPI_Comm_split(comm, group, rank, &group_comm);
+    const bool compute_rank = dolfinx::MPI::rank(group_comm) == 0;
+    MPI_Comm sub_comm;
+    MPI_Comm_split(comm, compute_rank ? 0 : MPI_UNDEFINED, rank, &sub_comm);
+
+    // Gather the cells of each group on its compute rank
+    const int group_size = dolfinx::MPI::size(group_comm);
+    const int num_cells = cells.num_nodes();
+    std::vector<int> cell_counts(group_size);
+    MPI_Gather(&num_cells, 1, MPI_INT, cell_counts.data(), 1, MPI_INT, 0,
+               group_comm);
+    std::vector<int> cell_disp(group_size + 1, 0);
+    std::partial_sum(cell_counts.begin(), cell_counts.end(),
+                     std::next(cell_disp.begin()));
+
+    std::vector<std::int32_t> row_sizes(num_cells);
+    for (int c = 0; c < num_cells; ++c)
+      row_sizes[c] = cells.num_links(c);
+    std::vector<std::int32_t> all_row_sizes(cell_disp.back());
+    MPI_Gatherv(row_sizes.data(), num_cells, MPI_INT32_T, all_row_sizes.data(),
+                cell_counts.data(), cell_disp.data(), MPI_INT32_T, 0,
+                group_comm);
+
+    const int array_size = cells.array().size();
+    std::vector<int> array_counts(group_size);
+    MPI_Gather(&array_size, 1, MPI_INT, array_counts.data(), 1, MPI_INT, 0,
+               group_comm);
+    std::vector<int> array_disp(group_size + 1, 0);
+    std::partial_sum(array_counts.begin(), array_counts.end(),
+                     std::next(array_disp.begin()));
+    std::vector<std::int64_t> all_array(array_disp.back());
+    MPI_Gatherv(cells.array().data(), array_size, MPI_INT64_T,
+                all_array.data(), array_counts.data(), array_disp.data(),
+                MPI_INT64_T, 0, group_comm);
+
+    // Partition the gathered cells on the compute ranks
+    std::vector<std::int32_t> all_dest_sizes;
+    std::vector<std::int32_t> all_dest_array;
+    std::vector<int> dest_counts(group_size, 0), dest_disp(group_size + 1, 0);
+    if (compute_rank)
+    {
+      std::vector<std::int32_t> offsets(all_row_sizes.size() + 1, 0);
+      std::partial_sum(all_row_sizes.begin(), all_row_sizes.end(),
+                       std::next(offsets.begin()));
+      const graph::AdjacencyList<std::int32_t> dest
+          = mesh::partition_cells_graph(
+              sub_comm, parts, tdim,
+              graph::AdjacencyList<std::int64_t>(std::move(all_array),
+                                                 std::move(offsets)),
+              ghost_mode, partfn);
+      MPI_Comm_free(&sub_comm);
+
+      all_dest_sizes.resize(dest.num_nodes());
+      for (int c = 0; c < dest.num_nodes(); ++c)
+        all_dest_sizes[c] = dest.num_links(c);
+      all_dest_array.assign(dest.array().begin(), dest.array().end());
+      for (int r = 0; r < group_size; ++r)
+      {
+        dest_counts[r] = std::accumulate(
+            std::next(all_dest_sizes.begin(), cell_disp[r]),
+            std::next(all_dest_sizes.begin(), cell_disp[r + 1]), 0);
+      }
+      std::partial_sum(dest_counts.begin(), dest_counts.end(),
+                       std::next(dest_disp.begin()));
+    }
+
+    // Scatter the destination rows back to the contributing ranks
+    std::vector<std::int32_t> dest_sizes(num_cells);
+    MPI_Scatterv(all_dest_sizes.data(), cell_counts.data(), cell_disp.data(),
+                 MPI_INT32_T, dest_sizes.data(), num_cells, MPI_INT32_T, 0,
+                 group_comm);
+    std::vector<std::int32_t> dest_offsets(num_cells + 1, 0);
+    std::partial_sum(dest_sizes.begin(), dest_sizes.end(),
+                     std::next(dest_offsets.begin()));
+    std::vector<std::int32_t> dest_array(dest_offsets.back());
+    MPI_Scatterv(all_dest_array.data(), dest_counts.data(), dest_disp.data(),
+                 MPI_INT32_T, dest_array.data(), dest_offsets.back(),
+                 MPI_INT32_T, 0, group_comm);
+    MPI_Comm_free(&group_comm);
+
+    return graph::AdjacencyList<std::int32_t>(std::move(dest_array),
+                                              std::move(dest_offsets));
+  };
+}
+//-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 Topology& Mesh::topology() { return _topology; }
@@ -188,3 +532,9 @@ const Geometry& Mesh::geometry() const { return _geometry; }
 //-----------------------------------------------------------------------------
 MPI_Comm Mesh::mpi_comm() const { return _mpi_comm.comm(); }
 //-----------------------------------------------------------------------------
+void Mesh::compact()
+{
+  _topology.compact();
+  _geometry.compact();
+}
+//-----------------------------------------------------------------------------
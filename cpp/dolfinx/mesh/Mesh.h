@@ -10,6 +10,7 @@
 #include "Topology.h"
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/UniqueIdGenerator.h>
+#include <dolfinx/graph/partition.h>
 #include <string>
 #include <utility>
 
@@ -111,6 +112,17 @@ public:
   /// @return The communicator on which the mesh is distributed
   MPI_Comm mpi_comm() const;
 
+  /// Discard construction-only data held by the mesh to reclaim
+  /// memory: the cached intermediate topology connectivities
+  /// (everything except the cell-vertex and vertex connectivity, see
+  /// Topology::compact) and the input global indices of the geometry
+  /// nodes (see Geometry::compact). Discarded connectivities are
+  /// recomputed lazily if an algorithm requests them again, e.g.
+  /// facet-cell connectivity by facet integrals. The input indices are
+  /// not recoverable: checkpoints and other output keyed on the input
+  /// node ordering must be written before compacting.
+  void compact();
+
   /// Name
   std::string name = "mesh";
 
@@ -152,10 +164,131 @@ Mesh create_mesh(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& cells,
                  const fem::CoordinateElement& element,
                  const xt::xtensor<double, 2>& x, GhostMode ghost_mode);
 
+/// Create a mesh using the default partitioner with a ghost overlap of
+/// @p num_ghost_layers layers of cells, e.g. for overlapping-Schwarz
+/// preconditioners or wide (stencil) discretisations. The first layer
+/// comes from the partitioner; deeper layers are added by iterating
+/// the ghost-growth exchange on the dual graph. The resulting
+/// IndexMaps are consistent across the full overlap.
+Mesh create_mesh(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& cells,
+                 const fem::CoordinateElement& element,
+                 const xt::xtensor<double, 2>& x, GhostMode ghost_mode,
+                 int num_ghost_layers);
+
 /// Create a mesh using a provided mesh partitioning function
 Mesh create_mesh(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& cells,
                  const fem::CoordinateElement& element,
                  const xt::xtensor<double, 2>& x, GhostMode ghost_mode,
                  const CellPartitionFunction& cell_partitioner);
 
+/// Create a mesh using a provided mesh partitioning function, fetching
+/// the node coordinates through a callback rather than from a
+/// distributed coordinate array. The callback is passed the sorted
+/// global input indices of the geometry nodes required on this rank
+/// (the nodes of its owned and ghost cells, after partitioning) and
+/// must return their coordinates in the same order; see
+/// create_geometry. Used for streaming mesh input, where each rank
+/// reads only its own coordinate rows from file and no rank ever
+/// holds or redistributes the full coordinate array.
+Mesh create_mesh(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& cells,
+                 const fem::CoordinateElement& element,
+                 const std::function<xt::xtensor<double, 2>(
+                     const xtl::span<const std::int64_t>&)>& fetch_coords,
+                 GhostMode ghost_mode,
+                 const CellPartitionFunction& cell_partitioner);
+
+/// Create a mesh with an implicit (analytic) geometry, where the
+/// coordinates of a node are a closed-form function of its input
+/// global index, e.g. for generated structured meshes. No coordinate
+/// array is built, stored or communicated; see create_geometry and
+/// Geometry::pack_x.
+/// @param[in] comm The MPI communicator to build the mesh on
+/// @param[in] cells The cells on the this MPI rank (global node
+/// indices)
+/// @param[in] element The coordinate element that describes the
+/// geometric mapping for cells
+/// @param[in] implicit_x Closed-form map from the input global index
+/// of a node to its coordinates (always three components)
+/// @param[in] gdim The Euclidean dimension of the coordinates
+/// @param[in] ghost_mode The requested type of cell ghosting/overlap
+/// @param[in] cell_partitioner The cell partitioning function
+/// @return A distributed Mesh with implicit geometry
+Mesh create_mesh(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& cells,
+                 const fem::CoordinateElement& element,
+                 const std::function<std::array<double, 3>(std::int64_t)>&
+                     implicit_x,
+                 int gdim, GhostMode ghost_mode,
+                 const CellPartitionFunction& cell_partitioner);
+
+/// Create a cell partitioning function that returns destination ranks
+/// previously saved with graph::build::write_destinations, skipping
+/// dual graph construction and graph partitioning entirely. The saved
+/// partition must have been computed with the same number of ranks,
+/// the same input cell distribution and the same ghost mode as the
+/// current run, e.g. by saving the result of partition_cells_graph
+/// from an earlier run of the same problem.
+///
+/// @param[in] filename Name of the file holding the saved partition
+/// @return A cell partitioning function for use with create_mesh
+CellPartitionFunction cell_partitioner_from_file(const std::string& filename);
+
+/// Create a cell partitioning function that runs the dual graph build
+/// and the graph partitioning on a sub-communicator of
+/// @p num_compute_ranks ranks, e.g. for coarse meshes (multigrid
+/// levels, parameter pre-studies) on large jobs, where engaging every
+/// rank in the partitioning collectives costs more than the work on
+/// the coarse mesh itself. The cells of each contiguous group of ranks
+/// are gathered on one compute rank, the partition is computed on the
+/// sub-communicator of the compute ranks, and the destinations are
+/// scattered back to the contributing ranks, so the result has the
+/// same form as a partition computed on the full communicator.
+///
+/// With @p num_dest_ranks > 0 the cells are in addition distributed to
+/// only the first @p num_dest_ranks ranks, creating a mesh that lives
+/// entirely on those ranks. The remaining ranks hold an empty mesh
+/// (zero-size index maps) but must still make the collective
+/// create_mesh call.
+///
+/// @param[in] num_compute_ranks Number of ranks the dual graph build
+/// and the graph partitioning run on
+/// @param[in] num_dest_ranks Number of ranks the cells are distributed
+/// to. Pass 0 to distribute to all ranks of the communicator.
+/// @param[in] partfn Graph partitioner applied to the dual graph
+/// @return A cell partitioning function for use with create_mesh
+CellPartitionFunction
+subcomm_cell_partitioner(int num_compute_ranks, int num_dest_ranks = 0,
+                         const graph::partition_fn& partfn
+                         = &graph::partition_graph);
+
+/// Create a cell partitioning function that balances per-cell
+/// computational weights, e.g. when cheap and expensive cell
+/// discretisations are mixed in one mesh and an equal-cell-count
+/// partition would be load-imbalanced. The weights are attached to the
+/// nodes of the dual graph of the mesh and passed to a weighted graph
+/// partitioner. For multi-constraint balancing (e.g. a memory and a
+/// flop estimate per cell) pass `ncon` weights per cell, row-major;
+/// support for `ncon > 1` depends on the partitioner.
+///
+/// @param[in] cell_weights Computational weight(s) for each cell on
+/// this rank, ordered as the cells passed to create_mesh
+/// @param[in] partfn Weighted graph partitioner applied to the dual
+/// graph. Defaults to the default weighted graph partitioner.
+/// @return A cell partitioning function for use with create_mesh
+CellPartitionFunction weighted_cell_partitioner(
+    std::vector<std::int32_t> cell_weights,
+    const graph::partition_fn_weighted& partfn
+    = &graph::partition_graph_weighted);
+
+/// Create a mesh using the default partitioner, taking ownership of
+/// the cell data. The cell buffers are released as soon as the cells
+/// have been redistributed to their owning ranks, which reduces the
+/// peak memory use when importing large meshes compared with the
+/// const-reference overload, where the caller and library copies of
+/// the cell data are live at the same time. Callers holding cell data
+/// in `std::vector` buffers can move them into the
+/// `graph::AdjacencyList` without a copy.
+Mesh create_mesh(MPI_Comm comm, graph::AdjacencyList<std::int64_t>&& cells,
+                 const fem::CoordinateElement& element,
+                 const xt::xtensor<double, 2>& x, GhostMode ghost_mode);
+
 } // namespace dolfinx::mesh
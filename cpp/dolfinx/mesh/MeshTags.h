@@ -10,8 +10,10 @@
 #include "Mesh.h"
 #include "Topology.h"
 #include <algorithm>
+#include <array>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/UniqueIdGenerator.h>
+#include <dolfinx/common/sort.h>
 #include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/graph/partition.h>
@@ -78,20 +80,44 @@ public:
 
   /// Find all entities with a given tag value
   /// @param[in] value The value
-  /// @return Indices of tagged entities
+  /// @return Sorted indices of tagged entities
+  /// @note The first call builds an inverted index from tag value to
+  /// entity intervals, making subsequent calls proportional to the size
+  /// of the result rather than to the number of tagged entities.
   std::vector<std::int32_t> find(const T value) const
   {
-    int n = std::count(_values.begin(), _values.end(), value);
-    std::vector<std::int32_t> indices(n);
-    int counter = 0;
-    for (std::int32_t i = 0; i < _values.size(); ++i)
+    const std::vector<std::array<std::int32_t, 2>>& intervals
+        = find_intervals(value);
+    std::size_t n = 0;
+    for (const std::array<std::int32_t, 2>& interval : intervals)
+      n += interval[1] - interval[0];
+    std::vector<std::int32_t> indices;
+    indices.reserve(n);
+    for (const std::array<std::int32_t, 2>& interval : intervals)
     {
-      if (_values[i] == value)
-        indices[counter++] = _indices[i];
+      for (std::int32_t e = interval[0]; e < interval[1]; ++e)
+        indices.push_back(e);
     }
     return indices;
   }
 
+  /// Find all entities with a given tag value, returned as sorted
+  /// half-open intervals [first, last) of entity indices. Tags that
+  /// cover contiguous regions of the mesh compress to a small number of
+  /// intervals, which is considerably more compact than the expanded
+  /// list returned by find().
+  /// @param[in] value The value
+  /// @return Sorted, non-overlapping entity index intervals
+  const std::vector<std::array<std::int32_t, 2>>&
+  find_intervals(const T value) const
+  {
+    if (_value_index.empty() and !_values.empty())
+      build_value_index();
+    static const std::vector<std::array<std::int32_t, 2>> empty;
+    auto it = _value_index.find(value);
+    return it != _value_index.end() ? it->second : empty;
+  }
+
   /// Indices of tagged mesh entities (local-to-process). The indices
   /// are sorted.
   const std::vector<std::int32_t>& indices() const { return _indices; }
@@ -112,6 +138,23 @@ public:
   std::size_t id() const { return _unique_id; }
 
 private:
+  // Build the inverted index from tag value to intervals of entity
+  // indices. Runs of consecutive entity indices with equal values are
+  // stored as a single half-open interval [first, last), so the index
+  // is run-length compressed.
+  void build_value_index() const
+  {
+    for (std::size_t i = 0; i < _indices.size(); ++i)
+    {
+      std::vector<std::array<std::int32_t, 2>>& intervals
+          = _value_index[_values[i]];
+      if (!intervals.empty() and intervals.back()[1] == _indices[i])
+        intervals.back()[1] = _indices[i] + 1;
+      else
+        intervals.push_back({_indices[i], _indices[i] + 1});
+    }
+  }
+
   // Unique identifier
   std::size_t _unique_id = common::UniqueIdGenerator::id();
 
@@ -126,6 +169,12 @@ private:
 
   // Values attached to entities
   std::vector<T> _values;
+
+  // Inverted index from tag value to run-length compressed entity
+  // index intervals. Built lazily on the first call to find() or
+  // find_intervals(); _indices and _values are immutable after
+  // construction, so the index never needs invalidating.
+  mutable std::map<T, std::vector<std::array<std::int32_t, 2>>> _value_index;
 };
 
 /// Create MeshTags from arrays
@@ -190,7 +239,7 @@ create_meshtags(const std::shared_ptr<const mesh::Mesh>& mesh, int dim,
   }
 
   auto [indices_sorted, values_sorted]
-      = common::sort_unique(indices_new, values_new);
+      = common::sort_unique(std::move(indices_new), std::move(values_new));
   return mesh::MeshTags<T>(mesh, dim, std::move(indices_sorted),
                            std::move(values_sorted));
 }
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/memory.h>
 #include <dolfinx/common/sort.h>
 #include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
@@ -18,6 +19,7 @@
 #include <dolfinx/mesh/Mesh.h>
 #include <numeric>
 #include <random>
+#include <set>
 #include <unordered_map>
 
 using namespace dolfinx;
@@ -447,7 +449,8 @@ Topology::Topology(MPI_Comm comm, mesh::CellType type)
       _connectivity(
           mesh::cell_dim(type) + 1,
           std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>(
-              mesh::cell_dim(type) + 1))
+              mesh::cell_dim(type) + 1)),
+      _create_mutex(std::make_shared<std::mutex>())
 {
   // Do nothing
 }
@@ -459,6 +462,7 @@ void Topology::set_index_map(int dim,
 {
   assert(dim < (int)_index_map.size());
   _index_map[dim] = map;
+  ++_version;
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<const common::IndexMap> Topology::index_map(int dim) const
@@ -468,11 +472,18 @@ std::shared_ptr<const common::IndexMap> Topology::index_map(int dim) const
 }
 //-----------------------------------------------------------------------------
 std::int32_t Topology::create_entities(int dim)
+{
+  std::lock_guard<std::mutex> lock(*_create_mutex);
+  return create_entities_locked(dim);
+}
+//-----------------------------------------------------------------------------
+std::int32_t Topology::create_entities_locked(int dim)
 {
   // TODO: is this check sufficient/correct? Does not catch the cell_entity
   // entity case. Should there also be a check for
   // connectivity(this->dim(), dim) ?
-  // Skip if already computed (vertices (dim=0) should always exist)
+  // Skip if already computed by another thread (vertices (dim=0)
+  // should always exist)
   if (connectivity(dim, 0))
     return -1;
 
@@ -495,9 +506,19 @@ std::int32_t Topology::create_entities(int dim)
 //-----------------------------------------------------------------------------
 void Topology::create_connectivity(int d0, int d1)
 {
+  std::lock_guard<std::mutex> lock(*_create_mutex);
+  create_connectivity_locked(d0, d1);
+}
+//-----------------------------------------------------------------------------
+void Topology::create_connectivity_locked(int d0, int d1)
+{
+  // Skip if already computed by another thread
+  if (connectivity(d0, d1))
+    return;
+
   // Make sure entities exist
-  create_entities(d0);
-  create_entities(d1);
+  create_entities_locked(d0);
+  create_entities_locked(d1);
 
   // Compute connectivity
   const auto [c_d0_d1, c_d1_d0] = mesh::compute_connectivity(*this, d0, d1);
@@ -505,14 +526,7 @@ void Topology::create_connectivity(int d0, int d1)
   // NOTE: that to compute the (d0, d1) connections is it sometimes
   // necessary to compute the (d1, d0) connections. We store the (d1,
   // d0) for possible later use, but there is a memory overhead if they
-  // are not required. It may be better to not automatically store
-  // connectivity that was not requested, but advise in a docstring the
-  // most efficient order in which to call this function if several
-  // connectivities are needed.
-
-  // TODO: Caching policy/strategy.
-  // Concerning the note above: Provide an overload
-  // create_connectivity(std::vector<std::pair<int, int>>)?
+  // are not required. It can be reclaimed with discard().
 
   // Attach connectivities
   if (c_d0_d1)
@@ -521,8 +535,123 @@ void Topology::create_connectivity(int d0, int d1)
     set_connectivity(c_d1_d0, d1, d0);
 }
 //-----------------------------------------------------------------------------
+const std::vector<std::int32_t>& Topology::interface_entities(int dim)
+{
+  std::lock_guard<std::mutex> lock(*_create_mutex);
+  create_entity_classes_locked(dim);
+  return _interface_entities[dim];
+}
+//-----------------------------------------------------------------------------
+const std::vector<std::int32_t>& Topology::interior_entities(int dim)
+{
+  std::lock_guard<std::mutex> lock(*_create_mutex);
+  create_entity_classes_locked(dim);
+  return _interior_entities[dim];
+}
+//-----------------------------------------------------------------------------
+void Topology::create_entity_classes_locked(int dim)
+{
+  assert(dim >= 0 and dim < (int)_index_map.size());
+
+  // Skip if already computed by another thread
+  if (_entity_classes_computed[dim])
+    return;
+
+  // Mark the shared vertices: the ghost vertices on this process and
+  // the owned vertices that are ghosted on another process
+  std::shared_ptr<const common::IndexMap> map0 = _index_map[0];
+  assert(map0);
+  const std::int32_t num_owned_vertices = map0->size_local();
+  std::vector<bool> vertex_shared(num_owned_vertices + map0->num_ghosts(),
+                                  false);
+  std::fill(std::next(vertex_shared.begin(), num_owned_vertices),
+            vertex_shared.end(), true);
+  for (std::int32_t v : map0->scatter_fwd_indices().array())
+    vertex_shared[v] = true;
+
+  // An owned entity is an interface entity if any of its vertices is
+  // shared
+  std::vector<std::int32_t>& interior = _interior_entities[dim];
+  std::vector<std::int32_t>& interface = _interface_entities[dim];
+  if (dim == 0)
+  {
+    for (std::int32_t v = 0; v < num_owned_vertices; ++v)
+    {
+      if (vertex_shared[v])
+        interface.push_back(v);
+      else
+        interior.push_back(v);
+    }
+  }
+  else
+  {
+    create_entities_locked(dim);
+    std::shared_ptr<const graph::AdjacencyList<std::int32_t>> e_to_v
+        = connectivity(dim, 0);
+    assert(e_to_v);
+    std::shared_ptr<const common::IndexMap> map = _index_map[dim];
+    assert(map);
+    for (std::int32_t e = 0; e < map->size_local(); ++e)
+    {
+      const auto vertices = e_to_v->links(e);
+      if (std::any_of(vertices.begin(), vertices.end(),
+                      [&vertex_shared](std::int32_t v)
+                      { return vertex_shared[v]; }))
+      {
+        interface.push_back(e);
+      }
+      else
+        interior.push_back(e);
+    }
+  }
+
+  _entity_classes_computed[dim] = true;
+}
+//-----------------------------------------------------------------------------
+const std::vector<std::int32_t>& Topology::exterior_facets()
+{
+  std::lock_guard<std::mutex> lock(*_create_mutex);
+
+  // Skip if already computed by another thread
+  if (_exterior_facets_computed)
+    return _exterior_facets;
+
+  const int tdim = dim();
+  create_connectivity_locked(tdim - 1, tdim);
+  std::shared_ptr<const graph::AdjacencyList<std::int32_t>> f_to_c
+      = connectivity(tdim - 1, tdim);
+  assert(f_to_c);
+  assert(_index_map[tdim - 1]);
+
+  // Only need to consider shared facets when there are no ghost cells
+  assert(_index_map[tdim]);
+  std::set<std::int32_t> fwd_shared_facets;
+  if (_index_map[tdim]->num_ghosts() == 0)
+  {
+    fwd_shared_facets.insert(
+        _index_map[tdim - 1]->scatter_fwd_indices().array().begin(),
+        _index_map[tdim - 1]->scatter_fwd_indices().array().end());
+  }
+
+  // Owned facets with only one attached cell, which are also not
+  // shared forward (ghost on another process), are exterior
+  const std::int32_t num_facets = _index_map[tdim - 1]->size_local();
+  for (std::int32_t f = 0; f < num_facets; ++f)
+  {
+    if (f_to_c->num_links(f) == 1
+        and fwd_shared_facets.find(f) == fwd_shared_facets.end())
+    {
+      _exterior_facets.push_back(f);
+    }
+  }
+
+  _exterior_facets_computed = true;
+  return _exterior_facets;
+}
+//-----------------------------------------------------------------------------
 void Topology::create_entity_permutations()
 {
+  std::lock_guard<std::mutex> lock(*_create_mutex);
   if (!_cell_permutations.empty())
     return;
 
@@ -533,7 +662,7 @@ void Topology::create_entity_permutations()
   // Create all mesh entities
 
   for (int d = 0; d < tdim; ++d)
-    create_entities(d);
+    create_entities_locked(d);
 
   auto [facet_permutations, cell_permutations]
       = mesh::compute_entity_permutations(*this);
@@ -541,6 +670,80 @@ void Topology::create_entity_permutations()
   _cell_permutations = std::move(cell_permutations);
 }
 //-----------------------------------------------------------------------------
+void Topology::discard(int d0, int d1)
+{
+  assert(d0 < (int)_connectivity.size());
+  assert(d1 < (int)_connectivity[d0].size());
+  if ((d0 == this->dim() and d1 == 0) or (d0 == 0 and d1 == 0))
+  {
+    throw std::runtime_error("Cannot discard connectivity ("
+                             + std::to_string(d0) + ", " + std::to_string(d1)
+                             + "). It is required to rebuild the topology.");
+  }
+
+  std::lock_guard<std::mutex> lock(*_create_mutex);
+  _connectivity[d0][d1] = nullptr;
+  ++_version;
+}
+//-----------------------------------------------------------------------------
+void Topology::compact()
+{
+  const std::size_t tdim = this->dim();
+  std::lock_guard<std::mutex> lock(*_create_mutex);
+  for (std::size_t d0 = 0; d0 < _connectivity.size(); ++d0)
+  {
+    for (std::size_t d1 = 0; d1 < _connectivity[d0].size(); ++d1)
+    {
+      // The cell-vertex and vertex connectivity are required to
+      // rebuild the topology
+      if ((d0 == tdim and d1 == 0) or (d0 == 0 and d1 == 0))
+        continue;
+      _connectivity[d0][d1] = nullptr;
+    }
+  }
+  ++_version;
+}
+//-----------------------------------------------------------------------------
+void Topology::compress(int d0, int d1)
+{
+  assert(d0 < (int)_connectivity.size());
+  assert(d1 < (int)_connectivity[d0].size());
+  if ((d0 == this->dim() and d1 == 0) or (d0 == 0 and d1 == 0))
+  {
+    throw std::runtime_error("Cannot compress connectivity ("
+                             + std::to_string(d0) + ", " + std::to_string(d1)
+                             + "). It is required to rebuild the topology.");
+  }
+
+  std::lock_guard<std::mutex> lock(*_create_mutex);
+  std::shared_ptr<const graph::AdjacencyList<std::int32_t>> c
+      = _connectivity[d0][d1];
+  if (!c)
+    throw std::runtime_error("Connectivity has not been computed.");
+  auto compressed = std::make_shared<graph::CompressedAdjacencyList>(*c);
+
+  // Swap the accounting from the plain to the compressed storage
+  register_memory("Topology connectivity",
+                  -std::int64_t(sizeof(std::int32_t))
+                      * (c->array().size() + c->offsets().size()));
+  register_memory("Topology connectivity", compressed->storage_bytes());
+
+  _compressed_connectivity[{d0, d1}] = compressed;
+  _connectivity[d0][d1] = nullptr;
+  ++_version;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const graph::CompressedAdjacencyList>
+Topology::compressed_connectivity(int d0, int d1) const
+{
+  if (auto it = _compressed_connectivity.find({d0, d1});
+      it != _compressed_connectivity.end())
+  {
+    return it->second;
+  }
+  return nullptr;
+}
+//-----------------------------------------------------------------------------
 std::shared_ptr<const graph::AdjacencyList<std::int32_t>>
 Topology::connectivity(int d0, int d1) const
 {
@@ -554,7 +757,28 @@ void Topology::set_connectivity(
 {
   assert(d0 < (int)_connectivity.size());
   assert(d1 < (int)_connectivity[d0].size());
+
+  // Account for the connectivity storage (an estimate: lists may be
+  // shared between topologies)
+  auto bytes = [](const graph::AdjacencyList<std::int32_t>& a)
+  {
+    return std::int64_t(sizeof(std::int32_t))
+           * (a.array().size() + a.offsets().size());
+  };
+  if (_connectivity[d0][d1])
+    register_memory("Topology connectivity", -bytes(*_connectivity[d0][d1]));
+  if (c)
+  {
+    register_memory("Topology connectivity", bytes(*c));
+
+    // Large connectivity arrays benefit from huge-page backing (no-op
+    // unless enabled, see common::advise_huge_pages)
+    common::advise_huge_pages(c->array().data(),
+                              c->array().size() * sizeof(std::int32_t));
+  }
+
   _connectivity[d0][d1] = c;
+  ++_version;
 }
 //-----------------------------------------------------------------------------
 const std::vector<std::uint32_t>& Topology::get_cell_permutation_info() const
@@ -579,8 +803,63 @@ const std::vector<std::uint8_t>& Topology::get_facet_permutations() const
 //-----------------------------------------------------------------------------
 mesh::CellType Topology::cell_type() const noexcept { return _cell_type; }
 //-----------------------------------------------------------------------------
+std::size_t Topology::version() const noexcept { return _version; }
+//-----------------------------------------------------------------------------
 MPI_Comm Topology::mpi_comm() const { return _mpi_comm.comm(); }
 //-----------------------------------------------------------------------------
+const std::vector<std::int64_t>& Topology::entity_directory(int dim) const
+{
+  assert(dim >= 0 and dim <= this->dim());
+  auto map = this->index_map(dim);
+  if (!map)
+  {
+    throw std::runtime_error("IndexMap for dimension " + std::to_string(dim)
+                             + " does not exist.");
+  }
+
+  std::lock_guard<std::mutex> lock(*_create_mutex);
+  if (auto it = _entity_directory.find(dim); it != _entity_directory.end())
+    return it->second;
+
+  // Gather the upper end of every rank's ownership range (collective)
+  const int size = dolfinx::MPI::size(_mpi_comm.comm());
+  std::vector<std::int64_t> offsets(size + 1, 0);
+  const std::int64_t range_end = map->local_range()[1];
+  MPI_Allgather(&range_end, 1, MPI_INT64_T, offsets.data() + 1, 1, MPI_INT64_T,
+                _mpi_comm.comm());
+
+  return _entity_directory.emplace(dim, std::move(offsets)).first->second;
+}
+//-----------------------------------------------------------------------------
+std::vector<int>
+Topology::entity_owners(int dim,
+                        const xtl::span<const std::int64_t>& entities) const
+{
+  const std::vector<std::int64_t>& offsets = entity_directory(dim);
+  std::vector<int> owners(entities.size());
+  std::transform(entities.cbegin(), entities.cend(), owners.begin(),
+                 [&offsets](std::int64_t index) -> int
+                 {
+                   assert(index >= 0 and index < offsets.back());
+                   auto it = std::upper_bound(offsets.cbegin() + 1,
+                                              offsets.cend(), index);
+                   return std::distance(offsets.cbegin() + 1, it);
+                 });
+  return owners;
+}
+//-----------------------------------------------------------------------------
+std::pair<std::vector<int>, std::vector<std::int32_t>>
+Topology::entity_locations(int dim,
+                           const xtl::span<const std::int64_t>& entities) const
+{
+  const std::vector<std::int64_t>& offsets = entity_directory(dim);
+  std::vector<int> owners = entity_owners(dim, entities);
+  std::vector<std::int32_t> local(entities.size());
+  for (std::size_t i = 0; i < entities.size(); ++i)
+    local[i] = entities[i] - offsets[owners[i]];
+  return {std::move(owners), std::move(local)};
+}
+//-----------------------------------------------------------------------------
 Topology
 mesh::create_topology(MPI_Comm comm,
                       const graph::AdjacencyList<std::int64_t>& cells,
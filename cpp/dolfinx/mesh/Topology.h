@@ -9,7 +9,9 @@
 #include <array>
 #include <cstdint>
 #include <dolfinx/common/MPI.h>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <xtl/xspan.hpp>
 
@@ -22,6 +24,7 @@ namespace dolfinx::graph
 {
 template <typename T>
 class AdjacencyList;
+class CompressedAdjacencyList;
 }
 
 namespace dolfinx::mesh
@@ -99,6 +102,26 @@ public:
   void set_connectivity(std::shared_ptr<graph::AdjacencyList<std::int32_t>> c,
                         int d0, int d1);
 
+  /// Replace the cached d0 -> d1 connectivity with delta-compressed
+  /// storage (see graph::CompressedAdjacencyList), roughly halving its
+  /// memory. The plain table is discarded, so code that requests it
+  /// again through create_connectivity triggers a recompute:
+  /// compression is best applied to large tables that are afterwards
+  /// only read through compressed_connectivity. The cell-vertex and
+  /// vertex connectivity cannot be compressed since they are required
+  /// to rebuild the topology.
+  /// @param[in] d0 Topological dimension
+  /// @param[in] d1 Topological dimension
+  void compress(int d0, int d1);
+
+  /// Return the compressed connectivity from entities of dimension d0
+  /// to entities of dimension d1, or `nullptr` if the pair has not
+  /// been compressed with compress()
+  /// @param[in] d0 Topological dimension
+  /// @param[in] d1 Topological dimension
+  std::shared_ptr<const graph::CompressedAdjacencyList>
+  compressed_connectivity(int d0, int d1) const;
+
   /// Returns the permutation information
   const std::vector<std::uint32_t>& get_cell_permutation_info() const;
 
@@ -119,17 +142,24 @@ public:
   /// @return Cell type that the topology is for
   mesh::CellType cell_type() const noexcept;
 
-  // TODO: Rework memory management and associated API
-  // Currently, there is no clear caching policy implemented and no way of
-  // discarding cached data.
+  // Entities, connectivity and entity index maps are created lazily:
+  // the create_* functions are cheap no-ops when the data already
+  // exists, and tables that are never requested are never built.
+  // Tables that are no longer needed can be dropped with discard().
 
-  /// Create entities of given topological dimension.
+  /// Create entities of given topological dimension. Lazy: returns
+  /// immediately if the entities already exist. The entity IndexMap is
+  /// created together with the entities. Thread-safe: concurrent calls
+  /// compute the entities once.
   /// @param[in] dim Topological dimension
   /// @return Number of newly created entities, returns -1 if entities
   /// already existed
   std::int32_t create_entities(int dim);
 
-  /// Create connectivity between given pair of dimensions, d0 -> d1
+  /// Create connectivity between given pair of dimensions, d0 -> d1.
+  /// Lazy: returns immediately if the connectivity has already been
+  /// computed. Thread-safe: concurrent calls compute the connectivity
+  /// once.
   /// @param[in] d0 Topological dimension
   /// @param[in] d1 Topological dimension
   void create_connectivity(int d0, int d1);
@@ -137,11 +167,106 @@ public:
   /// Compute entity permutations and reflections
   void create_entity_permutations();
 
+  /// Discard the cached d0 -> d1 connectivity to reclaim memory, e.g.
+  /// the vertex-to-cell connectivity after dofmap construction. The
+  /// table is recomputed on the next call to create_connectivity. The
+  /// cell-vertex and vertex connectivity cannot be discarded since the
+  /// topology cannot be rebuilt without them.
+  /// @param[in] d0 Topological dimension
+  /// @param[in] d1 Topological dimension
+  void discard(int d0, int d1);
+
+  /// Discard every cached connectivity that can be rebuilt, keeping
+  /// only the cell-vertex and vertex connectivity, which are required
+  /// to rebuild the topology. The discarded tables are recomputed
+  /// lazily by create_connectivity when next required, e.g.
+  /// facet-cell connectivity by facet integrals and boundary facet
+  /// detection, or vertex-cell connectivity by dofmap construction.
+  /// See Mesh::compact.
+  void compact();
+
+  /// Owned entities of dimension dim that touch the process interface,
+  /// i.e. that have at least one vertex that is shared with another
+  /// process (ghosted on this process or ghosted elsewhere). These are
+  /// the entities whose dofs can be ghosted on another process, for any
+  /// dofmap. Lazy: the classification is computed on first request and
+  /// cached; entities of dimension dim and their vertex connectivity
+  /// are created if required. Thread-safe.
+  /// @param[in] dim Topological dimension
+  /// @return Sorted list of owned interface entities (local indices)
+  const std::vector<std::int32_t>& interface_entities(int dim);
+
+  /// Owned entities of dimension dim all of whose vertices are
+  /// unshared. The complement of interface_entities() within the owned
+  /// entities: work on these entities cannot touch ghosted data and
+  /// can be overlapped with communication. Lazy and thread-safe, see
+  /// interface_entities().
+  /// @param[in] dim Topological dimension
+  /// @return Sorted list of owned interior entities (local indices)
+  const std::vector<std::int32_t>& interior_entities(int dim);
+
+  /// Owned facets on the exterior boundary of the domain, i.e. owned
+  /// facets that are connected to exactly one cell and are not shared
+  /// with another process. Lazy: the list is computed on first request
+  /// and cached; facets and facet-cell connectivity are created if
+  /// required. Thread-safe.
+  /// @return Sorted list of owned exterior facets (local indices)
+  const std::vector<std::int32_t>& exterior_facets();
+
+  /// Owning ranks of entities of dimension dim, given by their global
+  /// indices. The first call for a dimension builds a directory of the
+  /// ownership ranges of the entity IndexMap across all ranks and is
+  /// therefore collective; the directory is cached and subsequent
+  /// queries for the same dimension are answered locally, without
+  /// communication. Consolidates the ad-hoc ownership exchanges of
+  /// meshtags reading, refinement and coupling codes.
+  /// @param[in] dim Topological dimension of the entities
+  /// @param[in] entities Global entity indices to resolve
+  /// @return The rank owning each entity in @p entities
+  std::vector<int>
+  entity_owners(int dim, const xtl::span<const std::int64_t>& entities) const;
+
+  /// Locations (owning rank and local index on the owner) of entities
+  /// of dimension dim, given by their global indices. Uses the same
+  /// cached directory as entity_owners; the first call for a dimension
+  /// is collective.
+  /// @param[in] dim Topological dimension of the entities
+  /// @param[in] entities Global entity indices to resolve
+  /// @return The rank owning each entity in @p entities and the local
+  /// index of the entity on its owner
+  std::pair<std::vector<int>, std::vector<std::int32_t>>
+  entity_locations(int dim,
+                   const xtl::span<const std::int64_t>& entities) const;
+
+  /// Version counter for the stored topology data. The counter is
+  /// incremented whenever an index map or connectivity is set,
+  /// replaced, compressed or dropped (including lazy creation through
+  /// the create_* functions), and can be used to invalidate caches of
+  /// data derived from the topology in O(1), e.g. assembly scratch
+  /// data or reused sparsity patterns.
+  std::size_t version() const noexcept;
+
   /// Mesh MPI communicator
   /// @return The communicator on which the topology is distributed
   MPI_Comm mpi_comm() const;
 
 private:
+  // Ownership range offsets over all ranks for entities of dimension
+  // dim (the entity directory), gathering them on the first request.
+  // Takes and releases _create_mutex.
+  const std::vector<std::int64_t>& entity_directory(int dim) const;
+
+  // Create entities of given topological dimension. Caller must hold
+  // _create_mutex.
+  std::int32_t create_entities_locked(int dim);
+
+  // Create d0 -> d1 connectivity. Caller must hold _create_mutex.
+  void create_connectivity_locked(int d0, int d1);
+
+  // Classify the owned entities of dimension dim into interior and
+  // interface entities. Caller must hold _create_mutex.
+  void create_entity_classes_locked(int dim);
+
   // MPI communicator
   dolfinx::MPI::Comm _mpi_comm;
 
@@ -155,6 +280,12 @@ private:
   std::vector<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>>
       _connectivity;
 
+  // Compressed connectivity for pairs {d0, d1}, created on request by
+  // compress()
+  std::map<std::array<int, 2>,
+           std::shared_ptr<const graph::CompressedAdjacencyList>>
+      _compressed_connectivity;
+
   // The facet permutations (local facet, cell))
   // [cell0_0, cell0_1, ,cell0_2, cell1_0, cell1_1, ,cell1_2, ...,
   // celln_0, celln_1, ,celln_2,]
@@ -163,6 +294,32 @@ private:
   // Cell permutation info. See the documentation for
   // get_cell_permutation_info for documentation of how this is encoded.
   std::vector<std::uint32_t> _cell_permutations;
+
+  // Owned entities classified by whether they touch a shared vertex,
+  // per dimension. Computed lazily by interface_entities() and
+  // interior_entities().
+  std::array<std::vector<std::int32_t>, 4> _interior_entities;
+  std::array<std::vector<std::int32_t>, 4> _interface_entities;
+  std::array<bool, 4> _entity_classes_computed
+      = {false, false, false, false};
+
+  // Owned exterior boundary facets. Computed lazily by
+  // exterior_facets().
+  std::vector<std::int32_t> _exterior_facets;
+  bool _exterior_facets_computed = false;
+
+  // Entity ownership directory, per dimension: offsets[r] is the first
+  // global entity index owned by rank r (offsets has size + 1
+  // entries). Gathered lazily by entity_owners()/entity_locations().
+  mutable std::map<int, std::vector<std::int64_t>> _entity_directory;
+
+  // Version counter for the stored topology data (see version())
+  std::size_t _version = 0;
+
+  // Serializes lazy creation of entities and connectivity so that a
+  // first access from concurrent threads computes the data once. Held
+  // by pointer to keep the Topology copyable and movable.
+  std::shared_ptr<std::mutex> _create_mutex;
 };
 
 /// Create distributed topology
@@ -6,12 +6,16 @@
 
 #include "graphbuild.h"
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/common/sort.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/cell_types.h>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <xtensor/xview.hpp>
@@ -22,6 +26,45 @@ namespace
 {
 //-----------------------------------------------------------------------------
 
+/// Execute `f(range_begin, range_end)` over [0, n), splitting the range
+/// across the threads requested via common::num_threads(). For a single
+/// thread `f` is called directly on the full range.
+template <typename F>
+void parallel_for_ranges(std::size_t n, F&& f)
+{
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads <= 1 or n == 0)
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t)
+  {
+    const std::size_t begin = (n * t) / num_threads;
+    const std::size_t end = (n * (t + 1)) / num_threads;
+    if (begin == end)
+      continue;
+    threads.emplace_back(f, begin, end);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+}
+//-----------------------------------------------------------------------------
+
+/// Mix a 64-bit value into a hash (splitmix64 finaliser). Used to hash
+/// the sorted global vertex indices of a facet.
+constexpr std::uint64_t hash_mix(std::uint64_t x)
+{
+  x += UINT64_C(0x9e3779b97f4a7c15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+//-----------------------------------------------------------------------------
+
 /// Build nonlocal part of dual graph for mesh and return number of
 /// non-local edges. Note: GraphBuilder::compute_local_dual_graph should
 /// be called before this function is called. Returns (ghost vertices,
@@ -39,6 +82,12 @@ namespace
 /// @param[in] local_graph The dual graph for cells on this MPI rank
 /// @return (0) Extended dual graph to include ghost edges (edges to
 /// off-rank cells) and (1) the number of ghost edges
+///
+/// @note Facets are routed to intermediary match-making ranks by a
+/// 64-bit hash of their sorted global vertex indices, and matched by
+/// comparing hashes. The full vertex lists are carried alongside the
+/// hashes and are compared exactly within runs of equal hashes, so a
+/// (rare) hash collision cannot produce a false match.
 std::pair<graph::AdjacencyList<std::int64_t>, std::int32_t>
 compute_nonlocal_dual_graph(
     const MPI_Comm comm, const xt::xtensor<std::int64_t, 2>& unmatched_facets,
@@ -71,45 +120,56 @@ compute_nonlocal_dual_graph(
   // At this stage facet_cell map only contains facets->cells with edge
   // facets either interprocess or external boundaries
 
-  // TODO: improve scalability, possibly by limiting the number of
-  // processes which do the matching, and using a neighbor comm?
-
-  // (0) Some ranks may have empty unmatched_facets, so get max across
-  // all ranks
-  // (1) Find the global range of the first vertex index of each facet
-  // in the list and use this to divide up the facets between all
-  // processes.
-  //
-  // Combine into single MPI reduce (MPI_MIN)
-  std::array<std::int64_t, 3> buffer_local_min
-      = {-std::int64_t(unmatched_facets.shape(1) - 1),
-         std::numeric_limits<std::int64_t>::max(), 0};
-  if (unmatched_facets.shape(0) > 0)
-  {
-    auto local_minmax = xt::minmax(xt::col(unmatched_facets, 0))();
-    buffer_local_min[1] = local_minmax[0];
-    buffer_local_min[2] = -local_minmax[1];
-  }
-  std::array<std::int64_t, 3> buffer_global_min;
-  MPI_Allreduce(buffer_local_min.data(), buffer_global_min.data(), 3,
-                MPI_INT64_T, MPI_MIN, comm);
-  const std::int32_t max_num_vertices_per_facet = -buffer_global_min[0];
+  // Some ranks may have empty unmatched_facets, so get the maximum
+  // number of facet vertices across all ranks
+  const std::int64_t max_num_vertices_local
+      = unmatched_facets.shape(0) > 0
+            ? std::int64_t(unmatched_facets.shape(1)) - 1
+            : 0;
+  std::int64_t max_num_vertices_global = 0;
+  MPI_Allreduce(&max_num_vertices_local, &max_num_vertices_global, 1,
+                MPI_INT64_T, MPI_MAX, comm);
+  const std::int32_t max_num_vertices_per_facet = max_num_vertices_global;
   LOG(INFO) << "Max. vertices per facet=" << max_num_vertices_per_facet << "\n";
-  assert(buffer_global_min[1] != std::numeric_limits<std::int64_t>::max());
-  const std::array<std::int64_t, 2> global_minmax
-      = {buffer_global_min[1], -buffer_global_min[2]};
-  const std::int64_t global_range = global_minmax[1] - global_minmax[0] + 1;
 
-  // Send facet-to-cell data to intermediary match-making ranks
-
-  // Count number of item to send to each rank
+  // Hash the sorted global vertex indices of each unmatched facet. The
+  // hash (i) determines the intermediary match-making rank, giving a
+  // balanced distribution of the matching work irrespective of the
+  // global vertex numbering, and (ii) reduces facet matching to a
+  // 64-bit key comparison. The top hash bit is discarded so that the
+  // value is non-negative when stored in the std::int64_t exchange
+  // buffer.
+  const std::size_t num_facets_local = unmatched_facets.shape(0);
+  const std::int32_t num_vertices_local = max_num_vertices_local;
+  constexpr std::int64_t padding = std::numeric_limits<std::int64_t>::max();
+  std::vector<std::int64_t> facet_hash(num_facets_local);
+  parallel_for_ranges(num_facets_local,
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                          std::uint64_t h = 0;
+                          for (std::int32_t j = 0; j < num_vertices_local; ++j)
+                          {
+                            const std::int64_t v = unmatched_facets(i, j);
+                            if (v == padding)
+                              break;
+                            h = hash_mix(h ^ std::uint64_t(v));
+                          }
+                          facet_hash[i] = std::int64_t(h >> 1);
+                        }
+                      });
+
+  // Send facet-to-cell data to intermediary match-making ranks. Each
+  // buffer row has the form [v0, ..., v_{max-1}, cell_index, hash].
+  const std::int32_t buffer_shape1 = max_num_vertices_per_facet + 2;
+
+  // Count number of items to send to each rank
   std::vector<int> p_count(num_ranks, 0);
-  for (std::size_t i = 0; i < unmatched_facets.shape(0); ++i)
+  for (std::size_t i = 0; i < num_facets_local; ++i)
   {
-    // Use first vertex of facet to partition into blocks
-    std::int64_t v0 = unmatched_facets(i, 0) - global_minmax[0];
-    const int dest = dolfinx::MPI::index_owner(num_ranks, v0, global_range);
-    p_count[dest] += max_num_vertices_per_facet + 1;
+    const int dest = facet_hash[i] % num_ranks;
+    p_count[dest] += buffer_shape1;
   }
 
   // Create back adjacency list send buffer
@@ -121,39 +181,39 @@ compute_nonlocal_dual_graph(
   // Wait for the MPI_Iexscan to complete
   MPI_Wait(&request_cell_offset, MPI_STATUS_IGNORE);
 
-  // Pack facet-to-cell to send to match-maker rank
+  // Pack facet vertices, attached (global) cell index and hash to send
+  // to the match-maker rank
   std::vector<int> pos(send_buffer.num_nodes(), 0);
-  for (std::size_t i = 0; i < unmatched_facets.shape(0); ++i)
+  for (std::size_t i = 0; i < num_facets_local; ++i)
   {
-    std::int64_t v0 = unmatched_facets(i, 0) - global_minmax[0];
-    const int dest = dolfinx::MPI::index_owner(num_ranks, v0, global_range);
-
-    // Pack facet vertices, and attached cell local index
+    const int dest = facet_hash[i] % num_ranks;
     xtl::span<std::int64_t> buffer = send_buffer.links(dest);
-    for (int j = 0; j < max_num_vertices_per_facet + 1; ++j)
-      buffer[pos[dest] + j] = unmatched_facets(i, j);
-
-    // Add cell index offset
-    buffer[pos[dest] + max_num_vertices_per_facet] += cell_offset;
-    pos[dest] += max_num_vertices_per_facet + 1;
+    for (std::int32_t j = 0; j < max_num_vertices_per_facet; ++j)
+    {
+      buffer[pos[dest] + j]
+          = j < num_vertices_local ? unmatched_facets(i, j) : padding;
+    }
+    buffer[pos[dest] + max_num_vertices_per_facet]
+        = unmatched_facets(i, num_vertices_local) + cell_offset;
+    buffer[pos[dest] + max_num_vertices_per_facet + 1] = facet_hash[i];
+    pos[dest] += buffer_shape1;
   }
 
   // Send data
   graph::AdjacencyList<std::int64_t> recvd_buffer
       = dolfinx::MPI::all_to_all(comm, send_buffer);
-  assert(recvd_buffer.array().size() % (max_num_vertices_per_facet + 1) == 0);
+  assert(recvd_buffer.array().size() % buffer_shape1 == 0);
 
   // Number of received facets
-  const int num_facets_rcvd
-      = recvd_buffer.array().size() / (max_num_vertices_per_facet + 1);
+  const int num_facets_rcvd = recvd_buffer.array().size() / buffer_shape1;
 
   // Build array from received facet to source rank
   const std::vector<std::int32_t>& recvd_disp = recvd_buffer.offsets();
   std::vector<int> proc(num_facets_rcvd);
   for (int p = 0; p < num_ranks; ++p)
   {
-    for (int f = recvd_disp[p] / (max_num_vertices_per_facet + 1);
-         f < recvd_disp[p + 1] / (max_num_vertices_per_facet + 1); ++f)
+    for (int f = recvd_disp[p] / buffer_shape1;
+         f < recvd_disp[p + 1] / buffer_shape1; ++f)
     {
       proc[f] = p;
     }
@@ -163,25 +223,96 @@ compute_nonlocal_dual_graph(
   {
     std::vector<std::int32_t> offsets(num_facets_rcvd + 1, 0);
     for (std::size_t i = 0; i < offsets.size() - 1; ++i)
-      offsets[i + 1] = offsets[i] + (max_num_vertices_per_facet + 1);
+      offsets[i + 1] = offsets[i] + buffer_shape1;
     recvd_buffer = graph::AdjacencyList<std::int64_t>(
         std::move(recvd_buffer.array()), std::move(offsets));
   }
 
-  // Get permutation that takes facets into sorted order
-  std::vector<int> perm(num_facets_rcvd);
+  // Extract the facet hashes (last entry of each row) into a
+  // contiguous array for sorting
+  std::vector<std::int64_t> hash_key(num_facets_rcvd);
+  parallel_for_ranges(num_facets_rcvd,
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t f = begin; f < end; ++f)
+                          hash_key[f] = recvd_buffer.links(f).back();
+                      });
+
+  // Get permutation that sorts the facets by hash. For multiple threads
+  // each thread radix-sorts a contiguous sub-range, and the sorted
+  // ranges are merged pairwise
+  std::vector<std::int32_t> perm(num_facets_rcvd);
   std::iota(perm.begin(), perm.end(), 0);
-  std::sort(perm.begin(), perm.end(),
-            [&recvd_buffer](int a, int b)
-            {
-              return std::lexicographical_compare(
-                  recvd_buffer.links(a).begin(),
-                  std::prev(recvd_buffer.links(a).end()),
-                  recvd_buffer.links(b).begin(),
-                  std::prev(recvd_buffer.links(b).end()));
-            });
-
-  // Count data items to send to each rank
+  const xtl::span<const std::int64_t> hash_span(hash_key);
+  if (const int num_threads = dolfinx::common::num_threads();
+      num_threads <= 1 or num_facets_rcvd == 0)
+  {
+    dolfinx::argsort_radix<std::int64_t>(hash_span,
+                                         xtl::span<std::int32_t>(perm));
+  }
+  else
+  {
+    std::vector<std::size_t> bounds(num_threads + 1);
+    for (int t = 0; t <= num_threads; ++t)
+      bounds[t] = (std::size_t(num_facets_rcvd) * t) / num_threads;
+    {
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (int t = 0; t < num_threads; ++t)
+      {
+        if (bounds[t] == bounds[t + 1])
+          continue;
+        threads.emplace_back(
+            [&hash_span, &perm](std::size_t begin, std::size_t end) {
+              dolfinx::argsort_radix<std::int64_t>(
+                  hash_span, xtl::span<std::int32_t>(perm.data() + begin,
+                                                     end - begin));
+            },
+            bounds[t], bounds[t + 1]);
+      }
+      for (std::thread& thread : threads)
+        thread.join();
+    }
+    for (int width = 1; width < num_threads; width *= 2)
+    {
+      for (int t = 0; t + width < num_threads; t += 2 * width)
+      {
+        std::inplace_merge(
+            std::next(perm.begin(), bounds[t]),
+            std::next(perm.begin(), bounds[t + width]),
+            std::next(perm.begin(),
+                      bounds[std::min(t + 2 * width, num_threads)]),
+            [&hash_key](std::int32_t a, std::int32_t b)
+            { return hash_key[a] < hash_key[b]; });
+      }
+    }
+  }
+
+  // Hash collisions are possible (although very rare). Sort any run of
+  // more than two facets with equal hashes lexicographically by vertex
+  // indices so that colliding facets can still be matched exactly
+  for (int i = 0; i < num_facets_rcvd;)
+  {
+    int j = i + 1;
+    while (j < num_facets_rcvd and hash_key[perm[j]] == hash_key[perm[i]])
+      ++j;
+    if (j - i > 2)
+    {
+      std::sort(std::next(perm.begin(), i), std::next(perm.begin(), j),
+                [&recvd_buffer](std::int32_t a, std::int32_t b)
+                {
+                  return std::lexicographical_compare(
+                      recvd_buffer.links(a).begin(),
+                      std::prev(recvd_buffer.links(a).end(), 2),
+                      recvd_buffer.links(b).begin(),
+                      std::prev(recvd_buffer.links(b).end(), 2));
+                });
+    }
+    i = j;
+  }
+
+  // Count data items to send to each rank. Facets match if their
+  // hashes, and then their vertex indices, are equal
   p_count.assign(num_ranks, 0);
   bool this_equal, last_equal = false;
   std::vector<bool> facet_match(num_facets_rcvd, false);
@@ -191,8 +322,9 @@ compute_nonlocal_dual_graph(
     const int i1 = perm[i];
     const auto facet0 = recvd_buffer.links(i0);
     const auto facet1 = recvd_buffer.links(i1);
-    this_equal
-        = std::equal(facet0.begin(), std::prev(facet0.end()), facet1.begin());
+    this_equal = hash_key[i0] == hash_key[i1]
+                 and std::equal(facet0.begin(), std::prev(facet0.end(), 2),
+                                facet1.begin());
     if (this_equal)
     {
       if (last_equal)
@@ -226,8 +358,8 @@ compute_nonlocal_dual_graph(
       const auto facet0 = recvd_buffer.links(i0);
       const auto facet1 = recvd_buffer.links(i1);
 
-      const std::int64_t cell0 = facet0.back();
-      const std::int64_t cell1 = facet1.back();
+      const std::int64_t cell0 = facet0[max_num_vertices_per_facet];
+      const std::int64_t cell1 = facet1[max_num_vertices_per_facet];
 
       auto buffer0 = send_buffer.links(proc0);
       buffer0[pos[proc0]++] = cell0;
@@ -411,45 +543,106 @@ mesh::build_local_dual_graph(const xtl::span<const std::int64_t>& cell_vertices,
     throw std::runtime_error("Invalid tdim");
   }
 
+  // Compute the offset of each cell into the facet list so that the
+  // facet extraction loop can be threaded
+  std::vector<std::int32_t> facet_offset(num_local_cells + 1, 0);
+  for (std::int32_t c = 0; c < num_local_cells; ++c)
+  {
+    const int num_cell_vertices = cell_offsets[c + 1] - cell_offsets[c];
+    facet_offset[c + 1] = nv_to_facets[num_cell_vertices].num_nodes();
+  }
+  std::partial_sum(facet_offset.begin(), facet_offset.end(),
+                   facet_offset.begin());
+  assert(facet_offset.back() == num_facets);
+
   // Iterating over every cell, create a 'key' (sorted vertex indices)
   // for each facet and store the associated cell index
   xt::xtensor<std::int32_t, 2> facets(
       {std::size_t(num_facets), std::size_t(max_num_facet_vertices)},
       std::numeric_limits<std::int32_t>::max());
-  std::vector<std::int32_t> facet_to_cell;
-  facet_to_cell.reserve(num_facets);
-  for (std::int32_t c = 0; c < num_local_cells; ++c)
-  {
-    // Cell facets (local) for current cell type
-    const int num_cell_vertices = cell_offsets[c + 1] - cell_offsets[c];
-    const graph::AdjacencyList<int>& cell_facets
-        = nv_to_facets[num_cell_vertices];
-
-    // Loop over all facets of cell c
-    for (int f = 0; f < cell_facets.num_nodes(); ++f)
-    {
-      // Get data array for this facet
-      auto facet = xt::row(facets, facet_to_cell.size());
-
-      // Get facet vertices (local indices)
-      auto facet_vertices = cell_facets.links(f);
-      assert(facet_vertices.size() <= std::size_t(max_num_facet_vertices));
-      std::transform(facet_vertices.cbegin(), facet_vertices.cend(),
-                     facet.begin(),
-                     [&cell_vertices_local, offset = cell_offsets[c]](auto fv)
-                     { return cell_vertices_local[offset + fv]; });
-
-      // Sort facet "indices"
-      std::sort(facet.begin(), facet.end());
-
-      // Store cell index
-      facet_to_cell.push_back(c);
-    }
-  }
+  std::vector<std::int32_t> facet_to_cell(num_facets);
+  parallel_for_ranges(
+      num_local_cells,
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t c = begin; c < end; ++c)
+        {
+          // Cell facets (local) for current cell type
+          const int num_cell_vertices = cell_offsets[c + 1] - cell_offsets[c];
+          const graph::AdjacencyList<int>& cell_facets
+              = nv_to_facets[num_cell_vertices];
+
+          // Loop over all facets of cell c
+          for (int f = 0; f < cell_facets.num_nodes(); ++f)
+          {
+            // Get data array for this facet
+            auto facet = xt::row(facets, facet_offset[c] + f);
+
+            // Get facet vertices (local indices)
+            auto facet_vertices = cell_facets.links(f);
+            assert(facet_vertices.size()
+                   <= std::size_t(max_num_facet_vertices));
+            std::transform(
+                facet_vertices.cbegin(), facet_vertices.cend(), facet.begin(),
+                [&cell_vertices_local, offset = cell_offsets[c]](auto fv)
+                { return cell_vertices_local[offset + fv]; });
+
+            // Sort facet "indices"
+            std::sort(facet.begin(), facet.end());
+
+            // Store cell index
+            facet_to_cell[facet_offset[c] + f] = c;
+          }
+        }
+      });
   assert(facet_to_cell.size() == facets.shape(0));
 
-  // Sort facets by lexicographic order of vertices
-  const std::vector<std::int32_t> facet_perm = dolfinx::sort_by_perm(facets);
+  // Sort facets by lexicographic order of vertices. Pack each facet
+  // key into a single 128-bit integer when the local vertex indices
+  // are small enough (always, in practice), replacing the
+  // column-by-column radix passes with a single argsort of the keys.
+  // The padding value maps to the all-ones digit, which preserves only
+  // equality grouping, not the unpadded lexicographic order; the
+  // matching loop below relies on equality alone.
+  std::int64_t max_vertex = -1;
+  for (std::int32_t v : cell_vertices_local)
+    max_vertex = std::max<std::int64_t>(max_vertex, v);
+  int bits_per_vertex = 1;
+  while ((std::int64_t(1) << bits_per_vertex) <= max_vertex + 1)
+    ++bits_per_vertex;
+
+  std::vector<std::int32_t> facet_perm(facets.shape(0));
+  std::iota(facet_perm.begin(), facet_perm.end(), 0);
+  if (max_num_facet_vertices * bits_per_vertex <= 127)
+  {
+    const std::uint64_t padding = (std::uint64_t(1) << bits_per_vertex) - 1;
+    std::vector<std::array<std::uint64_t, 2>> facet_keys(facets.shape(0));
+    parallel_for_ranges(
+        facets.shape(0),
+        [&](std::size_t begin, std::size_t end)
+        {
+          for (std::size_t i = begin; i < end; ++i)
+          {
+            std::array<std::uint64_t, 2> key = {0, 0};
+            for (int j = 0; j < max_num_facet_vertices; ++j)
+            {
+              const std::int32_t v = facets(i, j);
+              key[0] = (key[0] << bits_per_vertex)
+                       | (key[1] >> (64 - bits_per_vertex));
+              key[1] = (key[1] << bits_per_vertex)
+                       | (v == std::numeric_limits<std::int32_t>::max()
+                              ? padding
+                              : std::uint64_t(v));
+            }
+            facet_keys[i] = key;
+          }
+        });
+    dolfinx::argsort_radix128(
+        xtl::span<const std::array<std::uint64_t, 2>>(facet_keys),
+        xtl::span(facet_perm));
+  }
+  else
+    facet_perm = dolfinx::sort_by_perm(facets);
 
   // Iterator over facets, and push back cells that share the facet. If
   // facet is not shared, store in 'unshared_facets'.
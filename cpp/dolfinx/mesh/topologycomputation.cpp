@@ -8,6 +8,7 @@
 #include "Topology.h"
 #include "cell_types.h"
 #include <algorithm>
+#include <array>
 #include <boost/unordered_map.hpp>
 #include <cstdint>
 #include <dolfinx/common/IndexMap.h>
@@ -15,11 +16,13 @@
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/common/sort.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <memory>
 #include <numeric>
 #include <random>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -32,6 +35,82 @@ using namespace dolfinx;
 namespace
 {
 //-----------------------------------------------------------------------------
+
+/// Execute f(begin, end) over the index range [0, n), splitting the
+/// range across common::num_threads() threads. Writes from different
+/// sub-ranges must not overlap.
+template <typename Fn>
+void parallel_for_ranges(std::size_t n, Fn&& f)
+{
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads <= 1)
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    const std::size_t begin = (n * t) / num_threads;
+    const std::size_t end = (n * (t + 1)) / num_threads;
+    if (begin != end)
+      threads.emplace_back(f, begin, end);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+}
+//-----------------------------------------------------------------------------
+/// Radix argsort contiguous blocks of the permutation in parallel,
+/// then merge the sorted runs. @p argsort sorts one block of the
+/// permutation against the keys.
+template <typename K, typename Argsort>
+void parallel_block_argsort(const std::vector<K>& keys,
+                            std::vector<std::int32_t>& sort_order,
+                            Argsort&& argsort)
+{
+  const std::size_t num_rows = sort_order.size();
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads <= 1)
+  {
+    argsort(xtl::span(sort_order));
+    return;
+  }
+
+  std::vector<std::size_t> bounds(num_threads + 1);
+  for (int t = 0; t <= num_threads; ++t)
+    bounds[t] = (num_rows * t) / num_threads;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    if (bounds[t] == bounds[t + 1])
+      continue;
+    threads.emplace_back(
+        [&argsort, &sort_order](std::size_t begin, std::size_t end) {
+          argsort(xtl::span(sort_order).subspan(begin, end - begin));
+        },
+        bounds[t], bounds[t + 1]);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  auto cmp = [&keys](std::int32_t a, std::int32_t b)
+  { return keys[a] < keys[b]; };
+  for (int width = 1; width < num_threads; width *= 2)
+  {
+    for (int t = 0; t + width < num_threads; t += 2 * width)
+    {
+      std::inplace_merge(
+          std::next(sort_order.begin(), bounds[t]),
+          std::next(sort_order.begin(), bounds[t + width]),
+          std::next(sort_order.begin(),
+                    bounds[std::min(t + 2 * width, num_threads)]),
+          cmp);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 /// Get the ownership of an entity shared over several processes
 /// @param processes Set of sharing processes
 /// @param vertices Global vertex indices of entity
@@ -418,48 +497,173 @@ compute_entities_by_key_matching(
   xt::xtensor<std::int32_t, 2> entity_list(
       {num_cells * num_entities_per_cell,
        (std::size_t)max_vertices_per_entity});
-  for (std::size_t c = 0; c < num_cells; ++c)
-  {
-    // Get vertices from cell
-    auto vertices = cells.links(c);
-
-    for (int i = 0; i < num_entities_per_cell; ++i)
-    {
-      const std::int32_t idx = c * num_entities_per_cell + i;
-      auto ev = e_vertices.links(i);
-
-      // Get entity vertices padding with -1 if fewer than
-      // max_vertices_per_entity
-      entity_list(idx, max_vertices_per_entity - 1) = -1;
-      for (std::size_t j = 0; j < ev.size(); ++j)
-        entity_list(idx, j) = vertices[ev[j]];
-    }
-  }
+  parallel_for_ranges(
+      num_cells,
+      [&](std::size_t begin, std::size_t end)
+      {
+        for (std::size_t c = begin; c < end; ++c)
+        {
+          // Get vertices from cell
+          auto vertices = cells.links(c);
+
+          for (int i = 0; i < num_entities_per_cell; ++i)
+          {
+            const std::int32_t idx = c * num_entities_per_cell + i;
+            auto ev = e_vertices.links(i);
+
+            // Get entity vertices padding with -1 if fewer than
+            // max_vertices_per_entity
+            entity_list(idx, max_vertices_per_entity - 1) = -1;
+            for (std::size_t j = 0; j < ev.size(); ++j)
+              entity_list(idx, j) = vertices[ev[j]];
+          }
+        }
+      });
 
   // Copy list and sort vertices of each entity into (reverse) order
   xt::xtensor<std::int32_t, 2> entity_list_sorted = entity_list;
-  for (std::size_t i = 0; i < entity_list_sorted.shape(0); ++i)
+  parallel_for_ranges(entity_list_sorted.shape(0),
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                          std::sort(xt::row(entity_list_sorted, i).begin(),
+                                    xt::row(entity_list_sorted, i).end(),
+                                    std::greater<>());
+                        }
+                      });
+
+  const std::size_t num_rows = entity_list_sorted.shape(0);
+  std::vector<std::int32_t> sort_order(num_rows);
+  std::iota(sort_order.begin(), sort_order.end(), 0);
+
+  // Pack the sorted vertices of each entity into a single 64-bit key
+  // when the local vertex indices are small enough. A single radix
+  // argsort of the keys then replaces the column-by-column sorting
+  // pass and the duplicate test becomes a scalar comparison. Vertex
+  // indices are shifted by one so that the -1 padding maps to zero.
+  const std::int64_t num_vertices
+      = vertex_index_map.size_local() + vertex_index_map.num_ghosts();
+  int bits_per_vertex = 1;
+  while ((std::int64_t(1) << bits_per_vertex) <= num_vertices)
+    ++bits_per_vertex;
+
+  std::vector<std::int64_t> entity_keys;
+  std::vector<std::array<std::uint64_t, 2>> entity_keys128;
+  if (max_vertices_per_entity * bits_per_vertex <= 63)
   {
-    std::sort(xt::row(entity_list_sorted, i).begin(),
-              xt::row(entity_list_sorted, i).end(), std::greater<>());
+    entity_keys.resize(num_rows);
+    parallel_for_ranges(num_rows,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                          for (std::size_t i = begin; i < end; ++i)
+                          {
+                            std::int64_t key = 0;
+                            for (int j = 0; j < max_vertices_per_entity; ++j)
+                            {
+                              key = (key << bits_per_vertex)
+                                    | (entity_list_sorted(i, j) + 1);
+                            }
+                            entity_keys[i] = key;
+                          }
+                        });
+
+    parallel_block_argsort(
+        entity_keys, sort_order,
+        [keys = xtl::span<const std::int64_t>(entity_keys)](
+            xtl::span<std::int32_t> perm)
+        { dolfinx::argsort_radix<std::int64_t>(keys, perm); });
+  }
+  else if (max_vertices_per_entity * bits_per_vertex <= 127)
+  {
+    // Keys do not fit in 64 bits but do fit in 128: pack into (hi, lo)
+    // word pairs and argsort those
+    entity_keys128.resize(num_rows);
+    parallel_for_ranges(
+        num_rows,
+        [&](std::size_t begin, std::size_t end)
+        {
+          for (std::size_t i = begin; i < end; ++i)
+          {
+            std::array<std::uint64_t, 2> key = {0, 0};
+            for (int j = 0; j < max_vertices_per_entity; ++j)
+            {
+              key[0] = (key[0] << bits_per_vertex)
+                       | (key[1] >> (64 - bits_per_vertex));
+              key[1] = (key[1] << bits_per_vertex)
+                       | std::uint64_t(entity_list_sorted(i, j) + 1);
+            }
+            entity_keys128[i] = key;
+          }
+        });
+
+    parallel_block_argsort(
+        entity_keys128, sort_order,
+        [keys = xtl::span<const std::array<std::uint64_t, 2>>(entity_keys128)](
+            xtl::span<std::int32_t> perm)
+        { dolfinx::argsort_radix128(keys, perm); });
+  }
+  else
+  {
+    // Keys do not fit in 128 bits: sort the list column-by-column
+    sort_order = dolfinx::sort_by_perm(entity_list_sorted);
   }
 
-  // Sort the list and label uniquely
-  const std::vector<std::int32_t> sort_order
-      = dolfinx::sort_by_perm(entity_list_sorted);
-
-  std::vector<std::int32_t> entity_index(entity_list.shape(0), 0);
-  std::int32_t entity_count = 0;
-  std::int32_t last = sort_order[0];
-  for (std::size_t i = 1; i < sort_order.size(); ++i)
+  // Label the entities uniquely: flag each sorted position that
+  // differs from its predecessor, then prefix-sum the flags to get the
+  // entity numbers
+  std::vector<std::int32_t> unique_index(num_rows, 0);
+  if (!entity_keys.empty())
+  {
+    parallel_for_ranges(
+        num_rows,
+        [&](std::size_t begin, std::size_t end)
+        {
+          for (std::size_t i = std::max<std::size_t>(begin, 1); i < end; ++i)
+          {
+            unique_index[i]
+                = entity_keys[sort_order[i]] != entity_keys[sort_order[i - 1]];
+          }
+        });
+  }
+  else if (!entity_keys128.empty())
+  {
+    parallel_for_ranges(
+        num_rows,
+        [&](std::size_t begin, std::size_t end)
+        {
+          for (std::size_t i = std::max<std::size_t>(begin, 1); i < end; ++i)
+          {
+            unique_index[i] = entity_keys128[sort_order[i]]
+                              != entity_keys128[sort_order[i - 1]];
+          }
+        });
+  }
+  else
   {
-    std::int32_t j = sort_order[i];
-    if (xt::row(entity_list_sorted, j) != xt::row(entity_list_sorted, last))
-      ++entity_count;
-    entity_index[j] = entity_count;
-    last = j;
+    parallel_for_ranges(
+        num_rows,
+        [&](std::size_t begin, std::size_t end)
+        {
+          for (std::size_t i = std::max<std::size_t>(begin, 1); i < end; ++i)
+          {
+            unique_index[i] = xt::row(entity_list_sorted, sort_order[i])
+                              != xt::row(entity_list_sorted, sort_order[i - 1]);
+          }
+        });
   }
-  ++entity_count;
+  std::partial_sum(unique_index.begin(), unique_index.end(),
+                   unique_index.begin());
+
+  std::vector<std::int32_t> entity_index(num_rows, 0);
+  parallel_for_ranges(num_rows,
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t i = begin; i < end; ++i)
+                          entity_index[sort_order[i]] = unique_index[i];
+                      });
+  const std::int32_t entity_count
+      = unique_index.empty() ? 0 : unique_index.back() + 1;
 
   // Communicate with other processes to find out which entities are
   // ghosted and shared. Remap the numbering so that ghosts are at the
@@ -516,24 +720,77 @@ compute_from_transpose(const graph::AdjacencyList<std::int32_t>& c_d1_d0,
   LOG(INFO) << "Computing mesh connectivity " << d0 << " - " << d1
             << " from transpose.";
 
-  // Compute number of connections for each e0
-  std::vector<std::int32_t> num_connections(num_entities_d0, 0);
-  for (int e1 = 0; e1 < c_d1_d0.num_nodes(); ++e1)
+  const std::size_t num_e1 = c_d1_d0.num_nodes();
+  const int num_threads = dolfinx::common::num_threads();
+  std::vector<std::size_t> bounds(num_threads + 1);
+  for (int t = 0; t <= num_threads; ++t)
+    bounds[t] = (num_e1 * t) / num_threads;
+
+  // Compute number of connections for each e0, counting into a private
+  // array per thread to avoid write conflicts on shared entities
+  std::vector<std::vector<std::int32_t>> counts(
+      num_threads, std::vector<std::int32_t>(num_entities_d0, 0));
+  auto count_range = [&c_d1_d0](std::size_t begin, std::size_t end,
+                                std::vector<std::int32_t>& count)
+  {
+    for (std::size_t e1 = begin; e1 < end; ++e1)
+      for (std::int32_t e0 : c_d1_d0.links(e1))
+        count[e0]++;
+  };
+  if (num_threads <= 1)
+    count_range(0, num_e1, counts[0]);
+  else
   {
-    for (std::int32_t e0 : c_d1_d0.links(e1))
-      num_connections[e0]++;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+      if (bounds[t] != bounds[t + 1])
+        threads.emplace_back(count_range, bounds[t], bounds[t + 1],
+                             std::ref(counts[t]));
+    }
+    for (std::thread& thread : threads)
+      thread.join();
   }
 
-  // Compute offsets
-  std::vector<std::int32_t> offsets(num_connections.size() + 1, 0);
-  std::partial_sum(num_connections.begin(), num_connections.end(),
-                   std::next(offsets.begin()));
+  // Compute offsets over the combined counts, and turn each per-thread
+  // count into the insert position for its range: the offset plus the
+  // counts of lower-numbered threads. This reproduces the ordering of
+  // a serial pass over e1.
+  std::vector<std::int32_t> offsets(num_entities_d0 + 1, 0);
+  for (int e0 = 0; e0 < num_entities_d0; ++e0)
+  {
+    std::int32_t sum = 0;
+    for (int t = 0; t < num_threads; ++t)
+    {
+      const std::int32_t c = counts[t][e0];
+      counts[t][e0] = offsets[e0] + sum;
+      sum += c;
+    }
+    offsets[e0 + 1] = offsets[e0] + sum;
+  }
 
-  std::vector<std::int32_t> counter(num_connections.size(), 0);
   std::vector<std::int32_t> connections(offsets[offsets.size() - 1]);
-  for (int e1 = 0; e1 < c_d1_d0.num_nodes(); ++e1)
-    for (std::int32_t e0 : c_d1_d0.links(e1))
-      connections[offsets[e0] + counter[e0]++] = e1;
+  auto fill_range = [&c_d1_d0, &connections](std::size_t begin, std::size_t end,
+                                             std::vector<std::int32_t>& pos)
+  {
+    for (std::size_t e1 = begin; e1 < end; ++e1)
+      for (std::int32_t e0 : c_d1_d0.links(e1))
+        connections[pos[e0]++] = e1;
+  };
+  if (num_threads <= 1)
+    fill_range(0, num_e1, counts[0]);
+  else
+  {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+      if (bounds[t] != bounds[t + 1])
+        threads.emplace_back(fill_range, bounds[t], bounds[t + 1],
+                             std::ref(counts[t]));
+    }
+    for (std::thread& thread : threads)
+      thread.join();
+  }
 
   return graph::AdjacencyList<std::int32_t>(std::move(connections),
                                             std::move(offsets));
@@ -9,13 +9,20 @@
 #include "cell_types.h"
 #include "graphbuild.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <cstdlib>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/SharedArray.h>
+#include <dolfinx/common/ThreadPool.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/common/math.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/fem/ElementDofLayout.h>
 #include <dolfinx/graph/partition.h>
 #include <dolfinx/mesh/Mesh.h>
+#include <numeric>
 #include <stdexcept>
 #include <unordered_set>
 #include <xtensor/xadapt.hpp>
@@ -27,6 +34,41 @@
 
 using namespace dolfinx;
 
+namespace
+{
+//-----------------------------------------------------------------------------
+
+/// Execute `f(range_begin, range_end)` over [0, n) on the shared
+/// thread pool. For a single thread `f` is called directly on the full
+/// range.
+template <typename F>
+void parallel_for_ranges(std::size_t n, F&& f)
+{
+  dolfinx::common::thread_pool().parallel_for(n, f);
+}
+//-----------------------------------------------------------------------------
+
+/// Squared maximum distance between any two of the given points,
+/// stored row-major with three components per point
+double max_edge_length_squared(const double* p, int num_vertices)
+{
+  double h2 = 0.0;
+  for (int i = 0; i < num_vertices; ++i)
+  {
+    for (int j = i + 1; j < num_vertices; ++j)
+    {
+      const double dx = p[3 * i] - p[3 * j];
+      const double dy = p[3 * i + 1] - p[3 * j + 1];
+      const double dz = p[3 * i + 2] - p[3 * j + 2];
+      h2 = std::max(h2, dx * dx + dy * dy + dz * dz);
+    }
+  }
+  return h2;
+}
+//-----------------------------------------------------------------------------
+
+} // namespace
+
 //-----------------------------------------------------------------------------
 graph::AdjacencyList<std::int64_t>
 mesh::extract_topology(const CellType& cell_type,
@@ -77,31 +119,83 @@ std::vector<double> mesh::h(const Mesh& mesh,
   const xt::xtensor<double, 2>& geom_dofs = geometry.x();
   std::vector<double> h_cells(entities.size(), 0);
   assert(num_vertices <= 8);
-  xt::xtensor_fixed<double, xt::xshape<8, 3>> points;
-  for (std::size_t e = 0; e < entities.size(); ++e)
-  {
-    // Get the coordinates  of the vertices
-    auto dofs = x_dofs.links(entities[e]);
+  parallel_for_ranges(
+      entities.size(),
+      [&](std::size_t begin, std::size_t end)
+      {
+        std::array<double, 24> points;
+        for (std::size_t e = begin; e < end; ++e)
+        {
+          // Gather the coordinates of the vertices
+          auto dofs = x_dofs.links(entities[e]);
+          for (int v = 0; v < num_vertices; ++v)
+          {
+            for (int j = 0; j < 3; ++j)
+              points[3 * v + j] = geom_dofs(dofs[v], j);
+          }
 
-    // The below should work, but misbehaves with the Intel icpx compiler
-    // xt::view(points, xt::range(0, num_vertices), xt::all())
-    //     = xt::view(geom_dofs, xt::keep(dofs), xt::all());
-    auto points_view = xt::view(points, xt::range(0, num_vertices), xt::all());
-    points_view.assign(xt::view(geom_dofs, xt::keep(dofs), xt::all()));
+          // Get maximum edge length
+          h_cells[e]
+              = std::sqrt(max_edge_length_squared(points.data(), num_vertices));
+        }
+      });
 
-    // Get maximum edge length
-    for (int i = 0; i < num_vertices; ++i)
-    {
-      for (int j = i + 1; j < num_vertices; ++j)
+  return h_cells;
+}
+//-----------------------------------------------------------------------------
+std::pair<std::vector<double>, xt::xtensor<double, 2>>
+mesh::cell_metrics(const Mesh& mesh,
+                   const xtl::span<const std::int32_t>& entities, int dim)
+{
+  if (dim != mesh.topology().dim())
+    throw std::runtime_error("Cell size when dim ne tdim  requires updating.");
+
+  if (mesh.topology().cell_type() == mesh::CellType::prism and dim == 2)
+    throw std::runtime_error("More work needed for prism cell");
+
+  // Get number of cell vertices
+  const mesh::CellType type
+      = cell_entity_type(mesh.topology().cell_type(), dim, 0);
+  const int num_vertices = num_cell_vertices(type);
+
+  // Get geometry dofmap and dofs
+  const mesh::Geometry& geometry = mesh.geometry();
+  const graph::AdjacencyList<std::int32_t>& x_dofs = geometry.dofmap();
+  const xt::xtensor<double, 2>& geom_dofs = geometry.x();
+  std::vector<double> h_cells(entities.size(), 0);
+  xt::xtensor<double, 2> x_mid({entities.size(), 3});
+  assert(num_vertices <= 8);
+  parallel_for_ranges(
+      entities.size(),
+      [&](std::size_t begin, std::size_t end)
       {
-        auto p0 = xt::row(points, i);
-        auto p1 = xt::row(points, j);
-        h_cells[e] = std::max(h_cells[e], xt::norm_l2(p0 - p1)());
-      }
-    }
-  }
+        std::array<double, 24> points;
+        for (std::size_t e = begin; e < end; ++e)
+        {
+          // Gather the coordinates of the vertices once for all metrics
+          auto dofs = x_dofs.links(entities[e]);
+          for (int v = 0; v < num_vertices; ++v)
+          {
+            for (int j = 0; j < 3; ++j)
+              points[3 * v + j] = geom_dofs(dofs[v], j);
+          }
 
-  return h_cells;
+          // Maximum edge length
+          h_cells[e]
+              = std::sqrt(max_edge_length_squared(points.data(), num_vertices));
+
+          // Midpoint
+          for (int j = 0; j < 3; ++j)
+          {
+            double mid = 0.0;
+            for (int v = 0; v < num_vertices; ++v)
+              mid += points[3 * v + j];
+            x_mid(e, j) = mid / num_vertices;
+          }
+        }
+      });
+
+  return {std::move(h_cells), std::move(x_mid)};
 }
 //-----------------------------------------------------------------------------
 xt::xtensor<double, 2>
@@ -203,14 +297,22 @@ mesh::midpoints(const mesh::Mesh& mesh, int dim,
       = entities_to_geometry(mesh, dim, entities, false);
 
   xt::xtensor<double, 2> x_mid({entities.size(), 3});
-  for (std::size_t e = 0; e < entity_to_geometry.shape(0); ++e)
-  {
-    auto rows = xt::row(entity_to_geometry, e);
-    // The below should work, but misbehaves with the Intel icpx compiler
-    // xt::row(x_mid, e) = xt::mean(xt::view(x, xt::keep(rows)), 0);
-    auto _x = xt::row(x_mid, e);
-    _x.assign(xt::mean(xt::view(x, xt::keep(rows)), 0));
-  }
+  const std::size_t num_vertices = entity_to_geometry.shape(1);
+  parallel_for_ranges(entity_to_geometry.shape(0),
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t e = begin; e < end; ++e)
+                        {
+                          std::array<double, 3> mid = {0.0, 0.0, 0.0};
+                          for (std::size_t v = 0; v < num_vertices; ++v)
+                          {
+                            for (int j = 0; j < 3; ++j)
+                              mid[j] += x(entity_to_geometry(e, v), j);
+                          }
+                          for (int j = 0; j < 3; ++j)
+                            x_mid(e, j) = mid[j] / num_vertices;
+                        }
+                      });
 
   return x_mid;
 }
@@ -244,37 +346,82 @@ std::vector<std::int32_t> mesh::locate_entities(
       vertex_to_node[vertices[i]] = x_dofs[i];
   }
 
-  // Pack coordinates of vertices
+  // Pack the vertex coordinates and run the marker function in
+  // blocks, one per thread. The marker receives each block as a
+  // batched array, so a vectorized predicate stays vectorized within a
+  // block.
   const xt::xtensor<double, 2>& x_nodes = mesh.geometry().x();
-  xt::xtensor<double, 2> x_vertices({3, vertex_to_node.size()});
-  for (std::size_t i = 0; i < vertex_to_node.size(); ++i)
-    for (std::size_t j = 0; j < 3; ++j)
-      x_vertices(j, i) = x_nodes(vertex_to_node[i], j);
-
-  // Run marker function on vertex coordinates
-  const xt::xtensor<bool, 1> marked = marker(x_vertices);
-  if (marked.shape(0) != x_vertices.shape(1))
+  xt::xtensor<bool, 1> marked
+      = xt::zeros<bool>({vertex_to_node.size()});
+  std::atomic<bool> bad_marker_length(false);
+  parallel_for_ranges(vertex_to_node.size(),
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                        xt::xtensor<double, 2> x_block(
+                            {std::size_t(3), end - begin});
+                        for (std::size_t i = begin; i < end; ++i)
+                          for (std::size_t j = 0; j < 3; ++j)
+                            x_block(j, i - begin)
+                                = x_nodes(vertex_to_node[i], j);
+
+                        const xt::xtensor<bool, 1> m = marker(x_block);
+                        if (m.shape(0) != end - begin)
+                        {
+                          bad_marker_length = true;
+                          return;
+                        }
+                        std::copy(m.cbegin(), m.cend(),
+                                  std::next(marked.begin(), begin));
+                      });
+  if (bad_marker_length)
     throw std::runtime_error("Length of array of markers is wrong.");
 
-  // Iterate over entities to build vector of marked entities
+  // Iterate over entities to build vector of marked entities. An
+  // entity is marked if all of its vertices are marked.
   auto e_to_v = topology.connectivity(dim, 0);
   assert(e_to_v);
+  const std::int32_t num_entities = e_to_v->num_nodes();
+  const auto entity_marked = [&](std::int32_t e)
+  {
+    auto vertices = e_to_v->links(e);
+    return std::all_of(vertices.begin(), vertices.end(),
+                       [&marked](std::int32_t v) { return marked[v]; });
+  };
+
   std::vector<std::int32_t> entities;
-  for (int e = 0; e < e_to_v->num_nodes(); ++e)
+  common::ThreadPool& pool = common::thread_pool();
+  const int num_threads = pool.num_workers() + 1;
+  if (num_threads <= 1)
   {
-    // Iterate over entity vertices
-    bool all_vertices_marked = true;
-    for (std::int32_t v : e_to_v->links(e))
+    for (std::int32_t e = 0; e < num_entities; ++e)
+      if (entity_marked(e))
+        entities.push_back(e);
+  }
+  else
+  {
+    // Reduce each chunk of entities into its own list on the shared
+    // pool, then concatenate in chunk order to preserve the serial
+    // ordering
+    std::vector<std::vector<std::int32_t>> chunks(num_threads);
     {
-      if (!marked[v])
+      common::ThreadPool::TaskGroup tasks(pool);
+      for (int t = 0; t < num_threads; ++t)
       {
-        all_vertices_marked = false;
-        break;
+        tasks.run(
+            [&, t]()
+            {
+              const std::int32_t begin
+                  = (std::int64_t(num_entities) * t) / num_threads;
+              const std::int32_t end
+                  = (std::int64_t(num_entities) * (t + 1)) / num_threads;
+              for (std::int32_t e = begin; e < end; ++e)
+                if (entity_marked(e))
+                  chunks[t].push_back(e);
+            });
       }
     }
-
-    if (all_vertices_marked)
-      entities.push_back(e);
+    for (const std::vector<std::int32_t>& chunk : chunks)
+      entities.insert(entities.end(), chunk.begin(), chunk.end());
   }
 
   return entities;
@@ -293,10 +440,10 @@ std::vector<std::int32_t> mesh::locate_entities_boundary(
         "Cannot use mesh::locate_entities_boundary (boundary) for cells.");
   }
 
-  // Compute marker for boundary facets
+  // Get the boundary facets (computed once and cached on the topology)
   mesh.topology_mutable().create_entities(tdim - 1);
-  mesh.topology_mutable().create_connectivity(tdim - 1, tdim);
-  const std::vector boundary_facet = mesh::compute_boundary_facets(topology);
+  const std::vector<std::int32_t>& boundary_facets
+      = mesh.topology_mutable().exterior_facets();
 
   // Create entities and connectivities
   mesh.topology_mutable().create_entities(dim);
@@ -312,16 +459,13 @@ std::vector<std::int32_t> mesh::locate_entities_boundary(
   assert(f_to_e);
   std::unordered_set<std::int32_t> boundary_vertices;
   std::unordered_set<std::int32_t> facet_entities;
-  for (std::size_t f = 0; f < boundary_facet.size(); ++f)
+  for (std::int32_t f : boundary_facets)
   {
-    if (boundary_facet[f])
-    {
-      for (auto e : f_to_e->links(f))
-        facet_entities.insert(e);
+    for (auto e : f_to_e->links(f))
+      facet_entities.insert(e);
 
-      for (auto v : f_to_v->links(f))
-        boundary_vertices.insert(v);
-    }
+    for (auto v : f_to_v->links(f))
+      boundary_vertices.insert(v);
   }
 
   // Get geometry data
@@ -337,54 +481,96 @@ std::vector<std::int32_t> mesh::locate_entities_boundary(
   assert(v_to_c);
   auto c_to_v = topology.connectivity(tdim, 0);
   assert(c_to_v);
-  xt::xtensor<double, 2> x_vertices({3, vertices.size()});
   std::vector<std::int32_t> vertex_to_pos(v_to_c->num_nodes(), -1);
   for (std::size_t i = 0; i < vertices.size(); ++i)
-  {
-    const std::int32_t v = vertices[i];
+    vertex_to_pos[vertices[i]] = i;
 
-    // Get first cell and find position
-    const int c = v_to_c->links(v)[0];
-    auto vertices = c_to_v->links(c);
-    auto it = std::find(vertices.begin(), vertices.end(), v);
-    assert(it != vertices.end());
-    const int local_pos = std::distance(vertices.begin(), it);
+  // Pack the boundary vertex coordinates and run the marker function
+  // in blocks, one per thread. The marker receives each block as a
+  // batched array, so a vectorized predicate stays vectorized within a
+  // block.
+  xt::xtensor<bool, 1> marked = xt::zeros<bool>({vertices.size()});
+  std::atomic<bool> bad_marker_length(false);
+  parallel_for_ranges(
+      vertices.size(),
+      [&](std::size_t begin, std::size_t end)
+      {
+        xt::xtensor<double, 2> x_block({std::size_t(3), end - begin});
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          const std::int32_t v = vertices[i];
 
-    auto dofs = x_dofmap.links(c);
-    for (int j = 0; j < 3; ++j)
-      x_vertices(j, i) = x_nodes(dofs[local_pos], j);
+          // Get first cell and find position
+          const int c = v_to_c->links(v)[0];
+          auto cell_vertices = c_to_v->links(c);
+          auto it = std::find(cell_vertices.begin(), cell_vertices.end(), v);
+          assert(it != cell_vertices.end());
+          const int local_pos = std::distance(cell_vertices.begin(), it);
 
-    vertex_to_pos[v] = i;
-  }
+          auto dofs = x_dofmap.links(c);
+          for (int j = 0; j < 3; ++j)
+            x_block(j, i - begin) = x_nodes(dofs[local_pos], j);
+        }
 
-  // Run marker function on the vertex coordinates
-  const xt::xtensor<bool, 1> marked = marker(x_vertices);
-  if (marked.shape(0) != x_vertices.shape(1))
+        const xt::xtensor<bool, 1> m = marker(x_block);
+        if (m.shape(0) != end - begin)
+        {
+          bad_marker_length = true;
+          return;
+        }
+        std::copy(m.cbegin(), m.cend(), std::next(marked.begin(), begin));
+      });
+  if (bad_marker_length)
     throw std::runtime_error("Length of array of markers is wrong.");
 
-  // Loop over entities and check vertex markers
+  // Loop over entities and check vertex markers. The candidate
+  // entities are sorted so the result does not depend on the set
+  // iteration order.
   auto e_to_v = topology.connectivity(dim, 0);
   assert(e_to_v);
-  std::vector<std::int32_t> entities;
-  for (auto e : facet_entities)
+  std::vector<std::int32_t> candidates(facet_entities.begin(),
+                                       facet_entities.end());
+  std::sort(candidates.begin(), candidates.end());
+  const auto entity_marked = [&](std::int32_t e)
   {
-    // Assume all vertices on this entity are marked
-    bool all_vertices_marked = true;
+    auto entity_vertices = e_to_v->links(e);
+    return std::all_of(entity_vertices.begin(), entity_vertices.end(),
+                       [&](std::int32_t v)
+                       { return marked[vertex_to_pos[v]]; });
+  };
 
-    // Iterate over entity vertices
-    for (auto v : e_to_v->links(e))
+  std::vector<std::int32_t> entities;
+  common::ThreadPool& pool = common::thread_pool();
+  const int num_threads = pool.num_workers() + 1;
+  const std::size_t num_candidates = candidates.size();
+  if (num_threads <= 1)
+  {
+    for (std::int32_t e : candidates)
+      if (entity_marked(e))
+        entities.push_back(e);
+  }
+  else
+  {
+    // Reduce each chunk of candidates into its own list on the shared
+    // pool, then concatenate in chunk order to preserve the ordering
+    std::vector<std::vector<std::int32_t>> chunks(num_threads);
     {
-      const std::int32_t pos = vertex_to_pos[v];
-      if (!marked[pos])
+      common::ThreadPool::TaskGroup tasks(pool);
+      for (int t = 0; t < num_threads; ++t)
       {
-        all_vertices_marked = false;
-        break;
+        tasks.run(
+            [&, t]()
+            {
+              const std::size_t begin = (num_candidates * t) / num_threads;
+              const std::size_t end = (num_candidates * (t + 1)) / num_threads;
+              for (std::size_t i = begin; i < end; ++i)
+                if (entity_marked(candidates[i]))
+                  chunks[t].push_back(candidates[i]);
+            });
       }
     }
-
-    // Mark facet with all vertices marked
-    if (all_vertices_marked)
-      entities.push_back(e);
+    for (const std::vector<std::int32_t>& chunk : chunks)
+      entities.insert(entities.end(), chunk.begin(), chunk.end());
   }
 
   return entities;
@@ -474,39 +660,8 @@ mesh::entities_to_geometry(const mesh::Mesh& mesh, int dim,
 //------------------------------------------------------------------------
 std::vector<std::int32_t> mesh::exterior_facet_indices(const Mesh& mesh)
 {
-  // Note: Possible duplication of mesh::Topology::compute_boundary_facets
-
-  const mesh::Topology& topology = mesh.topology();
-  std::vector<std::int32_t> surface_facets;
-
-  // Get number of facets owned by this process
-  const int tdim = topology.dim();
-  mesh.topology_mutable().create_connectivity(tdim - 1, tdim);
-  auto f_to_c = topology.connectivity(tdim - 1, tdim);
-  assert(topology.index_map(tdim - 1));
-
-  // Only need to consider shared facets when there are no ghost cells
-  std::set<std::int32_t> fwd_shared_facets;
-  if (topology.index_map(tdim)->num_ghosts() == 0)
-  {
-    fwd_shared_facets.insert(
-        topology.index_map(tdim - 1)->scatter_fwd_indices().array().begin(),
-        topology.index_map(tdim - 1)->scatter_fwd_indices().array().end());
-  }
-
-  // Find all owned facets (not ghost) with only one attached cell, which are
-  // also not shared forward (ghost on another process)
-  const int num_facets = topology.index_map(tdim - 1)->size_local();
-  for (int f = 0; f < num_facets; ++f)
-  {
-    if (f_to_c->num_links(f) == 1
-        and fwd_shared_facets.find(f) == fwd_shared_facets.end())
-    {
-      surface_facets.push_back(f);
-    }
-  }
-
-  return surface_facets;
+  // The list is computed once and cached on the topology
+  return mesh.topology_mutable().exterior_facets();
 }
 //------------------------------------------------------------------------------
 graph::AdjacencyList<std::int32_t>
@@ -523,9 +678,21 @@ mesh::partition_cells_graph(MPI_Comm comm, int n, int tdim,
                             const graph::AdjacencyList<std::int64_t>& cells,
                             mesh::GhostMode ghost_mode,
                             const graph::partition_fn& partfn)
+{
+  return partition_cells_graph(comm, n, tdim, cells, ghost_mode, 1, partfn);
+}
+//-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t>
+mesh::partition_cells_graph(MPI_Comm comm, int n, int tdim,
+                            const graph::AdjacencyList<std::int64_t>& cells,
+                            mesh::GhostMode ghost_mode, int num_ghost_layers,
+                            const graph::partition_fn& partfn)
 {
   LOG(INFO) << "Compute partition of cells across ranks";
 
+  if (num_ghost_layers < 1)
+    throw std::runtime_error("Number of ghost layers must be at least 1.");
+
   // Compute distributed dual graph (for the cells on this process)
   const auto [dual_graph, num_ghost_edges]
       = mesh::build_dual_graph(comm, cells, tdim);
@@ -534,6 +701,485 @@ mesh::partition_cells_graph(MPI_Comm comm, int n, int tdim,
   bool ghosting = (ghost_mode != mesh::GhostMode::none);
 
   // Compute partition
-  return partfn(comm, n, dual_graph, num_ghost_edges, ghosting);
+  graph::AdjacencyList<std::int32_t> dest
+      = partfn(comm, n, dual_graph, num_ghost_edges, ghosting);
+
+  // Grow the one-layer overlap from the partitioner to the requested
+  // depth on the dual graph
+  if (ghosting and num_ghost_layers > 1)
+  {
+    dest = graph::build::expand_destinations(comm, dual_graph, dest,
+                                             num_ghost_layers);
+  }
+
+  return dest;
+}
+//-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t>
+mesh::partition_cells_graph(MPI_Comm comm, int n, int tdim,
+                            const graph::AdjacencyList<std::int64_t>& cells,
+                            mesh::GhostMode ghost_mode,
+                            const xtl::span<const std::int32_t>& cell_weights)
+{
+  return partition_cells_graph(comm, n, tdim, cells, ghost_mode, cell_weights,
+                               &graph::partition_graph_weighted);
+}
+//-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t>
+mesh::partition_cells_graph(MPI_Comm comm, int n, int tdim,
+                            const graph::AdjacencyList<std::int64_t>& cells,
+                            mesh::GhostMode ghost_mode,
+                            const xtl::span<const std::int32_t>& cell_weights,
+                            const graph::partition_fn_weighted& partfn)
+{
+  LOG(INFO) << "Compute weighted partition of cells across ranks";
+
+  // Compute distributed dual graph (for the cells on this process)
+  const auto [dual_graph, num_ghost_edges]
+      = mesh::build_dual_graph(comm, cells, tdim);
+
+  // Just flag any kind of ghosting for now
+  bool ghosting = (ghost_mode != mesh::GhostMode::none);
+
+  // Compute partition with cell weights attached to the dual graph
+  // nodes
+  return partfn(comm, n, dual_graph, cell_weights, num_ghost_edges, ghosting);
+}
+//-----------------------------------------------------------------------------
+namespace
+{
+/// Compute, on a shared-memory node communicator, the union of the
+/// per-rank global keys. Every rank learns, for each of its local
+/// keys, the position of the key in the (sorted) union, and the set of
+/// union positions it is responsible for writing: each union entry is
+/// assigned to its lowest-rank contributor, so every entry has exactly
+/// one writer. The union itself is only formed transiently on the node
+/// root. Collective on @p node_comm.
+/// @param[in] node_comm Node (shared-memory) communicator
+/// @param[in] keys Global keys on this rank (no duplicates)
+/// @return (Position in the union of each local key; local positions
+/// of the keys this rank must write; their union positions; size of
+/// the union)
+std::tuple<std::vector<std::int32_t>, std::vector<std::int32_t>,
+           std::vector<std::int32_t>, std::int64_t>
+build_node_union(MPI_Comm node_comm, const xtl::span<const std::int64_t>& keys)
+{
+  const int rank = dolfinx::MPI::rank(node_comm);
+  const int size = dolfinx::MPI::size(node_comm);
+
+  // Gather the keys of all ranks of the node on the node root
+  const int num_local = keys.size();
+  std::vector<int> counts(size), disp(size + 1, 0);
+  MPI_Gather(&num_local, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, node_comm);
+  std::partial_sum(counts.begin(), counts.end(), std::next(disp.begin()));
+  std::vector<std::int64_t> all_keys(disp.back());
+  MPI_Gatherv(keys.data(), num_local, MPI_INT64_T, all_keys.data(),
+              counts.data(), disp.data(), MPI_INT64_T, 0, node_comm);
+
+  // On the root: number the unique keys, record the union position of
+  // every gathered key, and assign each union entry to its
+  // lowest-rank contributor
+  std::int64_t union_size = 0;
+  std::vector<std::int32_t> all_map(all_keys.size());
+  std::vector<int> a_counts(size, 0), a_disp(size + 1, 0);
+  std::vector<std::int32_t> a_local, a_union;
+  if (rank == 0)
+  {
+    std::vector<std::int32_t> perm(all_keys.size());
+    std::iota(perm.begin(), perm.end(), 0);
+    std::stable_sort(perm.begin(), perm.end(),
+                     [&all_keys](std::int32_t a, std::int32_t b)
+                     { return all_keys[a] < all_keys[b]; });
+
+    std::vector<std::vector<std::int32_t>> assign_local(size),
+        assign_union(size);
+    std::int64_t prev_key = 0;
+    for (std::int32_t e : perm)
+    {
+      if (union_size == 0 or all_keys[e] != prev_key)
+      {
+        // First contributor of a new key (lowest rank, since the
+        // gathered keys are ordered by rank and the sort is stable)
+        const int r = std::distance(
+            disp.begin(), std::upper_bound(disp.begin(), disp.end(), e)) - 1;
+        assign_local[r].push_back(e - disp[r]);
+        assign_union[r].push_back(union_size);
+        prev_key = all_keys[e];
+        ++union_size;
+      }
+      all_map[e] = union_size - 1;
+    }
+
+    for (int r = 0; r < size; ++r)
+      a_counts[r] = assign_local[r].size();
+    std::partial_sum(a_counts.begin(), a_counts.end(),
+                     std::next(a_disp.begin()));
+    a_local.reserve(a_disp.back());
+    a_union.reserve(a_disp.back());
+    for (int r = 0; r < size; ++r)
+    {
+      a_local.insert(a_local.end(), assign_local[r].begin(),
+                     assign_local[r].end());
+      a_union.insert(a_union.end(), assign_union[r].begin(),
+                     assign_union[r].end());
+    }
+  }
+
+  // Send each rank the union positions of its keys and its write
+  // assignments
+  MPI_Bcast(&union_size, 1, MPI_INT64_T, 0, node_comm);
+  std::vector<std::int32_t> local_to_union(num_local);
+  MPI_Scatterv(all_map.data(), counts.data(), disp.data(), MPI_INT32_T,
+               local_to_union.data(), num_local, MPI_INT32_T, 0, node_comm);
+  int num_assigned = 0;
+  MPI_Scatter(a_counts.data(), 1, MPI_INT, &num_assigned, 1, MPI_INT, 0,
+              node_comm);
+  std::vector<std::int32_t> write_local(num_assigned),
+      write_union(num_assigned);
+  MPI_Scatterv(a_local.data(), a_counts.data(), a_disp.data(), MPI_INT32_T,
+               write_local.data(), num_assigned, MPI_INT32_T, 0, node_comm);
+  MPI_Scatterv(a_union.data(), a_counts.data(), a_disp.data(), MPI_INT32_T,
+               write_union.data(), num_assigned, MPI_INT32_T, 0, node_comm);
+
+  return {std::move(local_to_union), std::move(write_local),
+          std::move(write_union), union_size};
+}
+} // namespace
+//-----------------------------------------------------------------------------
+std::pair<std::shared_ptr<const common::SharedArray<double>>,
+          std::vector<std::int32_t>>
+mesh::create_shared_coordinates(const Mesh& mesh)
+{
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(mesh.mpi_comm(), MPI_COMM_TYPE_SHARED,
+                      dolfinx::MPI::rank(mesh.mpi_comm()), MPI_INFO_NULL,
+                      &node_comm);
+
+  // De-duplicate the geometry nodes of the ranks on this node by
+  // input global index
+  const std::vector<std::int64_t>& igi
+      = mesh.geometry().input_global_indices();
+  auto [local_to_shared, write_local, write_union, num_shared]
+      = build_node_union(node_comm, igi);
+
+  LOG(INFO) << "Sharing " << num_shared << " geometry nodes across "
+            << dolfinx::MPI::size(node_comm) << " ranks of the node";
+
+  // Each rank packs the coordinates of the nodes it is the assigned
+  // writer of, and copies them into their shared rows
+  auto x = std::make_shared<common::SharedArray<double>>(node_comm,
+                                                         3 * num_shared);
+  std::vector<double> coords(3 * write_local.size());
+  mesh.geometry().pack_x(write_local, coords);
+  xtl::span<double> xs = x->array();
+  for (std::size_t i = 0; i < write_local.size(); ++i)
+  {
+    std::copy_n(std::next(coords.begin(), 3 * i), 3,
+                std::next(xs.begin(), 3 * std::size_t(write_union[i])));
+  }
+  x->sync();
+
+  MPI_Comm_free(&node_comm);
+  return {std::move(x), std::move(local_to_shared)};
+}
+//-----------------------------------------------------------------------------
+std::tuple<std::shared_ptr<const common::SharedArray<std::int64_t>>, int,
+           std::vector<std::int32_t>>
+mesh::create_shared_connectivity(const Mesh& mesh, int d0, int d1)
+{
+  std::shared_ptr<const graph::AdjacencyList<std::int32_t>> c
+      = mesh.topology().connectivity(d0, d1);
+  if (!c)
+    throw std::runtime_error("Connectivity has not been computed.");
+  std::shared_ptr<const common::IndexMap> map0 = mesh.topology().index_map(d0);
+  std::shared_ptr<const common::IndexMap> map1 = mesh.topology().index_map(d1);
+  assert(map0);
+  assert(map1);
+
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(mesh.mpi_comm(), MPI_COMM_TYPE_SHARED,
+                      dolfinx::MPI::rank(mesh.mpi_comm()), MPI_INFO_NULL,
+                      &node_comm);
+
+  // The shared rows have a fixed width, so the connectivity must have
+  // a constant degree, consistent across the ranks of the node
+  const std::int32_t num_entities = c->num_nodes();
+  int degree = num_entities > 0 ? c->num_links(0) : 0;
+  MPI_Allreduce(MPI_IN_PLACE, &degree, 1, MPI_INT, MPI_MAX, node_comm);
+  for (std::int32_t e = 0; e < num_entities; ++e)
+  {
+    if (c->num_links(e) != degree)
+    {
+      throw std::runtime_error(
+          "Shared connectivity requires a fixed degree.");
+    }
+  }
+
+  // De-duplicate the entities of the ranks on this node by global
+  // entity index
+  const std::vector<std::int64_t> keys = map0->global_indices();
+  assert((std::int32_t)keys.size() == num_entities);
+  auto [local_to_shared, write_local, write_union, num_shared]
+      = build_node_union(node_comm, keys);
+
+  LOG(INFO) << "Sharing " << num_shared << " (" << d0 << ", " << d1
+            << ") connectivity rows across " << dolfinx::MPI::size(node_comm)
+            << " ranks of the node";
+
+  // Each rank fills the rows it is the assigned writer of, translating
+  // the links to global indices
+  auto array = std::make_shared<common::SharedArray<std::int64_t>>(
+      node_comm, std::size_t(degree) * num_shared);
+  xtl::span<std::int64_t> a = array->array();
+  for (std::size_t i = 0; i < write_local.size(); ++i)
+  {
+    map1->local_to_global(
+        c->links(write_local[i]),
+        a.subspan(std::size_t(degree) * write_union[i], degree));
+  }
+  array->sync();
+
+  MPI_Comm_free(&node_comm);
+  return {std::move(array), degree, std::move(local_to_shared)};
+}
+//-----------------------------------------------------------------------------
+namespace
+{
+/// Create a compact IndexMap for a subset of the indices of a parent
+/// map, keeping the owning rank of every index. With @p mark_owner
+/// true the owners of the ghost indices in the subset are told to
+/// include them, so every ghost has an owned counterpart on its owner;
+/// with @p mark_owner false, ghost indices whose owner did not include
+/// them are dropped from the subset. Collective on @p comm.
+/// @param[in] comm The MPI communicator of the parent map
+/// @param[in] map The parent index map
+/// @param[in] indices Sorted unique parent local indices of the subset
+/// @param[in] mark_owner Force inclusion of ghosted indices on their
+/// owning rank
+/// @return (the sub-IndexMap, the parent local index of each sub
+/// index, owned indices first)
+std::pair<std::shared_ptr<common::IndexMap>, std::vector<std::int32_t>>
+create_sub_index_map(MPI_Comm comm, const common::IndexMap& map,
+                     const xtl::span<const std::int32_t>& indices,
+                     bool mark_owner)
+{
+  const std::int32_t size_local = map.size_local();
+  std::vector<std::int32_t> owned, ghost;
+  for (std::int32_t i : indices)
+  {
+    if (i < size_local)
+      owned.push_back(i);
+    else
+      ghost.push_back(i);
+  }
+
+  if (mark_owner)
+  {
+    // Ask the owners of the ghost indices in the subset to include
+    // them, so that every retained ghost resolves to an owned index
+    std::vector<std::int32_t> marker(size_local, 0),
+        marker_ghost(map.num_ghosts(), 0);
+    for (std::int32_t i : owned)
+      marker[i] = 1;
+    for (std::int32_t i : ghost)
+      marker_ghost[i - size_local] = 1;
+    map.scatter_rev(xtl::span<std::int32_t>(marker),
+                    xtl::span<const std::int32_t>(marker_ghost), 1,
+                    common::IndexMap::Mode::add);
+    owned.clear();
+    for (std::int32_t i = 0; i < size_local; ++i)
+    {
+      if (marker[i] > 0)
+        owned.push_back(i);
+    }
+  }
+
+  // Number the owned subset entries and send the new global indices
+  // to the ranks ghosting them
+  std::int64_t offset = 0;
+  const std::int64_t num_owned = owned.size();
+  MPI_Exscan(&num_owned, &offset, 1, MPI_INT64_T, MPI_SUM, comm);
+  std::vector<std::int64_t> global_owned(size_local, -1);
+  for (std::size_t i = 0; i < owned.size(); ++i)
+    global_owned[owned[i]] = offset + std::int64_t(i);
+  std::vector<std::int64_t> global_ghost(map.num_ghosts());
+  map.scatter_fwd(xtl::span<const std::int64_t>(global_owned),
+                  xtl::span<std::int64_t>(global_ghost), 1);
+
+  // Ghost indices whose owner has not included them cannot be ghosted
+  // in the sub-map
+  std::vector<std::int32_t> sub_to_parent(owned);
+  std::vector<std::int64_t> ghosts;
+  for (std::int32_t i : ghost)
+  {
+    if (std::int64_t gi = global_ghost[i - size_local]; gi >= 0)
+    {
+      ghosts.push_back(gi);
+      sub_to_parent.push_back(i);
+    }
+  }
+
+  auto submap = std::make_shared<common::IndexMap>(
+      common::create_index_map(comm, std::int32_t(owned.size()), ghosts));
+  return {std::move(submap), std::move(sub_to_parent)};
+}
+} // namespace
+//-----------------------------------------------------------------------------
+std::tuple<mesh::Mesh, std::vector<std::int32_t>, std::vector<std::int32_t>,
+           std::vector<std::int32_t>>
+mesh::create_submesh(const Mesh& mesh, int dim,
+                     const xtl::span<const std::int32_t>& entities)
+{
+  MPI_Comm comm = mesh.mpi_comm();
+  const Topology& topology = mesh.topology();
+  const int tdim = topology.dim();
+  mesh.topology_mutable().create_entities(dim);
+  mesh.topology_mutable().create_connectivity(dim, 0);
+
+  // Compact index map for the submesh cells
+  std::vector<std::int32_t> unique_entities(entities.begin(), entities.end());
+  std::sort(unique_entities.begin(), unique_entities.end());
+  unique_entities.erase(
+      std::unique(unique_entities.begin(), unique_entities.end()),
+      unique_entities.end());
+  auto map_e = topology.index_map(dim);
+  assert(map_e);
+  auto [submap_e, entity_map]
+      = create_sub_index_map(comm, *map_e, unique_entities, false);
+
+  // Compact index map for the vertices of the submesh cells
+  auto e_to_v = topology.connectivity(dim, 0);
+  assert(e_to_v);
+  std::vector<std::int32_t> parent_vertices;
+  for (std::int32_t e : entity_map)
+  {
+    auto vtx = e_to_v->links(e);
+    parent_vertices.insert(parent_vertices.end(), vtx.begin(), vtx.end());
+  }
+  std::sort(parent_vertices.begin(), parent_vertices.end());
+  parent_vertices.erase(
+      std::unique(parent_vertices.begin(), parent_vertices.end()),
+      parent_vertices.end());
+  auto map_v = topology.index_map(0);
+  assert(map_v);
+  auto [submap_v, vertex_map]
+      = create_sub_index_map(comm, *map_v, parent_vertices, true);
+  std::vector<std::int32_t> vertex_parent_to_sub(
+      map_v->size_local() + map_v->num_ghosts(), -1);
+  for (std::size_t i = 0; i < vertex_map.size(); ++i)
+    vertex_parent_to_sub[vertex_map[i]] = std::int32_t(i);
+
+  // Build the submesh topology: the cell-vertex connectivity in
+  // submesh indexing, and the usual identity vertex 'connectivity'
+  const CellType entity_type
+      = mesh::cell_entity_type(topology.cell_type(), dim, 0);
+  const int num_entity_vertices = mesh::num_cell_vertices(entity_type);
+  std::vector<std::int32_t> conn;
+  conn.reserve(entity_map.size() * num_entity_vertices);
+  for (std::int32_t e : entity_map)
+  {
+    for (std::int32_t v : e_to_v->links(e))
+    {
+      assert(vertex_parent_to_sub[v] >= 0);
+      conn.push_back(vertex_parent_to_sub[v]);
+    }
+  }
+  std::vector<std::int32_t> offsets(entity_map.size() + 1, 0);
+  for (std::size_t e = 0; e < entity_map.size(); ++e)
+    offsets[e + 1] = offsets[e] + num_entity_vertices;
+
+  Topology subtopology(comm, entity_type);
+  subtopology.set_index_map(0, submap_v);
+  subtopology.set_index_map(dim, submap_e);
+  subtopology.set_connectivity(
+      std::make_shared<graph::AdjacencyList<std::int32_t>>(
+          submap_v->size_local() + submap_v->num_ghosts()),
+      0, 0);
+  subtopology.set_connectivity(
+      std::make_shared<graph::AdjacencyList<std::int32_t>>(std::move(conn),
+                                                           std::move(offsets)),
+      dim, 0);
+
+  // Geometry points of each submesh cell, in parent indexing. For
+  // dim == tdim the geometry dofmap rows carry over verbatim (any
+  // coordinate degree); for lower-dimensional entities only the
+  // vertex points are recoverable, so the geometry must be affine.
+  const Geometry& geometry = mesh.geometry();
+  const graph::AdjacencyList<std::int32_t>& xdofs = geometry.dofmap();
+  std::vector<std::int32_t> cell_xdofs;
+  if (dim == tdim)
+  {
+    for (std::int32_t e : entity_map)
+    {
+      auto xd = xdofs.links(e);
+      cell_xdofs.insert(cell_xdofs.end(), xd.begin(), xd.end());
+    }
+  }
+  else
+  {
+    if (xdofs.num_nodes() > 0
+        and xdofs.num_links(0)
+                != mesh::num_cell_vertices(topology.cell_type()))
+    {
+      throw std::runtime_error(
+          "Submesh creation for entities of lower dimension requires an "
+          "affine (degree 1) mesh geometry.");
+    }
+    xt::xtensor<std::int32_t, 2> e_to_g
+        = entities_to_geometry(mesh, dim, entity_map, false);
+    cell_xdofs.assign(e_to_g.begin(), e_to_g.end());
+  }
+  const fem::CoordinateElement sub_cmap
+      = dim == tdim ? geometry.cmap()
+                    : fem::CoordinateElement(entity_type, 1);
+
+  // Compact index map for the retained geometry points
+  std::vector<std::int32_t> parent_xdofs(cell_xdofs);
+  std::sort(parent_xdofs.begin(), parent_xdofs.end());
+  parent_xdofs.erase(std::unique(parent_xdofs.begin(), parent_xdofs.end()),
+                     parent_xdofs.end());
+  auto map_x = geometry.index_map();
+  assert(map_x);
+  auto [submap_x, xdof_map]
+      = create_sub_index_map(comm, *map_x, parent_xdofs, true);
+  std::vector<std::int32_t> xdof_parent_to_sub(
+      map_x->size_local() + map_x->num_ghosts(), -1);
+  for (std::size_t i = 0; i < xdof_map.size(); ++i)
+    xdof_parent_to_sub[xdof_map[i]] = std::int32_t(i);
+
+  // Submesh geometry dofmap in submesh indexing
+  const int num_cell_xdofs
+      = entity_map.empty() ? 0 : int(cell_xdofs.size() / entity_map.size());
+  std::vector<std::int32_t> sub_xdofs(cell_xdofs.size());
+  std::transform(cell_xdofs.begin(), cell_xdofs.end(), sub_xdofs.begin(),
+                 [&xdof_parent_to_sub](std::int32_t d)
+                 { return xdof_parent_to_sub[d]; });
+  std::vector<std::int32_t> xoffsets(entity_map.size() + 1, 0);
+  for (std::size_t e = 0; e < entity_map.size(); ++e)
+    xoffsets[e + 1] = xoffsets[e] + num_cell_xdofs;
+
+  // Coordinates and input global indices of the retained points
+  const xt::xtensor<double, 2>& x = geometry.x();
+  const std::size_t gdim = geometry.dim();
+  xt::xtensor<double, 2> sub_x({xdof_map.size(), gdim});
+  std::vector<std::int64_t> igi = geometry.input_global_indices();
+  if (igi.empty())
+    igi = map_x->global_indices();
+  std::vector<std::int64_t> sub_igi(xdof_map.size());
+  for (std::size_t i = 0; i < xdof_map.size(); ++i)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+      sub_x(i, j) = x(xdof_map[i], j);
+    sub_igi[i] = igi[xdof_map[i]];
+  }
+
+  Geometry subgeometry(
+      submap_x,
+      graph::AdjacencyList<std::int32_t>(std::move(sub_xdofs),
+                                         std::move(xoffsets)),
+      sub_cmap, std::move(sub_x), std::move(sub_igi));
+
+  return {Mesh(comm, std::move(subtopology), std::move(subgeometry)),
+          std::move(entity_map), std::move(vertex_map), std::move(xdof_map)};
 }
 //-----------------------------------------------------------------------------
@@ -6,12 +6,23 @@
 
 #pragma once
 
+#include "Mesh.h"
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/graph/partition.h>
 #include <functional>
+#include <memory>
 #include <mpi.h>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include <xtl/xspan.hpp>
 
+namespace dolfinx::common
+{
+template <typename T>
+class SharedArray;
+}
+
 namespace dolfinx::fem
 {
 class ElementDofLayout;
@@ -40,6 +51,21 @@ extract_topology(const CellType& cell_type, const fem::ElementDofLayout& layout,
 std::vector<double> h(const Mesh& mesh,
                       const xtl::span<const std::int32_t>& entities, int dim);
 
+/// Compute the greatest distance between any two vertices (h) and the
+/// vertex midpoint of mesh entities. Equivalent to calling h() and
+/// midpoints(), but the entity coordinates are gathered only once, so
+/// it is preferable when several metrics are evaluated over the full
+/// mesh, e.g. in each adaptivity cycle.
+/// @param[in] mesh The mesh
+/// @param[in] entities List of entity indices (local)
+/// @param[in] dim Topological dimension of the entities. Must equal the
+/// topological dimension of the mesh.
+/// @return (0) Greatest vertex distance and (1) vertex midpoint for
+/// each entity
+std::pair<std::vector<double>, xt::xtensor<double, 2>>
+cell_metrics(const Mesh& mesh, const xtl::span<const std::int32_t>& entities,
+             int dim);
+
 /// Compute normal to given cell (viewed as embedded in 3D)
 xt::xtensor<double, 2>
 cell_normals(const Mesh& mesh, int dim,
@@ -112,6 +138,35 @@ entities_to_geometry(const mesh::Mesh& mesh, int dim,
 /// @return List of facet indices of exterior facets of the mesh
 std::vector<std::int32_t> exterior_facet_indices(const Mesh& mesh);
 
+/// Create a self-contained mesh from a subset of the entities of a
+/// mesh, e.g. a tagged subdomain or a boundary region. The submesh has
+/// compact index maps for its cells and vertices and a geometry
+/// restricted to the points its cells touch, so auxiliary problems
+/// posed on the subdomain carry submesh-sized (rather than full-mesh)
+/// dofmaps and vectors. The returned maps give the parent index of
+/// every submesh cell, vertex and geometry point for transferring data
+/// between the meshes.
+///
+/// A vertex on an inter-process boundary keeps its parent owner, so a
+/// rank can own submesh vertices that none of its own submesh cells
+/// use. Ghost entities whose owning rank does not include them in
+/// @p entities are dropped from the submesh.
+///
+/// @note For entities of lower dimension than the mesh cells the
+/// geometry must be affine (degree 1).
+/// @note Collective
+/// @param[in] mesh The mesh
+/// @param[in] dim Topological dimension of the entities to extract
+/// @param[in] entities Indices (local to process) of the entities to
+/// extract, e.g. from MeshTags. May include ghost entities.
+/// @return The submesh, and the parent entity index of each submesh
+/// cell, the parent vertex index of each submesh vertex and the parent
+/// geometry point index of each submesh geometry point
+std::tuple<Mesh, std::vector<std::int32_t>, std::vector<std::int32_t>,
+           std::vector<std::int32_t>>
+create_submesh(const Mesh& mesh, int dim,
+               const xtl::span<const std::int32_t>& entities);
+
 /// Compute destination rank for mesh cells in this rank by applying the
 /// default graph partitioner to the dual graph of the mesh
 ///
@@ -140,4 +195,91 @@ partition_cells_graph(MPI_Comm comm, int n, int tdim,
                       mesh::GhostMode ghost_mode,
                       const graph::partition_fn& partfn);
 
+/// Compute destination rank for mesh cells on this rank by applying a
+/// provided graph partitioner to the dual graph of the mesh, with a
+/// ghost overlap of @p num_ghost_layers layers of cells. The
+/// partitioner provides the first layer; deeper layers are added by
+/// iterating the ghost-growth exchange on the dual graph (see
+/// graph::build::expand_destinations), e.g. for overlapping-Schwarz
+/// methods or wide stencils.
+graph::AdjacencyList<std::int32_t>
+partition_cells_graph(MPI_Comm comm, int n, int tdim,
+                      const graph::AdjacencyList<std::int64_t>& cells,
+                      mesh::GhostMode ghost_mode, int num_ghost_layers,
+                      const graph::partition_fn& partfn);
+
+/// Compute destination rank for mesh cells on this rank by applying
+/// the default weighted graph partitioner to the dual graph of the
+/// mesh, balancing per-cell computational weights
+///
+/// @param[in] comm MPI Communicator
+/// @param[in] n Number of partitions
+/// @param[in] tdim Topological dimension
+/// @param[in] cells Cells on this process (see the unweighted overload
+/// for the required layout)
+/// @param[in] ghost_mode How to overlap the cell partitioning: none,
+/// shared_facet or shared_vertex
+/// @param[in] cell_weights Computational weight(s) for each cell,
+/// row-major with `ncon` weights per cell for multi-constraint
+/// balancing (e.g. a memory and a flop estimate). Empty for an
+/// unweighted partitioning. Support for `ncon > 1` depends on the
+/// partitioner.
+/// @return Destination rank for each cell on this process
+graph::AdjacencyList<std::int32_t>
+partition_cells_graph(MPI_Comm comm, int n, int tdim,
+                      const graph::AdjacencyList<std::int64_t>& cells,
+                      mesh::GhostMode ghost_mode,
+                      const xtl::span<const std::int32_t>& cell_weights);
+
+/// Compute destination rank for mesh cells on this rank by applying a
+/// provided weighted graph partitioner to the dual graph of the mesh,
+/// balancing per-cell computational weights
+graph::AdjacencyList<std::int32_t>
+partition_cells_graph(MPI_Comm comm, int n, int tdim,
+                      const graph::AdjacencyList<std::int64_t>& cells,
+                      mesh::GhostMode ghost_mode,
+                      const xtl::span<const std::int32_t>& cell_weights,
+                      const graph::partition_fn_weighted& partfn);
+
+/// Build an intra-node shared copy of the mesh geometry coordinates in
+/// an MPI-3 shared-memory window. The ranks of one shared-memory node
+/// (found with MPI_COMM_TYPE_SHARED on the mesh communicator) hold a
+/// single coordinate array covering the union of their geometry nodes,
+/// de-duplicated by input global index, rather than one ghost-heavy
+/// copy per rank. Opt-in: the Geometry of the mesh is not modified,
+/// and callers read coordinates through the returned map. Collective
+/// on the mesh communicator. The shared array must be treated as
+/// read-only after this call.
+/// @param[in] mesh The mesh
+/// @return (Shared coordinate array of shape `(num_shared_nodes, 3)`,
+/// row-major; map from local geometry node index to its row in the
+/// shared array. Row `map[i]` holds the coordinates of local geometry
+/// node `i`.)
+std::pair<std::shared_ptr<const common::SharedArray<double>>,
+          std::vector<std::int32_t>>
+create_shared_coordinates(const Mesh& mesh);
+
+/// Build an intra-node shared copy of a mesh connectivity in an MPI-3
+/// shared-memory window. The ranks of one shared-memory node hold a
+/// single connectivity array covering the union of their
+/// dimension-@p d0 entities, de-duplicated by global entity index,
+/// rather than one ghost-heavy copy per rank. Rows store the *global*
+/// indices of the connected dimension-@p d1 entities, since local
+/// indices differ between ranks. The connectivity must have a fixed
+/// degree (the same number of links for every entity, e.g.
+/// cell-vertex connectivity for a single cell type) and must already
+/// have been computed on all ranks. Opt-in: the Topology of the mesh
+/// is not modified. Collective on the mesh communicator. The shared
+/// array must be treated as read-only after this call.
+/// @param[in] mesh The mesh
+/// @param[in] d0 Topological dimension of the entities
+/// @param[in] d1 Topological dimension of the connected entities
+/// @return (Shared connectivity array of shape
+/// `(num_shared_entities, degree)`, row-major, with global indices;
+/// the degree; map from local entity index to its row in the shared
+/// array)
+std::tuple<std::shared_ptr<const common::SharedArray<std::int64_t>>, int,
+           std::vector<std::int32_t>>
+create_shared_connectivity(const Mesh& mesh, int d0, int d1);
+
 } // namespace dolfinx::mesh
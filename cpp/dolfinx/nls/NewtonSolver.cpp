@@ -6,11 +6,15 @@
 
 #include "NewtonSolver.h"
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Telemetry.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/la/PETScKrylovSolver.h>
 #include <dolfinx/la/PETScOptions.h>
 #include <dolfinx/la/PETScVector.h>
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <vector>
 
 using namespace dolfinx;
 
@@ -24,12 +28,14 @@ namespace
 // and true` if convergence achieved
 std::pair<double, bool> converged(const nls::NewtonSolver& solver, const Vec r)
 {
-  la::PETScVector _r(r, true);
-  double residual = _r.norm(la::Norm::l2);
+  const double residual = solver.residual_norm(r);
 
   // Relative residual
   const double relative_residual = residual / solver.residual0();
 
+  common::telemetry::emit(common::telemetry::Channel::newton_residual,
+                          solver.iteration(), residual);
+
   // Output iteration number and residual
   if (solver.report and dolfinx::MPI::rank(solver.mpi_comm()) == 0)
   {
@@ -59,6 +65,71 @@ void update_solution(const nls::NewtonSolver& solver, const Vec dx, Vec x)
   VecAXPY(x, -solver.relaxation_parameter, dx);
 }
 //-----------------------------------------------------------------------------
+/// State of the Broyden shell operator: the frozen assembled Jacobian
+/// and the accumulated rank-one secant update pairs, with cached s^T s
+struct BroydenCtx
+{
+  Mat J;
+  std::vector<Vec> u, s;
+  std::vector<PetscScalar> sts;
+};
+//-----------------------------------------------------------------------------
+/// Shell matrix action y = (J + sum_i u_i s_i^T / s_i^T s_i) x
+PetscErrorCode broyden_mult(Mat A, Vec x, Vec y)
+{
+  void* p = nullptr;
+  MatShellGetContext(A, &p);
+  auto ctx = static_cast<BroydenCtx*>(p);
+  assert(ctx);
+  MatMult(ctx->J, x, y);
+  for (std::size_t i = 0; i < ctx->u.size(); ++i)
+  {
+    PetscScalar sx(0);
+    VecDot(x, ctx->s[i], &sx);
+    VecAXPY(y, sx / ctx->sts[i], ctx->u[i]);
+  }
+  return 0;
+}
+//-----------------------------------------------------------------------------
+/// State of the matrix-free (JFNK) operator: residual callback, ghost
+/// update callback, current solution and residual, and a work vector
+struct MatrixFreeCtx
+{
+  const std::function<void(const Vec, Vec)>* F;
+  const std::function<void(const Vec)>* system;
+  Vec x, b, xw;
+};
+//-----------------------------------------------------------------------------
+/// Matrix-free Jacobian action y = (F(x + eps v) - F(x)) / eps, with
+/// the differencing parameter scaled to the solution and direction
+/// norms
+PetscErrorCode matrix_free_mult(Mat A, Vec v, Vec y)
+{
+  void* p = nullptr;
+  MatShellGetContext(A, &p);
+  auto ctx = static_cast<MatrixFreeCtx*>(p);
+  assert(ctx);
+
+  PetscReal vnorm(0), xnorm(0);
+  VecNorm(v, NORM_2, &vnorm);
+  if (vnorm == 0.0)
+  {
+    VecZeroEntries(y);
+    return 0;
+  }
+  VecNorm(ctx->x, NORM_2, &xnorm);
+  const PetscReal eps
+      = PetscSqrtReal(PETSC_MACHINE_EPSILON) * (1.0 + xnorm) / vnorm;
+
+  VecWAXPY(ctx->xw, eps, v, ctx->x);
+  if (*ctx->system)
+    (*ctx->system)(ctx->xw);
+  (*ctx->F)(ctx->xw, y);
+  VecAXPY(y, -1.0, ctx->b);
+  VecScale(y, 1.0 / eps);
+  return 0;
+}
+//-----------------------------------------------------------------------------
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -142,6 +213,23 @@ void nls::NewtonSolver::set_update(
   _update_solution = update;
 }
 //-----------------------------------------------------------------------------
+void nls::NewtonSolver::set_residual_norm(
+    const std::function<double(const Vec r)>& norm)
+{
+  _residual_norm = norm;
+}
+//-----------------------------------------------------------------------------
+double nls::NewtonSolver::residual_norm(const Vec r) const
+{
+  if (_residual_norm)
+    return _residual_norm(r);
+  else
+  {
+    la::PETScVector _r(r, true);
+    return _r.norm(la::Norm::l2);
+  }
+}
+//-----------------------------------------------------------------------------
 std::pair<int, bool> dolfinx::nls::NewtonSolver::solve(Vec x)
 {
   // Reset iteration counts
@@ -155,7 +243,7 @@ std::pair<int, bool> dolfinx::nls::NewtonSolver::solve(Vec x)
                              "been provided to the NewtonSolver.");
   }
 
-  if (!_fnJ)
+  if (!_fnJ and !jacobian_free)
   {
     throw std::runtime_error("Function for computing Jacobianhas not "
                              "been provided to the NewtonSolver.");
@@ -182,31 +270,237 @@ std::pair<int, bool> dolfinx::nls::NewtonSolver::solve(Vec x)
                              + convergence_criterion);
   }
 
-  // FIXME: check that this is efficient if A and/or P are unchanged
-  // Set operators
+  // In Jacobian-free mode the Jacobian action is finite-differenced
+  // through a shell operator; an assembled matrix, if any, serves only
+  // as preconditioner
+  MatrixFreeCtx mf{&_fnF, &_system, x, _b, nullptr};
+  Mat shell_mf = nullptr;
+  if (jacobian_free)
+  {
+    PetscInt m(0), n(0), M(0), N(0);
+    VecGetLocalSize(_b, &m);
+    VecGetSize(_b, &M);
+    VecGetLocalSize(x, &n);
+    VecGetSize(x, &N);
+    MatCreateShell(_mpi_comm.comm(), m, n, M, N, &mf, &shell_mf);
+    MatShellSetOperation(shell_mf, MATOP_MULT,
+                         (void (*)(void))matrix_free_mult);
+    VecDuplicate(x, &mf.xw);
+  }
+
+  // Broyden rank-one updates are applied through a shell operator, so
+  // the assembled Jacobian used to build the preconditioner stays
+  // untouched
+  BroydenCtx broyden{_matJ, {}, {}, {}};
+  Mat shell = nullptr;
+  Vec x_old = nullptr, b_old = nullptr, work = nullptr;
+  if (broyden_update and !jacobian_free)
+  {
+    assert(_matJ);
+    PetscInt m(0), n(0), M(0), N(0);
+    MatGetLocalSize(_matJ, &m, &n);
+    MatGetSize(_matJ, &M, &N);
+    MatCreateShell(_mpi_comm.comm(), m, n, M, N, &broyden, &shell);
+    MatShellSetOperation(shell, MATOP_MULT, (void (*)(void))broyden_mult);
+    VecDuplicate(x, &x_old);
+    VecDuplicate(_b, &b_old);
+    VecDuplicate(_b, &work);
+  }
+
+  // Anderson acceleration treats the relaxed Newton step as a
+  // fixed-point update g(x) = x - relaxation_parameter*dx and mixes
+  // the last anderson_depth candidates. The Gram matrix of the
+  // residual differences and the right-hand side of the mixing
+  // problem are cached and extended by a single batched inner product
+  // per iteration.
+  std::vector<Vec> and_dF, and_dG;
+  std::vector<std::vector<PetscScalar>> and_gram;
+  std::vector<PetscScalar> and_rhs;
+  Vec f_cur = nullptr, g_cur = nullptr, f_prev = nullptr, g_prev = nullptr;
+  if (anderson_depth > 0)
+  {
+    VecDuplicate(x, &f_cur);
+    VecDuplicate(x, &g_cur);
+    VecDuplicate(x, &f_prev);
+    VecDuplicate(x, &g_prev);
+  }
+
+  // Set operators. While the Jacobian is lagged the matrices are
+  // unchanged, and the Krylov solver does not rebuild the
+  // preconditioner.
+  Mat A = shell_mf ? shell_mf : (shell ? shell : _matJ);
   if (_matP)
-    _solver.set_operators(_matJ, _matP);
+    _solver.set_operators(A, _matP);
   else
-    _solver.set_operators(_matJ, _matJ);
+    _solver.set_operators(A, _matJ ? _matJ : A);
 
   if (!_dx)
-    MatCreateVecs(_matJ, &_dx, nullptr);
+  {
+    if (_matJ)
+      MatCreateVecs(_matJ, &_dx, nullptr);
+    else
+      VecDuplicate(x, &_dx);
+  }
+
+  // Adaptive (Eisenstat-Walker) forcing terms for the inner solve
+  const bool adaptive_forcing = forcing_term != "constant";
+  if (adaptive_forcing and forcing_term != "eisenstat-walker1"
+      and forcing_term != "eisenstat-walker2")
+  {
+    throw std::runtime_error("Unknown forcing term strategy: " + forcing_term);
+  }
+  double eta = forcing_eta0;
+
+  bool jacobian_stale = false;
+  double residual_prev = _residual;
 
   // Start iterations
   while (!newton_converged and _iteration < max_it)
   {
-    // Compute Jacobian
-    assert(_matJ);
-    _fnJ(x, _matJ);
+    // Compute Jacobian on the first iteration, every jacobian_lag-th
+    // iteration thereafter, and whenever convergence under a lagged
+    // Jacobian has degraded. In Jacobian-free mode the assembled
+    // matrices feed the preconditioner only.
+    if ((_fnJ or _fnP)
+        and (_iteration == 0 or jacobian_stale or jacobian_lag <= 1
+             or _iteration % jacobian_lag == 0))
+    {
+      if (_fnJ)
+        _fnJ(x, _matJ);
+      if (_fnP)
+        _fnP(x, _matP);
+
+      // A fresh Jacobian supersedes the accumulated secant updates
+      for (Vec v : broyden.u)
+        VecDestroy(&v);
+      for (Vec v : broyden.s)
+        VecDestroy(&v);
+      broyden.u.clear();
+      broyden.s.clear();
+      broyden.sts.clear();
+      jacobian_stale = false;
+    }
+
+    if (shell)
+    {
+      VecCopy(x, x_old);
+      VecCopy(_b, b_old);
+    }
 
-    if (_fnP)
-      _fnP(x, _matP);
+    // Set the tolerance of the inner solve from the forcing term
+    if (adaptive_forcing)
+    {
+      KSPSetTolerances(_solver.ksp(), eta, PETSC_DEFAULT, PETSC_DEFAULT,
+                       PETSC_DEFAULT);
+    }
 
     // Perform linear solve and update total number of Krylov iterations
     _krylov_iterations += _solver.solve(_dx, _b);
 
     // Update solution
-    this->_update_solution(*this, _dx, x);
+    if (anderson_depth > 0)
+    {
+      // Candidate iterate g and fixed-point residual f = g - x of the
+      // underlying relaxed Newton step
+      VecWAXPY(g_cur, -relaxation_parameter, _dx, x);
+      VecWAXPY(f_cur, -1.0, x, g_cur);
+      if (_iteration > 0)
+      {
+        // Append the difference pair of this iteration, recycling the
+        // oldest slot (and dropping its Gram row and column) once the
+        // window is full
+        Vec df = nullptr, dg = nullptr;
+        if (int(and_dF.size()) == anderson_depth)
+        {
+          df = and_dF.front();
+          dg = and_dG.front();
+          and_dF.erase(and_dF.begin());
+          and_dG.erase(and_dG.begin());
+          and_gram.erase(and_gram.begin());
+          for (std::vector<PetscScalar>& row : and_gram)
+            row.erase(row.begin());
+          and_rhs.erase(and_rhs.begin());
+        }
+        else
+        {
+          VecDuplicate(x, &df);
+          VecDuplicate(x, &dg);
+        }
+        VecWAXPY(df, -1.0, f_prev, f_cur);
+        VecWAXPY(dg, -1.0, g_prev, g_cur);
+        and_dF.push_back(df);
+        and_dG.push_back(dg);
+
+        // One batched reduction: the new Gram column against the
+        // window together with the product against the previous
+        // residual, from which the right-hand side dF_j . f follows
+        // recursively (f = f_prev + dF_new)
+        const int m = int(and_dF.size());
+        std::vector<Vec> ys(and_dF);
+        ys.push_back(f_prev);
+        std::vector<PetscScalar> dots(m + 1);
+        VecMDot(df, m + 1, ys.data(), dots.data());
+        for (int j = 0; j < m - 1; ++j)
+        {
+          and_gram[j].push_back(dots[j]);
+          and_rhs[j] += dots[j];
+        }
+        and_gram.push_back(
+            std::vector<PetscScalar>(dots.begin(), dots.begin() + m));
+        and_rhs.push_back(dots[m] + dots[m - 1]);
+
+        // Solve the small (regularised) normal equations locally for
+        // the mixing weights
+        std::vector<PetscScalar> A(m * m), gamma(and_rhs);
+        PetscReal diag_max(0);
+        for (int i = 0; i < m; ++i)
+        {
+          for (int j = 0; j < m; ++j)
+            A[i * m + j] = i >= j ? and_gram[i][j] : and_gram[j][i];
+          diag_max = std::max(diag_max, std::abs(A[i * m + i]));
+        }
+        for (int i = 0; i < m; ++i)
+          A[i * m + i] += 1e-12 * diag_max;
+        for (int i = 0; i < m; ++i)
+        {
+          int p = i;
+          for (int k = i + 1; k < m; ++k)
+            if (std::abs(A[k * m + i]) > std::abs(A[p * m + i]))
+              p = k;
+          if (p != i)
+          {
+            for (int j = i; j < m; ++j)
+              std::swap(A[i * m + j], A[p * m + j]);
+            std::swap(gamma[i], gamma[p]);
+          }
+          for (int k = i + 1; k < m; ++k)
+          {
+            const PetscScalar c = A[k * m + i] / A[i * m + i];
+            for (int j = i; j < m; ++j)
+              A[k * m + j] -= c * A[i * m + j];
+            gamma[k] -= c * gamma[i];
+          }
+        }
+        for (int i = m - 1; i >= 0; --i)
+        {
+          for (int j = i + 1; j < m; ++j)
+            gamma[i] -= A[i * m + j] * gamma[j];
+          gamma[i] /= A[i * m + i];
+        }
+
+        // Mixed iterate x = g - sum_j gamma_j dG_j
+        VecCopy(g_cur, x);
+        for (PetscScalar& c : gamma)
+          c = -c;
+        VecMAXPY(x, m, gamma.data(), and_dG.data());
+      }
+      else
+        VecCopy(g_cur, x);
+      std::swap(f_prev, f_cur);
+      std::swap(g_prev, g_cur);
+    }
+    else
+      this->_update_solution(*this, _dx, x);
 
     // Increment iteration count
     ++_iteration;
@@ -218,6 +512,31 @@ std::pair<int, bool> dolfinx::nls::NewtonSolver::solve(Vec x)
     if (_system)
       _system(x);
     _fnF(x, _b);
+
+    if (shell)
+    {
+      // Broyden's update J <- J + (y - J s) s^T / (s^T s), with the
+      // step s and residual difference y of this iteration
+      Vec s = nullptr;
+      VecDuplicate(x, &s);
+      VecWAXPY(s, -1.0, x_old, x);
+      PetscScalar sts(0);
+      VecDot(s, s, &sts);
+      if (std::abs(sts) > 0.0)
+      {
+        MatMult(shell, s, work);
+        Vec u = nullptr;
+        VecDuplicate(_b, &u);
+        VecWAXPY(u, -1.0, b_old, _b);
+        VecAXPY(u, -1.0, work);
+        broyden.s.push_back(s);
+        broyden.u.push_back(u);
+        broyden.sts.push_back(sts);
+      }
+      else
+        VecDestroy(&s);
+    }
+
     // Initialize _residual0
     if (_iteration == 1)
     {
@@ -243,8 +562,73 @@ std::pair<int, bool> dolfinx::nls::NewtonSolver::solve(Vec x)
     }
     else
       throw std::runtime_error("Unknown convergence criterion string.");
+
+    // Choose the forcing term of the next linear solve from the
+    // residual history (Eisenstat-Walker), with the usual safeguard
+    // against the tolerance dropping too fast
+    if (adaptive_forcing and residual_prev > 0.0)
+    {
+      double eta_new(0), eta_safe(0);
+      if (forcing_term == "eisenstat-walker1")
+      {
+        // The linear model residual |F_prev + J dx| is the final
+        // residual norm of the inner solve
+        PetscReal lin_res(0);
+        KSPGetResidualNorm(_solver.ksp(), &lin_res);
+        eta_new = std::abs(_residual - lin_res) / residual_prev;
+        eta_safe = std::pow(eta, (1.0 + std::sqrt(5.0)) / 2.0);
+      }
+      else
+      {
+        eta_new = forcing_gamma
+                  * std::pow(_residual / residual_prev, forcing_alpha);
+        eta_safe = forcing_gamma * std::pow(eta, forcing_alpha);
+      }
+      if (eta_safe > 0.1)
+        eta_new = std::max(eta_new, eta_safe);
+      eta = std::min(eta_new, forcing_eta_max);
+    }
+
+    // Flag a lagged Jacobian as stale if the residual reduction of
+    // this iteration has degraded beyond jacobian_rate_tol
+    if (!newton_converged and _iteration > 1
+        and _residual > jacobian_rate_tol * residual_prev)
+    {
+      jacobian_stale = true;
+    }
+    residual_prev = _residual;
   }
 
+  // Release the shell operator state
+  if (shell_mf)
+    MatDestroy(&shell_mf);
+  if (mf.xw)
+    VecDestroy(&mf.xw);
+  for (Vec v : broyden.u)
+    VecDestroy(&v);
+  for (Vec v : broyden.s)
+    VecDestroy(&v);
+  if (shell)
+    MatDestroy(&shell);
+  if (x_old)
+    VecDestroy(&x_old);
+  if (b_old)
+    VecDestroy(&b_old);
+  if (work)
+    VecDestroy(&work);
+  for (Vec v : and_dF)
+    VecDestroy(&v);
+  for (Vec v : and_dG)
+    VecDestroy(&v);
+  if (f_cur)
+    VecDestroy(&f_cur);
+  if (g_cur)
+    VecDestroy(&g_cur);
+  if (f_prev)
+    VecDestroy(&f_prev);
+  if (g_prev)
+    VecDestroy(&g_prev);
+
   if (newton_converged)
   {
     if (dolfinx::MPI::rank(_mpi_comm.comm()) == 0)
@@ -98,6 +98,22 @@ public:
   void set_update(const std::function<void(const nls::NewtonSolver& solver,
                                            const Vec dx, Vec x)>& update);
 
+  /// Set the function that supplies the l2 norm of the residual vector
+  /// assembled by the F callback. Residual callbacks that fuse the norm
+  /// accumulation into assembly (see fem::assemble_vector_norm_begin)
+  /// can hand the norm to the solver through this hook, so the default
+  /// convergence check skips the extra full-vector pass and blocking
+  /// allreduce of VecNorm.
+  /// @param[in] norm Function returning the l2 norm of the residual
+  /// vector passed to it
+  void set_residual_norm(const std::function<double(const Vec r)>& norm);
+
+  /// Compute the l2 norm of a residual vector, using the function set
+  /// with set_residual_norm if any, otherwise VecNorm
+  /// @param[in] r The residual vector
+  /// @return The l2 norm of `r`
+  double residual_norm(const Vec r) const;
+
   /// Solve the nonlinear problem \f$`F(x) = 0\f$ for given \f$F\f$ and
   /// Jacobian \f$\dfrac{\partial F}{\partial x}\f$.
   ///
@@ -148,6 +164,72 @@ public:
   /// Relaxation parameter
   double relaxation_parameter = 1.0;
 
+  /// Number of iterations the assembled Jacobian (and preconditioner
+  /// matrix) is reused before reassembly (modified Newton). With the
+  /// default value 1 the Jacobian is reassembled every iteration
+  /// (classic Newton). While the matrices are reused the Krylov solver
+  /// also reuses the preconditioner, since the operators are
+  /// unchanged.
+  int jacobian_lag = 1;
+
+  /// When reusing a lagged Jacobian, reassemble early if the residual
+  /// reduction per iteration degrades beyond this factor, i.e. if
+  /// residual > jacobian_rate_tol * previous residual.
+  double jacobian_rate_tol = 0.9;
+
+  // FIXME: change to string to enum
+  /// Forcing-term strategy for the relative tolerance of the inner
+  /// Krylov solve. "constant" keeps the Krylov solver's own tolerance;
+  /// "eisenstat-walker1" and "eisenstat-walker2" adapt the tolerance
+  /// to the nonlinear residual history, solving the early Newton
+  /// updates only as accurately as the outer convergence warrants
+  /// (inexact Newton)
+  std::string forcing_term = "constant";
+
+  /// Forcing term used for the first iteration of an adaptive
+  /// strategy
+  double forcing_eta0 = 0.3;
+
+  /// Upper safeguard bound on adaptive forcing terms
+  double forcing_eta_max = 0.9;
+
+  /// Factor gamma of the "eisenstat-walker2" choice
+  /// eta = gamma (|r| / |r_prev|)^alpha
+  double forcing_gamma = 0.9;
+
+  /// Exponent alpha of the "eisenstat-walker2" choice
+  double forcing_alpha = 1.618;
+
+  /// Jacobian-free Newton-Krylov mode: the Jacobian action J(x) v is
+  /// approximated by a finite difference of two residual evaluations,
+  /// so no Jacobian needs to be assembled. A matrix set with setJ or
+  /// setP is then used only to build the preconditioner and may be
+  /// lagged with jacobian_lag; if neither is set, the Krylov solver
+  /// runs on the matrix-free operator alone and the preconditioner
+  /// should be disabled (-nls_solve_pc_type none). Takes precedence
+  /// over broyden_update.
+  bool jacobian_free = false;
+
+  /// Apply Broyden rank-one secant updates to the Jacobian between
+  /// reassemblies. The updates are applied matrix-free through a PETSc
+  /// shell operator, so the assembled matrix handed to the
+  /// preconditioner is untouched and preconditioner reuse (including a
+  /// matrix set with setP) composes with the lagging. The updates are
+  /// discarded each time the Jacobian is reassembled.
+  bool broyden_update = false;
+
+  /// Depth of the Anderson acceleration window. When positive, the
+  /// relaxed Newton step of each iteration is treated as a fixed-point
+  /// update and the next iterate is the least-squares mixing of the
+  /// last anderson_depth candidates. The small mixing problem is
+  /// assembled from a single batched inner product (one reduction) per
+  /// iteration and solved locally, so the acceleration is cheap and
+  /// composes with jacobian_lag, where the fixed-point map of the
+  /// lagged Jacobian is stationary between reassemblies. An update
+  /// function set with set_update is bypassed while enabled. Disabled
+  /// by default.
+  int anderson_depth = 0;
+
 private:
   // Function for computing the residual vector. The first argument is
   // the latest solution vector x and the second argument is the
@@ -179,6 +261,10 @@ private:
                                         const Vec r)>
       _converged;
 
+  // Optional function supplying the residual norm, e.g. fused into the
+  // residual assembly
+  std::function<double(const Vec r)> _residual_norm;
+
   // Function to update the solution once convergence is reached
   std::function<void(const nls::NewtonSolver& solver, const Vec dx, Vec x)>
       _update_solution;
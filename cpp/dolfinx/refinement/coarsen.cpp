@@ -0,0 +1,94 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "coarsen.h"
+#include "refine.h"
+#include <algorithm>
+#include <cassert>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/geometry/PointLocator.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/utils.h>
+#include <numeric>
+#include <stdexcept>
+#include <xtl/xspan.hpp>
+
+using namespace dolfinx;
+
+//-----------------------------------------------------------------------------
+std::vector<double> refinement::transfer_indicators(
+    std::shared_ptr<const mesh::Mesh> coarse_mesh, const mesh::Mesh& fine_mesh,
+    const la::Vector<double>& fine_indicators)
+{
+  assert(coarse_mesh);
+  if (fine_indicators.bs() != 1)
+    throw std::runtime_error("Cell indicators must have block size 1.");
+
+  const int tdim = fine_mesh.topology().dim();
+  auto map_c = fine_mesh.topology().index_map(tdim);
+  assert(map_c);
+  const std::int32_t num_fine_cells = map_c->size_local();
+  assert(fine_indicators.map());
+  if (fine_indicators.map()->size_local() != num_fine_cells)
+  {
+    throw std::runtime_error(
+        "Indicator length does not match the fine mesh cell count.");
+  }
+  const xtl::span<const double> eta
+      = fine_indicators.array().first(num_fine_cells);
+
+  // Locate the coarse cell containing each owned fine cell midpoint
+  std::vector<std::int32_t> fine_cells(num_fine_cells);
+  std::iota(fine_cells.begin(), fine_cells.end(), 0);
+  const xt::xtensor<double, 2> x
+      = mesh::midpoints(fine_mesh, tdim, fine_cells);
+  geometry::PointLocator locator(coarse_mesh);
+  const std::vector<std::int32_t> parent = locator.locate(x);
+
+  auto map_c0 = coarse_mesh->topology().index_map(tdim);
+  assert(map_c0);
+  std::vector<double> coarse_indicators(map_c0->size_local(), 0.0);
+  for (std::int32_t c = 0; c < num_fine_cells; ++c)
+  {
+    if (parent[c] < 0)
+    {
+      throw std::runtime_error(
+          "No coarse cell contains a fine cell midpoint. The refined mesh "
+          "must not be redistributed, see refine_with_parent_data.");
+    }
+    if (parent[c] < (std::int32_t)coarse_indicators.size())
+    {
+      coarse_indicators[parent[c]]
+          = std::max(coarse_indicators[parent[c]], eta[c]);
+    }
+  }
+
+  return coarse_indicators;
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh refinement::coarsen(std::shared_ptr<const mesh::Mesh> coarse_mesh,
+                               const mesh::Mesh& fine_mesh,
+                               const la::Vector<double>& fine_indicators,
+                               double threshold, bool redistribute)
+{
+  const std::vector<double> coarse_indicators
+      = transfer_indicators(coarse_mesh, fine_mesh, fine_indicators);
+
+  std::vector<std::int32_t> cells;
+  for (std::size_t c = 0; c < coarse_indicators.size(); ++c)
+    if (coarse_indicators[c] > threshold)
+      cells.push_back(c);
+
+  LOG(INFO) << "Coarsening: re-refining " << cells.size() << " of "
+            << coarse_indicators.size() << " local cells";
+
+  return refinement::refine(*coarse_mesh,
+                            xtl::span<const std::int32_t>(cells),
+                            redistribute);
+}
+//-----------------------------------------------------------------------------
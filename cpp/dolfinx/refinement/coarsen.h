@@ -0,0 +1,66 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <dolfinx/la/Vector.h>
+#include <memory>
+#include <vector>
+
+namespace dolfinx::mesh
+{
+class Mesh;
+}
+
+namespace dolfinx::refinement
+{
+
+/// Transfer per-cell indicators from a refined mesh back to the mesh
+/// it was refined from. Each owned fine cell contributes to the coarse
+/// cell containing its midpoint, and contributions accumulate by
+/// maximum, so a coarse cell keeps the largest indicator among its
+/// descendants and is only eligible for coarsening when all of them
+/// have dropped. The refined mesh must have been created without
+/// redistribution (see refine_with_parent_data), so that the parent of
+/// every owned fine cell is on the same rank.
+///
+/// @param[in] coarse_mesh The mesh the refined mesh was created from
+/// @param[in] fine_mesh The refined mesh
+/// @param[in] fine_indicators Per-cell indicator on the refined mesh,
+/// one value for each owned cell (block size 1)
+/// @return Per-cell indicator on the coarse mesh (owned cells)
+std::vector<double>
+transfer_indicators(std::shared_ptr<const mesh::Mesh> coarse_mesh,
+                    const mesh::Mesh& fine_mesh,
+                    const la::Vector<double>& fine_indicators);
+
+/// Coarsen a refined mesh where the indicators have dropped, by
+/// re-refining its parent mesh with a reduced marked set: coarse cells
+/// whose descendants all fall below the threshold are not refined
+/// again, collapsing their cell family, while cells that still carry a
+/// large indicator are re-split. Conformity is maintained by the usual
+/// longest-edge closure of the refinement kernel, and all index maps
+/// are rebuilt consistently by the mesh constructor. The refined mesh
+/// must have been created without redistribution (see
+/// refine_with_parent_data).
+///
+/// @param[in] coarse_mesh The mesh the refined mesh was created from
+/// @param[in] fine_mesh The refined mesh
+/// @param[in] fine_indicators Per-cell indicator on the refined mesh,
+/// one value for each owned cell (block size 1)
+/// @param[in] threshold Indicator value below which a cell family is
+/// collapsed
+/// @param[in] redistribute Optional argument to redistribute the new
+///     mesh if mesh is a distributed mesh.
+/// @return A new mesh, refined only where indicators remain above the
+/// threshold
+mesh::Mesh coarsen(std::shared_ptr<const mesh::Mesh> coarse_mesh,
+                   const mesh::Mesh& fine_mesh,
+                   const la::Vector<double>& fine_indicators, double threshold,
+                   bool redistribute = true);
+
+} // namespace dolfinx::refinement
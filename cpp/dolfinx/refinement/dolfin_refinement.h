@@ -12,4 +12,7 @@ namespace dolfinx
 
 // DOLFINx refinement interface
 
+#include <dolfinx/refinement/coarsen.h>
+#include <dolfinx/refinement/marking.h>
 #include <dolfinx/refinement/refine.h>
+#include <dolfinx/refinement/transfer.h>
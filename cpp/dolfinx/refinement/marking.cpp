@@ -0,0 +1,123 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "marking.h"
+#include "refine.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <numeric>
+#include <stdexcept>
+#include <xtl/xspan.hpp>
+
+using namespace dolfinx;
+
+namespace
+{
+//-----------------------------------------------------------------------------
+// Check the indicator layout and return the owned values
+xtl::span<const double> owned_indicators(const la::Vector<double>& indicators)
+{
+  if (indicators.bs() != 1)
+    throw std::runtime_error("Cell indicators must have block size 1.");
+  assert(indicators.map());
+  return indicators.array().first(indicators.map()->size_local());
+}
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+refinement::mark_doerfler(const la::Vector<double>& indicators, double theta)
+{
+  if (theta < 0.0 or theta > 1.0)
+    throw std::runtime_error("Marking fraction must be in [0, 1].");
+
+  const xtl::span<const double> eta = owned_indicators(indicators);
+  MPI_Comm comm = indicators.map()->comm();
+
+  std::array<double, 2> sum_max
+      = {std::accumulate(eta.begin(), eta.end(), 0.0),
+         eta.empty() ? 0.0 : *std::max_element(eta.begin(), eta.end())};
+  MPI_Allreduce(MPI_IN_PLACE, sum_max.data(), 1, MPI_DOUBLE, MPI_SUM, comm);
+  MPI_Allreduce(MPI_IN_PLACE, sum_max.data() + 1, 1, MPI_DOUBLE, MPI_MAX,
+                comm);
+  const double target = theta * sum_max[0];
+
+  // Bisect for the largest threshold t such that the indicators above
+  // t still sum to at least the target. The captured sum is monotone
+  // decreasing in t, so the invariant sum(eta > lo) >= target holds
+  // throughout.
+  double lo = 0.0, hi = sum_max[1];
+  for (int i = 0; i < 50; ++i)
+  {
+    const double mid = 0.5 * (lo + hi);
+    double sum = 0.0;
+    for (double e : eta)
+      if (e > mid)
+        sum += e;
+    MPI_Allreduce(MPI_IN_PLACE, &sum, 1, MPI_DOUBLE, MPI_SUM, comm);
+    if (sum >= target)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  std::vector<std::int32_t> cells;
+  for (std::size_t c = 0; c < eta.size(); ++c)
+    if (eta[c] > lo)
+      cells.push_back(c);
+  return cells;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+refinement::mark_fraction(const la::Vector<double>& indicators, double fraction)
+{
+  if (fraction < 0.0 or fraction > 1.0)
+    throw std::runtime_error("Marking fraction must be in [0, 1].");
+
+  const xtl::span<const double> eta = owned_indicators(indicators);
+  MPI_Comm comm = indicators.map()->comm();
+
+  double max = eta.empty() ? 0.0 : *std::max_element(eta.begin(), eta.end());
+  MPI_Allreduce(MPI_IN_PLACE, &max, 1, MPI_DOUBLE, MPI_MAX, comm);
+  const std::int64_t target
+      = fraction * indicators.map()->size_global() * indicators.bs();
+
+  // Bisect for the largest threshold t such that at least the target
+  // number of cells have an indicator above t
+  double lo = 0.0, hi = max;
+  for (int i = 0; i < 50; ++i)
+  {
+    const double mid = 0.5 * (lo + hi);
+    std::int64_t count
+        = std::count_if(eta.begin(), eta.end(),
+                        [mid](double e) { return e > mid; });
+    MPI_Allreduce(MPI_IN_PLACE, &count, 1, MPI_INT64_T, MPI_SUM, comm);
+    if (count >= target)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  std::vector<std::int32_t> cells;
+  for (std::size_t c = 0; c < eta.size(); ++c)
+    if (eta[c] > lo)
+      cells.push_back(c);
+  return cells;
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh refinement::refine_doerfler(const mesh::Mesh& mesh,
+                                       const la::Vector<double>& indicators,
+                                       double theta, bool redistribute)
+{
+  const std::vector<std::int32_t> cells = mark_doerfler(indicators, theta);
+  return refinement::refine(mesh, xtl::span<const std::int32_t>(cells),
+                            redistribute);
+}
+//-----------------------------------------------------------------------------
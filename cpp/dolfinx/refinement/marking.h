@@ -0,0 +1,63 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <dolfinx/la/Vector.h>
+#include <vector>
+
+namespace dolfinx::mesh
+{
+class Mesh;
+}
+
+namespace dolfinx::refinement
+{
+
+/// Dörfler (bulk-chasing) marking. Select a near-minimal set of owned
+/// cells whose error indicators sum to at least the fraction theta of
+/// the global indicator sum. The marking threshold is found by
+/// bisection with an MPI reduction per iteration, so no global sort of
+/// the indicators is required. Collective.
+///
+/// @param[in] indicators Per-cell error indicator, one non-negative
+/// value for each owned cell (block size 1)
+/// @param[in] theta Fraction of the global indicator sum to capture,
+/// in [0, 1]
+/// @return Local indices of the marked (owned) cells
+std::vector<std::int32_t> mark_doerfler(const la::Vector<double>& indicators,
+                                        double theta);
+
+/// Fixed-fraction marking. Select the given fraction of cells globally
+/// with the largest error indicators. The marking threshold is found
+/// by bisection with an MPI reduction per iteration. Collective.
+///
+/// @param[in] indicators Per-cell error indicator, one non-negative
+/// value for each owned cell (block size 1)
+/// @param[in] fraction Fraction of the global cell count to mark, in
+/// [0, 1]
+/// @return Local indices of the marked (owned) cells
+std::vector<std::int32_t> mark_fraction(const la::Vector<double>& indicators,
+                                        double fraction);
+
+/// Mark cells by the Dörfler criterion and refine in a single call,
+/// passing the marked cells straight to the refinement kernel without
+/// materializing a MeshTags object.
+///
+/// @param[in] mesh The mesh from which to build a refined Mesh
+/// @param[in] indicators Per-cell error indicator, one non-negative
+/// value for each owned cell (block size 1)
+/// @param[in] theta Fraction of the global indicator sum to capture,
+/// in [0, 1]
+/// @param[in] redistribute Optional argument to redistribute the
+///     refined mesh if mesh is a distributed mesh.
+/// @return A locally refined mesh
+mesh::Mesh refine_doerfler(const mesh::Mesh& mesh,
+                           const la::Vector<double>& indicators, double theta,
+                           bool redistribute = true);
+
+} // namespace dolfinx::refinement
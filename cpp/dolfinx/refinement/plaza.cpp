@@ -6,8 +6,12 @@
 
 #include "plaza.h"
 #include "utils.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/Timer.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
@@ -15,6 +19,7 @@
 #include <dolfinx/mesh/Topology.h>
 #include <limits>
 #include <map>
+#include <thread>
 #include <vector>
 #include <xtensor/xnorm.hpp>
 
@@ -30,6 +35,7 @@ namespace
 void enforce_rules(
     const MPI_Comm& neighbor_comm,
     const std::map<std::int32_t, std::vector<std::int32_t>>& shared_edges,
+    const std::vector<std::vector<std::int32_t>>& edge_lists,
     std::vector<bool>& marked_edges, const mesh::Mesh& mesh,
     const std::vector<std::int32_t>& long_edge)
 {
@@ -55,16 +61,19 @@ void enforce_rules(
   const int num_neighbors = indegree;
   std::vector<std::vector<std::int32_t>> marked_for_update(num_neighbors);
 
-  std::int32_t update_count = 1;
-  while (update_count > 0)
+  // The face walk of each round is split into blocks executed on
+  // separate threads. Blocks only read the edge markers and collect
+  // the long edges to be marked; the markers and the neighbor update
+  // sets are updated serially once all blocks have finished.
+  const std::size_t num_threads = std::max<std::size_t>(
+      1, std::min<std::size_t>(common::num_threads(), num_faces));
+  std::vector<std::vector<std::int32_t>> block_marks(num_threads);
+
+  auto walk_block = [&f_to_e, &long_edge,
+                     &marked_edges](std::size_t begin, std::size_t end,
+                                    std::vector<std::int32_t>& marks)
   {
-    update_count = 0;
-    refinement::update_logical_edgefunction(neighbor_comm, marked_for_update,
-                                            marked_edges, *map_e);
-    for (int i = 0; i < num_neighbors; ++i)
-      marked_for_update[i].clear();
-
-    for (int f = 0; f < num_faces; ++f)
+    for (std::size_t f = begin; f < end; ++f)
     {
       const std::int32_t long_e = long_edge[f];
       if (marked_edges[long_e])
@@ -75,13 +84,45 @@ void enforce_rules(
         any_marked = any_marked or marked_edges[edge];
 
       if (any_marked)
+        marks.push_back(long_e);
+    }
+  };
+
+  std::int32_t update_count = 1;
+  while (update_count > 0)
+  {
+    update_count = 0;
+    refinement::update_logical_edgefunction(neighbor_comm, edge_lists,
+                                            marked_for_update, marked_edges,
+                                            *map_e);
+    for (int i = 0; i < num_neighbors; ++i)
+      marked_for_update[i].clear();
+
+    if (num_threads <= 1)
+      walk_block(0, num_faces, block_marks[0]);
+    else
+    {
+      std::vector<std::thread> threads;
+      for (std::size_t t = 0; t < num_threads; ++t)
+      {
+        threads.emplace_back(walk_block, (num_faces * t) / num_threads,
+                             (num_faces * (t + 1)) / num_threads,
+                             std::ref(block_marks[t]));
+      }
+      for (std::thread& thread : threads)
+        thread.join();
+    }
+
+    for (std::vector<std::int32_t>& marks : block_marks)
+    {
+      for (std::int32_t long_e : marks)
       {
         if (!marked_edges[long_e])
         {
           marked_edges[long_e] = true;
 
-          // If it is a shared edge, add all sharing neighbors to update
-          // set
+          // If it is a shared edge, add all sharing neighbors to
+          // update set
           if (auto map_it = shared_edges.find(long_e);
               map_it != shared_edges.end())
           {
@@ -91,6 +132,7 @@ void enforce_rules(
         }
         ++update_count;
       }
+      marks.clear();
     }
 
     const std::int32_t update_count_old = update_count;
@@ -383,7 +425,8 @@ face_long_edge(const mesh::Mesh& mesh)
 //-----------------------------------------------------------------------------
 // Convenient interface for both uniform and marker refinement
 std::tuple<graph::AdjacencyList<std::int64_t>, xt::xtensor<double, 2>,
-           std::vector<std::int32_t>>
+           std::vector<std::int32_t>,
+           std::map<std::int64_t, std::array<std::int64_t, 2>>>
 compute_refinement(
     const MPI_Comm& neighbor_comm, const std::vector<bool>& marked_edges,
     const std::map<std::int32_t, std::vector<std::int32_t>> shared_edges,
@@ -421,6 +464,24 @@ compute_refinement(
   std::vector<std::int64_t> global_indices = refinement::adjust_indices(
       *mesh.topology().index_map(0), num_new_vertices_local);
 
+  // Record the parent vertices of each new vertex by global index.
+  // Vertices carried over from the input mesh keep a single parent
+  // (their own index in the input mesh, second entry -1); vertices
+  // created on a bisected edge have the two edge endpoints as parents.
+  auto e_to_v = mesh.topology().connectivity(1, 0);
+  assert(e_to_v);
+  const std::vector<std::int64_t> vertex_global
+      = mesh.topology().index_map(0)->global_indices();
+  std::map<std::int64_t, std::array<std::int64_t, 2>> parent_vertices;
+  for (std::size_t v = 0; v < vertex_global.size(); ++v)
+    parent_vertices.insert({global_indices[v], {vertex_global[v], -1}});
+  for (auto& [edge, vertex] : new_vertex_map)
+  {
+    auto v = e_to_v->links(edge);
+    parent_vertices.insert(
+        {vertex, {vertex_global[v[0]], vertex_global[v[1]]}});
+  }
+
   const int num_cells = map_c->size_local();
   std::vector<std::int64_t> cell_topology;
   for (int c = 0; c < num_cells; ++c)
@@ -505,7 +566,7 @@ compute_refinement(
                                               std::move(offsets));
 
   return {std::move(cell_adj), std::move(new_vertex_coordinates),
-          std::move(parent_cell)};
+          std::move(parent_cell), std::move(parent_vertices)};
 }
 //-----------------------------------------------------------------------------
 } // namespace
@@ -513,7 +574,7 @@ compute_refinement(
 //-----------------------------------------------------------------------------
 mesh::Mesh plaza::refine(const mesh::Mesh& mesh, bool redistribute)
 {
-  auto [cell_adj, new_vertex_coordinates, parent_cell]
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
       = plaza::compute_refinement_data(mesh);
 
   if (dolfinx::MPI::size(mesh.mpi_comm()) == 1)
@@ -544,7 +605,7 @@ mesh::Mesh plaza::refine(const mesh::Mesh& mesh,
                          const mesh::MeshTags<std::int8_t>& refinement_marker,
                          bool redistribute)
 {
-  auto [cell_adj, new_vertex_coordinates, parent_cell]
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
       = plaza::compute_refinement_data(mesh, refinement_marker);
 
   if (dolfinx::MPI::size(mesh.mpi_comm()) == 1)
@@ -570,9 +631,136 @@ mesh::Mesh plaza::refine(const mesh::Mesh& mesh,
   return refinement::partition(mesh, cell_adj, new_vertex_coordinates,
                                redistribute, ghost_mode);
 }
+//-----------------------------------------------------------------------------
+mesh::Mesh plaza::refine(const mesh::Mesh& mesh,
+                         const xtl::span<const std::int32_t>& cells,
+                         bool redistribute)
+{
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
+      = plaza::compute_refinement_data(mesh, cells);
+
+  if (dolfinx::MPI::size(mesh.mpi_comm()) == 1)
+  {
+    return mesh::create_mesh(mesh.mpi_comm(), cell_adj, mesh.geometry().cmap(),
+                             new_vertex_coordinates, mesh::GhostMode::none);
+  }
+
+  const std::shared_ptr<const common::IndexMap> map_c
+      = mesh.topology().index_map(mesh.topology().dim());
+  const int num_ghost_cells = map_c->num_ghosts();
+  // Check if mesh has ghost cells on any rank
+  // FIXME: this is not a robust test. Should be user option.
+  int max_ghost_cells = 0;
+  MPI_Allreduce(&num_ghost_cells, &max_ghost_cells, 1, MPI_INT, MPI_MAX,
+                mesh.mpi_comm());
+
+  // Build mesh
+  const mesh::GhostMode ghost_mode = max_ghost_cells == 0
+                                         ? mesh::GhostMode::none
+                                         : mesh::GhostMode::shared_facet;
+
+  return refinement::partition(mesh, cell_adj, new_vertex_coordinates,
+                               redistribute, ghost_mode);
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh plaza::refine(const mesh::Mesh& mesh, double rebalance_threshold)
+{
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
+      = plaza::compute_refinement_data(mesh);
+
+  if (dolfinx::MPI::size(mesh.mpi_comm()) == 1)
+  {
+    return mesh::create_mesh(mesh.mpi_comm(), cell_adj, mesh.geometry().cmap(),
+                             new_vertex_coordinates, mesh::GhostMode::none);
+  }
+
+  const std::shared_ptr<const common::IndexMap> map_c
+      = mesh.topology().index_map(mesh.topology().dim());
+  const int num_ghost_cells = map_c->num_ghosts();
+  // Check if mesh has ghost cells on any rank
+  // FIXME: this is not a robust test. Should be user option.
+  int max_ghost_cells = 0;
+  MPI_Allreduce(&num_ghost_cells, &max_ghost_cells, 1, MPI_INT, MPI_MAX,
+                mesh.mpi_comm());
+
+  // Build mesh
+  const mesh::GhostMode ghost_mode = max_ghost_cells == 0
+                                         ? mesh::GhostMode::none
+                                         : mesh::GhostMode::shared_facet;
+
+  return refinement::partition(mesh, cell_adj, new_vertex_coordinates,
+                               rebalance_threshold, ghost_mode);
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh plaza::refine(const mesh::Mesh& mesh,
+                         const mesh::MeshTags<std::int8_t>& refinement_marker,
+                         double rebalance_threshold)
+{
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
+      = plaza::compute_refinement_data(mesh, refinement_marker);
+
+  if (dolfinx::MPI::size(mesh.mpi_comm()) == 1)
+  {
+    return mesh::create_mesh(mesh.mpi_comm(), cell_adj, mesh.geometry().cmap(),
+                             new_vertex_coordinates, mesh::GhostMode::none);
+  }
+
+  const std::shared_ptr<const common::IndexMap> map_c
+      = mesh.topology().index_map(mesh.topology().dim());
+  const int num_ghost_cells = map_c->num_ghosts();
+  // Check if mesh has ghost cells on any rank
+  // FIXME: this is not a robust test. Should be user option.
+  int max_ghost_cells = 0;
+  MPI_Allreduce(&num_ghost_cells, &max_ghost_cells, 1, MPI_INT, MPI_MAX,
+                mesh.mpi_comm());
+
+  // Build mesh
+  const mesh::GhostMode ghost_mode = max_ghost_cells == 0
+                                         ? mesh::GhostMode::none
+                                         : mesh::GhostMode::shared_facet;
+
+  return refinement::partition(mesh, cell_adj, new_vertex_coordinates,
+                               rebalance_threshold, ghost_mode);
+}
+//------------------------------------------------------------------------------
+std::pair<mesh::Mesh, std::map<std::int64_t, std::array<std::int64_t, 2>>>
+plaza::refine_with_parent_data(const mesh::Mesh& mesh)
+{
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
+      = plaza::compute_refinement_data(mesh);
+
+  if (dolfinx::MPI::size(mesh.mpi_comm()) == 1)
+  {
+    return {mesh::create_mesh(mesh.mpi_comm(), cell_adj,
+                              mesh.geometry().cmap(), new_vertex_coordinates,
+                              mesh::GhostMode::none),
+            std::move(parent_vertices)};
+  }
+
+  const std::shared_ptr<const common::IndexMap> map_c
+      = mesh.topology().index_map(mesh.topology().dim());
+  const int num_ghost_cells = map_c->num_ghosts();
+  // Check if mesh has ghost cells on any rank
+  // FIXME: this is not a robust test. Should be user option.
+  int max_ghost_cells = 0;
+  MPI_Allreduce(&num_ghost_cells, &max_ghost_cells, 1, MPI_INT, MPI_MAX,
+                mesh.mpi_comm());
+
+  // Build mesh. Cells stay on their current rank so that the parent
+  // vertices of every owned vertex of the new mesh remain locally
+  // available on the input mesh.
+  const mesh::GhostMode ghost_mode = max_ghost_cells == 0
+                                         ? mesh::GhostMode::none
+                                         : mesh::GhostMode::shared_facet;
+
+  return {refinement::partition(mesh, cell_adj, new_vertex_coordinates, false,
+                                ghost_mode),
+          std::move(parent_vertices)};
+}
 //------------------------------------------------------------------------------
 std::tuple<graph::AdjacencyList<std::int64_t>, xt::xtensor<double, 2>,
-           std::vector<std::int32_t>>
+           std::vector<std::int32_t>,
+           std::map<std::int64_t, std::array<std::int64_t, 2>>>
 plaza::compute_refinement_data(const mesh::Mesh& mesh)
 {
 
@@ -592,17 +780,18 @@ plaza::compute_refinement_data(const mesh::Mesh& mesh)
                                  true);
 
   const auto [long_edge, edge_ratio_ok] = face_long_edge(mesh);
-  auto [cell_adj, new_vertex_coordinates, parent_cell]
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
       = compute_refinement(neighbor_comm, marked_edges, shared_edges, mesh,
                            long_edge, edge_ratio_ok);
   MPI_Comm_free(&neighbor_comm);
 
   return {std::move(cell_adj), std::move(new_vertex_coordinates),
-          std::move(parent_cell)};
+          std::move(parent_cell), std::move(parent_vertices)};
 }
 //------------------------------------------------------------------------------
 std::tuple<graph::AdjacencyList<std::int64_t>, xt::xtensor<double, 2>,
-           std::vector<std::int32_t>>
+           std::vector<std::int32_t>,
+           std::map<std::int64_t, std::array<std::int64_t, 2>>>
 plaza::compute_refinement_data(
     const mesh::Mesh& mesh,
     const mesh::MeshTags<std::int8_t>& refinement_marker)
@@ -639,6 +828,9 @@ plaza::compute_refinement_data(
                                  &weighted);
   assert(indegree == outdegree);
   const int num_neighbors = indegree;
+  const std::vector<std::vector<std::int32_t>> edge_lists
+      = refinement::compute_shared_edge_lists(shared_edges, num_neighbors,
+                                              *map_e);
   std::vector<std::vector<std::int32_t>> marked_for_update(num_neighbors);
   for (std::int32_t i : marker_indices)
   {
@@ -662,19 +854,118 @@ plaza::compute_refinement_data(
   }
 
   // Communicate any shared edges
-  refinement::update_logical_edgefunction(neighbor_comm, marked_for_update,
-                                          marked_edges, *map_e);
+  refinement::update_logical_edgefunction(neighbor_comm, edge_lists,
+                                          marked_for_update, marked_edges,
+                                          *map_e);
+
+  // Enforce rules about refinement (i.e. if any edge is marked in a
+  // triangle, then the longest edge must also be marked).
+  const auto [long_edge, edge_ratio_ok] = face_long_edge(mesh);
+  enforce_rules(neighbor_comm, shared_edges, edge_lists, marked_edges, mesh,
+                long_edge);
+
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
+      = compute_refinement(neighbor_comm, marked_edges, shared_edges, mesh,
+                           long_edge, edge_ratio_ok);
+  MPI_Comm_free(&neighbor_comm);
+  return {std::move(cell_adj), std::move(new_vertex_coordinates),
+          std::move(parent_cell), std::move(parent_vertices)};
+}
+//-----------------------------------------------------------------------------
+std::tuple<graph::AdjacencyList<std::int64_t>, xt::xtensor<double, 2>,
+           std::vector<std::int32_t>,
+           std::map<std::int64_t, std::array<std::int64_t, 2>>>
+plaza::compute_refinement_data(const mesh::Mesh& mesh,
+                               const xtl::span<const std::int32_t>& cells)
+{
+  if (mesh.topology().cell_type() != mesh::CellType::triangle
+      and mesh.topology().cell_type() != mesh::CellType::tetrahedron)
+  {
+    throw std::runtime_error("Cell type not supported");
+  }
+
+  common::Timer t0("PLAZA: refine");
+
+  auto [neighbor_comm, shared_edges] = refinement::compute_edge_sharing(mesh);
+
+  const int tdim = mesh.topology().dim();
+  auto map_e = mesh.topology().index_map(1);
+  auto c_to_e = mesh.topology().connectivity(tdim, 1);
+  if (!c_to_e)
+  {
+    throw std::runtime_error("Connectivity missing: (" + std::to_string(tdim)
+                             + ", 1)");
+  }
+
+  // Mark the edges of the given cells in a threaded pass over the
+  // cell-edge connectivity. Threads may write to the same entry, but
+  // all writes store the same value, so the overlap is benign.
+  std::vector<std::uint8_t> edge_marked(
+      map_e->size_local() + map_e->num_ghosts(), 0);
+  auto mark_range
+      = [&c_to_e, &cells, &edge_marked](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+      for (auto edge : c_to_e->links(cells[i]))
+        edge_marked[edge] = 1;
+  };
+  const std::size_t num_threads = common::num_threads();
+  if (num_threads <= 1)
+    mark_range(0, cells.size());
+  else
+  {
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < num_threads; ++t)
+    {
+      threads.emplace_back(mark_range, (cells.size() * t) / num_threads,
+                           (cells.size() * (t + 1)) / num_threads);
+    }
+    for (std::thread& t : threads)
+      t.join();
+  }
+
+  // Get number of neighbors
+  int indegree(-1), outdegree(-2), weighted(-1);
+  MPI_Dist_graph_neighbors_count(neighbor_comm, &indegree, &outdegree,
+                                 &weighted);
+  assert(indegree == outdegree);
+  const std::vector<std::vector<std::int32_t>> edge_lists
+      = refinement::compute_shared_edge_lists(shared_edges, indegree, *map_e);
+
+  // Collect the edges shared with other processes for update
+  std::vector<bool> marked_edges(edge_marked.size(), false);
+  std::vector<std::vector<std::int32_t>> marked_for_update(indegree);
+  for (std::size_t e = 0; e < edge_marked.size(); ++e)
+  {
+    if (!edge_marked[e])
+      continue;
+    marked_edges[e] = true;
+
+    // If it is a shared edge, add all sharing neighbors to update set
+    auto map_it = shared_edges.find(e);
+    if (map_it != shared_edges.end())
+    {
+      for (int p : map_it->second)
+        marked_for_update[p].push_back(e);
+    }
+  }
+
+  // Communicate any shared edges
+  refinement::update_logical_edgefunction(neighbor_comm, edge_lists,
+                                          marked_for_update, marked_edges,
+                                          *map_e);
 
   // Enforce rules about refinement (i.e. if any edge is marked in a
   // triangle, then the longest edge must also be marked).
   const auto [long_edge, edge_ratio_ok] = face_long_edge(mesh);
-  enforce_rules(neighbor_comm, shared_edges, marked_edges, mesh, long_edge);
+  enforce_rules(neighbor_comm, shared_edges, edge_lists, marked_edges, mesh,
+                long_edge);
 
-  auto [cell_adj, new_vertex_coordinates, parent_cell]
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
       = compute_refinement(neighbor_comm, marked_edges, shared_edges, mesh,
                            long_edge, edge_ratio_ok);
   MPI_Comm_free(&neighbor_comm);
   return {std::move(cell_adj), std::move(new_vertex_coordinates),
-          std::move(parent_cell)};
+          std::move(parent_cell), std::move(parent_vertices)};
 }
 //-----------------------------------------------------------------------------
@@ -4,10 +4,13 @@
 //
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
+#include <array>
 #include <cstdint>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <map>
 #include <utility>
 #include <vector>
+#include <xtl/xspan.hpp>
 
 #pragma once
 
@@ -48,26 +51,105 @@ mesh::Mesh refine(const mesh::Mesh& mesh,
                   const mesh::MeshTags<std::int8_t>& refinement_marker,
                   bool redistribute);
 
+/// Refine with a list of marked cells, optionally redistributing. The
+/// cell indices are passed straight to the refinement kernel, where
+/// their edges are marked in a threaded pass over the cell-edge
+/// connectivity, so no intermediate MeshTags object is required, e.g.
+/// when the cells come from an error-indicator marking (see
+/// refinement::mark_doerfler).
+///
+/// @param[in] mesh Input mesh to be refined
+/// @param[in] cells Local indices of the cells whose edges should be
+/// split by this refinement
+/// @param[in] redistribute Flag to call the Mesh Partitioner to
+/// redistribute after refinement
+/// @return New Mesh
+mesh::Mesh refine(const mesh::Mesh& mesh,
+                  const xtl::span<const std::int32_t>& cells,
+                  bool redistribute);
+
+/// Uniform refine, redistributing only when the refined cell
+/// distribution is imbalanced beyond the given threshold (see
+/// refinement::compute_imbalance). Uniform refinement preserves the
+/// balance of the input mesh, so the partitioner is normally skipped.
+///
+/// @param[in] mesh Input mesh to be refined
+/// @param[in] rebalance_threshold Imbalance ratio above which the
+/// refined mesh is redistributed
+/// @return New mesh
+mesh::Mesh refine(const mesh::Mesh& mesh, double rebalance_threshold);
+
+/// Refine with markers, redistributing only when the refined cell
+/// distribution is imbalanced beyond the given threshold (see
+/// refinement::compute_imbalance)
+///
+/// @param[in] mesh Input mesh to be refined
+/// @param[in] refinement_marker MeshTags listing which mesh entities
+/// should be split by this refinement. The values are ignored.
+/// @param[in] rebalance_threshold Imbalance ratio above which the
+/// refined mesh is redistributed
+/// @return New Mesh
+mesh::Mesh refine(const mesh::Mesh& mesh,
+                  const mesh::MeshTags<std::int8_t>& refinement_marker,
+                  double rebalance_threshold);
+
+/// Uniform refine, additionally returning the parent vertices of each
+/// vertex of the refined mesh. The map is keyed by the global vertex
+/// index in the refined mesh; the value holds the global indices (in
+/// the input mesh) of the two endpoints of the bisected edge on which
+/// the vertex was created, or the vertex's own input index and -1 for
+/// vertices carried over from the input mesh. The refined cells stay
+/// on their current rank (no redistribution), so the parents of every
+/// owned vertex are present locally on the input mesh. The parent data
+/// is sufficient to build coarse-to-fine transfer operators, see
+/// refinement::create_interpolation_matrix.
+///
+/// @param[in] mesh Input mesh to be refined
+/// @return New mesh and the vertex parent map
+std::pair<mesh::Mesh, std::map<std::int64_t, std::array<std::int64_t, 2>>>
+refine_with_parent_data(const mesh::Mesh& mesh);
+
 /// Refine with markers returning new mesh data
 ///
 /// @param[in] mesh Input mesh to be refined
 /// @param[in] refinement_marker MeshTags listing which mesh entities
 /// should be split by this refinement. The values are ignored.
 /// redistribute after refinement
-/// @return New mesh data: cell topology, vertex coordinates and parent cell
-/// index
+/// @return New mesh data: cell topology, vertex coordinates, parent
+/// cell index and vertex parent map (global vertex index in the new
+/// mesh -> global indices of its parent vertices in the input mesh,
+/// second entry -1 for vertices carried over from the input mesh)
 std::tuple<graph::AdjacencyList<std::int64_t>, xt::xtensor<double, 2>,
-           std::vector<std::int32_t>>
+           std::vector<std::int32_t>,
+           std::map<std::int64_t, std::array<std::int64_t, 2>>>
 compute_refinement_data(const mesh::Mesh& mesh,
                         const mesh::MeshTags<std::int8_t>& refinement_marker);
 
+/// Refine with a list of marked cells returning new mesh data
+///
+/// @param[in] mesh Input mesh to be refined
+/// @param[in] cells Local indices of the cells whose edges should be
+/// split by this refinement
+/// @return New mesh data: cell topology, vertex coordinates, parent
+/// cell index and vertex parent map (global vertex index in the new
+/// mesh -> global indices of its parent vertices in the input mesh,
+/// second entry -1 for vertices carried over from the input mesh)
+std::tuple<graph::AdjacencyList<std::int64_t>, xt::xtensor<double, 2>,
+           std::vector<std::int32_t>,
+           std::map<std::int64_t, std::array<std::int64_t, 2>>>
+compute_refinement_data(const mesh::Mesh& mesh,
+                        const xtl::span<const std::int32_t>& cells);
+
 /// Refine mesh returning new mesh data
 ///
 /// @param[in] mesh Input mesh to be refined
-/// @return New mesh data: cell topology, vertex coordinates and parent cell
-/// index
+/// @return New mesh data: cell topology, vertex coordinates, parent
+/// cell index and vertex parent map (global vertex index in the new
+/// mesh -> global indices of its parent vertices in the input mesh,
+/// second entry -1 for vertices carried over from the input mesh)
 std::tuple<graph::AdjacencyList<std::int64_t>, xt::xtensor<double, 2>,
-           std::vector<std::int32_t>>
+           std::vector<std::int32_t>,
+           std::map<std::int64_t, std::array<std::int64_t, 2>>>
 compute_refinement_data(const mesh::Mesh& mesh);
 
 } // namespace plaza
@@ -6,6 +6,7 @@
 
 #include "refine.h"
 #include "plaza.h"
+#include "uniform.h"
 #include <dolfinx/common/log.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/MeshTags.h>
@@ -23,7 +24,7 @@ mesh::Mesh dolfinx::refinement::refine(const mesh::Mesh& mesh,
     throw std::runtime_error("Refinement only defined for simplices");
   }
 
-  mesh::Mesh refined_mesh = plaza::refine(mesh, redistribute);
+  mesh::Mesh refined_mesh = uniform::refine(mesh, redistribute);
 
   // Report the number of refined cells
   const int D = mesh.topology().dim();
@@ -60,3 +61,97 @@ dolfinx::refinement::refine(const mesh::Mesh& mesh,
   return refined_mesh;
 }
 //-----------------------------------------------------------------------------
+mesh::Mesh
+dolfinx::refinement::refine(const mesh::Mesh& mesh,
+                            const xtl::span<const std::int32_t>& cells,
+                            bool redistribute)
+{
+  if (mesh.topology().cell_type() != mesh::CellType::triangle
+      and mesh.topology().cell_type() != mesh::CellType::tetrahedron)
+  {
+    throw std::runtime_error("Refinement only defined for simplices");
+  }
+
+  mesh::Mesh refined_mesh = plaza::refine(mesh, cells, redistribute);
+
+  // Report the number of refined cells
+  const int D = mesh.topology().dim();
+  const std::int64_t n0 = mesh.topology().index_map(D)->size_global();
+  const std::int64_t n1 = refined_mesh.topology().index_map(D)->size_global();
+  LOG(INFO) << "Number of cells increased from " << n0 << " to " << n1 << " ("
+            << 100.0 * (static_cast<double>(n1) / static_cast<double>(n0) - 1.0)
+            << "%% increase).";
+
+  return refined_mesh;
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh dolfinx::refinement::refine(const mesh::Mesh& mesh,
+                                       double rebalance_threshold)
+{
+  if (mesh.topology().cell_type() != mesh::CellType::triangle
+      and mesh.topology().cell_type() != mesh::CellType::tetrahedron)
+  {
+    throw std::runtime_error("Refinement only defined for simplices");
+  }
+
+  mesh::Mesh refined_mesh = uniform::refine(mesh, rebalance_threshold);
+
+  // Report the number of refined cells
+  const int D = mesh.topology().dim();
+  const std::int64_t n0 = mesh.topology().index_map(D)->size_global();
+  const std::int64_t n1 = refined_mesh.topology().index_map(D)->size_global();
+  LOG(INFO) << "Number of cells increased from " << n0 << " to " << n1 << " ("
+            << 100.0 * (static_cast<double>(n1) / static_cast<double>(n0) - 1.0)
+            << "%% increase).";
+
+  return refined_mesh;
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh
+dolfinx::refinement::refine(const mesh::Mesh& mesh,
+                            const mesh::MeshTags<std::int8_t>& cell_markers,
+                            double rebalance_threshold)
+{
+  if (mesh.topology().cell_type() != mesh::CellType::triangle
+      and mesh.topology().cell_type() != mesh::CellType::tetrahedron)
+  {
+    throw std::runtime_error("Refinement only defined for simplices");
+  }
+
+  mesh::Mesh refined_mesh
+      = plaza::refine(mesh, cell_markers, rebalance_threshold);
+
+  // Report the number of refined cells
+  const int D = mesh.topology().dim();
+  const std::int64_t n0 = mesh.topology().index_map(D)->size_global();
+  const std::int64_t n1 = refined_mesh.topology().index_map(D)->size_global();
+  LOG(INFO) << "Number of cells increased from " << n0 << " to " << n1 << " ("
+            << 100.0 * (static_cast<double>(n1) / static_cast<double>(n0) - 1.0)
+            << "%% increase).";
+
+  return refined_mesh;
+}
+//-----------------------------------------------------------------------------
+std::pair<mesh::Mesh, std::map<std::int64_t, std::array<std::int64_t, 2>>>
+dolfinx::refinement::refine_with_parent_data(const mesh::Mesh& mesh)
+{
+  if (mesh.topology().cell_type() != mesh::CellType::triangle
+      and mesh.topology().cell_type() != mesh::CellType::tetrahedron)
+  {
+    throw std::runtime_error("Refinement only defined for simplices");
+  }
+
+  auto [refined_mesh, parent_vertices]
+      = uniform::refine_with_parent_data(mesh);
+
+  // Report the number of refined cells
+  const int D = mesh.topology().dim();
+  const std::int64_t n0 = mesh.topology().index_map(D)->size_global();
+  const std::int64_t n1 = refined_mesh.topology().index_map(D)->size_global();
+  LOG(INFO) << "Number of cells increased from " << n0 << " to " << n1 << " ("
+            << 100.0 * (static_cast<double>(n1) / static_cast<double>(n0) - 1.0)
+            << "%% increase).";
+
+  return {std::move(refined_mesh), std::move(parent_vertices)};
+}
+//-----------------------------------------------------------------------------
@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <map>
+#include <utility>
+#include <xtl/xspan.hpp>
 
 namespace dolfinx::mesh
 {
@@ -18,7 +22,10 @@ class MeshTags;
 namespace dolfinx::refinement
 {
 
-/// Create uniformly refined mesh
+/// Create uniformly refined mesh. Every edge is bisected and each cell
+/// is replaced by a closed-form set of children (see
+/// refinement::uniform), so the marked-edge machinery of the local
+/// refinement overloads is bypassed entirely.
 ///
 /// @param[in] mesh The mesh from which to build a refined Mesh
 /// @param[in] redistribute Optional argument to redistribute the
@@ -39,4 +46,62 @@ mesh::Mesh refine(const mesh::Mesh& mesh,
                   const mesh::MeshTags<std::int8_t>& cell_markers,
                   bool redistribute = true);
 
+/// Create locally refined mesh from a list of marked cells, e.g. from
+/// an error-indicator marking (see refinement::mark_doerfler). The
+/// cell indices are passed straight to the refinement kernel, which
+/// marks their edges in a threaded pass over the cell-edge
+/// connectivity, so no intermediate MeshTags object is required.
+///
+/// @param[in] mesh The mesh from which to build a refined Mesh
+/// @param[in] cells Local indices of the cells whose edges should be
+///     split by this refinement
+/// @param[in] redistribute Optional argument to redistribute the
+///     refined mesh if mesh is a distributed mesh.
+/// @return A locally refined mesh
+mesh::Mesh refine(const mesh::Mesh& mesh,
+                  const xtl::span<const std::int32_t>& cells,
+                  bool redistribute = true);
+
+/// Create uniformly refined mesh, redistributing only when the refined
+/// cell distribution is imbalanced beyond the given threshold. Uniform
+/// refinement preserves the balance of the input mesh, so the
+/// partitioner is normally skipped, which is considerably cheaper when
+/// building a refinement hierarchy, e.g. for multigrid.
+///
+/// @param[in] mesh The mesh from which to build a refined Mesh
+/// @param[in] rebalance_threshold Imbalance ratio (maximum local cell
+///     count over mean) above which the refined mesh is redistributed
+/// @return A refined mesh
+mesh::Mesh refine(const mesh::Mesh& mesh, double rebalance_threshold);
+
+/// Create locally refined mesh, redistributing only when the refined
+/// cell distribution is imbalanced beyond the given threshold
+///
+/// @param[in] mesh The mesh from which to build a refined Mesh
+/// @param[in] cell_markers A mesh function over integers specifying
+///     which cells should be refined (value == 1) (and which should not
+///     (any other integer value)).
+/// @param[in] rebalance_threshold Imbalance ratio (maximum local cell
+///     count over mean) above which the refined mesh is redistributed
+/// @return A locally refined mesh
+mesh::Mesh refine(const mesh::Mesh& mesh,
+                  const mesh::MeshTags<std::int8_t>& cell_markers,
+                  double rebalance_threshold);
+
+/// Create uniformly refined mesh, additionally returning the parent
+/// vertices of each vertex of the refined mesh. The map is keyed by
+/// the global vertex index in the refined mesh; the value holds the
+/// global indices (in the input mesh) of the two endpoints of the
+/// bisected edge on which the vertex was created, or the vertex's own
+/// input index and -1 for vertices carried over from the input mesh.
+/// The refined cells stay on their current rank (no redistribution).
+/// The parent data is sufficient to build coarse-to-fine transfer
+/// operators for geometric multigrid, see
+/// refinement::create_interpolation_matrix.
+///
+/// @param[in] mesh The mesh from which to build a refined Mesh
+/// @return A refined mesh and the vertex parent map
+std::pair<mesh::Mesh, std::map<std::int64_t, std::array<std::int64_t, 2>>>
+refine_with_parent_data(const mesh::Mesh& mesh);
+
 } // namespace dolfinx::refinement
@@ -0,0 +1,305 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "transfer.h"
+#include <algorithm>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/utils.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/fem/ElementDofLayout.h>
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+using namespace dolfinx;
+
+namespace
+{
+//-----------------------------------------------------------------------------
+
+/// Execute f(begin, end) over the index range [0, n), splitting the
+/// range across common::num_threads() threads. Writes from different
+/// sub-ranges must not overlap.
+template <typename Fn>
+void parallel_for_ranges(std::size_t n, Fn&& f)
+{
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads <= 1)
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    const std::size_t begin = (n * t) / num_threads;
+    const std::size_t end = (n * (t + 1)) / num_threads;
+    if (begin != end)
+      threads.emplace_back(f, begin, end);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+}
+//-----------------------------------------------------------------------------
+// Map each local mesh vertex (owned and ghost) to the local degree of
+// freedom attached to it, via the cell dofmaps. Requires exactly one
+// dof per vertex, i.e. a scalar continuous Lagrange space of degree 1.
+std::vector<std::int32_t> vertex_to_dof_map(const fem::FunctionSpace& V)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = V.mesh();
+  assert(mesh);
+  std::shared_ptr<const fem::DofMap> dofmap = V.dofmap();
+  assert(dofmap);
+  assert(dofmap->element_dof_layout);
+  const fem::ElementDofLayout& layout = *dofmap->element_dof_layout;
+
+  const int num_cell_vertices
+      = mesh::cell_num_entities(mesh->topology().cell_type(), 0);
+  if (dofmap->bs() != 1 or layout.num_dofs() != num_cell_vertices
+      or layout.num_entity_dofs(0) != 1)
+  {
+    throw std::runtime_error("Interpolation matrix requires scalar "
+                             "continuous Lagrange spaces of degree 1.");
+  }
+
+  const int tdim = mesh->topology().dim();
+  auto c_to_v = mesh->topology().connectivity(tdim, 0);
+  if (!c_to_v)
+    throw std::runtime_error("Missing cell-vertex connectivity.");
+  auto map_v = mesh->topology().index_map(0);
+  assert(map_v);
+
+  std::vector<std::int32_t> vertex_to_dof(
+      map_v->size_local() + map_v->num_ghosts(), -1);
+  for (std::int32_t c = 0; c < c_to_v->num_nodes(); ++c)
+  {
+    auto vertices = c_to_v->links(c);
+    auto dofs = dofmap->cell_dofs(c);
+    for (std::size_t v = 0; v < vertices.size(); ++v)
+      vertex_to_dof[vertices[v]] = dofs[layout.entity_dofs(0, v)[0]];
+  }
+
+  return vertex_to_dof;
+}
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+la::MatrixCSR<double> refinement::create_interpolation_matrix(
+    const fem::FunctionSpace& coarse_space,
+    const fem::FunctionSpace& fine_space,
+    const std::map<std::int64_t, std::array<std::int64_t, 2>>& parent_vertices)
+{
+  const std::vector<std::int32_t> coarse_vertex_to_dof
+      = vertex_to_dof_map(coarse_space);
+  const std::vector<std::int32_t> fine_vertex_to_dof
+      = vertex_to_dof_map(fine_space);
+
+  std::shared_ptr<const mesh::Mesh> coarse_mesh = coarse_space.mesh();
+  std::shared_ptr<const mesh::Mesh> fine_mesh = fine_space.mesh();
+
+  // Map the global index of each locally present coarse vertex to the
+  // local coarse dof attached to it
+  const std::vector<std::int64_t> coarse_vertex_global
+      = coarse_mesh->topology().index_map(0)->global_indices();
+  std::map<std::int64_t, std::int32_t> coarse_dof;
+  for (std::size_t v = 0; v < coarse_vertex_global.size(); ++v)
+    coarse_dof.insert({coarse_vertex_global[v], coarse_vertex_to_dof[v]});
+
+  // Build the matrix entries: each owned fine dof takes the coarse
+  // value at its parent vertex (weight 1), or the mean of the values
+  // at the endpoints of its parent edge (weight 1/2 each)
+  const std::vector<std::int64_t> fine_vertex_global
+      = fine_mesh->topology().index_map(0)->global_indices();
+  const std::shared_ptr<const common::IndexMap> map_row
+      = fine_space.dofmap()->index_map;
+  assert(map_row);
+  const std::int32_t num_owned_rows = map_row->size_local();
+
+  std::vector<std::int32_t> rows, cols;
+  std::vector<double> weights;
+  for (std::size_t v = 0; v < fine_vertex_global.size(); ++v)
+  {
+    const std::int32_t row = fine_vertex_to_dof[v];
+    if (row < 0 or row >= num_owned_rows)
+      continue;
+
+    auto it = parent_vertices.find(fine_vertex_global[v]);
+    if (it == parent_vertices.end())
+    {
+      throw std::runtime_error(
+          "Vertex parent data does not cover the fine mesh. The refined "
+          "mesh must not be redistributed, see refine_with_parent_data.");
+    }
+
+    const std::array<std::int64_t, 2>& parents = it->second;
+    const double w = parents[1] == -1 ? 1.0 : 0.5;
+    for (std::int64_t parent : parents)
+    {
+      if (parent == -1)
+        continue;
+      auto dof = coarse_dof.find(parent);
+      if (dof == coarse_dof.end())
+      {
+        throw std::runtime_error(
+            "Parent vertex is not present on the coarse mesh. The refined "
+            "mesh must not be redistributed, see refine_with_parent_data.");
+      }
+      rows.push_back(row);
+      cols.push_back(dof->second);
+      weights.push_back(w);
+    }
+  }
+
+  la::SparsityPattern pattern(
+      fine_mesh->mpi_comm(), {map_row, coarse_space.dofmap()->index_map},
+      {1, 1});
+  for (std::size_t i = 0; i < rows.size(); ++i)
+  {
+    pattern.insert(xtl::span<const std::int32_t>(rows.data() + i, 1),
+                   xtl::span<const std::int32_t>(cols.data() + i, 1));
+  }
+  pattern.assemble();
+
+  la::MatrixCSR<double> A(pattern);
+  for (std::size_t i = 0; i < rows.size(); ++i)
+    A.add(1, &rows[i], 1, &cols[i], &weights[i]);
+
+  return A;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::int32_t> refinement::compute_parent_entities(
+    const mesh::Mesh& refined_mesh, const mesh::Mesh& parent_mesh, int dim,
+    const xtl::span<const std::int32_t>& parent_cell,
+    const std::map<std::int64_t, std::array<std::int64_t, 2>>& parent_vertices)
+{
+  const int tdim = parent_mesh.topology().dim();
+  assert(refined_mesh.topology().dim() == tdim);
+
+  refined_mesh.topology_mutable().create_entities(dim);
+  auto map_e = refined_mesh.topology().index_map(dim);
+  assert(map_e);
+  const std::int32_t num_child = map_e->size_local() + map_e->num_ghosts();
+  std::vector<std::int32_t> parent_entity(num_child, -1);
+
+  if (dim == tdim)
+  {
+    // Cells of the refined mesh appear in the order produced by
+    // compute_refinement_data when the mesh is not redistributed, so
+    // the parent cell array applies directly to the owned cells. Ghost
+    // cells are resolved by their owning rank.
+    const std::int32_t num_cells = std::min<std::int32_t>(
+        parent_cell.size(), map_e->size_local());
+    std::copy_n(parent_cell.begin(), num_cells, parent_entity.begin());
+    return parent_entity;
+  }
+
+  refined_mesh.topology_mutable().create_connectivity(dim, 0);
+  parent_mesh.topology_mutable().create_entities(dim);
+  parent_mesh.topology_mutable().create_connectivity(dim, 0);
+  parent_mesh.topology_mutable().create_connectivity(0, dim);
+
+  auto e_to_v = refined_mesh.topology().connectivity(dim, 0);
+  assert(e_to_v);
+  auto parent_e_to_v = parent_mesh.topology().connectivity(dim, 0);
+  assert(parent_e_to_v);
+  auto parent_v_to_e = parent_mesh.topology().connectivity(0, dim);
+  assert(parent_v_to_e);
+
+  // Map the global index of each locally present parent vertex to its
+  // local index
+  const std::vector<std::int64_t> parent_vertex_global
+      = parent_mesh.topology().index_map(0)->global_indices();
+  std::map<std::int64_t, std::int32_t> parent_vertex_local;
+  for (std::size_t v = 0; v < parent_vertex_global.size(); ++v)
+    parent_vertex_local.insert({parent_vertex_global[v], std::int32_t(v)});
+
+  const std::vector<std::int64_t> child_vertex_global
+      = refined_mesh.topology().index_map(0)->global_indices();
+
+  // Match each child entity against the parent entities incident to
+  // the parents of its vertices. The child entity is contained in a
+  // parent entity of the same dimension exactly when the vertex set of
+  // the parent entity contains the parents of every child vertex.
+  parallel_for_ranges(
+      num_child,
+      [&](std::size_t begin, std::size_t end)
+      {
+        std::vector<std::int32_t> parents;
+        for (std::size_t e = begin; e < end; ++e)
+        {
+          // Collect the local parent vertices of the child entity
+          parents.clear();
+          bool resolved = true;
+          for (std::int32_t v : e_to_v->links(std::int32_t(e)))
+          {
+            auto it = parent_vertices.find(child_vertex_global[v]);
+            if (it == parent_vertices.end())
+            {
+              resolved = false;
+              break;
+            }
+            for (std::int64_t parent : it->second)
+            {
+              if (parent == -1)
+                continue;
+              auto it_local = parent_vertex_local.find(parent);
+              if (it_local == parent_vertex_local.end())
+              {
+                resolved = false;
+                break;
+              }
+              if (std::find(parents.begin(), parents.end(), it_local->second)
+                  == parents.end())
+              {
+                parents.push_back(it_local->second);
+              }
+            }
+            if (!resolved)
+              break;
+          }
+          if (!resolved or parents.empty())
+            continue;
+
+          // Find the parent entity containing all parent vertices,
+          // among the entities incident to the first one
+          std::int32_t match = -1;
+          bool unique = true;
+          for (std::int32_t candidate : parent_v_to_e->links(parents[0]))
+          {
+            auto vertices = parent_e_to_v->links(candidate);
+            const bool contains_all = std::all_of(
+                parents.begin(), parents.end(),
+                [&vertices](std::int32_t p) {
+                  return std::find(vertices.begin(), vertices.end(), p)
+                         != vertices.end();
+                });
+            if (contains_all)
+            {
+              if (match >= 0)
+              {
+                unique = false;
+                break;
+              }
+              match = candidate;
+            }
+          }
+          if (match >= 0 and unique)
+            parent_entity[e] = match;
+        }
+      });
+
+  return parent_entity;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,172 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/MeshTags.h>
+#include <dolfinx/mesh/Topology.h>
+#include <map>
+#include <memory>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::fem
+{
+class FunctionSpace;
+}
+
+namespace dolfinx::refinement
+{
+
+/// Build the interpolation (prolongation) matrix from a function space
+/// on a coarse mesh to a function space on the refined mesh created
+/// from it by refine_with_parent_data. Rows correspond to fine degrees
+/// of freedom and columns to coarse degrees of freedom; the transpose
+/// of the matrix acts as the restriction operator, as required for a
+/// geometric multigrid hierarchy.
+///
+/// Both spaces must be scalar continuous Lagrange spaces of degree 1,
+/// for which the interpolant is determined by the vertex parent data:
+/// a vertex carried over from the coarse mesh takes the coarse value
+/// (weight 1), and a vertex created on a bisected edge takes the mean
+/// of the values at the edge endpoints (weight 1/2 each).
+///
+/// @param[in] coarse_space Function space on the coarse mesh
+/// @param[in] fine_space Function space on the refined mesh
+/// @param[in] parent_vertices Vertex parent map returned by
+/// refine_with_parent_data, relating the two meshes
+/// @return The interpolation matrix, with a row for each fine degree
+/// of freedom owned by this rank
+la::MatrixCSR<double> create_interpolation_matrix(
+    const fem::FunctionSpace& coarse_space,
+    const fem::FunctionSpace& fine_space,
+    const std::map<std::int64_t, std::array<std::int64_t, 2>>&
+        parent_vertices);
+
+/// Compute, for each entity of a refined mesh, the parent mesh entity
+/// of the same dimension that contains it. Cells are matched with the
+/// parent cell array returned by plaza::compute_refinement_data; lower
+/// dimensional entities are matched in a threaded pass through the
+/// vertex parent map, by locating the parent entity whose vertex set
+/// contains the parents of every vertex of the child entity. Entities
+/// created in the interior of a parent cell (or, for lower dimensions,
+/// in the interior of a higher-dimensional parent entity) have no
+/// parent of the same dimension.
+///
+/// The refined mesh must have been created from the parent mesh
+/// without redistribution, so that the parents of every local entity
+/// are present locally, see plaza::refine_with_parent_data.
+///
+/// @param[in] refined_mesh The refined mesh
+/// @param[in] parent_mesh The mesh that was refined
+/// @param[in] dim Topological dimension of the entities
+/// @param[in] parent_cell Parent cell index of each refined cell, as
+/// returned by plaza::compute_refinement_data
+/// @param[in] parent_vertices Vertex parent map relating the two
+/// meshes
+/// @return Local parent entity index for each entity (owned and ghost)
+/// of the refined mesh, or -1 if the entity has no parent of the same
+/// dimension
+std::vector<std::int32_t> compute_parent_entities(
+    const mesh::Mesh& refined_mesh, const mesh::Mesh& parent_mesh, int dim,
+    const xtl::span<const std::int32_t>& parent_cell,
+    const std::map<std::int64_t, std::array<std::int64_t, 2>>&
+        parent_vertices);
+
+/// Transfer tags from a mesh to a refined mesh created from it,
+/// mapping the tag of each parent entity to all child entities it
+/// contains (see compute_parent_entities). This avoids re-running
+/// locate_entities and geometric classification after each refinement.
+/// Ghost entities of the refined mesh take the value assigned by their
+/// owning rank.
+///
+/// @param[in] tags Tags on the parent mesh
+/// @param[in] refined_mesh The refined mesh, created from the parent
+/// mesh without redistribution
+/// @param[in] parent_cell Parent cell index of each refined cell, as
+/// returned by plaza::compute_refinement_data
+/// @param[in] parent_vertices Vertex parent map relating the two
+/// meshes
+/// @return Tags on the refined mesh
+template <typename T>
+mesh::MeshTags<T> transfer_meshtags(
+    const mesh::MeshTags<T>& tags,
+    const std::shared_ptr<const mesh::Mesh>& refined_mesh,
+    const std::vector<std::int32_t>& parent_cell,
+    const std::map<std::int64_t, std::array<std::int64_t, 2>>& parent_vertices)
+{
+  assert(refined_mesh);
+  std::shared_ptr<const mesh::Mesh> parent_mesh = tags.mesh();
+  assert(parent_mesh);
+  const int dim = tags.dim();
+
+  const std::vector<std::int32_t> parent_entity = compute_parent_entities(
+      *refined_mesh, *parent_mesh, dim, parent_cell, parent_vertices);
+
+  // Build dense tag data over the parent entities
+  auto map_parent = parent_mesh->topology().index_map(dim);
+  assert(map_parent);
+  const std::int32_t num_parent
+      = map_parent->size_local() + map_parent->num_ghosts();
+  std::vector<T> parent_values(num_parent);
+  std::vector<std::int8_t> parent_marker(num_parent, 0);
+  const std::vector<std::int32_t>& indices = tags.indices();
+  const std::vector<T>& values = tags.values();
+  for (std::size_t i = 0; i < indices.size(); ++i)
+  {
+    assert(indices[i] < num_parent);
+    parent_values[indices[i]] = values[i];
+    parent_marker[indices[i]] = 1;
+  }
+
+  // Transfer to child entities with a tagged parent
+  auto map_child = refined_mesh->topology().index_map(dim);
+  assert(map_child);
+  const std::int32_t num_local = map_child->size_local();
+  const std::int32_t num_child = num_local + map_child->num_ghosts();
+  std::vector<T> child_values(num_child);
+  std::vector<std::int8_t> child_marker(num_child, 0);
+  for (std::int32_t e = 0; e < num_child; ++e)
+  {
+    if (std::int32_t p = parent_entity[e]; p >= 0 and parent_marker[p])
+    {
+      child_values[e] = parent_values[p];
+      child_marker[e] = 1;
+    }
+  }
+
+  // Update ghost entities with the value assigned by the owning rank
+  map_child->scatter_fwd(
+      xtl::span<const T>(child_values.data(), num_local),
+      xtl::span<T>(child_values.data() + num_local, num_child - num_local), 1);
+  map_child->scatter_fwd(
+      xtl::span<const std::int8_t>(child_marker.data(), num_local),
+      xtl::span<std::int8_t>(child_marker.data() + num_local,
+                             num_child - num_local),
+      1);
+
+  // Collect the tagged entities (in ascending index order)
+  std::vector<std::int32_t> child_indices;
+  std::vector<T> tag_values;
+  for (std::int32_t e = 0; e < num_child; ++e)
+  {
+    if (child_marker[e])
+    {
+      child_indices.push_back(e);
+      tag_values.push_back(child_values[e]);
+    }
+  }
+
+  return mesh::MeshTags<T>(refined_mesh, dim, std::move(child_indices),
+                           std::move(tag_values));
+}
+
+} // namespace dolfinx::refinement
@@ -0,0 +1,364 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "uniform.h"
+#include "utils.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/common/utils.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/utils.h>
+#include <map>
+#include <mpi.h>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xview.hpp>
+
+using namespace dolfinx;
+using namespace dolfinx::refinement;
+
+namespace
+{
+//-----------------------------------------------------------------------------
+
+/// Execute f(begin, end) over the index range [0, n), splitting the
+/// range across common::num_threads() threads. Writes from different
+/// sub-ranges must not overlap.
+template <typename Fn>
+void parallel_for_ranges(std::size_t n, Fn&& f)
+{
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads <= 1)
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    const std::size_t begin = (n * t) / num_threads;
+    const std::size_t end = (n * (t + 1)) / num_threads;
+    if (begin != end)
+      threads.emplace_back(f, begin, end);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+}
+//-----------------------------------------------------------------------------
+
+// Child cells of the uniform subdivision, as indices into the
+// [vertices][edge midpoints] array of a cell: 3 + 3 entries in 2D,
+// 4 + 6 in 3D, with the midpoint of local edge i at position
+// num_cell_vertices + i.
+
+// Edge i of a triangle is opposite vertex i. The pattern matches the
+// uniform case of the Plaza subdivision: three corner triangles and
+// the central one.
+constexpr std::int32_t triangle_children[4][3]
+    = {{3, 4, 2}, {4, 5, 0}, {5, 3, 1}, {5, 4, 3}};
+
+// Tetrahedron edges are numbered {2,3}, {1,3}, {1,2}, {0,3}, {0,2},
+// {0,1}. Cutting off the four corner tetrahedra leaves an octahedron
+// of the six edge midpoints, which is split into four tetrahedra along
+// the fixed diagonal joining the midpoints of the opposite edges (0,1)
+// and (2,3) (indices 9 and 4). The diagonal is interior to the cell,
+// so the choice needs no coordination with neighboring cells or
+// processes.
+constexpr std::int32_t tetrahedron_children[8][4]
+    = {{0, 9, 8, 7}, {1, 9, 6, 5}, {2, 8, 6, 4}, {3, 7, 5, 4},
+       {4, 9, 5, 6}, {4, 9, 6, 8}, {4, 9, 8, 7}, {4, 9, 7, 5}};
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+mesh::Mesh uniform::refine(const mesh::Mesh& mesh, bool redistribute)
+{
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
+      = uniform::compute_refinement_data(mesh);
+
+  if (dolfinx::MPI::size(mesh.mpi_comm()) == 1)
+  {
+    return mesh::create_mesh(mesh.mpi_comm(), cell_adj, mesh.geometry().cmap(),
+                             new_vertex_coordinates, mesh::GhostMode::none);
+  }
+
+  const std::shared_ptr<const common::IndexMap> map_c
+      = mesh.topology().index_map(mesh.topology().dim());
+  const int num_ghost_cells = map_c->num_ghosts();
+  // Check if mesh has ghost cells on any rank
+  // FIXME: this is not a robust test. Should be user option.
+  int max_ghost_cells = 0;
+  MPI_Allreduce(&num_ghost_cells, &max_ghost_cells, 1, MPI_INT, MPI_MAX,
+                mesh.mpi_comm());
+
+  // Build mesh
+  const mesh::GhostMode ghost_mode = max_ghost_cells == 0
+                                         ? mesh::GhostMode::none
+                                         : mesh::GhostMode::shared_facet;
+
+  return refinement::partition(mesh, cell_adj, new_vertex_coordinates,
+                               redistribute, ghost_mode);
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh uniform::refine(const mesh::Mesh& mesh, double rebalance_threshold)
+{
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
+      = uniform::compute_refinement_data(mesh);
+
+  if (dolfinx::MPI::size(mesh.mpi_comm()) == 1)
+  {
+    return mesh::create_mesh(mesh.mpi_comm(), cell_adj, mesh.geometry().cmap(),
+                             new_vertex_coordinates, mesh::GhostMode::none);
+  }
+
+  const std::shared_ptr<const common::IndexMap> map_c
+      = mesh.topology().index_map(mesh.topology().dim());
+  const int num_ghost_cells = map_c->num_ghosts();
+  // Check if mesh has ghost cells on any rank
+  // FIXME: this is not a robust test. Should be user option.
+  int max_ghost_cells = 0;
+  MPI_Allreduce(&num_ghost_cells, &max_ghost_cells, 1, MPI_INT, MPI_MAX,
+                mesh.mpi_comm());
+
+  // Build mesh
+  const mesh::GhostMode ghost_mode = max_ghost_cells == 0
+                                         ? mesh::GhostMode::none
+                                         : mesh::GhostMode::shared_facet;
+
+  return refinement::partition(mesh, cell_adj, new_vertex_coordinates,
+                               rebalance_threshold, ghost_mode);
+}
+//-----------------------------------------------------------------------------
+std::pair<mesh::Mesh, std::map<std::int64_t, std::array<std::int64_t, 2>>>
+uniform::refine_with_parent_data(const mesh::Mesh& mesh)
+{
+  auto [cell_adj, new_vertex_coordinates, parent_cell, parent_vertices]
+      = uniform::compute_refinement_data(mesh);
+
+  if (dolfinx::MPI::size(mesh.mpi_comm()) == 1)
+  {
+    return {mesh::create_mesh(mesh.mpi_comm(), cell_adj,
+                              mesh.geometry().cmap(), new_vertex_coordinates,
+                              mesh::GhostMode::none),
+            std::move(parent_vertices)};
+  }
+
+  const std::shared_ptr<const common::IndexMap> map_c
+      = mesh.topology().index_map(mesh.topology().dim());
+  const int num_ghost_cells = map_c->num_ghosts();
+  // Check if mesh has ghost cells on any rank
+  // FIXME: this is not a robust test. Should be user option.
+  int max_ghost_cells = 0;
+  MPI_Allreduce(&num_ghost_cells, &max_ghost_cells, 1, MPI_INT, MPI_MAX,
+                mesh.mpi_comm());
+
+  // Build mesh. Cells stay on their current rank so that the parent
+  // vertices of every owned vertex of the new mesh remain locally
+  // available on the input mesh.
+  const mesh::GhostMode ghost_mode = max_ghost_cells == 0
+                                         ? mesh::GhostMode::none
+                                         : mesh::GhostMode::shared_facet;
+
+  return {refinement::partition(mesh, cell_adj, new_vertex_coordinates, false,
+                                ghost_mode),
+          std::move(parent_vertices)};
+}
+//-----------------------------------------------------------------------------
+std::tuple<graph::AdjacencyList<std::int64_t>, xt::xtensor<double, 2>,
+           std::vector<std::int32_t>,
+           std::map<std::int64_t, std::array<std::int64_t, 2>>>
+uniform::compute_refinement_data(const mesh::Mesh& mesh)
+{
+  if (mesh.topology().cell_type() != mesh::CellType::triangle
+      and mesh.topology().cell_type() != mesh::CellType::tetrahedron)
+  {
+    throw std::runtime_error("Cell type not supported");
+  }
+
+  common::Timer t0("UNIFORM: refine");
+
+  const int tdim = mesh.topology().dim();
+  mesh.topology_mutable().create_entities(1);
+  mesh.topology_mutable().create_connectivity(tdim, 1);
+
+  auto map_v = mesh.topology().index_map(0);
+  assert(map_v);
+  auto map_e = mesh.topology().index_map(1);
+  assert(map_e);
+  auto map_c = mesh.topology().index_map(tdim);
+  assert(map_c);
+
+  auto c_to_v = mesh.topology().connectivity(tdim, 0);
+  assert(c_to_v);
+  auto c_to_e = mesh.topology().connectivity(tdim, 1);
+  assert(c_to_e);
+  auto e_to_v = mesh.topology().connectivity(1, 0);
+  assert(e_to_v);
+
+  const std::int32_t num_owned_edges = map_e->size_local();
+  const std::int32_t num_edges = num_owned_edges + map_e->num_ghosts();
+
+  // Every edge is bisected, so there is no marker to scan: renumber the
+  // existing vertices making room for one new vertex per owned edge
+  std::vector<std::int64_t> global_v
+      = refinement::adjust_indices(*map_v, num_owned_edges);
+
+  // The new vertices of rank r occupy the block starting at the end of
+  // the adjusted range of r's old vertices, i.e. at v_end(r) + S(r),
+  // where S(r) is the number of edges owned by ranks before r, which
+  // is just the start of r's edge range. The new vertex of the edge
+  // with global index ge owned by rank r therefore has global index
+  // v_end(r) + ge, so new vertices are enumerated directly from the
+  // edge IndexMap, with no per-edge communication. (This coincides
+  // with the numbering produced by create_new_vertices when all edges
+  // are marked.)
+  MPI_Comm comm = mesh.mpi_comm();
+  const int mpi_rank = dolfinx::MPI::rank(comm);
+  const int mpi_size = dolfinx::MPI::size(comm);
+  const std::int64_t v_end = map_v->local_range()[1];
+  std::vector<std::int64_t> v_ends(mpi_size);
+  MPI_Allgather(&v_end, 1, dolfinx::MPI::mpi_type<std::int64_t>(),
+                v_ends.data(), 1, dolfinx::MPI::mpi_type<std::int64_t>(),
+                comm);
+
+  std::vector<std::int64_t> edge_vertex(num_edges);
+  const std::int64_t edge_offset = map_e->local_range()[0];
+  for (std::int32_t e = 0; e < num_owned_edges; ++e)
+    edge_vertex[e] = v_ends[mpi_rank] + edge_offset + e;
+  const std::vector<std::int64_t>& ghost_edges = map_e->ghosts();
+  const std::vector<int>& ghost_owners = map_e->ghost_owner_rank();
+  for (std::size_t i = 0; i < ghost_edges.size(); ++i)
+    edge_vertex[num_owned_edges + i] = v_ends[ghost_owners[i]] + ghost_edges[i];
+
+  // Build map from vertex -> geometry dof. Cells sharing a vertex
+  // store the same geometry dof for it, so overlapping writes from
+  // different threads are benign
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  std::vector<std::int32_t> vertex_to_x(map_v->size_local()
+                                        + map_v->num_ghosts());
+  parallel_for_ranges(map_c->size_local() + map_c->num_ghosts(),
+                      [&c_to_v, &x_dofmap,
+                       &vertex_to_x](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t c = begin; c < end; ++c)
+                        {
+                          auto vertices = c_to_v->links(std::int32_t(c));
+                          auto dofs = x_dofmap.links(std::int32_t(c));
+                          for (std::size_t i = 0; i < vertices.size(); ++i)
+                            vertex_to_x[vertices[i]] = dofs[i];
+                        }
+                      });
+
+  // Copy over existing mesh vertices and append the midpoints of the
+  // owned edges
+  const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
+  const std::size_t num_vertices = map_v->size_local();
+  xt::xtensor<double, 2> new_vertex_coordinates(
+      {num_vertices + num_owned_edges, 3});
+  parallel_for_ranges(
+      num_vertices,
+      [&x_g, &vertex_to_x, &new_vertex_coordinates](std::size_t begin,
+                                                    std::size_t end)
+      {
+        for (std::size_t v = begin; v < end; ++v)
+          for (std::size_t j = 0; j < x_g.shape(1); ++j)
+            new_vertex_coordinates(v, j) = x_g(vertex_to_x[v], j);
+      });
+
+  std::vector<std::int32_t> edges(num_owned_edges);
+  std::iota(edges.begin(), edges.end(), 0);
+  const xt::xtensor<double, 2> midpoints = mesh::midpoints(mesh, 1, edges);
+  auto _vertex
+      = xt::view(new_vertex_coordinates,
+                 xt::range(num_vertices, num_vertices + num_owned_edges),
+                 xt::all());
+  _vertex.assign(midpoints);
+  xt::xtensor<double, 2> coordinates
+      = xt::view(new_vertex_coordinates, xt::all(),
+                 xt::range(0, mesh.geometry().dim()));
+
+  // Record the parent vertices of each new vertex by global index.
+  // Vertices carried over from the input mesh keep a single parent
+  // (their own index in the input mesh, second entry -1); vertices
+  // created on a bisected edge have the two edge endpoints as parents.
+  const std::vector<std::int64_t> vertex_global = map_v->global_indices();
+  std::map<std::int64_t, std::array<std::int64_t, 2>> parent_vertices;
+  for (std::size_t v = 0; v < vertex_global.size(); ++v)
+    parent_vertices.insert({global_v[v], {vertex_global[v], -1}});
+  for (std::int32_t e = 0; e < num_edges; ++e)
+  {
+    auto v = e_to_v->links(e);
+    parent_vertices.insert(
+        {edge_vertex[e], {vertex_global[v[0]], vertex_global[v[1]]}});
+  }
+
+  // Generate the child cells from the closed-form subdivision tables
+  // in a threaded pass: every cell produces the same number of
+  // children, so each thread writes a disjoint slice of the topology
+  const std::int32_t num_cells = map_c->size_local();
+  const int num_cell_vertices = tdim + 1;
+  const int num_children = tdim == 2 ? 4 : 8;
+
+  std::vector<std::int64_t> cell_topology(std::size_t(num_cells)
+                                          * num_children * num_cell_vertices);
+  std::vector<std::int32_t> parent_cell(std::size_t(num_cells)
+                                        * num_children);
+  parallel_for_ranges(
+      num_cells,
+      [&](std::size_t begin, std::size_t end)
+      {
+        std::array<std::int64_t, 10> indices;
+        for (std::size_t c = begin; c < end; ++c)
+        {
+          // Create vector of indices in the order [vertices][edges],
+          // 3+3 in 2D, 4+6 in 3D
+          auto vertices = c_to_v->links(std::int32_t(c));
+          for (std::size_t v = 0; v < vertices.size(); ++v)
+            indices[v] = global_v[vertices[v]];
+          auto cell_edges = c_to_e->links(std::int32_t(c));
+          for (std::size_t e = 0; e < cell_edges.size(); ++e)
+            indices[num_cell_vertices + e] = edge_vertex[cell_edges[e]];
+
+          std::int64_t* cells
+              = cell_topology.data() + c * num_children * num_cell_vertices;
+          if (tdim == 2)
+          {
+            for (int i = 0; i < 4; ++i)
+              for (int j = 0; j < 3; ++j)
+                *cells++ = indices[triangle_children[i][j]];
+          }
+          else
+          {
+            for (int i = 0; i < 8; ++i)
+              for (int j = 0; j < 4; ++j)
+                *cells++ = indices[tetrahedron_children[i][j]];
+          }
+
+          std::fill_n(std::next(parent_cell.begin(), c * num_children),
+                      num_children, std::int32_t(c));
+        }
+      });
+
+  std::vector<std::int32_t> offsets(
+      std::size_t(num_cells) * num_children + 1, 0);
+  for (std::size_t i = 0; i < offsets.size() - 1; ++i)
+    offsets[i + 1] = offsets[i] + num_cell_vertices;
+  graph::AdjacencyList<std::int64_t> cell_adj(std::move(cell_topology),
+                                              std::move(offsets));
+
+  return {std::move(cell_adj), std::move(coordinates), std::move(parent_cell),
+          std::move(parent_vertices)};
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include <array>
+#include <cstdint>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <map>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+namespace dolfinx::mesh
+{
+class Mesh;
+} // namespace dolfinx::mesh
+
+namespace dolfinx::refinement
+{
+
+/// Uniform ("red") refinement of simplicial meshes. Every edge is
+/// bisected and each cell is replaced by a closed-form set of children:
+/// a triangle by four similar triangles and a tetrahedron by four
+/// corner tetrahedra plus four tetrahedra from the interior octahedron,
+/// split along a fixed diagonal. Since every edge carries a new vertex,
+/// the marked-edge propagation, case analysis and distributed marker
+/// synchronization of the Plaza algorithm are not needed: new vertices
+/// are enumerated directly from the edge IndexMap and the child cells
+/// are generated in a threaded pass over the cells.
+namespace uniform
+{
+
+/// Uniformly refine, optionally redistributing
+///
+/// @param[in] mesh Input mesh to be refined
+/// @param[in] redistribute Flag to call the mesh partitioner to
+/// redistribute after refinement
+/// @return New mesh
+mesh::Mesh refine(const mesh::Mesh& mesh, bool redistribute);
+
+/// Uniformly refine, redistributing only when the refined cell
+/// distribution is imbalanced beyond the given threshold (see
+/// refinement::compute_imbalance). Uniform refinement preserves the
+/// balance of the input mesh, so the partitioner is normally skipped.
+///
+/// @param[in] mesh Input mesh to be refined
+/// @param[in] rebalance_threshold Imbalance ratio above which the
+/// refined mesh is redistributed
+/// @return New mesh
+mesh::Mesh refine(const mesh::Mesh& mesh, double rebalance_threshold);
+
+/// Uniformly refine, additionally returning the parent vertices of
+/// each vertex of the refined mesh. The map is keyed by the global
+/// vertex index in the refined mesh; the value holds the global
+/// indices (in the input mesh) of the two endpoints of the bisected
+/// edge on which the vertex was created, or the vertex's own input
+/// index and -1 for vertices carried over from the input mesh. The
+/// refined cells stay on their current rank (no redistribution), so
+/// the parents of every owned vertex are present locally on the input
+/// mesh. The parent data is sufficient to build coarse-to-fine
+/// transfer operators, see refinement::create_interpolation_matrix.
+///
+/// @param[in] mesh Input mesh to be refined
+/// @return New mesh and the vertex parent map
+std::pair<mesh::Mesh, std::map<std::int64_t, std::array<std::int64_t, 2>>>
+refine_with_parent_data(const mesh::Mesh& mesh);
+
+/// Uniformly refine mesh returning new mesh data
+///
+/// @param[in] mesh Input mesh to be refined
+/// @return New mesh data: cell topology, vertex coordinates, parent
+/// cell index and vertex parent map (global vertex index in the new
+/// mesh -> global indices of its parent vertices in the input mesh,
+/// second entry -1 for vertices carried over from the input mesh)
+std::tuple<graph::AdjacencyList<std::int64_t>, xt::xtensor<double, 2>,
+           std::vector<std::int32_t>,
+           std::map<std::int64_t, std::array<std::int64_t, 2>>>
+compute_refinement_data(const mesh::Mesh& mesh);
+
+} // namespace uniform
+} // namespace dolfinx::refinement
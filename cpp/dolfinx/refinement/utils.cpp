@@ -5,7 +5,11 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "utils.h"
+#include <algorithm>
+#include <cstdint>
 #include <dolfinx/common/MPI.h>
+#include <dolfinx/common/log.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/fem/ElementDofLayout.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
@@ -17,6 +21,8 @@
 #include <map>
 #include <memory>
 #include <mpi.h>
+#include <numeric>
+#include <thread>
 #include <vector>
 #include <xtensor/xadapt.hpp>
 #include <xtensor/xtensor.hpp>
@@ -27,6 +33,33 @@ using namespace xt::placeholders;
 
 namespace
 {
+//-----------------------------------------------------------------------------
+
+/// Execute f(begin, end) over the index range [0, n), splitting the
+/// range across common::num_threads() threads. Writes from different
+/// sub-ranges must not overlap.
+template <typename Fn>
+void parallel_for_ranges(std::size_t n, Fn&& f)
+{
+  const int num_threads = dolfinx::common::num_threads();
+  if (num_threads <= 1)
+  {
+    f(std::size_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    const std::size_t begin = (n * t) / num_threads;
+    const std::size_t end = (n * (t + 1)) / num_threads;
+    if (begin != end)
+      threads.emplace_back(f, begin, end);
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+}
+//-----------------------------------------------------------------------------
 std::int64_t local_to_global(std::int32_t local_index,
                              const common::IndexMap& map)
 {
@@ -67,18 +100,27 @@ xt::xtensor<double, 2> create_new_geometry(
                                         + map_v->num_ghosts());
   auto map_c = mesh.topology().index_map(tdim);
   assert(map_c);
-  for (int c = 0; c < map_c->size_local() + map_c->num_ghosts(); ++c)
-  {
-    auto vertices = c_to_v->links(c);
-    auto dofs = x_dofmap.links(c);
-    for (std::size_t i = 0; i < vertices.size(); ++i)
-    {
-      // FIXME: We are making an assumption here on the
-      // ElementDofLayout. We should use an ElementDofLayout to map
-      // between local vertex index and x dof index.
-      vertex_to_x[vertices[i]] = dofs[i];
-    }
-  }
+
+  // Cells sharing a vertex store the same geometry dof for it, so
+  // overlapping writes from different threads are benign
+  parallel_for_ranges(map_c->size_local() + map_c->num_ghosts(),
+                      [&c_to_v, &x_dofmap,
+                       &vertex_to_x](std::size_t begin, std::size_t end)
+                      {
+                        for (std::size_t c = begin; c < end; ++c)
+                        {
+                          auto vertices = c_to_v->links(std::int32_t(c));
+                          auto dofs = x_dofmap.links(std::int32_t(c));
+                          for (std::size_t i = 0; i < vertices.size(); ++i)
+                          {
+                            // FIXME: We are making an assumption here on the
+                            // ElementDofLayout. We should use an
+                            // ElementDofLayout to map between local vertex
+                            // index and x dof index.
+                            vertex_to_x[vertices[i]] = dofs[i];
+                          }
+                        }
+                      });
 
   // Copy over existing mesh vertices
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
@@ -88,9 +130,15 @@ xt::xtensor<double, 2> create_new_geometry(
   xt::xtensor<double, 2> new_vertex_coordinates(
       {num_vertices + num_new_vertices, 3});
 
-  for (std::size_t v = 0; v < num_vertices; ++v)
-    for (std::size_t j = 0; j < x_g.shape(1); ++j)
-      new_vertex_coordinates(v, j) = x_g(vertex_to_x[v], j);
+  parallel_for_ranges(
+      num_vertices,
+      [&x_g, &vertex_to_x, &new_vertex_coordinates](std::size_t begin,
+                                                    std::size_t end)
+      {
+        for (std::size_t v = begin; v < end; ++v)
+          for (std::size_t j = 0; j < x_g.shape(1); ++j)
+            new_vertex_coordinates(v, j) = x_g(vertex_to_x[v], j);
+      });
 
   std::vector<int> edges(num_new_vertices);
   int i = 0;
@@ -159,37 +207,96 @@ refinement::compute_edge_sharing(const mesh::Mesh& mesh)
   return {neighbor_comm, std::move(shared_edges)};
 }
 //-----------------------------------------------------------------------------
+std::vector<std::vector<std::int32_t>> refinement::compute_shared_edge_lists(
+    const std::map<std::int32_t, std::vector<int>>& shared_edges,
+    int num_neighbors, const common::IndexMap& map_e)
+{
+  std::vector<std::vector<std::int32_t>> edge_lists(num_neighbors);
+  for (const auto& q : shared_edges)
+  {
+    for (int p : q.second)
+    {
+      assert(p < num_neighbors);
+      edge_lists[p].push_back(q.first);
+    }
+  }
+
+  // Sort each list by global edge index. The sharing peer holds the
+  // same global indices, so the resulting order (and hence the bit
+  // positions in the marker exchanges) is agreed without
+  // communication.
+  for (std::vector<std::int32_t>& edges : edge_lists)
+  {
+    std::sort(edges.begin(), edges.end(),
+              [&map_e](std::int32_t e0, std::int32_t e1) {
+                return local_to_global(e0, map_e)
+                       < local_to_global(e1, map_e);
+              });
+  }
+
+  return edge_lists;
+}
+//-----------------------------------------------------------------------------
 void refinement::update_logical_edgefunction(
     const MPI_Comm& neighbor_comm,
+    const std::vector<std::vector<std::int32_t>>& edge_lists,
     const std::vector<std::vector<std::int32_t>>& marked_for_update,
     std::vector<bool>& marked_edges, const common::IndexMap& map_e)
 {
-  std::vector<std::int32_t> send_offsets = {0};
-  std::vector<std::int64_t> data_to_send;
-  int num_neighbors = marked_for_update.size();
+  const int num_neighbors = edge_lists.size();
+  assert(marked_for_update.size() == edge_lists.size());
+
+  // The shared edge sets are symmetric, so the bitmap sizes are known
+  // on both sides and no size exchange is needed
+  std::vector<int> counts(num_neighbors), disp(num_neighbors + 1, 0);
   for (int i = 0; i < num_neighbors; ++i)
   {
-    for (std::int32_t q : marked_for_update[i])
-      data_to_send.push_back(local_to_global(q, map_e));
+    counts[i] = int((edge_lists[i].size() + 7) / 8);
+    disp[i + 1] = disp[i] + counts[i];
+  }
 
-    send_offsets.push_back(data_to_send.size());
+  // Pack the edges newly marked for each neighbor, one bit per shared
+  // edge at the position of the edge in the agreed order
+  std::vector<std::uint8_t> send_buffer(disp.back(), 0);
+  for (int i = 0; i < num_neighbors; ++i)
+  {
+    const std::vector<std::int32_t>& edges = edge_lists[i];
+    for (std::int32_t q : marked_for_update[i])
+    {
+      const std::int64_t global = local_to_global(q, map_e);
+      auto it = std::lower_bound(edges.begin(), edges.end(), global,
+                                 [&map_e](std::int32_t e, std::int64_t value) {
+                                   return local_to_global(e, map_e) < value;
+                                 });
+      assert(it != edges.end() and *it == q);
+      const std::size_t pos = std::distance(edges.begin(), it);
+      send_buffer[disp[i] + pos / 8] |= (1 << (pos % 8));
+    }
   }
 
-  // Send all shared edges marked for update and receive from other
-  // processes
-  const std::vector<std::int64_t> data_to_recv
-      = MPI::neighbor_all_to_all(
-            neighbor_comm,
-            graph::AdjacencyList<std::int64_t>(data_to_send, send_offsets))
-            .array();
-
-  // Flatten received values and set marked_edges at each index received
-  std::vector<std::int32_t> local_indices(data_to_recv.size());
-  map_e.global_to_local(data_to_recv, local_indices);
-  for (std::int32_t local_index : local_indices)
+  std::vector<std::uint8_t> recv_buffer(disp.back(), 0);
+  MPI_Neighbor_alltoallv(send_buffer.data(), counts.data(), disp.data(),
+                         MPI_UINT8_T, recv_buffer.data(), counts.data(),
+                         disp.data(), MPI_UINT8_T, neighbor_comm);
+
+  // Set the marker of each edge whose bit is set, skipping empty bytes
+  for (int i = 0; i < num_neighbors; ++i)
   {
-    assert(local_index != -1);
-    marked_edges[local_index] = true;
+    const std::vector<std::int32_t>& edges = edge_lists[i];
+    for (int b = 0; b < counts[i]; ++b)
+    {
+      const std::uint8_t byte = recv_buffer[disp[i] + b];
+      if (byte == 0)
+        continue;
+      for (int bit = 0; bit < 8; ++bit)
+      {
+        if (byte & (1 << bit))
+        {
+          assert(std::size_t(8 * b + bit) < edges.size());
+          marked_edges[edges[8 * b + bit]] = true;
+        }
+      }
+    }
   }
 }
 //-----------------------------------------------------------------------------
@@ -202,81 +309,122 @@ refinement::create_new_vertices(
   // Take marked_edges and use to create new vertices
   const std::shared_ptr<const common::IndexMap> edge_index_map
       = mesh.topology().index_map(1);
+  const std::int32_t num_owned_edges = edge_index_map->size_local();
+
+  // Number the new vertices with an exclusive scan over the owned
+  // marked edges
+  std::vector<std::int64_t> edge_to_vertex(num_owned_edges + 1, 0);
+  std::transform(marked_edges.begin(), marked_edges.begin() + num_owned_edges,
+                 std::next(edge_to_vertex.begin()),
+                 [](bool marked) { return marked ? 1 : 0; });
+  std::partial_sum(edge_to_vertex.begin(), edge_to_vertex.end(),
+                   edge_to_vertex.begin());
+
+  const std::int64_t num_local = edge_to_vertex.back();
+  std::int64_t global_offset = 0;
+  MPI_Exscan(&num_local, &global_offset, 1,
+             dolfinx::MPI::mpi_type<std::int64_t>(), MPI_SUM, mesh.mpi_comm());
+  global_offset += mesh.topology().index_map(0)->local_range()[1];
 
-  // Add new edge midpoints to list of vertices
-  int n = 0;
   std::map<std::int32_t, std::int64_t> local_edge_to_new_vertex;
-  for (int local_i = 0; local_i < edge_index_map->size_local(); ++local_i)
+  for (std::int32_t e = 0; e < num_owned_edges; ++e)
   {
-    if (marked_edges[local_i] == true)
+    if (marked_edges[e])
     {
-      [[maybe_unused]] auto it = local_edge_to_new_vertex.insert({local_i, n});
-      assert(it.second);
-      ++n;
+      local_edge_to_new_vertex.emplace_hint(local_edge_to_new_vertex.end(), e,
+                                            global_offset + edge_to_vertex[e]);
     }
   }
 
-  const std::int64_t num_local = n;
-  std::int64_t global_offset = 0;
-  MPI_Exscan(&num_local, &global_offset, 1,
-             dolfinx::MPI::mpi_type<std::int64_t>(), MPI_SUM, mesh.mpi_comm());
-  global_offset += mesh.topology().index_map(0)->local_range()[1];
-  std::for_each(local_edge_to_new_vertex.begin(),
-                local_edge_to_new_vertex.end(),
-                [global_offset](auto& e) { e.second += global_offset; });
-
   // Create actual points
   xt::xtensor<double, 2> new_vertex_coordinates
       = create_new_geometry(mesh, local_edge_to_new_vertex);
 
-  // If they are shared, then the new global vertex index needs to be
-  // sent off-process.
+  // New vertices on shared edges are numbered by the owning rank and
+  // the indices sent to the sharing neighbors. The edge markers have
+  // already been synchronised, so both sides know which shared edges
+  // carry a new vertex; ordering them by global edge index fixes the
+  // transfer order, and the buffer sizes, without communication, and a
+  // single neighbor collective carrying only the new vertex indices
+  // suffices.
 
-  // Get number of neighbors
+  // Get neighbor ranks
   int indegree(-1), outdegree(-2), weighted(-1);
   MPI_Dist_graph_neighbors_count(neighbor_comm, &indegree, &outdegree,
                                  &weighted);
   assert(indegree == outdegree);
   const int num_neighbors = indegree;
-
-  std::vector<std::vector<std::int64_t>> values_to_send(num_neighbors);
-  for (auto& local_edge : local_edge_to_new_vertex)
+  std::vector<int> neighbors(num_neighbors), neighbors1(num_neighbors);
+  MPI_Dist_graph_neighbors(neighbor_comm, num_neighbors, neighbors.data(),
+                           MPI_UNWEIGHTED, num_neighbors, neighbors1.data(),
+                           MPI_UNWEIGHTED);
+  std::map<int, int> rank_to_neighbor;
+  for (int i = 0; i < num_neighbors; ++i)
+    rank_to_neighbor.insert({neighbors[i], i});
+
+  // Collect the marked shared edges: owned edges are sent to all
+  // sharing neighbors, ghost edges are received from their owner
+  const std::vector<int>& ghost_owners = edge_index_map->ghost_owner_rank();
+  std::vector<std::vector<std::int32_t>> send_edges(num_neighbors);
+  std::vector<std::vector<std::int32_t>> recv_edges(num_neighbors);
+  for (const auto& q : shared_edges)
   {
-    const std::size_t local_i = local_edge.first;
-    // shared, but locally owned : remote owned are not in list.
+    const std::int32_t e = q.first;
+    if (!marked_edges[e])
+      continue;
 
-    if (auto shared_edge_i = shared_edges.find(local_i);
-        shared_edge_i != shared_edges.end())
+    if (e < num_owned_edges)
     {
-      for (int remote_process : shared_edge_i->second)
-      {
-        // send map from global edge index to new global vertex index
-        values_to_send[remote_process].push_back(
-            local_to_global(local_edge.first, *edge_index_map));
-        values_to_send[remote_process].push_back(local_edge.second);
-      }
+      for (int p : q.second)
+        send_edges[p].push_back(e);
     }
+    else
+    {
+      auto it = rank_to_neighbor.find(ghost_owners[e - num_owned_edges]);
+      assert(it != rank_to_neighbor.end());
+      recv_edges[it->second].push_back(e);
+    }
+  }
+
+  // Owned edges are already in global order; sort the ghost edges to
+  // match the order used by the owner
+  for (std::vector<std::int32_t>& edges : recv_edges)
+  {
+    std::sort(edges.begin(), edges.end(),
+              [&edge_index_map](std::int32_t e0, std::int32_t e1) {
+                return local_to_global(e0, *edge_index_map)
+                       < local_to_global(e1, *edge_index_map);
+              });
+  }
+
+  std::vector<int> send_counts(num_neighbors), send_disp(num_neighbors + 1, 0);
+  std::vector<int> recv_counts(num_neighbors), recv_disp(num_neighbors + 1, 0);
+  std::vector<std::int64_t> send_values;
+  for (int i = 0; i < num_neighbors; ++i)
+  {
+    for (std::int32_t e : send_edges[i])
+      send_values.push_back(global_offset + edge_to_vertex[e]);
+    send_counts[i] = send_edges[i].size();
+    send_disp[i + 1] = send_disp[i] + send_counts[i];
+    recv_counts[i] = recv_edges[i].size();
+    recv_disp[i + 1] = recv_disp[i] + recv_counts[i];
   }
 
-  const std::vector<std::int64_t> received_values
-      = MPI::neighbor_all_to_all(
-            neighbor_comm, graph::AdjacencyList<std::int64_t>(values_to_send))
-            .array();
+  std::vector<std::int64_t> recv_values(recv_disp.back());
+  MPI_Neighbor_alltoallv(send_values.data(), send_counts.data(),
+                         send_disp.data(), MPI_INT64_T, recv_values.data(),
+                         recv_counts.data(), recv_disp.data(), MPI_INT64_T,
+                         neighbor_comm);
 
   // Add received remote global vertex indices to map
-  std::vector<std::int64_t> recv_global_edge;
-  assert(received_values.size() % 2 == 0);
-  for (std::size_t i = 0; i < received_values.size() / 2; ++i)
-    recv_global_edge.push_back(received_values[i * 2]);
-  std::vector<std::int32_t> recv_local_edge(recv_global_edge.size());
-  mesh.topology().index_map(1)->global_to_local(recv_global_edge,
-                                                recv_local_edge);
-  for (std::size_t i = 0; i < received_values.size() / 2; ++i)
+  for (int i = 0; i < num_neighbors; ++i)
   {
-    assert(recv_local_edge[i] != -1);
-    [[maybe_unused]] auto it = local_edge_to_new_vertex.insert(
-        {recv_local_edge[i], received_values[i * 2 + 1]});
-    assert(it.second);
+    for (int j = 0; j < recv_counts[i]; ++j)
+    {
+      [[maybe_unused]] auto it = local_edge_to_new_vertex.insert(
+          {recv_edges[i][j], recv_values[recv_disp[i] + j]});
+      assert(it.second);
+    }
   }
 
   return {std::move(local_edge_to_new_vertex),
@@ -358,6 +506,40 @@ refinement::partition(const mesh::Mesh& old_mesh,
                            gm, partitioner);
 }
 //-----------------------------------------------------------------------------
+double refinement::compute_imbalance(MPI_Comm comm,
+                                     std::int32_t num_local_cells)
+{
+  const std::int64_t num_local = num_local_cells;
+  std::int64_t num_global = 0, num_max = 0;
+  MPI_Allreduce(&num_local, &num_global, 1,
+                dolfinx::MPI::mpi_type<std::int64_t>(), MPI_SUM, comm);
+  MPI_Allreduce(&num_local, &num_max, 1,
+                dolfinx::MPI::mpi_type<std::int64_t>(), MPI_MAX, comm);
+  if (num_global == 0)
+    return 1.0;
+
+  const double mean
+      = static_cast<double>(num_global) / dolfinx::MPI::size(comm);
+  return static_cast<double>(num_max) / mean;
+}
+//-----------------------------------------------------------------------------
+mesh::Mesh
+refinement::partition(const mesh::Mesh& old_mesh,
+                      const graph::AdjacencyList<std::int64_t>& cell_topology,
+                      const xt::xtensor<double, 2>& new_vertex_coordinates,
+                      double rebalance_threshold, mesh::GhostMode gm)
+{
+  const double imbalance
+      = compute_imbalance(old_mesh.mpi_comm(), cell_topology.num_nodes());
+  const bool redistribute = imbalance > rebalance_threshold;
+  LOG(INFO) << "Refined cell imbalance ratio " << imbalance << " (threshold "
+            << rebalance_threshold << "): "
+            << (redistribute ? "redistributing" : "keeping distribution");
+
+  return partition(old_mesh, cell_topology, new_vertex_coordinates,
+                   redistribute, gm);
+}
+//-----------------------------------------------------------------------------
 std::vector<std::int64_t>
 refinement::adjust_indices(const common::IndexMap& index_map, std::int32_t n)
 {
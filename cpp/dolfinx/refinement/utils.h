@@ -36,14 +36,36 @@ namespace dolfinx::refinement
 std::pair<MPI_Comm, std::map<std::int32_t, std::vector<int>>>
 compute_edge_sharing(const mesh::Mesh& mesh);
 
-/// Transfer marked edges between processes.
+/// Build, for each neighbor in the edge-sharing communicator, the list
+/// of local edges shared with that neighbor, ordered by global edge
+/// index. Both sharing ranks hold the same set of global indices, so
+/// the order is agreed between the peers without communication; it
+/// defines the bit positions used by the packed marker exchanges of
+/// update_logical_edgefunction.
+/// @param[in] shared_edges Map from local edge index to sharing
+/// neighbors, as computed by compute_edge_sharing
+/// @param[in] num_neighbors Number of neighbors in the communicator
+/// @param[in] map_e IndexMap for edges
+/// @return Lists of local edge indices shared with each neighbor
+std::vector<std::vector<std::int32_t>> compute_shared_edge_lists(
+    const std::map<std::int32_t, std::vector<int>>& shared_edges,
+    int num_neighbors, const common::IndexMap& map_e);
+
+/// Transfer marked edges between processes. The newly marked edges are
+/// packed into one bit per shared edge, at the position of the edge in
+/// the agreed per-neighbor shared edge list (see
+/// compute_shared_edge_lists), so the buffer sizes are known on both
+/// sides and a single neighbor collective suffices.
 /// @param neighbor_comm MPI Communicator for neighborhood
+/// @param edge_lists Shared edges for each neighbor, as computed by
+/// compute_shared_edge_lists
 /// @param marked_for_update Lists of edges to be updates on each
 /// neighbor
 /// @param marked_edges Marked edges to be updated
 /// @param map_e IndexMap for edges
 void update_logical_edgefunction(
     const MPI_Comm& neighbor_comm,
+    const std::vector<std::vector<std::int32_t>>& edge_lists,
     const std::vector<std::vector<std::int32_t>>& marked_for_update,
     std::vector<bool>& marked_edges, const common::IndexMap& map_e);
 
@@ -74,6 +96,34 @@ mesh::Mesh partition(const mesh::Mesh& old_mesh,
                      const xt::xtensor<double, 2>& new_vertex_coordinates,
                      bool redistribute, mesh::GhostMode ghost_mode);
 
+/// Compute the cell imbalance ratio of a distribution across
+/// processes, i.e. the maximum over ranks of the local cell count
+/// divided by the mean count. The ratio is 1.0 for a perfectly
+/// balanced distribution.
+/// @param[in] comm MPI Communicator
+/// @param[in] num_local_cells Number of cells on this rank
+/// @return Imbalance ratio (>= 1.0)
+double compute_imbalance(MPI_Comm comm, std::int32_t num_local_cells);
+
+/// Use vertex and topology data to build the refined mesh, calling the
+/// graph partitioner only when the refined cell distribution is
+/// imbalanced beyond the given threshold. Below the threshold cells
+/// stay on their current rank (with ghost destinations recomputed), so
+/// the existing distribution is reused and the partitioning step is
+/// skipped entirely, e.g. for uniform refinement, which preserves the
+/// balance of the input mesh exactly.
+/// @param[in] old_mesh
+/// @param[in] cell_topology Topology of cells, (vertex indices)
+/// @param[in] new_vertex_coordinates
+/// @param[in] rebalance_threshold Imbalance ratio (see
+/// compute_imbalance) above which the mesh is redistributed
+/// @param[in] ghost_mode None or shared_facet
+/// @return New mesh
+mesh::Mesh partition(const mesh::Mesh& old_mesh,
+                     const graph::AdjacencyList<std::int64_t>& cell_topology,
+                     const xt::xtensor<double, 2>& new_vertex_coordinates,
+                     double rebalance_threshold, mesh::GhostMode ghost_mode);
+
 /// Adjust indices to account for extra n values on each process This
 /// is a utility to help add new topological vertices on each process
 /// into the space of the index map.
@@ -0,0 +1,68 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Minimal Google-Benchmark-style harness for the DOLFINx
+// microbenchmarks. Benchmarks register themselves with
+// DOLFINX_BENCHMARK and are timed over a number of repetitions with a
+// barrier before each start, so the slowest rank defines each sample.
+// Results are printed as a table and can be written as JSON for CI
+// trend tracking (--json=<file>).
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace bench
+{
+
+/// Timing and throughput record of one benchmark
+struct Result
+{
+  /// Benchmark name
+  std::string name;
+
+  /// Number of timed repetitions
+  int reps = 0;
+
+  /// Fastest and mean wall time of a repetition [s]
+  double wall_min = 0.0, wall_mean = 0.0;
+
+  /// Bytes processed per repetition, summed over ranks (0 if not
+  /// meaningful). Reported as a bandwidth.
+  double bytes = 0.0;
+
+  /// Items (cells, points, ...) processed per repetition, summed over
+  /// ranks (0 if not meaningful). Reported as a rate.
+  double items = 0.0;
+};
+
+/// Register a benchmark under a name. Use via DOLFINX_BENCHMARK.
+/// @param[in] name The benchmark name
+/// @param[in] fn The benchmark. It performs its own setup and calls
+/// bench::time for the timed section, and may set the bytes/items
+/// fields of the Result.
+/// @return true (value for static registration)
+bool add(const std::string& name, std::function<void(Result&)> fn);
+
+/// Time a function over a number of repetitions, with one untimed
+/// warm-up repetition and a barrier before each start. Fills the
+/// reps/wall_min/wall_mean fields of the result.
+/// @param[in,out] r The result to fill
+/// @param[in] reps Number of timed repetitions
+/// @param[in] fn The function to time
+void time(Result& r, int reps, const std::function<void()>& fn);
+
+/// Run the registered benchmarks (optionally filtered by a substring
+/// given as a plain argument) and report. Collective on MPI_COMM_WORLD.
+/// @return Exit code for main
+int run(int argc, char* argv[]);
+
+} // namespace bench
+
+/// Register a benchmark function under a name
+#define DOLFINX_BENCHMARK(name, fn)                                            \
+  static const bool _bench_registered_##fn = bench::add(name, fn)
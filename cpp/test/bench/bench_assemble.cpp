@@ -0,0 +1,200 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Matrix and vector assembly microbenchmarks. The C++ tree carries no
+// generated (FFCx) kernels, so the benchmarks use a hand-coded P1
+// Laplacian on tetrahedra and a surrogate element matrix on hexahedra,
+// with the cell-vertex connectivity as the P1 dofmap. They exercise
+// the kernel + insertion + finalisation path of la::MatrixCSR and
+// la::Vector, which is where assembly regressions have shown up.
+
+#include "bench.h"
+#include <cmath>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/generation/BoxMesh.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <mpi.h>
+#include <xtensor/xtensor.hpp>
+
+using namespace dolfinx;
+
+namespace
+{
+
+mesh::Mesh make_box(mesh::CellType celltype, std::size_t n)
+{
+  return generation::BoxMesh::create(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {n, n, n},
+      celltype, mesh::GhostMode::none);
+}
+
+// Build the sparsity pattern of a P1 discretisation: the dofmap is the
+// cell-vertex connectivity with the vertex index map
+la::SparsityPattern p1_pattern(const mesh::Mesh& mesh)
+{
+  const int tdim = mesh.topology().dim();
+  auto map0 = mesh.topology().index_map(0);
+  auto c_to_v = mesh.topology().connectivity(tdim, 0);
+  la::SparsityPattern pattern(mesh.mpi_comm(), {map0, map0}, {1, 1});
+  const std::int32_t num_cells = mesh.topology().index_map(tdim)->size_local();
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    const auto dofs = c_to_v->links(c);
+    pattern.insert(dofs, dofs);
+  }
+  pattern.assemble();
+  return pattern;
+}
+
+// Element stiffness matrix of the P1 Laplacian on a tetrahedron with
+// vertex coordinates x(xd[i], :)
+void p1_tet_kernel(const xt::xtensor<double, 2>& x,
+                   const xtl::span<const std::int32_t>& xd, double Ke[4][4])
+{
+  double a[3], b[3], c[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    a[i] = x(xd[1], i) - x(xd[0], i);
+    b[i] = x(xd[2], i) - x(xd[0], i);
+    c[i] = x(xd[3], i) - x(xd[0], i);
+  }
+
+  // Rows of det(J) J^{-1} are the cross products of the Jacobian
+  // columns; the basis gradients are the rows of J^{-1} (and their
+  // negative sum)
+  double g[4][3]
+      = {{0.0, 0.0, 0.0},
+         {b[1] * c[2] - b[2] * c[1], b[2] * c[0] - b[0] * c[2],
+          b[0] * c[1] - b[1] * c[0]},
+         {c[1] * a[2] - c[2] * a[1], c[2] * a[0] - c[0] * a[2],
+          c[0] * a[1] - c[1] * a[0]},
+         {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+          a[0] * b[1] - a[1] * b[0]}};
+  const double detJ = a[0] * g[1][0] + a[1] * g[1][1] + a[2] * g[1][2];
+  for (int i = 0; i < 3; ++i)
+    g[0][i] = -(g[1][i] + g[2][i] + g[3][i]);
+
+  // Ke = vol grad_i . grad_j with vol = |detJ|/6 and the scaled
+  // gradients above carrying a factor detJ each
+  const double w = 1.0 / (6.0 * std::abs(detJ));
+  for (int i = 0; i < 4; ++i)
+  {
+    for (int j = 0; j < 4; ++j)
+    {
+      Ke[i][j]
+          = w * (g[i][0] * g[j][0] + g[i][1] * g[j][1] + g[i][2] * g[j][2]);
+    }
+  }
+}
+
+void assemble_matrix_p1_tet(bench::Result& r)
+{
+  const mesh::Mesh mesh = make_box(mesh::CellType::tetrahedron, 16);
+  const int tdim = mesh.topology().dim();
+  auto c_to_v = mesh.topology().connectivity(tdim, 0);
+  const la::SparsityPattern pattern = p1_pattern(mesh);
+  la::MatrixCSR<double> A(pattern);
+  const auto mat_add = A.mat_add_values();
+
+  const xt::xtensor<double, 2>& x = mesh.geometry().x();
+  const graph::AdjacencyList<std::int32_t>& xdofs = mesh.geometry().dofmap();
+  const std::int32_t num_cells = mesh.topology().index_map(tdim)->size_local();
+  r.items = mesh.topology().index_map(tdim)->size_global();
+
+  bench::time(r, 5,
+              [&]()
+              {
+                A.set(0.0);
+                double Ke[4][4];
+                for (std::int32_t c = 0; c < num_cells; ++c)
+                {
+                  p1_tet_kernel(x, xdofs.links(c), Ke);
+                  const auto dofs = c_to_v->links(c);
+                  mat_add(4, dofs.data(), 4, dofs.data(), &Ke[0][0]);
+                }
+                A.finalize();
+              });
+}
+DOLFINX_BENCHMARK("assemble_matrix P1 tet", assemble_matrix_p1_tet);
+
+void assemble_matrix_p1_hex(bench::Result& r)
+{
+  const mesh::Mesh mesh = make_box(mesh::CellType::hexahedron, 24);
+  const int tdim = mesh.topology().dim();
+  auto c_to_v = mesh.topology().connectivity(tdim, 0);
+  const la::SparsityPattern pattern = p1_pattern(mesh);
+  la::MatrixCSR<double> A(pattern);
+  const auto mat_add = A.mat_add_values();
+
+  // Surrogate element matrix: the benchmark targets the insertion and
+  // finalisation machinery, not the quadrature
+  double Ke[8][8];
+  for (int i = 0; i < 8; ++i)
+    for (int j = 0; j < 8; ++j)
+      Ke[i][j] = i == j ? 8.0 : -1.0;
+
+  const std::int32_t num_cells = mesh.topology().index_map(tdim)->size_local();
+  r.items = mesh.topology().index_map(tdim)->size_global();
+
+  bench::time(r, 5,
+              [&]()
+              {
+                A.set(0.0);
+                for (std::int32_t c = 0; c < num_cells; ++c)
+                {
+                  const auto dofs = c_to_v->links(c);
+                  mat_add(8, dofs.data(), 8, dofs.data(), &Ke[0][0]);
+                }
+                A.finalize();
+              });
+}
+DOLFINX_BENCHMARK("assemble_matrix P1 hex", assemble_matrix_p1_hex);
+
+void assemble_vector_p1_tet(bench::Result& r)
+{
+  const mesh::Mesh mesh = make_box(mesh::CellType::tetrahedron, 16);
+  const int tdim = mesh.topology().dim();
+  auto c_to_v = mesh.topology().connectivity(tdim, 0);
+  la::Vector<double> b(mesh.topology().index_map(0), 1);
+
+  const xt::xtensor<double, 2>& x = mesh.geometry().x();
+  const graph::AdjacencyList<std::int32_t>& xdofs = mesh.geometry().dofmap();
+  const std::int32_t num_cells = mesh.topology().index_map(tdim)->size_local();
+  r.items = mesh.topology().index_map(tdim)->size_global();
+
+  bench::time(r, 5,
+              [&]()
+              {
+                b.set(0.0);
+                const xtl::span<double> barr = b.mutable_array();
+                for (std::int32_t c = 0; c < num_cells; ++c)
+                {
+                  // Load vector of f = 1: |detJ|/24 on each vertex
+                  const auto xd = xdofs.links(c);
+                  double a[3], bb[3], cc[3];
+                  for (int i = 0; i < 3; ++i)
+                  {
+                    a[i] = x(xd[1], i) - x(xd[0], i);
+                    bb[i] = x(xd[2], i) - x(xd[0], i);
+                    cc[i] = x(xd[3], i) - x(xd[0], i);
+                  }
+                  const double detJ = a[0] * (bb[1] * cc[2] - bb[2] * cc[1])
+                                      + a[1] * (bb[2] * cc[0] - bb[0] * cc[2])
+                                      + a[2] * (bb[0] * cc[1] - bb[1] * cc[0]);
+                  const double be = std::abs(detJ) / 24.0;
+                  for (std::int32_t dof : c_to_v->links(c))
+                    barr[dof] += be;
+                }
+                b.scatter_rev(common::IndexMap::Mode::add);
+              });
+}
+DOLFINX_BENCHMARK("assemble_vector P1 tet", assemble_vector_p1_tet);
+
+} // namespace
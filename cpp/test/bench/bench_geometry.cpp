@@ -0,0 +1,60 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// BoundingBoxTree build and point-collision query throughput.
+
+#include "bench.h"
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/generation/BoxMesh.h>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/utils.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <mpi.h>
+#include <random>
+#include <xtensor/xtensor.hpp>
+
+using namespace dolfinx;
+
+namespace
+{
+
+void bb_tree_build(bench::Result& r)
+{
+  const mesh::Mesh mesh = generation::BoxMesh::create(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {16, 16, 16},
+      mesh::CellType::tetrahedron, mesh::GhostMode::none);
+  const int tdim = mesh.topology().dim();
+  r.items = mesh.topology().index_map(tdim)->size_global();
+
+  bench::time(r, 5,
+              [&]() { geometry::BoundingBoxTree tree(mesh, tdim, 0.0); });
+}
+DOLFINX_BENCHMARK("BoundingBoxTree build", bb_tree_build);
+
+void bb_tree_collisions(bench::Result& r)
+{
+  const mesh::Mesh mesh = generation::BoxMesh::create(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {16, 16, 16},
+      mesh::CellType::tetrahedron, mesh::GhostMode::none);
+  const int tdim = mesh.topology().dim();
+  const geometry::BoundingBoxTree tree(mesh, tdim, 0.0);
+
+  // Random query points in the box, fixed seed for reproducible trees
+  constexpr std::size_t num_points = 65536;
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  xt::xtensor<double, 2> points
+      = xt::zeros<double>({num_points, std::size_t(3)});
+  for (std::size_t p = 0; p < num_points; ++p)
+    for (std::size_t i = 0; i < 3; ++i)
+      points(p, i) = dist(rng);
+
+  r.items = double(num_points) * dolfinx::MPI::size(MPI_COMM_WORLD);
+  bench::time(r, 5, [&]() { geometry::compute_collisions(tree, points); });
+}
+DOLFINX_BENCHMARK("BoundingBoxTree collisions", bb_tree_collisions);
+
+} // namespace
@@ -0,0 +1,44 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// XDMF/HDF5 mesh write bandwidth.
+
+#include "bench.h"
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/generation/BoxMesh.h>
+#include <dolfinx/io/XDMFFile.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <mpi.h>
+
+using namespace dolfinx;
+
+namespace
+{
+
+void xdmf_write_mesh(bench::Result& r)
+{
+  const mesh::Mesh mesh = generation::BoxMesh::create(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {32, 32, 32},
+      mesh::CellType::tetrahedron, mesh::GhostMode::none);
+  const int tdim = mesh.topology().dim();
+  const std::int64_t num_cells = mesh.topology().index_map(tdim)->size_global();
+  const std::int64_t num_vertices = mesh.topology().index_map(0)->size_global();
+
+  // Payload written per repetition: vertex coordinates and cell
+  // connectivity
+  r.bytes = 3.0 * 8 * num_vertices + 4.0 * 8 * num_cells;
+  r.items = num_cells;
+
+  bench::time(r, 3,
+              [&]()
+              {
+                io::XDMFFile file(mesh.mpi_comm(), "bench_mesh.xdmf", "w");
+                file.write_mesh(mesh);
+              });
+}
+DOLFINX_BENCHMARK("XDMF write mesh", xdmf_write_mesh);
+
+} // namespace
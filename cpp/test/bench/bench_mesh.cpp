@@ -0,0 +1,97 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Topology and sparsity microbenchmarks: entity computation
+// (compute_entities via Topology::create_entities) and
+// SparsityPattern insertion + assembly on BoxMesh meshes.
+
+#include "bench.h"
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/generation/BoxMesh.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <mpi.h>
+
+using namespace dolfinx;
+
+namespace
+{
+
+mesh::Mesh make_box(mesh::CellType celltype, std::size_t n)
+{
+  return generation::BoxMesh::create(
+      MPI_COMM_WORLD, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {n, n, n},
+      celltype, mesh::GhostMode::none);
+}
+
+void create_entities(bench::Result& r, mesh::CellType celltype, std::size_t n)
+{
+  const mesh::Mesh mesh = make_box(celltype, n);
+  const int tdim = mesh.topology().dim();
+  r.items = mesh.topology().index_map(tdim)->size_global();
+
+  bench::time(r, 5,
+              [&]()
+              {
+                // A fresh copy discards the lazily created entities of
+                // the previous repetition
+                mesh::Topology topology = mesh.topology();
+                topology.create_entities(tdim - 1);
+                topology.create_entities(1);
+              });
+}
+
+void create_entities_tet(bench::Result& r)
+{
+  create_entities(r, mesh::CellType::tetrahedron, 16);
+}
+DOLFINX_BENCHMARK("compute_entities tet", create_entities_tet);
+
+void create_entities_hex(bench::Result& r)
+{
+  create_entities(r, mesh::CellType::hexahedron, 24);
+}
+DOLFINX_BENCHMARK("compute_entities hex", create_entities_hex);
+
+void sparsity_assemble(bench::Result& r, mesh::CellType celltype,
+                       std::size_t n)
+{
+  const mesh::Mesh mesh = make_box(celltype, n);
+  const int tdim = mesh.topology().dim();
+  auto map0 = mesh.topology().index_map(0);
+  auto c_to_v = mesh.topology().connectivity(tdim, 0);
+  const std::int32_t num_cells = mesh.topology().index_map(tdim)->size_local();
+  r.items = mesh.topology().index_map(tdim)->size_global();
+
+  bench::time(r, 5,
+              [&]()
+              {
+                la::SparsityPattern pattern(mesh.mpi_comm(), {map0, map0},
+                                            {1, 1});
+                for (std::int32_t c = 0; c < num_cells; ++c)
+                {
+                  const auto dofs = c_to_v->links(c);
+                  pattern.insert(dofs, dofs);
+                }
+                pattern.assemble();
+              });
+}
+
+void sparsity_tet(bench::Result& r)
+{
+  sparsity_assemble(r, mesh::CellType::tetrahedron, 16);
+}
+DOLFINX_BENCHMARK("SparsityPattern P1 tet", sparsity_tet);
+
+void sparsity_hex(bench::Result& r)
+{
+  sparsity_assemble(r, mesh::CellType::hexahedron, 24);
+}
+DOLFINX_BENCHMARK("SparsityPattern P1 hex", sparsity_hex);
+
+} // namespace
@@ -0,0 +1,76 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// IndexMap scatter latency and bandwidth sweep: la::Vector forward
+// scatters over ring-ghosted index maps with a growing number of
+// ghosts, from latency-bound (few ghosts) to bandwidth-bound.
+
+#include "bench.h"
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/la/Vector.h>
+#include <memory>
+#include <mpi.h>
+#include <set>
+#include <vector>
+
+using namespace dolfinx;
+
+namespace
+{
+
+// Create an index map with the given local size and ghosts of the
+// first blocks of the next rank (ring pattern)
+std::shared_ptr<common::IndexMap> ring_map(std::int32_t size_local,
+                                           std::int32_t num_ghosts)
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  if (mpi_size == 1)
+    num_ghosts = 0;
+
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (std::int32_t i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * std::int64_t(size_local) + i;
+  const std::vector<int> ghost_owners(ghosts.size(),
+                                      (mpi_rank + 1) % mpi_size);
+
+  return std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local,
+      dolfinx::MPI::compute_graph_edges(
+          MPI_COMM_WORLD,
+          std::set<int>(ghost_owners.begin(), ghost_owners.end())),
+      ghosts, ghost_owners);
+}
+
+void scatter_fwd_sweep(bench::Result& r, std::int32_t num_ghosts, int reps)
+{
+  const std::int32_t size_local = std::max<std::int32_t>(num_ghosts, 1024);
+  auto map = ring_map(size_local, num_ghosts);
+  la::Vector<double> x(map, 1);
+  x.set(1.0);
+
+  // Ghost values moved per repetition, summed over ranks
+  r.bytes = double(map->num_ghosts()) * sizeof(double)
+            * dolfinx::MPI::size(MPI_COMM_WORLD);
+  r.items = double(map->num_ghosts()) * dolfinx::MPI::size(MPI_COMM_WORLD);
+
+  bench::time(r, reps, [&]() { x.scatter_fwd(); });
+}
+
+void scatter_fwd_16(bench::Result& r) { scatter_fwd_sweep(r, 16, 50); }
+DOLFINX_BENCHMARK("scatter_fwd 16 ghosts", scatter_fwd_16);
+
+void scatter_fwd_1k(bench::Result& r) { scatter_fwd_sweep(r, 1024, 50); }
+DOLFINX_BENCHMARK("scatter_fwd 1k ghosts", scatter_fwd_1k);
+
+void scatter_fwd_64k(bench::Result& r) { scatter_fwd_sweep(r, 65536, 20); }
+DOLFINX_BENCHMARK("scatter_fwd 64k ghosts", scatter_fwd_64k);
+
+void scatter_fwd_1m(bench::Result& r) { scatter_fwd_sweep(r, 1 << 20, 10); }
+DOLFINX_BENCHMARK("scatter_fwd 1M ghosts", scatter_fwd_1m);
+
+} // namespace
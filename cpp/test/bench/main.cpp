@@ -0,0 +1,142 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "bench.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mpi.h>
+#include <vector>
+
+namespace
+{
+struct Benchmark
+{
+  std::string name;
+  std::function<void(bench::Result&)> fn;
+};
+
+std::vector<Benchmark>& registry()
+{
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool bench::add(const std::string& name, std::function<void(Result&)> fn)
+{
+  registry().push_back({name, std::move(fn)});
+  return true;
+}
+//-----------------------------------------------------------------------------
+void bench::time(Result& r, int reps, const std::function<void()>& fn)
+{
+  r.reps = reps;
+  r.wall_min = std::numeric_limits<double>::max();
+  double sum = 0.0;
+
+  // One untimed warm-up repetition (i == -1)
+  for (int i = -1; i < reps; ++i)
+  {
+    MPI_Barrier(MPI_COMM_WORLD);
+    const double t0 = MPI_Wtime();
+    fn();
+    MPI_Barrier(MPI_COMM_WORLD);
+    const double t = MPI_Wtime() - t0;
+    if (i >= 0)
+    {
+      r.wall_min = std::min(r.wall_min, t);
+      sum += t;
+    }
+  }
+  r.wall_mean = sum / reps;
+}
+//-----------------------------------------------------------------------------
+int bench::run(int argc, char* argv[])
+{
+  std::string json, filter;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg.rfind("--json=", 0) == 0)
+      json = arg.substr(7);
+    else
+      filter = arg;
+  }
+
+  int rank, size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  if (rank == 0)
+  {
+    std::cout << std::left << std::setw(40) << "benchmark" << std::right
+              << std::setw(12) << "min [s]" << std::setw(12) << "mean [s]"
+              << std::setw(12) << "MB/s" << std::setw(14) << "Mitems/s"
+              << "\n";
+  }
+
+  std::vector<Result> results;
+  for (const Benchmark& b : registry())
+  {
+    if (!filter.empty() and b.name.find(filter) == std::string::npos)
+      continue;
+
+    Result r;
+    r.name = b.name;
+    b.fn(r);
+    results.push_back(r);
+
+    if (rank == 0)
+    {
+      std::cout << std::left << std::setw(40) << r.name << std::right
+                << std::setw(12) << std::setprecision(4) << r.wall_min
+                << std::setw(12) << r.wall_mean;
+      if (r.bytes > 0)
+        std::cout << std::setw(12) << r.bytes / r.wall_min / 1e6;
+      else
+        std::cout << std::setw(12) << "-";
+      if (r.items > 0)
+        std::cout << std::setw(14) << r.items / r.wall_min / 1e6;
+      else
+        std::cout << std::setw(14) << "-";
+      std::cout << "\n";
+    }
+  }
+
+  if (rank == 0 and !json.empty())
+  {
+    std::ofstream f(json);
+    if (!f)
+    {
+      std::cerr << "Cannot open JSON output file '" << json << "'\n";
+      return 1;
+    }
+    f << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      const Result& r = results[i];
+      f << "  {\"name\": \"" << r.name << "\", \"mpi_size\": " << size
+        << ", \"reps\": " << r.reps << ", \"wall_min\": " << r.wall_min
+        << ", \"wall_mean\": " << r.wall_mean << ", \"bytes\": " << r.bytes
+        << ", \"items\": " << r.items << "}"
+        << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    f << "]\n";
+  }
+
+  return 0;
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+  const int result = bench::run(argc, argv);
+  MPI_Finalize();
+  return result;
+}
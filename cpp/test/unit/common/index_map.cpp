@@ -101,6 +101,65 @@ void test_scatter_rev()
   sum = std::reduce(data_local.begin(), data_local.end(), 0);
   CHECK(sum == 2 * n * value * num_ghosts);
 }
+
+void test_scatter_fwd_compressed()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size_local = 100;
+
+  // Create some ghost entries on next process
+  const int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+
+  std::vector<int> global_ghost_owner(ghosts.size(), (mpi_rank + 1) % mpi_size);
+
+  // Create an IndexMap
+  common::IndexMap idx_map(
+      MPI_COMM_WORLD, size_local,
+      dolfinx::MPI::compute_graph_edges(
+          MPI_COMM_WORLD,
+          std::set<int>(global_ghost_owner.begin(), global_ghost_owner.end())),
+      ghosts, global_ghost_owner);
+
+  // Scatter double data through float buffers; values exactly
+  // representable in float must round-trip
+  const double val = 0.5;
+  std::vector<double> data_local(size_local, val * mpi_rank);
+  std::vector<double> data_ghost(num_ghosts, -1);
+  idx_map.scatter_fwd<double, float>(xtl::span<const double>(data_local),
+                                     xtl::span<double>(data_ghost), 1);
+  CHECK(std::all_of(data_ghost.begin(), data_ghost.end(),
+                    [=](auto v)
+                    { return v == val * ((mpi_rank + 1) % mpi_size); }));
+}
+
+void test_create_index_map()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size_local = 100;
+
+  // Create some ghost entries on next process
+  const int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+
+  const std::vector<int> global_ghost_owner(ghosts.size(),
+                                            (mpi_rank + 1) % mpi_size);
+
+  // Create an IndexMap without passing the ghost owners or destination
+  // ranks; they are determined by the distributed directory lookup
+  common::IndexMap idx_map
+      = common::create_index_map(MPI_COMM_WORLD, size_local, ghosts);
+
+  CHECK(idx_map.size_global() == std::int64_t(size_local) * mpi_size);
+  CHECK(idx_map.ghosts() == ghosts);
+  CHECK(idx_map.ghost_owner_rank() == global_ghost_owner);
+}
 } // namespace
 
 TEST_CASE("Scatter forward using IndexMap", "[index_map_scatter_fwd]")
@@ -113,3 +172,15 @@ TEST_CASE("Scatter reverse using IndexMap", "[index_map_scatter_rev]")
 {
   CHECK_NOTHROW(test_scatter_rev());
 }
+
+TEST_CASE("Compressed scatter forward using IndexMap",
+          "[index_map_scatter_fwd_compressed]")
+{
+  CHECK_NOTHROW(test_scatter_fwd_compressed());
+}
+
+TEST_CASE("Create IndexMap with distributed directory ghost owner lookup",
+          "[index_map_rendezvous]")
+{
+  CHECK_NOTHROW(test_create_index_map());
+}
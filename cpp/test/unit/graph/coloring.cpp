@@ -0,0 +1,64 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include <catch.hpp>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/coloring.h>
+#include <random>
+
+TEST_CASE("Test greedy graph colouring")
+{
+  // Build a random undirected graph and check that the computed
+  // colouring is proper, i.e. no two adjacent nodes share a colour
+  const std::int32_t n = 200;
+  std::vector<std::vector<std::int32_t>> edges(n);
+  std::uniform_int_distribution<std::int32_t> distribution(0, n - 1);
+  std::mt19937 engine;
+  for (int e = 0; e < 4 * n; ++e)
+  {
+    const std::int32_t v = distribution(engine);
+    const std::int32_t w = distribution(engine);
+    if (v != w)
+    {
+      edges[v].push_back(w);
+      edges[w].push_back(v);
+    }
+  }
+
+  const dolfinx::graph::AdjacencyList<std::int32_t> graph(edges);
+  const std::vector<std::int32_t> colors = dolfinx::graph::color(graph);
+  REQUIRE((int)colors.size() == n);
+  for (std::int32_t v = 0; v < n; ++v)
+  {
+    REQUIRE(colors[v] >= 0);
+    for (std::int32_t w : graph.links(v))
+      if (v != w)
+        REQUIRE(colors[v] != colors[w]);
+  }
+
+  // A distance-2 colouring must also separate nodes with a common
+  // neighbour
+  const std::vector<std::int32_t> colors2 = dolfinx::graph::color(graph, 2);
+  for (std::int32_t v = 0; v < n; ++v)
+  {
+    for (std::int32_t w : graph.links(v))
+    {
+      if (v != w)
+        REQUIRE(colors2[v] != colors2[w]);
+      for (std::int32_t u : graph.links(w))
+        if (u != v)
+          REQUIRE(colors2[v] != colors2[u]);
+    }
+  }
+
+  // The colour classes must partition the nodes and match the colours
+  const dolfinx::graph::AdjacencyList<std::int32_t> classes
+      = dolfinx::graph::color_classes(colors);
+  REQUIRE((int)classes.array().size() == n);
+  for (std::int32_t c = 0; c < classes.num_nodes(); ++c)
+    for (std::int32_t v : classes.links(c))
+      REQUIRE(colors[v] == c);
+}
@@ -0,0 +1,77 @@
+// Copyright (C) 2021 Chris Richardson
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for distributed la::MatrixCSR
+
+#include <catch.hpp>
+#include <dolfinx.h>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+
+using namespace dolfinx;
+
+namespace
+{
+
+void test_matrix_csr()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 50;
+
+  // Create some ghost entries on next process
+  const int num_ghosts = mpi_size > 1 ? 3 : 0;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+
+  const std::vector<int> global_ghost_owner(ghosts.size(),
+                                            (mpi_rank + 1) % mpi_size);
+
+  // Create an IndexMap, used for rows and columns
+  const auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local,
+      dolfinx::MPI::compute_graph_edges(
+          MPI_COMM_WORLD,
+          std::set<int>(global_ghost_owner.begin(), global_ghost_owner.end())),
+      ghosts, global_ghost_owner);
+
+  // Diagonal sparsity pattern, with entries on owned and ghost rows
+  la::SparsityPattern pattern(MPI_COMM_WORLD, {index_map, index_map}, {1, 1});
+  for (std::int32_t i = 0; i < size_local + num_ghosts; ++i)
+    pattern.insert(xtl::span(&i, 1), xtl::span(&i, 1));
+  pattern.assemble();
+
+  la::MatrixCSR<PetscScalar> A(pattern);
+  const auto mat_add = A.mat_add_values();
+  const PetscScalar one = 1.0;
+  for (std::int32_t i = 0; i < size_local + num_ghosts; ++i)
+    CHECK(mat_add(1, &i, 1, &i, &one) == 0);
+  A.finalize();
+
+  // After finalize, ghost row contributions have been added to the
+  // diagonal entries of the owning rank: rows ghosted on the previous
+  // rank hold 2, all other rows hold 1
+  const xtl::span<const std::int32_t> row_ptr = A.row_ptr();
+  const xtl::span<const PetscScalar> values = A.values();
+  for (std::int32_t i = 0; i < size_local; ++i)
+  {
+    REQUIRE(row_ptr[i + 1] - row_ptr[i] == 1);
+    const PetscScalar expected = (mpi_size > 1 and i < num_ghosts) ? 2.0 : 1.0;
+    CHECK(values[row_ptr[i]] == expected);
+  }
+
+  // The off-diagonal block holds no entries for a diagonal pattern
+  CHECK(A.off_diag_values().empty());
+}
+
+} // namespace
+
+TEST_CASE("Linear Algebra CSR matrix", "[la_matrix_csr]")
+{
+  CHECK_NOTHROW(test_matrix_csr());
+}
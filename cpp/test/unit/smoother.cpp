@@ -0,0 +1,108 @@
+// Copyright (C) 2021 DOLFINx authors
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for the matrix-free polynomial smoother
+
+#include <catch.hpp>
+#include <dolfinx.h>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/la/PolynomialSmoother.h>
+#include <dolfinx/la/Vector.h>
+#include <set>
+
+using namespace dolfinx;
+
+namespace
+{
+
+std::shared_ptr<common::IndexMap> create_map()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+
+  // Create some ghost entries on next process
+  int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+
+  const std::vector<int> global_ghost_owner(ghosts.size(),
+                                            (mpi_rank + 1) % mpi_size);
+
+  return std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local,
+      dolfinx::MPI::compute_graph_edges(
+          MPI_COMM_WORLD,
+          std::set<int>(global_ghost_owner.begin(), global_ghost_owner.end())),
+      ghosts, global_ghost_owner);
+}
+
+// Operator application y += 2 x for a diagonal test operator A = 2 I
+void apply_2I(la::Vector<PetscScalar>& x, la::Vector<PetscScalar>& y)
+{
+  x.scatter_fwd();
+  const xtl::span<const PetscScalar> x_arr = x.array();
+  const xtl::span<PetscScalar> y_arr = y.mutable_array();
+  const std::size_t n = x.map()->size_local();
+  for (std::size_t i = 0; i < n; ++i)
+    y_arr[i] += 2.0 * x_arr[i];
+}
+
+void test_smoother_jacobi()
+{
+  auto map = create_map();
+
+  la::Vector<PetscScalar> diag(map, 1), b(map, 1), x(map, 1);
+  std::fill(diag.mutable_array().begin(), diag.mutable_array().end(), 2.0);
+  std::fill(b.mutable_array().begin(), b.mutable_array().end(), 3.0);
+  std::fill(x.mutable_array().begin(), x.mutable_array().end(), 0.0);
+
+  // Undamped Jacobi solves the diagonal system A x = b exactly in one
+  // application: x = b / 2
+  la::PolynomialSmoother<PetscScalar> smoother(
+      apply_2I, diag, {0.5, 1.5}, 1,
+      la::PolynomialSmoother<PetscScalar>::Type::jacobi);
+  smoother.set_damping(1.0);
+  smoother.smooth(b, x);
+
+  const std::size_t n = map->size_local();
+  const xtl::span<const PetscScalar> x_arr = x.array();
+  CHECK(std::all_of(x_arr.begin(), std::next(x_arr.begin(), n),
+                    [](auto v) { return std::abs(v - 1.5) < 1e-12; }));
+}
+
+void test_smoother_chebyshev()
+{
+  auto map = create_map();
+
+  la::Vector<PetscScalar> diag(map, 1), b(map, 1), x(map, 1);
+  std::fill(diag.mutable_array().begin(), diag.mutable_array().end(), 2.0);
+  std::fill(b.mutable_array().begin(), b.mutable_array().end(), 3.0);
+  std::fill(x.mutable_array().begin(), x.mutable_array().end(), 0.0);
+
+  // D^{-1} A = I, so with the eigenvalue estimate [0.5, 1.5] centred
+  // on 1 the first Chebyshev correction is exact
+  la::PolynomialSmoother<PetscScalar> smoother(apply_2I, diag, {0.5, 1.5}, 3);
+  smoother.smooth(b, x);
+
+  const std::size_t n = map->size_local();
+  const xtl::span<const PetscScalar> x_arr = x.array();
+  CHECK(std::all_of(x_arr.begin(), std::next(x_arr.begin(), n),
+                    [](auto v) { return std::abs(v - 1.5) < 1e-12; }));
+}
+
+} // namespace
+
+TEST_CASE("Jacobi polynomial smoother", "[smoother_jacobi]")
+{
+  CHECK_NOTHROW(test_smoother_jacobi());
+}
+
+TEST_CASE("Chebyshev polynomial smoother", "[smoother_chebyshev]")
+{
+  CHECK_NOTHROW(test_smoother_chebyshev());
+}
@@ -7,8 +7,11 @@
 // Unit tests for Distributed la::Vector
 
 #include <catch.hpp>
+#include <cstdint>
 #include <dolfinx.h>
+#include <functional>
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/allocator.h>
 #include <dolfinx/la/Vector.h>
 
 using namespace dolfinx;
@@ -53,6 +56,111 @@ void test_vector()
   CHECK(v.norm(la::Norm::l2) == std::sqrt(sumn2));
   CHECK(la::inner_product(v, v) == sumn2);
   CHECK(v.norm(la::Norm::linf) == static_cast<PetscScalar>(mpi_size - 1));
+
+  // Payload must be aligned by the default (pool) allocator
+  CHECK(reinterpret_cast<std::uintptr_t>(v.array().data()) % 64 == 0);
+}
+
+void test_vector_fused()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+
+  // Create some ghost entries on next process
+  int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+
+  const std::vector<int> global_ghost_owner(ghosts.size(),
+                                            (mpi_rank + 1) % mpi_size);
+
+  // Create an IndexMap
+  const auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local,
+      dolfinx::MPI::compute_graph_edges(
+          MPI_COMM_WORLD,
+          std::set<int>(global_ghost_owner.begin(), global_ghost_owner.end())),
+      ghosts, global_ghost_owner);
+
+  la::Vector<PetscScalar> x(index_map, 1), y(index_map, 1), z(index_map, 1),
+      w(index_map, 1);
+  std::fill(x.mutable_array().begin(), x.mutable_array().end(), 1.0);
+  std::fill(y.mutable_array().begin(), y.mutable_array().end(), 2.0);
+  std::fill(z.mutable_array().begin(), z.mutable_array().end(), 3.0);
+
+  // Fused update: w = 2*x + 3*y + 1*z = 11
+  la::axpbypcz(w, PetscScalar(2), x, PetscScalar(3), y, PetscScalar(1), z);
+  CHECK(std::all_of(w.array().begin(), w.array().end(),
+                    [](auto v) { return v == 11.0; }));
+
+  // Expression assignment evaluates in one loop: w = 1*w + 2*x + z = 16
+  w = PetscScalar(1) * w + PetscScalar(2) * x + z;
+  CHECK(std::all_of(w.array().begin(), w.array().end(),
+                    [](auto v) { return v == 16.0; }));
+
+  // Combined inner products with a single reduction: {x.x, x.y}
+  const std::vector<std::reference_wrapper<const la::Vector<PetscScalar>>> b{
+      x, y};
+  const std::vector<PetscScalar> products = la::inner_product(x, b);
+  const double N = mpi_size * size_local;
+  REQUIRE(products.size() == 2);
+  CHECK(products[0] == N);
+  CHECK(products[1] == 2.0 * N);
+}
+
+void test_vector_compressed_scatter()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+
+  // Create some ghost entries on next process
+  int num_ghosts = (mpi_size - 1) * 3;
+  std::vector<std::int64_t> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+
+  const std::vector<int> global_ghost_owner(ghosts.size(),
+                                            (mpi_rank + 1) % mpi_size);
+
+  // Create an IndexMap
+  const auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local,
+      dolfinx::MPI::compute_graph_edges(
+          MPI_COMM_WORLD,
+          std::set<int>(global_ghost_owner.begin(), global_ghost_owner.end())),
+      ghosts, global_ghost_owner);
+
+  la::Vector<PetscScalar> v(index_map, 1);
+  std::fill(v.mutable_array().begin(), v.mutable_array().end(),
+            0.25 * mpi_rank);
+
+  // Update ghost values through the reduced precision (float) buffers;
+  // values exactly representable in float must round-trip
+  v.set_compressed_scatter(true);
+  v.scatter_fwd();
+  const xtl::span<const PetscScalar> xghost
+      = v.array().subspan(size_local, num_ghosts);
+  CHECK(std::all_of(xghost.begin(), xghost.end(),
+                    [=](auto g)
+                    { return g == 0.25 * ((mpi_rank + 1) % mpi_size); }));
+}
+
+void test_vector_allocator()
+{
+  // Recycling: memory released by one container with a pool allocator
+  // is handed back for an allocation of the same size
+  common::AlignedPoolAllocator<PetscScalar> alloc;
+  std::uintptr_t data0 = 0;
+  {
+    std::vector<PetscScalar, decltype(alloc)> v0(100, alloc);
+    data0 = reinterpret_cast<std::uintptr_t>(v0.data());
+    CHECK(data0 % 64 == 0);
+  }
+  std::vector<PetscScalar, decltype(alloc)> v1(100, alloc);
+  CHECK(reinterpret_cast<std::uintptr_t>(v1.data()) == data0);
 }
 
 } // namespace
@@ -61,3 +169,18 @@ TEST_CASE("Linear Algebra Vector", "[la_vector]")
 {
   CHECK_NOTHROW(test_vector());
 }
+
+TEST_CASE("Compressed Vector ghost update", "[la_vector_compressed_scatter]")
+{
+  CHECK_NOTHROW(test_vector_compressed_scatter());
+}
+
+TEST_CASE("Fused Vector operations", "[la_vector_fused]")
+{
+  CHECK_NOTHROW(test_vector_fused());
+}
+
+TEST_CASE("Aligned pool allocator", "[la_vector_allocator]")
+{
+  CHECK_NOTHROW(test_vector_allocator());
+}
@@ -62,4 +62,15 @@ auto xt_as_pyarray(U&& x)
 
   return py::array_t<typename U::value_type>(shape, strides, data, capsule);
 }
+
+/// Create a read-only py::array_t view of existing data owned by
+/// `owner`. No data is copied; the returned array keeps `owner` alive.
+template <typename T, typename Shape>
+py::array_t<T> as_pyarray_view(const T* data, Shape&& shape, py::handle owner)
+{
+  py::array_t<T> array(std::forward<Shape>(shape), data, owner);
+  py::detail::array_proxy(array.ptr())->flags
+      &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+  return array;
+}
 } // namespace dolfinx_wrappers
@@ -125,7 +125,9 @@ void declare_functions(py::module& m)
                         py::array_t<T, py::array::c_style>>& coefficients)
       {
         auto _coefficients = py_to_cpp_coeffs(coefficients);
-        return dolfinx::fem::assemble_scalar<T>(M, constants, _coefficients);
+        xtl::span<const T> _constants(constants.data(), constants.size());
+        py::gil_scoped_release release;
+        return dolfinx::fem::assemble_scalar<T>(M, _constants, _coefficients);
       },
       "Assemble functional over mesh with provided constants and "
       "coefficients");
@@ -138,8 +140,10 @@ void declare_functions(py::module& m)
                         py::array_t<T, py::array::c_style>>& coefficients)
       {
         auto _coefficients = py_to_cpp_coeffs(coefficients);
-        dolfinx::fem::assemble_vector<T>(xtl::span(b.mutable_data(), b.size()),
-                                         L, constants, _coefficients);
+        xtl::span<T> _b(b.mutable_data(), b.size());
+        xtl::span<const T> _constants(constants.data(), constants.size());
+        py::gil_scoped_release release;
+        dolfinx::fem::assemble_vector<T>(_b, L, _constants, _coefficients);
       },
       py::arg("b"), py::arg("L"), py::arg("constants"), py::arg("coeffs"),
       "Assemble linear form into an existing vector with pre-packed "
@@ -197,8 +201,10 @@ void declare_functions(py::module& m)
                        std::back_inserter(_coeffs),
                        [](auto& c) { return py_to_cpp_coeffs(c); });
 
-        dolfinx::fem::apply_lifting<T>(xtl::span(b.mutable_data(), b.size()), a,
-                                       _constants, _coeffs, bcs1, _x0, scale);
+        xtl::span<T> _b(b.mutable_data(), b.size());
+        py::gil_scoped_release release;
+        dolfinx::fem::apply_lifting<T>(_b, a, _constants, _coeffs, bcs1, _x0,
+                                       scale);
       },
       "Modify vector for lifted boundary conditions");
   m.def(
@@ -208,15 +214,17 @@ void declare_functions(py::module& m)
              bcs,
          const py::array_t<T, py::array::c_style>& x0, double scale)
       {
+        xtl::span<T> _b(b.mutable_data(), b.size());
         if (x0.ndim() == 0)
         {
-          dolfinx::fem::set_bc<T>(xtl::span(b.mutable_data(), b.size()), bcs,
-                                  scale);
+          py::gil_scoped_release release;
+          dolfinx::fem::set_bc<T>(_b, bcs, scale);
         }
         else if (x0.ndim() == 1)
         {
-          dolfinx::fem::set_bc<T>(xtl::span(b.mutable_data(), b.size()), bcs,
-                                  xtl::span(x0.data(), x0.shape(0)), scale);
+          xtl::span<const T> _x0(x0.data(), x0.shape(0));
+          py::gil_scoped_release release;
+          dolfinx::fem::set_bc<T>(_b, bcs, _x0, scale);
         }
         else
           throw std::runtime_error("Wrong array dimension.");
@@ -621,6 +629,7 @@ void fem(py::module& m)
           throw std::runtime_error(
               "create_sparsity_pattern requires exactly two dofmaps.");
         }
+        py::gil_scoped_release release;
         return dolfinx::fem::create_sparsity_pattern(
             topology, {dofmaps[0], dofmaps[1]}, types);
       },
@@ -690,11 +699,7 @@ void fem(py::module& m)
            [](const dolfinx::fem::FiniteElement& self)
            {
              const xt::xtensor<double, 2>& x = self.interpolation_points();
-
-             // FIXME: Set read-only flag and return wrapper
-             return py::array_t<double>(x.shape(), x.data());
-             //  return py::array_t<double>(x.shape(), x.data(),
-             //  py::cast(self));
+             return as_pyarray_view(x.data(), x.shape(), py::cast(self));
            })
       .def_property_readonly("interpolation_ident",
                              &dolfinx::fem::FiniteElement::interpolation_ident)
@@ -859,8 +864,11 @@ void fem(py::module& m)
           set_fn = dolfinx::la::PETScMatrix::set_block_fn(A, ADD_VALUES);
 
         auto _coefficients = py_to_cpp_coeffs(coefficients);
-        dolfinx::fem::assemble_matrix(set_fn, a, xtl::span(constants),
-                                      _coefficients, bcs);
+        xtl::span<const PetscScalar> _constants(constants.data(),
+                                                constants.size());
+        py::gil_scoped_release release;
+        dolfinx::fem::assemble_matrix(set_fn, a, _constants, _coefficients,
+                                      bcs);
       },
       py::arg("A"), py::arg("a"), py::arg("constants"), py::arg("coeffs"),
       py::arg("bcs"), py::arg("unrolled") = false,
@@ -888,8 +896,11 @@ void fem(py::module& m)
           set_fn = dolfinx::la::PETScMatrix::set_block_fn(A, ADD_VALUES);
 
         auto _coefficients = py_to_cpp_coeffs(coefficients);
-        dolfinx::fem::assemble_matrix(set_fn, a, xtl::span(constants),
-                                      _coefficients, rows0, rows1);
+        xtl::span<const PetscScalar> _constants(constants.data(),
+                                                constants.size());
+        py::gil_scoped_release release;
+        dolfinx::fem::assemble_matrix(set_fn, a, _constants, _coefficients,
+                                      rows0, rows1);
       },
       py::arg("A"), py::arg("a"), py::arg("constants"), py::arg("coeffs"),
       py::arg("rows0"), py::arg("rows1"), py::arg("unrolled") = false);
@@ -935,10 +946,14 @@ void fem(py::module& m)
       {
         if (V.size() != 2)
           throw std::runtime_error("Expected two function spaces.");
-        std::array<std::vector<std::int32_t>, 2> dofs
-            = dolfinx::fem::locate_dofs_topological(
-                {V[0], V[1]}, dim, xtl::span(entities.data(), entities.size()),
-                remote);
+        xtl::span<const std::int32_t> _entities(entities.data(),
+                                                entities.size());
+        std::array<std::vector<std::int32_t>, 2> dofs;
+        {
+          py::gil_scoped_release release;
+          dofs = dolfinx::fem::locate_dofs_topological({V[0], V[1]}, dim,
+                                                       _entities, remote);
+        }
         return {as_pyarray(std::move(dofs[0])), as_pyarray(std::move(dofs[1]))};
       },
       py::arg("V"), py::arg("dim"), py::arg("entities"),
@@ -949,8 +964,15 @@ void fem(py::module& m)
          const py::array_t<std::int32_t, py::array::c_style>& entities,
          bool remote)
       {
-        return as_pyarray(dolfinx::fem::locate_dofs_topological(
-            V, dim, xtl::span(entities.data(), entities.size()), remote));
+        xtl::span<const std::int32_t> _entities(entities.data(),
+                                                entities.size());
+        std::vector<std::int32_t> dofs;
+        {
+          py::gil_scoped_release release;
+          dofs = dolfinx::fem::locate_dofs_topological(V, dim, _entities,
+                                                       remote);
+        }
+        return as_pyarray(std::move(dofs));
       },
       py::arg("V"), py::arg("dim"), py::arg("entities"),
       py::arg("remote") = true);
@@ -964,9 +986,12 @@ void fem(py::module& m)
         if (V.size() != 2)
           throw std::runtime_error("Expected two function spaces.");
 
+        // Reacquire the GIL only for the (batched) call into the Python
+        // marker function
         auto _marker
             = [&marker](const xt::xtensor<double, 2>& x) -> xt::xtensor<bool, 1>
         {
+          py::gil_scoped_acquire acquire;
           auto strides = x.strides();
           std::transform(strides.begin(), strides.end(), strides.begin(),
                          [](auto s) { return s * sizeof(double); });
@@ -976,8 +1001,11 @@ void fem(py::module& m)
           return xt::adapt(m.data(), m.size(), xt::no_ownership(), s);
         };
 
-        std::array<std::vector<std::int32_t>, 2> dofs
-            = dolfinx::fem::locate_dofs_geometrical({V[0], V[1]}, _marker);
+        std::array<std::vector<std::int32_t>, 2> dofs;
+        {
+          py::gil_scoped_release release;
+          dofs = dolfinx::fem::locate_dofs_geometrical({V[0], V[1]}, _marker);
+        }
         return {as_pyarray(std::move(dofs[0])), as_pyarray(std::move(dofs[1]))};
       },
       py::arg("V"), py::arg("marker"));
@@ -990,6 +1018,7 @@ void fem(py::module& m)
         auto _marker
             = [&marker](const xt::xtensor<double, 2>& x) -> xt::xtensor<bool, 1>
         {
+          py::gil_scoped_acquire acquire;
           auto strides = x.strides();
           std::transform(strides.begin(), strides.end(), strides.begin(),
                          [](auto s) { return s * sizeof(double); });
@@ -998,7 +1027,12 @@ void fem(py::module& m)
           std::vector<std::size_t> s(m.shape(), m.shape() + m.ndim());
           return xt::adapt(m.data(), m.size(), xt::no_ownership(), s);
         };
-        return as_pyarray(dolfinx::fem::locate_dofs_geometrical(V, _marker));
+        std::vector<std::int32_t> dofs;
+        {
+          py::gil_scoped_release release;
+          dofs = dolfinx::fem::locate_dofs_geometrical(V, _marker);
+        }
+        return as_pyarray(std::move(dofs));
       },
       py::arg("V"), py::arg("marker"));
 
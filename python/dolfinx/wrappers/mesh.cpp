@@ -156,6 +156,9 @@ void mesh(py::module& m)
                   const dolfinx::graph::AdjacencyList<std::int64_t>& cells,
                   dolfinx::mesh::GhostMode ghost_mode)
         {
+          // Reacquire the GIL only for the (single) call into the
+          // Python partitioning function
+          py::gil_scoped_acquire acquire;
           return partitioner(MPICommWrapper(comm), n, tdim, cells, ghost_mode);
         };
 
@@ -163,11 +166,43 @@ void mesh(py::module& m)
         std::array<std::size_t, 2> shape
             = {static_cast<std::size_t>(x.shape(0)), shape1};
         auto _x = xt::adapt(x.data(), x.size(), xt::no_ownership(), shape);
+        py::gil_scoped_release release;
         return dolfinx::mesh::create_mesh(comm.get(), cells, element, _x,
                                           ghost_mode, partitioner_wrapper);
       },
       "Helper function for creating meshes.");
 
+  m.def(
+      "create_mesh",
+      [](const MPICommWrapper comm,
+         const py::array_t<std::int64_t, py::array::c_style>& cells,
+         const dolfinx::fem::CoordinateElement& element,
+         const py::array_t<double, py::array::c_style>& x,
+         dolfinx::mesh::GhostMode ghost_mode)
+      {
+        // Adopt the cell data into library-owned storage in one copy.
+        // The ownership-taking create_mesh overload releases it as
+        // soon as the cells have been redistributed, so the caller and
+        // library copies do not coexist beyond the handoff.
+        if (cells.ndim() != 2)
+          throw std::runtime_error("Incorrect array dimension.");
+        const std::size_t degree = cells.shape(1);
+        std::vector<std::int64_t> data(cells.data(),
+                                       cells.data() + cells.size());
+        const std::size_t shape1 = x.ndim() == 1 ? 1 : x.shape()[1];
+        std::array<std::size_t, 2> shape
+            = {static_cast<std::size_t>(x.shape(0)), shape1};
+        auto _x = xt::adapt(x.data(), x.size(), xt::no_ownership(), shape);
+        py::gil_scoped_release release;
+        return dolfinx::mesh::create_mesh(
+            comm.get(),
+            dolfinx::graph::build_adjacency_list<std::int64_t>(
+                std::move(data), degree),
+            element, _x, ghost_mode);
+      },
+      "Helper function for creating meshes from a cell array without an "
+      "intermediate AdjacencyList copy.");
+
   // dolfinx::mesh::GhostMode enums
   py::enum_<dolfinx::mesh::GhostMode>(m, "GhostMode")
       .value("none", dolfinx::mesh::GhostMode::none)
@@ -240,10 +275,14 @@ void mesh(py::module& m)
           { return dolfinx::mesh::Topology(comm.get(), cell_type); }))
       .def("set_connectivity", &dolfinx::mesh::Topology::set_connectivity)
       .def("set_index_map", &dolfinx::mesh::Topology::set_index_map)
-      .def("create_entities", &dolfinx::mesh::Topology::create_entities)
+      .def("create_entities", &dolfinx::mesh::Topology::create_entities,
+           py::call_guard<py::gil_scoped_release>())
       .def("create_entity_permutations",
-           &dolfinx::mesh::Topology::create_entity_permutations)
-      .def("create_connectivity", &dolfinx::mesh::Topology::create_connectivity)
+           &dolfinx::mesh::Topology::create_entity_permutations,
+           py::call_guard<py::gil_scoped_release>())
+      .def("create_connectivity",
+           &dolfinx::mesh::Topology::create_connectivity,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_facet_permutations",
            [](const dolfinx::mesh::Topology& self)
            {
@@ -312,17 +351,24 @@ void mesh(py::module& m)
            const std::function<py::array_t<bool>(
                const py::array_t<double, py::array::c_style>&)>& marker)
         {
+          // Reacquire the GIL only for the (batched) call into the
+          // Python marker function
           auto cpp_marker =
               [&marker](const xt::xtensor<double, 2>& x) -> xt::xtensor<bool, 1>
           {
+            py::gil_scoped_acquire acquire;
             py::array_t<double> x_view(x.shape(), x.data(), py::none());
             py::array_t<bool> marked = marker(x_view);
             std::array shape = {static_cast<std::size_t>(marked.size())};
             return xt::adapt(marked.data(), marked.size(), xt::no_ownership(),
                              shape);
           };
-          return as_pyarray(
-              dolfinx::mesh::locate_entities(mesh, dim, cpp_marker));
+          std::vector<std::int32_t> entities;
+          {
+            py::gil_scoped_release release;
+            entities = dolfinx::mesh::locate_entities(mesh, dim, cpp_marker);
+          }
+          return as_pyarray(std::move(entities));
         });
 
   m.def("locate_entities_boundary",
@@ -333,14 +379,20 @@ void mesh(py::module& m)
           auto cpp_marker =
               [&marker](const xt::xtensor<double, 2>& x) -> xt::xtensor<bool, 1>
           {
+            py::gil_scoped_acquire acquire;
             py::array_t<double> x_view(x.shape(), x.data(), py::none());
             py::array_t<bool> marked = marker(x_view);
             std::array shape = {static_cast<std::size_t>(marked.size())};
             return xt::adapt(marked.data(), marked.size(), xt::no_ownership(),
                              shape);
           };
-          return as_pyarray(
-              dolfinx::mesh::locate_entities_boundary(mesh, dim, cpp_marker));
+          std::vector<std::int32_t> entities;
+          {
+            py::gil_scoped_release release;
+            entities = dolfinx::mesh::locate_entities_boundary(mesh, dim,
+                                                               cpp_marker);
+          }
+          return as_pyarray(std::move(entities));
         });
 
   m.def("entities_to_geometry",